@@ -159,20 +159,16 @@ ResourceBindFlags getBindFlags(bool isDepth, bool allowUav)
 size_t Fbo::DescHash::operator()(const Fbo::Desc& d) const
 {
     size_t hash = 0;
-    std::hash<uint32_t> u32hash;
-    std::hash<bool> bhash;
+    auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
     for (uint32_t i = 0; i < getMaxColorTargetCount(); i++)
     {
-        uint32_t format = (uint32_t)d.getColorTargetFormat(i);
-        format <<= i;
-        hash |= u32hash(format) >> i;
-        hash |= bhash(d.isColorTargetUav(i)) << i;
+        combine(std::hash<uint32_t>()((uint32_t)d.getColorTargetFormat(i)));
+        combine(std::hash<bool>()(d.isColorTargetUav(i)));
     }
 
-    uint32_t format = (uint32_t)d.getDepthStencilFormat();
-    hash |= u32hash(format);
-    hash |= bhash(d.isDepthStencilUav());
-    hash |= u32hash(d.getSampleCount());
+    combine(std::hash<uint32_t>()((uint32_t)d.getDepthStencilFormat()));
+    combine(std::hash<bool>()(d.isDepthStencilUav()));
+    combine(std::hash<uint32_t>()(d.getSampleCount()));
 
     return hash;
 }
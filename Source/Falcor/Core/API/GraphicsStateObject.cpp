@@ -29,6 +29,7 @@
 #include "Device.h"
 #include "GFXHelpers.h"
 #include "GFXAPI.h"
+#include <mutex>
 
 namespace Falcor
 {
@@ -232,14 +233,33 @@ GraphicsStateObject::~GraphicsStateObject()
     mpDevice->releaseResource(mpGFXRenderPassLayout);
 }
 
+size_t GraphicsStateObjectDesc::Hash::operator()(const GraphicsStateObjectDesc& desc) const
+{
+    size_t hash = Fbo::DescHash()(desc.fboDesc);
+    auto combine = [&hash](size_t value) { hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2); };
+    combine(std::hash<const void*>()(desc.pVertexLayout.get()));
+    combine(std::hash<const void*>()(desc.pProgramKernels.get()));
+    combine(std::hash<const void*>()(desc.pRasterizerState.get()));
+    combine(std::hash<const void*>()(desc.pDepthStencilState.get()));
+    combine(std::hash<const void*>()(desc.pBlendState.get()));
+    combine(std::hash<uint32_t>()(desc.sampleMask));
+    combine(std::hash<uint32_t>()((uint32_t)desc.primitiveType));
+    return hash;
+}
+
 GraphicsStateObject::GraphicsStateObject(ref<Device> pDevice, const GraphicsStateObjectDesc& desc) : mpDevice(pDevice), mDesc(desc)
 {
-    if (spDefaultBlendState == nullptr)
     {
-        // Create default objects
-        spDefaultBlendState = BlendState::create(BlendState::Desc());
-        spDefaultDepthStencilState = DepthStencilState::create(DepthStencilState::Desc());
-        spDefaultRasterizerState = RasterizerState::create(RasterizerState::Desc());
+        // Graphics state objects may be created on worker threads (see GraphicsState::prewarmGSO()).
+        static std::mutex sDefaultStateMutex;
+        std::lock_guard<std::mutex> lock(sDefaultStateMutex);
+        if (spDefaultBlendState == nullptr)
+        {
+            // Create default objects
+            spDefaultBlendState = BlendState::create(BlendState::Desc());
+            spDefaultDepthStencilState = DepthStencilState::create(DepthStencilState::Desc());
+            spDefaultRasterizerState = RasterizerState::create(RasterizerState::Desc());
+        }
     }
 
     // Initialize default objects
@@ -77,6 +77,15 @@ struct GraphicsStateObjectDesc
         result = result && (pDepthStencilState == other.pDepthStencilState);
         return result;
     }
+
+    /**
+     * Hash function for using descs as keys in hash maps.
+     * State objects are hashed by identity, consistent with operator==.
+     */
+    struct FALCOR_API Hash
+    {
+        size_t operator()(const GraphicsStateObjectDesc& desc) const;
+    };
 };
 
 class FALCOR_API GraphicsStateObject : public Object
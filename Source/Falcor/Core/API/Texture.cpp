@@ -273,6 +273,11 @@ ref<Texture> Texture::createMippedFromFiles(
     size_t combinedSize = 0;
     std::filesystem::path fullPathMip0;
 
+    // Channel reduction is applied once all levels are loaded, as all levels need to use the same format.
+    // Single and two-channel 8-bit formats have no sRGB variant, so sRGB textures are not reduced.
+    const bool reduceChannels = is_set(importFlags, Bitmap::ImportFlags::ReduceChannels) && !loadAsSrgb;
+    const Bitmap::ImportFlags bitmapImportFlags = importFlags & ~Bitmap::ImportFlags::ReduceChannels;
+
     for (const auto& path : paths)
     {
         Bitmap::UniqueConstPtr pBitmap;
@@ -282,7 +287,7 @@ ref<Texture> Texture::createMippedFromFiles(
         }
         else
         {
-            pBitmap = Bitmap::createFromFile(path, kTopDown, importFlags);
+            pBitmap = Bitmap::createFromFile(path, kTopDown, bitmapImportFlags);
         }
         if (!pBitmap)
         {
@@ -320,6 +325,28 @@ ref<Texture> Texture::createMippedFromFiles(
         mips.emplace_back(std::move(pBitmap));
     }
 
+    if (reduceChannels && !mips.empty())
+    {
+        std::vector<Bitmap::UniqueConstPtr> reducedMips;
+        for (const auto& mip : mips)
+        {
+            auto pReduced = Bitmap::reduceChannels(*mip);
+            if (!pReduced)
+                break;
+            if (!reducedMips.empty() && (pReduced->getFormat() != reducedMips[0]->getFormat() ||
+                                         pReduced->getChannelSwizzle() != reducedMips[0]->getChannelSwizzle()))
+                break;
+            reducedMips.emplace_back(std::move(pReduced));
+        }
+        if (reducedMips.size() == mips.size())
+        {
+            mips = std::move(reducedMips);
+            combinedSize = 0;
+            for (const auto& mip : mips)
+                combinedSize += mip->getSize();
+        }
+    }
+
     ref<Texture> pTex;
     if (!mips.empty())
     {
@@ -345,6 +372,7 @@ ref<Texture> Texture::createMippedFromFiles(
     {
         pTex->setSourcePath(fullPathMip0);
         pTex->mImportFlags = importFlags;
+        pTex->mChannelSwizzle = mips[0]->getChannelSwizzle();
 
         // Log debug info.
         std::string str = fmt::format(
@@ -388,9 +416,25 @@ ref<Texture> Texture::createFromFile(
             logWarning("Error loading '{}': {}", path, e.what());
         }
     }
+    else if (hasExtension(path, "ktx2"))
+    {
+        try
+        {
+            pTex = ImageIO::loadTextureFromKTX2(pDevice, path, generateMipLevels, loadAsSrgb, bindFlags, importFlags);
+        }
+        catch (const std::exception& e)
+        {
+            logWarning("Error loading '{}': {}", path, e.what());
+        }
+    }
     else
     {
-        Bitmap::UniqueConstPtr pBitmap = Bitmap::createFromFile(path, kTopDown, importFlags);
+        // Single and two-channel 8-bit formats have no sRGB variant, so sRGB textures are not reduced.
+        Bitmap::ImportFlags bitmapImportFlags = importFlags;
+        if (loadAsSrgb)
+            bitmapImportFlags &= ~Bitmap::ImportFlags::ReduceChannels;
+
+        Bitmap::UniqueConstPtr pBitmap = Bitmap::createFromFile(path, kTopDown, bitmapImportFlags);
         if (pBitmap)
         {
             ResourceFormat texFormat = pBitmap->getFormat();
@@ -408,6 +452,8 @@ ref<Texture> Texture::createFromFile(
                 pBitmap->getData(),
                 bindFlags
             );
+            if (pTex)
+                pTex->mChannelSwizzle = pBitmap->getChannelSwizzle();
         }
     }
 
@@ -737,6 +783,27 @@ bool Texture::compareDesc(const Texture* pOther) const
            mIsSparse == pOther->mIsSparse && all(mSparsePageRes == pOther->mSparsePageRes);
 }
 
+void Texture::swapStorage(Texture& other)
+{
+    FALCOR_CHECK(
+        mType == other.mType && mFormat == other.mFormat && mArraySize == other.mArraySize && mSampleCount == other.mSampleCount,
+        "Can't swap storage of textures with different types or formats."
+    );
+
+    invalidateViews();
+    other.invalidateViews();
+
+    std::swap(mGfxTextureResource, other.mGfxTextureResource);
+    std::swap(mWidth, other.mWidth);
+    std::swap(mHeight, other.mHeight);
+    std::swap(mDepth, other.mDepth);
+    std::swap(mMipLevels, other.mMipLevels);
+    std::swap(mSize, other.mSize);
+    std::swap(mState, other.mState);
+    mSharedApiHandle = 0;
+    other.mSharedApiHandle = 0;
+}
+
 uint64_t Texture::getTextureSizeInBytes() const
 {
     // get allocation info for resource description
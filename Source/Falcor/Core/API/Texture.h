@@ -315,6 +315,16 @@ public:
      */
     Bitmap::ImportFlags getImportFlags() const { return mImportFlags; }
 
+    /**
+     * Set how the stored channels map to RGBA when sampled as a material texture. See Bitmap::ChannelSwizzle.
+     */
+    void setChannelSwizzle(Bitmap::ChannelSwizzle swizzle) { mChannelSwizzle = swizzle; }
+
+    /**
+     * Get how the stored channels map to RGBA when sampled as a material texture.
+     */
+    Bitmap::ChannelSwizzle getChannelSwizzle() const { return mChannelSwizzle; }
+
     /**
      * Returns the total number of texels across all mip levels and array slices.
      */
@@ -331,6 +341,15 @@ public:
      */
     bool compareDesc(const Texture* pOther) const;
 
+    /**
+     * Exchange the GPU storage of two textures.
+     * This swaps the underlying resources along with their dimensions and mip counts, while keeping the identity of the texture objects.
+     * It is used to change the resident mip levels of a texture that is referenced elsewhere.
+     * All views of both textures are invalidated and need to be rebound.
+     * Both textures must have the same type, format, array size and sample count.
+     */
+    void swapStorage(Texture& other);
+
 protected:
     void uploadInitData(RenderContext* pRenderContext, const void* pData, bool autoGenMips);
 
@@ -339,6 +358,7 @@ protected:
     bool mReleaseRtvsAfterGenMips = true;
     std::filesystem::path mSourcePath;
     Bitmap::ImportFlags mImportFlags = Bitmap::ImportFlags::None; ///< Flags used for import if loaded from file.
+    Bitmap::ChannelSwizzle mChannelSwizzle = Bitmap::ChannelSwizzle::Identity; ///< Mapping of stored channels to RGBA.
 
     ResourceFormat mFormat = ResourceFormat::Unknown;
     uint32_t mWidth = 0;
@@ -0,0 +1,294 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "FileWatcher.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+
+#if FALCOR_LINUX
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace Falcor
+{
+
+#if FALCOR_LINUX
+namespace
+{
+// Events that indicate that a file in a watched directory was written, replaced or removed.
+// IN_MODIFY and IN_CREATE are not used, as they are always followed by IN_CLOSE_WRITE.
+const uint32_t kWatchMask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_MOVED_FROM | IN_DELETE;
+} // namespace
+#endif
+
+FileWatcher::FileWatcher()
+{
+#if FALCOR_LINUX
+    mInotifyFd = ::inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    mWakeFd = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (mInotifyFd == -1 || mWakeFd == -1)
+    {
+        logWarning("FileWatcher: Failed to initialize inotify: {}", std::strerror(errno));
+        if (mInotifyFd != -1)
+            ::close(mInotifyFd);
+        if (mWakeFd != -1)
+            ::close(mWakeFd);
+        mInotifyFd = mWakeFd = -1;
+        return;
+    }
+    mThread = std::thread(&FileWatcher::run, this);
+#endif
+}
+
+FileWatcher::~FileWatcher()
+{
+#if FALCOR_LINUX
+    if (mThread.joinable())
+    {
+        uint64_t value = 1;
+        [[maybe_unused]] ssize_t written = ::write(mWakeFd, &value, sizeof(value));
+        mThread.join();
+    }
+    if (mInotifyFd != -1)
+        ::close(mInotifyFd);
+    if (mWakeFd != -1)
+        ::close(mWakeFd);
+#endif
+}
+
+bool FileWatcher::isSupported()
+{
+#if FALCOR_LINUX
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool FileWatcher::addFile(const std::filesystem::path& path, Callback callback)
+{
+#if FALCOR_LINUX
+    if (mInotifyFd == -1)
+        return false;
+
+    std::filesystem::path normalizedPath = normalizePath(path);
+    std::string key = normalizedPath.string();
+    std::string directory = normalizedPath.parent_path().string();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (auto it = mFiles.find(key); it != mFiles.end())
+    {
+        it->second = std::move(callback);
+        return true;
+    }
+
+    Directory& dir = mDirectories[directory];
+    if (dir.fileCount == 0)
+    {
+        dir.watch = ::inotify_add_watch(mInotifyFd, directory.c_str(), kWatchMask | IN_ONLYDIR);
+        if (dir.watch == -1)
+        {
+            logWarning("FileWatcher: Failed to watch directory '{}': {}", directory, std::strerror(errno));
+            mDirectories.erase(directory);
+            return false;
+        }
+        mWatchToDirectory[dir.watch] = directory;
+    }
+    dir.fileCount++;
+    mFiles.emplace(std::move(key), std::move(callback));
+    return true;
+#else
+    (void)path;
+    (void)callback;
+    return false;
+#endif
+}
+
+void FileWatcher::removeFile(const std::filesystem::path& path)
+{
+#if FALCOR_LINUX
+    std::filesystem::path normalizedPath = normalizePath(path);
+    std::string key = normalizedPath.string();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    if (mFiles.erase(key) == 0)
+        return;
+    mChangedFiles.erase(key);
+
+    auto it = mDirectories.find(normalizedPath.parent_path().string());
+    FALCOR_ASSERT(it != mDirectories.end() && it->second.fileCount > 0);
+    if (--it->second.fileCount == 0)
+    {
+        if (it->second.watch != -1)
+        {
+            ::inotify_rm_watch(mInotifyFd, it->second.watch);
+            mWatchToDirectory.erase(it->second.watch);
+        }
+        mDirectories.erase(it);
+    }
+#else
+    (void)path;
+#endif
+}
+
+bool FileWatcher::isWatching(const std::filesystem::path& path) const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFiles.count(normalizePath(path).string()) > 0;
+}
+
+size_t FileWatcher::getWatchedFileCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFiles.size();
+}
+
+std::vector<std::filesystem::path> FileWatcher::takeChangedFiles()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::vector<std::filesystem::path> changedFiles(mChangedFiles.begin(), mChangedFiles.end());
+    mChangedFiles.clear();
+    return changedFiles;
+}
+
+bool FileWatcher::waitForChanges(std::chrono::milliseconds timeout)
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    return mChangedCondition.wait_for(lock, timeout, [this]() { return !mChangedFiles.empty(); });
+}
+
+std::filesystem::path FileWatcher::normalizePath(const std::filesystem::path& path)
+{
+    std::error_code ec;
+    std::filesystem::path result = std::filesystem::weakly_canonical(std::filesystem::absolute(path, ec), ec);
+    if (ec)
+        result = std::filesystem::absolute(path, ec);
+    return result.lexically_normal();
+}
+
+void FileWatcher::notifyChanged(const std::vector<std::string>& paths)
+{
+    std::vector<std::pair<std::filesystem::path, Callback>> callbacks;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        for (const auto& path : paths)
+        {
+            auto it = mFiles.find(path);
+            if (it == mFiles.end())
+                continue;
+            mChangedFiles.insert(path);
+            if (it->second)
+                callbacks.emplace_back(path, it->second);
+        }
+    }
+    mChangedCondition.notify_all();
+
+    // Call the callbacks without holding the lock, so they can add or remove files.
+    for (const auto& [path, callback] : callbacks)
+        callback(path);
+}
+
+void FileWatcher::run()
+{
+#if FALCOR_LINUX
+    alignas(struct inotify_event) char buffer[64 * 1024];
+
+    while (true)
+    {
+        struct pollfd fds[2] = {{mInotifyFd, POLLIN, 0}, {mWakeFd, POLLIN, 0}};
+        if (::poll(fds, 2, -1) == -1)
+        {
+            if (errno == EINTR)
+                continue;
+            logWarning("FileWatcher: Failed to poll for events: {}", std::strerror(errno));
+            break;
+        }
+
+        // Woken up for shutdown.
+        if (fds[1].revents & POLLIN)
+            break;
+
+        ssize_t length = ::read(mInotifyFd, buffer, sizeof(buffer));
+        if (length <= 0)
+            continue;
+
+        // Collect the unique paths of all events in the batch, so that callbacks are called once per file.
+        std::set<std::string> paths;
+        bool overflow = false;
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            for (ssize_t offset = 0; offset < length;)
+            {
+                const struct inotify_event* event = reinterpret_cast<const struct inotify_event*>(buffer + offset);
+                offset += sizeof(struct inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    overflow = true;
+                    continue;
+                }
+
+                auto it = mWatchToDirectory.find(event->wd);
+                if (it == mWatchToDirectory.end())
+                    continue;
+
+                // The directory itself was removed. Its files are reported by IN_DELETE before this.
+                if (event->mask & IN_IGNORED)
+                {
+                    if (auto dirIt = mDirectories.find(it->second); dirIt != mDirectories.end())
+                        dirIt->second.watch = -1;
+                    mWatchToDirectory.erase(it);
+                    continue;
+                }
+
+                if (event->len > 0)
+                    paths.insert((std::filesystem::path(it->second) / event->name).string());
+            }
+
+            // Events were lost. Conservatively report all watched files as changed.
+            if (overflow)
+            {
+                logWarning("FileWatcher: Event queue overflow, reporting all {} watched files as changed.", mFiles.size());
+                for (const auto& file : mFiles)
+                    paths.insert(file.first);
+            }
+        }
+
+        if (!paths.empty())
+            notifyChanged(std::vector<std::string>(paths.begin(), paths.end()));
+    }
+#endif
+}
+
+} // namespace Falcor
@@ -0,0 +1,134 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+
+#include "Core/Macros.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Event-driven watcher for file changes.
+ * Uses inotify on Linux. Files are watched through their parent directories, so that changes
+ * are also detected when editors save by writing a new file and renaming it over the old one.
+ * Events are received on a background thread, no polling of file modification times is done.
+ *
+ * Changed files are accumulated until they are retrieved with takeChangedFiles(). Optionally,
+ * a callback can be registered per file, which is called on the background thread.
+ *
+ * On platforms without a native backend isSupported() returns false and no changes are reported.
+ */
+class FALCOR_API FileWatcher
+{
+public:
+    using Callback = std::function<void(const std::filesystem::path&)>;
+
+    FileWatcher();
+    ~FileWatcher();
+
+    /// Returns true if file watching is supported on this platform.
+    static bool isSupported();
+
+    /**
+     * Start watching a file. Watching a file that is already watched replaces its callback.
+     * The file does not need to exist yet, but its parent directory does.
+     * @param path File path.
+     * @param callback Optional callback called on the watcher thread when the file changed.
+     * @return True if successful.
+     */
+    bool addFile(const std::filesystem::path& path, Callback callback = {});
+
+    /**
+     * Stop watching a file.
+     * @param path File path.
+     */
+    void removeFile(const std::filesystem::path& path);
+
+    /// Returns true if the file is watched.
+    bool isWatching(const std::filesystem::path& path) const;
+
+    /// Returns the number of watched files.
+    size_t getWatchedFileCount() const;
+
+    /**
+     * Get the files that changed since the last call and clear the list.
+     * @return Normalized paths of the changed files.
+     */
+    std::vector<std::filesystem::path> takeChangedFiles();
+
+    /**
+     * Wait until at least one file changed.
+     * @param timeout Maximum time to wait.
+     * @return True if there are changed files.
+     */
+    bool waitForChanges(std::chrono::milliseconds timeout);
+
+    /**
+     * Normalize a path to the form used for watching.
+     * @param path File path.
+     * @return Absolute, lexically normalized path with symlinks in existing parts resolved.
+     */
+    static std::filesystem::path normalizePath(const std::filesystem::path& path);
+
+private:
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    struct Directory
+    {
+        int watch = -1;
+        size_t fileCount = 0;
+    };
+
+    void run();
+    void notifyChanged(const std::vector<std::string>& paths);
+
+    int mInotifyFd = -1;
+    int mWakeFd = -1;
+    std::thread mThread;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mChangedCondition;
+    std::unordered_map<std::string, Callback> mFiles;           ///< Watched files and their callbacks.
+    std::unordered_map<std::string, Directory> mDirectories;    ///< Watched directories.
+    std::unordered_map<int, std::string> mWatchToDirectory;     ///< Map from watch descriptor to directory.
+    std::set<std::string> mChangedFiles;                        ///< Files changed since the last call to takeChangedFiles().
+};
+
+} // namespace Falcor
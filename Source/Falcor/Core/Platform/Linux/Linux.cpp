@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Core/Platform/OS.h"
+#include "Core/Platform/FileWatcher.h"
 #include "Core/Error.h"
 #include "Core/GLFW.h"
 #include "Utils/Logger.h"
@@ -34,6 +35,8 @@
 #include <gtk/gtk.h>
 
 #include <iostream>
+#include <fstream>
+#include <string_view>
 #include <unistd.h>
 #include <signal.h>
 #include <sys/types.h>
@@ -163,17 +166,28 @@ void terminateProcess(size_t processID)
     FALCOR_UNIMPLEMENTED();
 }
 
+static FileWatcher& getSharedFileWatcher()
+{
+    static FileWatcher watcher;
+    return watcher;
+}
+
 void monitorFileUpdates(const std::filesystem::path& path, const std::function<void()>& callback)
 {
-    (void)path;
-    (void)callback;
-    FALCOR_UNIMPLEMENTED();
+    // As on Windows, the callback is called on the watcher thread.
+    getSharedFileWatcher().addFile(
+        path,
+        [callback](const std::filesystem::path&)
+        {
+            if (callback)
+                callback();
+        }
+    );
 }
 
 void closeSharedFile(const std::filesystem::path& path)
 {
-    (void)path;
-    FALCOR_UNIMPLEMENTED();
+    getSharedFileWatcher().removeFile(path);
 }
 
 bool createJunction(const std::filesystem::path& link, const std::filesystem::path& target)
@@ -577,15 +591,29 @@ void OSServices::start() {}
 
 void OSServices::stop() {}
 
-size_t getCurrentRSS()
+namespace
 {
-    FALCOR_UNIMPLEMENTED();
+/// Read a memory size field (reported in kB) from /proc/self/status. Returns size in bytes, or 0 if not found.
+uint64_t readProcStatusSize(std::string_view key)
+{
+    std::ifstream file("/proc/self/status");
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.size() > key.size() && line.compare(0, key.size(), key) == 0 && line[key.size()] == ':')
+            return std::strtoull(line.c_str() + key.size() + 1, nullptr, 10) * 1024;
+    }
     return 0;
 }
+} // namespace
 
-size_t getPeakRSS()
+uint64_t getCurrentRSS()
 {
-    FALCOR_UNIMPLEMENTED();
-    return 0;
+    return readProcStatusSize("VmRSS");
+}
+
+uint64_t getPeakRSS()
+{
+    return readProcStatusSize("VmHWM");
 }
 } // namespace Falcor
@@ -0,0 +1,179 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MacroUsageTracker.h"
+
+#include <fstream>
+#include <iterator>
+
+namespace Falcor
+{
+
+namespace
+{
+bool isIdentifierStart(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+bool isIdentifierChar(char c)
+{
+    return isIdentifierStart(c) || (c >= '0' && c <= '9');
+}
+
+bool containsAny(const MacroUsageTracker::IdentifierSet& identifiers, const std::set<std::string>& macroNames)
+{
+    for (const auto& name : macroNames)
+    {
+        if (identifiers.count(name) > 0)
+            return true;
+    }
+    return false;
+}
+} // namespace
+
+void MacroUsageTracker::scanIdentifiers(std::string_view source, IdentifierSet& identifiers)
+{
+    const size_t n = source.size();
+    size_t i = 0;
+    while (i < n)
+    {
+        char c = source[i];
+        if (c == '/' && i + 1 < n && source[i + 1] == '/')
+        {
+            // Line comment.
+            while (i < n && source[i] != '\n')
+                i++;
+        }
+        else if (c == '/' && i + 1 < n && source[i + 1] == '*')
+        {
+            // Block comment.
+            size_t end = source.find("*/", i + 2);
+            i = end == std::string_view::npos ? n : end + 2;
+        }
+        else if (c == '"' || c == '\'')
+        {
+            // String or character literal.
+            i++;
+            while (i < n && source[i] != c && source[i] != '\n')
+                i += source[i] == '\\' ? 2 : 1;
+            i++;
+        }
+        else if (isIdentifierStart(c))
+        {
+            size_t start = i;
+            while (i < n && isIdentifierChar(source[i]))
+                i++;
+            identifiers.emplace(source.substr(start, i - start));
+        }
+        else if (c >= '0' && c <= '9')
+        {
+            // Numeric literal including suffixes, e.g. 1.5f or 0xffu.
+            while (i < n && (isIdentifierChar(source[i]) || source[i] == '.'))
+                i++;
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+std::set<std::string> MacroUsageTracker::getChangedMacros(const DefineList& before, const DefineList& after)
+{
+    std::set<std::string> changed;
+    for (const auto& [name, value] : before)
+    {
+        auto it = after.find(name);
+        if (it == after.end() || it->second != value)
+            changed.insert(name);
+    }
+    for (const auto& [name, value] : after)
+    {
+        if (before.find(name) == before.end())
+            changed.insert(name);
+    }
+
+    // Defines expanding to a changed macro change as well. Iterate until no more defines are added.
+    bool added = !changed.empty();
+    while (added)
+    {
+        added = false;
+        for (const DefineList* pDefines : {&before, &after})
+        {
+            for (const auto& [name, value] : *pDefines)
+            {
+                if (changed.count(name) == 0 && isAnyMacroUsed(value, changed))
+                {
+                    changed.insert(name);
+                    added = true;
+                }
+            }
+        }
+    }
+
+    return changed;
+}
+
+bool MacroUsageTracker::isAnyMacroUsed(std::string_view source, const std::set<std::string>& macroNames)
+{
+    if (macroNames.empty())
+        return false;
+    IdentifierSet identifiers;
+    scanIdentifiers(source, identifiers);
+    return containsAny(identifiers, macroNames);
+}
+
+bool MacroUsageTracker::isAnyMacroUsedInFile(const std::filesystem::path& path, const std::set<std::string>& macroNames)
+{
+    if (macroNames.empty())
+        return false;
+
+    std::error_code ec;
+    auto modifiedTime = std::filesystem::last_write_time(path, ec);
+    if (ec)
+        return true;
+
+    std::string key = path.string();
+    auto it = mFiles.find(key);
+    if (it == mFiles.end() || it->second.modifiedTime != modifiedTime)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+            return true;
+        std::string source((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        FileEntry entry;
+        entry.modifiedTime = modifiedTime;
+        scanIdentifiers(source, entry.identifiers);
+        it = mFiles.insert_or_assign(std::move(key), std::move(entry)).first;
+    }
+
+    return containsAny(it->second.identifiers, macroNames);
+}
+
+} // namespace Falcor
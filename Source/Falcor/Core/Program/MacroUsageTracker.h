@@ -0,0 +1,107 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "DefineList.h"
+#include "Core/Macros.h"
+
+#include <filesystem>
+#include <set>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace Falcor
+{
+
+/**
+ * Tracks which macro names are referenced by shader sources.
+ * Used to decide which programs need to be recompiled when a global define changes.
+ *
+ * Sources are scanned for identifier tokens, skipping comments, string and character literals.
+ * A macro can only affect a program if its name appears as a token in one of the program's sources
+ * (either in a preprocessor directive or as a value in code), so the scan is conservative.
+ * Macro names assembled with token pasting are not detected.
+ *
+ * The identifiers of each file are cached and rescanned when the file's modification time changes.
+ */
+class FALCOR_API MacroUsageTracker
+{
+public:
+    using IdentifierSet = std::unordered_set<std::string>;
+
+    /**
+     * Collect the identifier tokens of a source string.
+     * @param[in] source Source string.
+     * @param[in,out] identifiers Set the identifiers are added to.
+     */
+    static void scanIdentifiers(std::string_view source, IdentifierSet& identifiers);
+
+    /**
+     * Get the macros changed between two define lists.
+     * Defines whose values reference a changed macro are reported as changed as well.
+     * @param[in] before Define list before the change.
+     * @param[in] after Define list after the change.
+     * @return Names of the macros that were added, removed or changed value.
+     */
+    static std::set<std::string> getChangedMacros(const DefineList& before, const DefineList& after);
+
+    /**
+     * Check if any of the macro names is referenced by a source string.
+     * @param[in] source Source string.
+     * @param[in] macroNames Macro names.
+     * @return True if any macro name appears as an identifier.
+     */
+    static bool isAnyMacroUsed(std::string_view source, const std::set<std::string>& macroNames);
+
+    /**
+     * Check if any of the macro names is referenced by a source file.
+     * Files that cannot be read are assumed to reference all macros.
+     * @param[in] path File path.
+     * @param[in] macroNames Macro names.
+     * @return True if any macro name appears as an identifier.
+     */
+    bool isAnyMacroUsedInFile(const std::filesystem::path& path, const std::set<std::string>& macroNames);
+
+    /// Returns the number of cached files.
+    size_t getCachedFileCount() const { return mFiles.size(); }
+
+    /// Clear the file cache.
+    void clear() { mFiles.clear(); }
+
+private:
+    struct FileEntry
+    {
+        std::filesystem::file_time_type modifiedTime;
+        IdentifierSet identifiers;
+    };
+
+    std::unordered_map<std::string, FileEntry> mFiles;
+};
+
+} // namespace Falcor
@@ -33,6 +33,8 @@
 
 #include <slang.h>
 
+#include <set>
+
 namespace Falcor
 {
 
@@ -102,6 +104,9 @@ inline bool doSlangReflection(
 
 ProgramManager::ProgramManager(Device* pDevice) : mpDevice(pDevice)
 {
+    if (FileWatcher::isSupported())
+        mpFileWatcher = std::make_unique<FileWatcher>();
+
     // Set global shader defines
     DefineList globalDefines = {
         {"FALCOR_NVAPI_AVAILABLE", (FALCOR_NVAPI_AVAILABLE && mpDevice->getType() == Device::Type::D3D12) ? "1" : "0"},
@@ -164,13 +169,18 @@ ref<const ProgramVersion> ProgramManager::createProgramVersion(const Program& pr
     }
 
     // Extract list of files referenced, for dependency-tracking purposes.
+    std::vector<std::filesystem::path> depFiles;
     int depFileCount = spGetDependencyFileCount(pSlangRequest);
     for (int ii = 0; ii < depFileCount; ++ii)
     {
         std::string depFilePath = spGetDependencyFilePath(pSlangRequest, ii);
         if (std::filesystem::exists(depFilePath))
+        {
             program.mFileTimeMap[depFilePath] = getFileModifiedTime(depFilePath);
+            depFiles.push_back(depFilePath);
+        }
     }
+    addProgramDependencies(program, depFiles);
 
     // Note: the `ProgramReflection` needs to be able to refer back to the
     // `ProgramVersion`, but the `ProgramVersion` can't be initialized
@@ -568,15 +578,122 @@ void ProgramManager::registerProgramForReload(Program* program)
 void ProgramManager::unregisterProgramForReload(Program* program)
 {
     mLoadedPrograms.erase(std::remove(mLoadedPrograms.begin(), mLoadedPrograms.end(), program), mLoadedPrograms.end());
+
+    for (const auto& path : mProgramDependencies.removeDependent(program))
+    {
+        if (mpFileWatcher)
+            mpFileWatcher->removeFile(path);
+    }
+}
+
+void ProgramManager::addProgramDependencies(const Program& program, const std::vector<std::filesystem::path>& files) const
+{
+    // Dependencies are kept until the program is unregistered. Resetting a program does not remove them,
+    // so that a program that failed to compile is still reset when the offending file is fixed.
+    // Dependencies of all program versions are accumulated, as they can include different files.
+    for (const auto& file : files)
+    {
+        std::filesystem::path path = FileWatcher::normalizePath(file);
+        if (mProgramDependencies.addDependency(&program, path) && mpFileWatcher)
+            mpFileWatcher->addFile(path);
+    }
+}
+
+bool ProgramManager::isProgramUsingMacros(const Program& program, const std::set<std::string>& macroNames)
+{
+    // Programs that were never compiled have no recorded dependencies. Resetting them is cheap.
+    if (!mProgramDependencies.hasDependent(&program))
+        return true;
+
+    for (const auto& path : mProgramDependencies.getDependencies(&program))
+    {
+        if (mMacroUsage.isAnyMacroUsedInFile(path, macroNames))
+            return true;
+    }
+
+    // Sources given as strings are not reported as dependencies by Slang.
+    for (const auto& shaderModule : program.getDesc().shaderModules)
+    {
+        for (const auto& source : shaderModule.sources)
+        {
+            if (source.type == ProgramDesc::ShaderSource::Type::String && MacroUsageTracker::isAnyMacroUsed(source.string, macroNames))
+                return true;
+        }
+    }
+
+    // Program defines can expand to global defines.
+    for (const auto& [name, value] : program.getDefines())
+    {
+        if (MacroUsageTracker::isAnyMacroUsed(value, macroNames))
+            return true;
+    }
+
+    return false;
+}
+
+bool ProgramManager::reloadProgramsUsingMacros(const std::set<std::string>& macroNames)
+{
+    bool hasReloaded = false;
+
+    for (auto program : mLoadedPrograms)
+    {
+        if (isProgramUsingMacros(*program, macroNames))
+        {
+            program->reset();
+            hasReloaded = true;
+        }
+    }
+
+    return hasReloaded;
+}
+
+std::vector<Program*> ProgramManager::getProgramsDependingOn(const std::filesystem::path& path) const
+{
+    std::vector<const Program*> dependents = mProgramDependencies.getDependents(FileWatcher::normalizePath(path));
+    std::vector<Program*> programs;
+    for (auto program : mLoadedPrograms)
+    {
+        if (std::find(dependents.begin(), dependents.end(), program) != dependents.end())
+            programs.push_back(program);
+    }
+    return programs;
 }
 
 bool ProgramManager::reloadAllPrograms(bool forceReload)
 {
     bool hasReloaded = false;
 
+    // Reset only the programs depending on files reported by the file watcher.
+    if (mpFileWatcher && !forceReload)
+    {
+        std::set<const Program*> changedPrograms;
+        for (const auto& path : mpFileWatcher->takeChangedFiles())
+        {
+            for (const Program* program : mProgramDependencies.getDependents(path))
+                changedPrograms.insert(program);
+        }
+        if (changedPrograms.empty())
+            return false;
+
+        for (auto program : mLoadedPrograms)
+        {
+            if (changedPrograms.count(program) > 0)
+            {
+                program->reset();
+                hasReloaded = true;
+            }
+        }
+
+        return hasReloaded;
+    }
+
+    // All programs are checked below, pending file changes are covered by that.
+    if (mpFileWatcher)
+        mpFileWatcher->takeChangedFiles();
+
     for (auto program : mLoadedPrograms)
     {
-        if (program->checkIfFilesChanged() || forceReload)
+        if (forceReload || program->checkIfFilesChanged())
         {
             program->reset();
             hasReloaded = true;
@@ -588,14 +705,16 @@ bool ProgramManager::reloadAllPrograms(bool forceReload)
 
 void ProgramManager::addGlobalDefines(const DefineList& defineList)
 {
+    DefineList previousDefineList = mGlobalDefineList;
     mGlobalDefineList.add(defineList);
-    reloadAllPrograms(true);
+    reloadProgramsUsingMacros(MacroUsageTracker::getChangedMacros(previousDefineList, mGlobalDefineList));
 }
 
 void ProgramManager::removeGlobalDefines(const DefineList& defineList)
 {
+    DefineList previousDefineList = mGlobalDefineList;
     mGlobalDefineList.remove(defineList);
-    reloadAllPrograms(true);
+    reloadProgramsUsingMacros(MacroUsageTracker::getChangedMacros(previousDefineList, mGlobalDefineList));
 }
 
 void ProgramManager::setGenerateDebugInfoEnabled(bool enabled)
@@ -27,10 +27,17 @@
  **************************************************************************/
 #pragma once
 #include "Program.h"
+#include "MacroUsageTracker.h"
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
+#include "Core/Platform/FileWatcher.h"
+#include "Utils/FileDependencyIndex.h"
 
+#include <filesystem>
 #include <memory>
+#include <set>
+#include <string>
+#include <vector>
 
 namespace Falcor
 {
@@ -86,19 +93,33 @@ public:
 
     /**
      * Reload and relink all programs.
+     * If file watching is supported, only the programs depending on files that changed since the
+     * last call are reset. Otherwise the modification times of all program dependencies are checked.
      * @param[in] forceReload Force reloading all programs.
      * @return True if any program was reloaded, false otherwise.
      */
     bool reloadAllPrograms(bool forceReload = false);
 
+    /**
+     * Get the loaded programs that depend on a file.
+     * @param[in] path File path.
+     * @return List of programs.
+     */
+    std::vector<Program*> getProgramsDependingOn(const std::filesystem::path& path) const;
+
+    /// Returns true if file changes are detected by a file watcher instead of checking modification times.
+    bool isFileWatchingEnabled() const { return mpFileWatcher != nullptr; }
+
     /**
      * Add a list of defines applied to all programs.
+     * Only the programs whose sources reference a changed define are reloaded.
      * @param[in] defineList List of macro definitions.
      */
     void addGlobalDefines(const DefineList& defineList);
 
     /**
      * Remove a list of defines applied to all programs.
+     * Only the programs whose sources reference a removed define are reloaded.
      * @param[in] defineList List of macro definitions.
      */
     void removeGlobalDefines(const DefineList& defineList);
@@ -146,10 +167,16 @@ public:
 
 private:
     SlangCompileRequest* createSlangCompileRequest(const Program& program) const;
+    void addProgramDependencies(const Program& program, const std::vector<std::filesystem::path>& files) const;
+    bool isProgramUsingMacros(const Program& program, const std::set<std::string>& macroNames);
+    bool reloadProgramsUsingMacros(const std::set<std::string>& macroNames);
 
     Device* mpDevice;
 
     std::vector<Program*> mLoadedPrograms;
+    std::unique_ptr<FileWatcher> mpFileWatcher;                                 ///< Watcher for program dependencies. Nullptr if not supported.
+    mutable FileDependencyIndex<const Program*> mProgramDependencies;           ///< Index from source files to the programs including them, accumulated over all program versions.
+    MacroUsageTracker mMacroUsage;                                              ///< Cache of the identifiers referenced by source files.
     mutable CompilationStats mCompilationStats;
 
     DefineList mGlobalDefineList;
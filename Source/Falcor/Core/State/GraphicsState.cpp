@@ -51,6 +51,9 @@ static GraphicsStateObjectDesc::PrimitiveType topology2Type(Vao::Topology t)
     }
 }
 
+// Number of worker threads for creating graphics state objects ahead of first use.
+static const uint32_t kPrewarmWorkerCount = 2;
+
 ref<GraphicsState> GraphicsState::create(ref<Device> pDevice)
 {
     return ref<GraphicsState>(new GraphicsState(pDevice));
@@ -71,6 +74,7 @@ GraphicsState::GraphicsState(ref<Device> pDevice) : mpDevice(pDevice)
     }
 
     mpGsoGraph = std::make_unique<GraphicsStateGraph>();
+    mpGsoCache = std::make_unique<GraphicsStateObjectCache>(kPrewarmWorkerCount);
 }
 
 GraphicsState::~GraphicsState() = default;
@@ -95,28 +99,44 @@ ref<GraphicsStateObject> GraphicsState::getGSO(const ProgramVars* pVars)
     ref<GraphicsStateObject> pGso = mpGsoGraph->getCurrentNode();
     if (pGso == nullptr)
     {
-        mDesc.pProgramKernels = pProgramKernels;
-        mDesc.fboDesc = mpFbo ? mpFbo->getDesc() : Fbo::Desc();
-        mDesc.pVertexLayout = mpVao->getVertexLayout();
-        mDesc.primitiveType = topology2Type(mpVao->getPrimitiveTopology());
-
-        GraphicsStateGraph::CompareFunc cmpFunc = [&desc = mDesc](ref<GraphicsStateObject> pGso) -> bool
-        { return pGso && (desc == pGso->getDesc()); };
-
-        if (mpGsoGraph->scanForMatchingNode(cmpFunc))
-        {
-            pGso = mpGsoGraph->getCurrentNode();
-        }
-        else
-        {
-            pGso = mpDevice->createGraphicsStateObject(mDesc);
-            pGso->breakStrongReferenceToDevice();
-            mpGsoGraph->setCurrentNodeData(pGso);
-        }
+        // The graph walk reached a new node. Look up the state object by desc, creating it if it doesn't exist yet.
+        updateDesc(pProgramKernels);
+        pGso = mpGsoCache->getOrCreate(mDesc, getCreateFunc());
+        mpGsoGraph->setCurrentNodeData(pGso);
     }
     return pGso;
 }
 
+bool GraphicsState::prewarmGSO(const ProgramVars* pVars)
+{
+    FALCOR_CHECK(mpProgram, "Can't prewarm a graphics state object without a program.");
+    FALCOR_CHECK(mpVao, "Can't prewarm a graphics state object without a VAO.");
+
+    auto pProgramKernels = mpProgram->getActiveVersion()->getKernels(mpDevice, pVars);
+    updateDesc(pProgramKernels);
+    return mpGsoCache->prewarm(mDesc, getCreateFunc());
+}
+
+void GraphicsState::updateDesc(const ref<const ProgramKernels>& pProgramKernels)
+{
+    mDesc.pProgramKernels = pProgramKernels;
+    mDesc.fboDesc = mpFbo ? mpFbo->getDesc() : Fbo::Desc();
+    mDesc.pVertexLayout = mpVao->getVertexLayout();
+    mDesc.primitiveType = topology2Type(mpVao->getPrimitiveTopology());
+}
+
+GraphicsState::GraphicsStateObjectCache::CreateFunc GraphicsState::getCreateFunc() const
+{
+    // The device outlives its graphics states, so a raw pointer is safe to use from the workers.
+    Device* pDevice = mpDevice.get();
+    return [pDevice](const GraphicsStateObjectDesc& desc)
+    {
+        ref<GraphicsStateObject> pGso = pDevice->createGraphicsStateObject(desc);
+        pGso->breakStrongReferenceToDevice();
+        return pGso;
+    };
+}
+
 GraphicsState& GraphicsState::setFbo(const ref<Fbo>& pFbo, bool setVp0Sc0)
 {
     mpFbo = pFbo;
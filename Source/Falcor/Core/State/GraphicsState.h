@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "StateGraph.h"
+#include "StateObjectCache.h"
 #include "Core/Macros.h"
 #include "Core/Object.h"
 #include "Core/API/FBO.h"
@@ -264,11 +265,32 @@ public:
      */
     uint32_t getSampleMask() const { return mDesc.sampleMask; }
 
+    using GraphicsStateObjectCache = StateObjectCache<GraphicsStateObjectDesc, ref<GraphicsStateObject>, GraphicsStateObjectDesc::Hash>;
+
     /**
      * Get the active graphics state object.
      */
     virtual ref<GraphicsStateObject> getGSO(const ProgramVars* pVars);
 
+    /**
+     * Enqueue creation of the graphics state object for the current state on a worker thread.
+     * Set up the state as for a draw call and call this ahead of the first draw to avoid creating the state object on the
+     * render thread. The program kernels are still created on the calling thread.
+     * @param[in] pVars Program vars used for selecting the program kernels, same as for getGSO().
+     * @return True if creation was enqueued, false if the state object already exists or is pending.
+     */
+    bool prewarmGSO(const ProgramVars* pVars);
+
+    /**
+     * Wait for all graphics state objects enqueued with prewarmGSO() to be created.
+     */
+    void waitForPrewarming() { mpGsoCache->waitForPrewarming(); }
+
+    /**
+     * Get lookup statistics of the graphics state object cache.
+     */
+    GraphicsStateObjectCache::Stats getGSOCacheStats() const { return mpGsoCache->getStats(); }
+
     /**
      * Get the desc
      */
@@ -279,6 +301,9 @@ public:
 private:
     GraphicsState(ref<Device> pDevice);
 
+    void updateDesc(const ref<const ProgramKernels>& pProgramKernels);
+    GraphicsStateObjectCache::CreateFunc getCreateFunc() const;
+
     BreakableReference<Device> mpDevice;
     ref<Vao> mpVao;
     ref<Fbo> mpFbo;
@@ -301,5 +326,6 @@ private:
 
     using GraphicsStateGraph = StateGraph<ref<GraphicsStateObject>, void*>;
     std::unique_ptr<GraphicsStateGraph> mpGsoGraph;
+    std::unique_ptr<GraphicsStateObjectCache> mpGsoCache; ///< Hashed desc to state object index, used when the graph walk lands on an empty node.
 };
 } // namespace Falcor
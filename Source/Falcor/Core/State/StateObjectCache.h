@@ -0,0 +1,301 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Hash-indexed cache of state objects (pipelines) keyed by their desc.
+ * State objects are either created synchronously on first use via getOrCreate(), or ahead of time on worker threads via prewarm().
+ * Looking up a desc that is still being created by a worker waits for it instead of creating a duplicate.
+ * A failed background creation is not cached, so the next getOrCreate() call creates the object on the calling thread
+ * and reports the error there.
+ * All functions are thread-safe.
+ */
+template<typename DescType, typename StateObjectType, typename DescHashType = std::hash<DescType>>
+class StateObjectCache
+{
+public:
+    using CreateFunc = std::function<StateObjectType(const DescType& desc)>;
+
+    struct Stats
+    {
+        uint64_t hits = 0;           ///< Number of lookups finding a ready state object.
+        uint64_t misses = 0;         ///< Number of lookups creating the state object on the calling thread.
+        uint64_t waits = 0;          ///< Number of lookups waiting for a background creation to finish.
+        uint64_t prewarmed = 0;      ///< Number of state objects created by the workers.
+        uint64_t failedPrewarms = 0; ///< Number of background creations that failed.
+    };
+
+    /**
+     * Constructor.
+     * @param[in] workerCount Number of worker threads used for prewarming. The threads are started on the first prewarm() call.
+     */
+    StateObjectCache(uint32_t workerCount = 1) : mWorkerCount(workerCount > 0 ? workerCount : 1) {}
+
+    ~StateObjectCache()
+    {
+        {
+            // Drop jobs that have not started yet.
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTerminate = true;
+            mPendingCount -= mQueue.size();
+            mQueue.clear();
+        }
+        mQueueCondition.notify_all();
+        for (auto& thread : mWorkers)
+            thread.join();
+    }
+
+    StateObjectCache(const StateObjectCache&) = delete;
+    StateObjectCache& operator=(const StateObjectCache&) = delete;
+
+    /**
+     * Find a state object. Waits if the state object is being created by a worker.
+     * @return The state object, or a default constructed value if it is not in the cache.
+     */
+    StateObjectType find(const DescType& desc)
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        auto it = waitForEntry(lock, desc);
+        if (it == mEntries.end())
+            return {};
+        mStats.hits++;
+        return it->second.pObject;
+    }
+
+    /**
+     * Find a state object, creating it on the calling thread if it is not in the cache.
+     * @param[in] desc State object desc.
+     * @param[in] createFunc Function creating the state object. Exceptions are passed on to the caller.
+     * @return The state object.
+     */
+    StateObjectType getOrCreate(const DescType& desc, const CreateFunc& createFunc)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            auto it = waitForEntry(lock, desc);
+            if (it != mEntries.end())
+            {
+                mStats.hits++;
+                return it->second.pObject;
+            }
+            mStats.misses++;
+        }
+
+        // Create outside the lock to not block the workers.
+        StateObjectType pObject = createFunc(desc);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        auto& entry = mEntries[desc];
+        entry.pObject = pObject;
+        entry.pending = false;
+        mEntryCondition.notify_all();
+        return pObject;
+    }
+
+    /**
+     * Enqueue a state object for creation on a worker thread.
+     * @param[in] desc State object desc.
+     * @param[in] createFunc Function creating the state object. Called on a worker thread.
+     * @return True if the state object was enqueued, false if it is already cached or pending.
+     */
+    bool prewarm(const DescType& desc, CreateFunc createFunc)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (mEntries.find(desc) != mEntries.end())
+                return false;
+
+            mEntries[desc].pending = true;
+            mQueue.push_back({desc, std::move(createFunc)});
+            mPendingCount++;
+
+            // Start another worker if all running workers are busy.
+            if (mWorkers.size() < mWorkerCount && mQueue.size() > mWorkers.size() - mBusyWorkers)
+                mWorkers.emplace_back([this]() { workerLoop(); });
+        }
+        mQueueCondition.notify_one();
+        return true;
+    }
+
+    /**
+     * Wait for all enqueued state objects to be created.
+     */
+    void waitForPrewarming()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mEntryCondition.wait(lock, [this]() { return mPendingCount == 0; });
+    }
+
+    /**
+     * Check if a desc is in the cache, either ready or pending.
+     */
+    bool contains(const DescType& desc) const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mEntries.find(desc) != mEntries.end();
+    }
+
+    /**
+     * Get the number of cached descs, including pending ones.
+     */
+    size_t size() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mEntries.size();
+    }
+
+    /**
+     * Get the number of state objects waiting for or in creation on the workers.
+     */
+    size_t getPendingCount() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mPendingCount;
+    }
+
+    Stats getStats() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mStats;
+    }
+
+    /**
+     * Remove all state objects. Waits for pending creations to finish first.
+     */
+    void clear()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mEntryCondition.wait(lock, [this]() { return mPendingCount == 0; });
+        mEntries.clear();
+    }
+
+private:
+    struct Entry
+    {
+        StateObjectType pObject = {};
+        bool pending = false;
+    };
+
+    struct Job
+    {
+        DescType desc;
+        CreateFunc createFunc;
+    };
+
+    using EntryMap = std::unordered_map<DescType, Entry, DescHashType>;
+
+    /// Look up a desc, waiting while it is pending. The lookup is repeated after waiting as the map may change meanwhile.
+    typename EntryMap::iterator waitForEntry(std::unique_lock<std::mutex>& lock, const DescType& desc)
+    {
+        bool waited = false;
+        while (true)
+        {
+            auto it = mEntries.find(desc);
+            if (it == mEntries.end() || !it->second.pending)
+            {
+                if (waited)
+                    mStats.waits++;
+                return it;
+            }
+            waited = true;
+            mEntryCondition.wait(lock);
+        }
+    }
+
+    void workerLoop()
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        while (true)
+        {
+            mQueueCondition.wait(lock, [this]() { return mTerminate || !mQueue.empty(); });
+            if (mTerminate)
+                return;
+
+            Job job = std::move(mQueue.front());
+            mQueue.pop_front();
+            mBusyWorkers++;
+            lock.unlock();
+
+            StateObjectType pObject = {};
+            bool success = true;
+            try
+            {
+                pObject = job.createFunc(job.desc);
+            }
+            catch (...)
+            {
+                success = false;
+            }
+
+            lock.lock();
+            mBusyWorkers--;
+            // The entry may have been created synchronously in the meantime, in which case the result is dropped.
+            auto it = mEntries.find(job.desc);
+            if (it != mEntries.end() && it->second.pending)
+            {
+                if (success)
+                {
+                    it->second.pObject = pObject;
+                    it->second.pending = false;
+                    mStats.prewarmed++;
+                }
+                else
+                {
+                    mEntries.erase(it);
+                    mStats.failedPrewarms++;
+                }
+            }
+            mPendingCount--;
+            mEntryCondition.notify_all();
+        }
+    }
+
+    const uint32_t mWorkerCount;
+
+    mutable std::mutex mMutex;
+    std::condition_variable mEntryCondition; ///< Signaled when a pending entry is resolved.
+    std::condition_variable mQueueCondition; ///< Signaled when a job is enqueued or the workers terminate.
+    EntryMap mEntries;
+    std::deque<Job> mQueue;
+    std::vector<std::thread> mWorkers;
+    size_t mPendingCount = 0;
+    size_t mBusyWorkers = 0;
+    bool mTerminate = false;
+    Stats mStats;
+};
+} // namespace Falcor
@@ -305,6 +305,12 @@ public:
         return compile(pRenderContext, s);
     }
 
+    /**
+     * Get the multi-queue schedule of the compiled graph.
+     * @return The schedule, or nullptr if the graph has not been compiled.
+     */
+    const RenderGraphScheduler::Schedule* getSchedule() const { return mpExe ? &mpExe->getSchedule() : nullptr; }
+
 private:
     struct EdgeData
     {
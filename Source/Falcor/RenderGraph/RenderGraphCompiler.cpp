@@ -40,6 +40,25 @@ bool canAutoResolve(const RenderPassReflection::Field& src, const RenderPassRefl
 {
     return src.getSampleCount() > 1 && dst.getSampleCount() == 1;
 }
+
+/// Returns the state a pass leaves an output resource in.
+Resource::State getOutputState(const RenderPassReflection::Field& field)
+{
+    ResourceBindFlags flags = field.getBindFlags();
+    if (is_set(flags, ResourceBindFlags::DepthStencil))
+        return Resource::State::DepthStencil;
+    if (is_set(flags, ResourceBindFlags::RenderTarget))
+        return Resource::State::RenderTarget;
+    return Resource::State::UnorderedAccess;
+}
+
+/// Returns the state a pass requires an input resource to be in.
+Resource::State getInputState(const RenderPassReflection::Field& field)
+{
+    if (is_set(field.getVisibility(), RenderPassReflection::Field::Visibility::Output))
+        return getOutputState(field);
+    return Resource::State::ShaderResource;
+}
 } // namespace
 
 RenderGraphCompiler::RenderGraphCompiler(RenderGraph& graph, const Dependencies& dependencies)
@@ -65,6 +84,7 @@ std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
         c.resolveExecutionOrder();
     c.validateGraph();
     c.allocateResources(pRenderContext->getDevice(), pResourcesCache.get());
+    auto schedule = c.planSchedule();
 
     auto pExe = std::make_unique<RenderGraphExe>();
     pExe->mExecutionList.reserve(c.mExecutionList.size());
@@ -75,6 +95,7 @@ std::unique_ptr<RenderGraphExe> RenderGraphCompiler::compile(
     }
     c.restoreCompilationChanges();
     pExe->mpResourceCache = std::move(pResourcesCache);
+    pExe->mSchedule = std::move(schedule);
     return pExe;
 }
 
@@ -119,6 +140,49 @@ void RenderGraphCompiler::validateGraph() const
         FALCOR_THROW(err);
 }
 
+RenderGraphScheduler::Schedule RenderGraphCompiler::planSchedule() const
+{
+    std::vector<RenderGraphScheduler::PassDesc> passes;
+    passes.reserve(mExecutionList.size());
+    std::unordered_map<uint32_t, uint32_t> nodeToPass;
+    for (const auto& p : mExecutionList)
+    {
+        nodeToPass[p.index] = (uint32_t)passes.size();
+        passes.push_back({p.name, p.pPass->getScheduleHints()});
+    }
+
+    std::vector<RenderGraphScheduler::EdgeDesc> edges;
+    for (uint32_t dst = 0; dst < mExecutionList.size(); dst++)
+    {
+        const auto& dstPass = mExecutionList[dst];
+        const DirectedGraph::Node* pNode = mGraph.mpGraph->getNode(dstPass.index);
+        for (uint32_t e = 0; e < pNode->getIncomingEdgeCount(); e++)
+        {
+            uint32_t edgeIndex = pNode->getIncomingEdge(e);
+            auto it = nodeToPass.find(mGraph.mpGraph->getEdge(edgeIndex)->getSourceNode());
+            if (it == nodeToPass.end())
+                continue;
+
+            RenderGraphScheduler::EdgeDesc edge;
+            edge.srcPass = it->second;
+            edge.dstPass = dst;
+
+            // Execution-edges only create a dependency.
+            const auto& edgeData = mGraph.mEdgeData.at(edgeIndex);
+            if (!edgeData.srcField.empty())
+            {
+                const auto& srcPass = mExecutionList[it->second];
+                edge.resource = srcPass.name + '.' + edgeData.srcField;
+                edge.srcState = getOutputState(*srcPass.reflector.getField(edgeData.srcField));
+                edge.dstState = getInputState(*dstPass.reflector.getField(edgeData.dstField));
+            }
+            edges.push_back(std::move(edge));
+        }
+    }
+
+    return RenderGraphScheduler::plan(passes, edges);
+}
+
 void RenderGraphCompiler::resolveExecutionOrder()
 {
     mExecutionList.clear();
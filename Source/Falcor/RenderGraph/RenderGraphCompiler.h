@@ -77,6 +77,7 @@ private:
     bool insertAutoPasses();
     void allocateResources(ref<Device> pDevice, ResourceCache* pResourceCache);
     void validateGraph() const;
+    RenderGraphScheduler::Schedule planSchedule() const;
     void restoreCompilationChanges();
     RenderPass::CompileData prepPassCompilationData(const PassData& passData);
 };
@@ -28,6 +28,7 @@
 #pragma once
 #include "RenderPass.h"
 #include "ResourceCache.h"
+#include "RenderGraphScheduler.h"
 #include "Core/Macros.h"
 #include "Core/HotReloadFlags.h"
 #include "Core/API/Formats.h"
@@ -94,6 +95,12 @@ public:
      */
     void setInput(const std::string& name, const ref<Resource>& pResource);
 
+    /**
+     * Get the multi-queue schedule planned for the graph.
+     * Passes are currently executed serially on a single render context in execution list order.
+     */
+    const RenderGraphScheduler::Schedule& getSchedule() const { return mSchedule; }
+
 private:
     friend class RenderGraphCompiler;
 
@@ -111,5 +118,6 @@ private:
 
     std::vector<Pass> mExecutionList;
     std::unique_ptr<ResourceCache> mpResourceCache;
+    RenderGraphScheduler::Schedule mSchedule;
 };
 } // namespace Falcor
@@ -0,0 +1,414 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "RenderGraphScheduler.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <map>
+#include <queue>
+#include <set>
+
+namespace Falcor
+{
+namespace
+{
+using Queue = RenderGraphScheduler::Queue;
+using QueueMask = uint32_t;
+
+constexpr QueueMask queueBit(Queue queue)
+{
+    return 1u << (uint32_t)queue;
+}
+
+constexpr QueueMask kGraphicsOnly = queueBit(Queue::Graphics);
+
+using Clock = std::array<uint64_t, RenderGraphScheduler::kQueueCount>;
+} // namespace
+
+bool RenderGraphScheduler::canRunOn(Queue preferred, Queue queue)
+{
+    switch (preferred)
+    {
+    case Queue::Graphics:
+        return queue == Queue::Graphics;
+    case Queue::Compute:
+        return queue == Queue::Graphics || queue == Queue::Compute;
+    case Queue::Copy:
+        return queue != Queue::Count;
+    default:
+        FALCOR_UNREACHABLE();
+        return false;
+    }
+}
+
+bool RenderGraphScheduler::isStateSupported(Queue queue, Resource::State state)
+{
+    using State = Resource::State;
+
+    switch (queue)
+    {
+    case Queue::Graphics:
+        return true;
+    case Queue::Compute:
+        switch (state)
+        {
+        case State::VertexBuffer:
+        case State::IndexBuffer:
+        case State::RenderTarget:
+        case State::DepthStencil:
+        case State::StreamOut:
+        case State::ResolveDest:
+        case State::ResolveSource:
+        case State::Present:
+        case State::PixelShader:
+            return false;
+        default:
+            return true;
+        }
+    case Queue::Copy:
+        return state == State::Common || state == State::CopyDest || state == State::CopySource;
+    default:
+        FALCOR_UNREACHABLE();
+        return false;
+    }
+}
+
+RenderGraphScheduler::Schedule RenderGraphScheduler::plan(
+    const std::vector<PassDesc>& passes,
+    const std::vector<EdgeDesc>& edges,
+    const Options& options
+)
+{
+    const uint32_t passCount = (uint32_t)passes.size();
+
+    // Build adjacency lists. Duplicate edges between the same passes only create one dependency.
+    std::vector<std::vector<uint32_t>> preds(passCount), succs(passCount);
+    {
+        std::set<std::pair<uint32_t, uint32_t>> dependencies;
+        for (const auto& e : edges)
+        {
+            FALCOR_CHECK(e.srcPass < passCount && e.dstPass < passCount, "Render graph edge references an invalid pass.");
+            FALCOR_CHECK(e.srcPass != e.dstPass, "Render graph edge connects pass '{}' to itself.", passes[e.srcPass].name);
+            if (dependencies.emplace(e.srcPass, e.dstPass).second)
+            {
+                preds[e.dstPass].push_back(e.srcPass);
+                succs[e.srcPass].push_back(e.dstPass);
+            }
+        }
+    }
+    for (const auto& p : passes)
+        FALCOR_CHECK(p.hints.cost >= 0.f, "Pass '{}' has a negative cost hint.", p.name);
+
+    // Determine the queues each pass may run on.
+    // A queue is only allowed if it supports the states of all resources the pass produces and consumes.
+    std::vector<QueueMask> allowedQueues(passCount, 0);
+    for (uint32_t i = 0; i < passCount; i++)
+    {
+        for (uint32_t q = 0; q < kQueueCount; q++)
+        {
+            Queue queue = Queue(q);
+            if ((options.enabledQueues[q] || queue == Queue::Graphics) && canRunOn(passes[i].hints.queue, queue))
+                allowedQueues[i] |= queueBit(queue);
+        }
+    }
+    for (const auto& e : edges)
+    {
+        if (e.resource.empty())
+            continue;
+        for (uint32_t q = 0; q < kQueueCount; q++)
+        {
+            if (!isStateSupported(Queue(q), e.srcState))
+                allowedQueues[e.srcPass] &= ~queueBit(Queue(q));
+            if (!isStateSupported(Queue(q), e.dstState))
+                allowedQueues[e.dstPass] &= ~queueBit(Queue(q));
+        }
+    }
+
+    // Group resource edges by produced resource.
+    // Resources that are consumed in different states are transitioned in sequence, which requires all consumers to be on one queue.
+    std::map<std::pair<uint32_t, std::string>, std::vector<uint32_t>> resourceEdges;
+    for (uint32_t i = 0; i < (uint32_t)edges.size(); i++)
+    {
+        if (!edges[i].resource.empty())
+            resourceEdges[{edges[i].srcPass, edges[i].resource}].push_back(i);
+    }
+    for (const auto& [key, edgeIndices] : resourceEdges)
+    {
+        bool uniformState = std::all_of(
+            edgeIndices.begin(), edgeIndices.end(), [&](uint32_t e) { return edges[e].dstState == edges[edgeIndices[0]].dstState; }
+        );
+        if (!uniformState)
+        {
+            for (uint32_t e : edgeIndices)
+                allowedQueues[edges[e].dstPass] = kGraphicsOnly;
+        }
+    }
+    FALCOR_ASSERT(std::all_of(allowedQueues.begin(), allowedQueues.end(), [](QueueMask mask) { return (mask & kGraphicsOnly) != 0; }));
+
+    // Compute a topological order and the upward rank of each pass.
+    std::vector<uint32_t> topoOrder;
+    topoOrder.reserve(passCount);
+    {
+        std::vector<uint32_t> inDegree(passCount);
+        for (uint32_t i = 0; i < passCount; i++)
+        {
+            inDegree[i] = (uint32_t)preds[i].size();
+            if (inDegree[i] == 0)
+                topoOrder.push_back(i);
+        }
+        for (size_t i = 0; i < topoOrder.size(); i++)
+        {
+            for (uint32_t s : succs[topoOrder[i]])
+            {
+                if (--inDegree[s] == 0)
+                    topoOrder.push_back(s);
+            }
+        }
+        FALCOR_CHECK(topoOrder.size() == passCount, "Render graph contains a dependency cycle.");
+    }
+
+    std::vector<float> rank(passCount, 0.f);
+    for (auto it = topoOrder.rbegin(); it != topoOrder.rend(); ++it)
+    {
+        float maxSucc = 0.f;
+        for (uint32_t s : succs[*it])
+            maxSucc = std::max(maxSucc, rank[s]);
+        rank[*it] = passes[*it].hints.cost + maxSucc;
+    }
+
+    Schedule schedule;
+    schedule.passToScheduled.resize(passCount, kInvalidIndex);
+    schedule.passes.reserve(passCount);
+    for (float r : rank)
+        schedule.criticalPath = std::max(schedule.criticalPath, r);
+
+    // List scheduling. Ready passes are picked by decreasing rank and placed on the allowed queue
+    // that finishes them the earliest. Ties prefer the hinted queue, then the lowest queue index.
+    {
+        auto lowerPriority = [&](uint32_t a, uint32_t b) { return rank[a] != rank[b] ? rank[a] < rank[b] : a > b; };
+        std::priority_queue<uint32_t, std::vector<uint32_t>, decltype(lowerPriority)> ready(lowerPriority);
+        std::vector<uint32_t> remainingPreds(passCount);
+        for (uint32_t i = 0; i < passCount; i++)
+        {
+            remainingPreds[i] = (uint32_t)preds[i].size();
+            if (remainingPreds[i] == 0)
+                ready.push(i);
+        }
+
+        std::array<float, kQueueCount> queueAvailable = {};
+        while (!ready.empty())
+        {
+            uint32_t pass = ready.top();
+            ready.pop();
+
+            Queue bestQueue = Queue::Count;
+            float bestStart = 0.f;
+            float bestFinish = 0.f;
+            for (uint32_t q = 0; q < kQueueCount; q++)
+            {
+                Queue queue = Queue(q);
+                if (!(allowedQueues[pass] & queueBit(queue)))
+                    continue;
+
+                float start = queueAvailable[q];
+                for (uint32_t p : preds[pass])
+                {
+                    const auto& pred = schedule.passes[schedule.passToScheduled[p]];
+                    start = std::max(start, pred.finish + (pred.queue != queue ? options.syncCost : 0.f));
+                }
+                float finish = start + passes[pass].hints.cost;
+
+                bool better = bestQueue == Queue::Count || finish < bestFinish ||
+                              (finish == bestFinish && queue == passes[pass].hints.queue && bestQueue != passes[pass].hints.queue);
+                if (better)
+                {
+                    bestQueue = queue;
+                    bestStart = start;
+                    bestFinish = finish;
+                }
+            }
+            FALCOR_ASSERT(bestQueue != Queue::Count);
+
+            ScheduledPass scheduled;
+            scheduled.pass = pass;
+            scheduled.queue = bestQueue;
+            scheduled.start = bestStart;
+            scheduled.finish = bestFinish;
+            auto& queueList = schedule.queues[(uint32_t)bestQueue];
+            scheduled.fenceValue = queueList.size() + 1;
+            queueList.push_back((uint32_t)schedule.passes.size());
+            queueAvailable[(uint32_t)bestQueue] = bestFinish;
+
+            schedule.passToScheduled[pass] = (uint32_t)schedule.passes.size();
+            schedule.passes.push_back(std::move(scheduled));
+
+            for (uint32_t s : succs[pass])
+            {
+                if (--remainingPreds[s] == 0)
+                    ready.push(s);
+            }
+        }
+    }
+
+    auto scheduledOf = [&](uint32_t pass) -> ScheduledPass& { return schedule.passes[schedule.passToScheduled[pass]]; };
+
+    // Place resource transitions.
+    // Transitions are issued as late as possible on the consuming queue when all consumers share the producer's queue.
+    // Resources shared across queues are transitioned once, after the producer if its queue supports the state, or before
+    // the first consumer otherwise. In the latter case the other consumers additionally wait for that consumer.
+    std::vector<std::vector<uint32_t>> extraPreds(passCount);
+    for (auto& [key, edgeIndices] : resourceEdges)
+    {
+        const auto& [producer, resource] = key;
+        std::sort(
+            edgeIndices.begin(),
+            edgeIndices.end(),
+            [&](uint32_t a, uint32_t b)
+            { return schedule.passToScheduled[edges[a].dstPass] < schedule.passToScheduled[edges[b].dstPass]; }
+        );
+
+        const Queue producerQueue = scheduledOf(producer).queue;
+        const Resource::State srcState = edges[edgeIndices[0]].srcState;
+        bool uniformState = std::all_of(
+            edgeIndices.begin(), edgeIndices.end(), [&](uint32_t e) { return edges[e].dstState == edges[edgeIndices[0]].dstState; }
+        );
+        bool sameQueue = std::all_of(
+            edgeIndices.begin(), edgeIndices.end(), [&](uint32_t e) { return scheduledOf(edges[e].dstPass).queue == producerQueue; }
+        );
+
+        if (!uniformState || sameQueue)
+        {
+            // All consumers are on a single queue (consumers in different states are restricted to the graphics queue).
+            Resource::State state = srcState;
+            for (uint32_t e : edgeIndices)
+            {
+                if (edges[e].dstState != state)
+                {
+                    scheduledOf(edges[e].dstPass).preTransitions.push_back({resource, state, edges[e].dstState});
+                    state = edges[e].dstState;
+                }
+            }
+        }
+        else
+        {
+            const Resource::State dstState = edges[edgeIndices[0]].dstState;
+            if (dstState == srcState)
+                continue;
+
+            if (isStateSupported(producerQueue, dstState))
+            {
+                scheduledOf(producer).postTransitions.push_back({resource, srcState, dstState});
+            }
+            else
+            {
+                uint32_t owner = edges[edgeIndices[0]].dstPass;
+                scheduledOf(owner).preTransitions.push_back({resource, srcState, dstState});
+                for (size_t i = 1; i < edgeIndices.size(); i++)
+                {
+                    uint32_t consumer = edges[edgeIndices[i]].dstPass;
+                    if (scheduledOf(consumer).queue != scheduledOf(owner).queue)
+                        extraPreds[consumer].push_back(owner);
+                }
+            }
+        }
+    }
+
+    // Re-estimate timings with the added dependencies and compute the sync points.
+    // Each queue tracks a vector clock of the fence values it is known to have waited for, which removes
+    // waits that are already implied by earlier waits on the same queue (directly or transitively).
+    std::vector<Clock> clockAfter(schedule.passes.size());
+    std::array<Clock, kQueueCount> queueClock = {};
+    std::array<float, kQueueCount> queueAvailable = {};
+    for (uint32_t i = 0; i < (uint32_t)schedule.passes.size(); i++)
+    {
+        ScheduledPass& scheduled = schedule.passes[i];
+        const uint32_t q = (uint32_t)scheduled.queue;
+
+        // Collect the latest required fence value per queue.
+        Clock required = {};
+        std::array<uint32_t, kQueueCount> signalPass;
+        signalPass.fill(kInvalidIndex);
+        float start = queueAvailable[q];
+        auto addDependency = [&](uint32_t p)
+        {
+            uint32_t dep = schedule.passToScheduled[p];
+            FALCOR_ASSERT(dep < i);
+            const auto& depPass = schedule.passes[dep];
+            uint32_t r = (uint32_t)depPass.queue;
+            start = std::max(start, depPass.finish + (r != q ? options.syncCost : 0.f));
+            if (r != q && depPass.fenceValue > required[r])
+            {
+                required[r] = depPass.fenceValue;
+                signalPass[r] = dep;
+            }
+        };
+        for (uint32_t p : preds[scheduled.pass])
+            addDependency(p);
+        for (uint32_t p : extraPreds[scheduled.pass])
+            addDependency(p);
+
+        // Drop waits that are already satisfied or implied by another required wait.
+        std::array<bool, kQueueCount> needWait = {};
+        for (uint32_t r = 0; r < kQueueCount; r++)
+        {
+            if (required[r] == 0 || queueClock[q][r] >= required[r])
+                continue;
+            needWait[r] = true;
+            for (uint32_t o = 0; o < kQueueCount; o++)
+            {
+                if (o != r && required[o] != 0 && clockAfter[signalPass[o]][r] >= required[r])
+                {
+                    needWait[r] = false;
+                    break;
+                }
+            }
+        }
+
+        for (uint32_t r = 0; r < kQueueCount; r++)
+        {
+            if (!needWait[r])
+                continue;
+            ScheduledPass& signaler = schedule.passes[signalPass[r]];
+            signaler.signal = true;
+            scheduled.waits.push_back((uint32_t)schedule.syncPoints.size());
+            schedule.syncPoints.push_back({signaler.queue, signaler.pass, signaler.fenceValue, scheduled.queue, scheduled.pass});
+            for (uint32_t c = 0; c < kQueueCount; c++)
+                queueClock[q][c] = std::max(queueClock[q][c], clockAfter[signalPass[r]][c]);
+        }
+
+        queueClock[q][q] = scheduled.fenceValue;
+        clockAfter[i] = queueClock[q];
+
+        scheduled.start = start;
+        scheduled.finish = start + passes[scheduled.pass].hints.cost;
+        queueAvailable[q] = scheduled.finish;
+        schedule.makespan = std::max(schedule.makespan, scheduled.finish);
+    }
+
+    return schedule;
+}
+} // namespace Falcor
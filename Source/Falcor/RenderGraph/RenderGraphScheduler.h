@@ -0,0 +1,177 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Enum.h"
+#include "Core/API/Resource.h"
+#include <array>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Plans the execution of a render graph across multiple GPU queues.
+ *
+ * The scheduler takes a set of passes with queue and cost hints and the dependencies between them
+ * and produces a schedule that assigns each pass to a graphics, compute or copy queue.
+ * Passes are list-scheduled by decreasing upward rank (the cost of the longest path to a sink),
+ * which keeps the passes on the critical path from being delayed by independent work.
+ *
+ * The schedule contains the cross-queue sync points (fence signal/wait pairs) and the resource
+ * state transitions for each edge, batched per pass. The scheduler is pure CPU code and does not
+ * depend on a device, so it can be used on synthetic graphs.
+ */
+class FALCOR_API RenderGraphScheduler
+{
+public:
+    static constexpr uint32_t kInvalidIndex = uint32_t(-1);
+
+    enum class Queue : uint32_t
+    {
+        Graphics, ///< Universal queue. Supports all work and all resource states.
+        Compute,  ///< Async compute queue.
+        Copy,     ///< Copy/transfer queue.
+
+        Count
+    };
+    FALCOR_ENUM_INFO(
+        Queue,
+        {
+            {Queue::Graphics, "Graphics"},
+            {Queue::Compute, "Compute"},
+            {Queue::Copy, "Copy"},
+        }
+    );
+
+    static constexpr uint32_t kQueueCount = (uint32_t)Queue::Count;
+
+    /**
+     * Scheduling hints provided by a pass.
+     */
+    struct PassHints
+    {
+        Queue queue = Queue::Graphics; ///< Preferred queue. Compute work may also run on the graphics queue and copy work on any queue.
+        float cost = 1.f;              ///< Estimated execution cost in arbitrary units (e.g. milliseconds).
+    };
+
+    struct PassDesc
+    {
+        std::string name;
+        PassHints hints;
+    };
+
+    /**
+     * Dependency between two passes.
+     * Edges with an empty resource name are pure execution dependencies without a resource transition.
+     */
+    struct EdgeDesc
+    {
+        uint32_t srcPass = kInvalidIndex;
+        uint32_t dstPass = kInvalidIndex;
+        std::string resource;                                 ///< Name of the resource passed along the edge.
+        Resource::State srcState = Resource::State::Common; ///< State the resource is left in by the source pass.
+        Resource::State dstState = Resource::State::Common; ///< State the resource is required in by the destination pass.
+    };
+
+    struct Options
+    {
+        /// Queues available for scheduling. The graphics queue is always used.
+        std::array<bool, kQueueCount> enabledQueues = {true, true, true};
+        float syncCost = 0.f; ///< Estimated cost of a cross-queue wait. Higher values keep dependent passes on the same queue.
+    };
+
+    struct Transition
+    {
+        std::string resource;
+        Resource::State before = Resource::State::Common;
+        Resource::State after = Resource::State::Common;
+    };
+
+    /**
+     * Cross-queue synchronization. The wait queue waits until the signal queue's fence reaches the fence value.
+     */
+    struct SyncPoint
+    {
+        Queue signalQueue = Queue::Graphics;
+        uint32_t signalPass = kInvalidIndex; ///< Pass after which the fence is signaled.
+        uint64_t fenceValue = 0;
+        Queue waitQueue = Queue::Graphics;
+        uint32_t waitPass = kInvalidIndex; ///< Pass before which the wait is inserted.
+    };
+
+    struct ScheduledPass
+    {
+        uint32_t pass = kInvalidIndex;   ///< Index of the pass in the input pass list.
+        Queue queue = Queue::Graphics;   ///< Queue the pass is executed on.
+        uint64_t fenceValue = 0;         ///< Fence value of the pass's queue after the pass (its 1-based position on the queue).
+        bool signal = false;             ///< True if another queue waits for this pass, i.e. the fence needs to be signaled after the pass.
+        float start = 0.f;               ///< Estimated start time.
+        float finish = 0.f;              ///< Estimated finish time.
+        std::vector<uint32_t> waits;     ///< Sync points (indices into Schedule::syncPoints) to wait for before the pass.
+        std::vector<Transition> preTransitions;  ///< Transitions to issue before the pass, after the waits.
+        std::vector<Transition> postTransitions; ///< Transitions to issue after the pass, before signaling.
+    };
+
+    struct Schedule
+    {
+        std::vector<ScheduledPass> passes;                    ///< Scheduled passes in submission order. This is a valid topological order.
+        std::array<std::vector<uint32_t>, kQueueCount> queues; ///< Per-queue execution order (indices into passes).
+        std::vector<uint32_t> passToScheduled;                ///< Maps input pass index to index into passes.
+        std::vector<SyncPoint> syncPoints;                    ///< All sync points, ordered by wait pass submission order.
+        float criticalPath = 0.f;                             ///< Cost of the longest dependency chain, a lower bound on the makespan.
+        float makespan = 0.f;                                 ///< Estimated time until all queues have finished.
+
+        const ScheduledPass& getPass(uint32_t pass) const { return passes[passToScheduled[pass]]; }
+    };
+
+    /**
+     * Plan the execution of a set of passes.
+     * Throws if the dependencies contain a cycle or reference invalid passes.
+     * @param[in] passes Pass descriptions.
+     * @param[in] edges Dependencies between passes.
+     * @param[in] options Scheduling options.
+     * @return The schedule.
+     */
+    static Schedule plan(const std::vector<PassDesc>& passes, const std::vector<EdgeDesc>& edges, const Options& options);
+    static Schedule plan(const std::vector<PassDesc>& passes, const std::vector<EdgeDesc>& edges) { return plan(passes, edges, Options()); }
+
+    /**
+     * Check if work that prefers one queue can be executed on another queue.
+     */
+    static bool canRunOn(Queue preferred, Queue queue);
+
+    /**
+     * Check if resources can be transitioned to/from the given state on a queue.
+     * Shader resource reads are assumed to map to non-pixel shader reads on the compute queue.
+     */
+    static bool isStateSupported(Queue queue, Resource::State state);
+};
+
+FALCOR_ENUM_REGISTER(RenderGraphScheduler::Queue);
+} // namespace Falcor
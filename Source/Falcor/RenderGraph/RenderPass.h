@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "ResourceCache.h"
+#include "RenderGraphScheduler.h"
 #include "Core/Macros.h"
 #include "Core/Object.h"
 #include "Core/Plugin.h"
@@ -188,6 +189,12 @@ public:
      */
     virtual Properties getProperties() const { return {}; }
 
+    /**
+     * Get hints for scheduling the pass across GPU queues.
+     * Passes that only issue compute or copy work should return the matching queue and an estimated cost.
+     */
+    virtual RenderGraphScheduler::PassHints getScheduleHints() const { return {}; }
+
     /**
      * Render the pass's UI
      * *   Note: This is deprecated.
@@ -0,0 +1,473 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AnalyticLightBVH.h"
+#include "LightBVHCostModel.h"
+#include "Core/Error.h"
+#include "Utils/Color/ColorHelpers.slang"
+#include <algorithm>
+#include <limits>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint64_t kInvalidBitmask = std::numeric_limits<uint64_t>::max();
+
+        uint32_t ceilLog2(uint32_t count)
+        {
+            uint32_t log2 = 0;
+            while (log2 < 32 && (1ull << log2) < count) log2++;
+            return log2;
+        }
+
+        /** Returns true if a subtree with the given number of lights can be built starting at the given depth,
+            in the worst case by splitting the lights in equal halves.
+        */
+        bool fitsInTree(uint32_t depth, uint32_t lightCount)
+        {
+            return depth + ceilLog2(lightCount) <= AnalyticLightBVH::kMaxDepth;
+        }
+
+        uint32_t getLargestDimension(const float3& dimensions)
+        {
+            return dimensions[2] >= dimensions[0] && dimensions[2] >= dimensions[1] ? 2 : (dimensions[1] >= dimensions[0] ? 1 : 0);
+        }
+
+        AABB transformAABB(const float4x4& transform, const float3& minPoint, const float3& maxPoint)
+        {
+            AABB result;
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                float3 p = float3(i & 1 ? maxPoint.x : minPoint.x, i & 2 ? maxPoint.y : minPoint.y, i & 4 ? maxPoint.z : minPoint.z);
+                result |= transformPoint(transform, p);
+            }
+            return result;
+        }
+    }
+
+    void AnalyticLightBVH::build(const std::vector<LightData>& lights, const Options& options)
+    {
+        FALCOR_CHECK(options.binCount > 1, "Bin count must be larger than one.");
+        FALCOR_CHECK(lights.size() < AnalyticLightBVHNode::kLeafFlag, "Light count exceeds the maximum supported ({}).", AnalyticLightBVHNode::kLeafFlag);
+
+        clear();
+        mOptions = options;
+        mLightBitmasks.resize(lights.size(), kInvalidBitmask);
+
+        // Gather the local lights and their bounds.
+        std::vector<BuildItem> items;
+        items.reserve(lights.size());
+        for (uint32_t i = 0; i < (uint32_t)lights.size(); i++)
+        {
+            BuildItem item;
+            if (computeLightBounds(lights[i], item.lightBounds))
+            {
+                item.center = item.lightBounds.bounds.center();
+                item.lightIndex = i;
+                items.push_back(item);
+            }
+            else
+            {
+                mInfiniteLightIndices.push_back(i);
+            }
+        }
+
+        if (items.empty()) return;
+
+        // A binary tree with one light per leaf has exactly 2n-1 nodes.
+        mNodes.reserve(2 * items.size() - 1);
+        buildInternal(items, 0, (uint32_t)items.size(), 0, 0ull);
+        FALCOR_ASSERT(mNodes.size() == 2 * items.size() - 1);
+    }
+
+    void AnalyticLightBVH::refit(const std::vector<LightData>& lights)
+    {
+        FALCOR_CHECK(lights.size() == getLightCount(), "Light count has changed since the BVH was built.");
+        if (mNodes.empty()) return;
+
+        std::vector<LightBounds> lightBounds(lights.size());
+        for (uint32_t i = 0; i < (uint32_t)lights.size(); i++)
+        {
+            bool isLocal = computeLightBounds(lights[i], lightBounds[i]);
+            FALCOR_CHECK(isLocal == (mLightBitmasks[i] != kInvalidBitmask), "Light type has changed since the BVH was built.");
+        }
+
+        refitInternal(0, lightBounds);
+    }
+
+    void AnalyticLightBVH::clear()
+    {
+        mNodes.clear();
+        mInfiniteLightIndices.clear();
+        mLightBitmasks.clear();
+        mMaxDepth = 0;
+    }
+
+    bool AnalyticLightBVH::computeLightBounds(const LightData& light, LightBounds& lightBounds)
+    {
+        lightBounds = {};
+        const float luminanceIntensity = luminance(light.intensity);
+
+        switch ((LightType)light.type)
+        {
+        case LightType::Point:
+            lightBounds.bounds = AABB(light.posW);
+            lightBounds.intensity = luminanceIntensity;
+            // Spot lights emit within the opening angle around their direction.
+            if (light.cosOpeningAngle > -1.f && length(light.dirW) > 0.f)
+            {
+                lightBounds.coneDirection = normalize(light.dirW);
+                lightBounds.cosThetaO = 1.f;
+                lightBounds.cosThetaE = light.cosOpeningAngle;
+            }
+            return true;
+        case LightType::Rect:
+        case LightType::Disc:
+        {
+            // Single-sided emitters in the z=0 plane with extent [-1,1] in object space.
+            lightBounds.bounds = transformAABB(light.transMat, float3(-1.f, -1.f, 0.f), float3(1.f, 1.f, 0.f));
+            lightBounds.intensity = luminanceIntensity * light.surfaceArea;
+            float3 normal = transformVector(light.transMatIT, float3(0.f, 0.f, 1.f));
+            if (length(normal) > 0.f)
+            {
+                lightBounds.coneDirection = normalize(normal);
+                lightBounds.cosThetaO = 1.f;
+                lightBounds.cosThetaE = 0.f;
+            }
+            return true;
+        }
+        case LightType::Sphere:
+            // Unit sphere in object space. The peak intensity is the radiance times the projected area.
+            lightBounds.bounds = transformAABB(light.transMat, float3(-1.f), float3(1.f));
+            lightBounds.intensity = luminanceIntensity * light.surfaceArea * 0.25f;
+            return true;
+        case LightType::Directional:
+        case LightType::Distant:
+            return false;
+        default:
+            FALCOR_UNREACHABLE();
+            return false;
+        }
+    }
+
+    bool AnalyticLightBVH::sampleLight(const float3& posW, const float3& normalW, bool upperHemisphere, float u, uint32_t& lightIndex, float& pdf) const
+    {
+        const uint32_t lightCount = getLightCount();
+        if (lightCount == 0) return false;
+
+        // Select between the infinite lights and the tree.
+        const float pInfinite = getInfiniteLightSelectionProbability();
+        if (u < pInfinite)
+        {
+            const uint32_t infiniteLightCount = getInfiniteLightCount();
+            uint32_t idx = std::min((uint32_t)(u / pInfinite * infiniteLightCount), infiniteLightCount - 1);
+            lightIndex = mInfiniteLightIndices[idx];
+            pdf = 1.f / lightCount;
+            return true;
+        }
+        if (mNodes.empty()) return false;
+
+        // Stochastically traverse the tree. The random number is rescaled at each step.
+        u = (u - pInfinite) / (1.f - pInfinite);
+        pdf = 1.f - pInfinite;
+        uint32_t nodeIndex = 0;
+        while (!mNodes[nodeIndex].isLeaf())
+        {
+            const uint32_t leftIndex = nodeIndex + 1;
+            const uint32_t rightIndex = mNodes[nodeIndex].getRightChildIndex();
+            const float leftImportance = evalAnalyticLightBVHNodeImportance(mNodes[leftIndex], posW, normalW, upperHemisphere);
+            const float rightImportance = evalAnalyticLightBVHNodeImportance(mNodes[rightIndex], posW, normalW, upperHemisphere);
+            const float totalImportance = leftImportance + rightImportance;
+            if (totalImportance == 0.f) return false;
+
+            const float pLeft = leftImportance / totalImportance;
+            if (u < pLeft)
+            {
+                u = u / pLeft;
+                pdf *= pLeft;
+                nodeIndex = leftIndex;
+            }
+            else
+            {
+                const float pRight = 1.f - pLeft;
+                u = (u - pLeft) / pRight;
+                pdf *= pRight;
+                nodeIndex = rightIndex;
+            }
+        }
+
+        lightIndex = mNodes[nodeIndex].getLightIndex();
+        return true;
+    }
+
+    float AnalyticLightBVH::evalLightSelectionPdf(const float3& posW, const float3& normalW, bool upperHemisphere, uint32_t lightIndex) const
+    {
+        FALCOR_CHECK(lightIndex < getLightCount(), "Light index {} is out of range.", lightIndex);
+
+        const uint64_t bitmask = mLightBitmasks[lightIndex];
+        if (bitmask == kInvalidBitmask) return 1.f / getLightCount();
+
+        // Follow the traversal path to the light's leaf node.
+        const float pInfinite = getInfiniteLightSelectionProbability();
+        float pdf = 1.f - pInfinite;
+        uint32_t nodeIndex = 0;
+        for (uint32_t depth = 0; !mNodes[nodeIndex].isLeaf(); depth++)
+        {
+            FALCOR_ASSERT(depth < kMaxDepth);
+            const uint32_t leftIndex = nodeIndex + 1;
+            const uint32_t rightIndex = mNodes[nodeIndex].getRightChildIndex();
+            const float leftImportance = evalAnalyticLightBVHNodeImportance(mNodes[leftIndex], posW, normalW, upperHemisphere);
+            const float rightImportance = evalAnalyticLightBVHNodeImportance(mNodes[rightIndex], posW, normalW, upperHemisphere);
+            const float totalImportance = leftImportance + rightImportance;
+            if (totalImportance == 0.f) return 0.f;
+
+            const float pLeft = leftImportance / totalImportance;
+            if ((bitmask >> depth) & 1)
+            {
+                pdf *= 1.f - pLeft;
+                nodeIndex = rightIndex;
+            }
+            else
+            {
+                pdf *= pLeft;
+                nodeIndex = leftIndex;
+            }
+        }
+        FALCOR_ASSERT(mNodes[nodeIndex].getLightIndex() == lightIndex);
+
+        return pdf;
+    }
+
+    uint32_t AnalyticLightBVH::buildInternal(std::vector<BuildItem>& items, uint32_t begin, uint32_t end, uint32_t depth, uint64_t bitmask)
+    {
+        FALCOR_ASSERT(begin < end && fitsInTree(depth, end - begin));
+
+        const uint32_t nodeIndex = (uint32_t)mNodes.size();
+        mNodes.push_back({});
+
+        if (end - begin == 1)
+        {
+            const BuildItem& item = items[begin];
+            mNodes[nodeIndex] = createLeafNode(item.lightBounds, item.lightIndex);
+            mLightBitmasks[item.lightIndex] = bitmask;
+            mMaxDepth = std::max(mMaxDepth, depth);
+            return nodeIndex;
+        }
+
+        AABB centerBounds;
+        for (uint32_t i = begin; i < end; i++) centerBounds |= items[i].center;
+
+        // Partition the lights around the split.
+        uint32_t axis = 0;
+        const uint32_t split = findSplit(items, begin, end, depth, centerBounds, axis);
+        FALCOR_ASSERT(begin < split && split < end);
+        auto comp = [axis](const BuildItem& a, const BuildItem& b) { return a.center[axis] < b.center[axis]; };
+        std::nth_element(items.begin() + begin, items.begin() + split, items.begin() + end, comp);
+
+        uint32_t leftIndex = buildInternal(items, begin, split, depth + 1, bitmask);
+        uint32_t rightIndex = buildInternal(items, split, end, depth + 1, bitmask | (1ull << depth));
+        FALCOR_ASSERT(leftIndex == nodeIndex + 1);
+
+        AnalyticLightBVHNode node;
+        mergeNodes(mNodes[leftIndex], mNodes[rightIndex], node);
+        node.childOrLightIndex = rightIndex;
+        mNodes[nodeIndex] = node;
+        return nodeIndex;
+    }
+
+    uint32_t AnalyticLightBVH::findSplit(const std::vector<BuildItem>& items, uint32_t begin, uint32_t end, uint32_t depth, const AABB& centerBounds, uint32_t& axis) const
+    {
+        LightBVHCostModel::Params params;
+        params.usePreintegration = mOptions.usePreintegration;
+        params.useLightingCones = mOptions.useLightingCones;
+        params.useVolumeOverSA = mOptions.useVolumeOverSA;
+        params.volumeEpsilon = mOptions.volumeEpsilon;
+
+        struct Bin
+        {
+            AABB bounds;
+            uint32_t lightCount = 0;
+            float intensity = 0.f;
+            float3 coneDirection = float3(0.f);
+            float cosThetaO = 1.f;
+            float cosThetaE = 1.f;
+
+            Bin& operator|=(const Bin& rhs)
+            {
+                bounds |= rhs.bounds;
+                lightCount += rhs.lightCount;
+                intensity += rhs.intensity;
+                coneDirection += rhs.coneDirection;
+                cosThetaE = std::min(cosThetaE, rhs.cosThetaE);
+                // Note: cosThetaO is computed separately once the cone direction is known.
+                return *this;
+            }
+        };
+
+        const uint32_t binCount = mOptions.binCount;
+        std::vector<Bin> bins(binCount);
+        const float3 dimensions = centerBounds.extent();
+
+        float bestCost = std::numeric_limits<float>::infinity();
+        uint32_t bestSplit = 0;
+
+        // Computes the SAOH cost of the union of bins [first, last].
+        auto evalBinRange = [&](uint32_t first, uint32_t last)
+        {
+            Bin total;
+            for (uint32_t j = first; j <= last; j++) total |= bins[j];
+            if (total.lightCount == 0) return 0.f;
+
+            // The cone direction is the average over all lights and the spread angle is grown to include all bins.
+            float cosThetaO = kInvalidCosConeAngle;
+            if (length(total.coneDirection) >= FLT_MIN)
+            {
+                const float3 coneDirection = normalize(total.coneDirection);
+                cosThetaO = 1.f;
+                for (uint32_t j = first; j <= last; j++)
+                {
+                    if (bins[j].lightCount == 0) continue;
+                    cosThetaO = LightBVHCostModel::computeCosConeAngle(coneDirection, cosThetaO, bins[j].coneDirection, bins[j].cosThetaO);
+                }
+            }
+            return LightBVHCostModel::evalSAOH(total.bounds, total.intensity, cosThetaO, total.cosThetaE, params);
+        };
+
+        // Bin the lights by their centers along a dimension and evaluate the binCount - 1 possible splits.
+        auto binAlongDimension = [&](uint32_t dimension)
+        {
+            const float bmin = centerBounds.minPoint[dimension];
+            const float w = dimensions[dimension];
+            if (!(w > 0.f)) return;
+            const float scale = (float)binCount / w;
+            auto getBinId = [&](const BuildItem& item) { return std::min((uint32_t)((item.center[dimension] - bmin) * scale), binCount - 1); };
+
+            for (Bin& bin : bins) bin = Bin();
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const LightBounds& lb = items[i].lightBounds;
+                Bin& bin = bins[getBinId(items[i])];
+                bin.bounds |= lb.bounds;
+                bin.lightCount++;
+                bin.intensity += lb.intensity;
+                if (lb.cosThetaO != kInvalidCosConeAngle) bin.coneDirection += lb.coneDirection;
+                bin.cosThetaE = std::min(bin.cosThetaE, lb.cosThetaE);
+            }
+
+            // Compute the bounding cones of the bins.
+            for (Bin& bin : bins)
+            {
+                bin.cosThetaO = length(bin.coneDirection) < FLT_MIN ? kInvalidCosConeAngle : 1.f;
+                if (bin.cosThetaO != kInvalidCosConeAngle) bin.coneDirection = normalize(bin.coneDirection);
+            }
+            for (uint32_t i = begin; i < end; i++)
+            {
+                const LightBounds& lb = items[i].lightBounds;
+                Bin& bin = bins[getBinId(items[i])];
+                bin.cosThetaO = LightBVHCostModel::computeCosConeAngle(bin.coneDirection, bin.cosThetaO, lb.coneDirection, lb.cosThetaO);
+            }
+
+            uint32_t leftCount = 0;
+            for (uint32_t i = 0; i + 1 < binCount; i++)
+            {
+                leftCount += bins[i].lightCount;
+                const uint32_t rightCount = (end - begin) - leftCount;
+                if (leftCount == 0 || rightCount == 0) continue;
+                if (!fitsInTree(depth + 1, leftCount) || !fitsInTree(depth + 1, rightCount)) continue;
+
+                const float cost = evalBinRange(0, i) + evalBinRange(i + 1, binCount - 1);
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestSplit = begin + leftCount;
+                    axis = dimension;
+                }
+            }
+        };
+
+        if (mOptions.splitAlongLargest)
+        {
+            binAlongDimension(getLargestDimension(dimensions));
+        }
+        else
+        {
+            for (uint32_t dimension = 0; dimension < 3; dimension++) binAlongDimension(dimension);
+        }
+
+        // Revert to splitting the lights in equal halves if no valid split was found, e.g. when all lights are
+        // at the same position or the tree would become too deep.
+        if (bestSplit == 0)
+        {
+            axis = getLargestDimension(dimensions);
+            bestSplit = (begin + end) / 2;
+        }
+        return bestSplit;
+    }
+
+    void AnalyticLightBVH::refitInternal(uint32_t nodeIndex, const std::vector<LightBounds>& lightBounds)
+    {
+        AnalyticLightBVHNode& node = mNodes[nodeIndex];
+        if (node.isLeaf())
+        {
+            const uint32_t lightIndex = node.getLightIndex();
+            node = createLeafNode(lightBounds[lightIndex], lightIndex);
+            return;
+        }
+
+        const uint32_t leftIndex = nodeIndex + 1;
+        const uint32_t rightIndex = node.getRightChildIndex();
+        refitInternal(leftIndex, lightBounds);
+        refitInternal(rightIndex, lightBounds);
+        mergeNodes(mNodes[leftIndex], mNodes[rightIndex], mNodes[nodeIndex]);
+        FALCOR_ASSERT(mNodes[nodeIndex].getRightChildIndex() == rightIndex);
+    }
+
+    AnalyticLightBVHNode AnalyticLightBVH::createLeafNode(const LightBounds& lightBounds, uint32_t lightIndex)
+    {
+        AnalyticLightBVHNode node;
+        node.origin = lightBounds.bounds.center();
+        node.extent = lightBounds.bounds.extent() * 0.5f;
+        node.childOrLightIndex = AnalyticLightBVHNode::kLeafFlag | lightIndex;
+        node.intensity = lightBounds.intensity;
+        node.coneDirection = lightBounds.coneDirection;
+        node.cosThetaO = lightBounds.cosThetaO;
+        node.cosThetaE = lightBounds.cosThetaE;
+        return node;
+    }
+
+    void AnalyticLightBVH::mergeNodes(const AnalyticLightBVHNode& left, const AnalyticLightBVHNode& right, AnalyticLightBVHNode& node)
+    {
+        AABB bounds(left.origin - left.extent, left.origin + left.extent);
+        bounds |= AABB(right.origin - right.extent, right.origin + right.extent);
+        node.origin = bounds.center();
+        node.extent = bounds.extent() * 0.5f;
+        node.intensity = left.intensity + right.intensity;
+        node.coneDirection = LightBVHCostModel::coneUnionAverageAxis(left.coneDirection, left.cosThetaO, right.coneDirection, right.cosThetaO, node.cosThetaO);
+        node.cosThetaE = std::min(left.cosThetaE, right.cosThetaE);
+    }
+}
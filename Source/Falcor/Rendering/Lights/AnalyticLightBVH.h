@@ -0,0 +1,192 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "AnalyticLightBVHTypes.slang"
+#include "Core/Macros.h"
+#include "Scene/Lights/LightData.slang"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Light BVH over the analytic lights of a scene, built on the CPU.
+
+        Point, spot and area lights are organized in a binary tree with a single light per leaf node.
+        The tree is built with the binned SAOH metric of LightBVHBuilder (see LightBVHCostModel),
+        where spot lights are bounded by orientation cones around their axes. Directional and distant
+        lights have no position and are kept in a separate list.
+
+        A light is selected by first choosing between the list of infinite lights and the tree,
+        with probabilities proportional to their light counts. Infinite lights are then picked uniformly,
+        while the tree is traversed stochastically based on the node importance (see
+        evalAnalyticLightBVHNodeImportance() in AnalyticLightBVHTypes.slang). The node importance is shared
+        with the GPU sampler (AnalyticLightBVHSampler.slang), so the functions here compute the exact
+        probabilities used when rendering.
+
+        When lights move or change, the tree can be refit to keep the hierarchy while updating the node bounds.
+    */
+    class FALCOR_API AnalyticLightBVH
+    {
+    public:
+        /** Maximum supported tree depth.
+            The limitation comes from storing the traversal path to each light in a bit mask.
+        */
+        static constexpr uint32_t kMaxDepth = 64;
+
+        /** Build configuration options.
+        */
+        struct Options
+        {
+            uint32_t binCount = 16;                 ///< How many bins to use when building the BVH.
+            bool     splitAlongLargest = false;     ///< Only compute the split along the largest dimension rather than along all 3 dimensions.
+            bool     useVolumeOverSA = false;       ///< Use the volume rather than the surface area of the AABB when computing the split cost.
+            float    volumeEpsilon = 1e-3f;         ///< Replace AABB dimensions that are zero by this value when computing volumes.
+            bool     usePreintegration = true;      ///< Use the light intensities when computing the split cost.
+            bool     useLightingCones = true;       ///< Use the orientation cones when computing the split cost.
+            bool     allowRefitting = true;         ///< Refit the BVH when lights move rather than rebuilding it.
+
+            template<typename Archive>
+            void serialize(Archive& ar)
+            {
+                ar("binCount", binCount);
+                ar("splitAlongLargest", splitAlongLargest);
+                ar("useVolumeOverSA", useVolumeOverSA);
+                ar("volumeEpsilon", volumeEpsilon);
+                ar("usePreintegration", usePreintegration);
+                ar("useLightingCones", useLightingCones);
+                ar("allowRefitting", allowRefitting);
+            }
+        };
+
+        /** Bounds of a single light.
+        */
+        struct LightBounds
+        {
+            AABB bounds;                            ///< World-space bounding box of the light.
+            float3 coneDirection = {};              ///< Emission axis.
+            float cosThetaO = kInvalidCosConeAngle; ///< Cosine of the spread angle of the emission axes, or kInvalidCosConeAngle for lights emitting in all directions.
+            float cosThetaE = 0.f;                  ///< Cosine of the emission angle around the axis.
+            float intensity = 0.f;                  ///< Peak radiant intensity (luminance).
+        };
+
+        /** Build the BVH.
+            \param[in] lights Light data of all active lights. The light indices in the BVH refer to this list.
+            \param[in] options Build options.
+        */
+        void build(const std::vector<LightData>& lights, const Options& options);
+
+        /** Refit the BVH to the current light data, keeping the hierarchy.
+            \param[in] lights Light data of all active lights. Must contain the same lights, and light types, as when the BVH was built.
+        */
+        void refit(const std::vector<LightData>& lights);
+
+        /** Clear the BVH.
+        */
+        void clear();
+
+        /** Compute the bounds of a light.
+            \param[in] light Light data.
+            \param[out] lightBounds Light bounds. Only valid if true is returned.
+            \return True if the light is a local light, false for directional and distant lights.
+        */
+        static bool computeLightBounds(const LightData& light, LightBounds& lightBounds);
+
+        /** Select a light based on the importance from a shading point.
+            \param[in] posW Shading point in world space.
+            \param[in] normalW Normal at the shading point in world space.
+            \param[in] upperHemisphere True if only upper hemisphere should be considered.
+            \param[in] u Uniform random number in [0,1).
+            \param[out] lightIndex Index of the selected light. Only valid if true is returned.
+            \param[out] pdf Probability of selecting the light. Only valid if true is returned.
+            \return True if a light was selected, false if no light can illuminate the shading point.
+        */
+        bool sampleLight(const float3& posW, const float3& normalW, bool upperHemisphere, float u, uint32_t& lightIndex, float& pdf) const;
+
+        /** Evaluate the probability of selecting a light with sampleLight().
+            \param[in] posW Shading point in world space.
+            \param[in] normalW Normal at the shading point in world space.
+            \param[in] upperHemisphere True if only upper hemisphere should be considered.
+            \param[in] lightIndex Index of the light.
+            \return Probability of selecting the light.
+        */
+        float evalLightSelectionPdf(const float3& posW, const float3& normalW, bool upperHemisphere, uint32_t lightIndex) const;
+
+        /** Returns the total number of lights, including infinite lights.
+        */
+        uint32_t getLightCount() const { return (uint32_t)mLightBitmasks.size(); }
+
+        /** Returns the number of lights in the tree.
+        */
+        uint32_t getLocalLightCount() const { return getLightCount() - getInfiniteLightCount(); }
+
+        /** Returns the number of directional and distant lights.
+        */
+        uint32_t getInfiniteLightCount() const { return (uint32_t)mInfiniteLightIndices.size(); }
+
+        /** Returns the probability of choosing the list of infinite lights rather than the tree.
+        */
+        float getInfiniteLightSelectionProbability() const { return getLightCount() > 0 ? (float)getInfiniteLightCount() / getLightCount() : 0.f; }
+
+        const std::vector<AnalyticLightBVHNode>& getNodes() const { return mNodes; }
+        const std::vector<uint32_t>& getInfiniteLightIndices() const { return mInfiniteLightIndices; }
+
+        /** Returns the bit mask of the traversal path to a light in the tree: 0=left child, 1=right child.
+            Infinite lights have all bits set.
+        */
+        uint64_t getLightBitmask(uint32_t lightIndex) const { return mLightBitmasks[lightIndex]; }
+
+        /** Returns the depth of the deepest leaf node.
+        */
+        uint32_t getMaxDepth() const { return mMaxDepth; }
+
+        const Options& getOptions() const { return mOptions; }
+
+    protected:
+        struct BuildItem
+        {
+            LightBounds lightBounds;
+            float3 center;
+            uint32_t lightIndex;
+        };
+
+        uint32_t buildInternal(std::vector<BuildItem>& items, uint32_t begin, uint32_t end, uint32_t depth, uint64_t bitmask);
+        uint32_t findSplit(const std::vector<BuildItem>& items, uint32_t begin, uint32_t end, uint32_t depth, const AABB& centerBounds, uint32_t& axis) const;
+        void refitInternal(uint32_t nodeIndex, const std::vector<LightBounds>& lightBounds);
+
+        static AnalyticLightBVHNode createLeafNode(const LightBounds& lightBounds, uint32_t lightIndex);
+        static void mergeNodes(const AnalyticLightBVHNode& left, const AnalyticLightBVHNode& right, AnalyticLightBVHNode& node);
+
+        Options mOptions;
+        std::vector<AnalyticLightBVHNode> mNodes;       ///< Nodes with the root node at index 0. Empty if there are no local lights.
+        std::vector<uint32_t> mInfiniteLightIndices;    ///< Indices of the directional and distant lights.
+        std::vector<uint64_t> mLightBitmasks;           ///< Traversal path to each light, indexed by light index.
+        uint32_t mMaxDepth = 0;
+    };
+}
@@ -0,0 +1,164 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AnalyticLightBVHSampler.h"
+#include "Core/Error.h"
+#include "Core/API/RenderContext.h"
+#include "Utils/Timing/Profiler.h"
+#include <cstring>
+
+namespace Falcor
+{
+    AnalyticLightBVHSampler::AnalyticLightBVHSampler(ref<Scene> pScene, const Options& options)
+        : mpDevice(pScene->getDevice())
+        , mpScene(pScene)
+        , mOptions(options)
+    {
+        FALCOR_ASSERT(pScene);
+    }
+
+    bool AnalyticLightBVHSampler::update(RenderContext* pRenderContext)
+    {
+        FALCOR_PROFILE(pRenderContext, "AnalyticLightBVHSampler::update");
+
+        bool needsRefit = false;
+
+        // Check if the lights have changed. Changing the set of active lights requires a rebuild.
+        auto updates = mpScene->getUpdates();
+        if (is_set(updates, Scene::UpdateFlags::LightCountChanged))
+        {
+            mNeedsRebuild = true;
+        }
+        else if (is_set(updates, Scene::UpdateFlags::LightsMoved) || is_set(updates, Scene::UpdateFlags::LightIntensityChanged) || is_set(updates, Scene::UpdateFlags::LightPropertiesChanged))
+        {
+            if (mOptions.allowRefitting && !mNeedsRebuild) needsRefit = true;
+            else mNeedsRebuild = true;
+        }
+
+        if (mNeedsRebuild)
+        {
+            mBVH.build(getActiveLightData(), mOptions);
+            mNeedsRebuild = false;
+        }
+        else if (needsRefit)
+        {
+            mBVH.refit(getActiveLightData());
+        }
+        else
+        {
+            return false;
+        }
+
+        uploadGPUBuffers();
+        return true;
+    }
+
+    void AnalyticLightBVHSampler::bindShaderData(const ShaderVar& var) const
+    {
+        FALCOR_ASSERT(var.isValid());
+
+        var["lightCount"] = mBVH.getLightCount();
+        var["infiniteLightCount"] = mBVH.getInfiniteLightCount();
+        var["nodes"] = mpNodesBuffer;
+        var["infiniteLights"] = mpInfiniteLightsBuffer;
+    }
+
+    bool AnalyticLightBVHSampler::renderUI(Gui::Widgets& widget)
+    {
+        bool optionsChanged = false;
+
+        if (auto buildGroup = widget.group("BVH building options"))
+        {
+            optionsChanged |= buildGroup.checkbox("Allow refitting", mOptions.allowRefitting);
+            optionsChanged |= buildGroup.var("Bin count", mOptions.binCount, 2u);
+            optionsChanged |= buildGroup.checkbox("Split along largest dimension", mOptions.splitAlongLargest);
+            optionsChanged |= buildGroup.checkbox("Use volume instead of surface area", mOptions.useVolumeOverSA);
+            if (mOptions.useVolumeOverSA)
+            {
+                optionsChanged |= buildGroup.var("Dimension epsilon for volume", mOptions.volumeEpsilon, 0.0f, 1.0f);
+            }
+            optionsChanged |= buildGroup.checkbox("Use pre-integration", mOptions.usePreintegration);
+            optionsChanged |= buildGroup.checkbox("Use lighting cones", mOptions.useLightingCones);
+        }
+
+        if (auto statGroup = widget.group("BVH statistics"))
+        {
+            std::string statsStr;
+            statsStr += "Local lights:          " + std::to_string(mBVH.getLocalLightCount()) + "\n";
+            statsStr += "Infinite lights:       " + std::to_string(mBVH.getInfiniteLightCount()) + "\n";
+            statsStr += "Nodes:                 " + std::to_string(mBVH.getNodes().size()) + "\n";
+            statsStr += "Max depth:             " + std::to_string(mBVH.getMaxDepth()) + "\n";
+            statGroup.text(statsStr);
+        }
+
+        if (optionsChanged) mNeedsRebuild = true;
+        return optionsChanged;
+    }
+
+    void AnalyticLightBVHSampler::setOptions(const Options& options)
+    {
+        if (std::memcmp(&mOptions, &options, sizeof(Options)) != 0)
+        {
+            mOptions = options;
+            mNeedsRebuild = true;
+        }
+    }
+
+    void AnalyticLightBVHSampler::uploadGPUBuffers()
+    {
+        const auto& nodes = mBVH.getNodes();
+        if (!nodes.empty())
+        {
+            if (!mpNodesBuffer || mpNodesBuffer->getElementCount() < nodes.size())
+            {
+                mpNodesBuffer = mpDevice->createStructuredBuffer(sizeof(AnalyticLightBVHNode), (uint32_t)nodes.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
+                mpNodesBuffer->setName("AnalyticLightBVHSampler::mpNodesBuffer");
+            }
+            mpNodesBuffer->setBlob(nodes.data(), 0, nodes.size() * sizeof(nodes[0]));
+        }
+
+        const auto& infiniteLights = mBVH.getInfiniteLightIndices();
+        if (!infiniteLights.empty())
+        {
+            if (!mpInfiniteLightsBuffer || mpInfiniteLightsBuffer->getElementCount() < infiniteLights.size())
+            {
+                mpInfiniteLightsBuffer = mpDevice->createStructuredBuffer(sizeof(uint32_t), (uint32_t)infiniteLights.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
+                mpInfiniteLightsBuffer->setName("AnalyticLightBVHSampler::mpInfiniteLightsBuffer");
+            }
+            mpInfiniteLightsBuffer->setBlob(infiniteLights.data(), 0, infiniteLights.size() * sizeof(infiniteLights[0]));
+        }
+    }
+
+    std::vector<LightData> AnalyticLightBVHSampler::getActiveLightData() const
+    {
+        // The light indices match the order of the lights in the scene's GPU light buffer.
+        std::vector<LightData> lights;
+        lights.reserve(mpScene->getActiveLightCount());
+        for (const auto& pLight : mpScene->getActiveLights()) lights.push_back(pLight->getData());
+        return lights;
+    }
+}
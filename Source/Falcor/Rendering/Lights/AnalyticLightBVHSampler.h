@@ -0,0 +1,97 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "AnalyticLightBVH.h"
+#include "Core/Macros.h"
+#include "Core/API/Buffer.h"
+#include "Scene/Scene.h"
+#include "Utils/UI/Gui.h"
+
+namespace Falcor
+{
+    class RenderContext;
+
+    /** Analytic light sampler using a light BVH.
+
+        This class wraps an AnalyticLightBVH over the active analytic lights of a scene,
+        and keeps it up to date as lights move or change. The BVH is built on the CPU
+        and uploaded to the GPU for use by AnalyticLightBVHSampler.slang.
+    */
+    class FALCOR_API AnalyticLightBVHSampler
+    {
+    public:
+        using Options = AnalyticLightBVH::Options;
+
+        /** Create a new object.
+            \param[in] pScene The scene.
+            \param[in] options The options to override the default behavior.
+        */
+        AnalyticLightBVHSampler(ref<Scene> pScene, const Options& options = Options());
+        virtual ~AnalyticLightBVHSampler() = default;
+
+        /** Updates the sampler to the current frame.
+            \param[in] pRenderContext The render context.
+            \return True if the sampler was updated.
+        */
+        bool update(RenderContext* pRenderContext);
+
+        /** Bind the light sampler data to a given shader variable.
+            \param[in] var Shader variable.
+        */
+        void bindShaderData(const ShaderVar& var) const;
+
+        /** Render the GUI.
+            \return True if setting the refresh flag is needed, false otherwise.
+        */
+        bool renderUI(Gui::Widgets& widget);
+
+        /** Returns the current configuration.
+        */
+        const Options& getOptions() const { return mOptions; }
+
+        /** Set the options, the BVH is rebuilt on the next update if they changed.
+        */
+        void setOptions(const Options& options);
+
+        const AnalyticLightBVH& getBVH() const { return mBVH; }
+
+    protected:
+        void uploadGPUBuffers();
+        std::vector<LightData> getActiveLightData() const;
+
+        ref<Device> mpDevice;
+        ref<Scene> mpScene;
+
+        Options mOptions;
+        AnalyticLightBVH mBVH;
+        bool mNeedsRebuild = true;                  ///< Set to true whenever the BVH needs to be rebuilt.
+
+        ref<Buffer> mpNodesBuffer;                  ///< BVH nodes.
+        ref<Buffer> mpInfiniteLightsBuffer;         ///< Indices of the directional and distant lights.
+    };
+}
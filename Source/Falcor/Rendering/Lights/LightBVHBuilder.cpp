@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "LightBVHBuilder.h"
+#include "LightBVHCostModel.h"
 #include "Core/Error.h"
 #include "Utils/Logger.h"
 #include "Utils/Timing/Profiler.h"
@@ -43,178 +44,6 @@ namespace
     // Define the maximum supported leaf triangle count and offsets.
     const uint32_t kMaxLeafTriangleCount = 1 << PackedNode::kTriangleCountBits;
     const uint32_t kMaxLeafTriangleOffset = 1 << PackedNode::kTriangleOffsetBits;
-
-    inline float safeACos(float v)
-    {
-        return std::acos(std::clamp(v, -1.0f, 1.0f));
-    }
-
-    /** Returns sin(a) based on cos(a) for a in [0,pi].
-    */
-    inline float sinFromCos(float cosAngle)
-    {
-        return std::sqrt(std::max(0.f, 1.f - cosAngle * cosAngle));
-    }
-
-    /** Given a bounding cone specified by direction and cosine spread angle,
-        compute the minimum cone angle that includes a second bounding cone.
-        If either cone is invalid or the result is larger than pi, the resulting
-        cone is marked as invalid.
-        TODO: Move to utility header and add unit test.
-        \return The cosine of the spread angle for the new cone.
-    */
-    float computeCosConeAngle(const float3& coneDir, const float cosTheta, const float3& otherConeDir, const float cosOtherTheta)
-    {
-        float cosResult = kInvalidCosConeAngle;
-        if (cosTheta != kInvalidCosConeAngle && cosOtherTheta != kInvalidCosConeAngle)
-        {
-            const float cosDiffTheta = dot(coneDir, otherConeDir);
-            const float sinDiffTheta = sinFromCos(cosDiffTheta);
-            const float sinOtherTheta = sinFromCos(cosOtherTheta);
-
-            // Rotate (cosDiffTheta, sinDiffTheta) counterclockwise by the other cone's spread angle.
-            float cosTotalTheta = cosOtherTheta * cosDiffTheta - sinOtherTheta * sinDiffTheta;
-            float sinTotalTheta = sinOtherTheta * cosDiffTheta + cosOtherTheta * sinDiffTheta;
-
-            // If the total angle is less than pi, store the new cone angle.
-            // Otherwise, the bounding cone will be deactivated because it would represent the whole sphere.
-            if (sinTotalTheta > 0.f)
-            {
-                cosResult = std::min(cosTheta, cosTotalTheta);
-            }
-        }
-        return cosResult;
-    }
-
-    /** Given two cones specified by direction vectors and the cosine of
-        their spread angles, returns a cone that bounds both of them. This
-        is what was used previously; the cones it returns aren't as tight as
-        those given by coneUnion().
-    */
-    float3 coneUnionOld(float3 aDir, float aCosTheta, float3 bDir, float bCosTheta, float& cosResult)
-    {
-        float3 dir = aDir + bDir;
-        if (aCosTheta == kInvalidCosConeAngle || bCosTheta == kInvalidCosConeAngle || all(dir == float3(0.0f)))
-        {
-            cosResult = kInvalidCosConeAngle;
-            return float3(0.0f);
-        }
-
-        dir = normalize(dir);
-
-        const float aDiff = safeACos(dot(dir, aDir));
-        const float bDiff = safeACos(dot(dir, bDir));
-        cosResult = std::cos(std::max(aDiff + std::acos(aCosTheta), bDiff + std::acos(bCosTheta)));
-        return dir;
-    }
-
-    /** Given two cones specified by direction vectors and the cosine of
-        their spread angles, returns a cone that bounds both of
-        them. Algorithm 1 in the 2018 Sony EGSR light sampling paper.
-    */
-    float3 coneUnion(float3 aDir, float aCosTheta, float3 bDir, float bCosTheta, float& cosResult)
-    {
-        if (aCosTheta == kInvalidCosConeAngle || bCosTheta == kInvalidCosConeAngle)
-        {
-            cosResult = kInvalidCosConeAngle;
-            return float3(0.0f);
-        }
-
-        // Swap if necessary so that aTheta > bTheta. Note that the test is
-        // reversed since we're testing the cosine of the angles.
-        if (bCosTheta < aCosTheta)
-        {
-            std::swap(aDir, bDir);
-            std::swap(aCosTheta, bCosTheta);
-        }
-
-        // TODO: this could be optimized to use fewer trig functions.
-        const float theta = safeACos(dot(aDir, bDir));
-        const float aTheta = safeACos(aCosTheta), bTheta = safeACos(bCosTheta);
-        if (std::min(theta + bTheta, float(M_PI)) <= aTheta)
-        {
-            // a encloses b and we're done.
-            cosResult = aCosTheta;
-            return aDir;
-        }
-
-        // Merge the two cones. First compute the spread angle of the cone
-        // that will fit all of them.
-        float oTheta = (theta + aTheta + bTheta) / 2;
-        if (oTheta > float(M_PI))
-        {
-            cosResult = kInvalidCosConeAngle;
-            return float3(0.0f);
-        }
-
-        // Rotate a's axis toward b just enough so that that oTheta covers
-        // both cones.
-        const float rTheta = oTheta - aTheta;
-        const float3 rDir = cross(aDir, bDir);
-        float3 dir;
-        if (dot(rDir, rDir) < 1e-8)
-        {
-            // The two vectors are effectively pointing in opposite directions.
-
-            // Find some vector that's orthogonal to one of them (via
-            // "Building and Orthonormal Basis, Revisited" in jcgt.)
-            const float sign = aDir.z > 0 ? 1.f : -1.f;
-            const float a = -1.f / (sign + aDir.z);
-            const float b = aDir.x * aDir.y * a;
-            dir = float3(1.f + sign * aDir.x * aDir.x * a, sign * b, -sign * aDir.x);
-            // The spread angle needs to be pi/2 to encompass aDir and
-            // bDir, then aTheta / 2 more on top of that. (Recall that
-            // aTheta > bTheta, so we don't need to worry about bTheta).
-            // Note that we could rotate dir around the vector cross(dir,
-            // aTheta) and then be able to use the tighter spread angle
-            // oTheta computed before, but it probably doesn't matter much
-            // in this (rare) case.
-            oTheta = std::min(float(M_PI), float(M_PI_2) + aTheta);
-            cosResult = std::cos(oTheta);
-        }
-        else
-        {
-            // Rotate aDir by an angle of rTheta around the axis rDir.
-            const float4x4 rotationMatrix = math::matrixFromRotation(rTheta, rDir);
-            dir = transformVector(rotationMatrix, aDir);
-            cosResult = std::cos(oTheta);
-        }
-
-        // TODO: write a unit test.
-        // Testing code: make sure both a and b are inside the result.
-        auto checkInside = [&](float3 d, float theta) {
-                               // Make sure that sum of the angle between
-                               // the two cone vectors and the spread angle
-                               // of the given cone is still within the
-                               // extent of the result cone.
-                               float cosDelta = dot(d, dir);
-                               float delta = safeACos(cosDelta);
-                               bool dInCone = (delta + theta <= oTheta * 1.01f ||
-                                               delta + theta <= oTheta + 1e-3f);
-                               if (!dInCone)
-                               {
-                                   FALCOR_THROW("Error in coneUnion(): angle diff {} > spread {}", delta + theta, oTheta);
-                               }
-                           };
-        checkInside(aDir, aTheta);
-        checkInside(bDir, bTheta);
-
-        return dir;
-    }
-
-    /** Returns the volume of a bounding box.
-        \param[in] epsilon Replace dimensions that are zero by this value.
-        \return the volume of the bounding box if it is valid, -inf otherwise.
-    */
-    float aabbVolume(const AABB& bb, float epsilon)
-    {
-        if (bb.valid() == false)
-        {
-            return -std::numeric_limits<float>::infinity();
-        }
-        const float3 dims = max(float3(epsilon), bb.extent());
-        return dims.x * dims.y * dims.z;
-    }
 }
 
 namespace Falcor
@@ -451,9 +280,7 @@ namespace Falcor
             float rightNodeCosConeAngle = kInvalidCosConeAngle;
             float3 rightNodeConeDirection = computeLightingConesInternal(rightIndex, data, rightNodeCosConeAngle);
 
-            // TODO: Asserts in coneUnion
-            //float3 coneDirection = coneUnion(leftNodeConeDirection, leftNodeCosConeAngle,
-            float3 coneDirection = coneUnionOld(leftNodeConeDirection, leftNodeCosConeAngle,
+            float3 coneDirection = LightBVHCostModel::coneUnionAverageAxis(leftNodeConeDirection, leftNodeCosConeAngle,
                 rightNodeConeDirection, rightNodeCosConeAngle, cosConeAngle);
 
             // Update bounding cone.
@@ -491,7 +318,7 @@ namespace Falcor
             for (uint32_t triangleIdx = triangleRange.begin; triangleIdx < triangleRange.end; ++triangleIdx)
             {
                 const TriangleSortData& td = data.trianglesData[triangleIdx];
-                cosTheta = computeCosConeAngle(coneDirection, cosTheta, td.coneDirection, td.cosConeAngle);
+                cosTheta = LightBVHCostModel::computeCosConeAngle(coneDirection, cosTheta, td.coneDirection, td.cosConeAngle);
             }
         }
         return coneDirection;
@@ -512,16 +339,21 @@ namespace Falcor
         return result;
     }
 
-    /** Evaluates the SAH cost metric for a node.
-        If the node is empty (invalid bounds), the cost evaluates to zero.
-        See Eqn 15 in Moreau and Clarberg, "Importance Sampling of Many Lights on the GPU", Ray Tracing Gems, Ch. 18, 2019.
+    static LightBVHCostModel::Params getCostParams(const LightBVHBuilder::Options& options)
+    {
+        LightBVHCostModel::Params params;
+        params.usePreintegration = options.usePreintegration;
+        params.useLightingCones = options.useLightingCones;
+        params.useVolumeOverSA = options.useVolumeOverSA;
+        params.volumeEpsilon = options.volumeEpsilon;
+        return params;
+    }
+
+    /** Evaluates the SAH cost metric for a node. See LightBVHCostModel::evalSAH().
     */
     static float evalSAH(const AABB& bounds, const uint32_t triangleCount, const LightBVHBuilder::Options& parameters)
     {
-        float aabbCost = bounds.valid() ? (parameters.useVolumeOverSA ? aabbVolume(bounds, parameters.volumeEpsilon) : bounds.area()) : 0.f;
-        float cost = aabbCost * (float)triangleCount;
-        FALCOR_ASSERT(cost >= 0.f && !std::isnan(cost) && !std::isinf(cost));
-        return cost;
+        return LightBVHCostModel::evalSAH(bounds, triangleCount, getCostParams(parameters));
     }
 
     LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters)
@@ -651,32 +483,11 @@ namespace Falcor
         return overallBestSplit.second;
     }
 
-    /** Utility function that implements the orientation cost heuristic according to Equation 1
-        in Conty & Kulla, "Importance Sampling of Many Lights with Adaptive Tree Splitting", 2018.
-        We're assuming flat diffuse emitters (theta_e = pi/2). For this case the orientation cost
-        varies smoothly between pi (flat emitter) to 4pi (full sphere).
-    */
-    static float computeOrientationCost(const float theta_o)
-    {
-        float theta_w = std::min(theta_o + float(M_PI_2), float(M_PI));
-        float sin_theta_o = std::sin(theta_o);
-        float cos_theta_o = std::cos(theta_o);
-        return float(M_2PI) * (1.0f - cos_theta_o) + float(M_PI_2) * (2.0f * theta_w * sin_theta_o - std::cos(theta_o - 2.0f * theta_w) - 2.0f * theta_o * sin_theta_o + cos_theta_o);
-    };
-
-    /** Evaluates the SAOH cost metric for a node.
-        If the node is empty (invalid bounds), the cost evaluates to zero.
-        See Eqn 16 in Moreau and Clarberg, "Importance Sampling of Many Lights on the GPU", Ray Tracing Gems, Ch. 18, 2019.
+    /** Evaluates the SAOH cost metric for a node, assuming flat diffuse emitters. See LightBVHCostModel::evalSAOH().
     */
     static float evalSAOH(const AABB& bounds, const float flux, const float cosTheta, const LightBVHBuilder::Options& parameters)
     {
-        float fluxCost = parameters.usePreintegration ? flux : 1.0f;
-        float aabbCost = bounds.valid() ? (parameters.useVolumeOverSA ? aabbVolume(bounds, parameters.volumeEpsilon) : bounds.area()) : 0.f;
-        float theta = cosTheta != kInvalidCosConeAngle ? safeACos(cosTheta) : float(M_PI);
-        float orientationCost = parameters.useLightingCones ? computeOrientationCost(theta) : 1.0f;
-        float cost = fluxCost * aabbCost * orientationCost;
-        FALCOR_ASSERT(cost >= 0.f && !std::isnan(cost) && !std::isinf(cost));
-        return cost;
+        return LightBVHCostModel::evalSAOH(bounds, flux, cosTheta, 0.f, getCostParams(parameters));
     }
 
     LightBVHBuilder::SplitResult LightBVHBuilder::computeSplitWithBinnedSAOH(const BuildingData& data, const Range& triangleRange, const AABB& nodeBounds, const Options& parameters)
@@ -758,7 +569,7 @@ namespace Falcor
             {
                 const auto& td = data.trianglesData[i];
                 Bin& bin = bins[getBinId(td)];
-                bin.cosConeAngle = computeCosConeAngle(bin.coneDirection, bin.cosConeAngle, td.coneDirection, td.cosConeAngle);
+                bin.cosConeAngle = LightBVHCostModel::computeCosConeAngle(bin.coneDirection, bin.cosConeAngle, td.coneDirection, td.cosConeAngle);
             }
 
             // First, compute A_j(L) * N_j(L) by sweeping over the bins from left to right.
@@ -776,7 +587,7 @@ namespace Falcor
                     float3 coneDir = normalize(total.coneDirection);
                     for (std::size_t j = 0; j <= i; ++j)
                     {
-                        cosTheta = computeCosConeAngle(coneDir, cosTheta, bins[j].coneDirection, bins[j].cosConeAngle);
+                        cosTheta = LightBVHCostModel::computeCosConeAngle(coneDir, cosTheta, bins[j].coneDirection, bins[j].cosConeAngle);
                     }
                 }
 
@@ -797,7 +608,7 @@ namespace Falcor
                     float3 coneDir = normalize(total.coneDirection);
                     for (std::size_t j = i; j <= costs.size(); ++j)
                     {
-                        cosTheta = computeCosConeAngle(coneDir, cosTheta, bins[j].coneDirection, bins[j].cosConeAngle);
+                        cosTheta = LightBVHCostModel::computeCosConeAngle(coneDir, cosTheta, bins[j].coneDirection, bins[j].cosConeAngle);
                     }
                 }
 
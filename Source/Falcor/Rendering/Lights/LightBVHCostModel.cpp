@@ -0,0 +1,135 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "LightBVHCostModel.h"
+#include "LightBVHTypes.slang"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Falcor
+{
+    namespace
+    {
+        inline float safeACos(float v)
+        {
+            return std::acos(std::clamp(v, -1.0f, 1.0f));
+        }
+
+        /** Returns sin(a) based on cos(a) for a in [0,pi].
+        */
+        inline float sinFromCos(float cosAngle)
+        {
+            return std::sqrt(std::max(0.f, 1.f - cosAngle * cosAngle));
+        }
+
+        float evalAABBCost(const AABB& bounds, const LightBVHCostModel::Params& params)
+        {
+            if (!bounds.valid()) return 0.f;
+            return params.useVolumeOverSA ? LightBVHCostModel::aabbVolume(bounds, params.volumeEpsilon) : bounds.area();
+        }
+    }
+
+    float LightBVHCostModel::computeCosConeAngle(const float3& coneDir, const float cosTheta, const float3& otherConeDir, const float cosOtherTheta)
+    {
+        float cosResult = kInvalidCosConeAngle;
+        if (cosTheta != kInvalidCosConeAngle && cosOtherTheta != kInvalidCosConeAngle)
+        {
+            const float cosDiffTheta = dot(coneDir, otherConeDir);
+            const float sinDiffTheta = sinFromCos(cosDiffTheta);
+            const float sinOtherTheta = sinFromCos(cosOtherTheta);
+
+            // Rotate (cosDiffTheta, sinDiffTheta) counterclockwise by the other cone's spread angle.
+            float cosTotalTheta = cosOtherTheta * cosDiffTheta - sinOtherTheta * sinDiffTheta;
+            float sinTotalTheta = sinOtherTheta * cosDiffTheta + cosOtherTheta * sinDiffTheta;
+
+            // If the total angle is less than pi, store the new cone angle.
+            // Otherwise, the bounding cone will be deactivated because it would represent the whole sphere.
+            if (sinTotalTheta > 0.f)
+            {
+                cosResult = std::min(cosTheta, cosTotalTheta);
+            }
+        }
+        return cosResult;
+    }
+
+    float3 LightBVHCostModel::coneUnionAverageAxis(const float3& aDir, const float aCosTheta, const float3& bDir, const float bCosTheta, float& cosResult)
+    {
+        float3 dir = aDir + bDir;
+        if (aCosTheta == kInvalidCosConeAngle || bCosTheta == kInvalidCosConeAngle || all(dir == float3(0.0f)))
+        {
+            cosResult = kInvalidCosConeAngle;
+            return float3(0.0f);
+        }
+
+        dir = normalize(dir);
+
+        const float aDiff = safeACos(dot(dir, aDir));
+        const float bDiff = safeACos(dot(dir, bDir));
+        const float theta = std::max(aDiff + std::acos(aCosTheta), bDiff + std::acos(bCosTheta));
+
+        // Cones wider than pi cover the whole sphere.
+        cosResult = theta < float(M_PI) ? std::cos(theta) : kInvalidCosConeAngle;
+        return dir;
+    }
+
+    float LightBVHCostModel::computeOrientationCost(const float theta_o, const float theta_e)
+    {
+        float theta_w = std::min(theta_o + theta_e, float(M_PI));
+        float sin_theta_o = std::sin(theta_o);
+        float cos_theta_o = std::cos(theta_o);
+        return float(M_2PI) * (1.0f - cos_theta_o) + float(M_PI_2) * (2.0f * theta_w * sin_theta_o - std::cos(theta_o - 2.0f * theta_w) - 2.0f * theta_o * sin_theta_o + cos_theta_o);
+    }
+
+    float LightBVHCostModel::aabbVolume(const AABB& bb, float epsilon)
+    {
+        if (bb.valid() == false)
+        {
+            return -std::numeric_limits<float>::infinity();
+        }
+        const float3 dims = max(float3(epsilon), bb.extent());
+        return dims.x * dims.y * dims.z;
+    }
+
+    float LightBVHCostModel::evalSAH(const AABB& bounds, const uint32_t lightCount, const Params& params)
+    {
+        float cost = evalAABBCost(bounds, params) * (float)lightCount;
+        FALCOR_ASSERT(cost >= 0.f && !std::isnan(cost) && !std::isinf(cost));
+        return cost;
+    }
+
+    float LightBVHCostModel::evalSAOH(const AABB& bounds, const float flux, const float cosTheta, const float cosThetaE, const Params& params)
+    {
+        float fluxCost = params.usePreintegration ? flux : 1.0f;
+        float theta = cosTheta != kInvalidCosConeAngle ? safeACos(cosTheta) : float(M_PI);
+        float orientationCost = params.useLightingCones ? computeOrientationCost(theta, safeACos(cosThetaE)) : 1.0f;
+        float cost = fluxCost * evalAABBCost(bounds, params) * orientationCost;
+        FALCOR_ASSERT(cost >= 0.f && !std::isnan(cost) && !std::isinf(cost));
+        return cost;
+    }
+}
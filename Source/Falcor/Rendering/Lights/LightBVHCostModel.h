@@ -0,0 +1,98 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/MathConstants.slangh"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Bounding cone helpers and split cost metrics shared by the light BVH builders.
+
+        Bounding cones are specified by a direction and the cosine of their spread angle.
+        A cosine equal to kInvalidCosConeAngle denotes a cone that covers the whole sphere.
+    */
+    struct FALCOR_API LightBVHCostModel
+    {
+        /** Parameters of the cost metrics.
+        */
+        struct Params
+        {
+            bool usePreintegration = true;      ///< Weight the SAOH cost by the node flux.
+            bool useLightingCones = true;       ///< Include the orientation cost in the SAOH cost.
+            bool useVolumeOverSA = false;       ///< Use the volume rather than the surface area of the AABB.
+            float volumeEpsilon = 1e-3f;        ///< Replace AABB dimensions that are zero by this value when computing volumes.
+        };
+
+        /** Given a bounding cone specified by direction and cosine spread angle,
+            compute the minimum cone angle that includes a second bounding cone.
+            If either cone is invalid or the result is larger than pi, the resulting
+            cone is marked as invalid.
+            \return The cosine of the spread angle for the new cone.
+        */
+        static float computeCosConeAngle(const float3& coneDir, const float cosTheta, const float3& otherConeDir, const float cosOtherTheta);
+
+        /** Compute a cone that bounds two cones. The axis of the result is the normalized sum of the two axes.
+            This is not the tightest bounding cone (Algorithm 1 in the 2018 Sony EGSR light sampling paper rotates the
+            wider cone's axis toward the other instead), so the result is wider when the spread angles differ.
+            It is the bound the light BVH builders have always used: it is cheap, has no degenerate rotation case, and
+            keeping it leaves the SAOH split decisions and the resulting trees unchanged.
+            \param[out] cosResult Cosine of the spread angle of the result, or kInvalidCosConeAngle if the result covers the whole sphere.
+            \return Direction of the resulting cone.
+        */
+        static float3 coneUnionAverageAxis(const float3& aDir, const float aCosTheta, const float3& bDir, const float bCosTheta, float& cosResult);
+
+        /** Orientation cost according to Equation 1 in Conty & Kulla, "Importance Sampling of Many Lights with Adaptive Tree Splitting", 2018.
+            \param[in] theta_o Spread angle of the cone bounding the emitter normals/axes.
+            \param[in] theta_e Angle around the axes within which light is emitted (pi/2 for flat diffuse emitters).
+        */
+        static float computeOrientationCost(const float theta_o, const float theta_e = float(M_PI_2));
+
+        /** Returns the volume of a bounding box.
+            \param[in] epsilon Replace dimensions that are zero by this value.
+            \return the volume of the bounding box if it is valid, -inf otherwise.
+        */
+        static float aabbVolume(const AABB& bb, float epsilon);
+
+        /** Evaluates the SAH cost metric for a node.
+            If the node is empty (invalid bounds), the cost evaluates to zero.
+            See Eqn 15 in Moreau and Clarberg, "Importance Sampling of Many Lights on the GPU", Ray Tracing Gems, Ch. 18, 2019.
+        */
+        static float evalSAH(const AABB& bounds, const uint32_t lightCount, const Params& params);
+
+        /** Evaluates the SAOH cost metric for a node.
+            If the node is empty (invalid bounds), the cost evaluates to zero.
+            See Eqn 16 in Moreau and Clarberg, "Importance Sampling of Many Lights on the GPU", Ray Tracing Gems, Ch. 18, 2019.
+            \param[in] cosTheta Cosine of the spread angle of the node's bounding cone, or kInvalidCosConeAngle.
+            \param[in] cosThetaE Cosine of the emission angle around the cone (0 for flat diffuse emitters).
+        */
+        static float evalSAOH(const AABB& bounds, const float flux, const float cosTheta, const float cosThetaE, const Params& params);
+    };
+}
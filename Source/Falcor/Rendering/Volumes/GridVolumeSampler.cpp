@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "GridVolumeSampler.h"
 #include "Core/Error.h"
+#include "Utils/Logger.h"
 
 namespace Falcor
 {
@@ -35,6 +36,7 @@ namespace Falcor
         , mOptions(options)
     {
         FALCOR_ASSERT(pScene);
+        checkGridResidency();
     }
 
     DefineList GridVolumeSampler::getDefines() const
@@ -49,11 +51,49 @@ namespace Falcor
     void GridVolumeSampler::bindShaderData(const ShaderVar& var) const
     {
         FALCOR_ASSERT(var.isValid());
+
+        // Grid volumes may have been added or changed since the sampler was created.
+        checkGridResidency();
+    }
+
+    void GridVolumeSampler::setOptions(const Options& options)
+    {
+        mOptions = options;
+        checkGridResidency();
+    }
+
+    std::string GridVolumeSampler::findNonResidentGrid(bool useBrickedGrid) const
+    {
+        for (const auto& pGridVolume : mpScene->getGridVolumes())
+        {
+            for (auto slot : { GridVolume::GridSlot::Density, GridVolume::GridSlot::Emission })
+            {
+                for (const auto& pGrid : pGridVolume->getGridSequence(slot))
+                {
+                    if (pGrid && !(useBrickedGrid ? pGrid->hasBricks() : pGrid->hasNanoVDB()))
+                        return pGridVolume->getName();
+                }
+            }
+        }
+        return {};
+    }
+
+    void GridVolumeSampler::checkGridResidency() const
+    {
+        if (auto name = findNonResidentGrid(mOptions.useBrickedGrid); !name.empty())
+        {
+            FALCOR_THROW(
+                "Grid volume '{}' does not keep the {} representation resident, which is required by the grid volume sampler. "
+                "Change the grid residency or the 'useBrickedGrid' option.",
+                name, mOptions.useBrickedGrid ? "bricked" : "NanoVDB"
+            );
+        }
     }
 
     bool GridVolumeSampler::renderUI(Gui::Widgets& widget)
     {
         bool dirty = false;
+        const Options prevOptions = mOptions;
 
         if (widget.checkbox("Use BrickedGrid", mOptions.useBrickedGrid))
         {
@@ -77,6 +117,17 @@ namespace Falcor
             dirty = true;
         }
 
+        // Only allow switching to a representation that all grids keep resident.
+        if (dirty)
+        {
+            if (auto name = findNonResidentGrid(mOptions.useBrickedGrid); !name.empty())
+            {
+                logWarning("Grid volume '{}' does not keep the {} representation resident.", name, mOptions.useBrickedGrid ? "bricked" : "NanoVDB");
+                mOptions = prevOptions;
+                dirty = false;
+            }
+        }
+
         return dirty;
     }
 }
@@ -91,9 +91,22 @@ namespace Falcor
         */
         const Options& getOptions() const { return mOptions; }
 
-        void setOptions(const Options& options) { mOptions = options; }
+        /** Set the configuration.
+            Throws if the grids in the scene do not keep the representation required by the options resident (see Grid::Residency).
+        */
+        void setOptions(const Options& options);
 
     protected:
+        /** Check if all grids in the scene keep the representation used by the sampler resident.
+            \param[in] useBrickedGrid True to check for bricked grids, false to check for NanoVDB grids.
+            \return The name of the first grid that is missing the representation, or an empty string if all grids have it.
+        */
+        std::string findNonResidentGrid(bool useBrickedGrid) const;
+
+        /** Throw if a grid in the scene does not keep the representation used by the sampler resident.
+        */
+        void checkGridResidency() const;
+
         ref<Scene>              mpScene;            ///< Scene.
 
         Options                 mOptions;
@@ -0,0 +1,565 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "CpuRayQuery.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <limits>
+#include <numeric>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kBinCount = 16;              ///< Number of SAH bins per axis.
+        const uint32_t kMaxLeafSize = 4;            ///< Maximum number of primitives in a leaf unless they can't be split.
+        const uint32_t kMaxSAHDepth = 40;           ///< Depth after which median splits are used. This bounds the traversal stack.
+        const uint32_t kTraversalStackSize = 256;
+        const float kTraversalCost = 1.f;           ///< SAH cost of traversing a node relative to intersecting a primitive.
+
+        struct BuildNode
+        {
+            AABB bounds;
+            uint32_t left = 0;
+            uint32_t right = 0;
+            uint32_t primOffset = 0;
+            uint32_t primCount = 0;                 ///< Non-zero for leaves.
+        };
+
+        struct Bin
+        {
+            AABB bounds;
+            uint32_t count = 0;
+        };
+
+        /** Binned SAH builder producing a binary BVH, which is then collapsed into 4-wide nodes.
+        */
+        class BVHBuilder
+        {
+        public:
+            BVHBuilder(const std::vector<AABB>& primBounds, std::vector<uint32_t>& primIndices)
+                : mPrimBounds(primBounds)
+                , mPrimIndices(primIndices)
+            {
+                mCentroids.resize(primBounds.size());
+                for (size_t i = 0; i < primBounds.size(); i++) mCentroids[i] = primBounds[i].center();
+            }
+
+            void build(std::vector<CpuRayQuery::BVH4::Node>& nodes)
+            {
+                FALCOR_ASSERT(!mPrimIndices.empty());
+                mNodes.reserve(2 * mPrimIndices.size());
+                buildRecursive(0, (uint32_t)mPrimIndices.size(), 0);
+                nodes.reserve(mNodes.size() / 2 + 1);
+                collapse(0, nodes);
+            }
+
+        private:
+            uint32_t computeBin(uint32_t primIndex, uint32_t axis, float minCentroid, float scale) const
+            {
+                return std::min((uint32_t)((mCentroids[primIndex][axis] - minCentroid) * scale), kBinCount - 1);
+            }
+
+            uint32_t buildRecursive(uint32_t begin, uint32_t end, uint32_t depth)
+            {
+                uint32_t nodeIndex = (uint32_t)mNodes.size();
+                mNodes.emplace_back();
+
+                AABB bounds;
+                AABB centroidBounds;
+                for (uint32_t i = begin; i < end; i++)
+                {
+                    bounds.include(mPrimBounds[mPrimIndices[i]]);
+                    centroidBounds.include(mCentroids[mPrimIndices[i]]);
+                }
+                mNodes[nodeIndex].bounds = bounds;
+
+                const uint32_t count = end - begin;
+                auto makeLeaf = [&]()
+                {
+                    mNodes[nodeIndex].primOffset = begin;
+                    mNodes[nodeIndex].primCount = count;
+                    return nodeIndex;
+                };
+
+                if (count <= 1) return makeLeaf();
+
+                const float3 centroidExtent = centroidBounds.extent();
+                uint32_t largestAxis = 0;
+                if (centroidExtent.y > centroidExtent[largestAxis]) largestAxis = 1;
+                if (centroidExtent.z > centroidExtent[largestAxis]) largestAxis = 2;
+
+                // All centroids coincide. There is no meaningful split, so only split oversized leaves.
+                if (centroidExtent[largestAxis] <= 0.f && count <= kMaxLeafSize) return makeLeaf();
+
+                uint32_t mid = begin;
+                if (centroidExtent[largestAxis] > 0.f && depth < kMaxSAHDepth)
+                {
+                    // Find the best split plane over all axes.
+                    float bestCost = std::numeric_limits<float>::infinity();
+                    uint32_t bestAxis = 0;
+                    uint32_t bestBin = 0;
+
+                    for (uint32_t axis = 0; axis < 3; axis++)
+                    {
+                        if (centroidExtent[axis] <= 0.f) continue;
+
+                        const float minCentroid = centroidBounds.minPoint[axis];
+                        const float scale = kBinCount / centroidExtent[axis];
+
+                        Bin bins[kBinCount];
+                        for (uint32_t i = begin; i < end; i++)
+                        {
+                            uint32_t primIndex = mPrimIndices[i];
+                            Bin& bin = bins[computeBin(primIndex, axis, minCentroid, scale)];
+                            bin.bounds.include(mPrimBounds[primIndex]);
+                            bin.count++;
+                        }
+
+                        // Sweep from the right to compute the cost of the right side of each split.
+                        float rightCost[kBinCount] = {};
+                        AABB rightBounds;
+                        uint32_t rightCount = 0;
+                        for (uint32_t i = kBinCount - 1; i > 0; i--)
+                        {
+                            rightBounds.include(bins[i].bounds);
+                            rightCount += bins[i].count;
+                            rightCost[i] = rightCount > 0 ? rightCount * rightBounds.area() : std::numeric_limits<float>::infinity();
+                        }
+
+                        // Sweep from the left and evaluate the split between bin i-1 and i.
+                        AABB leftBounds;
+                        uint32_t leftCount = 0;
+                        for (uint32_t i = 1; i < kBinCount; i++)
+                        {
+                            leftBounds.include(bins[i - 1].bounds);
+                            leftCount += bins[i - 1].count;
+                            if (leftCount == 0) continue;
+                            float cost = leftCount * leftBounds.area() + rightCost[i];
+                            if (cost < bestCost)
+                            {
+                                bestCost = cost;
+                                bestAxis = axis;
+                                bestBin = i;
+                            }
+                        }
+                    }
+
+                    // Compare against the cost of making a leaf. Both are relative to the node's surface area.
+                    const float area = bounds.area();
+                    const float splitCost = kTraversalCost * area + bestCost;
+                    const float leafCost = count * area;
+                    if (count <= kMaxLeafSize && splitCost >= leafCost) return makeLeaf();
+
+                    if (bestCost < std::numeric_limits<float>::infinity())
+                    {
+                        const float minCentroid = centroidBounds.minPoint[bestAxis];
+                        const float scale = kBinCount / centroidExtent[bestAxis];
+                        auto it = std::partition(mPrimIndices.begin() + begin, mPrimIndices.begin() + end,
+                            [&](uint32_t primIndex) { return computeBin(primIndex, bestAxis, minCentroid, scale) < bestBin; });
+                        mid = (uint32_t)(it - mPrimIndices.begin());
+                    }
+                }
+
+                // Fall back to a median split.
+                if (mid == begin || mid == end)
+                {
+                    mid = begin + count / 2;
+                    std::nth_element(mPrimIndices.begin() + begin, mPrimIndices.begin() + mid, mPrimIndices.begin() + end,
+                        [&](uint32_t a, uint32_t b) { return mCentroids[a][largestAxis] < mCentroids[b][largestAxis]; });
+                }
+
+                uint32_t left = buildRecursive(begin, mid, depth + 1);
+                uint32_t right = buildRecursive(mid, end, depth + 1);
+                mNodes[nodeIndex].left = left;
+                mNodes[nodeIndex].right = right;
+                return nodeIndex;
+            }
+
+            uint32_t collapse(uint32_t binaryIndex, std::vector<CpuRayQuery::BVH4::Node>& nodes) const
+            {
+                // Gather up to four children by repeatedly opening the inner child with the largest surface area.
+                uint32_t children[4];
+                uint32_t childCount = 0;
+                const BuildNode& binaryNode = mNodes[binaryIndex];
+                if (binaryNode.primCount > 0)
+                {
+                    children[childCount++] = binaryIndex;
+                }
+                else
+                {
+                    children[childCount++] = binaryNode.left;
+                    children[childCount++] = binaryNode.right;
+                    while (childCount < 4)
+                    {
+                        int32_t best = -1;
+                        float bestArea = -1.f;
+                        for (uint32_t i = 0; i < childCount; i++)
+                        {
+                            const BuildNode& child = mNodes[children[i]];
+                            if (child.primCount == 0 && child.bounds.area() > bestArea)
+                            {
+                                best = (int32_t)i;
+                                bestArea = child.bounds.area();
+                            }
+                        }
+                        if (best < 0) break;
+                        const BuildNode& opened = mNodes[children[best]];
+                        children[best] = opened.left;
+                        children[childCount++] = opened.right;
+                    }
+                }
+
+                const uint32_t nodeIndex = (uint32_t)nodes.size();
+                CpuRayQuery::BVH4::Node emptyNode;
+                for (uint32_t i = 0; i < 4; i++)
+                {
+                    for (uint32_t axis = 0; axis < 3; axis++)
+                    {
+                        emptyNode.boundsMin[axis][i] = 0.f;
+                        emptyNode.boundsMax[axis][i] = 0.f;
+                    }
+                    emptyNode.index[i] = CpuRayQuery::kInvalidIndex;
+                    emptyNode.count[i] = CpuRayQuery::kInvalidIndex;
+                }
+                nodes.push_back(emptyNode);
+
+                for (uint32_t i = 0; i < childCount; i++)
+                {
+                    const BuildNode& child = mNodes[children[i]];
+                    uint32_t index = child.primOffset;
+                    uint32_t count = child.primCount;
+                    if (count == 0) index = collapse(children[i], nodes);
+
+                    // Note: The node list may have been reallocated by the recursion.
+                    CpuRayQuery::BVH4::Node& node = nodes[nodeIndex];
+                    for (uint32_t axis = 0; axis < 3; axis++)
+                    {
+                        node.boundsMin[axis][i] = child.bounds.minPoint[axis];
+                        node.boundsMax[axis][i] = child.bounds.maxPoint[axis];
+                    }
+                    node.index[i] = index;
+                    node.count[i] = count;
+                }
+
+                return nodeIndex;
+            }
+
+            const std::vector<AABB>& mPrimBounds;
+            std::vector<uint32_t>& mPrimIndices;
+            std::vector<float3> mCentroids;
+            std::vector<BuildNode> mNodes;
+        };
+
+        /** Compute the reciprocal ray direction. Zero components are replaced by a tiny value
+            to keep the slab test free of NaNs (0 * inf) for rays starting on a box plane.
+        */
+        float3 computeInvDir(const float3& dir)
+        {
+            const float kMinComponent = 1e-20f;
+            float3 invDir;
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                float d = std::abs(dir[i]) < kMinComponent ? std::copysign(kMinComponent, dir[i]) : dir[i];
+                invDir[i] = 1.f / d;
+            }
+            return invDir;
+        }
+    }
+
+    void CpuRayQuery::BVH4::build(const std::vector<AABB>& primBounds)
+    {
+        mNodes.clear();
+        mPrimIndices.clear();
+        mBounds = AABB();
+
+        // Primitives with invalid bounds (e.g. empty instances) can never be hit and are left out.
+        mPrimIndices.reserve(primBounds.size());
+        for (uint32_t i = 0; i < (uint32_t)primBounds.size(); i++)
+        {
+            if (!primBounds[i].valid()) continue;
+            mPrimIndices.push_back(i);
+            mBounds.include(primBounds[i]);
+        }
+        if (mPrimIndices.empty()) return;
+
+        BVHBuilder builder(primBounds, mPrimIndices);
+        builder.build(mNodes);
+        mNodes.shrink_to_fit();
+    }
+
+    template<bool AnyHit, typename IntersectFunc>
+    bool CpuRayQuery::BVH4::traverse(const float3& origin, const float3& invDir, float tMin, float& tMax, IntersectFunc&& intersect) const
+    {
+        if (mNodes.empty()) return false;
+
+        struct StackEntry
+        {
+            uint32_t index;
+            uint32_t count;
+            float tNear;
+        };
+        StackEntry stack[kTraversalStackSize];
+        uint32_t stackSize = 0;
+        stack[stackSize++] = { 0, 0, tMin };
+
+        bool hit = false;
+        while (stackSize > 0)
+        {
+            const StackEntry entry = stack[--stackSize];
+            if (entry.tNear > tMax) continue;
+
+            if (entry.count > 0)
+            {
+                // Leaf node.
+                for (uint32_t i = entry.index; i < entry.index + entry.count; i++)
+                {
+                    if (intersect(mPrimIndices[i], tMax))
+                    {
+                        if constexpr (AnyHit) return true;
+                        hit = true;
+                    }
+                }
+                continue;
+            }
+
+            // Slab test against the four child boxes. The loops operate on one child per lane and are
+            // written so that the compiler can map them to SIMD instructions.
+            const Node& node = mNodes[entry.index];
+            float tNear[4];
+            float tFar[4];
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                float tx0 = (node.boundsMin[0][i] - origin.x) * invDir.x;
+                float tx1 = (node.boundsMax[0][i] - origin.x) * invDir.x;
+                float ty0 = (node.boundsMin[1][i] - origin.y) * invDir.y;
+                float ty1 = (node.boundsMax[1][i] - origin.y) * invDir.y;
+                float tz0 = (node.boundsMin[2][i] - origin.z) * invDir.z;
+                float tz1 = (node.boundsMax[2][i] - origin.z) * invDir.z;
+                tNear[i] = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), tMin));
+                tFar[i] = std::min(std::min(std::max(tx0, tx1), std::max(ty0, ty1)), std::min(std::max(tz0, tz1), tMax));
+            }
+
+            // Sort the intersected children front to back and push them in reverse order.
+            uint32_t order[4];
+            uint32_t hitCount = 0;
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                if (node.count[i] == kInvalidIndex || tNear[i] > tFar[i]) continue;
+                uint32_t j = hitCount++;
+                for (; j > 0 && tNear[order[j - 1]] > tNear[i]; j--) order[j] = order[j - 1];
+                order[j] = i;
+            }
+
+            FALCOR_ASSERT(stackSize + hitCount <= kTraversalStackSize);
+            for (uint32_t j = hitCount; j > 0; j--)
+            {
+                uint32_t i = order[j - 1];
+                stack[stackSize++] = { node.index[i], node.count[i], tNear[i] };
+            }
+        }
+
+        return hit;
+    }
+
+    std::unique_ptr<CpuRayQuery> CpuRayQuery::create(const Scene::SceneData& sceneData)
+    {
+        auto startTime = CpuTimer::getCurrentTimePoint();
+
+        auto pRayQuery = std::unique_ptr<CpuRayQuery>(new CpuRayQuery());
+        auto& meshes = pRayQuery->mMeshes;
+        auto& instances = pRayQuery->mInstances;
+
+        // Compute the world matrices of the scene graph nodes. Parents are stored before their children.
+        std::vector<float4x4> globalMatrices(sceneData.sceneGraph.size());
+        for (size_t i = 0; i < sceneData.sceneGraph.size(); i++)
+        {
+            const auto& node = sceneData.sceneGraph[i];
+            globalMatrices[i] = node.transform;
+            if (node.parent != NodeID::Invalid())
+            {
+                FALCOR_ASSERT(node.parent.get() < i);
+                globalMatrices[i] = mul(globalMatrices[node.parent.get()], globalMatrices[i]);
+            }
+        }
+
+        // Build the mesh BVHs in parallel.
+        meshes.resize(sceneData.meshDesc.size());
+        auto buildMesh = [&](uint32_t meshID)
+        {
+            const MeshDesc& meshDesc = sceneData.meshDesc[meshID];
+            const uint32_t triangleCount = meshDesc.getTriangleCount();
+            const PackedStaticVertexData* pVertices = sceneData.meshStaticData.data() + meshDesc.vbOffset;
+
+            auto getIndices = [&](uint32_t triangleIndex) -> uint3
+            {
+                if (!meshDesc.useVertexIndices()) return uint3(triangleIndex * 3) + uint3(0, 1, 2);
+                if (meshDesc.use16BitIndices())
+                {
+                    const uint16_t* pIndices = reinterpret_cast<const uint16_t*>(sceneData.meshIndexData.data() + meshDesc.ibOffset) + triangleIndex * 3;
+                    return uint3(pIndices[0], pIndices[1], pIndices[2]);
+                }
+                const uint32_t* pIndices = sceneData.meshIndexData.data() + meshDesc.ibOffset + triangleIndex * 3;
+                return uint3(pIndices[0], pIndices[1], pIndices[2]);
+            };
+
+            Mesh& mesh = meshes[meshID];
+            mesh.triangles.resize(triangleCount);
+            std::vector<AABB> triangleBounds(triangleCount);
+            for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; triangleIndex++)
+            {
+                const uint3 indices = getIndices(triangleIndex);
+                FALCOR_ASSERT(indices.x < meshDesc.vertexCount && indices.y < meshDesc.vertexCount && indices.z < meshDesc.vertexCount);
+                const float3 p0 = pVertices[indices.x].position;
+                const float3 p1 = pVertices[indices.y].position;
+                const float3 p2 = pVertices[indices.z].position;
+                mesh.triangles[triangleIndex] = { p0, p1 - p0, p2 - p0 };
+                triangleBounds[triangleIndex] = AABB(p0).include(p1).include(p2);
+            }
+            mesh.bvh.build(triangleBounds);
+        };
+
+        NumericRange<uint32_t> meshRange(0, (uint32_t)meshes.size());
+        std::for_each(std::execution::par, meshRange.begin(), meshRange.end(), buildMesh);
+
+        // Build the instance BVH.
+        instances.resize(sceneData.meshInstanceData.size());
+        std::vector<AABB> instanceBounds(instances.size());
+        for (size_t i = 0; i < instances.size(); i++)
+        {
+            const GeometryInstanceData& instanceData = sceneData.meshInstanceData[i];
+            FALCOR_CHECK(instanceData.geometryID < meshes.size(), "Mesh instance {} references invalid mesh {}.", i, instanceData.geometryID);
+            FALCOR_CHECK(instanceData.globalMatrixID < globalMatrices.size(), "Mesh instance {} references invalid node {}.", i, instanceData.globalMatrixID);
+
+            const float4x4& worldMatrix = globalMatrices[instanceData.globalMatrixID];
+            instances[i].worldToObject = inverse(worldMatrix);
+            instances[i].meshID = instanceData.geometryID;
+            instanceBounds[i] = meshes[instanceData.geometryID].bvh.getBounds().transform(worldMatrix);
+        }
+        pRayQuery->mTopLevel.build(instanceBounds);
+        pRayQuery->mBounds = pRayQuery->mTopLevel.getBounds();
+
+        // Gather statistics.
+        Stats& stats = pRayQuery->mStats;
+        stats.meshCount = (uint32_t)meshes.size();
+        stats.instanceCount = (uint32_t)instances.size();
+        stats.nodeCount = pRayQuery->mTopLevel.getNodes().size();
+        stats.memoryInBytes = pRayQuery->mTopLevel.getMemoryInBytes() + instances.size() * sizeof(Instance);
+        for (const auto& mesh : meshes)
+        {
+            stats.triangleCount += mesh.triangles.size();
+            stats.nodeCount += mesh.bvh.getNodes().size();
+            stats.memoryInBytes += mesh.bvh.getMemoryInBytes() + mesh.triangles.size() * sizeof(Triangle);
+        }
+        stats.buildTime = CpuTimer::calcDuration(startTime, CpuTimer::getCurrentTimePoint()) * 1e-3;
+
+        logInfo("Built CPU ray query BVH with {} meshes, {} instances and {} triangles in {:.2f} s ({:.1f} MB).",
+            stats.meshCount, stats.instanceCount, stats.triangleCount, stats.buildTime, stats.memoryInBytes / (1024.0 * 1024.0));
+
+        return pRayQuery;
+    }
+
+    template<bool AnyHit>
+    bool CpuRayQuery::trace(const Ray& ray, TriangleHit* pHit) const
+    {
+        float tMax = ray.tMax;
+        const float3 invDir = computeInvDir(ray.dir);
+
+        auto intersectInstance = [&](uint32_t instanceID, float& tMaxInstance)
+        {
+            const Instance& instance = mInstances[instanceID];
+            const Mesh& mesh = mMeshes[instance.meshID];
+
+            // Transform the ray to object space. The direction is not normalized so hit distances are preserved.
+            const float3 origin = transformPoint(instance.worldToObject, ray.origin);
+            const float3 dir = transformVector(instance.worldToObject, ray.dir);
+            const float3 objectInvDir = computeInvDir(dir);
+
+            auto intersectTriangle = [&](uint32_t triangleIndex, float& tMaxTriangle)
+            {
+                // Moller-Trumbore test. The comparisons are written to reject NaNs from degenerate triangles.
+                const Triangle& triangle = mesh.triangles[triangleIndex];
+                const float3 pvec = cross(dir, triangle.e2);
+                const float det = dot(triangle.e1, pvec);
+                if (det == 0.f) return false;
+                const float invDet = 1.f / det;
+                const float3 tvec = origin - triangle.p0;
+                const float u = dot(tvec, pvec) * invDet;
+                if (!(u >= 0.f && u <= 1.f)) return false;
+                const float3 qvec = cross(tvec, triangle.e1);
+                const float v = dot(dir, qvec) * invDet;
+                if (!(v >= 0.f && u + v <= 1.f)) return false;
+                const float t = dot(triangle.e2, qvec) * invDet;
+                if (!(t >= ray.tMin && t < tMaxTriangle)) return false;
+
+                tMaxTriangle = t;
+                if constexpr (!AnyHit)
+                {
+                    pHit->instanceID = instanceID;
+                    pHit->primitiveIndex = triangleIndex;
+                    pHit->barycentrics = float2(u, v);
+                    pHit->t = t;
+                }
+                return true;
+            };
+
+            return mesh.bvh.traverse<AnyHit>(origin, objectInvDir, ray.tMin, tMaxInstance, intersectTriangle);
+        };
+
+        return mTopLevel.traverse<AnyHit>(ray.origin, invDir, ray.tMin, tMax, intersectInstance);
+    }
+
+    bool CpuRayQuery::traceClosestHit(const Ray& ray, TriangleHit& hit) const
+    {
+        hit = {};
+        return trace<false>(ray, &hit);
+    }
+
+    bool CpuRayQuery::traceAnyHit(const Ray& ray) const
+    {
+        return trace<true>(ray, nullptr);
+    }
+
+    void CpuRayQuery::traceClosestHit(const std::vector<Ray>& rays, std::vector<TriangleHit>& hits) const
+    {
+        hits.resize(rays.size());
+        NumericRange<size_t> range(0, rays.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) { traceClosestHit(rays[i], hits[i]); });
+    }
+
+    void CpuRayQuery::traceAnyHit(const std::vector<Ray>& rays, std::vector<uint8_t>& hits) const
+    {
+        hits.resize(rays.size());
+        NumericRange<size_t> range(0, rays.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i) { hits[i] = traceAnyHit(rays[i]) ? 1 : 0; });
+    }
+}
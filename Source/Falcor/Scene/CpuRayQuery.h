@@ -0,0 +1,204 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Scene.h"
+#include "Core/Macros.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Ray.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/Math/Matrix.h"
+#include <memory>
+#include <vector>
+
+namespace Falcor
+{
+    /** CPU reference implementation of ray queries against the triangle meshes of a scene.
+
+        The acceleration structure is a two-level BVH: one bottom-level BVH per mesh and a top-level
+        BVH over the mesh instances. Both levels are built with a binned SAH builder and collapsed
+        into 4-wide nodes whose child boxes are tested together during traversal.
+        Bottom-level BVHs are built in parallel and the batch query functions trace rays in parallel.
+
+        The structure is built from the scene data produced by SceneBuilder and reflects the geometry
+        at load time, i.e. animations, skinning and displacement are not taken into account.
+        All triangles are treated as opaque and no face culling is performed.
+        Curves, SDF grids and custom primitives are ignored.
+
+        The returned hits use the same conventions as TriangleHit in HitInfo.slang:
+        instanceID is the geometry instance ID, primitiveIndex the triangle index within the mesh and
+        barycentrics the weights of the triangle's second and third vertex.
+    */
+    class FALCOR_API CpuRayQuery
+    {
+    public:
+        static constexpr uint32_t kInvalidIndex = 0xffffffff;
+
+        /** Triangle hit information.
+        */
+        struct TriangleHit
+        {
+            uint32_t instanceID = kInvalidIndex;        ///< Geometry instance ID.
+            uint32_t primitiveIndex = kInvalidIndex;    ///< Triangle index within the mesh.
+            float2 barycentrics = float2(0.f);          ///< Barycentrics of the hit point (weights of the second and third vertex).
+            float t = 0.f;                              ///< Ray distance to the hit point.
+
+            bool isValid() const { return instanceID != kInvalidIndex; }
+
+            /** Returns all three barycentric weights.
+            */
+            float3 getBarycentricWeights() const { return float3(1.f - barycentrics.x - barycentrics.y, barycentrics.x, barycentrics.y); }
+        };
+
+        /** Acceleration structure statistics.
+        */
+        struct Stats
+        {
+            uint32_t meshCount = 0;         ///< Number of meshes with a bottom-level BVH.
+            uint32_t instanceCount = 0;     ///< Number of mesh instances in the top-level BVH.
+            uint64_t triangleCount = 0;     ///< Number of unique triangles.
+            uint64_t nodeCount = 0;         ///< Total number of 4-wide BVH nodes.
+            uint64_t memoryInBytes = 0;     ///< Total memory used by the acceleration structure.
+            double buildTime = 0.0;         ///< Build time in seconds.
+        };
+
+        /** Build the acceleration structure from scene data.
+            This needs to be called before the scene data is moved into the scene (see SceneBuilder::Flags::BuildCpuRayQuery).
+            \param[in] sceneData Scene data as produced by SceneBuilder.
+            \return The CPU ray query object.
+        */
+        static std::unique_ptr<CpuRayQuery> create(const Scene::SceneData& sceneData);
+
+        /** Trace a ray and find the closest hit.
+            \param[in] ray Ray. Hits are accepted in the range [tMin, tMax).
+            \param[out] hit Closest hit. Invalid if there is no hit.
+            \return True if the ray hit anything.
+        */
+        bool traceClosestHit(const Ray& ray, TriangleHit& hit) const;
+
+        /** Trace a ray and determine if it hits anything.
+            \param[in] ray Ray. Hits are accepted in the range [tMin, tMax).
+            \return True if the ray hit anything.
+        */
+        bool traceAnyHit(const Ray& ray) const;
+
+        /** Trace a batch of rays in parallel and find the closest hits.
+            \param[in] rays Rays.
+            \param[out] hits Closest hit for each ray. Invalid if there is no hit.
+        */
+        void traceClosestHit(const std::vector<Ray>& rays, std::vector<TriangleHit>& hits) const;
+
+        /** Trace a batch of rays in parallel and determine which rays hit anything.
+            \param[in] rays Rays.
+            \param[out] hits Non-zero for each ray that hit anything.
+        */
+        void traceAnyHit(const std::vector<Ray>& rays, std::vector<uint8_t>& hits) const;
+
+        /** Get the world space bounds of all instances.
+        */
+        const AABB& getBounds() const { return mBounds; }
+
+        const Stats& getStats() const { return mStats; }
+
+        /** 4-wide BVH over a set of primitive bounding boxes.
+            Exposed for the mesh and instance levels of the acceleration structure, not intended for direct use.
+        */
+        class BVH4
+        {
+        public:
+            /** BVH node with four children. Child bounds are stored as structure of arrays.
+                For each child, count is zero for inner nodes (index is a node index), non-zero for leaves
+                (index is the offset into the primitive index list) and kInvalidIndex for unused children.
+            */
+            struct Node
+            {
+                float boundsMin[3][4];
+                float boundsMax[3][4];
+                uint32_t index[4];
+                uint32_t count[4];
+            };
+
+            /** Build the BVH.
+                \param[in] primBounds Bounding box of each primitive.
+            */
+            void build(const std::vector<AABB>& primBounds);
+
+            /** Traverse the BVH.
+                \param[in] origin Ray origin.
+                \param[in] invDir Reciprocal ray direction.
+                \param[in] tMin Minimum ray distance.
+                \param[in,out] tMax Maximum ray distance. Updated by the intersection function.
+                \param[in] intersect Function called as intersect(primIndex, tMax) for primitives in visited leaves.
+                           It returns true on a hit, in which case it has updated tMax.
+                \return True if any primitive was hit.
+            */
+            template<bool AnyHit, typename IntersectFunc>
+            bool traverse(const float3& origin, const float3& invDir, float tMin, float& tMax, IntersectFunc&& intersect) const;
+
+            const std::vector<Node>& getNodes() const { return mNodes; }
+            const std::vector<uint32_t>& getPrimIndices() const { return mPrimIndices; }
+            const AABB& getBounds() const { return mBounds; }
+            uint64_t getMemoryInBytes() const { return mNodes.size() * sizeof(Node) + mPrimIndices.size() * sizeof(uint32_t); }
+
+        private:
+            std::vector<Node> mNodes;           ///< 4-wide nodes. The first node is the root.
+            std::vector<uint32_t> mPrimIndices; ///< Primitive indices referenced by the leaves.
+            AABB mBounds;                       ///< Bounds of all primitives.
+        };
+
+    private:
+        CpuRayQuery() = default;
+
+        struct Triangle
+        {
+            float3 p0;
+            float3 e1;  ///< p1 - p0.
+            float3 e2;  ///< p2 - p0.
+        };
+
+        struct Mesh
+        {
+            BVH4 bvh;
+            std::vector<Triangle> triangles;    ///< Object space triangles in the original order.
+        };
+
+        struct Instance
+        {
+            float4x4 worldToObject;
+            uint32_t meshID;
+        };
+
+        template<bool AnyHit>
+        bool trace(const Ray& ray, TriangleHit* pHit) const;
+
+        std::vector<Mesh> mMeshes;
+        std::vector<Instance> mInstances;   ///< Instances indexed by geometry instance ID.
+        BVH4 mTopLevel;
+        AABB mBounds;
+        Stats mStats;
+    };
+}
@@ -0,0 +1,263 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "CurveSimplifier.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <numeric>
+#include <utility>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kMortonBits = 10;
+
+        uint32_t expandBits(uint32_t v)
+        {
+            v = (v * 0x00010001u) & 0xFF0000FFu;
+            v = (v * 0x00000101u) & 0x0F00F00Fu;
+            v = (v * 0x00000011u) & 0xC30C30C3u;
+            v = (v * 0x00000005u) & 0x49249249u;
+            return v;
+        }
+
+        uint32_t mortonCode(const float3& p)
+        {
+            const float scale = (float)((1u << kMortonBits) - 1);
+            uint3 q = uint3(clamp(p, float3(0.f), float3(1.f)) * scale + 0.5f);
+            return (expandBits(q.x) << 2) | (expandBits(q.y) << 1) | expandBits(q.z);
+        }
+
+        /** Distance of a control point to the swept sphere segment between two other control points.
+        */
+        float evalError(const float3* points, const float* widths, uint32_t a, uint32_t b, uint32_t k)
+        {
+            float3 d = points[b] - points[a];
+            float dd = dot(d, d);
+            float t = dd > 0.f ? std::clamp(dot(points[k] - points[a], d) / dd, 0.f, 1.f) : 0.f;
+            float3 q = points[a] + t * d;
+            float r = 0.5f * (widths[a] + t * (widths[b] - widths[a]));
+            return length(points[k] - q) + std::abs(0.5f * widths[k] - r);
+        }
+
+        /** Mark the control points of a strand to keep.
+            \param[in] points Control points of the strand.
+            \param[in] widths Widths of the strand.
+            \param[in] count Number of control points.
+            \param[in] settings Simplification settings.
+            \param[out] keep Keep flag per control point.
+            \return Number of control points kept.
+        */
+        uint32_t simplifyStrand(const float3* points, const float* widths, uint32_t count, const CurveSimplificationSettings& settings, uint8_t* keep)
+        {
+            if (count <= 2 || settings.maxError <= 0.f)
+            {
+                std::fill(keep, keep + count, (uint8_t)1);
+                return count;
+            }
+
+            std::fill(keep, keep + count, (uint8_t)0);
+            keep[0] = keep[count - 1] = 1;
+            uint32_t keptCount = 2;
+
+            // Douglas-Peucker reduction on the swept sphere distance.
+            thread_local std::vector<std::pair<uint32_t, uint32_t>> stack;
+            stack.clear();
+            stack.emplace_back(0, count - 1);
+            while (!stack.empty())
+            {
+                auto [a, b] = stack.back();
+                stack.pop_back();
+
+                float maxError = 0.f;
+                uint32_t maxIndex = a;
+                for (uint32_t k = a + 1; k < b; k++)
+                {
+                    float error = evalError(points, widths, a, b, k);
+                    if (error > maxError)
+                    {
+                        maxError = error;
+                        maxIndex = k;
+                    }
+                }
+
+                if (maxError > settings.maxError)
+                {
+                    keep[maxIndex] = 1;
+                    keptCount++;
+                    if (maxIndex - a > 1) stack.emplace_back(a, maxIndex);
+                    if (b - maxIndex > 1) stack.emplace_back(maxIndex, b);
+                }
+            }
+
+            // Refine the worst segments until the minimum vertex count is reached.
+            uint32_t minCount = std::min(settings.minVerticesPerStrand, count);
+            while (keptCount < minCount)
+            {
+                float maxError = -1.f;
+                uint32_t maxIndex = 0;
+                uint32_t a = 0;
+                for (uint32_t b = 1; b < count; b++)
+                {
+                    if (!keep[b]) continue;
+                    for (uint32_t k = a + 1; k < b; k++)
+                    {
+                        float error = evalError(points, widths, a, b, k);
+                        if (error > maxError)
+                        {
+                            maxError = error;
+                            maxIndex = k;
+                        }
+                    }
+                    a = b;
+                }
+                FALCOR_ASSERT(maxError >= 0.f && !keep[maxIndex]);
+                keep[maxIndex] = 1;
+                keptCount++;
+            }
+
+            return keptCount;
+        }
+    }
+
+    std::vector<uint32_t> CurveSimplifier::selectStrands(uint32_t strandCount, const float3* rootPositions, float strandFraction)
+    {
+        FALCOR_CHECK(strandFraction > 0.f && strandFraction <= 1.f, "Strand fraction must be in (0, 1], got {}.", strandFraction);
+
+        std::vector<uint32_t> strands(strandCount);
+        std::iota(strands.begin(), strands.end(), 0u);
+
+        uint32_t keepCount = std::max(1u, (uint32_t)std::lround(strandFraction * strandCount));
+        if (strandCount == 0 || keepCount >= strandCount) return strands;
+
+        // Order the strands along a Morton curve over the root positions.
+        float3 minPos = rootPositions[0];
+        float3 maxPos = rootPositions[0];
+        for (uint32_t i = 1; i < strandCount; i++)
+        {
+            minPos = min(minPos, rootPositions[i]);
+            maxPos = max(maxPos, rootPositions[i]);
+        }
+        float3 extent = maxPos - minPos;
+        float3 invExtent = float3(extent.x > 0.f ? 1.f / extent.x : 0.f, extent.y > 0.f ? 1.f / extent.y : 0.f, extent.z > 0.f ? 1.f / extent.z : 0.f);
+
+        std::vector<std::pair<uint32_t, uint32_t>> order(strandCount);
+        for (uint32_t i = 0; i < strandCount; i++) order[i] = { mortonCode((rootPositions[i] - minPos) * invExtent), i };
+        std::sort(order.begin(), order.end());
+
+        // Keep evenly spaced strands along the curve.
+        std::vector<uint32_t> kept(keepCount);
+        for (uint32_t k = 0; k < keepCount; k++)
+        {
+            uint32_t i = (uint32_t)(((uint64_t)2 * k + 1) * strandCount / ((uint64_t)2 * keepCount));
+            kept[k] = order[i].second;
+        }
+        std::sort(kept.begin(), kept.end());
+
+        return kept;
+    }
+
+    CurveSimplifier::Result CurveSimplifier::simplify(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, const CurveSimplificationSettings& settings)
+    {
+        Selection selection = select(strandCount, vertexCountsPerStrand, controlPoints, widths, settings);
+        return apply(selection, selection.inputVertexCount, controlPoints, widths, UVs);
+    }
+
+    CurveSimplifier::Selection CurveSimplifier::select(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const CurveSimplificationSettings& settings)
+    {
+        FALCOR_CHECK(settings.maxError >= 0.f, "Maximum error must be non-negative, got {}.", settings.maxError);
+
+        // Compute offsets of the input strands.
+        std::vector<uint32_t> inputOffsets(strandCount + 1, 0);
+        for (uint32_t i = 0; i < strandCount; i++) inputOffsets[i + 1] = inputOffsets[i] + vertexCountsPerStrand[i];
+        uint32_t inputVertexCount = inputOffsets[strandCount];
+
+        // Select the strands to keep.
+        std::vector<float3> rootPositions(strandCount);
+        for (uint32_t i = 0; i < strandCount; i++)
+            rootPositions[i] = vertexCountsPerStrand[i] > 0 ? controlPoints[inputOffsets[i]] : float3(0.f);
+        std::vector<uint32_t> strands = selectStrands(strandCount, rootPositions.data(), settings.strandFraction);
+
+        // Mark the control points to keep in each selected strand.
+        std::vector<uint8_t> keep(inputVertexCount, 0);
+        std::vector<uint32_t> outputOffsets(strands.size() + 1, 0);
+
+        NumericRange<uint32_t> strandRange(0, (uint32_t)strands.size());
+        std::for_each(std::execution::par, strandRange.begin(), strandRange.end(), [&](uint32_t i)
+        {
+            uint32_t offset = inputOffsets[strands[i]];
+            outputOffsets[i + 1] = simplifyStrand(controlPoints + offset, widths + offset, vertexCountsPerStrand[strands[i]], settings, keep.data() + offset);
+        });
+        std::partial_sum(outputOffsets.begin(), outputOffsets.end(), outputOffsets.begin());
+
+        // Gather the indices of the kept control points.
+        Selection selection;
+        selection.inputVertexCount = inputVertexCount;
+        selection.widthScale = strands.empty() ? 1.f : std::pow((float)strandCount / (float)strands.size(), settings.widthCompensation);
+        selection.vertexCountsPerStrand.resize(strands.size());
+        selection.vertexIndices.resize(outputOffsets.back());
+
+        std::for_each(std::execution::par, strandRange.begin(), strandRange.end(), [&](uint32_t i)
+        {
+            uint32_t dst = outputOffsets[i];
+            selection.vertexCountsPerStrand[i] = outputOffsets[i + 1] - dst;
+            for (uint32_t src = inputOffsets[strands[i]]; src < inputOffsets[strands[i] + 1]; src++)
+            {
+                if (keep[src]) selection.vertexIndices[dst++] = src;
+            }
+            FALCOR_ASSERT(dst == outputOffsets[i + 1]);
+        });
+
+        return selection;
+    }
+
+    CurveSimplifier::Result CurveSimplifier::apply(const Selection& selection, uint32_t vertexCount, const float3* controlPoints, const float* widths, const float2* UVs)
+    {
+        FALCOR_CHECK(vertexCount == selection.inputVertexCount, "Curve has {} control points, but the simplification was selected for {}.", vertexCount, selection.inputVertexCount);
+
+        Result result;
+        size_t outputVertexCount = selection.vertexIndices.size();
+        result.vertexCountsPerStrand = selection.vertexCountsPerStrand;
+        result.controlPoints.resize(outputVertexCount);
+        result.widths.resize(outputVertexCount);
+        if (UVs) result.UVs.resize(outputVertexCount);
+
+        for (size_t i = 0; i < outputVertexCount; i++)
+        {
+            uint32_t src = selection.vertexIndices[i];
+            result.controlPoints[i] = controlPoints[src];
+            result.widths[i] = widths[src] * selection.widthScale;
+            if (UVs) result.UVs[i] = UVs[src];
+        }
+
+        return result;
+    }
+}
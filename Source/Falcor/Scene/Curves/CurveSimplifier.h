@@ -0,0 +1,133 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/fast_vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Curve simplification settings.
+    */
+    struct CurveSimplificationSettings
+    {
+        float maxError = 0.f;               ///< Maximum deviation of a simplified strand from its original control points, in the units of the input positions. The deviation includes the change in radius. Zero disables control point reduction.
+        float strandFraction = 1.f;         ///< Fraction of strands to keep in (0, 1]. One disables strand reduction.
+        float widthCompensation = 0.5f;     ///< Widths of the kept strands are scaled by (1 / keptFraction)^widthCompensation. Zero disables compensation, 0.5 matches the perceptual scaling used for 'keepOneEveryXStrands', one preserves the total projected area.
+        uint32_t minVerticesPerStrand = 2;  ///< Minimum number of control points kept per strand (unless the strand has fewer to begin with).
+
+        bool isEnabled() const { return maxError > 0.f || strandFraction < 1.f; }
+    };
+
+    /** Simplifies curve strands ahead of tessellation.
+
+        Control points are removed per strand with a Douglas-Peucker style reduction. A point is
+        kept if removing it would move the original control point further than 'maxError' away
+        from the simplified strand, where the distance is measured to the swept sphere, i.e.,
+        the change in radius is added to the change in position. The end points are always kept.
+        Since the curve tessellators interpolate the control points, the tolerance also bounds
+        the deviation of the tessellated strands up to the smoothing of the splines.
+
+        Strands are thinned out by keeping an evenly spaced subset of the strands ordered along
+        a Morton curve over their root positions. This distributes the removed strands uniformly
+        over the groom, which preserves coverage better than removing strands by index.
+
+        The output uses the same layout as the input and can be passed to any of the functions
+        in CurveTessellation. All strands are processed in parallel.
+
+        For animated curves, the control points to keep should be selected once with select()
+        and applied to every keyframe with apply(), so that all keyframes have the same topology.
+    */
+    class FALCOR_API CurveSimplifier
+    {
+    public:
+        struct Result
+        {
+            fast_vector<uint32_t> vertexCountsPerStrand;
+            fast_vector<float3> controlPoints;
+            fast_vector<float> widths;
+            fast_vector<float2> UVs;        ///< Texture coordinates. Empty if no texture coordinates were given.
+        };
+
+        /** Control points kept by the simplification.
+        */
+        struct Selection
+        {
+            uint32_t inputVertexCount = 0;                  ///< Number of control points of the input strands.
+            fast_vector<uint32_t> vertexCountsPerStrand;    ///< Number of kept control points per kept strand.
+            std::vector<uint32_t> vertexIndices;            ///< Indices of the kept control points into the input arrays.
+            float widthScale = 1.f;                         ///< Scale applied to the widths of the kept strands.
+        };
+
+        /** Simplify curve strands.
+            \param[in] strandCount Number of curve strands.
+            \param[in] vertexCountsPerStrand Number of control points per strand.
+            \param[in] controlPoints Array of control points.
+            \param[in] widths Array of curve widths, i.e., diameters of swept spheres.
+            \param[in] UVs Array of texture coordinates. This is optional and can be nullptr.
+            \param[in] settings Simplification settings.
+            \return Simplified strands.
+        */
+        static Result simplify(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const float2* UVs, const CurveSimplificationSettings& settings);
+
+        /** Select the strands and control points to keep.
+            \param[in] strandCount Number of curve strands.
+            \param[in] vertexCountsPerStrand Number of control points per strand.
+            \param[in] controlPoints Array of control points.
+            \param[in] widths Array of curve widths, i.e., diameters of swept spheres.
+            \param[in] settings Simplification settings.
+            eturn Selected control points.
+        */
+        static Selection select(uint32_t strandCount, const uint32_t* vertexCountsPerStrand, const float3* controlPoints, const float* widths, const CurveSimplificationSettings& settings);
+
+        /** Gather the selected control points. The input must have the same topology as the strands the selection was made from.
+            \param[in] selection Selected control points.
+            \param[in] vertexCount Number of control points in the input arrays.
+            \param[in] controlPoints Array of control points.
+            \param[in] widths Array of curve widths, i.e., diameters of swept spheres.
+            \param[in] UVs Array of texture coordinates. This is optional and can be nullptr.
+            eturn Simplified strands.
+        */
+        static Result apply(const Selection& selection, uint32_t vertexCount, const float3* controlPoints, const float* widths, const float2* UVs);
+
+        /** Select the strands to keep for a given strand fraction.
+            \param[in] strandCount Number of curve strands.
+            \param[in] rootPositions Position of the first control point of each strand.
+            \param[in] strandFraction Fraction of strands to keep in (0, 1].
+            \return Sorted indices of the strands to keep. At least one strand is kept if strandCount > 0.
+        */
+        static std::vector<uint32_t> selectStrands(uint32_t strandCount, const float3* rootPositions, float strandFraction);
+
+    private:
+        CurveSimplifier() = default;
+        CurveSimplifier(const CurveSimplifier&) = delete;
+        void operator=(const CurveSimplifier&) = delete;
+    };
+}
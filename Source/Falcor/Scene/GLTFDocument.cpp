@@ -0,0 +1,507 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GLTFDocument.h"
+#include "Core/Error.h"
+#include "Scene/ImporterError.h"
+#include "Utils/StringFormatters.h"
+#include "Utils/StringUtils.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace Falcor::gltf
+{
+
+namespace
+{
+const uint32_t kGlbMagic = 0x46546C67;     // "glTF"
+const uint32_t kGlbChunkJson = 0x4E4F534A; // "JSON"
+const uint32_t kGlbChunkBin = 0x004E4942;  // "BIN\0"
+
+uint32_t readU32(const uint8_t* p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t getComponentCount(const std::string& type)
+{
+    if (type == "SCALAR")
+        return 1;
+    if (type == "VEC2")
+        return 2;
+    if (type == "VEC3")
+        return 3;
+    if (type == "VEC4" || type == "MAT2")
+        return 4;
+    if (type == "MAT3")
+        return 9;
+    if (type == "MAT4")
+        return 16;
+    return 0;
+}
+
+bool isValidComponentType(uint32_t type)
+{
+    switch (ComponentType(type))
+    {
+    case ComponentType::Byte:
+    case ComponentType::UnsignedByte:
+    case ComponentType::Short:
+    case ComponentType::UnsignedShort:
+    case ComponentType::UnsignedInt:
+    case ComponentType::Float:
+        return true;
+    }
+    return false;
+}
+
+template<typename T>
+T load(const uint8_t* p)
+{
+    T value;
+    std::memcpy(&value, p, sizeof(T));
+    return value;
+}
+
+float readFloatComponent(const uint8_t* p, ComponentType type, bool normalized)
+{
+    switch (type)
+    {
+    case ComponentType::Float:
+        return load<float>(p);
+    case ComponentType::UnsignedByte:
+        return normalized ? load<uint8_t>(p) / 255.f : float(load<uint8_t>(p));
+    case ComponentType::Byte:
+        return normalized ? std::max(load<int8_t>(p) / 127.f, -1.f) : float(load<int8_t>(p));
+    case ComponentType::UnsignedShort:
+        return normalized ? load<uint16_t>(p) / 65535.f : float(load<uint16_t>(p));
+    case ComponentType::Short:
+        return normalized ? std::max(load<int16_t>(p) / 32767.f, -1.f) : float(load<int16_t>(p));
+    case ComponentType::UnsignedInt:
+        return normalized ? float(load<uint32_t>(p) / 4294967295.0) : float(load<uint32_t>(p));
+    }
+    FALCOR_UNREACHABLE();
+    return 0.f;
+}
+
+uint32_t readUintComponent(const uint8_t* p, ComponentType type)
+{
+    switch (type)
+    {
+    case ComponentType::UnsignedByte:
+        return load<uint8_t>(p);
+    case ComponentType::UnsignedShort:
+        return load<uint16_t>(p);
+    case ComponentType::UnsignedInt:
+        return load<uint32_t>(p);
+    case ComponentType::Byte:
+        return (uint32_t)std::max<int8_t>(load<int8_t>(p), 0);
+    case ComponentType::Short:
+        return (uint32_t)std::max<int16_t>(load<int16_t>(p), 0);
+    case ComponentType::Float:
+        return (uint32_t)std::max(load<float>(p), 0.f);
+    }
+    FALCOR_UNREACHABLE();
+    return 0;
+}
+} // namespace
+
+uint32_t getComponentSize(ComponentType type)
+{
+    switch (type)
+    {
+    case ComponentType::Byte:
+    case ComponentType::UnsignedByte:
+        return 1;
+    case ComponentType::Short:
+    case ComponentType::UnsignedShort:
+        return 2;
+    case ComponentType::UnsignedInt:
+    case ComponentType::Float:
+        return 4;
+    }
+    FALCOR_UNREACHABLE();
+    return 0;
+}
+
+void triangulate(PrimitiveMode mode, const uint32_t* pIndices, uint32_t indexCount, std::vector<uint32_t>& triangles)
+{
+    FALCOR_CHECK(mode == PrimitiveMode::TriangleStrip || mode == PrimitiveMode::TriangleFan, "'mode' must be a triangle strip or fan.");
+
+    triangles.clear();
+    if (indexCount < 3)
+        return;
+    triangles.reserve(size_t(indexCount - 2) * 3);
+    for (uint32_t i = 0; i + 2 < indexCount; i++)
+    {
+        if (mode == PrimitiveMode::TriangleStrip)
+        {
+            uint32_t odd = i % 2;
+            triangles.insert(triangles.end(), {pIndices[i], pIndices[i + 1 + odd], pIndices[i + 2 - odd]});
+        }
+        else
+        {
+            triangles.insert(triangles.end(), {pIndices[i + 1], pIndices[i + 2], pIndices[0]});
+        }
+    }
+}
+
+std::unique_ptr<Document> Document::load(const std::filesystem::path& path)
+{
+    std::unique_ptr<Document> pDocument(new Document());
+    pDocument->mPath = path;
+    if (!pDocument->mFile.open(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan))
+        throw ImporterError(path, "Failed to open file.");
+    pDocument->parse(pDocument->mFile.getData(), pDocument->mFile.getMappedSize());
+    return pDocument;
+}
+
+std::unique_ptr<Document> Document::loadFromMemory(const void* pData, size_t byteSize, const std::filesystem::path& path)
+{
+    std::unique_ptr<Document> pDocument(new Document());
+    pDocument->mPath = path;
+    pDocument->parse(pData, byteSize);
+    return pDocument;
+}
+
+const Accessor& Document::getAccessor(uint32_t index) const
+{
+    FALCOR_CHECK(index < mAccessors.size(), "Accessor index {} is out of range.", index);
+    return mAccessors[index];
+}
+
+AccessorView Document::getAccessorView(uint32_t index) const
+{
+    const Accessor& accessor = getAccessor(index);
+    AccessorView view;
+    view.count = accessor.count;
+    view.stride = accessor.getElementSize();
+    if (accessor.bufferView)
+    {
+        const BufferView& bufferView = mBufferViews[*accessor.bufferView];
+        view.pData = mBuffers[bufferView.buffer].pData + bufferView.byteOffset + accessor.byteOffset;
+        if (bufferView.byteStride != 0)
+            view.stride = bufferView.byteStride;
+    }
+    return view;
+}
+
+const void* Document::getTightData(uint32_t index, ComponentType componentType, uint32_t componentCount, size_t elementSize, size_t alignment) const
+{
+    const Accessor& accessor = getAccessor(index);
+    if (accessor.componentType != componentType || accessor.componentCount != componentCount || accessor.normalized || accessor.sparse)
+        return nullptr;
+    if (accessor.getElementSize() != elementSize)
+        return nullptr;
+
+    AccessorView view = getAccessorView(index);
+    if (!view.pData || view.stride != elementSize || reinterpret_cast<uintptr_t>(view.pData) % alignment != 0)
+        return nullptr;
+    return view.pData;
+}
+
+template<typename F>
+void Document::forEachElement(uint32_t index, F func) const
+{
+    // Calls func(elementIndex, pElement) for the dense elements and then for the sparse substitutions.
+    // pElement is nullptr for accessors without a buffer view, which are all zeros.
+    const Accessor& accessor = getAccessor(index);
+    AccessorView view = getAccessorView(index);
+    for (uint32_t i = 0; i < view.count; i++)
+        func(i, view.pData ? view.pData + size_t(i) * view.stride : nullptr);
+
+    if (accessor.sparse)
+    {
+        const Accessor::Sparse& sparse = *accessor.sparse;
+        const BufferView& indicesView = mBufferViews[sparse.indicesBufferView];
+        const BufferView& valuesView = mBufferViews[sparse.valuesBufferView];
+        const uint8_t* pIndices = mBuffers[indicesView.buffer].pData + indicesView.byteOffset + sparse.indicesByteOffset;
+        const uint8_t* pValues = mBuffers[valuesView.buffer].pData + valuesView.byteOffset + sparse.valuesByteOffset;
+        const uint32_t indexSize = getComponentSize(sparse.indicesComponentType);
+        const uint32_t elementSize = accessor.getElementSize();
+        for (uint32_t i = 0; i < sparse.count; i++)
+        {
+            uint32_t element = readUintComponent(pIndices + size_t(i) * indexSize, sparse.indicesComponentType);
+            if (element >= accessor.count)
+                throw ImporterError(mPath, "Sparse accessor {} has an out of range index {}.", index, element);
+            func(element, pValues + size_t(i) * elementSize);
+        }
+    }
+}
+
+void Document::readFloats(uint32_t index, uint32_t componentCount, float* pDst) const
+{
+    const Accessor& accessor = getAccessor(index);
+    const uint32_t componentSize = getComponentSize(accessor.componentType);
+    const uint32_t copyCount = std::min(componentCount, accessor.componentCount);
+
+    forEachElement(
+        index,
+        [&](uint32_t element, const uint8_t* pElement)
+        {
+            float* pOut = pDst + size_t(element) * componentCount;
+            uint32_t c = 0;
+            if (pElement)
+            {
+                for (; c < copyCount; c++)
+                    pOut[c] = readFloatComponent(pElement + c * componentSize, accessor.componentType, accessor.normalized);
+            }
+            for (; c < componentCount; c++)
+                pOut[c] = 0.f;
+        }
+    );
+}
+
+void Document::readUints(uint32_t index, uint32_t* pDst) const
+{
+    const Accessor& accessor = getAccessor(index);
+    const uint32_t componentSize = getComponentSize(accessor.componentType);
+
+    forEachElement(
+        index,
+        [&](uint32_t element, const uint8_t* pElement)
+        {
+            uint32_t* pOut = pDst + size_t(element) * accessor.componentCount;
+            for (uint32_t c = 0; c < accessor.componentCount; c++)
+                pOut[c] = pElement ? readUintComponent(pElement + c * componentSize, accessor.componentType) : 0;
+        }
+    );
+}
+
+std::pair<const uint8_t*, size_t> Document::getBufferViewData(uint32_t index) const
+{
+    FALCOR_CHECK(index < mBufferViews.size(), "Buffer view index {} is out of range.", index);
+    const BufferView& bufferView = mBufferViews[index];
+    return {mBuffers[bufferView.buffer].pData + bufferView.byteOffset, bufferView.byteLength};
+}
+
+void Document::parse(const void* pData, size_t byteSize)
+{
+    const uint8_t* pBytes = static_cast<const uint8_t*>(pData);
+    const uint8_t* pJson = pBytes;
+    size_t jsonSize = byteSize;
+    const uint8_t* pBinChunk = nullptr;
+    size_t binChunkSize = 0;
+
+    if (byteSize >= 12 && readU32(pBytes) == kGlbMagic)
+    {
+        // Binary glTF: 12 byte header followed by a JSON chunk and an optional BIN chunk.
+        uint32_t version = readU32(pBytes + 4);
+        if (version != 2)
+            throw ImporterError(mPath, "Unsupported GLB version {}.", version);
+        size_t length = std::min<size_t>(readU32(pBytes + 8), byteSize);
+
+        pJson = nullptr;
+        size_t offset = 12;
+        while (offset + 8 <= length)
+        {
+            uint32_t chunkLength = readU32(pBytes + offset);
+            uint32_t chunkType = readU32(pBytes + offset + 4);
+            offset += 8;
+            if (offset + chunkLength > length)
+                throw ImporterError(mPath, "GLB chunk exceeds the file size.");
+            if (chunkType == kGlbChunkJson && !pJson)
+            {
+                pJson = pBytes + offset;
+                jsonSize = chunkLength;
+            }
+            else if (chunkType == kGlbChunkBin && !pBinChunk)
+            {
+                pBinChunk = pBytes + offset;
+                binChunkSize = chunkLength;
+            }
+            offset += (chunkLength + 3) & ~3u;
+        }
+        if (!pJson)
+            throw ImporterError(mPath, "GLB file has no JSON chunk.");
+    }
+
+    try
+    {
+        mJson = nlohmann::json::parse(pJson, pJson + jsonSize);
+    }
+    catch (const nlohmann::json::exception& e)
+    {
+        throw ImporterError(mPath, "Failed to parse JSON: {}", e.what());
+    }
+
+    const auto& asset = mJson.find("asset");
+    if (asset == mJson.end() || !asset->is_object())
+        throw ImporterError(mPath, "Missing 'asset' property.");
+    std::string version = asset->value("version", "");
+    if (version.empty() || version[0] != '2')
+        throw ImporterError(mPath, "Unsupported glTF version '{}'.", version);
+
+    try
+    {
+        loadBuffers(pBinChunk, binChunkSize);
+        parseBufferViews();
+        parseAccessors();
+    }
+    catch (const nlohmann::json::exception& e)
+    {
+        throw ImporterError(mPath, "Malformed asset: {}", e.what());
+    }
+}
+
+void Document::loadBuffers(const uint8_t* pBinChunk, size_t binChunkSize)
+{
+    const auto& buffers = mJson.value("buffers", nlohmann::json::array());
+    mBuffers.resize(buffers.size());
+
+    for (size_t i = 0; i < buffers.size(); i++)
+    {
+        const auto& buffer = buffers[i];
+        size_t byteLength = buffer.at("byteLength").get<size_t>();
+        Buffer& dst = mBuffers[i];
+
+        if (!buffer.contains("uri"))
+        {
+            // Only the first buffer of a GLB file may omit the URI, it then refers to the BIN chunk.
+            if (i != 0 || !pBinChunk)
+                throw ImporterError(mPath, "Buffer {} has no URI.", i);
+            if (binChunkSize < byteLength)
+                throw ImporterError(mPath, "GLB BIN chunk is smaller than buffer 0.");
+            dst.pData = pBinChunk;
+        }
+        else
+        {
+            std::string uri = buffer.at("uri").get<std::string>();
+            if (uri.rfind("data:", 0) == 0)
+            {
+                auto base64 = uri.find(";base64,");
+                if (base64 == std::string::npos)
+                    throw ImporterError(mPath, "Buffer {} has an unsupported data URI.", i);
+                auto& decoded = mDecodedBuffers.emplace_back(decodeBase64(uri.substr(base64 + 8)));
+                if (decoded.size() < byteLength)
+                    throw ImporterError(mPath, "Buffer {} data URI is shorter than its byte length.", i);
+                dst.pData = decoded.data();
+            }
+            else
+            {
+                auto path = mPath.parent_path() / decodeURI(uri);
+                auto& pFile = mMappedBuffers.emplace_back(std::make_unique<MemoryMappedFile>());
+                if (byteLength > 0 && !pFile->open(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::RandomAccess))
+                    throw ImporterError(mPath, "Failed to open buffer file '{}'.", path);
+                if (pFile->getMappedSize() < byteLength)
+                    throw ImporterError(mPath, "Buffer file '{}' is smaller than its byte length.", path);
+                dst.pData = static_cast<const uint8_t*>(pFile->getData());
+            }
+        }
+        dst.byteLength = byteLength;
+    }
+}
+
+void Document::parseBufferViews()
+{
+    const auto& bufferViews = mJson.value("bufferViews", nlohmann::json::array());
+    mBufferViews.resize(bufferViews.size());
+
+    for (size_t i = 0; i < bufferViews.size(); i++)
+    {
+        const auto& src = bufferViews[i];
+        BufferView& dst = mBufferViews[i];
+        dst.buffer = src.at("buffer").get<uint32_t>();
+        dst.byteOffset = src.value("byteOffset", size_t(0));
+        dst.byteLength = src.at("byteLength").get<size_t>();
+        dst.byteStride = src.value("byteStride", 0u);
+
+        if (dst.buffer >= mBuffers.size())
+            throw ImporterError(mPath, "Buffer view {} references invalid buffer {}.", i, dst.buffer);
+        if (dst.byteOffset + dst.byteLength > mBuffers[dst.buffer].byteLength)
+            throw ImporterError(mPath, "Buffer view {} exceeds the size of buffer {}.", i, dst.buffer);
+    }
+}
+
+void Document::parseAccessors()
+{
+    const auto& accessors = mJson.value("accessors", nlohmann::json::array());
+    mAccessors.resize(accessors.size());
+
+    auto checkRange = [&](size_t accessorIndex, uint32_t bufferViewIndex, size_t byteOffset, size_t stride, size_t elementSize, size_t count)
+    {
+        if (bufferViewIndex >= mBufferViews.size())
+            throw ImporterError(mPath, "Accessor {} references invalid buffer view {}.", accessorIndex, bufferViewIndex);
+        if (count == 0)
+            return;
+        const BufferView& bufferView = mBufferViews[bufferViewIndex];
+        if (byteOffset + stride * (count - 1) + elementSize > bufferView.byteLength)
+            throw ImporterError(mPath, "Accessor {} exceeds the size of buffer view {}.", accessorIndex, bufferViewIndex);
+    };
+
+    for (size_t i = 0; i < accessors.size(); i++)
+    {
+        const auto& src = accessors[i];
+        Accessor& dst = mAccessors[i];
+
+        uint32_t componentType = src.at("componentType").get<uint32_t>();
+        if (!isValidComponentType(componentType))
+            throw ImporterError(mPath, "Accessor {} has invalid component type {}.", i, componentType);
+        dst.componentType = ComponentType(componentType);
+        dst.componentCount = getComponentCount(src.at("type").get<std::string>());
+        if (dst.componentCount == 0)
+            throw ImporterError(mPath, "Accessor {} has invalid type '{}'.", i, src.at("type").get<std::string>());
+        dst.count = src.at("count").get<uint32_t>();
+        dst.normalized = src.value("normalized", false);
+        dst.byteOffset = src.value("byteOffset", size_t(0));
+
+        if (src.contains("bufferView"))
+        {
+            dst.bufferView = src["bufferView"].get<uint32_t>();
+            uint32_t byteStride = *dst.bufferView < mBufferViews.size() ? mBufferViews[*dst.bufferView].byteStride : 0;
+            size_t stride = byteStride != 0 ? byteStride : dst.getElementSize();
+            checkRange(i, *dst.bufferView, dst.byteOffset, stride, dst.getElementSize(), dst.count);
+        }
+
+        if (src.contains("sparse"))
+        {
+            const auto& sparse = src["sparse"];
+            Accessor::Sparse s;
+            s.count = sparse.at("count").get<uint32_t>();
+            const auto& indices = sparse.at("indices");
+            s.indicesBufferView = indices.at("bufferView").get<uint32_t>();
+            s.indicesByteOffset = indices.value("byteOffset", size_t(0));
+            uint32_t indicesComponentType = indices.at("componentType").get<uint32_t>();
+            if (!isValidComponentType(indicesComponentType) || ComponentType(indicesComponentType) == ComponentType::Float)
+                throw ImporterError(mPath, "Sparse accessor {} has invalid index component type {}.", i, indicesComponentType);
+            s.indicesComponentType = ComponentType(indicesComponentType);
+            const auto& values = sparse.at("values");
+            s.valuesBufferView = values.at("bufferView").get<uint32_t>();
+            s.valuesByteOffset = values.value("byteOffset", size_t(0));
+
+            size_t indexSize = getComponentSize(s.indicesComponentType);
+            checkRange(i, s.indicesBufferView, s.indicesByteOffset, indexSize, indexSize, s.count);
+            checkRange(i, s.valuesBufferView, s.valuesByteOffset, dst.getElementSize(), dst.getElementSize(), s.count);
+            dst.sparse = s;
+        }
+    }
+}
+
+} // namespace Falcor::gltf
@@ -0,0 +1,224 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include <nlohmann/json.hpp>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace Falcor::gltf
+{
+
+/// Accessor component types, with the values used in glTF.
+enum class ComponentType : uint32_t
+{
+    Byte = 5120,
+    UnsignedByte = 5121,
+    Short = 5122,
+    UnsignedShort = 5123,
+    UnsignedInt = 5125,
+    Float = 5126,
+};
+
+/// Primitive topologies, with the values used in glTF.
+enum class PrimitiveMode : uint32_t
+{
+    Points = 0,
+    Lines = 1,
+    LineLoop = 2,
+    LineStrip = 3,
+    Triangles = 4,
+    TriangleStrip = 5,
+    TriangleFan = 6,
+};
+
+/// Get the size of a component type in bytes.
+FALCOR_API uint32_t getComponentSize(ComponentType type);
+
+/**
+ * Convert triangle strip or fan indices into a triangle list.
+ * Every other strip triangle is flipped to keep a consistent winding.
+ * @param[in] mode Either TriangleStrip or TriangleFan.
+ * @param[in] pIndices Strip or fan indices.
+ * @param[in] indexCount Number of indices.
+ * @param[out] triangles Triangle list indices.
+ */
+FALCOR_API void triangulate(PrimitiveMode mode, const uint32_t* pIndices, uint32_t indexCount, std::vector<uint32_t>& triangles);
+
+struct BufferView
+{
+    uint32_t buffer = 0;
+    size_t byteOffset = 0;
+    size_t byteLength = 0;
+    uint32_t byteStride = 0; ///< Zero if elements are tightly packed.
+};
+
+struct Accessor
+{
+    struct Sparse
+    {
+        uint32_t count = 0;
+        uint32_t indicesBufferView = 0;
+        size_t indicesByteOffset = 0;
+        ComponentType indicesComponentType = ComponentType::UnsignedInt;
+        uint32_t valuesBufferView = 0;
+        size_t valuesByteOffset = 0;
+    };
+
+    std::optional<uint32_t> bufferView; ///< Not set if all elements are zero (before applying sparse values).
+    size_t byteOffset = 0;
+    ComponentType componentType = ComponentType::Float;
+    uint32_t componentCount = 1; ///< Number of components per element (SCALAR = 1, VEC2 = 2, ..., MAT4 = 16).
+    uint32_t count = 0;
+    bool normalized = false;
+    std::optional<Sparse> sparse;
+
+    uint32_t getElementSize() const { return getComponentSize(componentType) * componentCount; }
+};
+
+/**
+ * Strided view of the dense part of an accessor, pointing into the buffer data.
+ */
+struct AccessorView
+{
+    const uint8_t* pData = nullptr; ///< First element, or nullptr if the accessor has no buffer view.
+    uint32_t count = 0;
+    uint32_t stride = 0;
+};
+
+/**
+ * A parsed glTF 2.0 asset (.gltf or .glb).
+ *
+ * Buffers are not copied: external .bin files are memory-mapped and the binary chunk of a .glb file is
+ * referenced in place. Only base64 data URIs are decoded into memory. Accessors and buffer views are
+ * parsed and validated up front, so that the accessor data can be read concurrently without further checks.
+ * The remaining parts of the asset (nodes, meshes, materials, ...) are accessed through the JSON document.
+ */
+class FALCOR_API Document
+{
+public:
+    /**
+     * Load an asset from a file.
+     * Throws an ImporterError if the file can't be read or is malformed.
+     * @param[in] path Path to a .gltf or .glb file.
+     */
+    static std::unique_ptr<Document> load(const std::filesystem::path& path);
+
+    /**
+     * Load an asset from memory. The memory must stay valid for the lifetime of the document.
+     * Throws an ImporterError if the data is malformed.
+     * @param[in] pData Contents of a .gltf or .glb file.
+     * @param[in] byteSize Size of the data in bytes.
+     * @param[in] path Path used to resolve relative URIs and for error messages.
+     */
+    static std::unique_ptr<Document> loadFromMemory(const void* pData, size_t byteSize, const std::filesystem::path& path);
+
+    const std::filesystem::path& getPath() const { return mPath; }
+    const nlohmann::json& getJson() const { return mJson; }
+
+    uint32_t getAccessorCount() const { return (uint32_t)mAccessors.size(); }
+    const Accessor& getAccessor(uint32_t index) const;
+
+    /**
+     * Get a view of the dense part of an accessor. Sparse values are not applied.
+     */
+    AccessorView getAccessorView(uint32_t index) const;
+
+    /**
+     * Get a pointer to accessor data that can be used in place as an array of T.
+     * @param[in] index Accessor index.
+     * @param[in] componentType Required component type.
+     * @param[in] componentCount Required number of components. sizeof(T) must match the element size.
+     * @return Pointer to the data, or nullptr if the accessor has a different layout, is normalized, strided, sparse
+     *         or misaligned. The data must then be read with readFloats() or readUints().
+     */
+    template<typename T>
+    const T* getTightData(uint32_t index, ComponentType componentType, uint32_t componentCount) const
+    {
+        const void* pData = getTightData(index, componentType, componentCount, sizeof(T), alignof(T));
+        return reinterpret_cast<const T*>(pData);
+    }
+
+    /**
+     * Read accessor data as floats, converting from the stored component type and applying sparse values.
+     * Normalized integers are mapped to [0, 1] or [-1, 1].
+     * @param[in] index Accessor index.
+     * @param[in] componentCount Number of components to write per element. Missing components are written as zero.
+     * @param[out] pDst Destination with room for count * componentCount floats.
+     */
+    void readFloats(uint32_t index, uint32_t componentCount, float* pDst) const;
+
+    /**
+     * Read scalar integer accessor data (e.g. indices or joint IDs) as 32-bit unsigned integers.
+     * @param[in] index Accessor index.
+     * @param[out] pDst Destination with room for count * componentCount values.
+     */
+    void readUints(uint32_t index, uint32_t* pDst) const;
+
+    /**
+     * Get the data of a buffer view, e.g. an embedded image.
+     * @return Pointer to the data and its size in bytes.
+     */
+    std::pair<const uint8_t*, size_t> getBufferViewData(uint32_t index) const;
+
+private:
+    Document() = default;
+
+    void parse(const void* pData, size_t byteSize);
+    void loadBuffers(const uint8_t* pBinChunk, size_t binChunkSize);
+    void parseBufferViews();
+    void parseAccessors();
+    const void* getTightData(uint32_t index, ComponentType componentType, uint32_t componentCount, size_t elementSize, size_t alignment) const;
+
+    template<typename F>
+    void forEachElement(uint32_t index, F func) const;
+
+    struct Buffer
+    {
+        const uint8_t* pData = nullptr;
+        size_t byteLength = 0;
+    };
+
+    std::filesystem::path mPath;
+    nlohmann::json mJson;
+
+    MemoryMappedFile mFile;                                             ///< The mapped .gltf/.glb file, if loaded from a file.
+    std::vector<std::unique_ptr<MemoryMappedFile>> mMappedBuffers;      ///< Mapped external buffer files.
+    std::vector<std::vector<uint8_t>> mDecodedBuffers;                  ///< Decoded data URI buffers.
+    std::vector<Buffer> mBuffers;
+    std::vector<BufferView> mBufferViews;
+    std::vector<Accessor> mAccessors;
+};
+
+} // namespace Falcor::gltf
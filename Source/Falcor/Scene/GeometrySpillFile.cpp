@@ -0,0 +1,91 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GeometrySpillFile.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/StringFormatters.h"
+
+namespace Falcor
+{
+    GeometrySpillFile::GeometrySpillFile(const std::filesystem::path& directory)
+    {
+        // Use a unique temporary file name, optionally placed in the given directory.
+        mPath = getTempFilePath();
+        if (!directory.empty()) mPath = directory / mPath.filename();
+
+        mStream.open(mPath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc);
+        if (!mStream)
+        {
+            FALCOR_THROW("Failed to create geometry spill file '{}'.", mPath);
+        }
+    }
+
+    GeometrySpillFile::~GeometrySpillFile()
+    {
+        mStream.close();
+        std::error_code ec;
+        if (!std::filesystem::remove(mPath, ec))
+        {
+            logWarning("Failed to remove geometry spill file '{}'.", mPath);
+        }
+    }
+
+    GeometrySpillFile::Range GeometrySpillFile::write(const void* pData, size_t size)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        Range range{ mSize, size };
+        if (size == 0) return range;
+
+        mStream.seekp((std::streamoff)mSize);
+        mStream.write(reinterpret_cast<const char*>(pData), (std::streamsize)size);
+        if (!mStream)
+        {
+            FALCOR_THROW("Failed to write {} bytes to geometry spill file '{}'.", size, mPath);
+        }
+        mSize += size;
+        return range;
+    }
+
+    void GeometrySpillFile::read(const Range& range, void* pDst) const
+    {
+        FALCOR_CHECK(range.offset + range.size <= mSize, "Range [{}, {}) is outside of the geometry spill file.", range.offset, range.offset + range.size);
+        if (range.size == 0) return;
+
+        std::lock_guard<std::mutex> lock(mMutex);
+
+        mStream.seekg((std::streamoff)range.offset);
+        mStream.read(reinterpret_cast<char*>(pDst), (std::streamsize)range.size);
+        if (!mStream)
+        {
+            FALCOR_THROW("Failed to read {} bytes from geometry spill file '{}'.", range.size, mPath);
+        }
+        mReadBytes += range.size;
+    }
+}
@@ -0,0 +1,116 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <vector>
+
+namespace Falcor
+{
+    /** Settings for building scenes out of core.
+    */
+    struct GeometrySpillSettings
+    {
+        uint64_t hostMemoryBudget = 1ull << 30;     ///< Budget in bytes for processed mesh data kept in host memory. Data beyond it is spilled to disk.
+        std::filesystem::path directory;            ///< Directory for the spill file. A temporary file path is used if empty.
+        uint64_t uploadChunkSize = 64ull << 20;     ///< Size in bytes of the staging chunks used to upload mesh data to the GPU without gathering it in host memory.
+    };
+
+    /** Append-only temporary file for geometry data that is evicted from host memory while building a scene.
+        Blocks are written once and can be read back any number of times. Writing a modified block appends
+        a new one; the old one is left in place until the file is closed. The file is deleted on destruction.
+        Reads are thread safe. Writes must not run concurrently with other accesses.
+    */
+    class FALCOR_API GeometrySpillFile
+    {
+    public:
+        /** Location of a block in the file.
+        */
+        struct Range
+        {
+            uint64_t offset = 0;    ///< Offset in bytes.
+            uint64_t size = 0;      ///< Size in bytes.
+        };
+
+        /** Create a spill file.
+            \param[in] directory Directory to create the file in. If empty, a temporary file path is used.
+        */
+        explicit GeometrySpillFile(const std::filesystem::path& directory = {});
+        ~GeometrySpillFile();
+
+        GeometrySpillFile(const GeometrySpillFile&) = delete;
+        GeometrySpillFile& operator=(const GeometrySpillFile&) = delete;
+
+        /** Append a block of data.
+            Throws an exception if the write fails.
+            \param[in] pData Data to write.
+            \param[in] size Size in bytes.
+            \return Location of the block.
+        */
+        Range write(const void* pData, size_t size);
+
+        template<typename T>
+        Range write(const std::vector<T>& data) { return write(data.data(), data.size() * sizeof(T)); }
+
+        /** Read a block of data, or a part of it.
+            Throws an exception if the read fails.
+            \param[in] range Location of the data.
+            \param[out] pDst Destination with space for 'range.size' bytes.
+        */
+        void read(const Range& range, void* pDst) const;
+
+        template<typename T>
+        void read(const Range& range, std::vector<T>& data) const
+        {
+            data.resize(range.size / sizeof(T));
+            read(range, data.data());
+        }
+
+        /** Get the path of the file.
+        */
+        const std::filesystem::path& getPath() const { return mPath; }
+
+        /** Get the file size in bytes.
+        */
+        uint64_t getSize() const { return mSize; }
+
+        /** Get the total number of bytes read back.
+        */
+        uint64_t getReadBytes() const { return mReadBytes; }
+
+    private:
+        std::filesystem::path mPath;
+        mutable std::fstream mStream;
+        mutable std::mutex mMutex;
+        uint64_t mSize = 0;
+        mutable uint64_t mReadBytes = 0;
+    };
+}
@@ -47,6 +47,12 @@ namespace Falcor
 
         // Constants.
         const float kMaxVolumeAnisotropy = 0.99f;
+
+        // Helper to check if a texture has an alpha channel, taking channel-reduced storage into account.
+        bool hasAlphaChannel(const ref<Texture>& pTexture)
+        {
+            return doesFormatHaveAlpha(pTexture->getFormat()) || pTexture->getChannelSwizzle() == Bitmap::ChannelSwizzle::GrayscaleAlpha;
+        }
     }
 
     BasicMaterial::BasicMaterial(ref<Device> pDevice, const std::string& name, MaterialType type)
@@ -77,7 +83,7 @@ namespace Falcor
 
         if (auto pTexture = getBaseColorTexture())
         {
-            bool hasAlpha = isAlphaSupported() && doesFormatHaveAlpha(pTexture->getFormat());
+            bool hasAlpha = isAlphaSupported() && hasAlphaChannel(pTexture);
             bool alphaConst = mIsTexturedAlphaConstant && hasAlpha;
             bool colorConst = mIsTexturedBaseColorConstant;
 
@@ -331,7 +337,7 @@ namespace Falcor
             bool previouslyOpaque = isOpaque();
 
             auto pBaseColor = getBaseColorTexture();
-            bool hasAlpha = isAlphaSupported() && pBaseColor && doesFormatHaveAlpha(pBaseColor->getFormat());
+            bool hasAlpha = isAlphaSupported() && pBaseColor && hasAlphaChannel(pBaseColor);
             bool isColorConstant = texInfo.isConstant(TextureChannelFlags::RGB);
             bool isAlphaConstant = texInfo.isConstant(TextureChannelFlags::Alpha);
 
@@ -620,7 +626,7 @@ namespace Falcor
         }
 
         // Set alpha range to the constant alpha value if non-textured.
-        bool hasAlpha = getBaseColorTexture() && doesFormatHaveAlpha(getBaseColorTexture()->getFormat());
+        bool hasAlpha = getBaseColorTexture() && hasAlphaChannel(getBaseColorTexture());
         float alpha = ((float4)mData.baseColor).a;
         if (!hasAlpha) mAlphaRange = float2(alpha);
 
@@ -47,6 +47,10 @@ namespace Falcor
         static_assert(static_cast<uint32_t>(AlphaMode::Count) <= (1u << MaterialHeader::kAlphaModeBits), "AlphaMode bit count exceeds the maximum");
         static_assert(static_cast<uint32_t>(LobeType::All) < (1u << MaterialHeader::kLobeTypeBits), "LobeType bit count exceeds the maximum");
         static_assert(static_cast<uint32_t>(TextureHandle::Mode::Count) <= (1u << TextureHandle::kModeBits), "TextureHandle::Mode bit count exceeds the maximum");
+        static_assert(static_cast<uint32_t>(TextureHandle::Swizzle::Count) <= (1u << TextureHandle::kSwizzleBits), "TextureHandle::Swizzle bit count exceeds the maximum");
+        static_assert(TextureHandle::kSwizzleOffset + TextureHandle::kSwizzleBits <= 32, "TextureHandle bit count exceeds the maximum");
+        static_assert(static_cast<uint32_t>(TextureHandle::Swizzle::Grayscale) == static_cast<uint32_t>(Bitmap::ChannelSwizzle::Grayscale));
+        static_assert(static_cast<uint32_t>(TextureHandle::Swizzle::GrayscaleAlpha) == static_cast<uint32_t>(Bitmap::ChannelSwizzle::GrayscaleAlpha));
         static_assert(MaterialHeader::kTotalHeaderBitsX <= 32, "MaterialHeader bit count x exceeds the maximum");
         static_assert(MaterialHeader::kTotalHeaderBitsY <= 32, "MaterialHeader bit count y exceeds the maximum");
         static_assert(MaterialHeader::kTotalHeaderBitsZ <= 32, "MaterialHeader bit count z exceeds the maximum");
@@ -266,11 +270,13 @@ namespace Falcor
             auto h = pOwner->getTextureManager().addTexture(pTexture);
             FALCOR_ASSERT(h);
             handle = h.toGpuHandle();
+            handle.setSwizzle(TextureHandle::Swizzle(pTexture->getChannelSwizzle()));
         }
         else
         {
             handle.setMode(TextureHandle::Mode::Uniform);
             handle.setUdimEnabled(false);
+            handle.setSwizzle(TextureHandle::Swizzle::Identity);
         }
         FALCOR_ASSERT(!handle.getUdimEnabled());
 
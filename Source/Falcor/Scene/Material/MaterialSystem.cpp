@@ -31,6 +31,7 @@
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
 #include "MaterialTypeRegistry.h"
+#include <cstring>
 #include <numeric>
 
 namespace Falcor
@@ -47,6 +48,30 @@ namespace Falcor
         const size_t kMaxSamplerCount = 1ull << MaterialHeader::kSamplerIDBits;
         const size_t kMaxTextureCount = 1ull << TextureHandle::kTextureIDBits;
         const size_t kMaxBufferCountPerMaterial = 1; // This is a conservative estimation of how many buffer descriptors to allocate per material. Most materials don't use any auxiliary data buffers.
+        const uint32_t kMaxMaterialUploadGap = 64; // Maximum number of unmodified materials between two modified ones that are uploaded together.
+
+        // Helper to expand the analysis result of a channel-reduced texture to the RGBA values seen when sampling it.
+        TextureAnalyzer::Result applyChannelSwizzle(const TextureAnalyzer::Result& result, Bitmap::ChannelSwizzle swizzle)
+        {
+            if (swizzle == Bitmap::ChannelSwizzle::Identity) return result;
+
+            // Source channel for each of RGBA, or -1 for a constant one.
+            const int srcChannel[4] = { 0, 0, 0, swizzle == Bitmap::ChannelSwizzle::GrayscaleAlpha ? 1 : -1 };
+
+            TextureAnalyzer::Result swizzled = result;
+            swizzled.mask &= ~0xfffffu;
+            for (int i = 0; i < 4; i++)
+            {
+                int c = srcChannel[i];
+                uint32_t varying = c >= 0 ? (result.mask >> c) & 1 : 0;
+                uint32_t range = c >= 0 ? (result.mask >> (4 + 4 * c)) & 0xf : (uint32_t)TextureAnalyzer::Result::RangeFlags::Pos;
+                swizzled.mask |= (varying << i) | (range << (4 + 4 * i));
+                swizzled.value[i] = c >= 0 ? result.value[c] : 1.f;
+                swizzled.minValue[i] = c >= 0 ? result.minValue[c] : 1.f;
+                swizzled.maxValue[i] = c >= 0 ? result.maxValue[c] : 1.f;
+            }
+            return swizzled;
+        }
 
         // Helper to check if a material is a standard material using the SpecGloss shading model.
         // We keep track of these as an optimization because most scenes do not use this shading model.
@@ -411,7 +436,8 @@ namespace Falcor
 
         for (size_t i = 0; i < textures.size(); i++)
         {
-            materialSlots[i].first->optimizeTexture(materialSlots[i].second, results[i], stats);
+            auto result = applyChannelSwizzle(results[i], textures[i]->getChannelSwizzle());
+            materialSlots[i].first->optimizeTexture(materialSlots[i].second, result, stats);
         }
 
         pResultsStaging->unmap();
@@ -431,6 +457,19 @@ namespace Falcor
         if (stats.constantNormalMaps > 0) logWarning("Materials have {} normal maps of constant value. Please update the asset to optimize performance.", stats.constantNormalMaps);
     }
 
+    size_t MaterialSystem::packTextureAtlases(const TextureAtlasSettings& settings)
+    {
+        size_t packedCount = mpTextureManager->packTextureAtlases(settings);
+        if (packedCount == 0) return 0;
+
+        // Texture handles have changed. Force all materials to fetch their new handles
+        // and trigger a metadata update so that the shader defines are refreshed.
+        for (auto& pMaterial : mMaterials) pMaterial->markUpdates(Material::UpdateFlags::ResourcesChanged);
+        mMaterialsChanged = true;
+
+        return packedCount;
+    }
+
     Material::UpdateFlags MaterialSystem::update(bool forceUpdate)
     {
         // If materials were added/removed since last update, we update all metadata
@@ -483,6 +522,10 @@ namespace Falcor
         updateFlags |= mMaterialUpdates;
         mMaterialUpdates = Material::UpdateFlags::None;
 
+        // Apply the texture memory budget. Textures whose resident mip levels changed have new views that need rebinding.
+        if (mpTextureManager->updateResidency())
+            updateFlags |= Material::UpdateFlags::ResourcesChanged;
+
         // Create parameter block if needed.
         if (!mpMaterialsBlock)
         {
@@ -507,6 +550,9 @@ namespace Falcor
             }
         }
 
+        // Upload the modified material data. This also includes edits made in the UI since the last update.
+        flushMaterialData();
+
         auto blockVar = mpMaterialsBlock->getRootVar();
 
         // Update samplers.
@@ -524,8 +570,9 @@ namespace Falcor
         if (forceUpdate || is_set(updateFlags, Material::UpdateFlags::ResourcesChanged))
         {
             FALCOR_ASSERT(!mMaterialsChanged);
+            // Only descriptors that changed are rewritten, unless the parameter block was recreated.
             mpTextureManager->bindShaderData(blockVar[kMaterialTexturesName], mTextureDescCount,
-                blockVar["udimIndirection"]);
+                blockVar["udimIndirection"], blockVar["atlasEntries"], !forceUpdate);
         }
 
         // Update buffers.
@@ -652,6 +699,7 @@ namespace Falcor
         defines.add("MATERIAL_SYSTEM_BUFFER_DESC_COUNT", std::to_string(mBufferDescCount));
         defines.add("MATERIAL_SYSTEM_TEXTURE_3D_DESC_COUNT", std::to_string(mTexture3DDescCount));
         defines.add("MATERIAL_SYSTEM_UDIM_INDIRECTION_ENABLED", mpTextureManager->getUdimIndirectionCount() > 0 ? "1" : "0");
+        defines.add("MATERIAL_SYSTEM_ATLAS_ENABLED", mpTextureManager->getAtlasEntryCount() > 0 ? "1" : "0");
         defines.add("MATERIAL_SYSTEM_HAS_SPEC_GLOSS_MATERIALS", mHasSpecGlossStandardMaterial ? "1" : "0");
         defines.add("FALCOR_MATERIAL_INSTANCE_SIZE", std::to_string(materialInstanceByteSize));
 
@@ -744,6 +792,10 @@ namespace Falcor
         {
             mpMaterialDataBuffer = mpDevice->createStructuredBuffer(blockVar[kMaterialDataName], (uint32_t)mMaterials.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, nullptr, false);
             mpMaterialDataBuffer->setName("MaterialSystem::mpMaterialDataBuffer");
+
+            // The new buffer is uninitialized, so the whole mirror has to be uploaded.
+            mMaterialData.resize(mMaterials.size());
+            mDirtyMaterialData.markDirty(0, (uint32_t)mMaterials.size());
         }
 
         // Bind resources to parameter block.
@@ -757,9 +809,29 @@ namespace Falcor
         const auto& pMaterial = mMaterials[materialID];
         FALCOR_ASSERT(pMaterial);
 
-        // TODO: On initial upload of materials, we could improve this by not having separate calls to setElement()
-        // but instead prepare a buffer containing all data.
+        // Update the CPU mirror. The data is uploaded in flushMaterialData(), batched with other modified materials.
+        // Materials often report changes that leave the data blob unchanged, these are skipped.
+        if (mMaterialData.size() < mMaterials.size()) mMaterialData.resize(mMaterials.size());
+        MaterialDataBlob blob = pMaterial->getDataBlob();
+        if (std::memcmp(&mMaterialData[materialID], &blob, sizeof(blob)) != 0)
+        {
+            mMaterialData[materialID] = blob;
+            mDirtyMaterialData.markDirty(materialID);
+        }
+    }
+
+    void MaterialSystem::flushMaterialData()
+    {
+        if (!mDirtyMaterialData.isDirty()) return;
         FALCOR_ASSERT(mpMaterialDataBuffer);
-        mpMaterialDataBuffer->setElement(materialID, pMaterial->getDataBlob());
+
+        // Upload coalesced ranges of modified materials. Small gaps of unmodified materials are uploaded
+        // along with them to reduce the number of uploads, typically to a single one per update.
+        for (const auto& range : mDirtyMaterialData.getRanges(kMaxMaterialUploadGap))
+        {
+            FALCOR_ASSERT(range.end <= mMaterialData.size());
+            mpMaterialDataBuffer->setBlob(&mMaterialData[range.begin], range.begin * sizeof(MaterialDataBlob), range.getCount() * sizeof(MaterialDataBlob));
+        }
+        mDirtyMaterialData.clear();
     }
 }
@@ -35,6 +35,7 @@
 #include "Core/Program/DefineList.h"
 #include "Core/Program/Program.h"
 #include "Utils/Image/TextureManager.h"
+#include "Utils/DirtyRangeTracker.h"
 #include "Utils/UI/Gui.h"
 #include <memory>
 #include <vector>
@@ -242,6 +243,14 @@ namespace Falcor
         */
         void optimizeMaterials();
 
+        /** Pack small material textures into shared texture atlases.
+            Packed textures are replaced by atlas handles that are resolved at runtime, similar to UDIMs.
+            This reduces the number of texture descriptors and binds used by scenes with many small textures.
+            \param[in] settings Atlas packing settings.
+            \return The number of textures packed into atlases.
+        */
+        size_t packTextureAtlases(const TextureAtlasSettings& settings = {});
+
         /** Get stats for the material system. This can be a slow operation.
         */
         MaterialStats getStats() const;
@@ -256,6 +265,7 @@ namespace Falcor
         void updateUI();
         void createParameterBlock();
         void uploadMaterial(const uint32_t materialID);
+        void flushMaterialData();
 
         ref<Device> mpDevice;
 
@@ -289,6 +299,8 @@ namespace Falcor
         ref<Fence> mpFence;
         ref<ParameterBlock> mpMaterialsBlock;                       ///< Parameter block for binding all material resources.
         ref<Buffer> mpMaterialDataBuffer;                           ///< GPU buffer holding all material data.
+        std::vector<MaterialDataBlob> mMaterialData;                ///< CPU mirror of the material data buffer.
+        DirtyRangeTracker mDirtyMaterialData;                       ///< Elements of the mirror that have not been uploaded yet.
         ref<Sampler> mpDefaultTextureSampler;                       ///< Default texture sampler to use for all materials.
         std::vector<ref<Sampler>> mTextureSamplers;                 ///< Texture sampler states. These are indexed by ID in the materials.
         std::vector<ref<Buffer>> mBuffers;                          ///< Buffers used by the materials. These are indexed by ID in the materials.
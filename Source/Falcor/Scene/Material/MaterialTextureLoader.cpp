@@ -52,6 +52,11 @@ namespace Falcor
 
         bool srgb = mUseSrgb && pMaterial->getTextureSlotInfo(slot).srgb;
 
+        // Store grayscale and two-channel textures in reduced formats. Sampling through the material system expands them again.
+        // This is lossless, and sRGB textures are left unchanged as the reduced 8-bit formats have no sRGB variant.
+        // Uncompressed 8-bit KTX2 textures are block compressed on load.
+        Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::ReduceChannels | Bitmap::ImportFlags::BlockCompress;
+
         // Request texture to be loaded.
         auto handle = mTextureManager.loadTexture(
             path,
@@ -59,7 +64,7 @@ namespace Falcor
             srgb,
             ResourceBindFlags::ShaderResource,
             true /*async*/,
-            Bitmap::ImportFlags::None,
+            importFlags,
             nullptr /*search dirs*/,
             nullptr /*load count*/,
             pMaterial.get()
@@ -0,0 +1,428 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "OpacityMicromapBaker.h"
+#include "Core/Error.h"
+#include "Core/API/Texture.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Math/FNVHash.h"
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <limits>
+
+namespace Falcor
+{
+    namespace
+    {
+        // Number of triangles baked per parallel batch. This bounds the memory used for unpacked micromaps.
+        const uint32_t kBatchSize = 16384;
+
+        uint32_t prefixEor(uint32_t x)
+        {
+            x ^= (x >> 1) & 0x7fff7fff;
+            x ^= (x >> 2) & 0x3fff3fff;
+            x ^= (x >> 4) & 0x0fff0fff;
+            x ^= (x >> 8) & 0x00ff00ff;
+            return x;
+        }
+
+        // Interleave the low 16 bits of x (even bits) with the low 16 bits of y (odd bits).
+        uint32_t interleaveBits(uint32_t x, uint32_t y)
+        {
+            x = (x & 0xffff) | (y << 16);
+            x = ((x >> 8) & 0x0000ff00) | ((x << 8) & 0x00ff0000) | (x & 0xff0000ff);
+            x = ((x >> 4) & 0x00f000f0) | ((x << 4) & 0x0f000f00) | (x & 0xf00ff00f);
+            x = ((x >> 2) & 0x0c0c0c0c) | ((x << 2) & 0x30303030) | (x & 0xc3c3c3c3);
+            x = ((x >> 1) & 0x22222222) | ((x << 1) & 0x44444444) | (x & 0x99999999);
+            return x;
+        }
+
+        size_t getMicromapByteSize(uint32_t level)
+        {
+            return std::max<size_t>(1, (size_t(1) << (2 * level)) / 4);
+        }
+
+        // Conservative overlap test between a 2D triangle and an axis-aligned square, using separating axes.
+        bool overlapsSquare(const float2 p[3], float2 center, float halfSize)
+        {
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                float2 e = p[(i + 1) % 3] - p[i];
+                float2 n = float2(-e.y, e.x);
+                float r = halfSize * (std::abs(n.x) + std::abs(n.y));
+                float c = dot(n, center);
+                float d0 = dot(n, p[0]), d1 = dot(n, p[1]), d2 = dot(n, p[2]);
+                if (std::max({ d0, d1, d2 }) < c - r || std::min({ d0, d1, d2 }) > c + r) return false;
+            }
+            return true;
+        }
+
+        class TriangleBaker
+        {
+        public:
+            TriangleBaker(const OpacityMicromapBaker::AlphaMap& alphaMap, const OpacityMicromapSettings& settings)
+                : mAlphaMap(alphaMap)
+                , mSettings(settings)
+                , mSize((float)alphaMap.getWidth(), (float)alphaMap.getHeight())
+                , mThreshold((uint32_t)std::ceil(std::clamp(settings.alphaThreshold, 0.f, 1.f) * 255.f))
+            {}
+
+            uint32_t selectLevel(float2 uv0, float2 uv1, float2 uv2) const
+            {
+                if (mSettings.texelsPerMicroTriangle <= 0.f) return mSettings.maxSubdivisionLevel;
+
+                float2 e1 = (uv1 - uv0) * mSize;
+                float2 e2 = (uv2 - uv0) * mSize;
+                float texelArea = 0.5f * std::abs(e1.x * e2.y - e1.y * e2.x);
+                uint32_t level = 0;
+                while (level < mSettings.maxSubdivisionLevel && texelArea > mSettings.texelsPerMicroTriangle)
+                {
+                    texelArea *= 0.25f;
+                    level++;
+                }
+                return level;
+            }
+
+            /** Bake the states of all micro-triangles of a triangle.
+                \param[out] states State per micro-triangle in bird curve order.
+            */
+            void bake(float2 uv0, float2 uv1, float2 uv2, uint32_t level, std::vector<OpacityState>& states) const
+            {
+                const uint32_t n = 1u << level;
+                states.resize(size_t(n) * n);
+
+                // Micro-triangle vertices are at the discrete barycentrics (u, v, w) scaled by 1/n, in texel space.
+                float2 t0 = uv0 * mSize, du = (uv1 - uv0) * mSize / (float)n, dv = (uv2 - uv0) * mSize / (float)n;
+                auto vertex = [&](uint32_t u, uint32_t v) { return t0 + du * (float)u + dv * (float)v; };
+
+                for (uint32_t u = 0; u < n; u++)
+                {
+                    for (uint32_t v = 0; u + v < n; v++)
+                    {
+                        float2 upright[3] = { vertex(u + 1, v), vertex(u, v + 1), vertex(u, v) };
+                        states[OpacityMicromapBaker::getMicroTriangleIndex(u, v, n - 1 - u - v, level)] = classify(upright);
+
+                        if (u + v + 2 <= n)
+                        {
+                            float2 inverted[3] = { vertex(u + 1, v + 1), vertex(u + 1, v), vertex(u, v + 1) };
+                            states[OpacityMicromapBaker::getMicroTriangleIndex(u, v, n - 2 - u - v, level)] = classify(inverted);
+                        }
+                    }
+                }
+            }
+
+        private:
+            bool isOpaque(int x, int y) const { return mAlphaMap.getAlpha(x, y) >= mThreshold; }
+
+            // Maps a texel coordinate into the texture. Returns -1 for texels outside the texture with border addressing.
+            int address(int i, int size) const
+            {
+                switch (mSettings.addressingMode)
+                {
+                case TextureAddressingMode::Wrap:
+                    return ((i % size) + size) % size;
+                case TextureAddressingMode::Mirror:
+                {
+                    int j = ((i % (2 * size)) + 2 * size) % (2 * size);
+                    return j < size ? j : 2 * size - 1 - j;
+                }
+                case TextureAddressingMode::Clamp:
+                    return std::clamp(i, 0, size - 1);
+                case TextureAddressingMode::MirrorOnce:
+                    return std::clamp(i < 0 ? -1 - i : i, 0, size - 1);
+                default:
+                    return i >= 0 && i < size ? i : -1;
+                }
+            }
+
+            OpacityState classify(const float2 p[3]) const
+            {
+                const int width = (int)mAlphaMap.getWidth(), height = (int)mAlphaMap.getHeight();
+                const float r = mSettings.filterRadius;
+
+                // A sample at position x touches the texels whose centers are within the filter radius.
+                float2 pMin = min(min(p[0], p[1]), p[2]);
+                float2 pMax = max(max(p[0], p[1]), p[2]);
+                int x0 = (int)std::floor(pMin.x - 0.5f - r), x1 = (int)std::ceil(pMax.x - 0.5f + r);
+                int y0 = (int)std::floor(pMin.y - 0.5f - r), y1 = (int)std::ceil(pMax.y - 0.5f + r);
+
+                bool anyOpaque = false, anyTransparent = false;
+
+                for (int y = y0; y <= y1 && !(anyOpaque && anyTransparent); y++)
+                {
+                    for (int x = x0; x <= x1 && !(anyOpaque && anyTransparent); x++)
+                    {
+                        if (!overlapsSquare(p, float2(x + 0.5f, y + 0.5f), r)) continue;
+                        int tx = address(x, width), ty = address(y, height);
+                        if (tx < 0 || ty < 0) anyOpaque = anyTransparent = true;
+                        else if (isOpaque(tx, ty)) anyOpaque = true;
+                        else anyTransparent = true;
+                    }
+                }
+
+                if (anyOpaque && anyTransparent)
+                {
+                    // Pick the unknown state from the texel at the centroid, for use when the any-hit shader is skipped.
+                    float2 c = (p[0] + p[1] + p[2]) / 3.f;
+                    int x = address((int)std::floor(c.x), width), y = address((int)std::floor(c.y), height);
+                    return x >= 0 && y >= 0 && isOpaque(x, y) ? OpacityState::UnknownOpaque : OpacityState::UnknownTransparent;
+                }
+                return anyOpaque ? OpacityState::Opaque : OpacityState::Transparent;
+            }
+
+            const OpacityMicromapBaker::AlphaMap& mAlphaMap;
+            const OpacityMicromapSettings& mSettings;
+            float2 mSize;
+            uint32_t mThreshold;
+        };
+
+        struct BakedTriangle
+        {
+            uint32_t level = 0;
+            bool isUniform = true;
+            uint32_t unknownCount = 0;
+            std::vector<uint8_t> data;
+        };
+    }
+
+    OpacityMicromapBaker::AlphaMap::AlphaMap(uint32_t width, uint32_t height, std::vector<uint8_t> alpha)
+        : mWidth(width)
+        , mHeight(height)
+        , mAlpha(std::move(alpha))
+    {
+        FALCOR_CHECK(width > 0 && height > 0, "Alpha map must not be empty.");
+        FALCOR_CHECK(mAlpha.size() == size_t(width) * height, "Alpha map size ({}) does not match its dimensions ({}x{}).", mAlpha.size(), width, height);
+
+        FNVHash64 hash;
+        hash.insert(&mWidth, sizeof(mWidth));
+        hash.insert(&mHeight, sizeof(mHeight));
+        hash.insert(mAlpha.data(), mAlpha.size());
+        mHash = hash.get();
+    }
+
+    OpacityMicromapBaker::AlphaMap OpacityMicromapBaker::AlphaMap::createFromTexture(const ref<Texture>& pTexture)
+    {
+        FALCOR_CHECK(pTexture, "'pTexture' must not be null.");
+
+        // Find the byte offset of the alpha channel within a texel.
+        uint32_t texelSize = 0, alphaOffset = 0;
+        switch (pTexture->getFormat())
+        {
+        case ResourceFormat::RGBA8Unorm:
+        case ResourceFormat::RGBA8UnormSrgb:
+        case ResourceFormat::BGRA8Unorm:
+        case ResourceFormat::BGRA8UnormSrgb:
+            texelSize = 4;
+            alphaOffset = 3;
+            break;
+        case ResourceFormat::RG8Unorm:
+            FALCOR_CHECK(pTexture->getChannelSwizzle() == Bitmap::ChannelSwizzle::GrayscaleAlpha, "Two-channel texture '{}' has no alpha channel.", pTexture->getSourcePath());
+            texelSize = 2;
+            alphaOffset = 1;
+            break;
+        default:
+            FALCOR_THROW("Unsupported format {} for opacity micromap baking of texture '{}'.", to_string(pTexture->getFormat()), pTexture->getSourcePath());
+        }
+
+        uint32_t width = pTexture->getWidth(), height = pTexture->getHeight();
+        std::vector<uint8_t> texels(size_t(width) * height * texelSize);
+        pTexture->getSubresourceBlob(pTexture->getSubresourceIndex(0, 0), texels.data(), texels.size());
+
+        std::vector<uint8_t> alpha(size_t(width) * height);
+        for (size_t i = 0; i < alpha.size(); i++) alpha[i] = texels[i * texelSize + alphaOffset];
+        return AlphaMap(width, height, std::move(alpha));
+    }
+
+    OpacityState OpacityMicromapBaker::Result::getState(uint32_t triangleIndex, uint32_t microTriangleIndex) const
+    {
+        FALCOR_ASSERT(triangleIndex < indices.size());
+        int32_t index = indices[triangleIndex];
+        if (index < 0) return OpacityState(-index - 1);
+
+        const Micromap& micromap = micromaps[index];
+        FALCOR_ASSERT(microTriangleIndex < (1u << (2 * micromap.subdivisionLevel)));
+        return OpacityState((data[micromap.byteOffset + microTriangleIndex / 4] >> (2 * (microTriangleIndex % 4))) & 3);
+    }
+
+    OpacityMicromapBaker::OpacityMicromapBaker(const OpacityMicromapSettings& settings)
+        : mSettings(settings)
+    {
+        FALCOR_CHECK(settings.maxSubdivisionLevel <= kMaxSubdivisionLevel, "'maxSubdivisionLevel' ({}) must be at most {}.", settings.maxSubdivisionLevel, kMaxSubdivisionLevel);
+        FALCOR_CHECK(settings.filterRadius >= 0.f, "'filterRadius' must not be negative.");
+    }
+
+    std::shared_ptr<const OpacityMicromapBaker::Result> OpacityMicromapBaker::bake(const AlphaMap& alphaMap, fstd::span<const float2> texCrds, fstd::span<const uint32_t> indices)
+    {
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count ({}) must be a multiple of 3.", indices.size());
+
+        FNVHash64 hash;
+        uint64_t alphaHash = alphaMap.getHash();
+        hash.insert(&alphaHash, sizeof(alphaHash));
+        hash.insert(&mSettings, sizeof(mSettings));
+        hash.insert(texCrds.data(), texCrds.size() * sizeof(float2));
+        hash.insert(indices.data(), indices.size() * sizeof(uint32_t));
+        uint64_t key = hash.get();
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            if (auto it = mCache.find(key); it != mCache.end()) return it->second;
+        }
+
+        // Bake outside the lock so that different meshes can be baked concurrently.
+        auto pResult = bakeMesh(alphaMap, texCrds, indices);
+
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mCache.emplace(key, pResult).first->second;
+    }
+
+    std::shared_ptr<const OpacityMicromapBaker::Result> OpacityMicromapBaker::bakeMesh(const AlphaMap& alphaMap, fstd::span<const float2> texCrds, fstd::span<const uint32_t> indices) const
+    {
+        const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+        for (uint32_t index : indices) FALCOR_CHECK(index < texCrds.size(), "Vertex index ({}) is out of bounds.", index);
+
+        auto pResult = std::make_shared<Result>();
+        pResult->indices.resize(triangleCount);
+        pResult->triangleOpacity.resize(triangleCount);
+
+        TriangleBaker triangleBaker(alphaMap, mSettings);
+        std::unordered_map<uint64_t, std::vector<int32_t>> micromapsByHash;
+        std::vector<BakedTriangle> batch(std::min(triangleCount, kBatchSize));
+
+        for (uint32_t batchStart = 0; batchStart < triangleCount; batchStart += kBatchSize)
+        {
+            uint32_t batchCount = std::min(kBatchSize, triangleCount - batchStart);
+
+            NumericRange<uint32_t> range(0, batchCount);
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t i)
+            {
+                uint32_t triangleIndex = batchStart + i;
+                float2 uv0 = texCrds[indices[3 * triangleIndex + 0]];
+                float2 uv1 = texCrds[indices[3 * triangleIndex + 1]];
+                float2 uv2 = texCrds[indices[3 * triangleIndex + 2]];
+
+                BakedTriangle& baked = batch[i];
+                baked.level = triangleBaker.selectLevel(uv0, uv1, uv2);
+
+                thread_local std::vector<OpacityState> states;
+                triangleBaker.bake(uv0, uv1, uv2, baked.level, states);
+
+                baked.isUniform = true;
+                baked.unknownCount = 0;
+                baked.data.assign(getMicromapByteSize(baked.level), 0);
+                for (size_t j = 0; j < states.size(); j++)
+                {
+                    if (states[j] != states[0]) baked.isUniform = false;
+                    if (states[j] == OpacityState::UnknownOpaque || states[j] == OpacityState::UnknownTransparent) baked.unknownCount++;
+                    baked.data[j / 4] |= (uint8_t)states[j] << (2 * (j % 4));
+                }
+            });
+
+            // Assign special indices to uniform triangles and share identical micromaps.
+            for (uint32_t i = 0; i < batchCount; i++)
+            {
+                uint32_t triangleIndex = batchStart + i;
+                const BakedTriangle& baked = batch[i];
+                pResult->microTriangleCount += 1ull << (2 * baked.level);
+                pResult->unknownMicroTriangleCount += baked.unknownCount;
+
+                OpacityState firstState = OpacityState(baked.data[0] & 3);
+                if (baked.isUniform && firstState == OpacityState::Opaque) pResult->triangleOpacity[triangleIndex] = TriangleOpacity::Opaque;
+                else if (baked.isUniform && firstState == OpacityState::Transparent) pResult->triangleOpacity[triangleIndex] = TriangleOpacity::Transparent;
+                else pResult->triangleOpacity[triangleIndex] = TriangleOpacity::Unknown;
+
+                if (baked.isUniform)
+                {
+                    pResult->indices[triangleIndex] = -(int32_t)firstState - 1;
+                    continue;
+                }
+
+                uint64_t dataHash = fnvHashArray64(baked.data.data(), baked.data.size()) ^ baked.level;
+                auto& candidates = micromapsByHash[dataHash];
+                auto it = std::find_if(candidates.begin(), candidates.end(), [&](int32_t index)
+                {
+                    const Micromap& micromap = pResult->micromaps[index];
+                    return micromap.subdivisionLevel == baked.level && std::equal(baked.data.begin(), baked.data.end(), pResult->data.begin() + micromap.byteOffset);
+                });
+
+                if (it != candidates.end())
+                {
+                    pResult->indices[triangleIndex] = *it;
+                }
+                else
+                {
+                    FALCOR_CHECK(pResult->data.size() + baked.data.size() <= std::numeric_limits<uint32_t>::max(), "Opacity micromap data exceeds 4GB.");
+                    int32_t index = (int32_t)pResult->micromaps.size();
+                    pResult->micromaps.push_back({ (uint32_t)pResult->data.size(), baked.level });
+                    pResult->data.insert(pResult->data.end(), baked.data.begin(), baked.data.end());
+                    candidates.push_back(index);
+                    pResult->indices[triangleIndex] = index;
+                }
+            }
+        }
+
+        return pResult;
+    }
+
+    size_t OpacityMicromapBaker::getCacheSize() const
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        return mCache.size();
+    }
+
+    void OpacityMicromapBaker::clearCache()
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mCache.clear();
+    }
+
+    uint32_t OpacityMicromapBaker::getMicroTriangleIndex(uint32_t u, uint32_t v, uint32_t w, uint32_t level)
+    {
+        FALCOR_ASSERT(level <= kMaxSubdivisionLevel);
+        const uint32_t coordMask = (1u << level) - 1;
+
+        uint32_t b0 = ~(u ^ w) & coordMask;
+        uint32_t t = (u ^ v) & b0;
+        uint32_t c = (((u & v & w) | (~u & ~v & ~w)) & coordMask) << 16;
+        uint32_t f = prefixEor(t | c) ^ u;
+        uint32_t b1 = (f & ~b0) | t;
+        return interleaveBits(b0, b1);
+    }
+
+    uint32_t OpacityMicromapBaker::getMicroTriangleIndex(float2 barycentrics, uint32_t level)
+    {
+        const uint32_t n = 1u << level;
+        float su = std::clamp(barycentrics.x, 0.f, 1.f) * n;
+        float sv = std::clamp(barycentrics.y, 0.f, 1.f) * n;
+        uint32_t u = std::min((uint32_t)su, n - 1);
+        uint32_t v = std::min((uint32_t)sv, n - 1 - u);
+
+        // The point is in the inverted micro-triangle of the cell if the fractional parts sum to more than one.
+        bool isInverted = (su - u) + (sv - v) > 1.f && u + v + 2 <= n;
+        return getMicroTriangleIndex(u, v, n - (isInverted ? 2 : 1) - u - v, level);
+    }
+}
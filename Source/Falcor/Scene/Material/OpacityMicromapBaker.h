@@ -0,0 +1,199 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Object.h"
+#include "Core/API/Sampler.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+    class Texture;
+
+    /** Opacity state of a micro-triangle.
+        The values match the 4-state opacity micromap format in DXR and Vulkan.
+    */
+    enum class OpacityState : uint8_t
+    {
+        Transparent = 0,
+        Opaque = 1,
+        UnknownTransparent = 2, ///< Partially covered. Resolved by the any-hit shader, or treated as transparent if forced to 2-state.
+        UnknownOpaque = 3,      ///< Partially covered. Resolved by the any-hit shader, or treated as opaque if forced to 2-state.
+    };
+
+    /** Opacity classification of a whole triangle.
+    */
+    enum class TriangleOpacity : uint8_t
+    {
+        Opaque,         ///< All micro-triangles are opaque. The triangle never needs the any-hit shader.
+        Transparent,    ///< All micro-triangles are transparent. The triangle can never be hit.
+        Unknown,        ///< The triangle is partially covered and needs its micromap or the any-hit shader.
+    };
+
+    /** Opacity micromap bake settings.
+    */
+    struct OpacityMicromapSettings
+    {
+        float alphaThreshold = 0.5f;        ///< Alpha threshold. Texels with lower alpha are transparent (see evalBasicAlphaTest()).
+        uint32_t maxSubdivisionLevel = 6;   ///< Max subdivision level. Must be at most OpacityMicromapBaker::kMaxSubdivisionLevel.
+        float texelsPerMicroTriangle = 4.f; ///< Target number of texels per micro-triangle, used to pick the subdivision level per triangle. Zero always uses the max level.
+        float filterRadius = 1.f;           ///< Radius of the texture filter footprint in texels. The default covers bilinear filtering.
+        TextureAddressingMode addressingMode = TextureAddressingMode::Wrap; ///< Addressing mode of the material sampler. With border addressing, all texels outside the texture are unknown.
+    };
+
+    /** Bakes 4-state opacity micromaps for alpha-tested triangles on the CPU.
+
+        Each triangle is uniformly subdivided into 4^level micro-triangles in its barycentric domain,
+        enumerated in the bird curve order used by DXR and Vulkan. Each micro-triangle is mapped into
+        texture space and classified conservatively against all texels that the filter footprint of
+        any sample inside it can touch: opaque if all of them pass the alpha test, transparent if
+        none of them pass, and unknown otherwise. The alpha is taken from mip 0 and texture
+        coordinates outside [0,1] follow the addressing mode of the sampler.
+
+        Triangles are baked in parallel. Triangles with a uniform state are assigned one of the
+        special micromap indices instead of a micromap, and identical micromaps are shared.
+        The results are cached per (mesh, alpha map) pair, keyed by a hash of their contents.
+    */
+    class FALCOR_API OpacityMicromapBaker
+    {
+    public:
+        static constexpr uint32_t kMaxSubdivisionLevel = 12;    ///< Max subdivision level of 4-state micromaps.
+
+        /** Special micromap indices. These are the same in DXR and Vulkan.
+        */
+        static constexpr int32_t kFullyTransparent = -1;
+        static constexpr int32_t kFullyOpaque = -2;
+        static constexpr int32_t kFullyUnknownTransparent = -3;
+        static constexpr int32_t kFullyUnknownOpaque = -4;
+
+        /** Alpha values of a texture.
+        */
+        class FALCOR_API AlphaMap
+        {
+        public:
+            /** Create an alpha map.
+                \param[in] width Width in texels.
+                \param[in] height Height in texels.
+                \param[in] alpha Alpha values in row-major order, where 255 is fully opaque.
+            */
+            AlphaMap(uint32_t width, uint32_t height, std::vector<uint8_t> alpha);
+
+            /** Create an alpha map from mip 0 of a texture. This reads the texture back from the GPU.
+                Supported are 8-bit RGBA and BGRA formats, and two-channel textures that store grayscale and alpha.
+                \param[in] pTexture Texture with an alpha channel.
+                \return Alpha map.
+            */
+            static AlphaMap createFromTexture(const ref<Texture>& pTexture);
+
+            uint32_t getWidth() const { return mWidth; }
+            uint32_t getHeight() const { return mHeight; }
+            uint8_t getAlpha(uint32_t x, uint32_t y) const { return mAlpha[size_t(y) * mWidth + x]; }
+            uint64_t getHash() const { return mHash; }
+
+        private:
+            uint32_t mWidth;
+            uint32_t mHeight;
+            std::vector<uint8_t> mAlpha;
+            uint64_t mHash;
+        };
+
+        struct Micromap
+        {
+            uint32_t byteOffset = 0;            ///< Offset of the packed states in the data buffer.
+            uint32_t subdivisionLevel = 0;      ///< Subdivision level. The micromap has 4^subdivisionLevel micro-triangles.
+        };
+
+        struct Result
+        {
+            std::vector<int32_t> indices;                   ///< Micromap index per triangle, or one of the special indices.
+            std::vector<TriangleOpacity> triangleOpacity;   ///< Opacity classification per triangle.
+            std::vector<Micromap> micromaps;                ///< Unique micromaps.
+            std::vector<uint8_t> data;                      ///< Packed micromap states, 2 bits each in bird curve order, starting at the least significant bits.
+            uint64_t microTriangleCount = 0;                ///< Total number of micro-triangles over all triangles.
+            uint64_t unknownMicroTriangleCount = 0;         ///< Number of micro-triangles that still need the any-hit shader.
+
+            /** Get the state of a micro-triangle.
+                \param[in] triangleIndex Triangle index.
+                \param[in] microTriangleIndex Micro-triangle index in bird curve order. Ignored for triangles with a special index.
+                \return Opacity state.
+            */
+            OpacityState getState(uint32_t triangleIndex, uint32_t microTriangleIndex) const;
+        };
+
+        /** Create a baker.
+            \param[in] settings Bake settings. These apply to all bakes and are part of the cache key.
+        */
+        OpacityMicromapBaker(const OpacityMicromapSettings& settings = {});
+
+        /** Bake opacity micromaps for a triangle mesh. The result is cached.
+            \param[in] alphaMap Alpha map of the material.
+            \param[in] texCrds Vertex texture coordinates.
+            \param[in] indices Triangle list indices.
+            \return Bake result.
+        */
+        std::shared_ptr<const Result> bake(const AlphaMap& alphaMap, fstd::span<const float2> texCrds, fstd::span<const uint32_t> indices);
+
+        const OpacityMicromapSettings& getSettings() const { return mSettings; }
+
+        /** Get the number of cached results.
+        */
+        size_t getCacheSize() const;
+
+        /** Clear all cached results.
+        */
+        void clearCache();
+
+        /** Get the bird curve index of a micro-triangle from its discrete barycentrics.
+            Upright micro-triangles have u + v + w == 2^level - 1 and inverted ones have u + v + w == 2^level - 2.
+            \param[in] u, v, w Discrete barycentrics of the micro-triangle, where u and v are the weights of the second and third vertex.
+            \param[in] level Subdivision level.
+            \return Micro-triangle index.
+        */
+        static uint32_t getMicroTriangleIndex(uint32_t u, uint32_t v, uint32_t w, uint32_t level);
+
+        /** Get the bird curve index of the micro-triangle containing a point.
+            \param[in] barycentrics Barycentrics of the point, i.e., the weights of the second and third vertex as reported by ray tracing hits.
+            \param[in] level Subdivision level.
+            \return Micro-triangle index.
+        */
+        static uint32_t getMicroTriangleIndex(float2 barycentrics, uint32_t level);
+
+    private:
+        std::shared_ptr<const Result> bakeMesh(const AlphaMap& alphaMap, fstd::span<const float2> texCrds, fstd::span<const uint32_t> indices) const;
+
+        OpacityMicromapSettings mSettings;
+        mutable std::mutex mMutex;
+        std::unordered_map<uint64_t, std::shared_ptr<const Result>> mCache;
+    };
+}
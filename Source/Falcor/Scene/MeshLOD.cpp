@@ -0,0 +1,100 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshLOD.h"
+#include "MeshSimplifier.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Falcor
+{
+    MeshLODChain generateMeshLODChain(fstd::span<const float3> positions, fstd::span<const uint32_t> indices, const MeshLODSettings& settings)
+    {
+        FALCOR_CHECK(settings.reductionRatio > 0.f && settings.reductionRatio < 1.f, "Reduction ratio ({}) must be in the range (0,1).", settings.reductionRatio);
+
+        MeshLODChain chain;
+        const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+        chain.indices.emplace_back(indices.begin(), indices.end());
+        chain.levels.push_back({ triangleCount, 0.f, 0 });
+        if (settings.maxLevelCount <= 1 || triangleCount <= settings.minTriangleCount) return chain;
+
+        AABB bounds;
+        for (uint32_t i : indices) bounds.include(positions[i]);
+        const float maxError = settings.maxRelativeError * length(bounds.extent());
+
+        MeshSimplifier simplifier(positions, indices);
+        uint32_t prevCount = triangleCount;
+        while (chain.levels.size() < settings.maxLevelCount)
+        {
+            const uint32_t targetCount = std::max(settings.minTriangleCount, (uint32_t)(prevCount * settings.reductionRatio));
+            if (targetCount >= prevCount) break;
+
+            // Stop if less than half of the requested reduction was achieved.
+            const uint32_t count = simplifier.simplify(targetCount, maxError);
+            if (count > (prevCount + targetCount) / 2) break;
+
+            chain.indices.push_back(simplifier.getIndices());
+            chain.levels.push_back({ count, simplifier.getError(), 0 });
+            prevCount = count;
+        }
+
+        return chain;
+    }
+
+    MeshLODSelector::MeshLODSelector(float fovY, uint32_t viewportHeight, float maxPixelError)
+        : mPixelsPerUnit(viewportHeight / (2.f * std::tan(0.5f * fovY)))
+        , mMaxPixelError(maxPixelError)
+    {
+        FALCOR_CHECK(fovY > 0.f && fovY < (float)M_PI, "Field of view ({}) must be in the range (0,pi).", fovY);
+    }
+
+    float MeshLODSelector::getProjectedError(float error, float distance) const
+    {
+        if (error <= 0.f) return 0.f;
+        if (distance <= 0.f) return std::numeric_limits<float>::infinity();
+        return error / distance * mPixelsPerUnit;
+    }
+
+    uint32_t MeshLODSelector::selectLevel(fstd::span<const MeshLODLevel> levels, float distance, float scale) const
+    {
+        uint32_t selected = 0;
+        for (uint32_t i = 1; i < (uint32_t)levels.size(); i++)
+        {
+            if (getProjectedError(levels[i].error * scale, distance) > mMaxPixelError) break;
+            selected = i;
+        }
+        return selected;
+    }
+
+    float MeshLODSelector::getDistance(const AABB& bounds, const float3& point)
+    {
+        const float3 d = max(max(bounds.minPoint - point, point - bounds.maxPoint), float3(0.f));
+        return length(d);
+    }
+}
@@ -0,0 +1,122 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+    /** Settings for mesh LOD generation and selection.
+    */
+    struct MeshLODSettings
+    {
+        uint32_t maxLevelCount = 4;         ///< Maximum number of levels per mesh, including the original mesh.
+        float reductionRatio = 0.5f;        ///< Target triangle count ratio between consecutive levels.
+        uint32_t minTriangleCount = 256;    ///< Meshes with fewer triangles are not simplified, and no level is simplified below this count.
+        float maxRelativeError = 0.01f;     ///< Maximum simplification error relative to the diagonal of the mesh bounding box.
+        float maxPixelError = 1.f;          ///< Maximum projected simplification error in pixels when selecting a level.
+        uint32_t viewportHeight = 1080;     ///< Viewport height in pixels used when selecting a level.
+    };
+
+    /** Statistics for a single mesh LOD level.
+    */
+    struct MeshLODLevel
+    {
+        uint32_t triangleCount = 0;         ///< Number of triangles.
+        float error = 0.f;                  ///< Simplification error in object space units.
+        uint32_t instanceCount = 0;         ///< Number of mesh instances using this level.
+    };
+
+    /** LOD chain statistics for a mesh.
+    */
+    struct MeshLODInfo
+    {
+        std::string meshName;               ///< Name of the original mesh.
+        std::vector<MeshLODLevel> levels;   ///< Levels ordered from finest to coarsest. Level 0 is the original mesh.
+    };
+
+    /** LOD chain for a mesh.
+    */
+    struct MeshLODChain
+    {
+        std::vector<std::vector<uint32_t>> indices; ///< Triangle list indices per level, referencing the original vertices.
+        std::vector<MeshLODLevel> levels;           ///< Level statistics. The instance counts are left at zero.
+    };
+
+    /** Generate a chain of simplified levels for a triangle mesh.
+        Each level targets the triangle count of the previous level scaled by the reduction ratio.
+        Generation stops when the maximum level count is reached, when the error bound is exceeded,
+        or when the simplifier can no longer make meaningful progress.
+        \param[in] positions Vertex positions.
+        \param[in] indices Triangle list indices.
+        \param[in] settings LOD settings.
+        \return LOD chain. The first level is the original mesh.
+    */
+    FALCOR_API MeshLODChain generateMeshLODChain(fstd::span<const float3> positions, fstd::span<const uint32_t> indices, const MeshLODSettings& settings);
+
+    /** Selects mesh LOD levels based on their projected simplification error.
+    */
+    class FALCOR_API MeshLODSelector
+    {
+    public:
+        /** Create a selector.
+            \param[in] fovY Vertical field of view in radians.
+            \param[in] viewportHeight Viewport height in pixels.
+            \param[in] maxPixelError Maximum allowed projected error in pixels.
+        */
+        MeshLODSelector(float fovY, uint32_t viewportHeight, float maxPixelError);
+
+        /** Get the projected size in pixels of an error at a given distance from the viewer.
+            \param[in] error Error in world space units.
+            \param[in] distance Distance from the viewer.
+            \return Projected error in pixels.
+        */
+        float getProjectedError(float error, float distance) const;
+
+        /** Select the coarsest level whose projected error is within the bound.
+            \param[in] levels Levels ordered from finest to coarsest, with non-decreasing errors.
+            \param[in] distance Distance from the viewer to the instance bounds.
+            \param[in] scale Scale of the instance transform, applied to the object space errors.
+            \return Index of the selected level.
+        */
+        uint32_t selectLevel(fstd::span<const MeshLODLevel> levels, float distance, float scale) const;
+
+        /** Get the distance from a point to a bounding box. Returns zero for points inside the box.
+        */
+        static float getDistance(const AABB& bounds, const float3& point);
+
+    private:
+        float mPixelsPerUnit;               ///< Pixels per world space unit at unit distance.
+        float mMaxPixelError;
+    };
+}
@@ -0,0 +1,422 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshSimplifier.h"
+#include "Core/Error.h"
+#include "Utils/Math/FNVHash.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        // Weights of the edge planes added along borders and attribute seams, relative to the triangle planes.
+        const float kBorderWeight = 10.f;
+        const float kSeamWeight = 1.f;
+
+        struct PositionKey
+        {
+            uint32_t bits[3];
+
+            bool operator==(const PositionKey& other) const { return std::memcmp(bits, other.bits, sizeof(bits)) == 0; }
+        };
+
+        struct PositionKeyHash
+        {
+            size_t operator()(const PositionKey& key) const { return (size_t)fnvHashArray64(key.bits, sizeof(key.bits)); }
+        };
+
+        uint64_t edgeKey(uint32_t a, uint32_t b) { return (uint64_t(a) << 32) | b; }
+
+        size_t countNotIn(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b, uint32_t value, bool& found)
+        {
+            size_t count = 0;
+            for (uint32_t x : a)
+            {
+                if (std::binary_search(b.begin(), b.end(), x)) continue;
+                count++;
+                if (x == value) found = true;
+            }
+            return count;
+        }
+    }
+
+    MeshSimplifier::Quadric MeshSimplifier::Quadric::fromPlane(const float3& n, float d, float weight)
+    {
+        Quadric q;
+        q.a00 = double(n.x) * n.x * weight;
+        q.a11 = double(n.y) * n.y * weight;
+        q.a22 = double(n.z) * n.z * weight;
+        q.a01 = double(n.x) * n.y * weight;
+        q.a02 = double(n.x) * n.z * weight;
+        q.a12 = double(n.y) * n.z * weight;
+        q.b0 = double(n.x) * d * weight;
+        q.b1 = double(n.y) * d * weight;
+        q.b2 = double(n.z) * d * weight;
+        q.c = double(d) * d * weight;
+        q.weight = weight;
+        return q;
+    }
+
+    MeshSimplifier::Quadric& MeshSimplifier::Quadric::operator+=(const Quadric& q)
+    {
+        a00 += q.a00; a11 += q.a11; a22 += q.a22;
+        a01 += q.a01; a02 += q.a02; a12 += q.a12;
+        b0 += q.b0; b1 += q.b1; b2 += q.b2;
+        c += q.c;
+        weight += q.weight;
+        return *this;
+    }
+
+    double MeshSimplifier::Quadric::eval(const float3& p) const
+    {
+        const double x = p.x, y = p.y, z = p.z;
+        return a00 * x * x + a11 * y * y + a22 * z * z
+            + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z)
+            + 2.0 * (b0 * x + b1 * y + b2 * z)
+            + c;
+    }
+
+    MeshSimplifier::MeshSimplifier(fstd::span<const float3> positions, fstd::span<const uint32_t> indices)
+        : mPositions(positions.begin(), positions.end())
+        , mIndices(indices.begin(), indices.end())
+    {
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count ({}) must be a multiple of three.", indices.size());
+        const uint32_t vertexCount = (uint32_t)positions.size();
+        const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+        for (uint32_t i : indices) FALCOR_CHECK(i < vertexCount, "Vertex index ({}) is out of range.", i);
+
+        // Weld vertices with bitwise identical positions into position classes.
+        mVertexClass.resize(vertexCount);
+        std::unordered_map<PositionKey, uint32_t, PositionKeyHash> classMap;
+        classMap.reserve(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            PositionKey key;
+            std::memcpy(key.bits, &mPositions[v], sizeof(key.bits));
+            auto [it, inserted] = classMap.try_emplace(key, (uint32_t)mClassVertices.size());
+            if (inserted) mClassVertices.emplace_back();
+            mVertexClass[v] = it->second;
+            mClassVertices[it->second].push_back(v);
+        }
+        const uint32_t classCount = (uint32_t)mClassVertices.size();
+        mClassTriangles.resize(classCount);
+        mQuadrics.resize(classCount);
+        mVersions.resize(classCount, 0);
+
+        // Discard triangles that are degenerate in position space and register the rest with their classes.
+        mTriangleAlive.resize(triangleCount, false);
+        std::vector<uint64_t> vertexEdges;
+        std::vector<uint64_t> classEdges;
+        vertexEdges.reserve(indices.size());
+        classEdges.reserve(indices.size());
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            const uint32_t* tri = &mIndices[3 * t];
+            const uint32_t c[3] = { mVertexClass[tri[0]], mVertexClass[tri[1]], mVertexClass[tri[2]] };
+            if (c[0] == c[1] || c[1] == c[2] || c[2] == c[0]) continue;
+
+            mTriangleAlive[t] = true;
+            mTriangleCount++;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                mClassTriangles[c[k]].push_back(t);
+                vertexEdges.push_back(edgeKey(tri[k], tri[(k + 1) % 3]));
+                classEdges.push_back(edgeKey(c[k], c[(k + 1) % 3]));
+            }
+        }
+        std::sort(vertexEdges.begin(), vertexEdges.end());
+        std::sort(classEdges.begin(), classEdges.end());
+
+        // Accumulate area weighted triangle planes. Edges without a matching opposite edge are
+        // either borders in position space or attribute seams. These get additional planes
+        // perpendicular to the surface to keep them from moving.
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            if (!mTriangleAlive[t]) continue;
+            const uint32_t* tri = &mIndices[3 * t];
+            const float3 p[3] = { mPositions[tri[0]], mPositions[tri[1]], mPositions[tri[2]] };
+            float3 n = cross(p[1] - p[0], p[2] - p[0]);
+            const float len = length(n);
+            if (len == 0.f) continue;
+            n /= len;
+
+            const Quadric q = Quadric::fromPlane(n, -dot(n, p[0]), 0.5f * len);
+            for (uint32_t k = 0; k < 3; k++) mQuadrics[mVertexClass[tri[k]]] += q;
+
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                const uint32_t a = tri[k], b = tri[(k + 1) % 3];
+                if (std::binary_search(vertexEdges.begin(), vertexEdges.end(), edgeKey(b, a))) continue;
+
+                const bool isBorder = !std::binary_search(classEdges.begin(), classEdges.end(), edgeKey(mVertexClass[b], mVertexClass[a]));
+                const float3 e = p[(k + 1) % 3] - p[k];
+                const float3 en = cross(e, n);
+                const float enLen = length(en);
+                if (enLen == 0.f) continue;
+
+                const float3 planeNormal = en / enLen;
+                const Quadric eq = Quadric::fromPlane(planeNormal, -dot(planeNormal, p[k]), dot(e, e) * (isBorder ? kBorderWeight : kSeamWeight));
+                mQuadrics[mVertexClass[a]] += eq;
+                mQuadrics[mVertexClass[b]] += eq;
+            }
+        }
+
+        for (uint32_t c = 0; c < classCount; c++)
+        {
+            if (!mClassTriangles[c].empty()) pushCollapse(c, false);
+        }
+    }
+
+    uint32_t MeshSimplifier::simplify(uint32_t targetTriangleCount, float maxError)
+    {
+        while (mTriangleCount > targetTriangleCount && !mQueue.empty())
+        {
+            const Collapse collapse = mQueue.top();
+            if (collapse.version != mVersions[collapse.src] || mClassVertices[collapse.src].empty() || mClassVertices[collapse.dst].empty())
+            {
+                mQueue.pop(); // Stale entry.
+                continue;
+            }
+
+            // Leave the collapse in the queue so that a later call with a larger error bound can continue from here.
+            if (collapse.error > maxError) break;
+            mQueue.pop();
+
+            // The neighborhood may have changed since the collapse was queued. Look for another one if it's no longer valid.
+            if (!isCollapseValid(collapse.src, collapse.dst))
+            {
+                pushCollapse(collapse.src, true);
+                continue;
+            }
+            performCollapse(collapse.src, collapse.dst);
+            mError = std::max(mError, collapse.error);
+        }
+        return mTriangleCount;
+    }
+
+    std::vector<uint32_t> MeshSimplifier::getIndices() const
+    {
+        std::vector<uint32_t> indices;
+        indices.reserve(3 * (size_t)mTriangleCount);
+        for (uint32_t t = 0; t < (uint32_t)mTriangleAlive.size(); t++)
+        {
+            if (!mTriangleAlive[t]) continue;
+            indices.insert(indices.end(), &mIndices[3 * t], &mIndices[3 * t] + 3);
+        }
+        return indices;
+    }
+
+    void MeshSimplifier::gatherNeighbors(uint32_t c, std::vector<uint32_t>& neighbors) const
+    {
+        neighbors.clear();
+        for (uint32_t t : mClassTriangles[c])
+        {
+            if (!mTriangleAlive[t]) continue;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                const uint32_t n = mVertexClass[mIndices[3 * t + k]];
+                if (n != c) neighbors.push_back(n);
+            }
+        }
+        std::sort(neighbors.begin(), neighbors.end());
+        neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+    }
+
+    float MeshSimplifier::evalCollapse(uint32_t src, uint32_t dst) const
+    {
+        Quadric q = mQuadrics[src];
+        q += mQuadrics[dst];
+        if (q.weight <= 0.0) return 0.f;
+        const double e = q.eval(mPositions[mClassVertices[dst][0]]);
+        return (float)std::sqrt(std::max(e, 0.0) / q.weight);
+    }
+
+    void MeshSimplifier::pushCollapse(uint32_t c, bool validate)
+    {
+        // Queue the cheapest collapse. The validity checks are expensive compared to the costs, and most
+        // queued collapses are invalidated by other collapses before they are reached. The validity is
+        // therefore checked when the collapse is dequeued, and only then are the alternatives checked in
+        // order of increasing cost.
+        gatherNeighbors(c, mNeighbors[0]);
+        mCandidates.clear();
+        for (uint32_t n : mNeighbors[0]) mCandidates.emplace_back(evalCollapse(c, n), n);
+        std::sort(mCandidates.begin(), mCandidates.end());
+
+        for (const auto& [error, n] : mCandidates)
+        {
+            if (validate && !isCollapseValid(c, n)) continue;
+            mQueue.push({ error, c, n, mVersions[c] });
+            return;
+        }
+    }
+
+    bool MeshSimplifier::isCollapseValid(uint32_t src, uint32_t dst)
+    {
+        const auto& srcVertices = mClassVertices[src];
+        const auto& srcTriangles = mClassTriangles[src];
+
+        // Each vertex of the source class must be connected to exactly one vertex of the destination class,
+        // which becomes its collapse target. Vertices on borders or seams must collapse along the border or seam.
+        auto& outs = mOuts;
+        auto& ins = mIns;
+        mCollapseTargets.assign(srcVertices.size(), kInvalidIndex);
+        for (size_t i = 0; i < srcVertices.size(); i++)
+        {
+            const uint32_t u = srcVertices[i];
+            uint32_t w = kInvalidIndex;
+            outs.clear();
+            ins.clear();
+            for (uint32_t t : srcTriangles)
+            {
+                if (!mTriangleAlive[t]) continue;
+                const uint32_t* tri = &mIndices[3 * t];
+                const uint32_t k = tri[0] == u ? 0 : tri[1] == u ? 1 : tri[2] == u ? 2 : 3;
+                if (k == 3) continue;
+
+                const uint32_t next = tri[(k + 1) % 3], prev = tri[(k + 2) % 3];
+                outs.push_back(next);
+                ins.push_back(prev);
+                for (uint32_t x : { next, prev })
+                {
+                    if (mVertexClass[x] != dst) continue;
+                    if (w != kInvalidIndex && w != x) return false;
+                    w = x;
+                }
+            }
+            if (outs.empty()) continue; // Vertex is no longer referenced.
+            if (w == kInvalidIndex) return false;
+
+            std::sort(outs.begin(), outs.end());
+            std::sort(ins.begin(), ins.end());
+            if (std::adjacent_find(outs.begin(), outs.end()) != outs.end() || std::adjacent_find(ins.begin(), ins.end()) != ins.end()) return false;
+
+            bool collapsesAlongOpenEdge = false;
+            const size_t openOut = countNotIn(outs, ins, w, collapsesAlongOpenEdge);
+            const size_t openIn = countNotIn(ins, outs, w, collapsesAlongOpenEdge);
+            if (openOut != openIn || openOut > 1) return false;
+            if (openOut == 1 && !collapsesAlongOpenEdge) return false;
+
+            mCollapseTargets[i] = w;
+        }
+
+        // Link condition: the classes adjacent to both source and destination must be exactly the
+        // opposite corners of the triangles on the collapsed edge. Otherwise the collapse changes the topology.
+        auto& srcNeighbors = mNeighbors[0];
+        auto& dstNeighbors = mNeighbors[1];
+        auto& opposite = mOpposite;
+        gatherNeighbors(src, srcNeighbors);
+        gatherNeighbors(dst, dstNeighbors);
+        opposite.clear();
+        for (uint32_t t : srcTriangles)
+        {
+            if (!mTriangleAlive[t]) continue;
+            uint32_t c[3];
+            for (uint32_t k = 0; k < 3; k++) c[k] = mVertexClass[mIndices[3 * t + k]];
+            if (c[0] != dst && c[1] != dst && c[2] != dst) continue;
+            for (uint32_t k = 0; k < 3; k++) if (c[k] != src && c[k] != dst) opposite.push_back(c[k]);
+        }
+        std::sort(opposite.begin(), opposite.end());
+        opposite.erase(std::unique(opposite.begin(), opposite.end()), opposite.end());
+
+        size_t commonCount = 0;
+        for (uint32_t n : srcNeighbors) commonCount += std::binary_search(dstNeighbors.begin(), dstNeighbors.end(), n) ? 1 : 0;
+        if (commonCount != opposite.size()) return false;
+
+        // Reject collapses that flip or collapse the remaining triangles.
+        const float3 dstPosition = mPositions[mClassVertices[dst][0]];
+        for (uint32_t t : srcTriangles)
+        {
+            if (!mTriangleAlive[t]) continue;
+            float3 p[3], q[3];
+            bool hasDst = false;
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                const uint32_t v = mIndices[3 * t + k];
+                hasDst |= mVertexClass[v] == dst;
+                p[k] = mPositions[v];
+                q[k] = mVertexClass[v] == src ? dstPosition : p[k];
+            }
+            if (hasDst) continue;
+
+            const float3 n0 = cross(p[1] - p[0], p[2] - p[0]);
+            const float3 n1 = cross(q[1] - q[0], q[2] - q[0]);
+            const float len0 = length(n0);
+            if (len0 > 0.f && dot(n0, n1) <= 0.25f * len0 * length(n1)) return false;
+        }
+
+        return true;
+    }
+
+    void MeshSimplifier::performCollapse(uint32_t src, uint32_t dst)
+    {
+        auto& srcVertices = mClassVertices[src];
+        auto& srcTriangles = mClassTriangles[src];
+        auto& dstTriangles = mClassTriangles[dst];
+
+        // Remove the triangles on the collapsed edge and move the remaining ones to the destination.
+        for (uint32_t t : srcTriangles)
+        {
+            if (!mTriangleAlive[t]) continue;
+            uint32_t* tri = &mIndices[3 * t];
+            if (mVertexClass[tri[0]] == dst || mVertexClass[tri[1]] == dst || mVertexClass[tri[2]] == dst)
+            {
+                mTriangleAlive[t] = false;
+                mTriangleCount--;
+                continue;
+            }
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                if (mVertexClass[tri[k]] != src) continue;
+                const size_t i = std::find(srcVertices.begin(), srcVertices.end(), tri[k]) - srcVertices.begin();
+                FALCOR_ASSERT(i < srcVertices.size() && mCollapseTargets[i] != kInvalidIndex);
+                tri[k] = mCollapseTargets[i];
+            }
+            dstTriangles.push_back(t);
+        }
+        std::erase_if(dstTriangles, [this](uint32_t t) { return !mTriangleAlive[t]; });
+
+        mQuadrics[dst] += mQuadrics[src];
+        srcVertices.clear();
+        srcTriangles.clear();
+        srcTriangles.shrink_to_fit();
+
+        // The collapse costs of the destination and its neighbors have changed.
+        gatherNeighbors(dst, mUpdated);
+        mUpdated.push_back(dst);
+        for (uint32_t c : mUpdated)
+        {
+            mVersions[c]++;
+            pushCollapse(c, false);
+        }
+    }
+}
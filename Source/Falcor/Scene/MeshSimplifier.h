@@ -0,0 +1,139 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h>
+#include <cstdint>
+#include <limits>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace Falcor
+{
+    /** Simplifies indexed triangle meshes using quadric error metrics.
+
+        The simplifier performs half-edge collapses, i.e., a vertex is always collapsed onto one of
+        its neighbors and no new vertices are created. The simplified index buffers therefore
+        reference the original vertex data, and all vertex attributes are preserved as is.
+
+        Vertices with bitwise identical positions are treated as one unit and collapsed together.
+        This keeps attribute seams (e.g. UV or normal discontinuities) intact: a vertex on a seam
+        may only slide along the seam, and all its wedges have to collapse onto the wedges of a
+        single neighbor. Mesh borders are handled the same way and are additionally constrained
+        by border planes in the error quadrics. Non-manifold vertices are never collapsed.
+
+        The simplifier is incremental. Calling simplify() repeatedly with decreasing triangle
+        counts produces a chain of nested levels of detail from a single run.
+
+        The error reported is the root mean square distance to the planes of the original
+        surface, in the units of the input positions.
+    */
+    class FALCOR_API MeshSimplifier
+    {
+    public:
+        /** Create a simplifier.
+            \param[in] positions Vertex positions.
+            \param[in] indices Triangle list indices. Must be a multiple of three.
+        */
+        MeshSimplifier(fstd::span<const float3> positions, fstd::span<const uint32_t> indices);
+
+        /** Simplify the mesh further.
+            Simplification stops when the triangle count reaches the target, or when the next
+            collapse would exceed the maximum error, or when no valid collapses remain.
+            \param[in] targetTriangleCount Target number of triangles.
+            \param[in] maxError Maximum error of the result.
+            \return Number of triangles after simplification.
+        */
+        uint32_t simplify(uint32_t targetTriangleCount, float maxError = std::numeric_limits<float>::max());
+
+        /** Get the current number of triangles.
+        */
+        uint32_t getTriangleCount() const { return mTriangleCount; }
+
+        /** Get the current simplification error.
+            This is the largest error of all collapses performed so far.
+        */
+        float getError() const { return mError; }
+
+        /** Get the current triangle list indices. The indices reference the original vertices.
+        */
+        std::vector<uint32_t> getIndices() const;
+
+    private:
+        struct Quadric
+        {
+            double a00 = 0.0, a11 = 0.0, a22 = 0.0, a01 = 0.0, a02 = 0.0, a12 = 0.0;
+            double b0 = 0.0, b1 = 0.0, b2 = 0.0, c = 0.0;
+            double weight = 0.0;
+
+            static Quadric fromPlane(const float3& n, float d, float weight);
+            Quadric& operator+=(const Quadric& q);
+            double eval(const float3& p) const;
+        };
+
+        struct Collapse
+        {
+            float error;
+            uint32_t src;       ///< Source vertex class.
+            uint32_t dst;       ///< Destination vertex class.
+            uint32_t version;   ///< Version of the source class when the collapse was evaluated.
+
+            bool operator>(const Collapse& other) const { return error > other.error; }
+        };
+
+        void gatherNeighbors(uint32_t c, std::vector<uint32_t>& neighbors) const;
+        float evalCollapse(uint32_t src, uint32_t dst) const;
+        void pushCollapse(uint32_t c, bool validate);
+        bool isCollapseValid(uint32_t src, uint32_t dst);
+        void performCollapse(uint32_t src, uint32_t dst);
+
+        std::vector<float3> mPositions;                 ///< Vertex positions.
+        std::vector<uint32_t> mIndices;                 ///< Current triangle indices.
+        std::vector<bool> mTriangleAlive;               ///< True if triangle is not collapsed.
+        std::vector<uint32_t> mVertexClass;             ///< Position class of each vertex.
+        std::vector<std::vector<uint32_t>> mClassVertices;  ///< Vertices in each position class.
+        std::vector<std::vector<uint32_t>> mClassTriangles; ///< Triangles referencing each position class. May contain collapsed triangles.
+        std::vector<Quadric> mQuadrics;                 ///< Error quadric of each position class.
+        std::vector<uint32_t> mVersions;                ///< Version of each position class, incremented when its collapse cost changes.
+        std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> mQueue; ///< Cheapest valid collapse of each position class.
+
+        // Scratch buffers.
+        std::vector<uint32_t> mCollapseTargets;         ///< Target vertex per source vertex of the collapse being evaluated.
+        std::vector<std::pair<float, uint32_t>> mCandidates;
+        std::vector<uint32_t> mUpdated;
+        std::vector<uint32_t> mNeighbors[2];
+        std::vector<uint32_t> mOuts;
+        std::vector<uint32_t> mIns;
+        std::vector<uint32_t> mOpposite;
+
+        uint32_t mTriangleCount = 0;
+        float mError = 0.f;
+    };
+}
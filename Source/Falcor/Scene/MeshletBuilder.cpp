@@ -0,0 +1,264 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshletBuilder.h"
+#include "Core/Error.h"
+#include "Utils/Math/AABB.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        // Normal cones with a smaller minimum cosine between axis and triangle normals are too wide to be useful for culling.
+        const float kMinConeCosine = 0.1f;
+
+        /** Spread the lower 10 bits of a value to every third bit.
+        */
+        uint32_t expandBits(uint32_t v)
+        {
+            v = (v * 0x00010001u) & 0xFF0000FFu;
+            v = (v * 0x00000101u) & 0x0F00F00Fu;
+            v = (v * 0x00000011u) & 0xC30C30C3u;
+            v = (v * 0x00000005u) & 0x49249249u;
+            return v;
+        }
+
+        uint32_t mortonCode(const float3& p)
+        {
+            const float3 q = clamp(p * 1024.f, float3(0.f), float3(1023.f));
+            return (expandBits((uint32_t)q.x) << 2) | (expandBits((uint32_t)q.y) << 1) | expandBits((uint32_t)q.z);
+        }
+
+        void computeBounds(MeshletDesc& meshlet, fstd::span<const float3> positions, const uint32_t* vertices, const uint32_t* triangles)
+        {
+            // Bounding sphere centered at the center of the bounding box.
+            AABB bounds;
+            for (uint32_t i = 0; i < meshlet.vertexCount; i++) bounds.include(positions[vertices[i]]);
+            meshlet.center = bounds.center();
+            float radius2 = 0.f;
+            for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+            {
+                const float3 d = positions[vertices[i]] - meshlet.center;
+                radius2 = std::max(radius2, dot(d, d));
+            }
+            meshlet.radius = std::sqrt(radius2);
+
+            // Normal cone around the average triangle normal. Degenerate triangles are ignored as they are never visible.
+            float3 axis(0.f);
+            for (uint32_t i = 0; i < meshlet.triangleCount; i++)
+            {
+                const uint3 t = MeshletBuilder::unpackTriangle(triangles[i]);
+                const float3 p0 = positions[vertices[t.x]];
+                const float3 n = cross(positions[vertices[t.y]] - p0, positions[vertices[t.z]] - p0);
+                const float len = length(n);
+                if (len > 0.f) axis += n / len;
+            }
+
+            meshlet.coneApex = meshlet.center;
+            meshlet.coneAxis = float3(0.f);
+            meshlet.coneCutoff = 1.f;
+            const float axisLength = length(axis);
+            if (axisLength == 0.f) return;
+            axis /= axisLength;
+
+            // Find the widest angle between the axis and the triangle normals. The apex is placed behind all
+            // triangle planes, so that the cone test is conservative for viewers at any distance.
+            float minCosine = 1.f;
+            float maxT = 0.f;
+            for (uint32_t i = 0; i < meshlet.triangleCount; i++)
+            {
+                const uint3 t = MeshletBuilder::unpackTriangle(triangles[i]);
+                const float3 p0 = positions[vertices[t.x]];
+                float3 n = cross(positions[vertices[t.y]] - p0, positions[vertices[t.z]] - p0);
+                const float len = length(n);
+                if (len == 0.f) continue;
+                n /= len;
+
+                const float cosine = dot(axis, n);
+                minCosine = std::min(minCosine, cosine);
+                if (cosine < kMinConeCosine) return;
+                maxT = std::max(maxT, dot(meshlet.center - p0, n) / cosine);
+            }
+
+            meshlet.coneApex = meshlet.center - axis * maxT;
+            meshlet.coneAxis = axis;
+            meshlet.coneCutoff = std::sqrt(std::max(0.f, 1.f - minCosine * minCosine));
+        }
+    }
+
+    MeshletBuilder::Result MeshletBuilder::build(fstd::span<const float3> positions, fstd::span<const uint32_t> indices, uint32_t maxVertexCount, uint32_t maxTriangleCount)
+    {
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count ({}) must be a multiple of three.", indices.size());
+        FALCOR_CHECK(maxVertexCount >= 3 && maxVertexCount <= 256, "Max vertex count ({}) must be in the range [3,256].", maxVertexCount);
+        FALCOR_CHECK(maxTriangleCount >= 1, "Max triangle count must be at least one.");
+
+        const uint32_t vertexCount = (uint32_t)positions.size();
+        const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+        for (uint32_t i : indices) FALCOR_CHECK(i < vertexCount, "Vertex index ({}) is out of range.", i);
+
+        Result result;
+        if (triangleCount == 0) return result;
+
+        // Build vertex to triangle adjacency.
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (uint32_t i : indices) adjacencyOffsets[i + 1]++;
+        for (uint32_t v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+        std::vector<uint32_t> adjacency(indices.size());
+        {
+            std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+            for (uint32_t i = 0; i < (uint32_t)indices.size(); i++) adjacency[fill[indices[i]]++] = i / 3;
+        }
+
+        // Compute triangle centroids and order the triangles along a Morton curve for seeding.
+        AABB bounds;
+        for (uint32_t i : indices) bounds.include(positions[i]);
+        const float3 extent = bounds.extent();
+        const float scale = 1.f / std::max(std::max(extent.x, extent.y), std::max(extent.z, std::numeric_limits<float>::min()));
+
+        std::vector<float3> centroids(triangleCount);
+        std::vector<uint64_t> seedOrder(triangleCount);
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            centroids[t] = (positions[indices[3 * t]] + positions[indices[3 * t + 1]] + positions[indices[3 * t + 2]]) / 3.f;
+            seedOrder[t] = (uint64_t(mortonCode((centroids[t] - bounds.minPoint) * scale)) << 32) | t;
+        }
+        std::sort(seedOrder.begin(), seedOrder.end());
+
+        std::vector<bool> used(triangleCount, false);
+        std::vector<uint32_t> liveCount(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++) liveCount[v] = adjacencyOffsets[v + 1] - adjacencyOffsets[v];
+        std::vector<uint32_t> localIndex(vertexCount, kInvalidIndex);
+        std::vector<uint32_t> candidates;
+        size_t seedCursor = 0;
+
+        MeshletDesc meshlet = {};
+        float3 centroidSum(0.f);
+
+        auto flush = [&]()
+        {
+            meshlet.vertexOffset = (uint32_t)result.vertices.size() - meshlet.vertexCount;
+            meshlet.triangleOffset = (uint32_t)result.triangles.size() - meshlet.triangleCount;
+            computeBounds(meshlet, positions, result.vertices.data() + meshlet.vertexOffset, result.triangles.data() + meshlet.triangleOffset);
+            result.meshlets.push_back(meshlet);
+
+            for (uint32_t i = 0; i < meshlet.vertexCount; i++) localIndex[result.vertices[meshlet.vertexOffset + i]] = kInvalidIndex;
+            meshlet = {};
+            centroidSum = float3(0.f);
+            candidates.clear();
+        };
+
+        for (uint32_t addedCount = 0; addedCount < triangleCount;)
+        {
+            // Find the adjacent triangle that adds the fewest vertices and is closest to the meshlet center.
+            // Triangles that are the last unused ones of a vertex are preferred, as they would otherwise be
+            // left behind as small fragments that need meshlets of their own.
+            uint32_t best = kInvalidIndex;
+            uint32_t bestPriority = 5;
+            float bestDistance = std::numeric_limits<float>::infinity();
+            const float3 center = meshlet.triangleCount > 0 ? centroidSum / (float)meshlet.triangleCount : float3(0.f);
+            for (size_t i = 0; i < candidates.size();)
+            {
+                const uint32_t t = candidates[i];
+                if (used[t])
+                {
+                    candidates[i] = candidates.back();
+                    candidates.pop_back();
+                    continue;
+                }
+                i++;
+
+                uint32_t newVertices = 0;
+                bool dangling = false;
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    const uint32_t v = indices[3 * t + k];
+                    newVertices += localIndex[v] == kInvalidIndex ? 1 : 0;
+                    dangling |= liveCount[v] == 1;
+                }
+                if (meshlet.vertexCount + newVertices > maxVertexCount) continue;
+
+                const uint32_t priority = newVertices == 0 ? 0 : dangling ? 1 : newVertices + 1;
+                if (priority > bestPriority) continue;
+
+                const float3 d = centroids[t] - center;
+                const float distance = dot(d, d);
+                if (priority < bestPriority || distance < bestDistance)
+                {
+                    best = t;
+                    bestPriority = priority;
+                    bestDistance = distance;
+                }
+            }
+
+            if (best == kInvalidIndex)
+            {
+                // Start a new meshlet if the current one can't grow, otherwise start from the next seed.
+                if (meshlet.triangleCount > 0)
+                {
+                    flush();
+                    continue;
+                }
+                while (used[(uint32_t)seedOrder[seedCursor]]) seedCursor++;
+                best = (uint32_t)seedOrder[seedCursor];
+            }
+
+            // Add the triangle.
+            used[best] = true;
+            addedCount++;
+            uint32_t local[3];
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                const uint32_t v = indices[3 * best + k];
+                liveCount[v]--;
+                if (localIndex[v] == kInvalidIndex)
+                {
+                    localIndex[v] = meshlet.vertexCount++;
+                    result.vertices.push_back(v);
+                    for (uint32_t j = adjacencyOffsets[v]; j < adjacencyOffsets[v + 1]; j++)
+                    {
+                        if (!used[adjacency[j]]) candidates.push_back(adjacency[j]);
+                    }
+                }
+                local[k] = localIndex[v];
+            }
+            result.triangles.push_back(packTriangle(local[0], local[1], local[2]));
+            meshlet.triangleCount++;
+            centroidSum += centroids[best];
+
+            if (meshlet.triangleCount == maxTriangleCount) flush();
+        }
+
+        if (meshlet.triangleCount > 0) flush();
+
+        return result;
+    }
+}
@@ -0,0 +1,82 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SceneTypes.slang"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Splits triangle meshes into meshlets, i.e., small clusters of triangles with bounds for culling.
+
+        Meshlets are grown greedily from seed triangles. Each step adds the adjacent triangle that
+        references the fewest new vertices, breaking ties by the distance to the meshlet center.
+        Seeds are taken in Morton order of the triangle centroids, so that meshlets are spatially
+        coherent even where the mesh connectivity doesn't help.
+
+        Each meshlet gets a bounding sphere for frustum culling and a normal cone for backface
+        culling (see MeshletDesc::isBackfacing()).
+    */
+    class FALCOR_API MeshletBuilder
+    {
+    public:
+        static constexpr uint32_t kMaxVertexCount = 64;      ///< Default max number of vertices per meshlet.
+        static constexpr uint32_t kMaxTriangleCount = 124;   ///< Default max number of triangles per meshlet.
+
+        struct Result
+        {
+            std::vector<MeshletDesc> meshlets;  ///< Meshlets. The offsets are into the vertex and triangle lists below.
+            std::vector<uint32_t> vertices;     ///< Meshlet vertices. These are indices into the mesh vertices.
+            std::vector<uint32_t> triangles;    ///< Meshlet triangles. Each is three 8-bit indices into the meshlet vertices.
+        };
+
+        /** Build meshlets for a triangle mesh.
+            \param[in] positions Vertex positions.
+            \param[in] indices Triangle list indices.
+            \param[in] maxVertexCount Max number of vertices per meshlet. Must be in the range [3,256].
+            \param[in] maxTriangleCount Max number of triangles per meshlet. Must be at least one.
+            \return Meshlets. Every triangle of the mesh is in exactly one meshlet.
+        */
+        static Result build(fstd::span<const float3> positions, fstd::span<const uint32_t> indices, uint32_t maxVertexCount = kMaxVertexCount, uint32_t maxTriangleCount = kMaxTriangleCount);
+
+        /** Pack a meshlet triangle.
+            \param[in] a, b, c Indices into the meshlet vertices.
+            \return Packed triangle.
+        */
+        static uint32_t packTriangle(uint32_t a, uint32_t b, uint32_t c) { return a | (b << 8) | (c << 16); }
+
+        /** Unpack a meshlet triangle.
+            \param[in] triangle Packed triangle.
+            \return Indices into the meshlet vertices.
+        */
+        static uint3 unpackTriangle(uint32_t triangle) { return uint3(triangle & 0xff, (triangle >> 8) & 0xff, (triangle >> 16) & 0xff); }
+    };
+}
@@ -0,0 +1,720 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ObjParser.h"
+#include "ImporterError.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include "Utils/StringFormatters.h"
+#include <fast_float/fast_float.h>
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <exception>
+#include <execution>
+#include <limits>
+#include <map>
+#include <utility>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kInvalidIndex = std::numeric_limits<uint32_t>::max();
+
+        /** Resolved indices of a face corner. Attributes that are not specified are kInvalidIndex.
+        */
+        struct Corner
+        {
+            uint32_t position;
+            uint32_t texCrd;
+            uint32_t normal;
+
+            bool operator==(const Corner& other) const { return position == other.position && texCrd == other.texCrd && normal == other.normal; }
+        };
+
+        /** Change of the current group or material, taking effect at the given triangle of a chunk.
+        */
+        struct StateChange
+        {
+            uint32_t triangle;
+            bool isMaterial;
+            std::string name;
+        };
+
+        struct Chunk
+        {
+            const char* pBegin = nullptr;
+            const char* pEnd = nullptr;
+
+            // Counts from the first pass and the global offsets derived from them.
+            uint64_t lineCount = 0;
+            uint64_t positionCount = 0;
+            uint64_t texCrdCount = 0;
+            uint64_t normalCount = 0;
+            uint64_t firstLine = 0;
+            uint64_t firstPosition = 0;
+            uint64_t firstTexCrd = 0;
+            uint64_t firstNormal = 0;
+
+            // Results of the second pass.
+            std::vector<Corner> corners;    ///< Three corners per triangle.
+            std::vector<StateChange> stateChanges;
+            std::vector<std::string> materialLibraries;
+
+            uint32_t getTriangleCount() const { return uint32_t(corners.size() / 3); }
+        };
+
+        /** Range of triangles of a chunk that belong to a mesh.
+        */
+        struct Segment
+        {
+            uint32_t chunk;
+            uint32_t firstTriangle;
+            uint32_t triangleCount;
+        };
+
+        struct VertexData
+        {
+            std::vector<float3> positions;
+            std::vector<float2> texCrds;
+            std::vector<float3> normals;
+        };
+
+        bool isSpace(char c) { return c == ' ' || c == '\t' || c == '\r'; }
+
+        /** Iterates over the lines of a text and the tokens of the current line.
+        */
+        class LineReader
+        {
+        public:
+            LineReader(const char* pBegin, const char* pEnd) : mpNext(pBegin), mpEnd(pEnd) {}
+
+            /** Advance to the next line.
+                \return False if there are no more lines.
+            */
+            bool nextLine()
+            {
+                if (mpNext >= mpEnd)
+                    return false;
+                mPos = mpNext;
+                const char* pNewline = static_cast<const char*>(std::memchr(mpNext, '\n', mpEnd - mpNext));
+                mLineEnd = pNewline ? pNewline : mpEnd;
+                mpNext = pNewline ? pNewline + 1 : mpEnd;
+                while (mLineEnd > mPos && isSpace(mLineEnd[-1]))
+                    mLineEnd--;
+                return true;
+            }
+
+            bool atEnd()
+            {
+                skipSpace();
+                return mPos == mLineEnd;
+            }
+
+            std::string_view token()
+            {
+                skipSpace();
+                const char* pBegin = mPos;
+                while (mPos < mLineEnd && !isSpace(*mPos))
+                    mPos++;
+                return std::string_view(pBegin, mPos - pBegin);
+            }
+
+            /** Get the remainder of the line, e.g. a name or file path that may contain spaces.
+            */
+            std::string_view rest()
+            {
+                skipSpace();
+                std::string_view str(mPos, mLineEnd - mPos);
+                mPos = mLineEnd;
+                return str;
+            }
+
+            bool readFloat(float& value)
+            {
+                skipSpace();
+                const char* pBegin = mPos;
+                // Skip '+' character, fast_float::from_chars doesn't handle '+'.
+                if (pBegin < mLineEnd && *pBegin == '+')
+                    pBegin++;
+                auto result = fast_float::from_chars(pBegin, mLineEnd, value);
+                if (result.ec != std::errc() || (result.ptr < mLineEnd && !isSpace(*result.ptr)))
+                    return false;
+                mPos = result.ptr;
+                return true;
+            }
+
+            /** Read a float if the next token is a number.
+            */
+            bool tryReadFloat(float& value)
+            {
+                const char* pPos = mPos;
+                if (readFloat(value))
+                    return true;
+                mPos = pPos;
+                return false;
+            }
+
+        private:
+            void skipSpace()
+            {
+                while (mPos < mLineEnd && isSpace(*mPos))
+                    mPos++;
+            }
+
+            const char* mpNext;
+            const char* mpEnd;
+            const char* mPos = nullptr;
+            const char* mLineEnd = nullptr;
+        };
+
+        enum class VertexStatement
+        {
+            None,
+            Position,
+            TexCrd,
+            Normal,
+        };
+
+        /** Classify a line by its keyword, without parsing it.
+            This must agree with the keywords found by ChunkParser, which writes vertex data to the ranges counted here.
+        */
+        VertexStatement getVertexStatement(const char* pLine, const char* pEnd)
+        {
+            while (pLine < pEnd && isSpace(*pLine))
+                pLine++;
+            const char* pKeywordEnd = pLine;
+            while (pKeywordEnd < pEnd && !isSpace(*pKeywordEnd))
+                pKeywordEnd++;
+            std::string_view keyword(pLine, pKeywordEnd - pLine);
+            if (keyword == "v")
+                return VertexStatement::Position;
+            if (keyword == "vt")
+                return VertexStatement::TexCrd;
+            if (keyword == "vn")
+                return VertexStatement::Normal;
+            return VertexStatement::None;
+        }
+
+        std::vector<Chunk> splitChunks(const char* pBegin, const char* pEnd, size_t chunkSize)
+        {
+            std::vector<Chunk> chunks;
+            while (pBegin < pEnd)
+            {
+                const char* pChunkEnd = pEnd;
+                if (size_t(pEnd - pBegin) > chunkSize)
+                {
+                    const char* pSearch = pBegin + chunkSize - 1;
+                    const char* pNewline = static_cast<const char*>(std::memchr(pSearch, '\n', pEnd - pSearch));
+                    pChunkEnd = pNewline ? pNewline + 1 : pEnd;
+                }
+                Chunk& chunk = chunks.emplace_back();
+                chunk.pBegin = pBegin;
+                chunk.pEnd = pChunkEnd;
+                pBegin = pChunkEnd;
+            }
+            return chunks;
+        }
+
+        void countChunk(Chunk& chunk)
+        {
+            const char* pLine = chunk.pBegin;
+            while (pLine < chunk.pEnd)
+            {
+                const char* pNewline = static_cast<const char*>(std::memchr(pLine, '\n', chunk.pEnd - pLine));
+                const char* pLineEnd = pNewline ? pNewline : chunk.pEnd;
+                switch (getVertexStatement(pLine, pLineEnd))
+                {
+                case VertexStatement::Position: chunk.positionCount++; break;
+                case VertexStatement::TexCrd: chunk.texCrdCount++; break;
+                case VertexStatement::Normal: chunk.normalCount++; break;
+                default: break;
+                }
+                chunk.lineCount++;
+                pLine = pNewline ? pNewline + 1 : chunk.pEnd;
+            }
+        }
+
+        /** Parse an OBJ vertex index and resolve it to a zero-based index.
+            \param[in] str Index string. Positive indices are one-based, negative indices are relative to the current vertex count.
+            \param[in] currentCount Number of vertices defined before the current line.
+            \param[in] totalCount Total number of vertices in the file.
+            \param[out] index Resolved index.
+            \return False if the index is malformed or out of range.
+        */
+        bool parseIndex(std::string_view str, uint64_t currentCount, uint64_t totalCount, uint32_t& index)
+        {
+            const char* pBegin = str.data();
+            const char* pEnd = str.data() + str.size();
+            if (pBegin < pEnd && *pBegin == '+')
+                pBegin++;
+            int64_t value = 0;
+            auto result = std::from_chars(pBegin, pEnd, value);
+            if (result.ec != std::errc() || result.ptr != pEnd || value == 0)
+                return false;
+            if (value < 0)
+            {
+                if (uint64_t(-value) > currentCount)
+                    return false;
+                index = uint32_t(currentCount - uint64_t(-value));
+            }
+            else
+            {
+                if (uint64_t(value) > totalCount)
+                    return false;
+                index = uint32_t(value - 1);
+            }
+            return true;
+        }
+
+        /** Second pass over a chunk. Vertex data is written to the chunk's ranges of the final vertex arrays,
+            faces and group/material changes are collected in the chunk.
+        */
+        class ChunkParser
+        {
+        public:
+            ChunkParser(const std::filesystem::path& path, Chunk& chunk, VertexData& vertices)
+                : mPath(path)
+                , mChunk(chunk)
+                , mVertices(vertices)
+                , mPositionCount(chunk.firstPosition)
+                , mTexCrdCount(chunk.firstTexCrd)
+                , mNormalCount(chunk.firstNormal)
+            {}
+
+            void parse()
+            {
+                LineReader reader(mChunk.pBegin, mChunk.pEnd);
+                uint64_t line = mChunk.firstLine;
+                std::vector<Corner> polygon;
+                while (reader.nextLine())
+                {
+                    line++;
+                    std::string_view keyword = reader.token();
+                    if (keyword.empty() || keyword[0] == '#')
+                        continue;
+
+                    if (keyword == "v")
+                    {
+                        float3& p = mVertices.positions[mPositionCount++];
+                        if (!reader.readFloat(p.x) || !reader.readFloat(p.y) || !reader.readFloat(p.z))
+                            error(line, "Expected three vertex coordinates.");
+                    }
+                    else if (keyword == "vt")
+                    {
+                        float2& t = mVertices.texCrds[mTexCrdCount++];
+                        t = float2(0.f);
+                        if (!reader.readFloat(t.x) || (!reader.atEnd() && !reader.readFloat(t.y)))
+                            error(line, "Expected texture coordinates.");
+                        t.y = 1.f - t.y;
+                    }
+                    else if (keyword == "vn")
+                    {
+                        float3& n = mVertices.normals[mNormalCount++];
+                        if (!reader.readFloat(n.x) || !reader.readFloat(n.y) || !reader.readFloat(n.z))
+                            error(line, "Expected three normal coordinates.");
+                    }
+                    else if (keyword == "f")
+                    {
+                        polygon.clear();
+                        while (!reader.atEnd())
+                            polygon.push_back(parseCorner(reader.token(), line));
+                        if (polygon.size() < 3)
+                            error(line, "Face has fewer than three vertices.");
+                        // Triangulate as a fan.
+                        for (size_t i = 1; i + 1 < polygon.size(); i++)
+                            mChunk.corners.insert(mChunk.corners.end(), {polygon[0], polygon[i], polygon[i + 1]});
+                    }
+                    else if (keyword == "g" || keyword == "o")
+                    {
+                        mChunk.stateChanges.push_back({mChunk.getTriangleCount(), false, std::string(reader.rest())});
+                    }
+                    else if (keyword == "usemtl")
+                    {
+                        mChunk.stateChanges.push_back({mChunk.getTriangleCount(), true, std::string(reader.rest())});
+                    }
+                    else if (keyword == "mtllib")
+                    {
+                        mChunk.materialLibraries.emplace_back(reader.rest());
+                    }
+                    // Other statements (points, lines, smoothing groups, free-form geometry, ...) are ignored.
+                }
+            }
+
+        private:
+            Corner parseCorner(std::string_view token, uint64_t line)
+            {
+                // Corners are of the form v, v/vt, v//vn or v/vt/vn.
+                Corner corner{kInvalidIndex, kInvalidIndex, kInvalidIndex};
+                size_t slash0 = token.find('/');
+                size_t slash1 = slash0 == std::string_view::npos ? std::string_view::npos : token.find('/', slash0 + 1);
+
+                if (!parseIndex(token.substr(0, slash0), mPositionCount, mVertices.positions.size(), corner.position))
+                    error(line, "Invalid vertex index '{}'.", token);
+                if (slash0 != std::string_view::npos)
+                {
+                    std::string_view texCrd = token.substr(slash0 + 1, slash1 == std::string_view::npos ? std::string_view::npos : slash1 - slash0 - 1);
+                    if (!texCrd.empty() && !parseIndex(texCrd, mTexCrdCount, mVertices.texCrds.size(), corner.texCrd))
+                        error(line, "Invalid texture coordinate index '{}'.", token);
+                }
+                if (slash1 != std::string_view::npos)
+                {
+                    if (!parseIndex(token.substr(slash1 + 1), mNormalCount, mVertices.normals.size(), corner.normal))
+                        error(line, "Invalid normal index '{}'.", token);
+                }
+                return corner;
+            }
+
+            template<typename... Args>
+            [[noreturn]] void error(uint64_t line, fmt::format_string<Args...> format, Args&&... args) const
+            {
+                throw ImporterError(mPath, "Line {}: {}", line, fmt::format(format, std::forward<Args>(args)...));
+            }
+
+            const std::filesystem::path& mPath;
+            Chunk& mChunk;
+            VertexData& mVertices;
+            uint64_t mPositionCount;    ///< Number of positions defined before the current line.
+            uint64_t mTexCrdCount;      ///< Number of texture coordinates defined before the current line.
+            uint64_t mNormalCount;      ///< Number of normals defined before the current line.
+        };
+
+        uint64_t hashCorner(const Corner& c)
+        {
+            uint64_t h = uint64_t(c.position) * 0x9e3779b97f4a7c15ull;
+            h ^= uint64_t(c.texCrd) * 0xc2b2ae3d27d4eb4full;
+            h ^= uint64_t(c.normal) * 0x165667b19e3779f9ull;
+            return h ^ (h >> 29);
+        }
+
+        /** Weld the corners of a mesh into vertices using an open addressing hash table.
+        */
+        void weldMesh(const std::filesystem::path& path, const std::vector<Chunk>& chunks, const std::vector<Segment>& segments, const VertexData& vertices, ObjParser::Mesh& mesh)
+        {
+            uint64_t cornerCount = 0;
+            bool hasTexCrds = true;
+            bool hasNormals = true;
+            for (const Segment& segment : segments)
+            {
+                cornerCount += uint64_t(segment.triangleCount) * 3;
+                const Corner* pCorners = chunks[segment.chunk].corners.data() + size_t(segment.firstTriangle) * 3;
+                for (size_t i = 0; i < size_t(segment.triangleCount) * 3; i++)
+                {
+                    hasTexCrds &= pCorners[i].texCrd != kInvalidIndex;
+                    hasNormals &= pCorners[i].normal != kInvalidIndex;
+                }
+            }
+            if (cornerCount >= kInvalidIndex)
+                throw ImporterError(path, "Mesh '{}' has too many faces.", mesh.name);
+
+            size_t capacity = 16;
+            while (capacity < cornerCount * 2)
+                capacity *= 2;
+            const uint64_t mask = capacity - 1;
+            std::vector<uint32_t> table(capacity, kInvalidIndex);
+            std::vector<Corner> uniqueCorners;
+            mesh.indices.reserve(cornerCount);
+
+            for (const Segment& segment : segments)
+            {
+                const Corner* pCorners = chunks[segment.chunk].corners.data() + size_t(segment.firstTriangle) * 3;
+                for (size_t i = 0; i < size_t(segment.triangleCount) * 3; i++)
+                {
+                    // Attributes that are missing on some faces are dropped for the whole mesh.
+                    Corner key = pCorners[i];
+                    if (!hasTexCrds)
+                        key.texCrd = kInvalidIndex;
+                    if (!hasNormals)
+                        key.normal = kInvalidIndex;
+
+                    uint64_t slot = hashCorner(key) & mask;
+                    while (table[slot] != kInvalidIndex && !(uniqueCorners[table[slot]] == key))
+                        slot = (slot + 1) & mask;
+                    if (table[slot] == kInvalidIndex)
+                    {
+                        table[slot] = uint32_t(uniqueCorners.size());
+                        uniqueCorners.push_back(key);
+                    }
+                    mesh.indices.push_back(table[slot]);
+                }
+            }
+
+            mesh.positions.resize(uniqueCorners.size());
+            if (hasTexCrds)
+                mesh.texCrds.resize(uniqueCorners.size());
+            if (hasNormals)
+                mesh.normals.resize(uniqueCorners.size());
+            for (size_t i = 0; i < uniqueCorners.size(); i++)
+            {
+                mesh.positions[i] = vertices.positions[uniqueCorners[i].position];
+                if (hasTexCrds)
+                    mesh.texCrds[i] = vertices.texCrds[uniqueCorners[i].texCrd];
+                if (hasNormals)
+                    mesh.normals[i] = vertices.normals[uniqueCorners[i].normal];
+            }
+        }
+
+        /** Run a function for each index in parallel.
+            Exceptions can't propagate out of the parallel loop, the one of the lowest failing index is rethrown afterwards.
+        */
+        template<typename F>
+        void parallelFor(size_t count, F func)
+        {
+            std::vector<std::exception_ptr> exceptions(count);
+            auto range = NumericRange<size_t>(0, count);
+            std::for_each(
+                std::execution::par,
+                range.begin(),
+                range.end(),
+                [&](size_t i)
+                {
+                    try
+                    {
+                        func(i);
+                    }
+                    catch (...)
+                    {
+                        exceptions[i] = std::current_exception();
+                    }
+                }
+            );
+            for (const auto& pException : exceptions)
+            {
+                if (pException)
+                    std::rethrow_exception(pException);
+            }
+        }
+
+        /** Skip the options of a texture map statement, e.g. "map_Kd -s 2 2 texture.png".
+            \param[in,out] token First token after the keyword. Updated to the first token after the options.
+        */
+        void skipMapOptions(LineReader& reader, std::string_view& token)
+        {
+            static const std::map<std::string_view, uint32_t> kOptionArgCounts = {
+                {"-blendu", 1}, {"-blendv", 1}, {"-bm", 1}, {"-boost", 1}, {"-cc", 1}, {"-clamp", 1},
+                {"-imfchan", 1}, {"-mm", 2}, {"-texres", 1}, {"-type", 1},
+            };
+
+            while (!token.empty() && token[0] == '-')
+            {
+                if (token == "-o" || token == "-s" || token == "-t")
+                {
+                    // One to three values.
+                    float value;
+                    for (uint32_t i = 0; i < 3 && reader.tryReadFloat(value); i++)
+                    {}
+                }
+                else if (auto it = kOptionArgCounts.find(token); it != kOptionArgCounts.end())
+                {
+                    for (uint32_t i = 0; i < it->second; i++)
+                        reader.token();
+                }
+                token = reader.token();
+            }
+        }
+    }
+
+    ObjParser::Result ObjParser::parse(const void* pData, size_t byteSize, const std::filesystem::path& path, size_t chunkSize)
+    {
+        FALCOR_CHECK(chunkSize > 0, "'chunkSize' must be positive.");
+
+        const char* pBegin = static_cast<const char*>(pData);
+        const char* pEnd = pBegin + byteSize;
+        // Skip the UTF-8 byte order mark.
+        if (byteSize >= 3 && std::memcmp(pBegin, "\xef\xbb\xbf", 3) == 0)
+            pBegin += 3;
+
+        // First pass: count lines and vertex statements per chunk.
+        std::vector<Chunk> chunks = splitChunks(pBegin, pEnd, chunkSize);
+        parallelFor(chunks.size(), [&](size_t i) { countChunk(chunks[i]); });
+
+        uint64_t lineCount = 0, positionCount = 0, texCrdCount = 0, normalCount = 0;
+        for (Chunk& chunk : chunks)
+        {
+            chunk.firstLine = lineCount;
+            chunk.firstPosition = positionCount;
+            chunk.firstTexCrd = texCrdCount;
+            chunk.firstNormal = normalCount;
+            lineCount += chunk.lineCount;
+            positionCount += chunk.positionCount;
+            texCrdCount += chunk.texCrdCount;
+            normalCount += chunk.normalCount;
+        }
+        if (std::max({positionCount, texCrdCount, normalCount}) >= kInvalidIndex)
+            throw ImporterError(path, "File has too many vertices.");
+
+        // Second pass: parse vertex data into the final arrays, collect faces and state changes per chunk.
+        VertexData vertices;
+        vertices.positions.resize(positionCount);
+        vertices.texCrds.resize(texCrdCount);
+        vertices.normals.resize(normalCount);
+        parallelFor(chunks.size(), [&](size_t i) { ChunkParser(path, chunks[i], vertices).parse(); });
+
+        // Assign triangle ranges to meshes by the current group and material.
+        Result result;
+        std::vector<std::vector<Segment>> meshSegments;
+        std::map<std::pair<std::string, std::string>, uint32_t> meshIndices;
+        std::string group = "default";
+        std::string material;
+        for (uint32_t chunkIndex = 0; chunkIndex < chunks.size(); chunkIndex++)
+        {
+            const Chunk& chunk = chunks[chunkIndex];
+            uint32_t firstTriangle = 0;
+            auto addSegment = [&](uint32_t endTriangle)
+            {
+                if (endTriangle > firstTriangle)
+                {
+                    auto [it, inserted] = meshIndices.try_emplace({group, material}, uint32_t(result.meshes.size()));
+                    if (inserted)
+                    {
+                        Mesh& mesh = result.meshes.emplace_back();
+                        mesh.name = group;
+                        mesh.material = material;
+                        meshSegments.emplace_back();
+                    }
+                    meshSegments[it->second].push_back({chunkIndex, firstTriangle, endTriangle - firstTriangle});
+                }
+                firstTriangle = endTriangle;
+            };
+
+            for (const StateChange& change : chunk.stateChanges)
+            {
+                addSegment(change.triangle);
+                if (change.isMaterial)
+                    material = change.name;
+                else
+                    group = change.name.empty() ? "default" : change.name;
+            }
+            addSegment(chunk.getTriangleCount());
+
+            for (const std::string& library : chunk.materialLibraries)
+            {
+                if (std::find(result.materialLibraries.begin(), result.materialLibraries.end(), library) == result.materialLibraries.end())
+                    result.materialLibraries.push_back(library);
+            }
+        }
+
+        // Weld meshes in parallel.
+        parallelFor(result.meshes.size(), [&](size_t i) { weldMesh(path, chunks, meshSegments[i], vertices, result.meshes[i]); });
+
+        return result;
+    }
+
+    std::vector<ObjParser::Material> ObjParser::parseMaterials(std::string_view text, const std::filesystem::path& path)
+    {
+        if (text.substr(0, 3) == "\xef\xbb\xbf")
+            text.remove_prefix(3);
+
+        std::vector<Material> materials;
+        LineReader reader(text.data(), text.data() + text.size());
+        uint64_t line = 0;
+
+        auto readFloat = [&](std::string_view keyword)
+        {
+            float value;
+            if (!reader.readFloat(value))
+                throw ImporterError(path, "Line {}: Invalid value for '{}'.", line, keyword);
+            return value;
+        };
+        auto readColor = [&](std::string_view keyword)
+        {
+            // A single value sets all channels.
+            float3 color(readFloat(keyword));
+            if (!reader.atEnd())
+            {
+                color.y = readFloat(keyword);
+                color.z = readFloat(keyword);
+            }
+            return color;
+        };
+        auto readMap = [&]()
+        {
+            std::string_view token = reader.token();
+            skipMapOptions(reader, token);
+            // File names may contain spaces.
+            std::string_view rest = reader.rest();
+            return std::string(token.data(), rest.data() + rest.size());
+        };
+
+        while (reader.nextLine())
+        {
+            line++;
+            std::string_view keyword = reader.token();
+            if (keyword.empty() || keyword[0] == '#')
+                continue;
+
+            if (keyword == "newmtl")
+            {
+                materials.emplace_back().name = reader.rest();
+                continue;
+            }
+            // Properties outside of a material are ignored.
+            if (materials.empty())
+                continue;
+
+            Material& material = materials.back();
+            if (keyword == "Kd")
+                material.diffuse = readColor(keyword);
+            else if (keyword == "Ks")
+                material.specular = readColor(keyword);
+            else if (keyword == "Ke")
+                material.emissive = readColor(keyword);
+            else if (keyword == "Ns")
+                material.shininess = readFloat(keyword);
+            else if (keyword == "Ni")
+                material.ior = readFloat(keyword);
+            else if (keyword == "d")
+            {
+                // The halo option is ignored.
+                float value;
+                if (!reader.tryReadFloat(value))
+                {
+                    if (reader.token() != "-halo")
+                        throw ImporterError(path, "Line {}: Invalid value for '{}'.", line, keyword);
+                    value = readFloat(keyword);
+                }
+                material.opacity = value;
+            }
+            else if (keyword == "Tr")
+                material.opacity = 1.f - readFloat(keyword);
+            else if (keyword == "map_Kd")
+                material.diffuseMap = readMap();
+            else if (keyword == "map_Ks")
+                material.specularMap = readMap();
+            else if (keyword == "map_Ke")
+                material.emissiveMap = readMap();
+            else if (keyword == "norm" || keyword == "bump" || keyword == "map_bump" || keyword == "map_Bump")
+                material.normalMap = readMap();
+            else if (keyword == "map_d")
+                material.opacityMap = readMap();
+            // Other statements (Ka, illum, ...) are ignored.
+        }
+
+        return materials;
+    }
+}
@@ -0,0 +1,110 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Falcor
+{
+    /** Parser for Wavefront OBJ geometry and MTL material files.
+
+        OBJ files are parsed in parallel. The data is split into chunks at line boundaries. A first pass
+        counts the vertex statements of each chunk, so that the second pass can resolve relative indices
+        and write vertex data directly into the final arrays. Faces are split into meshes by group and
+        material. Each mesh is welded in parallel by hashing the per-corner (position, texCrd, normal)
+        index triples into a single index buffer.
+
+        Polygons are triangulated as fans. Texture coordinates are flipped vertically to Falcor's
+        convention. Points, lines, free-form geometry and smoothing groups are ignored.
+    */
+    class FALCOR_API ObjParser
+    {
+    public:
+        static constexpr size_t kDefaultChunkSize = 4 << 20;    ///< Default chunk size in bytes for parallel parsing.
+
+        /** Triangle mesh with welded vertices.
+        */
+        struct Mesh
+        {
+            std::string name;               ///< Name of the group (g) or object (o) the faces belong to.
+            std::string material;           ///< Name of the material (usemtl). Empty if none.
+            std::vector<float3> positions;
+            std::vector<float3> normals;    ///< Empty unless all faces have normals.
+            std::vector<float2> texCrds;    ///< Empty unless all faces have texture coordinates.
+            std::vector<uint32_t> indices;  ///< Triangle list.
+        };
+
+        struct Result
+        {
+            std::vector<Mesh> meshes;                   ///< Meshes in order of first appearance. Meshes without faces are omitted.
+            std::vector<std::string> materialLibraries; ///< Material libraries (mtllib) in order of appearance, relative to the OBJ file.
+        };
+
+        /** Material from an MTL file.
+            Defaults match the values used by other OBJ loaders for unspecified properties.
+        */
+        struct Material
+        {
+            std::string name;
+            float3 diffuse = float3(0.6f);  ///< Kd.
+            float3 specular = float3(0.f);  ///< Ks.
+            float3 emissive = float3(0.f);  ///< Ke.
+            float shininess = 0.f;          ///< Ns, the Phong exponent.
+            float opacity = 1.f;            ///< d, or 1 - Tr.
+            float ior = 1.f;                ///< Ni.
+            std::string diffuseMap;         ///< map_Kd.
+            std::string specularMap;        ///< map_Ks.
+            std::string emissiveMap;        ///< map_Ke.
+            std::string normalMap;          ///< norm, bump or map_Bump.
+            std::string opacityMap;         ///< map_d.
+        };
+
+        /** Parse an OBJ file.
+            Throws an ImporterError if the data is malformed.
+            \param[in] pData File contents.
+            \param[in] byteSize Size of the data in bytes.
+            \param[in] path Path used for error messages.
+            \param[in] chunkSize Approximate size in bytes of the chunks that are parsed in parallel.
+            \return Parsed meshes and referenced material libraries.
+        */
+        static Result parse(const void* pData, size_t byteSize, const std::filesystem::path& path, size_t chunkSize = kDefaultChunkSize);
+
+        /** Parse an MTL file.
+            Throws an ImporterError if the data is malformed.
+            \param[in] text File contents.
+            \param[in] path Path used for error messages.
+            \return Materials in order of appearance.
+        */
+        static std::vector<Material> parseMaterials(std::string_view text, const std::filesystem::path& path);
+    };
+}
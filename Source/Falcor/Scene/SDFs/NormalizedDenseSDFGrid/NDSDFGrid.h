@@ -74,5 +74,7 @@ namespace Falcor
         // GPU data.
         std::vector<ref<Texture>> mNDSDFTextures;
         std::shared_ptr<SharedData> mpSharedData; ///< Shared data among all instances.
+
+        friend class SceneCache;
     };
 }
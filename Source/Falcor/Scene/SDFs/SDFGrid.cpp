@@ -82,6 +82,9 @@ namespace Falcor
     {
         const std::string kEvaluateSDFPrimitivesShaderName = "Scene/SDFs/EvaluateSDFPrimitives.cs.slang";
 
+        // Dirty primitive ranges closer than this are merged into a single upload.
+        const uint32_t kPrimitivesUploadMaxGap = 16;
+
         const char kPrimitiveShapeTypeJSONKey[] = "shape_type";
         const char kPrimitiveShapeDataJSONKey[] = "shape_data";
         const char kPrimitiveShapeBlobbingJSONKey[] = "shape_blobbing";
@@ -167,36 +170,13 @@ namespace Falcor
 
         mGridWidth = gridWidth;
         mPrimitives.clear();
-        mPrimitiveIDToIndex.clear();
-        mNextPrimitiveID = 0;
 
         return addPrimitives(primitives);
     }
 
     uint32_t SDFGrid::addPrimitives(const std::vector<SDF3DPrimitive>& primitives)
     {
-        // Copy primitives.
-        uint32_t primitivesStartOffset = (uint32_t)mPrimitives.size();
-        mPrimitives.reserve(mPrimitives.size() + primitives.size());
-        mPrimitives.insert(mPrimitives.end(), primitives.begin(), primitives.end());
-
-        // Assign indirection.
-        mPrimitiveIDToIndex.reserve(mPrimitives.size());
-        uint32_t basePrimitiveID = mNextPrimitiveID;
-
-        for (uint32_t idx = primitivesStartOffset; idx < mPrimitives.size(); idx++)
-        {
-            mPrimitiveIDToIndex[mNextPrimitiveID++] = idx;
-        }
-
-        std::unordered_set<uint32_t> indexSet;
-        for (const auto& [id, index] : mPrimitiveIDToIndex)
-        {
-            if (!indexSet.insert(index).second)
-            {
-                FALCOR_THROW("Multiple copies of index {}!", index);
-            }
-        }
+        uint32_t basePrimitiveID = mPrimitives.add(primitives);
 
         mPrimitivesDirty = true;
 
@@ -207,78 +187,15 @@ namespace Falcor
 
     void SDFGrid::removePrimitives(const std::vector<uint32_t>& primitiveIDs)
     {
-        for (uint32_t primitiveID : primitiveIDs)
-        {
-            auto idxIt = mPrimitiveIDToIndex.find(primitiveID);
-
-            if (idxIt == mPrimitiveIDToIndex.end())
-            {
-                logWarning("Primitive with ID {} does not exist!", primitiveID);
-                continue;
-            }
-
-            // Mark as dirty.
-            mPrimitivesDirty = true;
-
-            // Baked primitives cannot be removed.
-            uint32_t idx = idxIt->second;
-            if (idx < mBakedPrimitiveCount)
-            {
-                logWarning("Primitive with ID {} has been baked, cannot remove it!", primitiveID);
-                continue;
-            }
-
-            // Erase the index from the indirection map.
-            mPrimitiveIDToIndex.erase(idxIt);
-
-            // Compactify the primitive list.
-            mPrimitives.erase(mPrimitives.begin() + idx);
-
-            if (idx < mPrimitives.size())
-            {
-                // Update larger IDs as the primitive list must be compact.
-                for (auto& [id, index] : mPrimitiveIDToIndex)
-                {
-                    if (index > idx)
-                    {
-                        --index;
-                    }
-                }
-            }
-        }
-
-        std::unordered_set<uint32_t> indexSet;
-        for (const auto& [id, index] : mPrimitiveIDToIndex)
-        {
-            if (!indexSet.insert(index).second)
-            {
-                FALCOR_THROW("Multiple copies of index {}!", index);
-            }
-        }
+        // Baked primitives cannot be removed, the store skips them with a warning.
+        if (mPrimitives.remove(primitiveIDs, mBakedPrimitiveCount) > 0) mPrimitivesDirty = true;
 
         updatePrimitivesBuffer();
     }
 
     void SDFGrid::updatePrimitives(const std::vector<std::pair<uint32_t, SDF3DPrimitive>>& primitives)
     {
-        for (auto it = primitives.begin(); it != primitives.end(); it++)
-        {
-            uint32_t primitiveID = it->first;
-            const SDF3DPrimitive& primitive = it->second;
-
-            auto idxIt = mPrimitiveIDToIndex.find(primitiveID);
-            if (idxIt == mPrimitiveIDToIndex.end())
-            {
-                logWarning("Primitive with ID {} does not exist!", primitiveID);
-                continue;
-            }
-
-            // Mark as dirty.
-            mPrimitivesDirty = true;
-
-            // Update the primitive.
-            mPrimitives[idxIt->second] = primitive;
-        }
+        if (mPrimitives.update(primitives) > 0) mPrimitivesDirty = true;
 
         updatePrimitivesBuffer();
     }
@@ -293,6 +210,7 @@ namespace Falcor
         }
 
         mGridWidth = gridWidth;
+        mValuesSource = ValuesSource::Memory;
 
         setValuesInternal(cornerValues);
     }
@@ -312,6 +230,8 @@ namespace Falcor
 
             file.close();
             setValues(cornerValues, gridWidth);
+            mValuesSource = ValuesSource::File;
+            mValuesPath = path;
 
             mInitializedWithPrimitives = false;
             return true;
@@ -371,6 +291,8 @@ namespace Falcor
         }
 
         setValues(cornerValues, gridWidth);
+        mValuesSource = ValuesSource::Cheese;
+        mCheeseSeed = seed;
     }
 
     bool SDFGrid::writeValuesFromPrimitivesToFile(const std::filesystem::path& path, RenderContext* pRenderContext)
@@ -387,7 +309,7 @@ namespace Falcor
 
         auto var = mpEvaluatePrimitivesPass->getRootVar();
         var["CB"]["gGridWidth"] = mGridWidth;
-        var["CB"]["gPrimitiveCount"] = (uint32_t)mPrimitives.size() - mBakedPrimitiveCount;
+        var["CB"]["gPrimitiveCount"] = mPrimitives.getCount() - mBakedPrimitiveCount;
         var["gPrimitives"] = mpPrimitivesBuffer;
         var["gOldValues"] = mHasGridRepresentation ? mpSDFGridTexture : nullptr;
         var["gValues"] = pValuesBuffer;
@@ -430,7 +352,7 @@ namespace Falcor
         setPrimitives(primitives, gridWidth);
 
         mInitializedWithPrimitives = true;
-        return (uint32_t)mPrimitives.size();
+        return mPrimitives.getCount();
     }
 
     bool SDFGrid::writePrimitivesToFile(const std::filesystem::path& path)
@@ -442,7 +364,7 @@ namespace Falcor
             return false;
         }
 
-        json j = mPrimitives;
+        json j = mPrimitives.getPrimitives();
         ofs << j.dump(4);
 
         ofs.close();
@@ -452,15 +374,13 @@ namespace Falcor
 
     const SDF3DPrimitive& SDFGrid::getPrimitive(uint32_t primitiveID) const
     {
-        auto it = mPrimitiveIDToIndex.find(primitiveID);
-        FALCOR_CHECK(it != mPrimitiveIDToIndex.end(), "'primitiveID' ({}) is invalid.", primitiveID);
-        return mPrimitives[it->second];
+        return mPrimitives.get(primitiveID);
     }
 
     void SDFGrid::bakePrimitives(uint32_t batchSize)
     {
         // The baking is deferred, and occurs in the SDFSBS class.
-        mBakedPrimitiveCount = std::min(mBakedPrimitiveCount + batchSize, (uint32_t)mPrimitives.size());
+        mBakedPrimitiveCount = std::min(mBakedPrimitiveCount + batchSize, mPrimitives.getCount());
 
         // Tell the SDFSBS grid to bake the primitives when its update function is called.
         mBakePrimitives = true;
@@ -559,17 +479,38 @@ namespace Falcor
 
     void SDFGrid::updatePrimitivesBuffer()
     {
-        if (mPrimitives.empty() || mPrimitives.size() <= mPrimitivesExcludedFromBuffer) return;
+        uint32_t primitiveCount = mPrimitives.getCount();
+        if (primitiveCount <= mPrimitivesExcludedFromBuffer)
+        {
+            mPrimitives.clearDirtyRanges();
+            return;
+        }
 
-        uint32_t count = (uint32_t)mPrimitives.size() - mPrimitivesExcludedFromBuffer;
-        void* pData = (void*)&mPrimitives[mPrimitivesExcludedFromBuffer];
+        const auto& primitives = mPrimitives.getPrimitives();
+        uint32_t offset = mPrimitivesExcludedFromBuffer;
+        uint32_t count = primitiveCount - offset;
+        const void* pData = &primitives[offset];
         if (!mpPrimitivesBuffer || mpPrimitivesBuffer->getElementCount() < count)
         {
             mpPrimitivesBuffer = mpDevice->createStructuredBuffer(sizeof(SDF3DPrimitive), count, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, pData, false);
         }
-        else
+        else if (offset != mPrimitivesBufferOffset)
         {
             mpPrimitivesBuffer->setBlob(pData, 0, count * sizeof(SDF3DPrimitive));
         }
+        else
+        {
+            // Only upload the primitives that changed since the last update. Small gaps are merged to reduce the number of copies.
+            for (const auto& range : mPrimitives.getDirtyRanges().getRanges(kPrimitivesUploadMaxGap))
+            {
+                uint32_t begin = std::max(range.begin, offset);
+                uint32_t end = std::min(range.end, primitiveCount);
+                if (begin >= end) continue;
+                mpPrimitivesBuffer->setBlob(&primitives[begin], (begin - offset) * sizeof(SDF3DPrimitive), (end - begin) * sizeof(SDF3DPrimitive));
+            }
+        }
+
+        mPrimitivesBufferOffset = offset;
+        mPrimitives.clearDirtyRanges();
     }
 }
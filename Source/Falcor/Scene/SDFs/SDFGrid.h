@@ -32,6 +32,7 @@
 #include "Core/API/Texture.h"
 #include "Core/Pass/ComputePass.h"
 #include "Scene/SDFs/SDF3DPrimitiveCommon.slang"
+#include "Scene/SDFs/SDFPrimitiveStore.h"
 #include <memory>
 #include <vector>
 #include <utility>
@@ -175,12 +176,16 @@ namespace Falcor
 
         /** Returns the number of primitives in the SDF grid.
         */
-        uint32_t getPrimitiveCount() const { return (uint32_t)mPrimitives.size(); }
+        uint32_t getPrimitiveCount() const { return mPrimitives.getCount(); }
 
         /** Returns the primitive corresponding to the given primitiveID.
         */
         const SDF3DPrimitive& getPrimitive(uint32_t primitiveID) const;
 
+        /** Returns the primitive store, which holds the primitives in evaluation order along with their IDs.
+        */
+        const SDFPrimitiveStore& getPrimitiveStore() const { return mPrimitives; }
+
         /** Returns the byte size of the SDF grid.
         */
         virtual size_t getSize() const = 0;
@@ -246,9 +251,8 @@ namespace Falcor
         uint32_t                mGridWidth = 0;
 
         // Primitive data.
-        std::vector<SDF3DPrimitive> mPrimitives;
-        std::unordered_map<uint32_t, uint32_t> mPrimitiveIDToIndex;
-        uint32_t                mNextPrimitiveID = 0;
+        SDFPrimitiveStore       mPrimitives;                        ///< Primitives in evaluation order, with stable IDs.
+        uint32_t                mPrimitivesBufferOffset = 0;        ///< Value of mPrimitivesExcludedFromBuffer when the primitive buffer was last written.
         bool                    mPrimitivesDirty = false;           ///< True if the primitives have changed.
         ref<Buffer>             mpPrimitivesBuffer;                 ///< Holds the primitives that should be rendered.
         uint32_t                mPrimitivesExcludedFromBuffer = 0;  ///< Number of primitives to exclude from the primitive buffer.
@@ -260,7 +264,22 @@ namespace Falcor
         ref<Texture>            mpSDFGridTexture;                   ///< A texture on the GPU holding the value representation.
         ref<ComputePass>        mpEvaluatePrimitivesPass;
 
+        /** Source of the value representation. This allows the grid to be re-created when the scene is serialized.
+        */
+        enum class ValuesSource : uint32_t
+        {
+            None,       ///< No values were set.
+            File,       ///< Values were loaded from mValuesPath.
+            Cheese,     ///< Values were generated by generateCheeseValues() with mCheeseSeed.
+            Memory,     ///< Values were set directly and are not retained.
+        };
+
+        ValuesSource            mValuesSource = ValuesSource::None;
+        std::filesystem::path   mValuesPath;                        ///< Path of the .sdfg file the values were loaded from.
+        uint32_t                mCheeseSeed = 0;                    ///< Seed used to generate the values.
+
         friend class Scene;
+        friend class SceneCache;
     };
 
     FALCOR_ENUM_CLASS_OPERATORS(SDFGrid::UpdateFlags);
@@ -0,0 +1,215 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFPrimitiveEvaluator.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Math/Matrix.h"
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <limits>
+#include <numeric>
+
+namespace Falcor
+{
+    namespace
+    {
+        // Ports of the functions in Utils/SDF/SDF3DShapes.slang and Utils/SDF/SDFOperations.slang.
+
+        float saturate(float x) { return std::clamp(x, 0.f, 1.f); }
+        float signOf(float x) { return float((x > 0.f) - (x < 0.f)); }
+
+        float sdfSphere(const float3& p, float r) { return length(p) - r; }
+
+        float sdfEllipsoid(const float3& p, const float3& r)
+        {
+            float k0 = length(p / r);
+            float k1 = length(p / (r * r));
+            return k0 * (k0 - 1.f) / k1;
+        }
+
+        float sdfBox(const float3& p, const float3& b)
+        {
+            float3 q = abs(p) - b;
+            return length(max(q, float3(0.f))) + std::min(std::max(std::max(q.x, q.y), q.z), 0.f);
+        }
+
+        float sdfTorus(const float3& p, float r) { return length(float2(length(float2(p.x, p.z)) - r, p.y)); }
+
+        float sdfCone(const float3& p, float tan, float h)
+        {
+            float2 q = h * float2(tan, -1.f);
+            float2 w = float2(length(float2(p.x, p.z)), p.y - 0.5f * h);
+            float2 a = w - q * saturate(dot(w, q) / dot(q, q));
+            float2 b = w - q * float2(saturate(w.x / q.x), 1.f);
+            float k = signOf(q.y);
+            float d = std::min(dot(a, a), dot(b, b));
+            float s = std::max(k * (w.x * q.y - w.y * q.x), k * (w.y - q.y));
+            return std::sqrt(d) * signOf(s);
+        }
+
+        float sdfCapsule(float3 p, float hl)
+        {
+            p.y -= std::clamp(p.y, -hl, hl);
+            return length(p);
+        }
+
+        float smin(float a, float b, float k)
+        {
+            float h = std::max(k - std::abs(a - b), 0.f);
+            return std::min(a, b) - h * h * 0.25f / k;
+        }
+
+        float smax(float a, float b, float k)
+        {
+            float h = std::max(k - std::abs(a - b), 0.f);
+            return std::max(a, b) + h * h * 0.25f / k;
+        }
+
+        float3 getValuePosition(const uint3& coords, uint32_t gridWidth)
+        {
+            return -0.5f + float3(coords) / float(gridWidth);
+        }
+    }
+
+    float SDFPrimitiveEvaluator::evalShape(const SDF3DPrimitive& primitive, const float3& pGrid)
+    {
+        // Same transform as SDF3DPrimitive::evalShape(), including the transpose.
+        float3 p = mul(transpose(primitive.invRotationScale), pGrid - primitive.translation);
+        const float3& data = primitive.shapeData;
+        float d = std::numeric_limits<float>::max();
+
+        switch (primitive.shapeType)
+        {
+        case SDF3DShapeType::Sphere:    d = sdfSphere(p, data.x); break;
+        case SDF3DShapeType::Ellipsoid: d = sdfEllipsoid(p, data); break;
+        case SDF3DShapeType::Box:       d = sdfBox(p, data); break;
+        case SDF3DShapeType::Torus:     d = sdfTorus(p, data.x); break;
+        case SDF3DShapeType::Cone:      d = sdfCone(p, data.x, data.y); break;
+        case SDF3DShapeType::Capsule:   d = sdfCapsule(p, data.x); break;
+        default: FALCOR_THROW("SDF Primitive has unknown primitive type");
+        }
+
+        return d - primitive.shapeBlobbing;
+    }
+
+    float SDFPrimitiveEvaluator::evalOperation(SDFOperationType operationType, float d, float dShape, float smoothing)
+    {
+        switch (operationType)
+        {
+        case SDFOperationType::Union:               return std::min(d, dShape);
+        case SDFOperationType::Subtraction:         return std::max(d, -dShape);
+        case SDFOperationType::Intersection:        return std::max(d, dShape);
+        case SDFOperationType::SmoothUnion:         return smin(d, dShape, smoothing);
+        case SDFOperationType::SmoothSubtraction:   return smax(d, -dShape, smoothing);
+        case SDFOperationType::SmoothIntersection:  return smax(d, dShape, smoothing);
+        default: FALCOR_THROW("SDF Primitive has unknown operation type");
+        }
+    }
+
+    float SDFPrimitiveEvaluator::eval(const std::vector<SDF3DPrimitive>& primitives, const std::vector<uint32_t>& indices, const float3& p, float narrowBand)
+    {
+        float d = narrowBand;
+        for (uint32_t index : indices)
+        {
+            const SDF3DPrimitive& primitive = primitives[index];
+            d = evalOperation(primitive.operationType, d, evalShape(primitive, p), primitive.operationSmoothing);
+            d = std::clamp(d, -narrowBand, narrowBand);
+        }
+        return d;
+    }
+
+    std::vector<float> SDFPrimitiveEvaluator::evaluateGrid(const SDFPrimitiveStore& store, uint32_t gridWidth, float narrowBand)
+    {
+        const uint32_t valuesPerAxis = gridWidth + 1;
+        std::vector<float> values(size_t(valuesPerAxis) * valuesPerAxis * valuesPerAxis);
+
+        std::vector<uint32_t> indices(store.getCount());
+        std::iota(indices.begin(), indices.end(), 0u);
+
+        NumericRange<uint32_t> sliceRange(0, valuesPerAxis);
+        std::for_each(std::execution::par, sliceRange.begin(), sliceRange.end(), [&](uint32_t z)
+        {
+            for (uint32_t y = 0; y < valuesPerAxis; y++)
+            {
+                for (uint32_t x = 0; x < valuesPerAxis; x++)
+                {
+                    size_t offset = x + size_t(valuesPerAxis) * (y + size_t(valuesPerAxis) * z);
+                    values[offset] = eval(store.getPrimitives(), indices, getValuePosition(uint3(x, y, z), gridWidth), narrowBand);
+                }
+            }
+        });
+
+        return values;
+    }
+
+    uint32_t SDFPrimitiveEvaluator::evaluateDirtyChunks(const SDFPrimitiveStore& store, std::vector<float>& values)
+    {
+        FALCOR_CHECK(store.hasChunkIndex(), "The primitive store has no spatial index.");
+
+        const uint32_t gridWidth = store.getGridWidth();
+        const uint32_t chunkWidth = store.getChunkWidth();
+        const uint32_t chunksPerAxis = store.getChunksPerAxis();
+        const uint32_t valuesPerAxis = gridWidth + 1;
+        const float narrowBand = store.getNarrowBand();
+
+        if (values.size() != size_t(valuesPerAxis) * valuesPerAxis * valuesPerAxis)
+        {
+            values = evaluateGrid(store, gridWidth, narrowBand);
+            return chunksPerAxis * chunksPerAxis * chunksPerAxis;
+        }
+
+        std::vector<uint32_t> dirtyChunks = store.getDirtyChunks();
+
+        NumericRange<size_t> chunkRange(0, dirtyChunks.size());
+        std::for_each(std::execution::par, chunkRange.begin(), chunkRange.end(), [&](size_t i)
+        {
+            uint32_t chunk = dirtyChunks[i];
+            uint3 chunkCoords(chunk % chunksPerAxis, (chunk / chunksPerAxis) % chunksPerAxis, chunk / (chunksPerAxis * chunksPerAxis));
+            uint3 begin = chunkCoords * chunkWidth;
+            uint3 end = min(begin + chunkWidth, uint3(valuesPerAxis));
+
+            std::vector<uint32_t> indices;
+            store.getChunkPrimitiveIndices(chunk, indices);
+
+            for (uint32_t z = begin.z; z < end.z; z++)
+            {
+                for (uint32_t y = begin.y; y < end.y; y++)
+                {
+                    for (uint32_t x = begin.x; x < end.x; x++)
+                    {
+                        size_t offset = x + size_t(valuesPerAxis) * (y + size_t(valuesPerAxis) * z);
+                        values[offset] = eval(store.getPrimitives(), indices, getValuePosition(uint3(x, y, z), gridWidth), narrowBand);
+                    }
+                }
+            }
+        });
+
+        return (uint32_t)dirtyChunks.size();
+    }
+}
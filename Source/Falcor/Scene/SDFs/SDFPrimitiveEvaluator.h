@@ -0,0 +1,82 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SDF3DPrimitiveCommon.slang"
+#include "SDFPrimitiveStore.h"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** CPU evaluation of SDF primitives on the values of an SDF grid.
+        This mirrors the shape and operation functions used by the GPU passes and is intended for verification and tools.
+
+        Values are kept in a narrow band: evaluation starts at +narrowBand and the result of each operation is clamped
+        to [-narrowBand, narrowBand]. For union and subtraction this gives the same result as clamping the unbounded
+        distance, and it makes evaluation local: primitives only change values inside their influence bounds
+        (see SDFPrimitiveStore::computeInfluenceBounds()), so edits only require re-evaluating the chunks they touch.
+        The grid has (gridWidth + 1)^3 values, stored with x varying fastest, at positions -0.5 + coords / gridWidth.
+    */
+    class FALCOR_API SDFPrimitiveEvaluator
+    {
+    public:
+        /** Evaluate the distance to the shape of a primitive.
+        */
+        static float evalShape(const SDF3DPrimitive& primitive, const float3& p);
+
+        /** Combine a distance with the distance to a shape.
+        */
+        static float evalOperation(SDFOperationType operationType, float d, float dShape, float smoothing);
+
+        /** Evaluate the narrow band value at a point.
+            \param[in] primitives Primitives in evaluation order.
+            \param[in] indices Indices of the primitives to evaluate, in order.
+            \param[in] p Position in grid space.
+            \param[in] narrowBand Half width of the narrow band.
+        */
+        static float eval(const std::vector<SDF3DPrimitive>& primitives, const std::vector<uint32_t>& indices, const float3& p, float narrowBand);
+
+        /** Evaluate all values of a grid using all primitives.
+            \param[in] store Primitive store.
+            \param[in] gridWidth Grid width in voxels.
+            \param[in] narrowBand Half width of the narrow band.
+            \return (gridWidth + 1)^3 values.
+        */
+        static std::vector<float> evaluateGrid(const SDFPrimitiveStore& store, uint32_t gridWidth, float narrowBand);
+
+        /** Re-evaluate the values in the dirty chunks of the store's spatial index, using only the primitives that influence each chunk.
+            The dirty chunks are not cleared.
+            \param[in] store Primitive store with the spatial index enabled.
+            \param[in,out] values Values of the grid the index was created for. Resized and fully evaluated if the size doesn't match.
+            \return Number of evaluated chunks.
+        */
+        static uint32_t evaluateDirtyChunks(const SDFPrimitiveStore& store, std::vector<float>& values);
+    };
+}
@@ -0,0 +1,305 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFPrimitiveStore.h"
+#include "SDF3DPrimitiveFactory.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace Falcor
+{
+    namespace
+    {
+        bool isIntersection(SDFOperationType operationType)
+        {
+            return operationType == SDFOperationType::Intersection || operationType == SDFOperationType::SmoothIntersection;
+        }
+
+        void insertSorted(std::vector<uint32_t>& ids, uint32_t id)
+        {
+            ids.insert(std::lower_bound(ids.begin(), ids.end(), id), id);
+        }
+
+        void eraseSorted(std::vector<uint32_t>& ids, uint32_t id)
+        {
+            auto it = std::lower_bound(ids.begin(), ids.end(), id);
+            if (it != ids.end() && *it == id) ids.erase(it);
+        }
+    }
+
+    uint32_t SDFPrimitiveStore::add(const std::vector<SDF3DPrimitive>& primitives)
+    {
+        uint32_t baseID = mNextID;
+        uint32_t baseIndex = getCount();
+
+        mPrimitives.insert(mPrimitives.end(), primitives.begin(), primitives.end());
+        mIndexToID.reserve(mPrimitives.size());
+        mIDToIndex.reserve(mPrimitives.size());
+
+        for (uint32_t index = baseIndex; index < getCount(); index++)
+        {
+            uint32_t id = mNextID++;
+            mIndexToID.push_back(id);
+            mIDToIndex[id] = index;
+            if (hasChunkIndex()) updateChunks(id, mPrimitives[index], true);
+        }
+
+        mDirtyRanges.markDirty(baseIndex, getCount());
+        return baseID;
+    }
+
+    uint32_t SDFPrimitiveStore::remove(const std::vector<uint32_t>& primitiveIDs, uint32_t firstRemovableIndex)
+    {
+        // Flag the primitives to remove, then compact the array in a single pass.
+        std::vector<bool> removeFlags(mPrimitives.size(), false);
+        uint32_t firstRemoved = kInvalidIndex;
+
+        for (uint32_t primitiveID : primitiveIDs)
+        {
+            uint32_t index = getIndex(primitiveID);
+            if (index == kInvalidIndex)
+            {
+                logWarning("Primitive with ID {} does not exist!", primitiveID);
+                continue;
+            }
+            if (index < firstRemovableIndex)
+            {
+                logWarning("Primitive with ID {} has been baked, cannot remove it!", primitiveID);
+                continue;
+            }
+            removeFlags[index] = true;
+            firstRemoved = std::min(firstRemoved, index);
+        }
+
+        if (firstRemoved == kInvalidIndex) return 0;
+
+        uint32_t dst = firstRemoved;
+        for (uint32_t src = firstRemoved; src < getCount(); src++)
+        {
+            uint32_t id = mIndexToID[src];
+            if (removeFlags[src])
+            {
+                if (hasChunkIndex()) updateChunks(id, mPrimitives[src], false);
+                mIDToIndex.erase(id);
+                continue;
+            }
+            mPrimitives[dst] = mPrimitives[src];
+            mIndexToID[dst] = id;
+            mIDToIndex[id] = dst;
+            dst++;
+        }
+
+        uint32_t removedCount = getCount() - dst;
+        mPrimitives.resize(dst);
+        mIndexToID.resize(dst);
+
+        // All primitives after the first removed one moved.
+        mDirtyRanges.markDirty(firstRemoved, getCount());
+        return removedCount;
+    }
+
+    uint32_t SDFPrimitiveStore::update(const std::vector<std::pair<uint32_t, SDF3DPrimitive>>& primitives)
+    {
+        uint32_t updatedCount = 0;
+        for (const auto& [primitiveID, primitive] : primitives)
+        {
+            uint32_t index = getIndex(primitiveID);
+            if (index == kInvalidIndex)
+            {
+                logWarning("Primitive with ID {} does not exist!", primitiveID);
+                continue;
+            }
+
+            if (hasChunkIndex())
+            {
+                updateChunks(primitiveID, mPrimitives[index], false);
+                updateChunks(primitiveID, primitive, true);
+            }
+            mPrimitives[index] = primitive;
+            mDirtyRanges.markDirty(index);
+            updatedCount++;
+        }
+        return updatedCount;
+    }
+
+    void SDFPrimitiveStore::clear()
+    {
+        mPrimitives.clear();
+        mIndexToID.clear();
+        mIDToIndex.clear();
+        mNextID = 0;
+        mDirtyRanges.clear();
+
+        if (hasChunkIndex())
+        {
+            for (auto& ids : mChunkPrimitiveIDs) ids.clear();
+            mGlobalPrimitiveIDs.clear();
+            markAllChunksDirty();
+        }
+    }
+
+    const SDF3DPrimitive& SDFPrimitiveStore::get(uint32_t primitiveID) const
+    {
+        uint32_t index = getIndex(primitiveID);
+        FALCOR_CHECK(index != kInvalidIndex, "'primitiveID' ({}) is invalid.", primitiveID);
+        return mPrimitives[index];
+    }
+
+    uint32_t SDFPrimitiveStore::getIndex(uint32_t primitiveID) const
+    {
+        auto it = mIDToIndex.find(primitiveID);
+        return it != mIDToIndex.end() ? it->second : kInvalidIndex;
+    }
+
+    void SDFPrimitiveStore::enableChunkIndex(uint32_t gridWidth, uint32_t chunkWidth, float narrowBand)
+    {
+        FALCOR_CHECK(gridWidth > 0, "'gridWidth' must be larger than zero.");
+        FALCOR_CHECK(chunkWidth > 0, "'chunkWidth' must be larger than zero.");
+        FALCOR_CHECK(narrowBand > 0.f, "'narrowBand' must be positive.");
+
+        mGridWidth = gridWidth;
+        mChunkWidth = chunkWidth;
+        mChunksPerAxis = (gridWidth + chunkWidth) / chunkWidth; // The grid has gridWidth + 1 values per axis.
+        mNarrowBand = narrowBand;
+
+        uint32_t chunkCount = mChunksPerAxis * mChunksPerAxis * mChunksPerAxis;
+        mChunkPrimitiveIDs.assign(chunkCount, {});
+        mGlobalPrimitiveIDs.clear();
+        mChunkDirty.assign(chunkCount, false);
+        mDirtyChunks.clear();
+
+        for (uint32_t index = 0; index < getCount(); index++) updateChunks(mIndexToID[index], mPrimitives[index], true);
+        markAllChunksDirty();
+    }
+
+    void SDFPrimitiveStore::getChunkPrimitiveIndices(uint32_t chunkIndex, std::vector<uint32_t>& indices) const
+    {
+        FALCOR_ASSERT(chunkIndex < mChunkPrimitiveIDs.size());
+        const auto& chunkIDs = mChunkPrimitiveIDs[chunkIndex];
+
+        // IDs increase with the evaluation order, so merging the sorted lists yields the primitives in order.
+        indices.clear();
+        indices.reserve(chunkIDs.size() + mGlobalPrimitiveIDs.size());
+        std::merge(chunkIDs.begin(), chunkIDs.end(), mGlobalPrimitiveIDs.begin(), mGlobalPrimitiveIDs.end(), std::back_inserter(indices));
+        for (auto& index : indices) index = mIDToIndex.at(index);
+    }
+
+    std::vector<uint32_t> SDFPrimitiveStore::getDirtyChunks() const
+    {
+        std::vector<uint32_t> chunks = mDirtyChunks;
+        std::sort(chunks.begin(), chunks.end());
+        return chunks;
+    }
+
+    void SDFPrimitiveStore::clearDirtyChunks()
+    {
+        for (uint32_t chunk : mDirtyChunks) mChunkDirty[chunk] = false;
+        mDirtyChunks.clear();
+    }
+
+    AABB SDFPrimitiveStore::computeInfluenceBounds(const SDF3DPrimitive& primitive, float narrowBand)
+    {
+        if (isIntersection(primitive.operationType))
+        {
+            return AABB(float3(-std::numeric_limits<float>::infinity()), float3(std::numeric_limits<float>::infinity()));
+        }
+
+        // The shape bounds include blobbing and operation smoothing. Outside of them, the shape distance exceeds the smoothing,
+        // and it grows by at least the distance to the bounds divided by the largest scale of the primitive.
+        // The Frobenius norm of the rotation and scale matrix bounds that scale from above.
+        AABB bounds = SDF3DPrimitiveFactory::computeAABB(primitive);
+        float3x3 rotationScale = inverse(primitive.invRotationScale);
+        float maxScale = 0.f;
+        for (int r = 0; r < 3; r++) maxScale += dot(rotationScale[r], rotationScale[r]);
+        maxScale = std::sqrt(maxScale);
+
+        float margin = narrowBand * maxScale;
+        return AABB(bounds.minPoint - margin, bounds.maxPoint + margin);
+    }
+
+    bool SDFPrimitiveStore::getChunkRange(const AABB& bounds, uint3& minChunk, uint3& maxChunk) const
+    {
+        // Find the values inside the bounds. A small tolerance keeps values on the boundary.
+        const double kTolerance = 1e-3;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            double minCoord = std::ceil((double(bounds.minPoint[axis]) + 0.5) * mGridWidth - kTolerance);
+            double maxCoord = std::floor((double(bounds.maxPoint[axis]) + 0.5) * mGridWidth + kTolerance);
+            minCoord = std::max(minCoord, 0.0);
+            maxCoord = std::min(maxCoord, double(mGridWidth));
+            if (minCoord > maxCoord) return false;
+            minChunk[axis] = uint32_t(minCoord) / mChunkWidth;
+            maxChunk[axis] = uint32_t(maxCoord) / mChunkWidth;
+        }
+        return true;
+    }
+
+    void SDFPrimitiveStore::updateChunks(uint32_t primitiveID, const SDF3DPrimitive& primitive, bool insert)
+    {
+        if (isIntersection(primitive.operationType))
+        {
+            if (insert) insertSorted(mGlobalPrimitiveIDs, primitiveID);
+            else eraseSorted(mGlobalPrimitiveIDs, primitiveID);
+            markAllChunksDirty();
+            return;
+        }
+
+        uint3 minChunk, maxChunk;
+        if (!getChunkRange(computeInfluenceBounds(primitive, mNarrowBand), minChunk, maxChunk)) return;
+
+        for (uint32_t z = minChunk.z; z <= maxChunk.z; z++)
+        {
+            for (uint32_t y = minChunk.y; y <= maxChunk.y; y++)
+            {
+                for (uint32_t x = minChunk.x; x <= maxChunk.x; x++)
+                {
+                    uint32_t chunk = x + mChunksPerAxis * (y + mChunksPerAxis * z);
+                    if (insert) insertSorted(mChunkPrimitiveIDs[chunk], primitiveID);
+                    else eraseSorted(mChunkPrimitiveIDs[chunk], primitiveID);
+
+                    if (!mChunkDirty[chunk])
+                    {
+                        mChunkDirty[chunk] = true;
+                        mDirtyChunks.push_back(chunk);
+                    }
+                }
+            }
+        }
+    }
+
+    void SDFPrimitiveStore::markAllChunksDirty()
+    {
+        if (mDirtyChunks.size() == mChunkDirty.size()) return;
+        std::fill(mChunkDirty.begin(), mChunkDirty.end(), true);
+        mDirtyChunks.resize(mChunkDirty.size());
+        std::iota(mDirtyChunks.begin(), mDirtyChunks.end(), 0u);
+    }
+}
@@ -0,0 +1,161 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SDF3DPrimitiveCommon.slang"
+#include "Core/Macros.h"
+#include "Utils/DirtyRangeTracker.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace Falcor
+{
+    /** Ordered store of SDF primitives with stable IDs.
+        Primitives are evaluated in the order they were added, so the store keeps them in a compact array in that order.
+        Each primitive has an ID that stays valid until the primitive is removed. IDs increase with the evaluation order.
+        Removals are batched and compact the array in a single pass.
+
+        The store tracks which elements of the array changed, so that a GPU copy can be updated incrementally.
+        Optionally, it also maintains a spatial index over the chunks of an SDF grid. The index lists, for each chunk,
+        the primitives that may change the narrow band values in it (see computeInfluenceBounds()). It tracks which chunks
+        were touched by edits, so that only those need to be re-evaluated.
+    */
+    class FALCOR_API SDFPrimitiveStore
+    {
+    public:
+        static constexpr uint32_t kInvalidIndex = uint32_t(-1);
+
+        /** Add primitives after all existing ones.
+            \param[in] primitives Primitives to add.
+            \return ID of the first added primitive. The added primitives have consecutive IDs.
+        */
+        uint32_t add(const std::vector<SDF3DPrimitive>& primitives);
+
+        /** Remove primitives. The order of the remaining primitives is preserved.
+            Unknown IDs and primitives before 'firstRemovableIndex' are skipped with a warning.
+            \param[in] primitiveIDs IDs of the primitives to remove.
+            \param[in] firstRemovableIndex Index of the first primitive that may be removed, e.g. the number of baked primitives.
+            \return Number of removed primitives.
+        */
+        uint32_t remove(const std::vector<uint32_t>& primitiveIDs, uint32_t firstRemovableIndex = 0);
+
+        /** Replace primitives. Unknown IDs are skipped with a warning.
+            \param[in] primitives Pairs of primitive ID and new primitive.
+            \return Number of updated primitives.
+        */
+        uint32_t update(const std::vector<std::pair<uint32_t, SDF3DPrimitive>>& primitives);
+
+        /** Remove all primitives and restart IDs from zero. The spatial index settings are kept.
+        */
+        void clear();
+
+        uint32_t getCount() const { return (uint32_t)mPrimitives.size(); }
+        bool isEmpty() const { return mPrimitives.empty(); }
+
+        /** Get the primitives in evaluation order.
+        */
+        const std::vector<SDF3DPrimitive>& getPrimitives() const { return mPrimitives; }
+
+        /** Get a primitive by ID. Throws if the ID is invalid.
+        */
+        const SDF3DPrimitive& get(uint32_t primitiveID) const;
+
+        /** Get the index of a primitive in the evaluation order, or kInvalidIndex if the ID is invalid.
+        */
+        uint32_t getIndex(uint32_t primitiveID) const;
+
+        /** Get the ID of the primitive at an index.
+        */
+        uint32_t getID(uint32_t index) const { FALCOR_ASSERT(index < mIndexToID.size()); return mIndexToID[index]; }
+
+        /** Get the elements of the primitive array that changed since the last call to clearDirtyRanges().
+        */
+        const DirtyRangeTracker& getDirtyRanges() const { return mDirtyRanges; }
+        void clearDirtyRanges() { mDirtyRanges.clear(); }
+
+        /** Enable the spatial index over the chunks of an SDF grid.
+            The grid has (gridWidth + 1)^3 values at voxel corners, covering [-0.5, 0.5]^3. Chunks are cubes of chunkWidth^3 values.
+            Enabling the index marks all chunks dirty.
+            \param[in] gridWidth Grid width in voxels.
+            \param[in] chunkWidth Chunk width in values.
+            \param[in] narrowBand Half width of the narrow band in grid space. Values are clamped to it.
+        */
+        void enableChunkIndex(uint32_t gridWidth, uint32_t chunkWidth, float narrowBand);
+
+        bool hasChunkIndex() const { return mChunkWidth > 0; }
+        uint32_t getGridWidth() const { return mGridWidth; }
+        uint32_t getChunkWidth() const { return mChunkWidth; }
+        uint32_t getChunksPerAxis() const { return mChunksPerAxis; }
+        float getNarrowBand() const { return mNarrowBand; }
+
+        /** Get the indices of the primitives that may change the values in a chunk, in evaluation order.
+            This includes the primitives that affect all chunks (intersections).
+            \param[in] chunkIndex Flattened chunk index (x + chunksPerAxis * (y + chunksPerAxis * z)).
+            \param[out] indices Primitive indices.
+        */
+        void getChunkPrimitiveIndices(uint32_t chunkIndex, std::vector<uint32_t>& indices) const;
+
+        /** Get the chunks touched by edits since the last call to clearDirtyChunks(), sorted by flattened index.
+        */
+        std::vector<uint32_t> getDirtyChunks() const;
+        void clearDirtyChunks();
+
+        /** Compute the bounds outside of which a primitive can't change narrow band values.
+            At points outside the bounds, the primitive's distance is at least narrowBand plus its operation smoothing,
+            so union and subtraction operations leave clamped values unchanged.
+            \param[in] primitive Primitive.
+            \param[in] narrowBand Half width of the narrow band.
+            \return Bounds in grid space, or an infinite box for intersections, which affect all values.
+        */
+        static AABB computeInfluenceBounds(const SDF3DPrimitive& primitive, float narrowBand);
+
+    private:
+        bool getChunkRange(const AABB& bounds, uint3& minChunk, uint3& maxChunk) const;
+        void updateChunks(uint32_t primitiveID, const SDF3DPrimitive& primitive, bool insert);
+        void markAllChunksDirty();
+
+        std::vector<SDF3DPrimitive> mPrimitives;                ///< Primitives in evaluation order.
+        std::vector<uint32_t> mIndexToID;                       ///< Primitive ID for each index.
+        std::unordered_map<uint32_t, uint32_t> mIDToIndex;      ///< Index for each primitive ID.
+        uint32_t mNextID = 0;
+        DirtyRangeTracker mDirtyRanges;
+
+        // Spatial index.
+        uint32_t mGridWidth = 0;
+        uint32_t mChunkWidth = 0;
+        uint32_t mChunksPerAxis = 0;
+        float mNarrowBand = 0.f;
+        std::vector<std::vector<uint32_t>> mChunkPrimitiveIDs;  ///< Sorted IDs of the primitives influencing each chunk.
+        std::vector<uint32_t> mGlobalPrimitiveIDs;              ///< Sorted IDs of the primitives influencing all chunks.
+        std::vector<bool> mChunkDirty;                          ///< Dirty flag for each chunk.
+        std::vector<uint32_t> mDirtyChunks;                     ///< Unsorted list of dirty chunks.
+    };
+}
@@ -100,8 +100,8 @@ namespace Falcor
     SDFGrid::UpdateFlags SDFSBS::update(RenderContext* pRenderContext)
     {
         // No update is performed if the SDF grid isn't dirty or isn't constructed from primitives and should not be created as an empty grid.
-        bool isEmpty = mPrimitives.empty() && !mpSDFGridTexture && !mWasEmpty;
-        if ((!mPrimitivesDirty || (mPrimitives.empty() && !mHasGridRepresentation)) && !isEmpty) return UpdateFlags::None;
+        bool isEmpty = mPrimitives.isEmpty() && !mpSDFGridTexture && !mWasEmpty;
+        if ((!mPrimitivesDirty || (mPrimitives.isEmpty() && !mHasGridRepresentation)) && !isEmpty) return UpdateFlags::None;
 
         // Update grid texture, if user loads an sdf-file.
         if (!mSDField.empty())
@@ -123,11 +123,11 @@ namespace Falcor
             mSDField.clear();
         }
 
-        if (!mPrimitives.empty())
+        if (!mPrimitives.isEmpty())
         {
             createResourcesFromPrimitivesAndSDField(pRenderContext, deleteScratchData);
         }
-        else if (mPrimitives.empty() && mpSDFGridTexture != nullptr)
+        else if (mPrimitives.isEmpty() && mpSDFGridTexture != nullptr)
         {
             createResourcesFromSDField(pRenderContext, deleteScratchData);
         }
@@ -170,6 +170,7 @@ namespace Falcor
     void SDFSBS::createResourcesFromSDField(RenderContext* pRenderContext, bool deleteScratchData)
     {
         FALCOR_ASSERT(mpSDFGridTexture && mpSDFGridTexture->getWidth() == mGridWidth + 1);
+        mCanReuseBricks = false;
 
         // Calculate the maximum number of bricks that could be created.
         mVirtualBricksPerAxis = std::max(mVirtualBricksPerAxis, (uint32_t)std::ceil(float(mGridWidth) / mBrickWidth));
@@ -359,6 +360,8 @@ namespace Falcor
         // Assume AABBs will change.
         UpdateFlags updateFlags = UpdateFlags::AABBsChanged;
         uint32_t oldGridWidthInValues = mGridWidth + 1;
+        bool canReuseBricks = mCanReuseBricks;
+        mCanReuseBricks = false;
 
         // Calculate new width that encapsulate both the values and primitives to form a grid of bricks.
         uint32_t subdivisionCount = (uint32_t)std::ceil(std::log2((float)mGridWidth / mBrickWidth) / std::log2((float)kChunkWidth));
@@ -370,6 +373,15 @@ namespace Falcor
         if (oldGridWidthInValues != gridWidthInValues)
         {
             logInfo("Updated grid width of SDF Grid from {} to {}.", oldGridWidthInValues-1, mGridWidth);
+            canReuseBricks = false;
+        }
+
+        // Index the primitives by the bricks they can change. The chunks of the index cover the values of the bricks,
+        // and the narrow band matches the clamping of the brick values (see SDFSBSCreateBricksFromChunks.cs.slang).
+        if (!mPrimitives.hasChunkIndex() || mPrimitives.getGridWidth() != mGridWidth || mPrimitives.getChunkWidth() != mBrickWidth)
+        {
+            mPrimitives.enableChunkIndex(mGridWidth, mBrickWidth, std::sqrt(3.f) / (2.f * mGridWidth));
+            canReuseBricks = false;
         }
 
         // Check if the primitives should be combined with the values.
@@ -389,7 +401,7 @@ namespace Falcor
 
         bool createEmptyBrick = false;
         // Check if the SDF grid is empty, if it is, create one brick with no surface to make the renderer happy.
-        if ((mPrimitives.empty() && !includeValues && !mWasEmpty) || mBuildEmptyGrid)
+        if ((mPrimitives.isEmpty() && !includeValues && !mWasEmpty) || mBuildEmptyGrid)
         {
             mBrickCount = 1;
             if (!mpChunkCoordsBuffer || mpChunkCoordsBuffer->getSize() < mBrickCount * sizeof(uint3))
@@ -402,6 +414,13 @@ namespace Falcor
             mBuildEmptyGrid = false;
         }
 
+        // The bricks of the previous build can be reused where no primitive was edited, unless the values changed.
+        bool bakePrimitives = includeValues && mBakePrimitives && mCurrentBakedPrimitiveCount != mBakedPrimitiveCount;
+        bool reuseBricks = canReuseBricks && !createEmptyBrick && !mSDFieldUpdated && !bakePrimitives;
+        std::vector<uint32_t> dirtyBrickMask;
+        if (reuseBricks) dirtyBrickMask = computeDirtyBrickMask();
+        mPrimitives.clearDirtyChunks();
+
         if (includeValues)
         {
             // Only expand sdf grid texture if the size has changed.
@@ -479,7 +498,7 @@ namespace Falcor
             }
         }
 
-        uint32_t primitiveCount = (uint32_t)mPrimitives.size();
+        uint32_t primitiveCount = mPrimitives.getCount();
 
         // Create or update primitives buffer.
         {
@@ -646,6 +665,18 @@ namespace Falcor
                 compactifyChunks(pRenderContext, currentSubChunkCount);
             }
 
+            // Keep the bricks of the previous build, so that the brick passes can copy the ones outside of the edited chunks.
+            reuseBricks = reuseBricks && mBrickCount != 0;
+            if (reuseBricks) prepareBrickReuse(pRenderContext, dirtyBrickMask);
+
+            auto bindBrickReuseData = [&](const ShaderVar& paramBlock)
+            {
+                paramBlock["reuseBricks"] = reuseBricks;
+                paramBlock["virtualBricksPerAxis"] = mVirtualBricksPerAxis;
+                paramBlock["dirtyBrickMask"] = reuseBricks ? mpDirtyBrickMaskBuffer : nullptr;
+                paramBlock["prevIndirectionBuffer"] = reuseBricks ? mpPrevIndirectionTexture : nullptr;
+            };
+
             // Coarsely prune empty bricks.
             if (kEnableCoarseBrickPruning && !createEmptyBrick && mBrickCount != 0)
             {
@@ -656,6 +687,7 @@ namespace Falcor
                     pRenderContext->copyBufferRegion(mpSubChunkCoordsBuffer.get(), 0, mpChunkCoordsBuffer.get(), 0, preCoarsePruningBrickCount * sizeof(uint3));
 
                     auto paramBlock = mpCoarselyPruneEmptyBricks->getRootVar()["gParamBlock"];
+                    bindBrickReuseData(paramBlock);
                     paramBlock["primitiveCount"] = primitiveCount - mCurrentBakedPrimitiveCount;
                     paramBlock["gridWidth"] = mGridWidth;
                     paramBlock["brickCount"] = preCoarsePruningBrickCount;
@@ -686,6 +718,7 @@ namespace Falcor
                     pRenderContext->copyBufferRegion(mpSubChunkCoordsBuffer.get(), 0, mpChunkCoordsBuffer.get(), 0, preFinePruningBrickCount * sizeof(uint3));
 
                     auto paramBlock = mpFinelyPruneEmptyBricks->getRootVar()["gParamBlock"];
+                    bindBrickReuseData(paramBlock);
                     paramBlock["primitiveCount"] = primitiveCount - mCurrentBakedPrimitiveCount;
                     paramBlock["gridWidth"] = mGridWidth;
                     paramBlock["brickCount"] = preFinePruningBrickCount;
@@ -785,6 +818,9 @@ namespace Falcor
                 }
 
                 auto cparamBlock = mpCreateBricksFromChunks->getRootVar()["gParamBlock"];
+                bindBrickReuseData(cparamBlock);
+                cparamBlock["prevBricks"] = reuseBricks ? mpPrevBrickTexture : nullptr;
+                cparamBlock["prevBricksPerAxis"] = mPrevBricksPerAxis;
                 cparamBlock["primitiveCount"] = primitiveCount - mBakedPrimitiveCount;
                 cparamBlock["gridWidth"] = mGridWidth;
                 cparamBlock["brickCount"] = mBrickCount;
@@ -799,6 +835,8 @@ namespace Falcor
                 // Copy the uncompressed brick texture to the compressed brick texture.
                 if (mCompressed) pRenderContext->copyResource(mpBrickTexture.get(), mpBrickScratchTexture.get());
             }
+
+            mCanReuseBricks = mBrickCount != 0 && !createEmptyBrick;
         }
 
         if (deleteScratchData)
@@ -818,6 +856,10 @@ namespace Falcor
 
             mpSDFGridTextureModified.reset();
             mpCountStagingBuffer.reset();
+
+            mpPrevIndirectionTexture.reset();
+            mpPrevBrickTexture.reset();
+            mpDirtyBrickMaskBuffer.reset();
         }
 
         mCurrentBakedPrimitiveCount = mBakedPrimitiveCount;
@@ -834,6 +876,67 @@ namespace Falcor
         return updateFlags;
     }
 
+    std::vector<uint32_t> SDFSBS::computeDirtyBrickMask() const
+    {
+        // A brick covers the values of the chunk at the same coords and the first values of the next chunks along each axis.
+        // An edited chunk thus affects the brick at its coords and the previous bricks along each axis.
+        const uint32_t virtualBrickCount = mVirtualBricksPerAxis * mVirtualBricksPerAxis * mVirtualBricksPerAxis;
+        const uint32_t chunksPerAxis = mPrimitives.getChunksPerAxis();
+        std::vector<uint32_t> mask(div_round_up(virtualBrickCount, 32u), 0);
+
+        for (uint32_t chunk : mPrimitives.getDirtyChunks())
+        {
+            uint3 chunkCoords(chunk % chunksPerAxis, (chunk / chunksPerAxis) % chunksPerAxis, chunk / (chunksPerAxis * chunksPerAxis));
+            for (uint32_t i = 0; i < 8; i++)
+            {
+                uint3 offset(i & 1, (i >> 1) & 1, (i >> 2) & 1);
+                if (offset.x > chunkCoords.x || offset.y > chunkCoords.y || offset.z > chunkCoords.z) continue;
+
+                uint3 brickCoords = chunkCoords - offset;
+                if (brickCoords.x >= mVirtualBricksPerAxis || brickCoords.y >= mVirtualBricksPerAxis || brickCoords.z >= mVirtualBricksPerAxis) continue;
+
+                uint32_t brickIndex = brickCoords.x + mVirtualBricksPerAxis * (brickCoords.y + mVirtualBricksPerAxis * brickCoords.z);
+                mask[brickIndex >> 5] |= 1u << (brickIndex & 31);
+            }
+        }
+
+        return mask;
+    }
+
+    void SDFSBS::prepareBrickReuse(RenderContext* pRenderContext, const std::vector<uint32_t>& dirtyBrickMask)
+    {
+        // Copy the indirection and brick textures of the previous build, as the brick passes overwrite them.
+        // With compression, the bricks are written to the scratch texture of BC4 blocks, which still holds the previous bricks.
+        auto copyTexture = [&](ref<Texture>& pDst, const ref<Texture>& pSrc, const char* name)
+        {
+            FALCOR_ASSERT(pSrc);
+            if (!pDst || pDst->getWidth() != pSrc->getWidth() || pDst->getHeight() != pSrc->getHeight() || pDst->getDepth() != pSrc->getDepth() || pDst->getFormat() != pSrc->getFormat())
+            {
+                if (pSrc->getType() == Resource::Type::Texture3D)
+                    pDst = mpDevice->createTexture3D(pSrc->getWidth(), pSrc->getHeight(), pSrc->getDepth(), pSrc->getFormat(), 1, nullptr, ResourceBindFlags::ShaderResource);
+                else
+                    pDst = mpDevice->createTexture2D(pSrc->getWidth(), pSrc->getHeight(), pSrc->getFormat(), 1, 1, nullptr, ResourceBindFlags::ShaderResource);
+                pDst->setName(name);
+            }
+            pRenderContext->copyResource(pDst.get(), pSrc.get());
+        };
+
+        copyTexture(mpPrevIndirectionTexture, mpIndirectionTexture, "SDFSBS::PrevIndirectionTexture");
+        copyTexture(mpPrevBrickTexture, mCompressed ? mpBrickScratchTexture : mpBrickTexture, "SDFSBS::PrevBrickTexture");
+        mPrevBricksPerAxis = mBricksPerAxis;
+
+        const size_t maskSize = dirtyBrickMask.size() * sizeof(uint32_t);
+        if (!mpDirtyBrickMaskBuffer || mpDirtyBrickMaskBuffer->getSize() < maskSize)
+        {
+            mpDirtyBrickMaskBuffer = mpDevice->createBuffer(maskSize, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, dirtyBrickMask.data());
+            mpDirtyBrickMaskBuffer->setName("SDFSBS::DirtyBrickMaskBuffer");
+        }
+        else
+        {
+            mpDirtyBrickMaskBuffer->setBlob(dirtyBrickMask.data(), 0, maskSize);
+        }
+    }
+
     void SDFSBS::expandSDFGridTexture(RenderContext* pRenderContext, bool deleteScratchData, uint32_t oldGridWidthInValues, uint32_t gridWidthInValues)
     {
         FALCOR_CHECK(oldGridWidthInValues < gridWidthInValues, "Can only expand SDF grid texture if the old width is smaller than the new width.");
@@ -86,6 +86,14 @@ namespace Falcor
 
         void compactifyChunks(RenderContext* pRenderContext, uint32_t chunkCount);
 
+        /** Compute a bit mask over the virtual bricks that marks the bricks touched by the edited chunks of the primitive store.
+        */
+        std::vector<uint32_t> computeDirtyBrickMask() const;
+
+        /** Keep the bricks of the previous build and upload the dirty brick mask, so that the brick passes can reuse untouched bricks.
+        */
+        void prepareBrickReuse(RenderContext* pRenderContext, const std::vector<uint32_t>& dirtyBrickMask);
+
     private:
         // CPU data.
         std::vector<int8_t> mSDField;
@@ -106,6 +114,8 @@ namespace Falcor
         uint32_t mCurrentBakedPrimitiveCount = 0;
         bool mWasEmpty = false;
         bool mBuildEmptyGrid = false;
+        bool mCanReuseBricks = false;                   ///< True if the bricks of the last build from primitives can be reused where no primitive was edited since.
+        uint2 mPrevBricksPerAxis = uint2(0);            ///< Bricks per axis in 'mpPrevBrickTexture'.
 
         // GPU data.
         ref<Buffer> mpBrickAABBsBuffer;                 ///< A compact buffer containing AABBs for each brick.
@@ -155,5 +165,12 @@ namespace Falcor
         ref<Texture> mpSDFGridTextureModified;
         std::vector<ref<Texture>> mIntervalSDFieldMaps;
         ref<Buffer> mpCountStagingBuffer;
+
+        // Scratch data used for reusing the bricks of the previous build.
+        ref<Texture> mpPrevIndirectionTexture;
+        ref<Texture> mpPrevBrickTexture;
+        ref<Buffer> mpDirtyBrickMaskBuffer;
+
+        friend class SceneCache;
     };
 }
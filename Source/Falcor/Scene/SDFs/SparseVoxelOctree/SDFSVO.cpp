@@ -92,7 +92,7 @@ namespace Falcor
 
     void SDFSVO::createResources(RenderContext* pRenderContext, bool deleteScratchData)
     {
-        if (!mPrimitives.empty())
+        if (!mPrimitives.isEmpty())
         {
             FALCOR_THROW("An SDFSVO instance cannot be created from primitives!");
         }
@@ -52,7 +52,7 @@ namespace Falcor
 
     void SDFSVS::createResources(RenderContext* pRenderContext, bool deleteScratchData)
     {
-        if (!mPrimitives.empty())
+        if (!mPrimitives.isEmpty())
         {
             FALCOR_THROW("An SDFSVS instance cannot be created from primitives!");
         }
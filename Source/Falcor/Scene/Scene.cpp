@@ -28,6 +28,7 @@
 #include "Scene.h"
 #include "SceneDefines.slangh"
 #include "SceneBuilder.h"
+#include "SceneCache.h"
 #include "Importer.h"
 #include "Scene/Material/SerializedMaterialParams.h"
 #include "Curves/CurveConfig.h"
@@ -157,6 +158,7 @@ namespace Falcor
             std::transform(extensions.begin(), extensions.end(), std::back_inserter(filters), [](const auto& ext) {
                 return FileDialogFilter(ext);
             });
+            filters.push_back(FileDialogFilter(SceneCache::kPackageExtension, "Falcor Scene Package"));
             return filters;
         }();
         return sFilters;
@@ -189,13 +191,20 @@ namespace Falcor
 
         mMeshDesc = std::move(sceneData.meshDesc);
         mMeshNames = std::move(sceneData.meshNames);
+        mMeshLODs = std::move(sceneData.meshLODs);
+        mMeshlets = std::move(sceneData.meshlets);
+        mMeshletOffsets = std::move(sceneData.meshletOffsets);
+        mMeshletVertices = std::move(sceneData.meshletVertices);
+        mMeshletTriangles = std::move(sceneData.meshletTriangles);
         mMeshBBs = std::move(sceneData.meshBBs);
         mMeshIdToInstanceIds = std::move(sceneData.meshIdToInstanceIds);
         mMeshGroups = std::move(sceneData.meshGroups);
 
         mUseCompressedHitInfo = sceneData.useCompressedHitInfo;
+        mPreserveSourceObjects = sceneData.preserveSourceObjects;
         mHas16BitIndices = sceneData.has16BitIndices;
         mHas32BitIndices = sceneData.has32BitIndices;
+        mpCpuRayQuery = std::move(sceneData.pCpuRayQuery);
 
         mCurveDesc = std::move(sceneData.curveDesc);
         mCurveBBs = std::move(sceneData.curveBBs);
@@ -224,9 +233,17 @@ namespace Falcor
         setSDFGridConfig();
 
         // Create vertex array objects for meshes and curves.
-        createMeshVao(sceneData.meshDrawCount, sceneData.meshIndexData, sceneData.meshStaticData, sceneData.meshSkinningData);
+        createMeshVao(sceneData.meshDrawCount, sceneData.meshIndexData, sceneData.meshStaticData, sceneData.pMeshIndexBuffer, sceneData.pMeshStaticBuffer);
         createCurveVao(mCurveIndexData, mCurveStaticData);
-        createMeshUVTiles(mMeshDesc, sceneData.meshIndexData, sceneData.meshStaticData);
+        if (!sceneData.meshUVTiles.empty())
+        {
+            FALCOR_CHECK(sceneData.meshUVTiles.size() == mMeshDesc.size(), "Mesh UV tile count mismatch.");
+            mMeshUVTiles = std::move(sceneData.meshUVTiles);
+        }
+        else
+        {
+            createMeshUVTiles(mMeshDesc, sceneData.meshIndexData, sceneData.meshStaticData);
+        }
 
         // Create animation controller.
         mpAnimationController = std::make_unique<AnimationController>(mpDevice, this, sceneData.meshStaticData, sceneData.meshSkinningData, sceneData.prevVertexCount, sceneData.animations);
@@ -424,25 +441,25 @@ namespace Falcor
         pRenderContext->raytrace(pProgram, pVars.get(), dispatchDims.x, dispatchDims.y, dispatchDims.z);
     }
 
-    void Scene::createMeshVao(uint32_t drawCount, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData, const std::vector<SkinningVertexData>& skinningData)
+    void Scene::createMeshVao(uint32_t drawCount, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData, ref<Buffer> pIB, ref<Buffer> pStaticBuffer)
     {
         if (drawCount == 0) return;
 
-        // Create the index buffer.
+        // Create the index buffer, unless it was already uploaded by the scene builder.
         size_t ibSize = sizeof(uint32_t) * indexData.size();
         if (ibSize > std::numeric_limits<uint32_t>::max())
         {
             FALCOR_THROW("Index buffer size exceeds 4GB");
         }
 
-        ref<Buffer> pIB;
-        if (ibSize > 0)
+        if (!pIB && ibSize > 0)
         {
             ResourceBindFlags ibBindFlags = ResourceBindFlags::Index | ResourceBindFlags::ShaderResource;
             pIB = mpDevice->createBuffer(ibSize, ibBindFlags, MemoryType::DeviceLocal, indexData.data());
         }
 
-        // Create the vertex data structured buffer.
+        // Create the vertex data structured buffer, unless it was already uploaded by the scene builder.
+        // A buffer created here is filled by the animation controller.
         const size_t vertexCount = (uint32_t)staticData.size();
         size_t staticVbSize = sizeof(PackedStaticVertexData) * vertexCount;
         if (staticVbSize > std::numeric_limits<uint32_t>::max())
@@ -450,8 +467,7 @@ namespace Falcor
             FALCOR_THROW("Vertex buffer size exceeds 4GB");
         }
 
-        ref<Buffer> pStaticBuffer;
-        if (vertexCount > 0)
+        if (!pStaticBuffer && vertexCount > 0)
         {
             ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::Vertex;
             pStaticBuffer = mpDevice->createStructuredBuffer(sizeof(PackedStaticVertexData), (uint32_t)vertexCount, vbBindFlags, MemoryType::DeviceLocal, nullptr, false);
@@ -556,86 +572,92 @@ namespace Falcor
         mpCurveVao = Vao::create(Vao::Topology::LineStrip, pLayout, pVBs, pIB, ResourceFormat::R32Uint);
     }
 
-    void Scene::createMeshUVTiles(const std::vector<MeshDesc>& meshDescs, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData)
+    std::vector<Rectangle> Scene::computeMeshUVTiles(const MeshDesc& desc, const uint32_t* pIndexData, const PackedStaticVertexData* pStaticData)
     {
-        const uint8_t* indexData8 = reinterpret_cast<const uint8_t*>(indexData.data());
-        mMeshUVTiles.resize(meshDescs.size());
+        const uint8_t* indexData8 = reinterpret_cast<const uint8_t*>(pIndexData);
 
-        auto processMeshTile = [&](size_t meshIndex)
-        {
-            const MeshDesc& desc = meshDescs[meshIndex];
-            // This tile captures any triangles that span more than one unit square, e.g., for tiled textures
-            Rectangle largeTriangleTile;
-            std::map<int2, Rectangle> tiles;
+        // This tile captures any triangles that span more than one unit square, e.g., for tiled textures
+        Rectangle largeTriangleTile;
+        std::map<int2, Rectangle> tiles;
 
-            const uint tcount = desc.getTriangleCount();
-            for (uint tidx = 0; tidx < tcount; ++tidx)
+        const uint tcount = desc.getTriangleCount();
+        for (uint tidx = 0; tidx < tcount; ++tidx)
+        {
+            // Compute local vertex indices within the mesh.
+            uint32_t vidx[3] = {};
+            if (desc.useVertexIndices())
             {
-                // Compute local vertex indices within the mesh.
-                uint32_t vidx[3] = {};
-                if (desc.useVertexIndices())
+                FALCOR_ASSERT(indexData8 != nullptr);
+                if (desc.use16BitIndices())
                 {
-                    FALCOR_ASSERT(indexData8 != nullptr);
-                    uint baseIndex = desc.ibOffset * 4;
-                    if (desc.use16BitIndices())
-                    {
-                        baseIndex += tidx * 3 * sizeof(uint16_t);
-                        vidx[0] = reinterpret_cast<const uint16_t*>(indexData8 + baseIndex)[0];
-                        vidx[1] = reinterpret_cast<const uint16_t*>(indexData8 + baseIndex)[1];
-                        vidx[2] = reinterpret_cast<const uint16_t*>(indexData8 + baseIndex)[2];
-                    }
-                    else
-                    {
-                        baseIndex += tidx * 3 * sizeof(uint32_t);
-                        vidx[0] = reinterpret_cast<const uint32_t*>(indexData8 + baseIndex)[0];
-                        vidx[1] = reinterpret_cast<const uint32_t*>(indexData8 + baseIndex)[1];
-                        vidx[2] = reinterpret_cast<const uint32_t*>(indexData8 + baseIndex)[2];
-                    }
+                    uint baseIndex = tidx * 3 * sizeof(uint16_t);
+                    vidx[0] = reinterpret_cast<const uint16_t*>(indexData8 + baseIndex)[0];
+                    vidx[1] = reinterpret_cast<const uint16_t*>(indexData8 + baseIndex)[1];
+                    vidx[2] = reinterpret_cast<const uint16_t*>(indexData8 + baseIndex)[2];
                 }
                 else
                 {
-                    uint baseIndex = tidx * 3;
-                    vidx[0] = baseIndex + 0;
-                    vidx[1] = baseIndex + 1;
-                    vidx[2] = baseIndex + 2;
+                    uint baseIndex = tidx * 3 * sizeof(uint32_t);
+                    vidx[0] = reinterpret_cast<const uint32_t*>(indexData8 + baseIndex)[0];
+                    vidx[1] = reinterpret_cast<const uint32_t*>(indexData8 + baseIndex)[1];
+                    vidx[2] = reinterpret_cast<const uint32_t*>(indexData8 + baseIndex)[2];
                 }
-                FALCOR_ASSERT(vidx[0] < desc.vertexCount);
-                FALCOR_ASSERT(vidx[1] < desc.vertexCount);
-                FALCOR_ASSERT(vidx[2] < desc.vertexCount);
-
-                // Load vertices from global vertex buffer.
-                // Note that the mesh local vbOffset is added to address into the global vertex buffer.
-                FALCOR_ASSERT((size_t)desc.vbOffset + desc.vertexCount <= staticData.size());
-                StaticVertexData vertices[3];
-                vertices[0] = staticData[(size_t)desc.vbOffset + vidx[0]].unpack();
-                vertices[1] = staticData[(size_t)desc.vbOffset + vidx[1]].unpack();
-                vertices[2] = staticData[(size_t)desc.vbOffset + vidx[2]].unpack();
-
-                int2 v0 = int2(std::floor(vertices[0].texCrd[0]), std::floor(vertices[0].texCrd[1]));
-                int2 v1 = int2(std::floor(vertices[1].texCrd[0]), std::floor(vertices[1].texCrd[1]));
-                int2 v2 = int2(std::floor(vertices[2].texCrd[0]), std::floor(vertices[2].texCrd[1]));
-
-                Rectangle* tile;
-                if (all(v0 == v1 && v0 == v2))
-                    tile = &tiles[v0];
-                else
-                    tile = &largeTriangleTile;
-
-                tile->include(vertices[0].texCrd);
-                tile->include(vertices[1].texCrd);
-                tile->include(vertices[2].texCrd);
             }
-
-            std::vector<Rectangle>& result = mMeshUVTiles[meshIndex];
-            for (auto& tile : tiles)
+            else
             {
-                if (largeTriangleTile.contains(tile.second))
-                    continue;
-                result.push_back(tile.second);
+                uint baseIndex = tidx * 3;
+                vidx[0] = baseIndex + 0;
+                vidx[1] = baseIndex + 1;
+                vidx[2] = baseIndex + 2;
             }
+            FALCOR_ASSERT(vidx[0] < desc.vertexCount);
+            FALCOR_ASSERT(vidx[1] < desc.vertexCount);
+            FALCOR_ASSERT(vidx[2] < desc.vertexCount);
+
+            StaticVertexData vertices[3];
+            vertices[0] = pStaticData[vidx[0]].unpack();
+            vertices[1] = pStaticData[vidx[1]].unpack();
+            vertices[2] = pStaticData[vidx[2]].unpack();
+
+            int2 v0 = int2(std::floor(vertices[0].texCrd[0]), std::floor(vertices[0].texCrd[1]));
+            int2 v1 = int2(std::floor(vertices[1].texCrd[0]), std::floor(vertices[1].texCrd[1]));
+            int2 v2 = int2(std::floor(vertices[2].texCrd[0]), std::floor(vertices[2].texCrd[1]));
+
+            Rectangle* tile;
+            if (all(v0 == v1 && v0 == v2))
+                tile = &tiles[v0];
+            else
+                tile = &largeTriangleTile;
+
+            tile->include(vertices[0].texCrd);
+            tile->include(vertices[1].texCrd);
+            tile->include(vertices[2].texCrd);
+        }
+
+        std::vector<Rectangle> result;
+        for (auto& tile : tiles)
+        {
+            if (largeTriangleTile.contains(tile.second))
+                continue;
+            result.push_back(tile.second);
+        }
 
-            if (largeTriangleTile.valid())
-                result.push_back(largeTriangleTile);
+        if (largeTriangleTile.valid())
+            result.push_back(largeTriangleTile);
+        return result;
+    }
+
+    void Scene::createMeshUVTiles(const std::vector<MeshDesc>& meshDescs, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData)
+    {
+        mMeshUVTiles.resize(meshDescs.size());
+
+        auto processMeshTile = [&](size_t meshIndex)
+        {
+            // Note that the mesh local offsets are added to address into the global buffers.
+            const MeshDesc& desc = meshDescs[meshIndex];
+            FALCOR_ASSERT((size_t)desc.vbOffset + desc.vertexCount <= staticData.size());
+            const uint32_t* pIndexData = desc.useVertexIndices() ? indexData.data() + desc.ibOffset : nullptr;
+            mMeshUVTiles[meshIndex] = computeMeshUVTiles(desc, pIndexData, staticData.data() + desc.vbOffset);
         };
 
         auto range = NumericRange<size_t>(0, meshDescs.size());
@@ -29,6 +29,7 @@
 #include "SceneIDs.h"
 #include "SceneTypes.slang"
 #include "HitInfo.h"
+#include "MeshLOD.h"
 #include "Animation/Animation.h"
 #include "Animation/AnimationController.h"
 #include "Displacement/DisplacementUpdateTask.slang"
@@ -54,6 +55,7 @@
 #include "Utils/UI/Gui.h"
 #include "Utils/Settings/Settings.h"
 
+#include <fstd/span.h>
 #include <functional>
 #include <memory>
 #include <type_traits>
@@ -70,6 +72,7 @@ namespace Falcor
     struct GamepadState;
 
     class RtProgramVars;
+    class CpuRayQuery;
 
     /** This class is the main scene representation.
         It holds all scene resources such as geometry, cameras, lights, and materials.
@@ -319,6 +322,7 @@ namespace Falcor
             std::vector<Node> sceneGraph;                           ///< Scene graph nodes.
             std::vector<ref<Animation>> animations;                 ///< List of animations.
             Metadata metadata;                                      ///< Scene meadata.
+            bool preserveSourceObjects = false;                     ///< True if the scene objects are one-to-one with the objects of the source asset (see SceneBuilder::Flags::PreserveSourceObjects).
 
             // Mesh data
             std::vector<MeshDesc> meshDesc;                         ///< List of mesh descriptors.
@@ -338,6 +342,15 @@ namespace Falcor
             std::vector<uint32_t> meshIndexData;                    ///< Vertex indices for all meshes in either 32-bit or 16-bit format packed tightly, decided per mesh.
             std::vector<PackedStaticVertexData> meshStaticData;     ///< Vertex attributes for all meshes in packed format.
             std::vector<SkinningVertexData> meshSkinningData;       ///< Additional vertex attributes for skinned meshes.
+            ref<Buffer> pMeshIndexBuffer;                           ///< Mesh index buffer uploaded by the scene builder. If set, 'meshIndexData' is empty (see SceneBuilder::Flags::OutOfCoreGeometry).
+            ref<Buffer> pMeshStaticBuffer;                          ///< Mesh vertex buffer uploaded by the scene builder. If set, 'meshStaticData' is empty.
+            std::vector<std::vector<Rectangle>> meshUVTiles;        ///< UV tiles per mesh computed by the scene builder. Computed from 'meshStaticData' if empty.
+            std::vector<MeshLODInfo> meshLODs;                      ///< Statistics for the generated mesh LOD chains (see SceneBuilder::Flags::GenerateMeshLODs).
+
+            std::vector<MeshletDesc> meshlets;                      ///< Meshlets of all meshes (see SceneBuilder::Flags::GenerateMeshlets).
+            std::vector<uint32_t> meshletOffsets;                   ///< Offset of the first meshlet of each mesh, with the total count appended. Empty if no meshlets were generated.
+            std::vector<uint32_t> meshletVertices;                  ///< Meshlet vertices. These are vertex indices local to each mesh.
+            std::vector<uint32_t> meshletTriangles;                 ///< Meshlet triangles. Each is three packed 8-bit indices into the meshlet vertices.
 
             // Curve data
             std::vector<CurveDesc> curveDesc;                       ///< List of curve descriptors.
@@ -357,6 +370,8 @@ namespace Falcor
             // Custom primitive data
             std::vector<CustomPrimitiveDesc> customPrimitiveDesc;   ///< Custom primitive descriptors.
             std::vector<AABB> customPrimitiveAABBs;                 ///< List of AABBs for custom primitives in world space. Each custom primitive consists of one AABB.
+
+            std::shared_ptr<CpuRayQuery> pCpuRayQuery;              ///< Optional CPU ray query backend built from the data above.
         };
 
         /** Statistics.
@@ -701,6 +716,14 @@ namespace Falcor
         */
         std::vector<Rectangle> getGeometryUVTiles(GlobalGeometryID geometryID) const;
 
+        /** Compute the UV tiles accessed by a single mesh (see getGeometryUVTiles()).
+            \param[in] desc Mesh descriptor. The offsets are ignored, the data pointers address the mesh directly.
+            \param[in] pIndexData Index data of the mesh, or nullptr if the mesh is non-indexed.
+            \param[in] pStaticData Vertex data of the mesh.
+            \return List of non-overlapping UVTiles that bound the UV set of the mesh.
+        */
+        static std::vector<Rectangle> computeMeshUVTiles(const MeshDesc& desc, const uint32_t* pIndexData, const PackedStaticVertexData* pStaticData);
+
         /** Get the type of a given geometry.
             \param[in] geometryID Global geometry ID.
             \return The type of the given geometry.
@@ -789,6 +812,14 @@ namespace Falcor
         */
         std::vector<uint32_t> getGeometryInstanceIDsByType(GeometryType type) const;
 
+        /** Get the number of nodes in the scene graph.
+        */
+        uint32_t getNodeCount() const { return (uint32_t)mSceneGraph.size(); }
+
+        /** Get a node in the scene graph.
+        */
+        const Node& getNode(uint32_t nodeID) const { FALCOR_ASSERT(nodeID < mSceneGraph.size()); return mSceneGraph[nodeID]; }
+
         /** Updates a node in the graph.
         */
         void updateNodeTransform(uint32_t nodeID, const float4x4& transform);
@@ -1010,6 +1041,13 @@ namespace Falcor
         */
         void raytrace(RenderContext* pRenderContext, Program* pProgram, const ref<RtProgramVars>& pVars, uint3 dispatchDims);
 
+        /** Get the CPU ray query backend.
+            This is only available if the scene was built with SceneBuilder::Flags::BuildCpuRayQuery.
+            The CPU acceleration structure reflects the triangle meshes at load time and is not updated by animations.
+            \return The CPU ray query object or nullptr if not available.
+        */
+        const CpuRayQuery* getCpuRayQuery() const { return mpCpuRayQuery.get(); }
+
         /** Render the UI.
         */
         void renderUI(Gui::Widgets& widget);
@@ -1108,6 +1146,39 @@ namespace Falcor
         */
         bool hasMesh(uint32_t meshID) const { return meshID < mMeshNames.size(); }
 
+        /** Get statistics for the mesh LOD chains generated by the scene builder.
+            The list is empty unless the scene was built with SceneBuilder::Flags::GenerateMeshLODs.
+        */
+        const std::vector<MeshLODInfo>& getMeshLODs() const { return mMeshLODs; }
+
+        /** Return true if the scene was built with meshlets (see SceneBuilder::Flags::GenerateMeshlets).
+        */
+        bool hasMeshlets() const { return !mMeshletOffsets.empty(); }
+
+        /** Return true if the scene objects are one-to-one with the objects of the source asset, so that the scene
+            can be updated in place from it (see SceneBuilder::Flags::PreserveSourceObjects).
+        */
+        bool preservesSourceObjects() const { return mPreserveSourceObjects; }
+
+        /** Get the meshlets of a mesh. Dynamic and displaced meshes have no meshlets.
+            \param[in] meshID Mesh ID.
+            \return Meshlets of the mesh, or an empty list if the scene has no meshlets.
+        */
+        fstd::span<const MeshletDesc> getMeshlets(MeshID meshID) const
+        {
+            if (!hasMeshlets()) return {};
+            FALCOR_ASSERT(meshID.get() + 1 < mMeshletOffsets.size());
+            return fstd::span<const MeshletDesc>(mMeshlets.data() + mMeshletOffsets[meshID.get()], mMeshletOffsets[meshID.get() + 1] - mMeshletOffsets[meshID.get()]);
+        }
+
+        /** Get the meshlet vertices of all meshes. These are vertex indices local to each mesh.
+        */
+        const std::vector<uint32_t>& getMeshletVertices() const { return mMeshletVertices; }
+
+        /** Get the meshlet triangles of all meshes. Each is three 8-bit indices into the meshlet vertices packed into a uint.
+        */
+        const std::vector<uint32_t>& getMeshletTriangles() const { return mMeshletTriangles; }
+
         /** Get a list of raytracing BLAS IDs for all meshes. The list is arranged by mesh ID.
         */
         std::vector<uint32_t> getMeshBlasIDs() const;
@@ -1129,7 +1200,7 @@ namespace Falcor
         static constexpr uint32_t kDrawIdBufferIndex = kStaticDataBufferIndex + 1;
         static constexpr uint32_t kVertexBufferCount = kDrawIdBufferIndex + 1;
 
-        void createMeshVao(uint32_t drawCount, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData, const std::vector<SkinningVertexData>& skinningData);
+        void createMeshVao(uint32_t drawCount, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData, ref<Buffer> pIB, ref<Buffer> pStaticBuffer);
         void createCurveVao(const std::vector<uint32_t>& indexData, const std::vector<StaticCurveVertexData>& staticData);
         void createMeshUVTiles(const std::vector<MeshDesc>& meshDesc, const std::vector<uint32_t>& indexData, const std::vector<PackedStaticVertexData>& staticData);
 
@@ -1263,6 +1334,7 @@ namespace Falcor
         std::vector<GeometryInstanceData> mGeometryInstanceData;    ///< Geometry instance data (for all types of geometry).
 
         bool mUseCompressedHitInfo = false;                         ///< True if scene should used compressed HitInfo (on scenes with triangles meshes only).
+        bool mPreserveSourceObjects = false;                        ///< True if the scene objects are one-to-one with the objects of the source asset.
         bool mHas16BitIndices = false;                              ///< True if any meshes use 16-bit indices.
         bool mHas32BitIndices = false;                              ///< True if any meshes use 32-bit indices.
 
@@ -1276,6 +1348,11 @@ namespace Falcor
         std::vector<std::vector<Rectangle>> mMeshUVTiles;           ///< Bounding tiles for the mesh UVs
         std::vector<MeshGroup> mMeshGroups;                         ///< Groups of meshes. Each group maps to a BLAS for ray tracing.
         std::vector<std::string> mMeshNames;                        ///< Mesh names, indxed by mesh ID
+        std::vector<MeshLODInfo> mMeshLODs;                         ///< Mesh LOD chain statistics.
+        std::vector<MeshletDesc> mMeshlets;                         ///< Meshlets of all meshes.
+        std::vector<uint32_t> mMeshletOffsets;                      ///< Offset of the first meshlet of each mesh, with the total count appended.
+        std::vector<uint32_t> mMeshletVertices;                     ///< Meshlet vertices.
+        std::vector<uint32_t> mMeshletTriangles;                    ///< Packed meshlet triangles.
         std::vector<Node> mSceneGraph;                              ///< For each index i, the array element indicates the parent node. Indices are in relation to mLocalToWorldMatrices.
 
         /// For Python bindings of triangle meshes.
@@ -1457,6 +1534,8 @@ namespace Falcor
         bool mBlasDataValid = false;                        ///< Flag to indicate if the BLAS data is valid. This will be reset when geometry is changed.
         bool mRebuildBlas = true;                           ///< Flag to indicate BLASes need to be rebuilt.
 
+        std::shared_ptr<CpuRayQuery> mpCpuRayQuery;         ///< CPU ray query backend, or nullptr if not built.
+
         std::filesystem::path mPath;
         bool mFinalized = false;                            ///< True if scene is ready to be bound to the GPU.
     };
@@ -27,20 +27,26 @@
  **************************************************************************/
 #include "SceneBuilder.h"
 #include "SceneCache.h"
+#include "CpuRayQuery.h"
+#include "MeshletBuilder.h"
+#include "TangentSpaceGenerator.h"
 #include "Importer.h"
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
+#include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
 #include "Utils/Math/Common.h"
+#include "Utils/Math/FalcorMath.h"
 #include "Utils/Image/TextureAnalyzer.h"
 #include "Utils/Timing/TimeReport.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Math/MathHelpers.h"
 #include "Utils/ObjectIDPython.h"
 #include "Utils/NumericRange.h"
-#include <mikktspace.h>
 #include <filesystem>
 #include <cmath>
+#include <cstring>
 #include <execution>
 
 namespace Falcor
@@ -62,93 +68,6 @@ namespace Falcor
             else return 2;
         }
 
-        class MikkTSpaceWrapper
-        {
-        public:
-            static std::vector<float4> generateTangents(const SceneBuilder::Mesh& mesh)
-            {
-                if (!mesh.normals.pData || !mesh.positions.pData || !mesh.texCrds.pData || !mesh.pIndices)
-                {
-                    logWarning("Can't generate tangent space. The mesh '{}' doesn't have positions/normals/texCrd/indices.", mesh.name);
-                    return {};
-                }
-
-                // Generate new tangent space.
-                SMikkTSpaceInterface mikktspace = {};
-                mikktspace.m_getNumFaces = [](const SMikkTSpaceContext* pContext) { return ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getFaceCount(); };
-                mikktspace.m_getNumVerticesOfFace = [](const SMikkTSpaceContext* pContext, int32_t face) { return 3; };
-                mikktspace.m_getPosition = [](const SMikkTSpaceContext* pContext, float position[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getPosition(position, face, vert); };
-                mikktspace.m_getNormal = [](const SMikkTSpaceContext* pContext, float normal[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getNormal(normal, face, vert); };
-                mikktspace.m_getTexCoord = [](const SMikkTSpaceContext* pContext, float texCrd[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getTexCrd(texCrd, face, vert); };
-                mikktspace.m_setTSpaceBasic = [](const SMikkTSpaceContext* pContext, const float tangent[], float sign, int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->setTangent(tangent, sign, face, vert); };
-
-                MikkTSpaceWrapper wrapper(mesh);
-                SMikkTSpaceContext context = {};
-                context.m_pInterface = &mikktspace;
-                context.m_pUserData = &wrapper;
-
-                if (genTangSpaceDefault(&context) == false)
-                {
-                    FALCOR_THROW("MikkTSpace failed to generate tangents for the mesh '{}'.", mesh.name);
-                }
-
-                return wrapper.mTangents;
-            }
-
-        private:
-            MikkTSpaceWrapper(const SceneBuilder::Mesh& mesh)
-                : mMesh(mesh)
-            {
-                FALCOR_ASSERT(mesh.indexCount > 0);
-                mTangents.resize(mesh.indexCount, float4(0));
-
-                FALCOR_ASSERT_EQ(mesh.indexCount, mMesh.faceCount * 3);
-                mPositions.resize(mMesh.faceCount * 3);
-                switch (mMesh.positions.frequency)
-                {
-                case SceneBuilder::Mesh::AttributeFrequency::Constant:
-                {
-                    std::fill_n(mPositions.begin(), mPositions.size(), mMesh.positions.pData[0]);
-                    break;
-                }
-                case SceneBuilder::Mesh::AttributeFrequency::Uniform:
-                {
-                    for (uint32_t i = 0; i < mMesh.faceCount; ++i)
-                        std::fill_n(mPositions.begin() + i * 3, 3, mMesh.positions.pData[i]);
-                    break;
-                }
-                case SceneBuilder::Mesh::AttributeFrequency::Vertex:
-                {
-                    FALCOR_ASSERT_EQ(mesh.indexCount, mPositions.size());
-                    for (size_t fvarIdx = 0; fvarIdx < mPositions.size(); ++fvarIdx)
-                        mPositions[fvarIdx] = mMesh.positions.pData[mMesh.pIndices[fvarIdx]];
-                    break;
-                }
-                case SceneBuilder::Mesh::AttributeFrequency::FaceVarying:
-                {
-                    memcpy(mPositions.data(), mMesh.positions.pData, mPositions.size() * sizeof(float3));
-                    break;
-                }
-                default:
-                    FALCOR_UNREACHABLE();
-                }
-
-            }
-            const SceneBuilder::Mesh& mMesh;
-            std::vector<float4> mTangents;
-            std::vector<float3> mPositions;
-            int32_t getFaceCount() const { return (int32_t)mMesh.faceCount; }
-            void getPosition(float position[], int32_t face, int32_t vert) const { FALCOR_ASSERT_LT(size_t(face) * 3 + vert, mPositions.size()); memcpy(position, mPositions.data() + (face * 3 + vert), sizeof(float3)); }
-            void getNormal(float normal[], int32_t face, int32_t vert) { *reinterpret_cast<float3*>(normal) = mMesh.getNormal(face, vert); }
-            void getTexCrd(float texCrd[], int32_t face, int32_t vert) { *reinterpret_cast<float2*>(texCrd) = mMesh.getTexCrd(face, vert); }
-
-            void setTangent(const float tangent[], float sign, int32_t face, int32_t vert)
-            {
-                float3 T = *reinterpret_cast<const float3*>(tangent);
-                mTangents[face * 3 + vert] = float4(normalize(T), sign);
-            }
-        };
-
         void validateVertex(const SceneBuilder::Mesh::Vertex& v, size_t& invalidCount, size_t& zeroCount)
         {
             auto isInvalid = [](const auto& x)
@@ -177,7 +96,8 @@ namespace Falcor
             return true;
         }
 
-        std::vector<uint32_t> compact16BitIndices(const std::vector<uint32_t>& indices)
+        template<typename T>
+        std::vector<uint32_t> compact16BitIndices(const T& indices)
         {
             if (indices.empty()) return {};
             size_t sz = div_round_up(indices.size(), (std::size_t)2); // Storing two 16-bit indices per dword.
@@ -191,22 +111,119 @@ namespace Falcor
             return indexData;
         }
 
-        SceneCache::Key computeSceneCacheKey(const std::filesystem::path& path, SceneBuilder::Flags buildFlags)
+        /** Uploads data sequentially to a GPU buffer through a fixed-size staging chunk.
+            This avoids both gathering the full buffer in host memory and issuing one upload per small write.
+        */
+        class ChunkedBufferWriter
         {
-            SceneBuilder::Flags cacheFlags = buildFlags & (~(SceneBuilder::Flags::UseCache | SceneBuilder::Flags::RebuildCache));
+        public:
+            ChunkedBufferWriter(ref<Buffer> pBuffer, size_t chunkSize)
+                : mpBuffer(std::move(pBuffer))
+            {
+                if (mpBuffer) mChunk.resize(std::max<size_t>(std::min<size_t>(chunkSize, mpBuffer->getSize()), 1));
+            }
+
+            void write(const void* pData, size_t size)
+            {
+                const uint8_t* pSrc = reinterpret_cast<const uint8_t*>(pData);
+                while (size > 0)
+                {
+                    FALCOR_ASSERT(mpBuffer);
+                    size_t count = std::min(size, mChunk.size() - mChunkUsed);
+                    std::memcpy(mChunk.data() + mChunkUsed, pSrc, count);
+                    mChunkUsed += count;
+                    pSrc += count;
+                    size -= count;
+                    if (mChunkUsed == mChunk.size()) flush();
+                }
+            }
+
+            void flush()
+            {
+                if (mChunkUsed == 0) return;
+                FALCOR_CHECK(mOffset + mChunkUsed <= mpBuffer->getSize(), "Writing past the end of the buffer.");
+                mpBuffer->setBlob(mChunk.data(), mOffset, mChunkUsed);
+                mOffset += mChunkUsed;
+                mChunkUsed = 0;
+            }
+
+            /// Get the number of bytes written so far.
+            size_t getOffset() const { return mOffset + mChunkUsed; }
+
+        private:
+            ref<Buffer> mpBuffer;
+            std::vector<uint8_t> mChunk;
+            size_t mChunkUsed = 0;
+            size_t mOffset = 0;
+        };
+
+        size_t getMeshInputByteSize(const SceneBuilder::Mesh& mesh)
+        {
+            size_t byteSize = mesh.pIndices ? mesh.indexCount * sizeof(uint32_t) : 0;
+            auto addAttribute = [&](const auto& attribute)
+            {
+                using T = std::remove_cv_t<std::remove_pointer_t<decltype(attribute.pData)>>;
+                if (attribute.pData) byteSize += mesh.getAttributeCount(attribute) * sizeof(T);
+            };
+            addAttribute(mesh.positions);
+            addAttribute(mesh.normals);
+            addAttribute(mesh.tangents);
+            addAttribute(mesh.texCrds);
+            addAttribute(mesh.curveRadii);
+            addAttribute(mesh.boneIDs);
+            addAttribute(mesh.boneWeights);
+            return byteSize;
+        }
+
+        SceneCache::Key computeSceneCacheKey(const std::filesystem::path& path, SceneBuilder::Flags buildFlags, const MeshLODSettings& meshLODSettings)
+        {
+            SceneBuilder::Flags cacheFlags = buildFlags & (~(SceneBuilder::Flags::UseCache | SceneBuilder::Flags::RebuildCache | SceneBuilder::Flags::BuildCpuRayQuery | SceneBuilder::Flags::PackTextureAtlases | SceneBuilder::Flags::OutOfCoreGeometry));
             SHA1 sha1;
             auto pathStr = path.string();
             sha1.update(pathStr.data(), pathStr.size());
             sha1.update(&cacheFlags, sizeof(cacheFlags));
+            if (is_set(buildFlags, SceneBuilder::Flags::GenerateMeshLODs)) sha1.update(&meshLODSettings, sizeof(meshLODSettings));
             return sha1.finalize();
 
         }
+
+        MeshLODSettings readMeshLODSettings(const Settings& settings)
+        {
+            MeshLODSettings lodSettings;
+            lodSettings.maxLevelCount = settings.getOption("MeshLOD:maxLevelCount", lodSettings.maxLevelCount);
+            lodSettings.reductionRatio = settings.getOption("MeshLOD:reductionRatio", lodSettings.reductionRatio);
+            lodSettings.minTriangleCount = settings.getOption("MeshLOD:minTriangleCount", lodSettings.minTriangleCount);
+            lodSettings.maxRelativeError = settings.getOption("MeshLOD:maxRelativeError", lodSettings.maxRelativeError);
+            lodSettings.maxPixelError = settings.getOption("MeshLOD:maxPixelError", lodSettings.maxPixelError);
+            lodSettings.viewportHeight = settings.getOption("MeshLOD:viewportHeight", lodSettings.viewportHeight);
+            return lodSettings;
+        }
+
+        GeometrySpillSettings readGeometrySpillSettings(const Settings& settings)
+        {
+            GeometrySpillSettings spillSettings;
+            spillSettings.hostMemoryBudget = (uint64_t)settings.getOption("OutOfCore:hostMemoryBudgetMB", (uint32_t)(spillSettings.hostMemoryBudget >> 20)) << 20;
+            spillSettings.directory = settings.getOption("OutOfCore:spillDirectory", spillSettings.directory.string());
+            spillSettings.uploadChunkSize = (uint64_t)settings.getOption("OutOfCore:uploadChunkSizeMB", (uint32_t)(spillSettings.uploadChunkSize >> 20)) << 20;
+            return spillSettings;
+        }
+
+        TextureAtlasSettings readTextureAtlasSettings(const Settings& settings)
+        {
+            TextureAtlasSettings atlasSettings;
+            atlasSettings.maxTextureSize = settings.getOption("TextureAtlas:maxTextureSize", atlasSettings.maxTextureSize);
+            atlasSettings.atlasSize = settings.getOption("TextureAtlas:atlasSize", atlasSettings.atlasSize);
+            atlasSettings.mipLevels = settings.getOption("TextureAtlas:mipLevels", atlasSettings.mipLevels);
+            return atlasSettings;
+        }
     }
 
     SceneBuilder::SceneBuilder(ref<Device> pDevice, const Settings& settings, Flags flags)
         : mpDevice(pDevice)
         , mSettings(settings)
         , mFlags(flags)
+        , mMeshLODSettings(readMeshLODSettings(settings))
+        , mGeometrySpillSettings(readGeometrySpillSettings(settings))
     {
         mAssetResolver = AssetResolver::getDefaultResolver();
         mSceneData.pMaterials = std::make_unique<MaterialSystem>(mpDevice);
@@ -221,8 +238,25 @@ namespace Falcor
             throw ImporterError(path, "Can't find scene file '{}'.", path);
         }
 
+        // Scene packages contain processed scene data and are loaded directly.
+        if (SceneCache::isPackage(resolvedPath))
+        {
+            try
+            {
+                Scene::SceneData sceneData = SceneCache::readPackage(pDevice, resolvedPath);
+                if (is_set(flags, Flags::BuildCpuRayQuery)) sceneData.pCpuRayQuery = CpuRayQuery::create(sceneData);
+                if (is_set(flags, Flags::PackTextureAtlases)) sceneData.pMaterials->packTextureAtlases(readTextureAtlasSettings(settings));
+                mpScene = Scene::create(pDevice, std::move(sceneData));
+                return;
+            }
+            catch (const std::exception& e)
+            {
+                throw ImporterError(resolvedPath, "Failed to load scene package: {}", e.what());
+            }
+        }
+
         // Compute scene cache key based on absolute scene path and build flags.
-        mSceneCacheKey = computeSceneCacheKey(resolvedPath, flags);
+        mSceneCacheKey = computeSceneCacheKey(resolvedPath, flags, mMeshLODSettings);
 
         // Determine if scene cache should be written after import.
         bool useCache = is_set(flags, Flags::UseCache);
@@ -234,7 +268,10 @@ namespace Falcor
         {
             try
             {
-                mpScene = Scene::create(pDevice, SceneCache::readCache(pDevice, mSceneCacheKey));
+                Scene::SceneData sceneData = SceneCache::readCache(pDevice, mSceneCacheKey);
+                if (is_set(flags, Flags::BuildCpuRayQuery)) sceneData.pCpuRayQuery = CpuRayQuery::create(sceneData);
+                if (is_set(flags, Flags::PackTextureAtlases)) sceneData.pMaterials->packTextureAtlases(readTextureAtlasSettings(settings));
+                mpScene = Scene::create(pDevice, std::move(sceneData));
                 return;
             }
             catch (const std::exception& e)
@@ -271,6 +308,7 @@ namespace Falcor
 
     void SceneBuilder::import(const std::filesystem::path& path, const pybind11::dict& dict)
     {
+        checkNotFinalized();
         logInfo("Importing scene: {}", path);
         std::map<std::string, std::string> materialToShortName = convertDictToMap(dict);
 
@@ -293,6 +331,7 @@ namespace Falcor
 
     void SceneBuilder::importFromMemory(const void* buffer, size_t byteSize, std::string_view extension, const pybind11::dict& dict)
     {
+        checkNotFinalized();
         logInfo("Importing scene from memory");
         std::map<std::string, std::string> materialToShortName = convertDictToMap(dict);
 
@@ -323,6 +362,55 @@ namespace Falcor
     {
         if (mpScene) return mpScene;
 
+        finalizeSceneData();
+
+        TimeReport timeReport;
+
+        // Write scene cache if requested.
+        if (mWriteSceneCache)
+        {
+            SceneCache::writeCache(mSceneData, mSceneCacheKey);
+            timeReport.measure("Writing cache");
+        }
+
+        // Pack small material textures into atlases if requested. This is not stored in the scene cache.
+        if (is_set(mFlags, Flags::PackTextureAtlases))
+        {
+            mSceneData.pMaterials->packTextureAtlases(readTextureAtlasSettings(mSettings));
+            timeReport.measure("Packing texture atlases");
+        }
+
+        // Build the CPU acceleration structure if requested. This is not stored in the scene cache.
+        if (is_set(mFlags, Flags::BuildCpuRayQuery))
+        {
+            mSceneData.pCpuRayQuery = CpuRayQuery::create(mSceneData);
+            timeReport.measure("Building CPU ray query BVH");
+        }
+
+        // Create the scene object.
+        mpScene = Scene::create(mpDevice, std::move(mSceneData));
+        mSceneData = {};
+
+        timeReport.measure("Creating resources");
+        timeReport.printToLog();
+
+        return mpScene;
+    }
+
+    void SceneBuilder::exportPackage(const std::filesystem::path& path)
+    {
+        FALCOR_CHECK(!mpScene, "Can't export a scene package after the scene has been created.");
+
+        finalizeSceneData(true);
+        SceneCache::writePackage(mSceneData, path);
+    }
+
+    void SceneBuilder::finalizeSceneData(bool keepHostMeshData)
+    {
+        if (mSceneDataFinalized) return;
+
+        mKeepHostMeshData = keepHostMeshData;
+
         // Finish loading textures. This blocks until all textures are loaded and assigned.
         mpMaterialTextureLoader.reset();
 
@@ -340,6 +428,22 @@ namespace Falcor
             addMeshInstance(nodeID, meshID);
         }
 
+        if (mProcessedMeshCount > 0)
+        {
+            ImportStats stats = getImportStats();
+            logInfo("Imported {} meshes ({} adopted). Input mesh data: {} ({} adopted), processed mesh data: {}, peak RSS: {}.",
+                stats.meshCount, stats.adoptedMeshCount, formatByteSize(stats.inputMeshBytes), formatByteSize(stats.adoptedMeshBytes),
+                formatByteSize(stats.processedMeshBytes), formatByteSize(stats.peakRSS));
+            if (isOutOfCore())
+            {
+                logInfo("Out-of-core geometry: peak resident mesh data {} (budget {}), spill file {}.",
+                    formatByteSize(stats.peakResidentMeshBytes), formatByteSize(mGeometrySpillSettings.hostMemoryBudget), formatByteSize(stats.spillFileBytes));
+            }
+        }
+
+        // Recount the resident mesh data, as importers may have modified it.
+        updateResidentMeshBytes();
+
         // Post-process the scene data.
         TimeReport timeReport;
 
@@ -350,6 +454,7 @@ namespace Falcor
         prepareSceneGraph();
         prepareMeshes();
         removeUnusedMeshes();
+        generateMeshLODs();
         flattenStaticMeshInstances();
         pretransformStaticMeshes();
         unifyTriangleWinding();
@@ -358,6 +463,7 @@ namespace Falcor
         createMeshGroups();
         optimizeGeometry();
         sortMeshes();
+        createMeshlets();
         createGlobalBuffers();
         createCurveGlobalBuffers();
         collectVolumeGrids();
@@ -374,6 +480,7 @@ namespace Falcor
         // Prepare scene resources.
         createSceneGraph();
         createMeshData();
+        uploadMeshData();
         createMeshBoundingBoxes();
         createCurveData();
         calculateCurveBoundingBoxes();
@@ -386,33 +493,37 @@ namespace Falcor
         for (auto& sdfInstanceData : mSceneData.sdfGridInstances) sdfInstanceData.instanceIndex = tlasInstanceIndex++;
 
         mSceneData.useCompressedHitInfo = is_set(mFlags, Flags::UseCompressedHitInfo);
+        mSceneData.preserveSourceObjects = is_set(mFlags, Flags::PreserveSourceObjects);
 
-        // Write scene cache if requested.
-        if (mWriteSceneCache)
-        {
-            SceneCache::writeCache(mSceneData, mSceneCacheKey);
-            timeReport.measure("Writing cache");
-        }
-
-        // Create the scene object.
-        mpScene = Scene::create(mpDevice, std::move(mSceneData));
-        mSceneData = {};
-
-        timeReport.measure("Creating resources");
+        timeReport.measure("Creating scene data");
         timeReport.printToLog();
 
-        return mpScene;
+        // No objects can be added from now on.
+        mSceneDataFinalized = true;
+    }
+
+    void SceneBuilder::checkNotFinalized() const
+    {
+        FALCOR_CHECK(!mSceneDataFinalized, "Can't add objects to the scene builder after the scene has been built or exported with exportPackage().");
     }
 
     // Meshes
 
     MeshID SceneBuilder::addMesh(const Mesh& mesh)
     {
+        checkNotFinalized();
         return addProcessedMesh(processMesh(mesh));
     }
 
+    MeshID SceneBuilder::addMesh(OwnedMesh&& mesh)
+    {
+        checkNotFinalized();
+        return addProcessedMesh(processMesh(std::move(mesh)));
+    }
+
     MeshID SceneBuilder::addTriangleMesh(const ref<TriangleMesh>& pTriangleMesh, const ref<Material>& pMaterial, bool isAnimated)
     {
+        checkNotFinalized();
         FALCOR_CHECK(pTriangleMesh != nullptr, "'pTriangleMesh' is missing");
         FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
 
@@ -420,6 +531,8 @@ namespace Falcor
 
         const auto& indices = pTriangleMesh->getIndices();
         const auto& vertices = pTriangleMesh->getVertices();
+        const TriangleMesh::Vertex* pVertices = vertices.empty() ? nullptr : vertices.data();
+        const uint32_t stride = (uint32_t)sizeof(TriangleMesh::Vertex);
 
         mesh.name = pTriangleMesh->getName();
         mesh.faceCount = (uint32_t)(indices.size() / 3);
@@ -431,21 +544,29 @@ namespace Falcor
         mesh.pMaterial = pMaterial;
         mesh.isAnimated = isAnimated;
 
-        std::vector<float3> positions(vertices.size());
-        std::vector<float3> normals(vertices.size());
-        std::vector<float2> texCoords(vertices.size());
-        std::transform(vertices.begin(), vertices.end(), positions.begin(), [] (const auto& v) { return v.position; });
-        std::transform(vertices.begin(), vertices.end(), normals.begin(), [] (const auto& v) { return v.normal; });
-        std::transform(vertices.begin(), vertices.end(), texCoords.begin(), [] (const auto& v) { return v.texCoord; });
-
-        mesh.positions = { positions.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
-        mesh.normals = { normals.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
-        mesh.texCrds = { texCoords.data(), SceneBuilder::Mesh::AttributeFrequency::Vertex };
+        // Reference the interleaved vertices of the triangle mesh directly instead of copying them into separate arrays.
+        mesh.positions = { pVertices ? &pVertices->position : nullptr, Mesh::AttributeFrequency::Vertex, stride };
+        mesh.normals = { pVertices ? &pVertices->normal : nullptr, Mesh::AttributeFrequency::Vertex, stride };
+        mesh.texCrds = { pVertices ? &pVertices->texCoord : nullptr, Mesh::AttributeFrequency::Vertex, stride };
 
         return addMesh(mesh);
     }
 
     SceneBuilder::ProcessedMesh SceneBuilder::processMesh(const Mesh& mesh_, MeshAttributeIndices* pAttributeIndices, std::vector<float4>* pTangents) const
+    {
+        // Copy the mesh desc so we can update it. The caller retains the ownership of the data.
+        Mesh mesh = mesh_;
+        return processMeshInternal(mesh, nullptr, pAttributeIndices, pTangents);
+    }
+
+    SceneBuilder::ProcessedMesh SceneBuilder::processMesh(OwnedMesh&& mesh_, MeshAttributeIndices* pAttributeIndices, std::vector<float4>* pTangents) const
+    {
+        // Take over the data. The arrays are freed once they have been consumed.
+        OwnedMesh mesh = std::move(mesh_);
+        return processMeshInternal(mesh, &mesh, pAttributeIndices, pTangents);
+    }
+
+    SceneBuilder::ProcessedMesh SceneBuilder::processMeshInternal(Mesh& mesh, OwnedMesh* pOwnedMesh, MeshAttributeIndices* pAttributeIndices, std::vector<float4>* pTangents) const
     {
         // This function preprocesses a mesh into the final runtime representation.
         // Note the function needs to be thread safe. The following steps are performed:
@@ -454,9 +575,9 @@ namespace Falcor
         //  - Merge identical vertices, compute new indices (optional)
         //  - Validate final vertex data
         //  - Compact vertices/indices into runtime format
-
-        // Copy the mesh desc so we can update it. The caller retains the ownership of the data.
-        Mesh mesh = mesh_;
+        //
+        // If 'pOwnedMesh' is set, it holds the data that 'mesh' references. The index buffer is then
+        // rewritten in place and all input arrays are freed before the final vertex data is allocated.
         ProcessedMesh processedMesh;
 
         processedMesh.name = mesh.name;
@@ -489,12 +610,17 @@ namespace Falcor
         if (mesh.normals.pData == nullptr) missing_element_warning("normals");
         if (mesh.texCrds.pData == nullptr) missing_element_warning("texture coordinates");
 
-        if (mesh.hasBones())
+        const bool hasBones = mesh.hasBones();
+        if (hasBones)
         {
             if (mesh.boneIDs.pData == nullptr) throw_on_missing_element("bone IDs");
             if (mesh.boneWeights.pData == nullptr) throw_on_missing_element("bone weights");
         }
 
+        const size_t ownedByteSize = pOwnedMesh ? pOwnedMesh->getByteSize() : 0;
+        mProcessedMeshCount++;
+        mInputMeshBytes += getMeshInputByteSize(mesh);
+
         // Generate tangent space if that's required.
         std::vector<float4> localTangents;
         if (!pTangents)
@@ -512,7 +638,14 @@ namespace Falcor
             if (xform != float4x4::identity())
             {
                 size_t texCoordCount = mesh.getAttributeCount(mesh.texCrds);
-                transformedTexCoords.resize(texCoordCount);
+                // Transform owned texture coordinates in place.
+                const bool inPlace = pOwnedMesh && mesh.texCrds.pData == pOwnedMesh->texCrdData.data() && mesh.texCrds.stride == 0;
+                float2* pTransformed = inPlace ? pOwnedMesh->texCrdData.data() : nullptr;
+                if (!inPlace)
+                {
+                    transformedTexCoords.resize(texCoordCount);
+                    pTransformed = transformedTexCoords.data();
+                }
                 // The given matrix transforms the texture (e.g., scaling > 1 enlarges the texture).
                 // Because we're transforming the input coordinates, apply the inverse.
                 const float4x4 invXform = inverse(xform);
@@ -525,9 +658,10 @@ namespace Falcor
 
                 for (size_t i = 0; i < texCoordCount; ++i)
                 {
-                    transformedTexCoords[i] = mul(coordTransform, float3(mesh.texCrds.pData[i], 1.f));
+                    pTransformed[i] = mul(coordTransform, float3(mesh.get(mesh.texCrds, (uint32_t)i), 1.f));
                 }
-                mesh.texCrds.pData = transformedTexCoords.data();
+                mesh.texCrds.pData = pTransformed;
+                mesh.texCrds.stride = 0;
             }
         }
 
@@ -540,9 +674,14 @@ namespace Falcor
         // The 'heads' array point to the first vertex in each list, and each vertex has an associated next-pointer.
         // This ensures that adding to the linked lists do not require any dynamic memory allocation.
         //
+        // An owned index buffer is reused for the new indices. This is safe as each index is read before it is written.
+        //
         const uint32_t invalidIndex = 0xffffffff;
         std::vector<std::pair<Mesh::Vertex, uint32_t>> vertices;
-        std::vector<uint32_t> indices(mesh.indexCount);
+        fast_vector<uint32_t> indices;
+        const bool reuseIndices = pOwnedMesh && mesh.pIndices == pOwnedMesh->indexData.data() && pOwnedMesh->indexData.size() == mesh.indexCount;
+        if (reuseIndices) indices = std::move(pOwnedMesh->indexData);
+        else indices.resize(mesh.indexCount);
 
         if (pAttributeIndices)
         {
@@ -624,7 +763,16 @@ namespace Falcor
                 FALCOR_ASSERT(vertices.size() == pAttributeIndices->size());
             }
 
-            indices.assign(mesh.pIndices, mesh.pIndices + mesh.indexCount);
+            if (!reuseIndices) indices.assign(mesh.pIndices, mesh.pIndices + mesh.indexCount);
+        }
+
+        // All input attributes have been gathered into 'vertices'. Free owned input data before allocating the output.
+        if (pOwnedMesh)
+        {
+            pOwnedMesh->release();
+            localTangents = {};
+            mAdoptedMeshCount++;
+            mAdoptedMeshBytes += ownedByteSize;
         }
 
         FALCOR_ASSERT(vertices.size() > 0);
@@ -654,13 +802,13 @@ namespace Falcor
             processedMesh.indexCount = indices.size();
             processedMesh.use16BitIndices = (vertices.size() <= (1u << 16)) && !(is_set(mFlags, Flags::Force32BitIndices));
 
-            if (!processedMesh.use16BitIndices) processedMesh.indexData = std::move(indices);
+            if (!processedMesh.use16BitIndices) processedMesh.indexData.assign(indices.begin(), indices.end());
             else processedMesh.indexData = compact16BitIndices(indices);
         }
 
         // Copy vertices into processed mesh.
         processedMesh.staticData.resize(vertexCount);
-        if (mesh.hasBones()) processedMesh.skinningData.resize(vertexCount);
+        if (hasBones) processedMesh.skinningData.resize(vertexCount);
 
         for (uint32_t i = 0; i < vertexCount; i++)
         {
@@ -678,7 +826,7 @@ namespace Falcor
                 processedMesh.staticData[i] = s;
             }
 
-            if (mesh.hasBones())
+            if (hasBones)
             {
                 SkinningVertexData s;
                 s.boneWeight = v.boneWeights;
@@ -695,7 +843,40 @@ namespace Falcor
 
     void SceneBuilder::generateTangents(Mesh& mesh, std::vector<float4>& tangents)
     {
-        tangents = MikkTSpaceWrapper::generateTangents(mesh);
+        if (!mesh.normals.pData || !mesh.positions.pData || !mesh.texCrds.pData || !mesh.pIndices)
+        {
+            logWarning("Can't generate tangent space. The mesh '{}' doesn't have positions/normals/texCrd/indices.", mesh.name);
+            tangents.clear();
+        }
+        else
+        {
+            FALCOR_ASSERT(mesh.indexCount > 0);
+            FALCOR_ASSERT_EQ(mesh.indexCount, mesh.faceCount * 3);
+
+            // Gather face-varying attributes.
+            std::vector<float3> positions(mesh.indexCount);
+            std::vector<float3> normals(mesh.indexCount);
+            std::vector<float2> texCrds(mesh.indexCount);
+            NumericRange<uint32_t> range(0, mesh.indexCount);
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t fvIndex)
+            {
+                uint32_t faceIndex = fvIndex / 3;
+                uint32_t vertexIndex = fvIndex % 3;
+                positions[fvIndex] = mesh.getPosition(faceIndex, vertexIndex);
+                normals[fvIndex] = mesh.getNormal(faceIndex, vertexIndex);
+                texCrds[fvIndex] = mesh.getTexCrd(faceIndex, vertexIndex);
+            });
+
+            try
+            {
+                tangents = TangentSpaceGenerator::generate(positions, normals, texCrds);
+            }
+            catch (const RuntimeError& e)
+            {
+                FALCOR_THROW("Failed to generate tangents for the mesh '{}': {}", mesh.name, e.what());
+            }
+        }
+
         if (!tangents.empty())
         {
             FALCOR_ASSERT(tangents.size() == mesh.indexCount);
@@ -705,20 +886,18 @@ namespace Falcor
             /// MikkTSpace can produces NaN tangents in case of degenerate triangles,
             /// e.g. triangles where all three points, normals, and texture coordinates happen to be identical.
             /// We are replacing these NaN tangents by arbitrary tangent orthonormal to the vertex normal
-            if (mesh.tangents.pData)
+            NumericRange<uint32_t> range(0, mesh.indexCount);
+            std::for_each(std::execution::par_unseq, range.begin(), range.end(), [&](uint32_t fvIndex)
             {
-                FALCOR_ASSERT(mesh.tangents.frequency == Mesh::AttributeFrequency::FaceVarying);
-                NumericRange<uint32_t> range(0, mesh.indexCount);
-                std::for_each(std::execution::par_unseq, range.begin(), range.end(), [&](uint32_t fvIndex)
-                {
-                    if (!any(isnan(mesh.tangents.pData[fvIndex])))
-                        return;
-                    uint32_t faceIndex = fvIndex / 3;
-                    uint32_t vertexIndex = fvIndex % 3;
-                    float3 normal = mesh.getNormal(faceIndex, vertexIndex);
-                    tangents[fvIndex] = float4(perp_stark(normal), 1.f);
-                });
-            }
+                float4& tangent = tangents[fvIndex];
+                tangent = float4(normalize(tangent.xyz()), tangent.w);
+                if (!any(isnan(tangent)))
+                    return;
+                uint32_t faceIndex = fvIndex / 3;
+                uint32_t vertexIndex = fvIndex % 3;
+                float3 normal = mesh.getNormal(faceIndex, vertexIndex);
+                tangent = float4(perp_stark(normal), 1.f);
+            });
         }
         else
         {
@@ -727,8 +906,107 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::OwnedMesh::setIndices(fast_vector<uint32_t>&& indices)
+    {
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count ({}) must be a multiple of 3.", indices.size());
+        indexData = std::move(indices);
+        indexCount = (uint32_t)indexData.size();
+        faceCount = indexCount / 3;
+        pIndices = indexData.data();
+    }
+
+    void SceneBuilder::OwnedMesh::setPositions(fast_vector<float3>&& data, AttributeFrequency frequency)
+    {
+        positionData = std::move(data);
+        positions = { positionData.data(), frequency };
+        if (frequency == AttributeFrequency::Vertex) vertexCount = (uint32_t)positionData.size();
+    }
+
+    void SceneBuilder::OwnedMesh::setNormals(fast_vector<float3>&& data, AttributeFrequency frequency)
+    {
+        normalData = std::move(data);
+        normals = { normalData.data(), frequency };
+    }
+
+    void SceneBuilder::OwnedMesh::setTangents(fast_vector<float4>&& data, AttributeFrequency frequency)
+    {
+        tangentData = std::move(data);
+        tangents = { tangentData.data(), frequency };
+    }
+
+    void SceneBuilder::OwnedMesh::setTexCrds(fast_vector<float2>&& data, AttributeFrequency frequency)
+    {
+        texCrdData = std::move(data);
+        texCrds = { texCrdData.data(), frequency };
+    }
+
+    void SceneBuilder::OwnedMesh::setCurveRadii(fast_vector<float>&& data, AttributeFrequency frequency)
+    {
+        curveRadiusData = std::move(data);
+        curveRadii = { curveRadiusData.data(), frequency };
+    }
+
+    void SceneBuilder::OwnedMesh::setBones(fast_vector<uint4>&& ids, fast_vector<float4>&& weights, AttributeFrequency frequency)
+    {
+        FALCOR_CHECK(ids.size() == weights.size(), "Bone ID count ({}) doesn't match bone weight count ({}).", ids.size(), weights.size());
+        boneIDData = std::move(ids);
+        boneWeightData = std::move(weights);
+        boneIDs = { boneIDData.data(), frequency };
+        boneWeights = { boneWeightData.data(), frequency };
+    }
+
+    void SceneBuilder::OwnedMesh::release()
+    {
+        auto freeArray = [](auto& data) { data = std::decay_t<decltype(data)>(); };
+        freeArray(indexData);
+        freeArray(positionData);
+        freeArray(normalData);
+        freeArray(tangentData);
+        freeArray(texCrdData);
+        freeArray(curveRadiusData);
+        freeArray(boneIDData);
+        freeArray(boneWeightData);
+
+        pIndices = nullptr;
+        positions.pData = nullptr;
+        normals.pData = nullptr;
+        tangents.pData = nullptr;
+        texCrds.pData = nullptr;
+        curveRadii.pData = nullptr;
+        boneIDs.pData = nullptr;
+        boneWeights.pData = nullptr;
+    }
+
+    size_t SceneBuilder::OwnedMesh::getByteSize() const
+    {
+        return indexData.size() * sizeof(uint32_t) + positionData.size() * sizeof(float3) + normalData.size() * sizeof(float3) +
+            tangentData.size() * sizeof(float4) + texCrdData.size() * sizeof(float2) + curveRadiusData.size() * sizeof(float) +
+            boneIDData.size() * sizeof(uint4) + boneWeightData.size() * sizeof(float4);
+    }
+
+    SceneBuilder::ImportStats SceneBuilder::getImportStats() const
+    {
+        ImportStats stats;
+        stats.meshCount = mProcessedMeshCount;
+        stats.adoptedMeshCount = mAdoptedMeshCount;
+        stats.inputMeshBytes = mInputMeshBytes;
+        stats.adoptedMeshBytes = mAdoptedMeshBytes;
+        stats.processedMeshBytes = mProcessedMeshBytes;
+        stats.peakResidentMeshBytes = mPeakResidentMeshBytes;
+        stats.spillFileBytes = mpSpillFile ? mpSpillFile->getSize() : 0;
+        stats.peakRSS = getPeakRSS();
+        return stats;
+    }
+
     MeshID SceneBuilder::addProcessedMesh(const ProcessedMesh& mesh)
     {
+        checkNotFinalized();
+        return addProcessedMesh(ProcessedMesh(mesh));
+    }
+
+    MeshID SceneBuilder::addProcessedMesh(ProcessedMesh&& mesh)
+    {
+        checkNotFinalized();
         const bool isIndexed = !is_set(mFlags, Flags::NonIndexedVertices);
 
         MeshSpec spec;
@@ -762,18 +1040,27 @@ namespace Falcor
             spec.prevVertexCount = spec.skinningVertexCount;
         }
 
-        mMeshes.push_back(spec);
+        mProcessedMeshBytes += spec.indexData.size() * sizeof(uint32_t) + spec.staticData.size() * sizeof(StaticVertexData) + spec.skinningData.size() * sizeof(SkinningVertexData);
+
+        mMeshes.push_back(std::move(spec));
 
         if (mMeshes.size() > std::numeric_limits<uint32_t>::max())
         {
             FALCOR_THROW("Trying to build a scene that exceeds supported number of meshes");
         }
 
+        if (isOutOfCore())
+        {
+            mResidentMeshBytes += mMeshes.back().getDataByteSize();
+            trimMeshData(&mMeshes.back());
+        }
+
         return MeshID(mMeshes.size() - 1);
     }
 
     void SceneBuilder::addCachedMeshes(std::vector<CachedMesh>&& cachedMeshes)
     {
+        checkNotFinalized();
         mSceneData.cachedMeshes.reserve(mSceneData.cachedMeshes.size() + cachedMeshes.size());
         for (auto&& it : cachedMeshes)
             mSceneData.cachedMeshes.push_back(std::move(it));
@@ -781,11 +1068,13 @@ namespace Falcor
 
     void SceneBuilder::addCachedMesh(CachedMesh&& cachedMesh)
     {
+        checkNotFinalized();
         mSceneData.cachedMeshes.push_back(std::move(cachedMesh));
     }
 
     void SceneBuilder::addCustomPrimitive(uint32_t userID, const AABB& aabb)
     {
+        checkNotFinalized();
         // Currently each custom primitive has exactly one AABB. This may change in the future.
         FALCOR_ASSERT(mSceneData.customPrimitiveDesc.size() == mSceneData.customPrimitiveAABBs.size());
         if (mSceneData.customPrimitiveAABBs.size() > std::numeric_limits<uint32_t>::max())
@@ -805,6 +1094,7 @@ namespace Falcor
 
     CurveID SceneBuilder::addCurve(const Curve& curve)
     {
+        checkNotFinalized();
         return addProcessedCurve(processCurve(curve));
     }
 
@@ -863,6 +1153,7 @@ namespace Falcor
 
     CurveID SceneBuilder::addProcessedCurve(const ProcessedCurve& curve)
     {
+        checkNotFinalized();
         CurveSpec spec;
 
         // Add the curve to the scene.
@@ -890,6 +1181,7 @@ namespace Falcor
 
     void SceneBuilder::addCachedCurves(std::vector<CachedCurve>&& cachedCurves)
     {
+        checkNotFinalized();
         mSceneData.cachedCurves.reserve(mSceneData.cachedCurves.size() + cachedCurves.size());
         for (auto&& it : cachedCurves)
             mSceneData.cachedCurves.push_back(std::move(it));
@@ -897,6 +1189,7 @@ namespace Falcor
 
     void SceneBuilder::addCachedCurve(CachedCurve&& cachedCurve)
     {
+        checkNotFinalized();
         mSceneData.cachedCurves.push_back(std::move(cachedCurve));
     }
 
@@ -905,6 +1198,7 @@ namespace Falcor
 
     SdfDescID SceneBuilder::addSDFGrid(const ref<SDFGrid>& pSDFGrid, const ref<Material>& pMaterial)
     {
+        checkNotFinalized();
         FALCOR_CHECK(pSDFGrid != nullptr, "'pSDFGrid' is missing");
         FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
 
@@ -922,6 +1216,7 @@ namespace Falcor
 
     MaterialID SceneBuilder::addMaterial(const ref<Material>& pMaterial)
     {
+        checkNotFinalized();
         FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
         return mSceneData.pMaterials->addMaterial(pMaterial);
     }
@@ -935,6 +1230,7 @@ namespace Falcor
 
     void SceneBuilder::loadMaterialTexture(const ref<Material>& pMaterial, Material::TextureSlot slot, const std::filesystem::path& path)
     {
+        checkNotFinalized();
         FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
         if (!mpMaterialTextureLoader)
         {
@@ -962,6 +1258,7 @@ namespace Falcor
 
     VolumeID SceneBuilder::addGridVolume(const ref<GridVolume>& pGridVolume, NodeID nodeID)
     {
+        checkNotFinalized();
         FALCOR_ASSERT(pGridVolume);
         FALCOR_CHECK(nodeID == NodeID::Invalid() || nodeID.get() < mSceneGraph.size(), "'nodeID' ({}) is out of range", nodeID);
 
@@ -989,6 +1286,7 @@ namespace Falcor
 
     LightID SceneBuilder::addLight(const ref<Light>& pLight)
     {
+        checkNotFinalized();
         FALCOR_CHECK(pLight != nullptr, "'pLight' is missing");
         mSceneData.lights.push_back(pLight);
         FALCOR_ASSERT(mSceneData.lights.size() <= std::numeric_limits<uint32_t>::max());
@@ -997,6 +1295,7 @@ namespace Falcor
 
     void SceneBuilder::loadLightProfile(const std::string& filename, bool normalize)
     {
+        checkNotFinalized();
         mSceneData.pLightProfile = LightProfile::createFromIesProfile(mpDevice, mAssetResolver.resolvePath(std::filesystem::path(filename)), normalize);
     }
 
@@ -1004,6 +1303,7 @@ namespace Falcor
 
     CameraID SceneBuilder::addCamera(const ref<Camera>& pCamera)
     {
+        checkNotFinalized();
         FALCOR_CHECK(pCamera != nullptr, "'pCamera' is missing");
         mSceneData.cameras.push_back(pCamera);
         FALCOR_ASSERT(mSceneData.cameras.size() <= std::numeric_limits<uint32_t>::max());
@@ -1017,6 +1317,7 @@ namespace Falcor
 
     void SceneBuilder::setSelectedCamera(const ref<Camera>& pCamera)
     {
+        checkNotFinalized();
         auto it = std::find(mSceneData.cameras.begin(), mSceneData.cameras.end(), pCamera);
         mSceneData.selectedCamera = it != mSceneData.cameras.end() ? (uint32_t)std::distance(mSceneData.cameras.begin(), it) : 0;
     }
@@ -1025,12 +1326,14 @@ namespace Falcor
 
     void SceneBuilder::addAnimation(const ref<Animation>& pAnimation)
     {
+        checkNotFinalized();
         FALCOR_CHECK(pAnimation != nullptr, "'pAnimation' is missing");
         mSceneData.animations.push_back(pAnimation);
     }
 
     ref<Animation> SceneBuilder::createAnimation(ref<Animatable> pAnimatable, const std::string& name, double duration)
     {
+        checkNotFinalized();
         FALCOR_CHECK(pAnimatable != nullptr, "'pAnimatable' is missing");
 
         NodeID nodeID = pAnimatable->getNodeID();
@@ -1055,6 +1358,7 @@ namespace Falcor
 
     NodeID SceneBuilder::addNode(const Node& node)
     {
+        checkNotFinalized();
         // Validate node.
         auto validateMatrix = [&](float4x4 m, const char* field)
         {
@@ -1089,6 +1393,7 @@ namespace Falcor
 
     void SceneBuilder::addMeshInstance(NodeID nodeID, MeshID meshID)
     {
+        checkNotFinalized();
         FALCOR_CHECK(nodeID.get() < mSceneGraph.size(), "'nodeID' ({}) is out of range", nodeID);
         FALCOR_CHECK(meshID.get() < mMeshes.size(), "'meshID' ({}) is out of range", meshID);
 
@@ -1098,6 +1403,7 @@ namespace Falcor
 
     void SceneBuilder::addCurveInstance(NodeID nodeID, CurveID curveID)
     {
+        checkNotFinalized();
         FALCOR_CHECK(nodeID.get() < mSceneGraph.size(), "'nodeID' ({}) is out of range", nodeID);
         FALCOR_CHECK(curveID.get() < mCurves.size(), "'curveID' ({}) is out of range", curveID);
 
@@ -1107,6 +1413,7 @@ namespace Falcor
 
     void SceneBuilder::addSDFGridInstance(NodeID nodeID, SdfDescID sdfGridID)
     {
+        checkNotFinalized();
         FALCOR_CHECK(nodeID.get() < mSceneGraph.size(), "'nodeID' ({}) is out of range", nodeID);
         FALCOR_CHECK(sdfGridID.get() < mSceneData.sdfGridDesc.size(), "'sdfGridID' ({}) is out of range", sdfGridID);
 
@@ -1458,13 +1765,178 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::generateMeshLODs()
+    {
+        // This function optionally generates simplified levels of detail for static triangle meshes.
+        // The LOD chains are generated in parallel over the meshes. Each instance then uses the coarsest
+        // level whose simplification error projects to less than the maximum pixel error as seen from the
+        // selected camera. Animated instances always use the original mesh. Only the levels that are used
+        // are kept: the finest one replaces the original mesh data and the others are added as new meshes.
+
+        if (!is_set(mFlags, Flags::GenerateMeshLODs))
+        {
+            return;
+        }
+
+        auto pCamera = getSelectedCamera();
+        if (!pCamera)
+        {
+            logWarning("Scene has no camera. Skipping mesh LOD generation.");
+            return;
+        }
+
+        const MeshLODSettings& settings = mMeshLODSettings;
+        FALCOR_CHECK(settings.reductionRatio > 0.f && settings.reductionRatio < 1.f, "'MeshLOD:reductionRatio' ({}) must be in the range (0,1).", settings.reductionRatio);
+
+        std::vector<MeshID> meshIDs;
+        for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
+        {
+            const auto& mesh = mMeshes[meshID.get()];
+            if (mesh.topology != Vao::Topology::TriangleList || mesh.indexCount == 0 || mesh.isDynamic() || mesh.isDisplaced) continue;
+            if (mesh.getTriangleCount() <= settings.minTriangleCount) continue;
+            meshIDs.push_back(meshID);
+        }
+
+        if (meshIDs.empty())
+        {
+            return;
+        }
+
+        // Generate the LOD chains.
+        std::vector<MeshLODChain> chains(meshIDs.size());
+        NumericRange<uint32_t> range(0, (uint32_t)meshIDs.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t i)
+        {
+            MeshSpec tmp;
+            const auto& mesh = getResidentMesh(mMeshes[meshIDs[i].get()], tmp);
+            std::vector<float3> positions(mesh.staticData.size());
+            for (size_t v = 0; v < positions.size(); v++) positions[v] = mesh.staticData[v].position;
+            std::vector<uint32_t> indices(mesh.indexCount);
+            for (uint32_t j = 0; j < mesh.indexCount; j++) indices[j] = mesh.getIndex(j);
+            chains[i] = generateMeshLODChain(positions, indices, settings);
+        });
+
+        // Replace the mesh data by the data of a level. Only the vertices referenced by the level are kept.
+        auto setLevelData = [this](MeshSpec& mesh, const std::vector<StaticVertexData>& staticData, const std::vector<uint32_t>& indices)
+        {
+            std::vector<uint32_t> vertexMap(staticData.size(), std::numeric_limits<uint32_t>::max());
+            std::vector<uint32_t> levelIndices(indices.size());
+            mesh.staticData.clear();
+            for (size_t j = 0; j < indices.size(); j++)
+            {
+                uint32_t& v = vertexMap[indices[j]];
+                if (v == std::numeric_limits<uint32_t>::max())
+                {
+                    v = (uint32_t)mesh.staticData.size();
+                    mesh.staticData.push_back(staticData[indices[j]]);
+                }
+                levelIndices[j] = v;
+            }
+
+            mesh.indexCount = (uint32_t)levelIndices.size();
+            mesh.vertexCount = (uint32_t)mesh.staticData.size();
+            mesh.staticVertexCount = mesh.vertexCount;
+            mesh.use16BitIndices = (mesh.vertexCount <= (1u << 16)) && !(is_set(mFlags, Flags::Force32BitIndices));
+            mesh.indexData = mesh.use16BitIndices ? compact16BitIndices(levelIndices) : std::move(levelIndices);
+        };
+
+        // Select a level for each instance and create the meshes.
+        const MeshLODSelector selector(focalLengthToFovY(pCamera->getFocalLength(), pCamera->getFrameHeight()), settings.viewportHeight, settings.maxPixelError);
+        const float3 cameraPosition = pCamera->getPosition();
+
+        std::vector<MeshSpec> newMeshes;
+        uint64_t originalTriangleCount = 0;
+        uint64_t triangleCount = 0;
+        size_t simplifiedInstanceCount = 0;
+        float maxError = 0.f;
+
+        for (size_t i = 0; i < meshIDs.size(); i++)
+        {
+            const MeshID meshID = meshIDs[i];
+            auto& mesh = mMeshes[meshID.get()];
+            auto& chain = chains[i];
+            FALCOR_ASSERT(!mesh.instances.empty());
+            loadMeshData(mesh);
+
+            AABB meshBB;
+            for (const auto& v : mesh.staticData) meshBB.include(v.position);
+
+            std::vector<std::vector<NodeID>> levelInstances(chain.levels.size());
+            for (NodeID nodeID : mesh.instances)
+            {
+                uint32_t level = 0;
+                if (!isNodeAnimated(nodeID))
+                {
+                    float4x4 transform = float4x4::identity();
+                    for (NodeID curID = nodeID; curID != NodeID::Invalid(); curID = mSceneGraph[curID.get()].parent)
+                    {
+                        transform = mul(mSceneGraph[curID.get()].transform, transform);
+                    }
+
+                    float scale = 0.f;
+                    for (int j = 0; j < 3; j++) scale = std::max(scale, length(transform.getCol(j).xyz()));
+                    float distance = MeshLODSelector::getDistance(meshBB.transform(transform), cameraPosition);
+                    level = selector.selectLevel(chain.levels, distance, scale);
+                }
+                levelInstances[level].push_back(nodeID);
+                chain.levels[level].instanceCount++;
+            }
+
+            originalTriangleCount += (uint64_t)chain.levels[0].triangleCount * mesh.instances.size();
+            for (const auto& level : chain.levels)
+            {
+                triangleCount += (uint64_t)level.triangleCount * level.instanceCount;
+                if (level.instanceCount > 0) maxError = std::max(maxError, level.error);
+            }
+            simplifiedInstanceCount += mesh.instances.size() - levelInstances[0].size();
+            mSceneData.meshLODs.push_back({ mesh.name, chain.levels });
+
+            // Add the used levels, except the finest one, as new meshes.
+            const uint32_t finestLevel = (uint32_t)std::distance(levelInstances.begin(), std::find_if(levelInstances.begin(), levelInstances.end(), [](const auto& instances) { return !instances.empty(); }));
+            for (uint32_t level = finestLevel + 1; level < (uint32_t)chain.levels.size(); level++)
+            {
+                if (levelInstances[level].empty()) continue;
+
+                MeshSpec lodMesh = mesh;
+                lodMesh.name = mesh.name + "_LOD" + std::to_string(level);
+                setLevelData(lodMesh, mesh.staticData, chain.indices[level]);
+                lodMesh.instances = std::set<NodeID>(levelInstances[level].begin(), levelInstances[level].end());
+
+                // Move the instances to the new mesh.
+                const MeshID lodMeshID(mMeshes.size() + newMeshes.size());
+                for (NodeID nodeID : levelInstances[level])
+                {
+                    auto& node = mSceneGraph[nodeID.get()];
+                    std::replace(node.meshes.begin(), node.meshes.end(), meshID, lodMeshID);
+                    mesh.instances.erase(nodeID);
+                }
+                if (isOutOfCore()) spillMeshData(lodMesh);
+                newMeshes.push_back(std::move(lodMesh));
+            }
+
+            if (finestLevel > 0)
+            {
+                std::vector<StaticVertexData> staticData = std::move(mesh.staticData);
+                setLevelData(mesh, staticData, chain.indices[finestLevel]);
+            }
+
+            trimMeshData();
+        }
+
+        mMeshes.insert(mMeshes.end(), std::make_move_iterator(newMeshes.begin()), std::make_move_iterator(newMeshes.end()));
+        updateResidentMeshBytes();
+
+        logInfo("Generated mesh LODs for {} out of {} meshes. {} instances use simplified levels, reducing the instanced triangle count from {} to {} (max error {}).",
+            meshIDs.size(), mMeshes.size() - newMeshes.size(), simplifiedInstanceCount, originalTriangleCount, triangleCount, maxError);
+    }
+
     void SceneBuilder::flattenStaticMeshInstances()
     {
         // This function optionally flattens all instanced non-skinned mesh instances to
         // separate non-instanced meshes by duplicating mesh data and composing transformations.
         // The pass is disabled by default. Can lead to a large increase in memory use.
 
-        if (!is_set(mFlags, Flags::FlattenStaticMeshInstances))
+        if (!is_set(mFlags, Flags::FlattenStaticMeshInstances) || is_set(mFlags, Flags::PreserveSourceObjects))
         {
             return;
         }
@@ -1560,7 +2032,9 @@ namespace Falcor
                     MeshID newMeshID(mMeshes.size() + newMeshes.size());
                     newNode.meshes.push_back(newMeshID);
                     // Here, we do not insert nodeID into newInstances, effectively removing it.
-                    // Add to vector of meshes to be appended to mMeshes
+                    // Add to vector of meshes to be appended to mMeshes.
+                    // In out-of-core mode the copy is spilled right away. Copies of spilled meshes share the spilled data.
+                    if (isOutOfCore()) spillMeshData(*newMesh);
                     newMeshes.push_back(*newMesh);
                 }
             }
@@ -1576,6 +2050,7 @@ namespace Falcor
             mMeshes.reserve(mMeshes.size() + newMeshes.size());
             std::move(newMeshes.begin(), newMeshes.end(), std::back_inserter(mMeshes));
         }
+        updateResidentMeshBytes();
 
         if (flattenedInstanceCount > 0) logInfo("Flattened {} static instances.", flattenedInstanceCount);
     }
@@ -1584,7 +2059,7 @@ namespace Falcor
     {
         // This function optimizes the scene graph to flatten transform hierarchies
         // where possible by merging nodes.
-        if (is_set(mFlags, Flags::DontOptimizeGraph)) return;
+        if (is_set(mFlags, Flags::DontOptimizeGraph) || is_set(mFlags, Flags::PreserveSourceObjects)) return;
 
         // Iterate over all nodes to collapse sub-trees of static nodes.
         size_t removedNodes = 0;
@@ -1648,6 +2123,9 @@ namespace Falcor
         // This function transforms all static, non-instanced meshes to world space.
         // A new identity transform node is inserted in the scene graph, linking all transformed meshes.
         // This step is a prerequisite for the ray tracing optimizations we do later.
+        // It is skipped if node transforms need to stay editable.
+
+        if (is_set(mFlags, Flags::PreserveSourceObjects)) return;
 
         // Add an identity transform node.
         NodeID identityNodeID = addNode(Node{ "Identity", float4x4::identity(), float4x4::identity() });
@@ -1685,6 +2163,7 @@ namespace Falcor
             // Transform vertices to world space if not already identity transform.
             if (transform != float4x4::identity())
             {
+                loadMeshData(mesh);
                 FALCOR_ASSERT(!mesh.staticData.empty());
                 FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
 
@@ -1703,6 +2182,7 @@ namespace Falcor
                 }
 
                 transformedMeshCount++;
+                trimMeshData();
             }
 
             // Unlink mesh from its previous transform node.
@@ -1795,8 +2275,10 @@ namespace Falcor
             // Skip meshes that are already front face counter-clockwise.
             if (mesh.isFrontFaceCW == false) continue;
 
+            loadMeshData(mesh);
             flipTriangleWinding(mesh);
             FALCOR_ASSERT(!mesh.isFrontFaceCW);
+            trimMeshData();
 
             flippedMeshCount++;
         }
@@ -1808,6 +2290,7 @@ namespace Falcor
     {
         for (auto& mesh : mMeshes)
         {
+            loadMeshData(mesh);
             FALCOR_ASSERT(!mesh.staticData.empty());
             FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
 
@@ -1818,6 +2301,7 @@ namespace Falcor
             }
 
             mesh.boundingBox = meshBB;
+            trimMeshData();
         }
     }
 
@@ -1995,6 +2479,8 @@ namespace Falcor
         if (mesh.boundingBox.maxPoint[axis] < pos) return { meshID, std::nullopt };
         else if (mesh.boundingBox.minPoint[axis] >= pos) return { std::nullopt, meshID };
 
+        loadMeshData(mMeshes[meshID.get()]);
+
         // Setup mesh specs.
         auto createSpec = [](const MeshSpec& mesh, const std::string& name)
         {
@@ -2041,6 +2527,7 @@ namespace Falcor
             mSceneGraph.at(nodeID.get()).meshes.push_back(rightMeshID);
         }
         mMeshes.push_back(std::move(rightMesh));
+        trimMeshData();
 
         return { meshID, rightMeshID };
     }
@@ -2112,6 +2599,83 @@ namespace Falcor
         FALCOR_THROW("SceneBuilder::splitNonIndexedMesh() not implemented");
     }
 
+    bool SceneBuilder::isOutOfCore() const
+    {
+        return is_set(mFlags, Flags::OutOfCoreGeometry);
+    }
+
+    void SceneBuilder::spillMeshData(MeshSpec& mesh)
+    {
+        if (!mesh.isResident()) return;
+        if (!mpSpillFile) mpSpillFile = std::make_unique<GeometrySpillFile>(mGeometrySpillSettings.directory);
+
+        const uint64_t byteSize = mesh.getDataByteSize();
+
+        MeshSpec::SpilledData spilledData;
+        spilledData.indexData = mpSpillFile->write(mesh.indexData);
+        spilledData.staticData = mpSpillFile->write(mesh.staticData);
+        spilledData.skinningData = mpSpillFile->write(mesh.skinningData);
+        mesh.spilledData = spilledData;
+
+        mesh.indexData = {};
+        mesh.staticData = {};
+        mesh.skinningData = {};
+
+        mResidentMeshBytes -= std::min(mResidentMeshBytes, byteSize);
+    }
+
+    void SceneBuilder::loadMeshData(MeshSpec& mesh)
+    {
+        if (mesh.isResident()) return;
+        FALCOR_ASSERT(mpSpillFile);
+
+        mpSpillFile->read(mesh.spilledData->indexData, mesh.indexData);
+        mpSpillFile->read(mesh.spilledData->staticData, mesh.staticData);
+        mpSpillFile->read(mesh.spilledData->skinningData, mesh.skinningData);
+        mesh.spilledData.reset();
+
+        mResidentMeshBytes += mesh.getDataByteSize();
+        mPeakResidentMeshBytes = std::max(mPeakResidentMeshBytes, mResidentMeshBytes);
+    }
+
+    const SceneBuilder::MeshSpec& SceneBuilder::getResidentMesh(const MeshSpec& mesh, MeshSpec& tmp) const
+    {
+        // Read spilled data into a temporary copy, leaving the mesh itself untouched. This is thread safe.
+        if (mesh.isResident()) return mesh;
+        FALCOR_ASSERT(mpSpillFile);
+
+        tmp = mesh;
+        mpSpillFile->read(mesh.spilledData->indexData, tmp.indexData);
+        mpSpillFile->read(mesh.spilledData->staticData, tmp.staticData);
+        mpSpillFile->read(mesh.spilledData->skinningData, tmp.skinningData);
+        tmp.spilledData.reset();
+        return tmp;
+    }
+
+    void SceneBuilder::trimMeshData(const MeshSpec* pKeep)
+    {
+        // Spill meshes in round-robin order until the resident data is within the budget.
+        if (!isOutOfCore()) return;
+
+        mPeakResidentMeshBytes = std::max(mPeakResidentMeshBytes, mResidentMeshBytes);
+        for (size_t i = 0; i < mMeshes.size() && mResidentMeshBytes > mGeometrySpillSettings.hostMemoryBudget; i++)
+        {
+            if (mSpillCursor >= mMeshes.size()) mSpillCursor = 0;
+            MeshSpec& mesh = mMeshes[mSpillCursor++];
+            if (&mesh != pKeep) spillMeshData(mesh);
+        }
+    }
+
+    void SceneBuilder::updateResidentMeshBytes()
+    {
+        // Post-processing passes add and modify mesh data without tracking it. Recount and trim.
+        if (!isOutOfCore()) return;
+
+        mResidentMeshBytes = 0;
+        for (const auto& mesh : mMeshes) mResidentMeshBytes += mesh.getDataByteSize();
+        trimMeshData();
+    }
+
     size_t SceneBuilder::countTriangles(const MeshGroup& meshGroup) const
     {
         size_t triangleCount = 0;
@@ -2336,6 +2900,7 @@ namespace Falcor
         }
 
         mMeshGroups = std::move(optimizedGroups);
+        updateResidentMeshBytes();
     }
 
     void SceneBuilder::sortMeshes()
@@ -2383,6 +2948,65 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::createMeshlets()
+    {
+        // This function optionally splits the triangle meshes into meshlets for culling.
+        // The meshlets are built in parallel over the meshes and then concatenated in mesh order.
+        // The meshlet bounds are in object space, so dynamic and displaced meshes are not split.
+
+        if (!is_set(mFlags, Flags::GenerateMeshlets))
+        {
+            return;
+        }
+
+        std::vector<MeshletBuilder::Result> results(mMeshes.size());
+        NumericRange<uint32_t> range(0, (uint32_t)mMeshes.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t meshIndex)
+        {
+            if (mMeshes[meshIndex].topology != Vao::Topology::TriangleList || mMeshes[meshIndex].isDynamic() || mMeshes[meshIndex].isDisplaced) return;
+            MeshSpec tmp;
+            const auto& mesh = getResidentMesh(mMeshes[meshIndex], tmp);
+
+            std::vector<float3> positions(mesh.staticData.size());
+            for (size_t v = 0; v < positions.size(); v++) positions[v] = mesh.staticData[v].position;
+            std::vector<uint32_t> indices(mesh.indexCount > 0 ? mesh.indexCount : mesh.vertexCount);
+            for (uint32_t j = 0; j < (uint32_t)indices.size(); j++) indices[j] = mesh.indexCount > 0 ? mesh.getIndex(j) : j;
+            results[meshIndex] = MeshletBuilder::build(positions, indices);
+        });
+
+        size_t meshletCount = 0, vertexCount = 0, triangleCount = 0;
+        for (const auto& result : results)
+        {
+            meshletCount += result.meshlets.size();
+            vertexCount += result.vertices.size();
+            triangleCount += result.triangles.size();
+        }
+        if (vertexCount > std::numeric_limits<uint32_t>::max() || triangleCount > std::numeric_limits<uint32_t>::max())
+        {
+            FALCOR_THROW("Trying to build a scene that exceeds supported meshlet data size.");
+        }
+
+        mSceneData.meshlets.reserve(meshletCount);
+        mSceneData.meshletVertices.reserve(vertexCount);
+        mSceneData.meshletTriangles.reserve(triangleCount);
+        mSceneData.meshletOffsets.reserve(mMeshes.size() + 1);
+        for (auto& result : results)
+        {
+            mSceneData.meshletOffsets.push_back((uint32_t)mSceneData.meshlets.size());
+            for (auto meshlet : result.meshlets)
+            {
+                meshlet.vertexOffset += (uint32_t)mSceneData.meshletVertices.size();
+                meshlet.triangleOffset += (uint32_t)mSceneData.meshletTriangles.size();
+                mSceneData.meshlets.push_back(meshlet);
+            }
+            mSceneData.meshletVertices.insert(mSceneData.meshletVertices.end(), result.vertices.begin(), result.vertices.end());
+            mSceneData.meshletTriangles.insert(mSceneData.meshletTriangles.end(), result.triangles.begin(), result.triangles.end());
+        }
+        mSceneData.meshletOffsets.push_back((uint32_t)mSceneData.meshlets.size());
+
+        logInfo("Created {} meshlets with an average of {:.1f} triangles.", meshletCount, meshletCount > 0 ? (double)triangleCount / meshletCount : 0.0);
+    }
+
     void SceneBuilder::createGlobalBuffers()
     {
         FALCOR_ASSERT(mSceneData.meshIndexData.empty());
@@ -2396,11 +3020,20 @@ namespace Falcor
         size_t totalStaticVertexCount = 0;
         size_t totalSkinningVertexCount = 0;
 
+        auto getIndexDataCount = [](const MeshSpec& mesh)
+        {
+            return mesh.isResident() ? mesh.indexData.size() : mesh.spilledData->indexData.size / sizeof(uint32_t);
+        };
+        auto getStaticVertexCount = [](const MeshSpec& mesh)
+        {
+            return mesh.isResident() ? mesh.staticData.size() : mesh.spilledData->staticData.size / sizeof(StaticVertexData);
+        };
+
         for (const auto& mesh : mMeshes)
         {
-            totalIndexDataCount += mesh.indexData.size();
-            totalStaticVertexCount += mesh.staticData.size();
-            totalSkinningVertexCount += mesh.skinningData.size();
+            totalIndexDataCount += getIndexDataCount(mesh);
+            totalStaticVertexCount += getStaticVertexCount(mesh);
+            totalSkinningVertexCount += mesh.isResident() ? mesh.skinningData.size() : mesh.spilledData->skinningData.size / sizeof(SkinningVertexData);
             mSceneData.prevVertexCount += mesh.prevVertexCount;
         }
 
@@ -2412,13 +3045,64 @@ namespace Falcor
             FALCOR_THROW("Trying to build a scene that exceeds supported mesh data size.");
         }
 
+        // In out-of-core mode, the mesh data is uploaded to the GPU buffers in chunks by uploadMeshData() instead of being
+        // gathered in host memory. This is only possible if nothing reads the global arrays on the host, i.e. no scene cache
+        // or package is written, no CPU ray query is built and there are no skinned or vertex-animated meshes.
+        mUploadMeshData = isOutOfCore() && !mKeepHostMeshData && !mWriteSceneCache && !is_set(mFlags, Flags::BuildCpuRayQuery) &&
+            totalSkinningVertexCount == 0 && mSceneData.prevVertexCount == 0;
+
+        if (mUploadMeshData)
+        {
+            if (totalIndexDataCount * sizeof(uint32_t) > std::numeric_limits<uint32_t>::max())
+            {
+                FALCOR_THROW("Index buffer size exceeds 4GB");
+            }
+            if (totalStaticVertexCount * sizeof(PackedStaticVertexData) > std::numeric_limits<uint32_t>::max())
+            {
+                FALCOR_THROW("Vertex buffer size exceeds 4GB");
+            }
+
+            // Create the GPU buffers with the same layout as Scene::createMeshVao().
+            if (isIndexed && totalIndexDataCount > 0)
+            {
+                ResourceBindFlags ibBindFlags = ResourceBindFlags::Index | ResourceBindFlags::ShaderResource;
+                mSceneData.pMeshIndexBuffer = mpDevice->createBuffer(totalIndexDataCount * sizeof(uint32_t), ibBindFlags, MemoryType::DeviceLocal, nullptr);
+            }
+            if (totalStaticVertexCount > 0)
+            {
+                ResourceBindFlags vbBindFlags = ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess | ResourceBindFlags::Vertex;
+                mSceneData.pMeshStaticBuffer = mpDevice->createStructuredBuffer(sizeof(PackedStaticVertexData), (uint32_t)totalStaticVertexCount, vbBindFlags, MemoryType::DeviceLocal, nullptr, false);
+            }
+
+            // Only assign the offsets here. The mesh data stays with the meshes (resident or spilled) until it is uploaded.
+            uint32_t staticVertexOffset = 0;
+            uint32_t indexOffset = 0;
+            for (auto& mesh : mMeshes)
+            {
+                mesh.staticVertexOffset = staticVertexOffset;
+                mesh.skinningVertexOffset = 0;
+                mesh.prevVertexOffset = 0;
+                staticVertexOffset += (uint32_t)getStaticVertexCount(mesh);
+
+                if (isIndexed)
+                {
+                    mesh.indexOffset = indexOffset;
+                    indexOffset += (uint32_t)getIndexDataCount(mesh);
+                }
+            }
+            return;
+        }
+
         mSceneData.meshIndexData.reserve(totalIndexDataCount);
         mSceneData.meshStaticData.reserve(totalStaticVertexCount);
         mSceneData.meshSkinningData.reserve(totalSkinningVertexCount);
 
         // Copy all vertex and index data into the global buffers.
+        // Spilled meshes are read back one at a time.
         for (auto& mesh : mMeshes)
         {
+            loadMeshData(mesh);
+
             mesh.staticVertexOffset = (uint32_t)mSceneData.meshStaticData.size();
             mesh.skinningVertexOffset = (uint32_t)mSceneData.meshSkinningData.size();
             mesh.prevVertexOffset = mesh.skinningVertexOffset;
@@ -2446,11 +3130,15 @@ namespace Falcor
             }
 
             // Free the mesh local data.
-            mesh.indexData.clear();
-            mesh.staticData.clear();
-            mesh.skinningData.clear();
+            mResidentMeshBytes -= std::min(mResidentMeshBytes, (uint64_t)mesh.getDataByteSize());
+            mesh.indexData = {};
+            mesh.staticData = {};
+            mesh.skinningData = {};
         }
 
+        // All mesh data has been read back.
+        mpSpillFile.reset();
+
         // Initialize offsets for prev vertex data for vertex-animated meshes
         uint32_t prevOffset = (uint32_t)mSceneData.meshSkinningData.size();
         for (auto& cache : mSceneData.cachedMeshes)
@@ -2470,6 +3158,55 @@ namespace Falcor
         }
     }
 
+    void SceneBuilder::uploadMeshData()
+    {
+        if (!mUploadMeshData) return;
+
+        FALCOR_ASSERT(mSceneData.meshDesc.size() == mMeshes.size());
+        const bool isIndexed = !is_set(mFlags, Flags::NonIndexedVertices);
+        const size_t chunkSize = std::max<uint64_t>(mGeometrySpillSettings.uploadChunkSize, 1ull << 20);
+
+        ChunkedBufferWriter indexWriter(mSceneData.pMeshIndexBuffer, chunkSize);
+        ChunkedBufferWriter staticWriter(mSceneData.pMeshStaticBuffer, chunkSize);
+        std::vector<PackedStaticVertexData> packedData;
+        mSceneData.meshUVTiles.resize(mMeshes.size());
+
+        // Upload the meshes in order. Spilled meshes are read back one at a time.
+        // The same post-processing is applied as for the global arrays, and the UV tiles are computed while the data is at hand.
+        for (uint32_t meshID = 0; meshID < mMeshes.size(); meshID++)
+        {
+            auto& mesh = mMeshes[meshID];
+            loadMeshData(mesh);
+
+            // The vertices are converted to their packed format in this step.
+            packedData.assign(mesh.staticData.begin(), mesh.staticData.end());
+            quantizeTexCoords(mesh, packedData.data());
+
+            const uint32_t* pIndexData = isIndexed ? mesh.indexData.data() : nullptr;
+            mSceneData.meshUVTiles[meshID] = Scene::computeMeshUVTiles(mSceneData.meshDesc[meshID], pIndexData, packedData.data());
+
+            FALCOR_ASSERT(staticWriter.getOffset() == (size_t)mesh.staticVertexOffset * sizeof(PackedStaticVertexData));
+            staticWriter.write(packedData.data(), packedData.size() * sizeof(PackedStaticVertexData));
+            if (isIndexed)
+            {
+                FALCOR_ASSERT(indexWriter.getOffset() == (size_t)mesh.indexOffset * sizeof(uint32_t));
+                indexWriter.write(mesh.indexData.data(), mesh.indexData.size() * sizeof(uint32_t));
+            }
+
+            // Free the mesh local data.
+            mResidentMeshBytes -= std::min(mResidentMeshBytes, (uint64_t)mesh.getDataByteSize());
+            mesh.indexData = {};
+            mesh.staticData = {};
+            mesh.skinningData = {};
+        }
+
+        indexWriter.flush();
+        staticWriter.flush();
+
+        // All mesh data has been uploaded.
+        mpSpillFile.reset();
+    }
+
     void SceneBuilder::createCurveGlobalBuffers()
     {
         FALCOR_ASSERT(mSceneData.curveIndexData.empty());
@@ -2528,7 +3265,7 @@ namespace Falcor
         // textures may be reduced to identical materials after optimization,
         // increasing the likelihood of finding duplicates here.
 
-        if (is_set(mFlags, Flags::DontMergeMaterials)) return;
+        if (is_set(mFlags, Flags::DontMergeMaterials) || is_set(mFlags, Flags::PreserveSourceObjects)) return;
 
         std::vector<MaterialID> idMap;
         size_t removed = mSceneData.pMaterials->removeDuplicateMaterials(idMap);
@@ -2566,53 +3303,61 @@ namespace Falcor
     }
 
     void SceneBuilder::quantizeTexCoords()
+    {
+        // The texture coordinates of uploaded meshes are quantized in uploadMeshData().
+        if (mUploadMeshData) return;
+
+        for (const auto& mesh : mMeshes)
+        {
+            quantizeTexCoords(mesh, mSceneData.meshStaticData.data() + mesh.staticVertexOffset);
+        }
+    }
+
+    void SceneBuilder::quantizeTexCoords(const MeshSpec& mesh, PackedStaticVertexData* pVertices) const
     {
         // Match texture coordinate quantization for textured emissives to format of PackedEmissiveTriangle.
         // This is to avoid mismatch when sampling and evaluating emissive triangles.
         // Note that non-emissive meshes are unmodified and use full precision texcoords.
-        for (auto& mesh : mMeshes)
+        const auto& pMaterial = mSceneData.pMaterials->getMaterial(mesh.materialId)->toBasicMaterial();
+        if (pMaterial && pMaterial->getEmissiveTexture() != nullptr)
         {
-            const auto& pMaterial = mSceneData.pMaterials->getMaterial(mesh.materialId)->toBasicMaterial();
-            if (pMaterial && pMaterial->getEmissiveTexture() != nullptr)
+            // Quantize texture coordinates to fp16. Also track the bounds and max error.
+            float2 minTexCrd = float2(std::numeric_limits<float>::infinity());
+            float2 maxTexCrd = float2(-std::numeric_limits<float>::infinity());
+            float2 maxError = float2(0);
+
+            for (uint32_t i = 0; i < mesh.staticVertexCount; ++i)
             {
-                // Quantize texture coordinates to fp16. Also track the bounds and max error.
-                float2 minTexCrd = float2(std::numeric_limits<float>::infinity());
-                float2 maxTexCrd = float2(-std::numeric_limits<float>::infinity());
-                float2 maxError = float2(0);
+                auto& v = pVertices[i];
+                float2 texCrd = v.texCrd;
+                minTexCrd = min(minTexCrd, texCrd);
+                maxTexCrd = max(maxTexCrd, texCrd);
+                v.texCrd = f16tof32(f32tof16(texCrd));
+                maxError = max(maxError, abs(v.texCrd - texCrd));
+            }
 
-                for (uint32_t i = 0; i < mesh.staticVertexCount; ++i)
-                {
-                    auto& v = mSceneData.meshStaticData[mesh.staticVertexOffset + i];
-                    float2 texCrd = v.texCrd;
-                    minTexCrd = min(minTexCrd, texCrd);
-                    maxTexCrd = max(maxTexCrd, texCrd);
-                    v.texCrd = f16tof32(f32tof16(texCrd));
-                    maxError = max(maxError, abs(v.texCrd - texCrd));
-                }
+            // Issue warning if quantization errors are too large.
+            float2 maxAbsCrd = max(abs(minTexCrd), abs(maxTexCrd));
+            if (maxAbsCrd.x > HLF_MAX || maxAbsCrd.y > HLF_MAX)
+            {
+                logWarning("Texture coordinates for emissive textured mesh '{}' are outside the representable range, expect rendering errors.", mesh.name);
+            }
+            else
+            {
+                // Compute maximum quantization error in texels.
+                // The texcoords are used for all texture channels so taking the maximum dimensions.
+                uint2 maxTexDim = pMaterial->getMaxTextureDimensions();
+                maxError *= float2(maxTexDim);
+                float maxTexelError = std::max(maxError.x, maxError.y);
 
-                // Issue warning if quantization errors are too large.
-                float2 maxAbsCrd = max(abs(minTexCrd), abs(maxTexCrd));
-                if (maxAbsCrd.x > HLF_MAX || maxAbsCrd.y > HLF_MAX)
+                if (maxTexelError > kMaxTexelError)
                 {
-                    logWarning("Texture coordinates for emissive textured mesh '{}' are outside the representable range, expect rendering errors.", mesh.name);
-                }
-                else
-                {
-                    // Compute maximum quantization error in texels.
-                    // The texcoords are used for all texture channels so taking the maximum dimensions.
-                    uint2 maxTexDim = pMaterial->getMaxTextureDimensions();
-                    maxError *= float2(maxTexDim);
-                    float maxTexelError = std::max(maxError.x, maxError.y);
-
-                    if (maxTexelError > kMaxTexelError)
-                    {
-                        logWarning(
-                            "Texture coordinates for emissive textured mesh '{}' have a large quantization error of {} texels."
-                            "The coordinate range is [{},{}] x [{},{}] for maximum texture dimensions ({},{}).",
-                            mesh.name, maxTexelError,
-                            minTexCrd.x, maxTexCrd.x, minTexCrd.y, maxTexCrd.y, maxTexDim.x, maxTexDim.y
-                        );
-                    }
+                    logWarning(
+                        "Texture coordinates for emissive textured mesh '{}' have a large quantization error of {} texels."
+                        "The coordinate range is [{},{}] x [{},{}] for maximum texture dimensions ({},{}).",
+                        mesh.name, maxTexelError,
+                        minTexCrd.x, maxTexCrd.x, minTexCrd.y, maxTexCrd.y, maxTexDim.x, maxTexDim.y
+                    );
                 }
             }
         }
@@ -2939,6 +3684,12 @@ namespace Falcor
         flags.value("DontUseDisplacement", SceneBuilder::Flags::DontUseDisplacement);
         flags.value("UseCompressedHitInfo", SceneBuilder::Flags::UseCompressedHitInfo);
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
+        flags.value("BuildCpuRayQuery", SceneBuilder::Flags::BuildCpuRayQuery);
+        flags.value("GenerateMeshLODs", SceneBuilder::Flags::GenerateMeshLODs);
+        flags.value("GenerateMeshlets", SceneBuilder::Flags::GenerateMeshlets);
+        flags.value("PackTextureAtlases", SceneBuilder::Flags::PackTextureAtlases);
+        flags.value("OutOfCoreGeometry", SceneBuilder::Flags::OutOfCoreGeometry);
+        flags.value("PreserveSourceObjects", SceneBuilder::Flags::PreserveSourceObjects);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
         ScriptBindings::addEnumBinaryOperators(flags);
@@ -2956,6 +3707,7 @@ namespace Falcor
         sceneBuilder.def_property("selectedCamera", &SceneBuilder::getSelectedCamera, &SceneBuilder::setSelectedCamera);
         sceneBuilder.def_property("cameraSpeed", &SceneBuilder::getCameraSpeed, &SceneBuilder::setCameraSpeed);
         sceneBuilder.def("importScene", &SceneBuilder::import, "path"_a, "dict"_a = pybind11::dict());
+        sceneBuilder.def("exportPackage", &SceneBuilder::exportPackage, "path"_a);
         sceneBuilder.def("addTriangleMesh", &SceneBuilder::addTriangleMesh, "triangleMesh"_a, "material"_a, "isAnimated"_a = false);
         sceneBuilder.def("addSDFGrid", &SceneBuilder::addSDFGrid, "sdfGrid"_a, "material"_a);
         sceneBuilder.def("addMaterial", &SceneBuilder::addMaterial, "material"_a);
@@ -29,6 +29,8 @@
 #include "Scene.h"
 #include "SceneCache.h"
 #include "SceneIDs.h"
+#include "GeometrySpillFile.h"
+#include "MeshLOD.h"
 #include "Transform.h"
 #include "TriangleMesh.h"
 #include "VertexAttrib.slangh"
@@ -42,11 +44,14 @@
 #include "Utils/Math/Vector.h"
 #include "Utils/Math/Matrix.h"
 #include "Utils/Settings/Settings.h"
+#include "Utils/fast_vector.h"
 
 #include <pybind11/pytypes.h>
 
+#include <atomic>
 #include <filesystem>
 #include <memory>
+#include <optional>
 #include <string>
 #include <vector>
 
@@ -77,6 +82,12 @@ namespace Falcor
             DontUseDisplacement             = 0x4000,   ///< Don't use displacement mapping.
             UseCompressedHitInfo            = 0x8000,   ///< Use compressed hit info (on scenes with triangle meshes only).
             TessellateCurvesIntoPolyTubes   = 0x10000,  ///< Tessellate curves into poly-tubes (the default is linear swept spheres).
+            BuildCpuRayQuery                = 0x20000,  ///< Build a CPU acceleration structure over the triangle meshes for ray queries without a GPU (see Scene::getCpuRayQuery()).
+            GenerateMeshLODs                = 0x40000,  ///< Generate simplified levels of detail for static triangle meshes and use the coarsest level within the pixel error bound for each instance, as seen from the selected camera. The generation is configured by the 'MeshLOD:*' options (see getMeshLODSettings()).
+            GenerateMeshlets                = 0x80000,  ///< Split static triangle meshes into meshlets with bounding spheres and normal cones for culling (see Scene::getMeshlets()).
+            PackTextureAtlases              = 0x100000, ///< Pack small material textures into shared texture atlases to reduce descriptor count. The packing is configured by the 'TextureAtlas:*' options.
+            OutOfCoreGeometry               = 0x200000, ///< Keep processed mesh data within a host memory budget by spilling it to a temporary file, and upload it to the GPU in chunks when it isn't needed on the host. The budget is configured by the 'OutOfCore:*' options (see getGeometrySpillSettings()).
+            PreserveSourceObjects           = 0x400000, ///< Keep scene graph nodes, materials and lights one-to-one with the objects of the source asset so the scene can be updated in place (e.g. by USDSceneUpdater). Disables scene graph optimization, static mesh pre-transformation, instance flattening and material merging.
 
             UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
             RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
@@ -105,6 +116,7 @@ namespace Falcor
             {
                 const T* pData = nullptr;
                 AttributeFrequency frequency = AttributeFrequency::None;
+                uint32_t stride = 0;    ///< Distance between elements in bytes, or zero if the elements are tightly packed. Allows referencing interleaved vertex data without copying it.
             };
 
             std::string name;                           ///< The mesh's name.
@@ -153,7 +165,8 @@ namespace Falcor
             {
                 if (attribute.pData)
                 {
-                    return attribute.pData[index];
+                    if (attribute.stride == 0) return attribute.pData[index];
+                    return *reinterpret_cast<const T*>(reinterpret_cast<const uint8_t*>(attribute.pData) + (size_t)index * attribute.stride);
                 }
                 return T{};
             }
@@ -169,7 +182,7 @@ namespace Falcor
             }
 
             template<typename T>
-            size_t getAttributeCount(const Attribute<T>& attribute)
+            size_t getAttributeCount(const Attribute<T>& attribute) const
             {
                 switch (attribute.frequency)
                 {
@@ -260,6 +273,54 @@ namespace Falcor
             }
         };
 
+        /** Mesh description that owns its index and vertex attribute arrays.
+            Importers can move their arrays into the mesh with the set functions below, which also set up
+            the views in the base description. Moving an array keeps its storage, so the views stay valid when
+            the arrays or the mesh are moved. Importers that have already set up the views can also move their
+            arrays into the data members directly.
+            When added with addMesh(OwnedMesh&&) the mesh is processed in place and the arrays are
+            released as soon as they have been consumed, so the data is never held twice.
+        */
+        struct OwnedMesh : Mesh
+        {
+            OwnedMesh() = default;
+            OwnedMesh(const OwnedMesh&) = delete;
+            OwnedMesh& operator=(const OwnedMesh&) = delete;
+            OwnedMesh(OwnedMesh&&) = default;
+            OwnedMesh& operator=(OwnedMesh&&) = default;
+
+            /** Set triangle list indices. This also sets the index and face counts.
+            */
+            void setIndices(fast_vector<uint32_t>&& indices);
+
+            /** Set vertex positions. For per-vertex positions this also sets the vertex count.
+            */
+            void setPositions(fast_vector<float3>&& data, AttributeFrequency frequency = AttributeFrequency::Vertex);
+
+            void setNormals(fast_vector<float3>&& data, AttributeFrequency frequency = AttributeFrequency::Vertex);
+            void setTangents(fast_vector<float4>&& data, AttributeFrequency frequency = AttributeFrequency::Vertex);
+            void setTexCrds(fast_vector<float2>&& data, AttributeFrequency frequency = AttributeFrequency::Vertex);
+            void setCurveRadii(fast_vector<float>&& data, AttributeFrequency frequency = AttributeFrequency::Vertex);
+            void setBones(fast_vector<uint4>&& ids, fast_vector<float4>&& weights, AttributeFrequency frequency = AttributeFrequency::Vertex);
+
+            /** Free all owned arrays and clear the corresponding views. Counts are left unchanged.
+            */
+            void release();
+
+            /** Get the total size of the owned arrays in bytes.
+            */
+            size_t getByteSize() const;
+
+            fast_vector<uint32_t> indexData;
+            fast_vector<float3> positionData;
+            fast_vector<float3> normalData;
+            fast_vector<float4> tangentData;
+            fast_vector<float2> texCrdData;
+            fast_vector<float> curveRadiusData;
+            fast_vector<uint4> boneIDData;
+            fast_vector<float4> boneWeightData;
+        };
+
         /** Pre-processed mesh data.
             This data is formatted such that it can directly be copied
             to the global scene buffers.
@@ -372,11 +433,28 @@ namespace Falcor
         */
         ref<Scene> getScene();
 
+        /** Export the processed scene data to a scene package.
+            Scene packages can be loaded like any other scene file and skip the import and processing steps.
+            Objects can't be added after exporting, but the scene can still be created by calling getScene().
+            \param[in] path File path (should have the SceneCache::kPackageExtension extension).
+        */
+        void exportPackage(const std::filesystem::path& path);
+
         const ref<Device>& getDevice() const { return mpDevice; }
 
         const Settings& getSettings() const { return mSettings; }
         Settings& getSettings() { return mSettings; }
 
+        /** Get the mesh LOD settings. These are read from the 'MeshLOD:*' options when the builder is created,
+            e.g. 'MeshLOD:maxPixelError', and only used with Flags::GenerateMeshLODs.
+        */
+        const MeshLODSettings& getMeshLODSettings() const { return mMeshLODSettings; }
+
+        /** Get the out-of-core settings. These are read from the 'OutOfCore:*' options when the builder is created,
+            e.g. 'OutOfCore:hostMemoryBudgetMB', and only used with Flags::OutOfCoreGeometry.
+        */
+        const GeometrySpillSettings& getGeometrySpillSettings() const { return mGeometrySpillSettings; }
+
         /** Get the build flags
         */
         Flags getFlags() const { return mFlags; }
@@ -405,6 +483,26 @@ namespace Falcor
         */
         const Scene::Metadata& getMetadata() const { return mSceneData.metadata; }
 
+        // Statistics
+
+        /** Mesh import statistics.
+        */
+        struct ImportStats
+        {
+            uint64_t meshCount = 0;             ///< Number of meshes processed.
+            uint64_t adoptedMeshCount = 0;      ///< Number of meshes processed in place from owned data (see OwnedMesh).
+            uint64_t inputMeshBytes = 0;        ///< Total size of the index and vertex attribute arrays passed in by importers.
+            uint64_t adoptedMeshBytes = 0;      ///< Part of 'inputMeshBytes' that was adopted and freed during processing instead of being copied.
+            uint64_t processedMeshBytes = 0;    ///< Total size of the processed mesh data held by the builder.
+            uint64_t peakResidentMeshBytes = 0; ///< Peak size of the processed mesh data held in host memory. Only tracked in out-of-core mode.
+            uint64_t spillFileBytes = 0;        ///< Size of the spill file in out-of-core mode.
+            uint64_t peakRSS = 0;               ///< Peak resident set size of the process at the time of the query.
+        };
+
+        /** Get the mesh import statistics collected so far.
+        */
+        ImportStats getImportStats() const;
+
         // Meshes
 
         /** Add a mesh.
@@ -414,6 +512,14 @@ namespace Falcor
         */
         MeshID addMesh(const Mesh& mesh);
 
+        /** Add a mesh, taking ownership of its data.
+            The mesh is processed in place and its arrays are freed before the final vertex data is allocated.
+            Throws an exception if something went wrong.
+            \param mesh The mesh to add (will be moved from).
+            \return The ID of the mesh in the scene. Note that all of the instances share the same mesh ID.
+        */
+        MeshID addMesh(OwnedMesh&& mesh);
+
         /** Add a triangle mesh.
             \param The triangle mesh to add.
             \param pMaterial The material to use for the mesh.
@@ -431,6 +537,16 @@ namespace Falcor
         */
         ProcessedMesh processMesh(const Mesh& mesh, MeshAttributeIndices* pAttributeIndices = nullptr, std::vector<float4>* pTangents = nullptr) const;
 
+        /** Pre-process a mesh, taking ownership of its data.
+            This is the same as processMesh() above, but the owned index buffer is reused for the output indices
+            and all input arrays are freed before the final vertex data is allocated.
+            \param mesh The mesh to pre-process (will be moved from).
+            \param pAttributeIndices Optional. If specified, the attribute indices used to create the final mesh vertices will be saved here.
+            \param pTangents Optional. When specified and processMesh creates tangents for the mesh, the tangents are also stored in this parameter.
+            \return The pre-processed mesh.
+        */
+        ProcessedMesh processMesh(OwnedMesh&& mesh, MeshAttributeIndices* pAttributeIndices = nullptr, std::vector<float4>* pTangents = nullptr) const;
+
         /** Generate tangents for a mesh.
             \param mesh The mesh to generate tangents for. If successful, the tangent attribute on the mesh will be set to the output vector.
             \param tangents Output for generated tangents.
@@ -443,6 +559,12 @@ namespace Falcor
         */
         MeshID addProcessedMesh(const ProcessedMesh& mesh);
 
+        /** Add a pre-processed mesh, taking ownership of its data.
+            \param mesh The pre-processed mesh (will be moved from).
+            \return The ID of the mesh in the scene. Note that all of the instances share the same mesh ID.
+        */
+        MeshID addProcessedMesh(ProcessedMesh&& mesh);
+
         /** Add mesh vertex cache for animation.
             \param[in] cachedCurves The mesh vertex cache data (will be moved from).
         */
@@ -712,6 +834,26 @@ namespace Falcor
             std::vector<StaticVertexData> staticData;
             std::vector<SkinningVertexData> skinningData;
 
+            /** Location of the pre-processed vertex data in the spill file.
+            */
+            struct SpilledData
+            {
+                GeometrySpillFile::Range indexData;
+                GeometrySpillFile::Range staticData;
+                GeometrySpillFile::Range skinningData;
+            };
+            std::optional<SpilledData> spilledData; ///< Set if the vertex data has been spilled to disk (out-of-core mode). The data vectors are empty then.
+
+            bool isResident() const
+            {
+                return !spilledData.has_value();
+            }
+
+            size_t getDataByteSize() const
+            {
+                return indexData.size() * sizeof(uint32_t) + staticData.size() * sizeof(StaticVertexData) + skinningData.size() * sizeof(SkinningVertexData);
+            }
+
             uint32_t getTriangleCount() const
             {
                 FALCOR_ASSERT(topology == Vao::Topology::TriangleList);
@@ -765,6 +907,8 @@ namespace Falcor
         /// Local copy of settings used to create the SceneBuilder. Edits do not propagate to the parent.
         Settings mSettings;
         const Flags mFlags;
+        MeshLODSettings mMeshLODSettings;
+        GeometrySpillSettings mGeometrySpillSettings;
 
         AssetResolver mAssetResolver;
         std::vector<AssetResolver> mAssetResolverStack;
@@ -773,6 +917,9 @@ namespace Falcor
         ref<Scene> mpScene;
         SceneCache::Key mSceneCacheKey;
         bool mWriteSceneCache = false;  ///< True if scene cache should be written after import.
+        bool mSceneDataFinalized = false; ///< True if mSceneData has been created from the added objects.
+        bool mKeepHostMeshData = false; ///< True if the global mesh data must be gathered in host memory, e.g. for exportPackage().
+        bool mUploadMeshData = false;   ///< True if the global mesh data is uploaded to the GPU by uploadMeshData() instead of being gathered in host memory.
 
         SceneGraph mSceneGraph;
 
@@ -783,7 +930,21 @@ namespace Falcor
 
         std::unique_ptr<MaterialTextureLoader> mpMaterialTextureLoader;
 
+        // Import statistics. The mesh counters are updated by processMesh(), which importers may call concurrently.
+        mutable std::atomic<uint64_t> mProcessedMeshCount{ 0 };
+        mutable std::atomic<uint64_t> mAdoptedMeshCount{ 0 };
+        mutable std::atomic<uint64_t> mInputMeshBytes{ 0 };
+        mutable std::atomic<uint64_t> mAdoptedMeshBytes{ 0 };
+        uint64_t mProcessedMeshBytes = 0;
+
+        // Out-of-core state (see Flags::OutOfCoreGeometry).
+        std::unique_ptr<GeometrySpillFile> mpSpillFile; ///< Spill file for mesh data. Created on first use.
+        uint64_t mResidentMeshBytes = 0;                ///< Approximate size of the resident mesh data.
+        uint64_t mPeakResidentMeshBytes = 0;            ///< Peak of 'mResidentMeshBytes'.
+        size_t mSpillCursor = 0;                        ///< Next mesh to consider for spilling (round robin).
+
         // Helpers
+        ProcessedMesh processMeshInternal(Mesh& mesh, OwnedMesh* pOwnedMesh, MeshAttributeIndices* pAttributeIndices, std::vector<float4>* pTangents) const;
         bool doesNodeHaveAnimation(NodeID nodeID) const;
         void updateLinkedObjects(NodeID oldNodeID, NodeID newNodeID);
         bool collapseNodes(NodeID parentNodeID, NodeID childNodeID);
@@ -799,6 +960,14 @@ namespace Falcor
         void splitIndexedMesh(const MeshSpec& mesh, MeshSpec& leftMesh, MeshSpec& rightMesh, const int axis, const float pos);
         void splitNonIndexedMesh(const MeshSpec& mesh, MeshSpec& leftMesh, MeshSpec& rightMesh, const int axis, const float pos);
 
+        // Out-of-core helpers
+        bool isOutOfCore() const;
+        void spillMeshData(MeshSpec& mesh);
+        void loadMeshData(MeshSpec& mesh);
+        const MeshSpec& getResidentMesh(const MeshSpec& mesh, MeshSpec& tmp) const;
+        void trimMeshData(const MeshSpec* pKeep = nullptr);
+        void updateResidentMeshBytes();
+
         // Mesh group helpers
         size_t countTriangles(const MeshGroup& meshGroup) const;
         AABB calculateBoundingBox(const MeshGroup& meshGroup) const;
@@ -808,10 +977,13 @@ namespace Falcor
         MeshGroupList splitMeshGroupMidpointMeshes(MeshGroup& meshGroup);
 
         // Post processing
+        void finalizeSceneData(bool keepHostMeshData = false);
+        void checkNotFinalized() const;
         void prepareDisplacementMaps();
         void prepareSceneGraph();
         void prepareMeshes();
         void removeUnusedMeshes();
+        void generateMeshLODs();
         void flattenStaticMeshInstances();
         void optimizeSceneGraph();
         void pretransformStaticMeshes();
@@ -820,12 +992,15 @@ namespace Falcor
         void createMeshGroups();
         void optimizeGeometry();
         void sortMeshes();
+        void createMeshlets();
         void createGlobalBuffers();
+        void uploadMeshData();
         void createCurveGlobalBuffers();
         void optimizeMaterials();
         void removeDuplicateMaterials();
         void collectVolumeGrids();
         void quantizeTexCoords();
+        void quantizeTexCoords(const MeshSpec& mesh, PackedStaticVertexData* pVertices) const;
         void removeDuplicateSDFGrids();
 
         // Scene setup
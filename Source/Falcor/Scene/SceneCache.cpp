@@ -30,11 +30,21 @@
 #include "Material/HairMaterial.h"
 #include "Material/ClothMaterial.h"
 #include "Material/MaterialTextureLoader.h"
+#include "SDFs/NormalizedDenseSDFGrid/NDSDFGrid.h"
+#include "SDFs/SparseBrickSet/SDFSBS.h"
+#include "SDFs/SparseVoxelOctree/SDFSVO.h"
+#include "SDFs/SparseVoxelSet/SDFSVS.h"
+#include "Core/Platform/OS.h"
 #include "Utils/Logger.h"
+#include "Utils/Math/FNVHash.h"
 
 #include <lz4_stream/lz4_stream.h>
 
+#include <cstddef>
 #include <fstream>
+#include <functional>
+#include <map>
+#include <sstream>
 
 namespace Falcor
 {
@@ -43,7 +53,7 @@ namespace Falcor
         /** Specfies the current cache file version.
             This needs to be incremented every time the file format changes!
         */
-        const uint32_t kVersion = 25;
+        const uint32_t kVersion = 30;
 
         /** Scene cache directory (subdirectory in the application data directory).
         */
@@ -62,6 +72,227 @@ namespace Falcor
                 return std::memcmp(magic, kMagic, sizeof(Header::magic)) == 0 && version == kVersion;
             }
         };
+
+        // Scene package format. See the "Falcor Scene Packages" section in docs/usage/scene-formats.md.
+        // The major version is only incremented for changes that older readers can't skip over.
+        const char* kPackageMagic = "FalcorPk";
+        const uint32_t kPackageMajorVersion = 1;
+        const uint32_t kPackageMinorVersion = 0;
+
+        struct PackageHeader
+        {
+            uint8_t magic[8]{};
+            uint32_t majorVersion{};
+            uint32_t minorVersion{};
+        };
+        static_assert(sizeof(PackageHeader) == 16);
+
+        struct ChunkHeader
+        {
+            uint32_t tag{};         ///< Four character code identifying the section.
+            uint16_t version{};     ///< Version of the section. Newer versions only append data.
+            uint16_t flags{};       ///< See ChunkFlags.
+            uint64_t size{};        ///< Size of the payload in bytes.
+        };
+        static_assert(sizeof(ChunkHeader) == 16);
+
+        enum ChunkFlags : uint16_t
+        {
+            kChunkCompressed = 0x1, ///< Payload is LZ4 compressed.
+            kChunkRequired = 0x2,   ///< Readers that don't know the section must fail instead of skipping it.
+        };
+
+        constexpr uint32_t makeTag(const char (&str)[5])
+        {
+            return uint32_t(uint8_t(str[0])) | (uint32_t(uint8_t(str[1])) << 8) | (uint32_t(uint8_t(str[2])) << 16) | (uint32_t(uint8_t(str[3])) << 24);
+        }
+
+        std::string tagToString(uint32_t tag)
+        {
+            return std::string{ char(tag & 0xff), char((tag >> 8) & 0xff), char((tag >> 16) & 0xff), char((tag >> 24) & 0xff) };
+        }
+
+        const uint32_t kLayoutTag = makeTag("LAYT");
+        const uint32_t kSettingsTag = makeTag("SETT");
+        const uint32_t kCamerasTag = makeTag("CAMS");
+        const uint32_t kLightsTag = makeTag("LGHT");
+        const uint32_t kVolumesTag = makeTag("VOLS");
+        const uint32_t kEnvMapTag = makeTag("ENVM");
+        const uint32_t kMaterialsTag = makeTag("MATL");
+        const uint32_t kSceneGraphTag = makeTag("GRPH");
+        const uint32_t kAnimationsTag = makeTag("ANIM");
+        const uint32_t kMeshesTag = makeTag("MESH");
+        const uint32_t kCurvesTag = makeTag("CURV");
+        const uint32_t kCustomPrimitivesTag = makeTag("CUST");
+        const uint32_t kSDFGridsTag = makeTag("SDFG");
+        const uint32_t kEndTag = makeTag("END ");
+
+        /** Sections known to this version.
+            The version is written to the chunk header. Newer versions only append data, so they can be read.
+            Versions older than minVersion can't be read.
+        */
+        struct SectionInfo
+        {
+            uint32_t tag;
+            uint16_t version;
+            uint16_t minVersion;
+        };
+
+        const SectionInfo kSections[] =
+        {
+            { kLayoutTag, 2, 2 }, // Version 2 appends the layout version and field hash of each struct.
+            { kSettingsTag, 1, 1 },
+            { kCamerasTag, 1, 1 },
+            { kLightsTag, 1, 1 },
+            { kVolumesTag, 1, 1 },
+            { kEnvMapTag, 1, 1 },
+            { kMaterialsTag, 1, 1 },
+            { kSceneGraphTag, 1, 1 },
+            { kAnimationsTag, 1, 1 },
+            { kMeshesTag, 1, 1 },
+            { kCurvesTag, 1, 1 },
+            { kCustomPrimitivesTag, 1, 1 },
+            { kSDFGridsTag, 1, 1 },
+            { kEndTag, 1, 1 },
+        };
+
+        const SectionInfo* findSection(uint32_t tag)
+        {
+            auto it = std::find_if(std::begin(kSections), std::end(kSections), [&](const SectionInfo& info) { return info.tag == tag; });
+            return it != std::end(kSections) ? it : nullptr;
+        }
+
+        /** Layout of a struct that is stored as raw bytes in scene packages.
+        */
+        struct StructLayout
+        {
+            std::string name;
+            uint32_t version;   ///< Incremented when the meaning or encoding of a field changes but its offset and size don't.
+            uint32_t size;      ///< Size of the struct in bytes.
+            uint64_t fieldHash; ///< Hash of the offsets and sizes of all fields in declaration order.
+        };
+
+        struct FieldLayout
+        {
+            uint32_t offset;
+            uint32_t size;
+        };
+
+        StructLayout makeStructLayout(std::string name, uint32_t version, size_t size, std::initializer_list<FieldLayout> fields)
+        {
+            FNVHash64 hash;
+            for (const auto& field : fields)
+            {
+                hash.insert(&field.offset, sizeof(field.offset));
+                hash.insert(&field.size, sizeof(field.size));
+            }
+            return { std::move(name), version, (uint32_t)size, hash.get() };
+        }
+
+#define PACKAGE_FIELD(type, field) FieldLayout{ (uint32_t)offsetof(type, field), (uint32_t)sizeof(type::field) }
+
+        /** Layouts of the structs that are stored as raw bytes in scene packages.
+            A package can only be read if all of these match the ones it was written with.
+            When changing one of these structs, make sure the field list matches the struct. Changing the offset or size of
+            a field changes the hash, other changes to the interpretation of the data must increment the version.
+        */
+        std::vector<StructLayout> getPackageLayout()
+        {
+            using RenderSettings = Scene::RenderSettings;
+            using SamplerDesc = Sampler::Desc;
+            using Keyframe = Animation::Keyframe;
+            return
+            {
+                makeStructLayout("RenderSettings", 1, sizeof(RenderSettings), {
+                    PACKAGE_FIELD(RenderSettings, useEnvLight), PACKAGE_FIELD(RenderSettings, useAnalyticLights),
+                    PACKAGE_FIELD(RenderSettings, useEmissiveLights), PACKAGE_FIELD(RenderSettings, useGridVolumes),
+                    PACKAGE_FIELD(RenderSettings, diffuseAlbedoMultiplier) }),
+                makeStructLayout("CameraData", 1, sizeof(CameraData), {
+                    PACKAGE_FIELD(CameraData, viewMat), PACKAGE_FIELD(CameraData, prevViewMat), PACKAGE_FIELD(CameraData, projMat),
+                    PACKAGE_FIELD(CameraData, viewProjMat), PACKAGE_FIELD(CameraData, invViewProj), PACKAGE_FIELD(CameraData, viewProjMatNoJitter),
+                    PACKAGE_FIELD(CameraData, prevViewProjMatNoJitter), PACKAGE_FIELD(CameraData, projMatNoJitter), PACKAGE_FIELD(CameraData, posW),
+                    PACKAGE_FIELD(CameraData, focalLength), PACKAGE_FIELD(CameraData, prevPosW), PACKAGE_FIELD(CameraData, up),
+                    PACKAGE_FIELD(CameraData, aspectRatio), PACKAGE_FIELD(CameraData, target), PACKAGE_FIELD(CameraData, nearZ),
+                    PACKAGE_FIELD(CameraData, cameraU), PACKAGE_FIELD(CameraData, farZ), PACKAGE_FIELD(CameraData, cameraV),
+                    PACKAGE_FIELD(CameraData, jitterX), PACKAGE_FIELD(CameraData, cameraW), PACKAGE_FIELD(CameraData, jitterY),
+                    PACKAGE_FIELD(CameraData, frameHeight), PACKAGE_FIELD(CameraData, frameWidth), PACKAGE_FIELD(CameraData, focalDistance),
+                    PACKAGE_FIELD(CameraData, apertureRadius), PACKAGE_FIELD(CameraData, shutterSpeed), PACKAGE_FIELD(CameraData, ISOSpeed) }),
+                makeStructLayout("LightData", 1, sizeof(LightData), {
+                    PACKAGE_FIELD(LightData, posW), PACKAGE_FIELD(LightData, type), PACKAGE_FIELD(LightData, dirW),
+                    PACKAGE_FIELD(LightData, openingAngle), PACKAGE_FIELD(LightData, intensity), PACKAGE_FIELD(LightData, cosOpeningAngle),
+                    PACKAGE_FIELD(LightData, cosSubtendedAngle), PACKAGE_FIELD(LightData, penumbraAngle), PACKAGE_FIELD(LightData, tangent),
+                    PACKAGE_FIELD(LightData, surfaceArea), PACKAGE_FIELD(LightData, bitangent), PACKAGE_FIELD(LightData, transMat),
+                    PACKAGE_FIELD(LightData, transMatIT) }),
+                makeStructLayout("MaterialHeader", 1, sizeof(MaterialHeader), {
+                    PACKAGE_FIELD(MaterialHeader, packedData) }),
+                makeStructLayout("BasicMaterialData", 1, sizeof(BasicMaterialData), {
+                    PACKAGE_FIELD(BasicMaterialData, flags), PACKAGE_FIELD(BasicMaterialData, emissiveFactor),
+                    PACKAGE_FIELD(BasicMaterialData, baseColor), PACKAGE_FIELD(BasicMaterialData, specular),
+                    PACKAGE_FIELD(BasicMaterialData, emissive), PACKAGE_FIELD(BasicMaterialData, specularTransmission),
+                    PACKAGE_FIELD(BasicMaterialData, transmission), PACKAGE_FIELD(BasicMaterialData, diffuseTransmission),
+                    PACKAGE_FIELD(BasicMaterialData, volumeScattering), PACKAGE_FIELD(BasicMaterialData, volumeAbsorption),
+                    PACKAGE_FIELD(BasicMaterialData, volumeAnisotropy), PACKAGE_FIELD(BasicMaterialData, displacementScale),
+                    PACKAGE_FIELD(BasicMaterialData, displacementOffset), PACKAGE_FIELD(BasicMaterialData, texBaseColor),
+                    PACKAGE_FIELD(BasicMaterialData, texSpecular), PACKAGE_FIELD(BasicMaterialData, texEmissive),
+                    PACKAGE_FIELD(BasicMaterialData, texNormalMap), PACKAGE_FIELD(BasicMaterialData, texTransmission),
+                    PACKAGE_FIELD(BasicMaterialData, texDisplacementMap) }),
+                makeStructLayout("SamplerDesc", 1, sizeof(SamplerDesc), {
+                    PACKAGE_FIELD(SamplerDesc, magFilter), PACKAGE_FIELD(SamplerDesc, minFilter), PACKAGE_FIELD(SamplerDesc, mipFilter),
+                    PACKAGE_FIELD(SamplerDesc, maxAnisotropy), PACKAGE_FIELD(SamplerDesc, maxLod), PACKAGE_FIELD(SamplerDesc, minLod),
+                    PACKAGE_FIELD(SamplerDesc, lodBias), PACKAGE_FIELD(SamplerDesc, comparisonFunc), PACKAGE_FIELD(SamplerDesc, reductionMode),
+                    PACKAGE_FIELD(SamplerDesc, addressModeU), PACKAGE_FIELD(SamplerDesc, addressModeV), PACKAGE_FIELD(SamplerDesc, addressModeW),
+                    PACKAGE_FIELD(SamplerDesc, borderColor) }),
+                makeStructLayout("GridVolumeData", 1, sizeof(GridVolumeData), {
+                    PACKAGE_FIELD(GridVolumeData, transform), PACKAGE_FIELD(GridVolumeData, invTransform), PACKAGE_FIELD(GridVolumeData, boundsMin),
+                    PACKAGE_FIELD(GridVolumeData, densityScale), PACKAGE_FIELD(GridVolumeData, boundsMax), PACKAGE_FIELD(GridVolumeData, emissionScale),
+                    PACKAGE_FIELD(GridVolumeData, densityGrid), PACKAGE_FIELD(GridVolumeData, emissionGrid), PACKAGE_FIELD(GridVolumeData, flags),
+                    PACKAGE_FIELD(GridVolumeData, anisotropy), PACKAGE_FIELD(GridVolumeData, albedo), PACKAGE_FIELD(GridVolumeData, emissionTemperature) }),
+                makeStructLayout("EnvMapData", 1, sizeof(EnvMapData), {
+                    PACKAGE_FIELD(EnvMapData, transform), PACKAGE_FIELD(EnvMapData, invTransform), PACKAGE_FIELD(EnvMapData, tint),
+                    PACKAGE_FIELD(EnvMapData, intensity) }),
+                makeStructLayout("Keyframe", 1, sizeof(Keyframe), {
+                    PACKAGE_FIELD(Keyframe, time), PACKAGE_FIELD(Keyframe, translation), PACKAGE_FIELD(Keyframe, scaling),
+                    PACKAGE_FIELD(Keyframe, rotation) }),
+                makeStructLayout("MeshDesc", 1, sizeof(MeshDesc), {
+                    PACKAGE_FIELD(MeshDesc, vbOffset), PACKAGE_FIELD(MeshDesc, ibOffset), PACKAGE_FIELD(MeshDesc, vertexCount),
+                    PACKAGE_FIELD(MeshDesc, indexCount), PACKAGE_FIELD(MeshDesc, skinningVbOffset), PACKAGE_FIELD(MeshDesc, prevVbOffset),
+                    PACKAGE_FIELD(MeshDesc, materialID), PACKAGE_FIELD(MeshDesc, flags) }),
+                makeStructLayout("GeometryInstanceData", 1, sizeof(GeometryInstanceData), {
+                    PACKAGE_FIELD(GeometryInstanceData, flags), PACKAGE_FIELD(GeometryInstanceData, globalMatrixID),
+                    PACKAGE_FIELD(GeometryInstanceData, materialID), PACKAGE_FIELD(GeometryInstanceData, geometryID),
+                    PACKAGE_FIELD(GeometryInstanceData, vbOffset), PACKAGE_FIELD(GeometryInstanceData, ibOffset),
+                    PACKAGE_FIELD(GeometryInstanceData, instanceIndex), PACKAGE_FIELD(GeometryInstanceData, geometryIndex) }),
+                makeStructLayout("PackedStaticVertexData", 1, sizeof(PackedStaticVertexData), {
+                    PACKAGE_FIELD(PackedStaticVertexData, position), PACKAGE_FIELD(PackedStaticVertexData, packedNormalTangentCurveRadius),
+                    PACKAGE_FIELD(PackedStaticVertexData, texCrd) }),
+                makeStructLayout("SkinningVertexData", 1, sizeof(SkinningVertexData), {
+                    PACKAGE_FIELD(SkinningVertexData, boneID), PACKAGE_FIELD(SkinningVertexData, boneWeight),
+                    PACKAGE_FIELD(SkinningVertexData, staticIndex), PACKAGE_FIELD(SkinningVertexData, bindMatrixID),
+                    PACKAGE_FIELD(SkinningVertexData, skeletonMatrixID) }),
+                makeStructLayout("MeshLODLevel", 1, sizeof(MeshLODLevel), {
+                    PACKAGE_FIELD(MeshLODLevel, triangleCount), PACKAGE_FIELD(MeshLODLevel, error), PACKAGE_FIELD(MeshLODLevel, instanceCount) }),
+                makeStructLayout("MeshletDesc", 1, sizeof(MeshletDesc), {
+                    PACKAGE_FIELD(MeshletDesc, center), PACKAGE_FIELD(MeshletDesc, radius), PACKAGE_FIELD(MeshletDesc, coneApex),
+                    PACKAGE_FIELD(MeshletDesc, coneCutoff), PACKAGE_FIELD(MeshletDesc, coneAxis), PACKAGE_FIELD(MeshletDesc, vertexOffset),
+                    PACKAGE_FIELD(MeshletDesc, triangleOffset), PACKAGE_FIELD(MeshletDesc, vertexCount), PACKAGE_FIELD(MeshletDesc, triangleCount) }),
+                makeStructLayout("CurveDesc", 1, sizeof(CurveDesc), {
+                    PACKAGE_FIELD(CurveDesc, vbOffset), PACKAGE_FIELD(CurveDesc, ibOffset), PACKAGE_FIELD(CurveDesc, vertexCount),
+                    PACKAGE_FIELD(CurveDesc, indexCount), PACKAGE_FIELD(CurveDesc, degree), PACKAGE_FIELD(CurveDesc, materialID) }),
+                makeStructLayout("StaticCurveVertexData", 1, sizeof(StaticCurveVertexData), {
+                    PACKAGE_FIELD(StaticCurveVertexData, position), PACKAGE_FIELD(StaticCurveVertexData, radius),
+                    PACKAGE_FIELD(StaticCurveVertexData, texCrd) }),
+                makeStructLayout("DynamicCurveVertexData", 1, sizeof(DynamicCurveVertexData), {
+                    PACKAGE_FIELD(DynamicCurveVertexData, position) }),
+                makeStructLayout("CustomPrimitiveDesc", 1, sizeof(CustomPrimitiveDesc), {
+                    PACKAGE_FIELD(CustomPrimitiveDesc, userID), PACKAGE_FIELD(CustomPrimitiveDesc, aabbOffset) }),
+                makeStructLayout("SDF3DPrimitive", 1, sizeof(SDF3DPrimitive), {
+                    PACKAGE_FIELD(SDF3DPrimitive, shapeType), PACKAGE_FIELD(SDF3DPrimitive, shapeData), PACKAGE_FIELD(SDF3DPrimitive, shapeBlobbing),
+                    PACKAGE_FIELD(SDF3DPrimitive, operationType), PACKAGE_FIELD(SDF3DPrimitive, operationSmoothing),
+                    PACKAGE_FIELD(SDF3DPrimitive, translation), PACKAGE_FIELD(SDF3DPrimitive, invRotationScale) }),
+            };
+        }
+
+#undef PACKAGE_FIELD
     }
 
     /** Wrapper around std::ostream to ease serialization of basic types.
@@ -69,7 +300,7 @@ namespace Falcor
     class SceneCache::OutputStream
     {
     public:
-        OutputStream(std::ostream& stream) : mStream(stream) {}
+        OutputStream(std::ostream& stream, const std::filesystem::path& assetDirectory = {}) : mStream(stream), mAssetDirectory(assetDirectory) {}
 
         void write(const void* data, size_t len)
         {
@@ -117,8 +348,23 @@ namespace Falcor
             if (hasValue) write(opt.value());
         }
 
+        /** Write a path to an asset file.
+            If an asset directory is set, the path is written relative to it so it can be relocated together with the asset.
+        */
+        void writeAssetPath(const std::filesystem::path& path)
+        {
+            if (mAssetDirectory.empty() || path.empty())
+            {
+                write(path);
+                return;
+            }
+            auto relativePath = std::filesystem::absolute(path).lexically_relative(mAssetDirectory);
+            write(relativePath.empty() ? path.generic_string() : relativePath.generic_string());
+        }
+
     private:
         std::ostream& mStream;
+        std::filesystem::path mAssetDirectory;
     };
 
     /** Wrapper around std::istream to ease serialization of basic types.
@@ -126,7 +372,7 @@ namespace Falcor
     class SceneCache::InputStream
     {
     public:
-        InputStream(std::istream& stream) : mStream(stream) {}
+        InputStream(std::istream& stream, const std::filesystem::path& assetDirectory = {}) : mStream(stream), mAssetDirectory(assetDirectory) {}
 
         void read(void* data, size_t len)
         {
@@ -188,8 +434,20 @@ namespace Falcor
             }
         }
 
+        /** Read a path to an asset file written by OutputStream::writeAssetPath().
+        */
+        std::filesystem::path readAssetPath()
+        {
+            auto path = read<std::filesystem::path>();
+            if (!mAssetDirectory.empty() && path.is_relative() && !path.empty()) path = (mAssetDirectory / path).lexically_normal();
+            return path;
+        }
+
+        bool fail() const { return mStream.fail(); }
+
     private:
         std::istream& mStream;
+        std::filesystem::path mAssetDirectory;
     };
 
     bool SceneCache::hasValidCache(const Key& key)
@@ -256,6 +514,249 @@ namespace Falcor
         return sceneData;
     }
 
+    bool SceneCache::isPackage(const std::filesystem::path& path)
+    {
+        return hasExtension(path, kPackageExtension);
+    }
+
+    void SceneCache::writePackage(const Scene::SceneData& sceneData, const std::filesystem::path& path)
+    {
+        logInfo("Writing scene package to '{}'.", path);
+
+        // Open file.
+        std::ofstream fs(path, std::ios_base::binary);
+        if (!fs.good()) FALCOR_THROW("Failed to create scene package file '{}'.", path);
+
+        PackageHeader header;
+        std::memcpy(header.magic, kPackageMagic, sizeof(PackageHeader::magic));
+        header.majorVersion = kPackageMajorVersion;
+        header.minorVersion = kPackageMinorVersion;
+        fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        // Asset references are stored relative to the package directory.
+        const auto assetDirectory = std::filesystem::absolute(path).parent_path();
+
+        auto writeChunk = [&](uint32_t tag, uint16_t flags, const std::function<void(OutputStream&)>& writeFunc)
+        {
+            std::ostringstream payload(std::ios_base::binary);
+            if (flags & kChunkCompressed)
+            {
+                lz4_stream::basic_ostream<kBlockSize> zs(payload);
+                OutputStream stream(zs, assetDirectory);
+                writeFunc(stream);
+            }
+            else
+            {
+                OutputStream stream(payload, assetDirectory);
+                writeFunc(stream);
+            }
+
+            const std::string data = payload.str();
+            ChunkHeader chunkHeader;
+            chunkHeader.tag = tag;
+            chunkHeader.version = findSection(tag)->version;
+            chunkHeader.flags = flags;
+            chunkHeader.size = data.size();
+            fs.write(reinterpret_cast<const char*>(&chunkHeader), sizeof(chunkHeader));
+            fs.write(data.data(), data.size());
+        };
+
+        writeChunk(kLayoutTag, kChunkRequired, [&](OutputStream& stream)
+        {
+            auto layout = getPackageLayout();
+            stream.write((uint32_t)layout.size());
+            for (const auto& entry : layout)
+            {
+                stream.write(entry.name);
+                stream.write(entry.size);
+            }
+            for (const auto& entry : layout)
+            {
+                stream.write(entry.version);
+                stream.write(entry.fieldHash);
+            }
+        });
+        writeChunk(kSettingsTag, 0, [&](OutputStream& stream)
+        {
+            stream.write(sceneData.renderSettings);
+            writeMetadata(stream, sceneData.metadata);
+        });
+        writeChunk(kCamerasTag, 0, [&](OutputStream& stream) { writeCameras(stream, sceneData); });
+        writeChunk(kLightsTag, 0, [&](OutputStream& stream) { writeLights(stream, sceneData); });
+        writeChunk(kVolumesTag, kChunkCompressed, [&](OutputStream& stream) { writeVolumes(stream, sceneData); });
+        writeChunk(kEnvMapTag, 0, [&](OutputStream& stream) { writeEnvMapSection(stream, sceneData); });
+        writeChunk(kMaterialsTag, kChunkRequired, [&](OutputStream& stream) { writeMaterials(stream, *sceneData.pMaterials); });
+        writeChunk(kSceneGraphTag, kChunkRequired, [&](OutputStream& stream) { writeSceneGraph(stream, sceneData); });
+        writeChunk(kAnimationsTag, kChunkCompressed, [&](OutputStream& stream) { writeAnimations(stream, sceneData); });
+        writeChunk(kMeshesTag, kChunkCompressed | kChunkRequired, [&](OutputStream& stream) { writeMeshes(stream, sceneData); });
+        writeChunk(kCurvesTag, kChunkCompressed | kChunkRequired, [&](OutputStream& stream) { writeCurves(stream, sceneData); });
+        writeChunk(kCustomPrimitivesTag, 0, [&](OutputStream& stream) { writeCustomPrimitives(stream, sceneData); });
+        writeChunk(kSDFGridsTag, kChunkCompressed, [&](OutputStream& stream) { writeSDFGrids(stream, sceneData); });
+        writeChunk(kEndTag, 0, [](OutputStream&) {});
+
+        if (!fs.good()) FALCOR_THROW("Failed to write scene package file '{}'.", path);
+    }
+
+    Scene::SceneData SceneCache::readPackage(ref<Device> pDevice, const std::filesystem::path& path)
+    {
+        logInfo("Loading scene package from '{}'.", path);
+
+        // Open file.
+        std::ifstream fs(path, std::ios_base::binary);
+        if (!fs.good()) FALCOR_THROW("Failed to open scene package file '{}'.", path);
+
+        PackageHeader header;
+        fs.read(reinterpret_cast<char*>(&header), sizeof(header));
+        if (!fs.good() || std::memcmp(header.magic, kPackageMagic, sizeof(PackageHeader::magic)) != 0)
+        {
+            FALCOR_THROW("'{}' is not a scene package.", path);
+        }
+        if (header.majorVersion != kPackageMajorVersion)
+        {
+            FALCOR_THROW("Scene package '{}' has unsupported version {}.{} (expected {}.x).", path, header.majorVersion, header.minorVersion, kPackageMajorVersion);
+        }
+
+        // Read all chunks. Unknown chunks are skipped unless they are marked as required.
+        struct Chunk
+        {
+            uint16_t version;
+            uint16_t flags;
+            std::string data;
+        };
+        std::map<uint32_t, Chunk> chunks;
+        while (true)
+        {
+            ChunkHeader chunkHeader;
+            fs.read(reinterpret_cast<char*>(&chunkHeader), sizeof(chunkHeader));
+            if (!fs.good()) FALCOR_THROW("Scene package '{}' is truncated.", path);
+            if (chunkHeader.tag == kEndTag) break;
+
+            const SectionInfo* pSection = findSection(chunkHeader.tag);
+            if (!pSection)
+            {
+                if (chunkHeader.flags & kChunkRequired)
+                {
+                    FALCOR_THROW("Scene package '{}' contains required section '{}' which is not supported by this version.", path, tagToString(chunkHeader.tag));
+                }
+                logWarning("Skipping unknown section '{}' in scene package '{}'.", tagToString(chunkHeader.tag), path);
+                fs.seekg(chunkHeader.size, std::ios_base::cur);
+                continue;
+            }
+
+            if (chunkHeader.version < pSection->minVersion)
+            {
+                FALCOR_THROW("Section '{}' in scene package '{}' has unsupported version {} (expected {} or later). Re-export the package.",
+                    tagToString(chunkHeader.tag), path, chunkHeader.version, pSection->minVersion);
+            }
+            if (chunks.count(chunkHeader.tag) > 0)
+            {
+                FALCOR_THROW("Scene package '{}' contains section '{}' more than once.", path, tagToString(chunkHeader.tag));
+            }
+
+            Chunk& chunk = chunks[chunkHeader.tag];
+            chunk.version = chunkHeader.version;
+            chunk.flags = chunkHeader.flags;
+            chunk.data.resize(chunkHeader.size);
+            fs.read(chunk.data.data(), chunk.data.size());
+            if (!fs.good()) FALCOR_THROW("Scene package '{}' is truncated.", path);
+        }
+
+        // Parse a chunk. Chunks of newer versions only append data, so the trailing data is ignored.
+        const auto assetDirectory = std::filesystem::absolute(path).parent_path();
+        auto readChunk = [&](uint32_t tag, bool required, const std::function<void(InputStream&)>& readFunc)
+        {
+            auto it = chunks.find(tag);
+            if (it == chunks.end())
+            {
+                if (required) FALCOR_THROW("Scene package '{}' is missing section '{}'.", path, tagToString(tag));
+                return;
+            }
+
+            std::istringstream payload(it->second.data, std::ios_base::binary);
+            bool failed = false;
+            if (it->second.flags & kChunkCompressed)
+            {
+                lz4_stream::basic_istream<kBlockSize, kBlockSize> zs(payload);
+                InputStream stream(zs, assetDirectory);
+                readFunc(stream);
+                failed = stream.fail();
+            }
+            else
+            {
+                InputStream stream(payload, assetDirectory);
+                readFunc(stream);
+                failed = stream.fail();
+            }
+            if (failed) FALCOR_THROW("Section '{}' in scene package '{}' is corrupt.", tagToString(tag), path);
+        };
+
+        readChunk(kLayoutTag, true, [&](InputStream& stream)
+        {
+            // Version 1 stored the struct names and sizes. Version 2 appends the layout version and field hash of each struct.
+            uint32_t count = stream.read<uint32_t>();
+            std::vector<StructLayout> packageLayout;
+            for (uint32_t i = 0; i < count && !stream.fail(); i++)
+            {
+                StructLayout entry;
+                entry.name = stream.read<std::string>();
+                entry.size = stream.read<uint32_t>();
+                packageLayout.push_back(std::move(entry));
+            }
+            for (auto& entry : packageLayout)
+            {
+                entry.version = stream.read<uint32_t>();
+                entry.fieldHash = stream.read<uint64_t>();
+            }
+            if (stream.fail()) return;
+
+            // Every struct stored by this version must be described and match exactly.
+            for (const auto& expected : getPackageLayout())
+            {
+                auto it = std::find_if(packageLayout.begin(), packageLayout.end(), [&](const auto& entry) { return entry.name == expected.name; });
+                if (it == packageLayout.end())
+                {
+                    FALCOR_THROW("Scene package '{}' is incompatible with this version (layout of '{}' is missing). Re-export the package.", path, expected.name);
+                }
+                if (it->size != expected.size || it->version != expected.version || it->fieldHash != expected.fieldHash)
+                {
+                    FALCOR_THROW(
+                        "Scene package '{}' is incompatible with this version ('{}' has size {}, layout version {} and field hash {:016x}, expected {}, {} and {:016x}). Re-export the package.",
+                        path, expected.name, it->size, it->version, it->fieldHash, expected.size, expected.version, expected.fieldHash
+                    );
+                }
+            }
+        });
+
+        Scene::SceneData sceneData;
+        sceneData.path = path;
+        sceneData.pMaterials = std::make_unique<MaterialSystem>(pDevice);
+
+        readChunk(kSettingsTag, false, [&](InputStream& stream)
+        {
+            stream.read(sceneData.renderSettings);
+            sceneData.metadata = readMetadata(stream);
+        });
+        readChunk(kCamerasTag, false, [&](InputStream& stream) { readCameras(stream, sceneData); });
+        readChunk(kLightsTag, false, [&](InputStream& stream) { readLights(stream, sceneData); });
+        readChunk(kVolumesTag, false, [&](InputStream& stream) { readVolumes(stream, sceneData, pDevice); });
+        readChunk(kEnvMapTag, false, [&](InputStream& stream) { readEnvMapSection(stream, sceneData, pDevice); });
+
+        // See readSceneData() for why textures are loaded after volumes and the envmap.
+        {
+            MaterialTextureLoader materialTextureLoader(sceneData.pMaterials->getTextureManager(), true);
+            readChunk(kMaterialsTag, true, [&](InputStream& stream) { readMaterials(stream, *sceneData.pMaterials, materialTextureLoader, pDevice); });
+            readChunk(kSceneGraphTag, true, [&](InputStream& stream) { readSceneGraph(stream, sceneData); });
+            readChunk(kAnimationsTag, false, [&](InputStream& stream) { readAnimations(stream, sceneData); });
+            readChunk(kMeshesTag, true, [&](InputStream& stream) { readMeshes(stream, sceneData); });
+            readChunk(kCurvesTag, false, [&](InputStream& stream) { readCurves(stream, sceneData); });
+            readChunk(kCustomPrimitivesTag, false, [&](InputStream& stream) { readCustomPrimitives(stream, sceneData); });
+        }
+
+        readChunk(kSDFGridsTag, false, [&](InputStream& stream) { readSDFGrids(stream, sceneData, pDevice); });
+
+        return sceneData;
+    }
+
     std::filesystem::path SceneCache::getCachePath(const Key& key)
     {
         return getAppDataDirectory() / kDirectory / SHA1::toString(key);
@@ -267,37 +768,178 @@ namespace Falcor
     {
         writeMarker(stream, "Path");
         stream.write(sceneData.path);
+        stream.write(sceneData.preserveSourceObjects);
 
         writeMarker(stream, "RenderSettings");
         stream.write(sceneData.renderSettings);
 
         writeMarker(stream, "Cameras");
+        writeCameras(stream, sceneData);
+
+        writeMarker(stream, "Lights");
+        writeLights(stream, sceneData);
+
+        writeMarker(stream, "Volumes");
+        writeVolumes(stream, sceneData);
+
+        writeMarker(stream, "EnvMap");
+        writeEnvMapSection(stream, sceneData);
+
+        writeMarker(stream, "Materials");
+        writeMaterials(stream, *sceneData.pMaterials);
+
+        writeMarker(stream, "SceneGraph");
+        writeSceneGraph(stream, sceneData);
+
+        writeMarker(stream, "Animations");
+        writeAnimations(stream, sceneData);
+
+        writeMarker(stream, "Metadata");
+        writeMetadata(stream, sceneData.metadata);
+
+        writeMarker(stream, "Meshes");
+        writeMeshes(stream, sceneData);
+
+        writeMarker(stream, "Curves");
+        writeCurves(stream, sceneData);
+
+        writeMarker(stream, "CustomPrimitives");
+        writeCustomPrimitives(stream, sceneData);
+
+        writeMarker(stream, "SDFGrids");
+        writeSDFGrids(stream, sceneData);
+
+        writeMarker(stream, "End");
+    }
+
+    Scene::SceneData SceneCache::readSceneData(InputStream& stream, ref<Device> pDevice)
+    {
+        Scene::SceneData sceneData;
+        sceneData.pMaterials = std::make_unique<MaterialSystem>(pDevice);
+
+        readMarker(stream, "Path");
+        stream.read(sceneData.path);
+        stream.read(sceneData.preserveSourceObjects);
+
+        readMarker(stream, "RenderSettings");
+        stream.read(sceneData.renderSettings);
+
+        readMarker(stream, "Cameras");
+        readCameras(stream, sceneData);
+
+        readMarker(stream, "Lights");
+        readLights(stream, sceneData);
+
+        readMarker(stream, "Volumes");
+        readVolumes(stream, sceneData, pDevice);
+
+        readMarker(stream, "EnvMap");
+        readEnvMapSection(stream, sceneData, pDevice);
+
+        // Material textures are loaded asynchronously to allow loading other data
+        // in parallel while loading textures from files and uploading them to the GPU.
+        // Due to the current implementation, we need to make sure no other GPU operations (transfers)
+        // are executed while loading material textures. Due to this, we load volume grids and the envmap
+        // before material textures, as they upload buffers to the GPU when created.
+        // Make sure no other GPU operations are executed until calling pMaterialTextureLoader.reset()
+        // further down which blocks until all textures are loaded.
+        auto pMaterialTextureLoader = std::make_unique<MaterialTextureLoader>(sceneData.pMaterials->getTextureManager(), true);
+
+        readMarker(stream, "Materials");
+        readMaterials(stream, *sceneData.pMaterials, *pMaterialTextureLoader, pDevice);
+
+        readMarker(stream, "SceneGraph");
+        readSceneGraph(stream, sceneData);
+
+        readMarker(stream, "Animations");
+        readAnimations(stream, sceneData);
+
+        readMarker(stream, "Metadata");
+        sceneData.metadata = readMetadata(stream);
+
+        readMarker(stream, "Meshes");
+        readMeshes(stream, sceneData);
+
+        readMarker(stream, "Curves");
+        readCurves(stream, sceneData);
+
+        readMarker(stream, "CustomPrimitives");
+        readCustomPrimitives(stream, sceneData);
+
+        pMaterialTextureLoader.reset();
+
+        // SDF grids are created after the material textures are loaded, as they may upload data to the GPU.
+        readMarker(stream, "SDFGrids");
+        readSDFGrids(stream, sceneData, pDevice);
+
+        readMarker(stream, "End");
+
+        return sceneData;
+    }
+
+    // Scene data sections
+
+    void SceneCache::writeCameras(OutputStream& stream, const Scene::SceneData& sceneData)
+    {
         stream.write((uint32_t)sceneData.cameras.size());
         for (const auto& pCamera : sceneData.cameras) writeCamera(stream, pCamera);
         stream.write(sceneData.selectedCamera);
         stream.write(sceneData.cameraSpeed);
+    }
 
-        writeMarker(stream, "Lights");
+    void SceneCache::readCameras(InputStream& stream, Scene::SceneData& sceneData)
+    {
+        sceneData.cameras.resize(stream.read<uint32_t>());
+        for (auto& pCamera : sceneData.cameras) pCamera = readCamera(stream);
+        stream.read(sceneData.selectedCamera);
+        stream.read(sceneData.cameraSpeed);
+    }
+
+    void SceneCache::writeLights(OutputStream& stream, const Scene::SceneData& sceneData)
+    {
         stream.write((uint32_t)sceneData.lights.size());
         for (const auto& pLight : sceneData.lights) writeLight(stream, pLight);
+    }
+
+    void SceneCache::readLights(InputStream& stream, Scene::SceneData& sceneData)
+    {
+        sceneData.lights.resize(stream.read<uint32_t>());
+        for (auto& pLight : sceneData.lights) pLight = readLight(stream);
+    }
 
-        writeMarker(stream, "Grids");
+    void SceneCache::writeVolumes(OutputStream& stream, const Scene::SceneData& sceneData)
+    {
         stream.write((uint32_t)sceneData.grids.size());
         for (const auto& pGrid : sceneData.grids) writeGrid(stream, pGrid);
 
-        writeMarker(stream, "GridVolumes");
         stream.write((uint32_t)sceneData.gridVolumes.size());
         for (const auto& pGridVolume : sceneData.gridVolumes) writeGridVolume(stream, pGridVolume, sceneData.grids);
+    }
 
-        writeMarker(stream, "EnvMap");
+    void SceneCache::readVolumes(InputStream& stream, Scene::SceneData& sceneData, ref<Device> pDevice)
+    {
+        sceneData.grids.resize(stream.read<uint32_t>());
+        for (auto& pGrid : sceneData.grids) pGrid = readGrid(stream, pDevice);
+
+        sceneData.gridVolumes.resize(stream.read<uint32_t>());
+        for (auto& pGridVolume : sceneData.gridVolumes) pGridVolume = readGridVolume(stream, sceneData.grids, pDevice);
+    }
+
+    void SceneCache::writeEnvMapSection(OutputStream& stream, const Scene::SceneData& sceneData)
+    {
         bool hasEnvMap = sceneData.pEnvMap != nullptr;
         stream.write(hasEnvMap);
         if (hasEnvMap) writeEnvMap(stream, sceneData.pEnvMap);
+    }
 
-        writeMarker(stream, "Materials");
-        writeMaterials(stream, *sceneData.pMaterials);
+    void SceneCache::readEnvMapSection(InputStream& stream, Scene::SceneData& sceneData, ref<Device> pDevice)
+    {
+        auto hasEnvMap = stream.read<bool>();
+        if (hasEnvMap) sceneData.pEnvMap = readEnvMap(stream, pDevice);
+    }
 
-        writeMarker(stream, "SceneGraph");
+    void SceneCache::writeSceneGraph(OutputStream& stream, const Scene::SceneData& sceneData)
+    {
         stream.write((uint32_t)sceneData.sceneGraph.size());
         for (const auto& node : sceneData.sceneGraph)
         {
@@ -307,18 +949,38 @@ namespace Falcor
             stream.write(node.meshBind);
             stream.write(node.localToBindSpace);
         }
+    }
 
-        writeMarker(stream, "Animations");
+    void SceneCache::readSceneGraph(InputStream& stream, Scene::SceneData& sceneData)
+    {
+        sceneData.sceneGraph.resize(stream.read<uint32_t>());
+        for (auto &node : sceneData.sceneGraph)
+        {
+            stream.read(node.name);
+            stream.read(node.parent);
+            stream.read(node.transform);
+            stream.read(node.meshBind);
+            stream.read(node.localToBindSpace);
+        }
+    }
+
+    void SceneCache::writeAnimations(OutputStream& stream, const Scene::SceneData& sceneData)
+    {
         stream.write((uint32_t)sceneData.animations.size());
         for (const auto& pAnimation : sceneData.animations)
         {
             writeAnimation(stream, pAnimation);
         }
+    }
 
-        writeMarker(stream, "Metadata");
-        writeMetadata(stream, sceneData.metadata);
+    void SceneCache::readAnimations(InputStream& stream, Scene::SceneData& sceneData)
+    {
+        sceneData.animations.resize(stream.read<uint32_t>());
+        for (auto& pAnimation : sceneData.animations) pAnimation = readAnimation(stream);
+    }
 
-        writeMarker(stream, "Meshes");
+    void SceneCache::writeMeshes(OutputStream& stream, const Scene::SceneData& sceneData)
+    {
         stream.write(sceneData.meshDesc);
         stream.write(sceneData.meshNames);
         stream.write(sceneData.meshBBs);
@@ -347,99 +1009,24 @@ namespace Falcor
         stream.write(sceneData.has16BitIndices);
         stream.write(sceneData.has32BitIndices);
         stream.write(sceneData.meshDrawCount);
+        stream.write(sceneData.prevVertexCount);
         stream.write(sceneData.meshIndexData);
         stream.write(sceneData.meshStaticData);
         stream.write(sceneData.meshSkinningData);
-
-        writeMarker(stream, "Curves");
-        stream.write(sceneData.curveDesc);
-        stream.write(sceneData.curveBBs);
-        stream.write(sceneData.curveInstanceData);
-        stream.write(sceneData.curveIndexData);
-        stream.write(sceneData.curveStaticData);
-
-        stream.write((uint32_t)sceneData.cachedCurves.size());
-        for (const auto& cachedCurve : sceneData.cachedCurves)
+        stream.write((uint32_t)sceneData.meshLODs.size());
+        for (const auto& info : sceneData.meshLODs)
         {
-            stream.write(cachedCurve.tessellationMode);
-            stream.write(cachedCurve.geometryID);
-            stream.write(cachedCurve.timeSamples);
-            stream.write(cachedCurve.indexData);
-            stream.write((uint32_t)cachedCurve.vertexData.size());
-            for (const auto& data : cachedCurve.vertexData) stream.write(data);
+            stream.write(info.meshName);
+            stream.write(info.levels);
         }
-
-        writeMarker(stream, "CustomPrimitives");
-        stream.write(sceneData.customPrimitiveDesc);
-        stream.write(sceneData.customPrimitiveAABBs);
-
-        writeMarker(stream, "End");
+        stream.write(sceneData.meshlets);
+        stream.write(sceneData.meshletOffsets);
+        stream.write(sceneData.meshletVertices);
+        stream.write(sceneData.meshletTriangles);
     }
 
-    Scene::SceneData SceneCache::readSceneData(InputStream& stream, ref<Device> pDevice)
+    void SceneCache::readMeshes(InputStream& stream, Scene::SceneData& sceneData)
     {
-        Scene::SceneData sceneData;
-        sceneData.pMaterials = std::make_unique<MaterialSystem>(pDevice);
-
-        readMarker(stream, "Path");
-        stream.read(sceneData.path);
-
-        readMarker(stream, "RenderSettings");
-        stream.read(sceneData.renderSettings);
-
-        readMarker(stream, "Cameras");
-        sceneData.cameras.resize(stream.read<uint32_t>());
-        for (auto& pCamera : sceneData.cameras) pCamera = readCamera(stream);
-        stream.read(sceneData.selectedCamera);
-        stream.read(sceneData.cameraSpeed);
-
-        readMarker(stream, "Lights");
-        sceneData.lights.resize(stream.read<uint32_t>());
-        for (auto& pLight : sceneData.lights) pLight = readLight(stream);
-
-        readMarker(stream, "Grids");
-        sceneData.grids.resize(stream.read<uint32_t>());
-        for (auto& pGrid : sceneData.grids) pGrid = readGrid(stream, pDevice);
-
-        readMarker(stream, "GridVolumes");
-        sceneData.gridVolumes.resize(stream.read<uint32_t>());
-        for (auto& pGridVolume : sceneData.gridVolumes) pGridVolume = readGridVolume(stream, sceneData.grids, pDevice);
-
-        readMarker(stream, "EnvMap");
-        auto hasEnvMap = stream.read<bool>();
-        if (hasEnvMap) sceneData.pEnvMap = readEnvMap(stream, pDevice);
-
-        // Material textures are loaded asynchronously to allow loading other data
-        // in parallel while loading textures from files and uploading them to the GPU.
-        // Due to the current implementation, we need to make sure no other GPU operations (transfers)
-        // are executed while loading material textures. Due to this, we load volume grids and the envmap
-        // before material textures, as they upload buffers to the GPU when created.
-        // Make sure no other GPU operations are executed until calling pMaterialTextureLoader.reset()
-        // further down which blocks until all textures are loaded.
-        auto pMaterialTextureLoader = std::make_unique<MaterialTextureLoader>(sceneData.pMaterials->getTextureManager(), true);
-
-        readMarker(stream, "Materials");
-        readMaterials(stream, *sceneData.pMaterials, *pMaterialTextureLoader, pDevice);
-
-        readMarker(stream, "SceneGraph");
-        sceneData.sceneGraph.resize(stream.read<uint32_t>());
-        for (auto &node : sceneData.sceneGraph)
-        {
-            stream.read(node.name);
-            stream.read(node.parent);
-            stream.read(node.transform);
-            stream.read(node.meshBind);
-            stream.read(node.localToBindSpace);
-        }
-
-        readMarker(stream, "Animations");
-        sceneData.animations.resize(stream.read<uint32_t>());
-        for (auto& pAnimation : sceneData.animations) pAnimation = readAnimation(stream);
-
-        readMarker(stream, "Metadata");
-        sceneData.metadata = readMetadata(stream);
-
-        readMarker(stream, "Meshes");
         stream.read(sceneData.meshDesc);
         stream.read(sceneData.meshNames);
         stream.read(sceneData.meshBBs);
@@ -468,11 +1055,44 @@ namespace Falcor
         stream.read(sceneData.has16BitIndices);
         stream.read(sceneData.has32BitIndices);
         stream.read(sceneData.meshDrawCount);
+        stream.read(sceneData.prevVertexCount);
         stream.read(sceneData.meshIndexData);
         stream.read(sceneData.meshStaticData);
         stream.read(sceneData.meshSkinningData);
+        sceneData.meshLODs.resize(stream.read<uint32_t>());
+        for (auto& info : sceneData.meshLODs)
+        {
+            stream.read(info.meshName);
+            stream.read(info.levels);
+        }
+        stream.read(sceneData.meshlets);
+        stream.read(sceneData.meshletOffsets);
+        stream.read(sceneData.meshletVertices);
+        stream.read(sceneData.meshletTriangles);
+    }
 
-        readMarker(stream, "Curves");
+    void SceneCache::writeCurves(OutputStream& stream, const Scene::SceneData& sceneData)
+    {
+        stream.write(sceneData.curveDesc);
+        stream.write(sceneData.curveBBs);
+        stream.write(sceneData.curveInstanceData);
+        stream.write(sceneData.curveIndexData);
+        stream.write(sceneData.curveStaticData);
+
+        stream.write((uint32_t)sceneData.cachedCurves.size());
+        for (const auto& cachedCurve : sceneData.cachedCurves)
+        {
+            stream.write(cachedCurve.tessellationMode);
+            stream.write(cachedCurve.geometryID);
+            stream.write(cachedCurve.timeSamples);
+            stream.write(cachedCurve.indexData);
+            stream.write((uint32_t)cachedCurve.vertexData.size());
+            for (const auto& data : cachedCurve.vertexData) stream.write(data);
+        }
+    }
+
+    void SceneCache::readCurves(InputStream& stream, Scene::SceneData& sceneData)
+    {
         stream.read(sceneData.curveDesc);
         stream.read(sceneData.curveBBs);
         stream.read(sceneData.curveInstanceData);
@@ -489,16 +1109,50 @@ namespace Falcor
             cachedCurve.vertexData.resize(stream.read<uint32_t>());
             for (auto& data : cachedCurve.vertexData) stream.read(data);
         }
+    }
 
-        readMarker(stream, "CustomPrimitives");
+    void SceneCache::writeCustomPrimitives(OutputStream& stream, const Scene::SceneData& sceneData)
+    {
+        stream.write(sceneData.customPrimitiveDesc);
+        stream.write(sceneData.customPrimitiveAABBs);
+    }
+
+    void SceneCache::readCustomPrimitives(InputStream& stream, Scene::SceneData& sceneData)
+    {
         stream.read(sceneData.customPrimitiveDesc);
         stream.read(sceneData.customPrimitiveAABBs);
+    }
 
-        readMarker(stream, "End");
+    void SceneCache::writeSDFGrids(OutputStream& stream, const Scene::SceneData& sceneData)
+    {
+        stream.write((uint32_t)sceneData.sdfGrids.size());
+        for (const auto& pSDFGrid : sceneData.sdfGrids) writeSDFGrid(stream, pSDFGrid);
 
-        pMaterialTextureLoader.reset();
+        stream.write((uint32_t)sceneData.sdfGridDesc.size());
+        for (const auto& desc : sceneData.sdfGridDesc)
+        {
+            stream.write(desc.sdfGridID);
+            stream.write(desc.materialID);
+            stream.write(desc.instances);
+        }
+        stream.write(sceneData.sdfGridInstances);
+        stream.write(sceneData.sdfGridMaxLODCount);
+    }
 
-        return sceneData;
+    void SceneCache::readSDFGrids(InputStream& stream, Scene::SceneData& sceneData, ref<Device> pDevice)
+    {
+        sceneData.sdfGrids.resize(stream.read<uint32_t>());
+        for (auto& pSDFGrid : sceneData.sdfGrids) pSDFGrid = readSDFGrid(stream, pDevice);
+
+        sceneData.sdfGridDesc.resize(stream.read<uint32_t>());
+        for (auto& desc : sceneData.sdfGridDesc)
+        {
+            stream.read(desc.sdfGridID);
+            stream.read(desc.materialID);
+            stream.read(desc.instances);
+        }
+        stream.read(sceneData.sdfGridInstances);
+        stream.read(sceneData.sdfGridMaxLODCount);
     }
 
     // Metadata
@@ -677,7 +1331,7 @@ namespace Falcor
             stream.write(hasTexture);
             if (hasTexture)
             {
-                stream.write(pTexture->getSourcePath());
+                stream.writeAssetPath(pTexture->getSourcePath());
             }
         };
 
@@ -751,7 +1405,7 @@ namespace Falcor
             auto hasTexture = stream.read<bool>();
             if (hasTexture)
             {
-                auto path = stream.read<std::filesystem::path>();
+                auto path = stream.readAssetPath();
                 materialTextureLoader.loadTexture(pMaterial, slot, path);
             }
         };
@@ -859,6 +1513,7 @@ namespace Falcor
         const nanovdb::HostBuffer& buffer = pGrid->mGridHandle.buffer();
         stream.write((uint64_t)buffer.size());
         stream.write(buffer.data(), buffer.size());
+        stream.write(pGrid->mStorageDesc);
     }
 
     ref<Grid> SceneCache::readGrid(InputStream& stream, ref<Device> pDevice)
@@ -866,22 +1521,23 @@ namespace Falcor
         uint64_t size = stream.read<uint64_t>();
         auto buffer = nanovdb::HostBuffer::create(size);
         stream.read(buffer.data(), buffer.size());
-        return ref<Grid>(new Grid(pDevice, nanovdb::GridHandle<nanovdb::HostBuffer>(std::move(buffer))));
+        Grid::StorageDesc storage;
+        stream.read(storage);
+        return ref<Grid>(new Grid(pDevice, nanovdb::GridHandle<nanovdb::HostBuffer>(std::move(buffer)), storage));
     }
 
     // EnvMap
 
     void SceneCache::writeEnvMap(OutputStream& stream, const ref<EnvMap>& pEnvMap)
     {
-        auto path = pEnvMap->getEnvMap()->getSourcePath();
-        stream.write(path);
+        stream.writeAssetPath(pEnvMap->getEnvMap()->getSourcePath());
         stream.write(pEnvMap->mData);
         stream.write(pEnvMap->mRotation);
     }
 
     ref<EnvMap> SceneCache::readEnvMap(InputStream& stream, ref<Device> pDevice)
     {
-        auto path = stream.read<std::filesystem::path>();
+        auto path = stream.readAssetPath();
         auto pEnvMap = EnvMap::createFromFile(pDevice, path);
         if (!pEnvMap) FALCOR_THROW("Failed to load environment map");
         stream.read(pEnvMap->mData);
@@ -935,6 +1591,100 @@ namespace Falcor
         return pAnimation;
     }
 
+    // SDFGrid
+
+    void SceneCache::writeSDFGrid(OutputStream& stream, const ref<SDFGrid>& pSDFGrid)
+    {
+        SDFGrid::Type type = pSDFGrid->getType();
+        stream.write(type);
+
+        // Write type specific creation parameters.
+        switch (type)
+        {
+        case SDFGrid::Type::NormalizedDenseGrid:
+            stream.write(static_ref_cast<NDSDFGrid>(pSDFGrid)->mNarrowBandThickness);
+            break;
+        case SDFGrid::Type::SparseBrickSet:
+        {
+            auto pSBS = static_ref_cast<SDFSBS>(pSDFGrid);
+            stream.write(pSBS->mBrickWidth);
+            stream.write(pSBS->mCompressed);
+            stream.write(pSBS->mDefaultGridWidth);
+            break;
+        }
+        case SDFGrid::Type::SparseVoxelSet:
+        case SDFGrid::Type::SparseVoxelOctree:
+            break;
+        default:
+            FALCOR_THROW("Unsupported SDF grid type");
+        }
+
+        stream.write(pSDFGrid->mName);
+        stream.write(pSDFGrid->mGridWidth);
+
+        // The value representation is stored by reference to its source, as the grids don't retain the original values.
+        if (pSDFGrid->mValuesSource == SDFGrid::ValuesSource::Memory)
+        {
+            logWarning("SDF grid '{}' has values that were set from memory. These values are not serialized.", pSDFGrid->mName);
+        }
+        stream.write(pSDFGrid->mValuesSource);
+        if (pSDFGrid->mValuesSource == SDFGrid::ValuesSource::File) stream.writeAssetPath(pSDFGrid->mValuesPath);
+        if (pSDFGrid->mValuesSource == SDFGrid::ValuesSource::Cheese) stream.write(pSDFGrid->mCheeseSeed);
+
+        stream.write(pSDFGrid->mPrimitives.getPrimitives());
+        stream.write(pSDFGrid->mInitializedWithPrimitives);
+    }
+
+    ref<SDFGrid> SceneCache::readSDFGrid(InputStream& stream, ref<Device> pDevice)
+    {
+        ref<SDFGrid> pSDFGrid;
+        auto type = stream.read<SDFGrid::Type>();
+        switch (type)
+        {
+        case SDFGrid::Type::NormalizedDenseGrid:
+            pSDFGrid = NDSDFGrid::create(pDevice, stream.read<float>());
+            break;
+        case SDFGrid::Type::SparseBrickSet:
+        {
+            auto brickWidth = stream.read<uint32_t>();
+            auto compressed = stream.read<bool>();
+            auto defaultGridWidth = stream.read<uint32_t>();
+            pSDFGrid = SDFSBS::create(pDevice, brickWidth, compressed, defaultGridWidth);
+            break;
+        }
+        case SDFGrid::Type::SparseVoxelSet:
+            pSDFGrid = SDFSVS::create(pDevice);
+            break;
+        case SDFGrid::Type::SparseVoxelOctree:
+            pSDFGrid = SDFSVO::create(pDevice);
+            break;
+        default:
+            FALCOR_THROW("Unsupported SDF grid type");
+        }
+
+        stream.read(pSDFGrid->mName);
+        auto gridWidth = stream.read<uint32_t>();
+
+        auto valuesSource = stream.read<SDFGrid::ValuesSource>();
+        if (valuesSource == SDFGrid::ValuesSource::File)
+        {
+            auto path = stream.readAssetPath();
+            if (!pSDFGrid->loadValuesFromFile(path)) FALCOR_THROW("Failed to load SDF grid values from '{}'.", path);
+        }
+        else if (valuesSource == SDFGrid::ValuesSource::Cheese)
+        {
+            pSDFGrid->generateCheeseValues(gridWidth, stream.read<uint32_t>());
+        }
+
+        std::vector<SDF3DPrimitive> primitives;
+        stream.read(primitives);
+        if (!primitives.empty()) pSDFGrid->setPrimitives(primitives, gridWidth);
+        pSDFGrid->mGridWidth = gridWidth;
+        stream.read(pSDFGrid->mInitializedWithPrimitives);
+
+        return pSDFGrid;
+    }
+
     // Marker
 
     void SceneCache::writeMarker(OutputStream& stream, const std::string& id)
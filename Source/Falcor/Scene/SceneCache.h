@@ -33,6 +33,7 @@
 #include "Lights/Light.h"
 #include "Volume/Grid.h"
 #include "Volume/GridVolume.h"
+#include "SDFs/SDFGrid.h"
 #include "Material/BasicMaterial.h"
 #include "Material/MaterialSystem.h"
 #include "Material/MaterialTextureLoader.h"
@@ -47,15 +48,23 @@
 
 namespace Falcor
 {
-    /** Helper class for reading and writing scene cache files.
+    /** Helper class for reading and writing scene cache files and scene packages.
         The scene cache is used to heavily reduce load times of more complex assets.
         The cache stores a binary representation of `Scene::SceneData` which contains everything to re-create a `Scene`.
+
+        Scene packages store the same data in a portable, versioned file made of independent sections.
+        Asset references are stored relative to the package, so packages can be moved along with their assets.
+        See docs/usage/scene-formats.md for a description of the format.
     */
     class FALCOR_API SceneCache
     {
     public:
         using Key = SHA1::MD;
 
+        /** File extension of scene packages.
+        */
+        static constexpr char kPackageExtension[] = "fscene";
+
         /** Check if there is a valid scene cache for a given cache key.
             \param[in] key Cache key.
             \return Returns true if a valid cache exists.
@@ -75,6 +84,26 @@ namespace Falcor
         */
         static Scene::SceneData readCache(ref<Device> pDevice, const Key& key);
 
+        /** Check if a file is a scene package (based on the file extension).
+            \param[in] path File path.
+            \return Returns true if the file has the scene package extension.
+        */
+        static bool isPackage(const std::filesystem::path& path);
+
+        /** Write a scene package.
+            \param[in] sceneData Scene data.
+            \param[in] path File path.
+        */
+        static void writePackage(const Scene::SceneData& sceneData, const std::filesystem::path& path);
+
+        /** Read a scene package.
+            Sections that are unknown to this version are skipped. Throws if the package is incompatible or corrupt.
+            \param[in] pDevice GPU device.
+            \param[in] path File path.
+            \return Returns the loaded scene data.
+        */
+        static Scene::SceneData readPackage(ref<Device> pDevice, const std::filesystem::path& path);
+
     private:
         class OutputStream;
         class InputStream;
@@ -84,6 +113,36 @@ namespace Falcor
         static void writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData);
         static Scene::SceneData readSceneData(InputStream& stream, ref<Device> pDevice);
 
+        static void writeCameras(OutputStream& stream, const Scene::SceneData& sceneData);
+        static void readCameras(InputStream& stream, Scene::SceneData& sceneData);
+
+        static void writeLights(OutputStream& stream, const Scene::SceneData& sceneData);
+        static void readLights(InputStream& stream, Scene::SceneData& sceneData);
+
+        static void writeVolumes(OutputStream& stream, const Scene::SceneData& sceneData);
+        static void readVolumes(InputStream& stream, Scene::SceneData& sceneData, ref<Device> pDevice);
+
+        static void writeEnvMapSection(OutputStream& stream, const Scene::SceneData& sceneData);
+        static void readEnvMapSection(InputStream& stream, Scene::SceneData& sceneData, ref<Device> pDevice);
+
+        static void writeSceneGraph(OutputStream& stream, const Scene::SceneData& sceneData);
+        static void readSceneGraph(InputStream& stream, Scene::SceneData& sceneData);
+
+        static void writeAnimations(OutputStream& stream, const Scene::SceneData& sceneData);
+        static void readAnimations(InputStream& stream, Scene::SceneData& sceneData);
+
+        static void writeMeshes(OutputStream& stream, const Scene::SceneData& sceneData);
+        static void readMeshes(InputStream& stream, Scene::SceneData& sceneData);
+
+        static void writeCurves(OutputStream& stream, const Scene::SceneData& sceneData);
+        static void readCurves(InputStream& stream, Scene::SceneData& sceneData);
+
+        static void writeCustomPrimitives(OutputStream& stream, const Scene::SceneData& sceneData);
+        static void readCustomPrimitives(InputStream& stream, Scene::SceneData& sceneData);
+
+        static void writeSDFGrids(OutputStream& stream, const Scene::SceneData& sceneData);
+        static void readSDFGrids(InputStream& stream, Scene::SceneData& sceneData, ref<Device> pDevice);
+
         static void writeMetadata(OutputStream& stream, const Scene::Metadata& metadata);
         static Scene::Metadata readMetadata(InputStream& stream);
 
@@ -109,6 +168,9 @@ namespace Falcor
         static void writeGrid(OutputStream& stream, const ref<Grid>& pGrid);
         static ref<Grid> readGrid(InputStream& stream, ref<Device> pDevice);
 
+        static void writeSDFGrid(OutputStream& stream, const ref<SDFGrid>& pSDFGrid);
+        static ref<SDFGrid> readSDFGrid(InputStream& stream, ref<Device> pDevice);
+
         static void writeEnvMap(OutputStream& stream, const ref<EnvMap>& pEnvMap);
         static ref<EnvMap> readEnvMap(InputStream& stream, ref<Device> pDevice);
 
@@ -0,0 +1,180 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SceneChangeMapper.h"
+#include <fmt/format.h>
+#include <algorithm>
+#include <set>
+#include <utility>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Get the parent of a path, or an empty string if the path has no parent.
+        */
+        std::string getParentPath(const std::string& path)
+        {
+            size_t pos = path.find_last_of('/');
+            if (pos == std::string::npos || path.size() <= 1) return {};
+            return pos == 0 ? std::string("/") : path.substr(0, pos);
+        }
+    }
+
+    void SceneChangeMapper::registerObject(const std::string& path, ObjectType type, uint32_t id)
+    {
+        mObjects[path].push_back({ type, id });
+    }
+
+    size_t SceneChangeMapper::getObjectCount() const
+    {
+        size_t count = 0;
+        for (const auto& [path, objects] : mObjects) count += objects.size();
+        return count;
+    }
+
+    void SceneChangeMapper::setPropertyKind(const std::string& pattern, PropertyKind kind)
+    {
+        if (!pattern.empty() && pattern.back() == '*') mPropertyPrefixKinds[pattern.substr(0, pattern.size() - 1)] = kind;
+        else mPropertyKinds[pattern] = kind;
+    }
+
+    SceneChangeMapper::PropertyKind SceneChangeMapper::getPropertyKind(const std::string& property) const
+    {
+        if (auto it = mPropertyKinds.find(property); it != mPropertyKinds.end()) return it->second;
+
+        const std::pair<const std::string, PropertyKind>* pBest = nullptr;
+        for (const auto& entry : mPropertyPrefixKinds)
+        {
+            if (property.compare(0, entry.first.size(), entry.first) != 0) continue;
+            if (!pBest || entry.first.size() > pBest->first.size()) pBest = &entry;
+        }
+        return pBest ? pBest->second : PropertyKind::Parameter;
+    }
+
+    const SceneChangeMapper::Object* SceneChangeMapper::findObject(const std::string& path, ObjectType type) const
+    {
+        auto it = mObjects.find(path);
+        if (it == mObjects.end()) return nullptr;
+        auto objIt = std::find_if(it->second.begin(), it->second.end(), [type](const Object& obj) { return obj.type == type; });
+        return objIt != it->second.end() ? &*objIt : nullptr;
+    }
+
+    std::string SceneChangeMapper::findAncestorPath(const std::string& path, ObjectType type) const
+    {
+        for (std::string curPath = path; !curPath.empty(); curPath = getParentPath(curPath))
+        {
+            if (findObject(curPath, type)) return curPath;
+        }
+        return {};
+    }
+
+    bool SceneChangeMapper::isRelevant(const std::string& path) const
+    {
+        // The path is relevant if an object is registered at it, above it or below it.
+        for (std::string curPath = path; !curPath.empty(); curPath = getParentPath(curPath))
+        {
+            if (mObjects.count(curPath) > 0) return true;
+        }
+
+        std::string prefix = (!path.empty() && path.back() == '/') ? path : path + '/';
+        auto it = mObjects.lower_bound(prefix);
+        return it != mObjects.end() && it->first.compare(0, prefix.size(), prefix) == 0;
+    }
+
+    SceneChangeMapper::Result SceneChangeMapper::map(const std::vector<Change>& changes) const
+    {
+        Result result;
+        std::set<std::pair<ObjectType, uint32_t>> updated;
+
+        auto addUpdates = [&](const std::string& path, ObjectType type, const std::string& sourcePath)
+        {
+            for (const auto& obj : mObjects.at(path))
+            {
+                if (obj.type == type && updated.emplace(type, obj.id).second) result.updates.push_back({ type, obj.id, sourcePath });
+            }
+        };
+
+        auto requireRebuild = [&](std::string reason)
+        {
+            if (result.rebuild) return;
+            result.rebuild = true;
+            result.rebuildReason = std::move(reason);
+        };
+
+        for (const auto& change : changes)
+        {
+            if (result.rebuild) break;
+
+            if (change.resync)
+            {
+                // Restructuring inside a material (e.g. reconnected shader inputs) is handled by converting the material again.
+                // Anything else may add or remove scene objects.
+                if (auto materialPath = findAncestorPath(change.path, ObjectType::Material); !materialPath.empty())
+                {
+                    addUpdates(materialPath, ObjectType::Material, materialPath);
+                }
+                else requireRebuild(fmt::format("'{}' was restructured", change.path));
+                continue;
+            }
+
+            for (const auto& property : change.properties)
+            {
+                switch (getPropertyKind(property))
+                {
+                case PropertyKind::Ignore:
+                    break;
+                case PropertyKind::Topology:
+                    if (isRelevant(change.path)) requireRebuild(fmt::format("Property '{}' of '{}' changed", property, change.path));
+                    break;
+                case PropertyKind::Transform:
+                    if (findObject(change.path, ObjectType::Node)) addUpdates(change.path, ObjectType::Node, change.path);
+                    else if (isRelevant(change.path)) requireRebuild(fmt::format("Transform of '{}' has no matching scene node", change.path));
+                    break;
+                case PropertyKind::Parameter:
+                    if (findObject(change.path, ObjectType::Light))
+                    {
+                        addUpdates(change.path, ObjectType::Light, change.path);
+                    }
+                    else if (auto materialPath = findAncestorPath(change.path, ObjectType::Material); !materialPath.empty())
+                    {
+                        addUpdates(materialPath, ObjectType::Material, materialPath);
+                    }
+                    else if (findObject(change.path, ObjectType::Mesh) || findObject(change.path, ObjectType::Other))
+                    {
+                        requireRebuild(fmt::format("Property '{}' of '{}' changed", property, change.path));
+                    }
+                    break;
+                }
+                if (result.rebuild) break;
+            }
+        }
+
+        if (result.rebuild) result.updates.clear();
+        return result;
+    }
+}
@@ -0,0 +1,149 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+    /** Maps changes to objects in the source asset of a scene (e.g. USD prims) to the scene objects they affect.
+        Objects are identified by hierarchical paths with '/' separators. Importers that support live updates register
+        the source path of each scene object, and translate their native change notifications into Change records.
+        The mapper then decides which scene objects can be updated in place and whether the scene needs to be rebuilt.
+
+        A changed property is classified by its name (see setPropertyKind()) and resolved against the objects
+        registered at, above and below the changed path:
+        - Transform properties update the node registered at the path.
+        - Parameter properties update the light registered at the path, or the material registered at or above the path.
+        - Topology properties, parameters of meshes and other objects, and changes that can't be applied in place require a rebuild.
+        Changes to paths that are unrelated to all registered objects are ignored.
+    */
+    class FALCOR_API SceneChangeMapper
+    {
+    public:
+        /** Type of scene object.
+        */
+        enum class ObjectType
+        {
+            Node,       ///< Scene graph node.
+            Material,   ///< Material.
+            Light,      ///< Analytic light.
+            Mesh,       ///< Mesh.
+            Other,      ///< Other scene object that can only be updated by rebuilding the scene.
+        };
+
+        /** Effect of a property change.
+        */
+        enum class PropertyKind
+        {
+            Ignore,     ///< The property doesn't affect the scene.
+            Transform,  ///< The property affects the local transform of the object.
+            Parameter,  ///< The property is a parameter of a material or light.
+            Topology,   ///< The property changes geometry or scene structure and requires a rebuild.
+        };
+
+        /** Change to an object in the source asset.
+        */
+        struct Change
+        {
+            std::string path;                       ///< Path of the changed object.
+            std::vector<std::string> properties;    ///< Names of the changed properties.
+            bool resync = false;                    ///< True if the object or its descendants were added, removed or restructured.
+        };
+
+        /** Scene object to update in place.
+        */
+        struct Update
+        {
+            ObjectType type;    ///< Type of the object.
+            uint32_t id;        ///< ID of the object in the scene.
+            std::string path;   ///< Path of the source object to read the new state from.
+
+            bool operator==(const Update& other) const { return type == other.type && id == other.id && path == other.path; }
+        };
+
+        /** Result of mapping a set of changes.
+        */
+        struct Result
+        {
+            std::vector<Update> updates;    ///< Objects to update, in order of first occurrence. Empty if a rebuild is required.
+            bool rebuild = false;           ///< True if the changes can't be applied in place.
+            std::string rebuildReason;      ///< Description of the first change that requires a rebuild.
+        };
+
+        /** Register a scene object.
+            Several objects, also of the same type, may be registered at the same path.
+            \param[in] path Path of the source object.
+            \param[in] type Type of the scene object.
+            \param[in] id ID of the scene object.
+        */
+        void registerObject(const std::string& path, ObjectType type, uint32_t id);
+
+        /** Remove all registered objects. Property kinds are kept.
+        */
+        void clearObjects() { mObjects.clear(); }
+
+        /** Get the number of registered objects.
+        */
+        size_t getObjectCount() const;
+
+        /** Set the kind of a property.
+            \param[in] pattern Property name, or a name prefix followed by '*'. Exact names take precedence over prefixes,
+                and longer prefixes over shorter ones.
+            \param[in] kind Kind of the matching properties.
+        */
+        void setPropertyKind(const std::string& pattern, PropertyKind kind);
+
+        /** Get the kind of a property. Properties that don't match any pattern are parameters.
+        */
+        PropertyKind getPropertyKind(const std::string& property) const;
+
+        /** Map a set of changes to scene updates.
+        */
+        Result map(const std::vector<Change>& changes) const;
+
+    private:
+        struct Object
+        {
+            ObjectType type;
+            uint32_t id;
+        };
+
+        const Object* findObject(const std::string& path, ObjectType type) const;
+        std::string findAncestorPath(const std::string& path, ObjectType type) const;
+        bool isRelevant(const std::string& path) const;
+
+        std::map<std::string, std::vector<Object>> mObjects;                ///< Registered objects, sorted by path.
+        std::unordered_map<std::string, PropertyKind> mPropertyKinds;       ///< Kinds of exact property names.
+        std::map<std::string, PropertyKind> mPropertyPrefixKinds;           ///< Kinds of property name prefixes.
+    };
+}
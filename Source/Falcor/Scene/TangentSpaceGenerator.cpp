@@ -0,0 +1,557 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TangentSpaceGenerator.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Math/FNVHash.h"
+#include <mikktspace.h>
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+#include <execution>
+#include <numeric>
+
+namespace Falcor
+{
+    namespace
+    {
+        // Triangle flags. These match the flags of the reference implementation.
+        const uint32_t kGroupWithAny = 0x4;         ///< Triangle has a degenerate texture mapping and joins any group.
+        const uint32_t kOrientPreserving = 0x8;     ///< Texture mapping preserves the orientation of the triangle.
+
+        const uint32_t kInvalidIndex = 0xffffffff;
+        const uint32_t kGroupsPerTask = 256;        ///< Number of groups evaluated per parallel task.
+        const double kPi = 3.1415926535897932384626433832795;
+
+        /// Positions with a larger magnitude overflow the bounds computations of the reference vertex welding.
+        const float kMaxPositionMagnitude = 1e37f;
+
+        // The vector helpers below use the same operation order as the reference implementation.
+        // They must not be replaced by the generic math functions, as the results need to be bit-identical.
+
+        float dot3(const float3& a, const float3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+        float length3(const float3& v) { return std::sqrt(dot3(v, v)); }
+        float3 scale(float s, const float3& v) { return float3(s * v.x, s * v.y, s * v.z); }
+        bool notZero(float x) { return std::fabs(x) > FLT_MIN; }
+        bool notZero(const float3& v) { return notZero(v.x) || notZero(v.y) || notZero(v.z); }
+        float3 normalizeIfNotZero(const float3& v) { return notZero(v) ? scale(1.f / length3(v), v) : v; }
+
+        /** Project a vector onto the plane orthogonal to n and normalize it.
+        */
+        float3 projectAndNormalize(const float3& n, const float3& v) { return normalizeIfNotZero(v - scale(dot3(n, v), n)); }
+
+        bool equal(const float3& a, const float3& b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+        bool equal(const float2& a, const float2& b) { return a.x == b.x && a.y == b.y; }
+
+        template<typename T>
+        bool bitwiseEqual(const T& a, const T& b) { return std::memcmp(&a, &b, sizeof(T)) == 0; }
+
+        /** Hash the welding key of a vertex. Zeros are canonicalized as the welding compares floats by value.
+        */
+        uint64_t hashVertex(const float3& position, const float3& normal, const float2& texCrd)
+        {
+            float key[8] = { position.x, position.y, position.z, normal.x, normal.y, normal.z, texCrd.x, texCrd.y };
+            for (float& x : key) if (x == 0.f) x = 0.f;
+            return fnvHashArray64(key, sizeof(key));
+        }
+
+        /** Per-triangle data of non-degenerate triangles.
+        */
+        struct TriangleInfo
+        {
+            float3 os = float3(0.f);                ///< Normalized first order derivative of the position w.r.t. s.
+            float3 ot = float3(0.f);                ///< Normalized first order derivative of the position w.r.t. t.
+            uint32_t flags = kGroupWithAny;
+            int32_t neighbors[3] = { -1, -1, -1 };  ///< Adjacent triangle across each edge or -1.
+        };
+
+        /** Triangle edge, bucketed by its smaller welded vertex index.
+        */
+        struct Edge
+        {
+            uint32_t vertex;    ///< Larger welded vertex index.
+            uint32_t triangle;
+            uint32_t edge;
+        };
+
+        /** Group of triangles sharing a welded vertex with the same texture space orientation.
+        */
+        struct Group
+        {
+            uint32_t vertex;
+            bool orientPreserving;
+            uint32_t triangleOffset;
+            uint32_t triangleCount;
+        };
+
+        /** Scratch buffers for evaluating the tangent spaces of a group.
+        */
+        struct GroupScratch
+        {
+            std::vector<uint32_t> members;
+            std::vector<float3> os;
+            std::vector<float3> ot;
+            std::vector<float> angles;
+            std::vector<uint32_t> subgroupMembers;
+            std::vector<uint32_t> subgroupOffsets;
+            std::vector<float3> subgroupTangents;
+        };
+
+        /** Weld vertices with identical attributes using a concurrent open addressing hash table.
+            Each vertex is mapped to some vertex with the same attributes. Which one is chosen doesn't affect the result.
+            \param[out] welded Welded vertex index for each vertex.
+            \return False if vertices compare equal but differ in the sign of a zero. The reference result then depends on the chosen vertex.
+        */
+        bool weldVertices(fstd::span<const float3> positions, fstd::span<const float3> normals, fstd::span<const float2> texCrds, std::vector<uint32_t>& welded)
+        {
+            const uint32_t vertexCount = (uint32_t)positions.size();
+            size_t tableSize = 1;
+            while (tableSize < size_t(vertexCount) * 2) tableSize <<= 1;
+
+            std::vector<std::atomic<uint32_t>> table(tableSize);
+            NumericRange<size_t> tableRange(0, tableSize);
+            std::for_each(std::execution::par, tableRange.begin(), tableRange.end(), [&](size_t slot) { table[slot].store(kInvalidIndex, std::memory_order_relaxed); });
+
+            welded.resize(vertexCount);
+            std::atomic<bool> isAmbiguous = false;
+            NumericRange<uint32_t> vertexRange(0, vertexCount);
+            std::for_each(std::execution::par, vertexRange.begin(), vertexRange.end(), [&](uint32_t v)
+            {
+                size_t slot = hashVertex(positions[v], normals[v], texCrds[v]) & (tableSize - 1);
+                while (true)
+                {
+                    uint32_t w = table[slot].load(std::memory_order_acquire);
+                    if (w == kInvalidIndex && table[slot].compare_exchange_strong(w, v, std::memory_order_acq_rel))
+                    {
+                        welded[v] = v;
+                        return;
+                    }
+                    if (equal(positions[v], positions[w]) && equal(normals[v], normals[w]) && equal(texCrds[v], texCrds[w]))
+                    {
+                        welded[v] = w;
+                        if (!bitwiseEqual(positions[v], positions[w]) || !bitwiseEqual(normals[v], normals[w]) || !bitwiseEqual(texCrds[v], texCrds[w])) isAmbiguous = true;
+                        return;
+                    }
+                    slot = (slot + 1) & (tableSize - 1);
+                }
+            });
+
+            return !isAmbiguous;
+        }
+
+        uint32_t findCorner(const std::vector<uint32_t>& indices, uint32_t triangle, uint32_t vertex)
+        {
+            for (uint32_t i = 0; i < 3; i++) if (indices[triangle * 3 + i] == vertex) return i;
+            FALCOR_UNREACHABLE();
+            return 0;
+        }
+
+        /** Find adjacent triangles.
+            The reference implementation sorts the edges by their vertices and then by triangle, and pairs up triangles
+            sharing an edge in that order. Here the edges are bucketed by their smaller vertex with a counting sort,
+            which keeps the triangle order, and the buckets are sorted and paired up in parallel.
+        */
+        void findNeighbors(const std::vector<uint32_t>& indices, uint32_t vertexCount, std::vector<TriangleInfo>& infos)
+        {
+            const uint32_t edgeCount = (uint32_t)indices.size();
+            auto getEdgeVertices = [&](uint32_t e)
+            {
+                const uint32_t i0 = indices[e];
+                const uint32_t i1 = indices[e % 3 < 2 ? e + 1 : e - 2];
+                return uint2(std::min(i0, i1), std::max(i0, i1));
+            };
+
+            std::vector<uint32_t> bucketOffsets(vertexCount + 1, 0);
+            for (uint32_t e = 0; e < edgeCount; e++) bucketOffsets[getEdgeVertices(e).x + 1]++;
+            for (uint32_t v = 0; v < vertexCount; v++) bucketOffsets[v + 1] += bucketOffsets[v];
+
+            std::vector<Edge> edges(edgeCount);
+            std::vector<uint32_t> bucketSizes(vertexCount, 0);
+            for (uint32_t e = 0; e < edgeCount; e++)
+            {
+                const uint2 vertices = getEdgeVertices(e);
+                edges[bucketOffsets[vertices.x] + bucketSizes[vertices.x]++] = { vertices.y, e / 3, e % 3 };
+            }
+
+            NumericRange<uint32_t> bucketRange(0, vertexCount);
+            std::for_each(std::execution::par, bucketRange.begin(), bucketRange.end(), [&](uint32_t bucket)
+            {
+                const auto begin = edges.begin() + bucketOffsets[bucket];
+                const auto end = edges.begin() + bucketOffsets[bucket + 1];
+                if (end - begin < 2) return;
+                std::sort(begin, end, [](const Edge& a, const Edge& b) { return a.vertex != b.vertex ? a.vertex < b.vertex : a.triangle < b.triangle; });
+
+                for (auto a = begin; a != end; ++a)
+                {
+                    const uint32_t f = a->triangle;
+                    if (infos[f].neighbors[a->edge] != -1) continue;
+
+                    // Look for an unpaired triangle that has the edge in the opposite direction.
+                    const uint32_t i0 = indices[f * 3 + a->edge];
+                    const uint32_t i1 = indices[f * 3 + (a->edge + 1) % 3];
+                    for (auto b = a + 1; b != end && b->vertex == a->vertex; ++b)
+                    {
+                        const uint32_t t = b->triangle;
+                        if (indices[t * 3 + b->edge] == i1 && indices[t * 3 + (b->edge + 1) % 3] == i0 && infos[t].neighbors[b->edge] == -1)
+                        {
+                            infos[f].neighbors[a->edge] = (int32_t)t;
+                            infos[t].neighbors[b->edge] = (int32_t)f;
+                            break;
+                        }
+                    }
+                }
+            });
+        }
+
+        void checkInput(fstd::span<const float3> positions, fstd::span<const float3> normals, fstd::span<const float2> texCrds)
+        {
+            FALCOR_CHECK(!positions.empty() && positions.size() % 3 == 0, "Vertex count must be a non-zero multiple of three.");
+            FALCOR_CHECK(normals.size() == positions.size() && texCrds.size() == positions.size(), "Attribute counts don't match.");
+            FALCOR_CHECK(positions.size() / 3 < (1u << 29), "Too many triangles.");
+        }
+
+        class MikkTSpaceWrapper
+        {
+        public:
+            MikkTSpaceWrapper(fstd::span<const float3> positions, fstd::span<const float3> normals, fstd::span<const float2> texCrds)
+                : mPositions(positions)
+                , mNormals(normals)
+                , mTexCrds(texCrds)
+                , mTangents(positions.size(), float4(0.f))
+            {}
+
+            std::vector<float4> generateTangents()
+            {
+                SMikkTSpaceInterface mikktspace = {};
+                mikktspace.m_getNumFaces = [](const SMikkTSpaceContext* pContext) { return ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getFaceCount(); };
+                mikktspace.m_getNumVerticesOfFace = [](const SMikkTSpaceContext* pContext, int32_t face) { return 3; };
+                mikktspace.m_getPosition = [](const SMikkTSpaceContext* pContext, float position[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getPosition(position, face, vert); };
+                mikktspace.m_getNormal = [](const SMikkTSpaceContext* pContext, float normal[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getNormal(normal, face, vert); };
+                mikktspace.m_getTexCoord = [](const SMikkTSpaceContext* pContext, float texCrd[], int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->getTexCrd(texCrd, face, vert); };
+                mikktspace.m_setTSpaceBasic = [](const SMikkTSpaceContext* pContext, const float tangent[], float sign, int32_t face, int32_t vert) { ((MikkTSpaceWrapper*)(pContext->m_pUserData))->setTangent(tangent, sign, face, vert); };
+
+                SMikkTSpaceContext context = {};
+                context.m_pInterface = &mikktspace;
+                context.m_pUserData = this;
+
+                if (genTangSpaceDefault(&context) == false)
+                {
+                    FALCOR_THROW("MikkTSpace failed to generate tangents.");
+                }
+
+                return std::move(mTangents);
+            }
+
+        private:
+            int32_t getFaceCount() const { return (int32_t)(mPositions.size() / 3); }
+            void getPosition(float position[], int32_t face, int32_t vert) const { *reinterpret_cast<float3*>(position) = mPositions[face * 3 + vert]; }
+            void getNormal(float normal[], int32_t face, int32_t vert) const { *reinterpret_cast<float3*>(normal) = mNormals[face * 3 + vert]; }
+            void getTexCrd(float texCrd[], int32_t face, int32_t vert) const { *reinterpret_cast<float2*>(texCrd) = mTexCrds[face * 3 + vert]; }
+            void setTangent(const float tangent[], float sign, int32_t face, int32_t vert) { mTangents[face * 3 + vert] = float4(*reinterpret_cast<const float3*>(tangent), sign); }
+
+            fstd::span<const float3> mPositions;
+            fstd::span<const float3> mNormals;
+            fstd::span<const float2> mTexCrds;
+            std::vector<float4> mTangents;
+        };
+    }
+
+    std::vector<float4> TangentSpaceGenerator::generate(fstd::span<const float3> positions, fstd::span<const float3> normals, fstd::span<const float2> texCrds)
+    {
+        checkInput(positions, normals, texCrds);
+
+        // The reference welding doesn't merge identical vertices if positions are non-finite or overflow its bounds computations.
+        auto isOutOfRange = [](const float3& p)
+        {
+            return !(std::fabs(p.x) < kMaxPositionMagnitude && std::fabs(p.y) < kMaxPositionMagnitude && std::fabs(p.z) < kMaxPositionMagnitude);
+        };
+        if (std::any_of(std::execution::par, positions.begin(), positions.end(), isOutOfRange))
+        {
+            return generateReference(positions, normals, texCrds);
+        }
+
+        std::vector<uint32_t> welded;
+        if (!weldVertices(positions, normals, texCrds, welded))
+        {
+            return generateReference(positions, normals, texCrds);
+        }
+
+        const uint32_t vertexCount = (uint32_t)positions.size();
+        const uint32_t triangleCount = vertexCount / 3;
+        NumericRange<uint32_t> triangleRange(0, triangleCount);
+
+        // Separate the degenerate triangles. The order of the remaining triangles is preserved,
+        // as the reference implementation sums contributions in triangle order.
+        std::vector<uint8_t> isDegenerate(triangleCount);
+        std::for_each(std::execution::par, triangleRange.begin(), triangleRange.end(), [&](uint32_t t)
+        {
+            const float3& p0 = positions[t * 3 + 0];
+            const float3& p1 = positions[t * 3 + 1];
+            const float3& p2 = positions[t * 3 + 2];
+            isDegenerate[t] = equal(p0, p1) || equal(p0, p2) || equal(p1, p2);
+        });
+
+        std::vector<uint32_t> triangles;
+        std::vector<uint32_t> degenerateTriangles;
+        for (uint32_t t = 0; t < triangleCount; t++)
+        {
+            (isDegenerate[t] ? degenerateTriangles : triangles).push_back(t);
+        }
+
+        // Welded vertex indices of the non-degenerate triangles.
+        const uint32_t goodCount = (uint32_t)triangles.size();
+        NumericRange<uint32_t> goodRange(0, goodCount);
+        std::vector<uint32_t> indices(goodCount * 3);
+        std::for_each(std::execution::par, goodRange.begin(), goodRange.end(), [&](uint32_t f)
+        {
+            for (uint32_t i = 0; i < 3; i++) indices[f * 3 + i] = welded[triangles[f] * 3 + i];
+        });
+
+        // Evaluate the first order derivatives of each triangle.
+        std::vector<TriangleInfo> infos(goodCount);
+        std::for_each(std::execution::par, goodRange.begin(), goodRange.end(), [&](uint32_t f)
+        {
+            const uint32_t t = triangles[f];
+            const float3& v1 = positions[t * 3 + 0];
+            const float3& v2 = positions[t * 3 + 1];
+            const float3& v3 = positions[t * 3 + 2];
+            const float2& t1 = texCrds[t * 3 + 0];
+            const float2& t2 = texCrds[t * 3 + 1];
+            const float2& t3 = texCrds[t * 3 + 2];
+
+            const float t21x = t2.x - t1.x;
+            const float t21y = t2.y - t1.y;
+            const float t31x = t3.x - t1.x;
+            const float t31y = t3.y - t1.y;
+            const float3 d1 = v2 - v1;
+            const float3 d2 = v3 - v1;
+
+            const float signedAreaSTx2 = t21x * t31y - t21y * t31x;
+            const float3 os = scale(t31y, d1) - scale(t21y, d2);
+            const float3 ot = scale(-t31x, d1) + scale(t21x, d2);
+
+            TriangleInfo& info = infos[f];
+            if (signedAreaSTx2 > 0.f) info.flags |= kOrientPreserving;
+
+            if (notZero(signedAreaSTx2))
+            {
+                const float absArea = std::fabs(signedAreaSTx2);
+                const float lenOs = length3(os);
+                const float lenOt = length3(ot);
+                const float s = (info.flags & kOrientPreserving) == 0 ? -1.f : 1.f;
+                if (notZero(lenOs)) info.os = scale(s / lenOs, os);
+                if (notZero(lenOt)) info.ot = scale(s / lenOt, ot);
+
+                // The triangle is good if the magnitudes prior to normalization are non-zero.
+                if (notZero(lenOs / absArea) && notZero(lenOt / absArea)) info.flags &= ~kGroupWithAny;
+            }
+        });
+
+        findNeighbors(indices, vertexCount, infos);
+
+        // Build groups of triangles sharing a vertex. This is done serially, as the first group reaching a
+        // triangle with a degenerate texture mapping determines its orientation.
+        // Within a group the traversal order doesn't matter, so an explicit stack is used instead of recursion.
+        std::vector<Group> groups;
+        std::vector<uint32_t> groupTriangles;
+        std::vector<uint32_t> assignedGroups(goodCount * 3, kInvalidIndex);
+        std::vector<uint32_t> stack;
+        groupTriangles.reserve(goodCount * 3);
+
+        auto pushNeighbors = [&](uint32_t f, uint32_t corner)
+        {
+            const int32_t left = infos[f].neighbors[corner];
+            const int32_t right = infos[f].neighbors[corner > 0 ? corner - 1 : 2];
+            if (right >= 0) stack.push_back((uint32_t)right);
+            if (left >= 0) stack.push_back((uint32_t)left);
+        };
+
+        for (uint32_t f = 0; f < goodCount; f++)
+        {
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                if ((infos[f].flags & kGroupWithAny) != 0 || assignedGroups[f * 3 + i] != kInvalidIndex) continue;
+
+                const uint32_t groupIndex = (uint32_t)groups.size();
+                Group group = { indices[f * 3 + i], (infos[f].flags & kOrientPreserving) != 0, (uint32_t)groupTriangles.size(), 0 };
+                assignedGroups[f * 3 + i] = groupIndex;
+                groupTriangles.push_back(f);
+                pushNeighbors(f, i);
+
+                while (!stack.empty())
+                {
+                    const uint32_t t = stack.back();
+                    stack.pop_back();
+
+                    const uint32_t corner = findCorner(indices, t, group.vertex);
+                    if (assignedGroups[t * 3 + corner] != kInvalidIndex) continue;
+
+                    TriangleInfo& info = infos[t];
+                    if ((info.flags & kGroupWithAny) != 0 && assignedGroups[t * 3 + 0] == kInvalidIndex &&
+                        assignedGroups[t * 3 + 1] == kInvalidIndex && assignedGroups[t * 3 + 2] == kInvalidIndex)
+                    {
+                        info.flags = (info.flags & ~kOrientPreserving) | (group.orientPreserving ? kOrientPreserving : 0);
+                    }
+                    if (((info.flags & kOrientPreserving) != 0) != group.orientPreserving) continue;
+
+                    assignedGroups[t * 3 + corner] = groupIndex;
+                    groupTriangles.push_back(t);
+                    pushNeighbors(t, corner);
+                }
+
+                group.triangleCount = (uint32_t)groupTriangles.size() - group.triangleOffset;
+                groups.push_back(group);
+            }
+        }
+
+        // Evaluate the tangent spaces of the groups. Each group is split into subgroups of triangles
+        // with similar derivatives and one tangent is computed per unique subgroup.
+        // Vertices that are not part of any group keep the default tangent of the reference implementation.
+        const float thresholdCos = (float)std::cos(double((180.f * (float)kPi) / 180.f));
+        std::vector<float4> tangents(vertexCount, float4(1.f, 0.f, 0.f, -1.f));
+        NumericRange<uint32_t> taskRange(0, div_round_up((uint32_t)groups.size(), kGroupsPerTask));
+        std::for_each(std::execution::par, taskRange.begin(), taskRange.end(), [&](uint32_t task)
+        {
+            GroupScratch scratch;
+            const uint32_t groupEnd = std::min((task + 1) * kGroupsPerTask, (uint32_t)groups.size());
+            for (uint32_t groupIndex = task * kGroupsPerTask; groupIndex < groupEnd; groupIndex++)
+            {
+                const Group& group = groups[groupIndex];
+                auto& members = scratch.members;
+                members.assign(groupTriangles.begin() + group.triangleOffset, groupTriangles.begin() + group.triangleOffset + group.triangleCount);
+                std::sort(members.begin(), members.end());
+
+                // Project the derivatives of all members onto the tangent plane and compute their angle weights.
+                const float3 n = normals[group.vertex];
+                const uint32_t memberCount = (uint32_t)members.size();
+                scratch.os.resize(memberCount);
+                scratch.ot.resize(memberCount);
+                scratch.angles.resize(memberCount);
+                for (uint32_t k = 0; k < memberCount; k++)
+                {
+                    const TriangleInfo& info = infos[members[k]];
+                    scratch.os[k] = projectAndNormalize(n, info.os);
+                    scratch.ot[k] = projectAndNormalize(n, info.ot);
+                    if ((info.flags & kGroupWithAny) != 0) continue;
+
+                    const uint32_t* pIndices = &indices[members[k] * 3];
+                    const uint32_t i = findCorner(indices, members[k], group.vertex);
+                    const float3& p0 = positions[pIndices[i > 0 ? i - 1 : 2]];
+                    const float3& p1 = positions[pIndices[i]];
+                    const float3& p2 = positions[pIndices[i < 2 ? i + 1 : 0]];
+                    const float3 v1 = projectAndNormalize(n, p0 - p1);
+                    const float3 v2 = projectAndNormalize(n, p2 - p1);
+                    const float cosAngle = std::clamp(dot3(v1, v2), -1.f, 1.f);
+                    scratch.angles[k] = (float)std::acos(double(cosAngle));
+                }
+
+                // Subgroup member lists are stored back to back, with the offsets in subgroupOffsets.
+                scratch.subgroupMembers.clear();
+                scratch.subgroupOffsets.assign(1, 0);
+                scratch.subgroupTangents.clear();
+                for (uint32_t k = 0; k < memberCount; k++)
+                {
+                    const uint32_t f = members[k];
+                    const uint32_t begin = (uint32_t)scratch.subgroupMembers.size();
+                    for (uint32_t l = 0; l < memberCount; l++)
+                    {
+                        const bool any = ((infos[f].flags | infos[members[l]].flags) & kGroupWithAny) != 0;
+                        if (any || k == l || (dot3(scratch.os[k], scratch.os[l]) > thresholdCos && dot3(scratch.ot[k], scratch.ot[l]) > thresholdCos))
+                        {
+                            scratch.subgroupMembers.push_back(l);
+                        }
+                    }
+
+                    // Look for an existing identical subgroup.
+                    const auto subgroupBegin = scratch.subgroupMembers.begin() + begin;
+                    const uint32_t subgroupCount = (uint32_t)scratch.subgroupTangents.size();
+                    uint32_t subgroupIndex = 0;
+                    for (; subgroupIndex < subgroupCount; subgroupIndex++)
+                    {
+                        const auto otherBegin = scratch.subgroupMembers.begin() + scratch.subgroupOffsets[subgroupIndex];
+                        const auto otherEnd = scratch.subgroupMembers.begin() + scratch.subgroupOffsets[subgroupIndex + 1];
+                        if (std::equal(subgroupBegin, scratch.subgroupMembers.end(), otherBegin, otherEnd)) break;
+                    }
+
+                    if (subgroupIndex < subgroupCount)
+                    {
+                        scratch.subgroupMembers.resize(begin);
+                    }
+                    else
+                    {
+                        // Sum the angle weighted derivatives in triangle order.
+                        float3 tangent = float3(0.f);
+                        for (auto it = subgroupBegin; it != scratch.subgroupMembers.end(); ++it)
+                        {
+                            if ((infos[members[*it]].flags & kGroupWithAny) == 0) tangent = tangent + scale(scratch.angles[*it], scratch.os[*it]);
+                        }
+                        scratch.subgroupOffsets.push_back((uint32_t)scratch.subgroupMembers.size());
+                        scratch.subgroupTangents.push_back(normalizeIfNotZero(tangent));
+                    }
+
+                    const uint32_t corner = findCorner(indices, f, group.vertex);
+                    tangents[triangles[f] * 3 + corner] = float4(scratch.subgroupTangents[subgroupIndex], group.orientPreserving ? 1.f : -1.f);
+                }
+            }
+        });
+
+        // Degenerate triangles copy the tangent of the first vertex of a good triangle with the same welded vertex.
+        std::vector<uint32_t> firstGoodVertex(vertexCount, kInvalidIndex);
+        for (uint32_t f = 0; f < goodCount; f++)
+        {
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                uint32_t& first = firstGoodVertex[indices[f * 3 + i]];
+                if (first == kInvalidIndex) first = triangles[f] * 3 + i;
+            }
+        }
+
+        NumericRange<uint32_t> degenerateRange(0, (uint32_t)degenerateTriangles.size());
+        std::for_each(std::execution::par, degenerateRange.begin(), degenerateRange.end(), [&](uint32_t d)
+        {
+            const uint32_t t = degenerateTriangles[d];
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                const uint32_t first = firstGoodVertex[welded[t * 3 + i]];
+                if (first != kInvalidIndex) tangents[t * 3 + i] = tangents[first];
+            }
+        });
+
+        return tangents;
+    }
+
+    std::vector<float4> TangentSpaceGenerator::generateReference(fstd::span<const float3> positions, fstd::span<const float3> normals, fstd::span<const float2> texCrds)
+    {
+        checkInput(positions, normals, texCrds);
+        MikkTSpaceWrapper wrapper(positions, normals, texCrds);
+        return wrapper.generateTangents();
+    }
+}
@@ -0,0 +1,71 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <fstd/span.h>
+#include <vector>
+
+namespace Falcor
+{
+    /** Generates tangent spaces for triangle meshes using the MikkTSpace algorithm.
+
+        generate() is a parallel reimplementation whose output is bit-identical to the MikkTSpace
+        reference implementation (generateReference()). Vertex welding uses hashing instead of the
+        reference's spatial partitioning, edge adjacency is found with a parallel sort, and the
+        per-triangle derivatives and per-vertex tangent spaces are evaluated in parallel.
+        Only the assignment of triangles to vertex groups runs serially, as the reference algorithm
+        has an order dependency there.
+
+        Inputs that the parallel path can't reproduce exactly fall back to the reference implementation.
+        These are meshes with non-finite or extremely large positions, which change the reference's
+        welding, and meshes where vertices differ only in the sign of zero components, for which the
+        reference picks an arbitrary representative vertex.
+
+        All attributes are face-varying, i.e., there are three entries per triangle.
+    */
+    class FALCOR_API TangentSpaceGenerator
+    {
+    public:
+        /** Generate tangents.
+            \param[in] positions Face-varying vertex positions.
+            \param[in] normals Face-varying vertex normals.
+            \param[in] texCrds Face-varying texture coordinates.
+            \return Face-varying tangents. The xyz components hold the tangent and w the bitangent sign.
+        */
+        static std::vector<float4> generate(fstd::span<const float3> positions, fstd::span<const float3> normals, fstd::span<const float2> texCrds);
+
+        /** Generate tangents using the MikkTSpace reference implementation.
+            \param[in] positions Face-varying vertex positions.
+            \param[in] normals Face-varying vertex normals.
+            \param[in] texCrds Face-varying texture coordinates.
+            \return Face-varying tangents. The xyz components hold the tangent and w the bitangent sign.
+        */
+        static std::vector<float4> generateReference(fstd::span<const float3> positions, fstd::span<const float3> normals, fstd::span<const float2> texCrds);
+    };
+}
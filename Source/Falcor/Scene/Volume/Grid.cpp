@@ -75,21 +75,37 @@ namespace Falcor
         {
             return int3(c[0], c[1], c[2]);
         }
+
+        /** Get the NanoVDB grid type of a format. This matches the PNANOVDB_GRID_TYPE_* constants used on the GPU.
+        */
+        nanovdb::GridType getGridType(GridFormat format)
+        {
+            switch (format)
+            {
+            case GridFormat::Float: return nanovdb::GridType::Float;
+            case GridFormat::Fp4: return nanovdb::GridType::Fp4;
+            case GridFormat::Fp8: return nanovdb::GridType::Fp8;
+            case GridFormat::Fp16: return nanovdb::GridType::Fp16;
+            case GridFormat::FpN: return nanovdb::GridType::FpN;
+            default: FALCOR_UNREACHABLE();
+            }
+            return nanovdb::GridType::Unknown;
+        }
     }
 
-    ref<Grid> Grid::createSphere(ref<Device> pDevice, float radius, float voxelSize, float blendRange)
+    ref<Grid> Grid::createSphere(ref<Device> pDevice, float radius, float voxelSize, float blendRange, const StorageDesc& storage)
     {
         auto handle = nanovdb::createFogVolumeSphere<float>(radius, nanovdb::Vec3f(0.f), voxelSize, blendRange);
-        return ref<Grid>(new Grid(pDevice, std::move(handle)));
+        return ref<Grid>(new Grid(pDevice, std::move(handle), storage));
     }
 
-    ref<Grid> Grid::createBox(ref<Device> pDevice, float width, float height, float depth, float voxelSize, float blendRange)
+    ref<Grid> Grid::createBox(ref<Device> pDevice, float width, float height, float depth, float voxelSize, float blendRange, const StorageDesc& storage)
     {
         auto handle = nanovdb::createFogVolumeBox<float>(width, height, depth, nanovdb::Vec3f(0.f), voxelSize, blendRange);
-        return ref<Grid>(new Grid(pDevice, std::move(handle)));
+        return ref<Grid>(new Grid(pDevice, std::move(handle), storage));
     }
 
-    ref<Grid> Grid::createFromFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname)
+    ref<Grid> Grid::createFromFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname, const StorageDesc& storage)
     {
         if (!std::filesystem::exists(path))
         {
@@ -99,11 +115,11 @@ namespace Falcor
 
         if (hasExtension(path, "nvdb"))
         {
-            return createFromNanoVDBFile(pDevice, path, gridname);
+            return createFromNanoVDBFile(pDevice, path, gridname, storage);
         }
         else if (hasExtension(path, "vdb"))
         {
-            return createFromOpenVDBFile(pDevice, path, gridname);
+            return createFromOpenVDBFile(pDevice, path, gridname, storage);
         }
         else
         {
@@ -120,13 +136,25 @@ namespace Falcor
             << "Maximum index: " << to_string(getMaxIndex()) << std::endl
             << "Minimum value: " << getMinValue() << std::endl
             << "Maximum value: " << getMaxValue() << std::endl
-            << "Memory: " << formatByteSize(getGridSizeInBytes()) << std::endl;
+            << "Residency: " << enumToString(mStorageDesc.residency) << std::endl;
+        if (hasNanoVDB())
+        {
+            oss << "Format: " << enumToString(mFormat) << std::endl;
+            if (mFormat != GridFormat::Float)
+            {
+                oss << "Max error: " << mQuantizationError.maxAbsError << std::endl
+                    << "RMS error: " << mQuantizationError.rmsError << std::endl;
+            }
+        }
+        oss << "Memory: " << formatByteSize(getGridSizeInBytes()) << std::endl;
         widget.text(oss.str());
     }
 
     void Grid::bindShaderData(const ShaderVar& var)
     {
         var["buf"] = mpBuffer;
+        var["gridType"] = (uint32_t)getGridType(mFormat);
+        var["residency"] = (uint32_t)mStorageDesc.residency;
         var["rangeTex"] = mBrickedGrid.range;
         var["indirectionTex"] = mBrickedGrid.indirection;
         var["atlasTex"] = mBrickedGrid.atlas;
@@ -202,8 +230,9 @@ namespace Falcor
         return math::translate(float4x4(invAffine), -translation);
     }
 
-    Grid::Grid(ref<Device> pDevice, nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle)
+    Grid::Grid(ref<Device> pDevice, nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle, const StorageDesc& storage)
         : mpDevice(pDevice)
+        , mStorageDesc(storage)
         , mGridHandle(std::move(gridHandle))
         , mpFloatGrid(mGridHandle.grid<float>())
         , mAccessor(mpFloatGrid->getAccessor())
@@ -213,19 +242,54 @@ namespace Falcor
             nanovdb::gridStats(*mpFloatGrid);
         }
 
-        // Keep both NanoVDB and brick textures resident in GPU memory for simplicity for now (~15% increased footprint).
-        mpBuffer = mpDevice->createStructuredBuffer(
-            sizeof(uint32_t),
-            uint32_t(div_round_up(mGridHandle.size(), sizeof(uint32_t))),
-            ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource,
-            MemoryType::DeviceLocal,
-            mGridHandle.data()
-        );
-        using NanoVDBGridConverter = NanoVDBConverterBC4;
-        mBrickedGrid = NanoVDBGridConverter(mpFloatGrid).convert(mpDevice);
+        // The float grid is kept on the host for value queries and brick conversion.
+        // Only the representations selected by the residency are uploaded to GPU memory.
+        if (hasNanoVDB())
+        {
+            nanovdb::GridHandle<nanovdb::HostBuffer> quantizedHandle;
+            if (mStorageDesc.format != GridFormat::Float)
+            {
+                auto result = GridQuantizer::quantize(*mpFloatGrid, mStorageDesc.format, mStorageDesc.tolerance);
+                mFormat = result.format;
+                mQuantizationError = result.error;
+                if (mFormat != GridFormat::Float) quantizedHandle = std::move(result.handle);
+            }
+
+            // The quantized host copy is released after the upload.
+            const auto& uploadHandle = quantizedHandle ? quantizedHandle : mGridHandle;
+            mpBuffer = mpDevice->createStructuredBuffer(
+                sizeof(uint32_t),
+                uint32_t(div_round_up(uploadHandle.size(), sizeof(uint32_t))),
+                ResourceBindFlags::UnorderedAccess | ResourceBindFlags::ShaderResource,
+                MemoryType::DeviceLocal,
+                uploadHandle.data()
+            );
+        }
+
+        else
+        {
+            // Keep the grid header, tree header and root node resident so that the transforms and grid statistics remain
+            // available on the GPU. The root node is stored directly after the grid and tree headers.
+            const auto& root = mpFloatGrid->tree().root();
+            const size_t headerSize = size_t(reinterpret_cast<const uint8_t*>(&root) - reinterpret_cast<const uint8_t*>(mpFloatGrid)) + root.memUsage();
+            FALCOR_ASSERT(headerSize <= mGridHandle.size());
+            mpBuffer = mpDevice->createStructuredBuffer(
+                sizeof(uint32_t),
+                uint32_t(div_round_up(headerSize, sizeof(uint32_t))),
+                ResourceBindFlags::ShaderResource,
+                MemoryType::DeviceLocal,
+                mGridHandle.data()
+            );
+        }
+
+        if (hasBricks())
+        {
+            using NanoVDBGridConverter = NanoVDBConverterBC4;
+            mBrickedGrid = NanoVDBGridConverter(mpFloatGrid).convert(mpDevice);
+        }
     }
 
-    ref<Grid> Grid::createFromNanoVDBFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname)
+    ref<Grid> Grid::createFromNanoVDBFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname, const StorageDesc& storage)
     {
         if (!nanovdb::io::hasGrid(path.string(), gridname))
         {
@@ -253,10 +317,10 @@ namespace Falcor
             return nullptr;
         }
 
-        return ref<Grid>(new Grid(pDevice, std::move(handle)));
+        return ref<Grid>(new Grid(pDevice, std::move(handle), storage));
     }
 
-    ref<Grid> Grid::createFromOpenVDBFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname)
+    ref<Grid> Grid::createFromOpenVDBFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname, const StorageDesc& storage)
     {
         openvdb::initialize();
 
@@ -296,7 +360,7 @@ namespace Falcor
         openvdb::FloatGrid::Ptr floatGrid = openvdb::gridPtrCast<openvdb::FloatGrid>(baseGrid);
         auto handle = nanovdb::openToNanoVDB(floatGrid);
 
-        return ref<Grid>(new Grid(pDevice, std::move(handle)));
+        return ref<Grid>(new Grid(pDevice, std::move(handle), storage));
     }
 
 
@@ -304,12 +368,28 @@ namespace Falcor
     {
         using namespace pybind11::literals;
 
+        pybind11::enum_<GridFormat> gridFormat(m, "GridFormat");
+        gridFormat.value("Float", GridFormat::Float);
+        gridFormat.value("Fp4", GridFormat::Fp4);
+        gridFormat.value("Fp8", GridFormat::Fp8);
+        gridFormat.value("Fp16", GridFormat::Fp16);
+        gridFormat.value("FpN", GridFormat::FpN);
+
         pybind11::class_<Grid, ref<Grid>> grid(m, "Grid");
+
+        pybind11::enum_<Grid::Residency> residency(grid, "Residency");
+        residency.value("NanoVDBAndBricks", Grid::Residency::NanoVDBAndBricks);
+        residency.value("NanoVDB", Grid::Residency::NanoVDB);
+        residency.value("Bricks", Grid::Residency::Bricks);
+
         grid.def_property_readonly("voxelCount", &Grid::getVoxelCount);
         grid.def_property_readonly("minIndex", &Grid::getMinIndex);
         grid.def_property_readonly("maxIndex", &Grid::getMaxIndex);
         grid.def_property_readonly("minValue", &Grid::getMinValue);
         grid.def_property_readonly("maxValue", &Grid::getMaxValue);
+        grid.def_property_readonly("format", &Grid::getFormat);
+        grid.def_property_readonly("residency", [](const Grid& self) { return self.getStorageDesc().residency; });
+        grid.def_property_readonly("maxQuantizationError", [](const Grid& self) { return self.getQuantizationError().maxAbsError; });
 
         grid.def("getValue", &Grid::getValue, "ijk"_a);
 
@@ -325,10 +405,12 @@ namespace Falcor
         };
         grid.def_static("createBox", createBox, "width"_a, "height"_a, "depth"_a, "voxelSize"_a, "blendRange"_a = 3.f); // PYTHONDEPRECATED
 
-        auto createFromFile = [] (const std::filesystem::path& path, const std::string& gridname)
+        auto createFromFile = [] (const std::filesystem::path& path, const std::string& gridname, GridFormat format, float tolerance, Grid::Residency residency)
         {
-            return Grid::createFromFile(accessActivePythonSceneBuilder().getDevice(), getActiveAssetResolver().resolvePath(path), gridname);
+            Grid::StorageDesc storage{ format, tolerance, residency };
+            return Grid::createFromFile(accessActivePythonSceneBuilder().getDevice(), getActiveAssetResolver().resolvePath(path), gridname, storage);
         };
-        grid.def_static("createFromFile", createFromFile, "path"_a, "gridname"_a); // PYTHONDEPRECATED
+        grid.def_static("createFromFile", createFromFile, "path"_a, "gridname"_a,
+            "format"_a = GridFormat::Float, "tolerance"_a = 0.f, "residency"_a = Grid::Residency::NanoVDBAndBricks); // PYTHONDEPRECATED
     }
 }
@@ -28,6 +28,7 @@
 #pragma once
 
 #include "BrickedGrid.h"
+#include "GridQuantizer.h"
 #include "Core/Macros.h"
 #include "Core/Object.h"
 #include "Core/API/Buffer.h"
@@ -60,14 +61,42 @@ namespace Falcor
     {
         FALCOR_OBJECT(Grid)
     public:
+        /** Grid representations kept resident in GPU memory.
+        */
+        enum class Residency : uint32_t
+        {
+            NanoVDBAndBricks,   ///< Keep both the NanoVDB buffer and the bricked textures resident.
+            NanoVDB,            ///< Keep only the NanoVDB buffer resident (no local majorants).
+            Bricks,             ///< Keep only the bricked textures and the NanoVDB grid header resident (the NanoVDB lookup and DDA functions are not available).
+        };
+
+        FALCOR_ENUM_INFO(Residency, {
+            { Residency::NanoVDBAndBricks, "NanoVDBAndBricks" },
+            { Residency::NanoVDB, "NanoVDB" },
+            { Residency::Bricks, "Bricks" },
+        });
+
+        /** Describes how a grid is stored in GPU memory.
+        */
+        struct StorageDesc
+        {
+            GridFormat format = GridFormat::Float;  ///< Voxel format of the GPU NanoVDB buffer.
+            float tolerance = 0.f;                  ///< Absolute error tolerance of the quantized format (see GridQuantizer).
+            Residency residency = Residency::NanoVDBAndBricks; ///< Representations kept resident in GPU memory.
+
+            bool operator==(const StorageDesc& other) const { return format == other.format && tolerance == other.tolerance && residency == other.residency; }
+            bool operator!=(const StorageDesc& other) const { return !(*this == other); }
+        };
+
         /** Create a sphere voxel grid.
             \param[in] pDevice GPU device.
             \param[in] radius Radius of the sphere in world units.
             \param[in] voxelSize Size of a voxel in world units.
             \param[in] blendRange Range in voxels to blend from 0 to 1 (starting at surface inwards).
+            \param[in] storage Storage options for the GPU representation.
             \return A new grid.
         */
-        static ref<Grid> createSphere(ref<Device> pDevice, float radius, float voxelSize, float blendRange = 2.f);
+        static ref<Grid> createSphere(ref<Device> pDevice, float radius, float voxelSize, float blendRange = 2.f, const StorageDesc& storage = {});
 
         /** Create a box voxel grid.
             \param[in] pDevice GPU device.
@@ -76,18 +105,20 @@ namespace Falcor
             \param[in] depth Depth of the box in world units.
             \param[in] voxelSize Size of a voxel in world units.
             \param[in] blendRange Range in voxels to blend from 0 to 1 (starting at surface inwards).
+            \param[in] storage Storage options for the GPU representation.
             \return A new grid.
         */
-        static ref<Grid> createBox(ref<Device> pDevice, float width, float height, float depth, float voxelSize, float blendRange = 2.f);
+        static ref<Grid> createBox(ref<Device> pDevice, float width, float height, float depth, float voxelSize, float blendRange = 2.f, const StorageDesc& storage = {});
 
         /** Create a grid from a file.
             Currently only OpenVDB and NanoVDB grids of type float are supported.
             \param[in] pDevice GPU device.
             \param[in] path File path of the grid (absolute or relative to working directory).
             \param[in] gridname Name of the grid to load.
+            \param[in] storage Storage options for the GPU representation.
             \return A new grid, or nullptr if the grid failed to load.
         */
-        static ref<Grid> createFromFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname);
+        static ref<Grid> createFromFile(ref<Device> pDevice, const std::filesystem::path& path, const std::string& gridname, const StorageDesc& storage = {});
 
         /** Render the UI.
         */
@@ -122,6 +153,19 @@ namespace Falcor
         */
         uint64_t getGridSizeInBytes() const;
 
+        /** Get the storage options of the grid.
+        */
+        const StorageDesc& getStorageDesc() const { return mStorageDesc; }
+
+        /** Get the voxel format of the GPU NanoVDB buffer.
+            This may be wider than the requested format if the error tolerance could not be met.
+        */
+        GridFormat getFormat() const { return mFormat; }
+
+        /** Get the error of the GPU NanoVDB buffer against the float grid.
+        */
+        const GridQuantizationError& getQuantizationError() const { return mQuantizationError; }
+
         /** Get the grid's bounds in world space.
         */
         AABB getWorldBounds() const;
@@ -133,6 +177,7 @@ namespace Falcor
         float getValue(const int3& ijk) const;
 
         /** Get the raw NanoVDB grid handle.
+            This is always the float grid, see getFormat() for the format used in GPU memory.
         */
         const nanovdb::GridHandle<nanovdb::HostBuffer>& getGridHandle() const;
 
@@ -144,22 +189,36 @@ namespace Falcor
         */
         float4x4 getInvTransform() const;
 
+        /** Check if the full NanoVDB tree is resident in GPU memory.
+            The grid header with the transforms and statistics is always resident.
+        */
+        bool hasNanoVDB() const { return mStorageDesc.residency != Residency::Bricks; }
+
+        /** Check if the bricked textures are resident in GPU memory.
+        */
+        bool hasBricks() const { return mStorageDesc.residency != Residency::NanoVDB; }
+
     private:
-        Grid(ref<Device> pDevice, nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle);
+        Grid(ref<Device> pDevice, nanovdb::GridHandle<nanovdb::HostBuffer> gridHandle, const StorageDesc& storage);
 
-        static ref<Grid> createFromNanoVDBFile(ref<Device>, const std::filesystem::path& path, const std::string& gridname);
-        static ref<Grid> createFromOpenVDBFile(ref<Device>, const std::filesystem::path& path, const std::string& gridname);
+        static ref<Grid> createFromNanoVDBFile(ref<Device>, const std::filesystem::path& path, const std::string& gridname, const StorageDesc& storage);
+        static ref<Grid> createFromOpenVDBFile(ref<Device>, const std::filesystem::path& path, const std::string& gridname, const StorageDesc& storage);
 
         ref<Device> mpDevice;
+        StorageDesc mStorageDesc;
 
         // Host data.
         nanovdb::GridHandle<nanovdb::HostBuffer> mGridHandle;
         nanovdb::FloatGrid* mpFloatGrid;
         nanovdb::FloatGrid::AccessorType mAccessor;
+        GridFormat mFormat = GridFormat::Float;
+        GridQuantizationError mQuantizationError;
         // Device data.
         ref<Buffer> mpBuffer;
         BrickedGrid mBrickedGrid;
 
         friend class SceneCache;
     };
+
+    FALCOR_ENUM_REGISTER(Grid::Residency);
 }
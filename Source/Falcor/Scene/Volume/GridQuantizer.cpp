@@ -0,0 +1,298 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GridQuantizer.h"
+#include "Core/Error.h"
+#include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/Timing/CpuTimer.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4146 4244 4267 4275 4996 4456)
+#endif
+// TODO: GridBuilder.h uses the std::result_of type trait which is deprecated in C++17 and
+// removed in C++20. This is an ugly workaround to use C++20's invoke_result type trait.
+// This really should be fixed in nanovdb instead!
+#define result_of invoke_result
+#include <nanovdb/util/GridBuilder.h>
+#undef result_of
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+    namespace
+    {
+        using FloatLeaf = nanovdb::NanoLeaf<float>;
+        using FloatLower = nanovdb::NanoLower<float>;
+
+        struct LeafError
+        {
+            float minValue = std::numeric_limits<float>::max();
+            float maxValue = std::numeric_limits<float>::lowest();
+            float maxAbsError = 0.f;
+            double sumSqrError = 0.0;
+            uint64_t voxelCount = 0;
+        };
+
+        /** Compute the value range over all active leaf voxels.
+        */
+        float computeValueRange(const nanovdb::FloatGrid& grid)
+        {
+            const auto& tree = grid.tree();
+            const FloatLeaf* pLeaves = tree.getFirstNode<0>();
+            std::vector<float2> ranges(tree.nodeCount(0), float2(std::numeric_limits<float>::max(), std::numeric_limits<float>::lowest()));
+
+            auto range = NumericRange<uint32_t>(0, tree.nodeCount(0));
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t leafIndex)
+            {
+                const FloatLeaf& leaf = pLeaves[leafIndex];
+                for (uint32_t n = 0; n < FloatLeaf::SIZE; ++n)
+                {
+                    if (!leaf.isActive(n)) continue;
+                    float value = leaf.getValue(n);
+                    ranges[leafIndex].x = std::min(ranges[leafIndex].x, value);
+                    ranges[leafIndex].y = std::max(ranges[leafIndex].y, value);
+                }
+            });
+
+            float minValue = std::numeric_limits<float>::max(), maxValue = std::numeric_limits<float>::lowest();
+            for (const auto& r : ranges)
+            {
+                minValue = std::min(minValue, r.x);
+                maxValue = std::max(maxValue, r.y);
+            }
+            return maxValue > minValue ? maxValue - minValue : 0.f;
+        }
+
+        template<typename BuildT>
+        GridQuantizer::GridHandle buildGrid(const nanovdb::FloatGrid& grid, float tolerance)
+        {
+            const auto& tree = grid.tree();
+            nanovdb::GridBuilder<float, BuildT> builder(tree.background(), grid.gridClass());
+            auto acc = builder.getAccessor();
+
+            // Copy active leaf voxels.
+            const FloatLeaf* pLeaves = tree.getFirstNode<0>();
+            for (uint32_t leafIndex = 0; leafIndex < tree.nodeCount(0); ++leafIndex)
+            {
+                const FloatLeaf& leaf = pLeaves[leafIndex];
+                for (uint32_t n = 0; n < FloatLeaf::SIZE; ++n)
+                {
+                    if (leaf.isActive(n)) acc.setValue(leaf.offsetToGlobalCoord(n), leaf.getValue(n));
+                }
+            }
+
+            // Expand active tiles of the lower internal nodes into voxels.
+            // These leaves are constant and therefore quantize without error.
+            const FloatLower* pLowers = tree.getFirstNode<1>();
+            for (uint32_t nodeIndex = 0; nodeIndex < tree.nodeCount(1); ++nodeIndex)
+            {
+                const FloatLower& node = pLowers[nodeIndex];
+                for (uint32_t n = 0; n < FloatLower::SIZE; ++n)
+                {
+                    if (node.childMask().isOn(n) || !node.valueMask().isOn(n)) continue;
+                    const nanovdb::Coord origin = node.offsetToGlobalCoord(n);
+                    const float value = node.getValue(origin);
+                    const int32_t dim = FloatLower::ChildNodeType::DIM;
+                    for (int32_t z = 0; z < dim; ++z)
+                        for (int32_t y = 0; y < dim; ++y)
+                            for (int32_t x = 0; x < dim; ++x)
+                                acc.setValue(origin + nanovdb::Coord(x, y, z), value);
+                }
+            }
+
+            auto handle = builder.getHandle(grid.map(), grid.gridName(), nanovdb::AbsDiff(tolerance));
+
+            const auto* pGrid = handle.template grid<BuildT>();
+            FALCOR_CHECK(pGrid != nullptr, "Failed to convert grid '{}'.", grid.gridName());
+            if (pGrid->activeVoxelCount() != grid.activeVoxelCount())
+            {
+                logWarning("Grid '{}' has active tiles above the lower internal nodes, these are not preserved by the conversion ({} of {} active voxels).",
+                    grid.gridName(), pGrid->activeVoxelCount(), grid.activeVoxelCount());
+            }
+
+            return handle;
+        }
+
+        GridQuantizer::GridHandle buildGrid(const nanovdb::FloatGrid& grid, GridFormat format, float tolerance)
+        {
+            switch (format)
+            {
+            case GridFormat::Float: return buildGrid<float>(grid, tolerance);
+            case GridFormat::Fp4: return buildGrid<nanovdb::Fp4>(grid, tolerance);
+            case GridFormat::Fp8: return buildGrid<nanovdb::Fp8>(grid, tolerance);
+            case GridFormat::Fp16: return buildGrid<nanovdb::Fp16>(grid, tolerance);
+            case GridFormat::FpN: return buildGrid<nanovdb::FpN>(grid, tolerance);
+            default: FALCOR_UNREACHABLE();
+            }
+            return {};
+        }
+
+        template<typename BuildT>
+        GridQuantizationError computeErrorT(const nanovdb::FloatGrid& reference, const nanovdb::NanoGrid<BuildT>& grid)
+        {
+            const auto& tree = reference.tree();
+            const FloatLeaf* pLeaves = tree.getFirstNode<0>();
+            std::vector<LeafError> leafErrors(tree.nodeCount(0));
+
+            auto range = NumericRange<uint32_t>(0, tree.nodeCount(0));
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t leafIndex)
+            {
+                const FloatLeaf& leaf = pLeaves[leafIndex];
+                auto acc = grid.getAccessor();
+                LeafError& e = leafErrors[leafIndex];
+                for (uint32_t n = 0; n < FloatLeaf::SIZE; ++n)
+                {
+                    if (!leaf.isActive(n)) continue;
+                    const float value = leaf.getValue(n);
+                    const float error = std::abs(float(acc.getValue(leaf.offsetToGlobalCoord(n))) - value);
+                    e.minValue = std::min(e.minValue, value);
+                    e.maxValue = std::max(e.maxValue, value);
+                    e.maxAbsError = std::max(e.maxAbsError, error);
+                    e.sumSqrError += double(error) * error;
+                    e.voxelCount++;
+                }
+            });
+
+            LeafError total;
+            for (const auto& e : leafErrors)
+            {
+                total.minValue = std::min(total.minValue, e.minValue);
+                total.maxValue = std::max(total.maxValue, e.maxValue);
+                total.maxAbsError = std::max(total.maxAbsError, e.maxAbsError);
+                total.sumSqrError += e.sumSqrError;
+                total.voxelCount += e.voxelCount;
+            }
+
+            GridQuantizationError error;
+            error.voxelCount = total.voxelCount;
+            error.maxAbsError = total.maxAbsError;
+            error.rmsError = total.voxelCount > 0 ? (float)std::sqrt(total.sumSqrError / total.voxelCount) : 0.f;
+            error.valueRange = total.voxelCount > 0 ? total.maxValue - total.minValue : 0.f;
+            return error;
+        }
+
+        GridFormat getWiderFormat(GridFormat format)
+        {
+            switch (format)
+            {
+            case GridFormat::Fp4: return GridFormat::Fp8;
+            case GridFormat::Fp8: return GridFormat::Fp16;
+            default: return GridFormat::Float;
+            }
+        }
+    }
+
+    GridQuantizer::Result GridQuantizer::quantize(const nanovdb::FloatGrid& grid, GridFormat format, float tolerance)
+    {
+        auto t0 = CpuTimer::getCurrentTimePoint();
+
+        // FpN requires a positive tolerance to choose the per-leaf bit-width.
+        float oracleTolerance = tolerance;
+        if (format == GridFormat::FpN && tolerance <= 0.f)
+        {
+            oracleTolerance = 1e-3f * computeValueRange(grid);
+            if (oracleTolerance <= 0.f) oracleTolerance = std::numeric_limits<float>::min();
+        }
+
+        Result result;
+        result.format = format;
+        while (true)
+        {
+            result.handle = buildGrid(grid, result.format, oracleTolerance);
+            result.error = computeError(grid, result.handle);
+
+            // Widen fixed-width formats until the error is within tolerance.
+            bool widen = tolerance > 0.f && result.error.maxAbsError > tolerance &&
+                result.format != GridFormat::Float && result.format != GridFormat::FpN;
+            if (!widen) break;
+
+            GridFormat widerFormat = getWiderFormat(result.format);
+            logInfo("Grid '{}' exceeds error tolerance {} in format '{}' (max error {}), using '{}' instead.",
+                grid.gridName(), tolerance, result.format, result.error.maxAbsError, widerFormat);
+            result.format = widerFormat;
+        }
+
+        double dt = CpuTimer::calcDuration(t0, CpuTimer::getCurrentTimePoint());
+        logDebug("Converted grid '{}' to '{}' in {:.4}ms: {} -> {} bytes, max error {}, rms error {}.",
+            grid.gridName(), result.format, dt, grid.gridSize(), result.handle.size(), result.error.maxAbsError, result.error.rmsError);
+
+        return result;
+    }
+
+    GridQuantizationError GridQuantizer::computeError(const nanovdb::FloatGrid& reference, const GridHandle& handle)
+    {
+        switch (getFormat(handle))
+        {
+        case GridFormat::Float: return computeErrorT(reference, *handle.grid<float>());
+        case GridFormat::Fp4: return computeErrorT(reference, *handle.grid<nanovdb::Fp4>());
+        case GridFormat::Fp8: return computeErrorT(reference, *handle.grid<nanovdb::Fp8>());
+        case GridFormat::Fp16: return computeErrorT(reference, *handle.grid<nanovdb::Fp16>());
+        case GridFormat::FpN: return computeErrorT(reference, *handle.grid<nanovdb::FpN>());
+        default: FALCOR_UNREACHABLE();
+        }
+        return {};
+    }
+
+    GridFormat GridQuantizer::getFormat(const GridHandle& handle)
+    {
+        FALCOR_CHECK(handle.gridMetaData() != nullptr, "Grid handle is empty.");
+        switch (handle.gridMetaData()->gridType())
+        {
+        case nanovdb::GridType::Float: return GridFormat::Float;
+        case nanovdb::GridType::Fp4: return GridFormat::Fp4;
+        case nanovdb::GridType::Fp8: return GridFormat::Fp8;
+        case nanovdb::GridType::Fp16: return GridFormat::Fp16;
+        case nanovdb::GridType::FpN: return GridFormat::FpN;
+        default: FALCOR_THROW("Unsupported grid type '{}'.", nanovdb::toStr(handle.gridMetaData()->gridType()));
+        }
+    }
+
+    uint32_t GridQuantizer::getBitsPerVoxel(GridFormat format)
+    {
+        switch (format)
+        {
+        case GridFormat::Float: return 32;
+        case GridFormat::Fp4: return 4;
+        case GridFormat::Fp8: return 8;
+        case GridFormat::Fp16: return 16;
+        case GridFormat::FpN: return 0;
+        default: FALCOR_UNREACHABLE();
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,127 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Enum.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4244 4267)
+#endif
+#include <nanovdb/NanoVDB.h>
+#include <nanovdb/util/GridHandle.h>
+#include <nanovdb/util/HostBuffer.h>
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+#include <cstdint>
+
+namespace Falcor
+{
+    /** Voxel storage format of a NanoVDB grid.
+        The quantized formats store leaf values relative to the per-leaf value range,
+        internal tiles and statistics remain 32-bit float.
+    */
+    enum class GridFormat : uint32_t
+    {
+        Float,  ///< 32-bit float voxels (no quantization).
+        Fp4,    ///< 4-bit quantized voxels.
+        Fp8,    ///< 8-bit quantized voxels.
+        Fp16,   ///< 16-bit quantized voxels.
+        FpN,    ///< Variable bit-width quantized voxels, chosen per leaf to satisfy an absolute error tolerance.
+    };
+
+    FALCOR_ENUM_INFO(GridFormat, {
+        { GridFormat::Float, "Float" },
+        { GridFormat::Fp4, "Fp4" },
+        { GridFormat::Fp8, "Fp8" },
+        { GridFormat::Fp16, "Fp16" },
+        { GridFormat::FpN, "FpN" },
+    });
+    FALCOR_ENUM_REGISTER(GridFormat);
+
+    /** Error of a quantized grid measured against its float source.
+    */
+    struct GridQuantizationError
+    {
+        uint64_t voxelCount = 0;    ///< Number of compared voxels (active leaf voxels of the source).
+        float maxAbsError = 0.f;    ///< Maximum absolute error.
+        float rmsError = 0.f;       ///< Root mean square error.
+        float valueRange = 0.f;     ///< Value range (max - min) of the source grid.
+
+        /** Get the maximum error relative to the value range of the source grid.
+        */
+        float getMaxRelativeError() const { return valueRange > 0.f ? maxAbsError / valueRange : 0.f; }
+    };
+
+    /** Converts float NanoVDB grids to the quantized NanoVDB formats (Fp4/Fp8/Fp16/FpN) on the CPU.
+
+        The conversion is error-bounded: given an absolute tolerance, FpN chooses the bit-width per leaf
+        to satisfy it, while the fixed-width formats are widened (Fp4 -> Fp8 -> Fp16 -> Float) until the
+        measured error is within the tolerance.
+    */
+    class FALCOR_API GridQuantizer
+    {
+    public:
+        using GridHandle = nanovdb::GridHandle<nanovdb::HostBuffer>;
+
+        struct Result
+        {
+            GridHandle handle;              ///< Converted grid.
+            GridFormat format = GridFormat::Float; ///< Format of the converted grid (may be wider than requested).
+            GridQuantizationError error;    ///< Error of the converted grid against the source.
+        };
+
+        /** Convert a float grid to the given format.
+            \param[in] grid Source float grid.
+            \param[in] format Requested format.
+            \param[in] tolerance Absolute error tolerance. Zero or negative disables widening of the fixed-width formats.
+                       For FpN a non-positive tolerance selects 0.1% of the grid's value range.
+            \return The converted grid along with its actual format and error.
+        */
+        static Result quantize(const nanovdb::FloatGrid& grid, GridFormat format, float tolerance = 0.f);
+
+        /** Measure the error of a converted grid against its float source.
+            The error is evaluated over all active leaf voxels of the source grid.
+            \param[in] reference Source float grid.
+            \param[in] handle Converted grid in any of the supported formats.
+            \return The measured error.
+        */
+        static GridQuantizationError computeError(const nanovdb::FloatGrid& reference, const GridHandle& handle);
+
+        /** Get the format of a grid handle.
+            Throws if the grid is not of one of the supported formats.
+        */
+        static GridFormat getFormat(const GridHandle& handle);
+
+        /** Get the number of bits per voxel of a format (0 for the variable width FpN format).
+        */
+        static uint32_t getBitsPerVoxel(GridFormat format);
+    };
+}
@@ -118,33 +118,33 @@ namespace Falcor
         return changed;
     }
 
-    bool GridVolume::loadGrid(GridSlot slot, const std::filesystem::path& path, const std::string& gridname)
+    bool GridVolume::loadGrid(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, const Grid::StorageDesc& storage)
     {
-        auto grid = Grid::createFromFile(mpDevice, path, gridname);
+        auto grid = Grid::createFromFile(mpDevice, path, gridname, storage);
         if (grid) setGrid(slot, grid);
         return grid != nullptr;
     }
 
-    GridVolume::GridSequence GridVolume::createGridSequence(ref<Device> pDevice, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty)
+    GridVolume::GridSequence GridVolume::createGridSequence(ref<Device> pDevice, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty, const Grid::StorageDesc& storage)
     {
         GridSequence grids;
         for (const auto& path : paths)
         {
-            auto grid = Grid::createFromFile(pDevice, path, gridname);
+            auto grid = Grid::createFromFile(pDevice, path, gridname, storage);
             if (keepEmpty || grid) grids.push_back(grid);
         }
 
         return grids;
     }
 
-    uint32_t GridVolume::loadGridSequence(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty)
+    uint32_t GridVolume::loadGridSequence(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty, const Grid::StorageDesc& storage)
     {
-        GridVolume::GridSequence grids = GridVolume::createGridSequence(mpDevice, paths, gridname, keepEmpty);
+        GridVolume::GridSequence grids = GridVolume::createGridSequence(mpDevice, paths, gridname, keepEmpty, storage);
         setGridSequence(slot, grids);
         return (uint32_t)grids.size();
     }
 
-    uint32_t GridVolume::loadGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty)
+    uint32_t GridVolume::loadGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty, const Grid::StorageDesc& storage)
     {
         if (!std::filesystem::exists(path))
         {
@@ -172,7 +172,7 @@ namespace Falcor
         };
         std::sort(paths.begin(), paths.end(), cmp);
 
-        return loadGridSequence(slot, paths, gridname, keepEmpty);
+        return loadGridSequence(slot, paths, gridname, keepEmpty, storage);
     }
 
     void GridVolume::setGridSequence(GridSlot slot, const GridSequence& grids)
@@ -402,24 +402,24 @@ namespace Falcor
         };
         volume.def(pybind11::init(create), "name"_a); // PYTHONDEPRECATED
         volume.def("loadGrid",
-            [](GridVolume& self, GridVolume::GridSlot slot, const std::filesystem::path& path, const std::string& gridname)
-            { return self.loadGrid(slot, getActiveAssetResolver().resolvePath(path), gridname); },
-            "slot"_a, "path"_a, "gridname"_a
+            [](GridVolume& self, GridVolume::GridSlot slot, const std::filesystem::path& path, const std::string& gridname, GridFormat format, float tolerance, Grid::Residency residency)
+            { return self.loadGrid(slot, getActiveAssetResolver().resolvePath(path), gridname, Grid::StorageDesc{ format, tolerance, residency }); },
+            "slot"_a, "path"_a, "gridname"_a, "format"_a = GridFormat::Float, "tolerance"_a = 0.f, "residency"_a = Grid::Residency::NanoVDBAndBricks
         ); // PYTHONDEPRECATED
         volume.def("loadGridSequence",
-            [](GridVolume& self, GridVolume::GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty)
+            [](GridVolume& self, GridVolume::GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty, GridFormat format, float tolerance, Grid::Residency residency)
             {
                 std::vector<std::filesystem::path> resolvedPaths;
                 for (const auto& path : paths)
                     resolvedPaths.push_back(getActiveAssetResolver().resolvePath(path));
-                return self.loadGridSequence(slot, resolvedPaths, gridname, keepEmpty);
+                return self.loadGridSequence(slot, resolvedPaths, gridname, keepEmpty, Grid::StorageDesc{ format, tolerance, residency });
             },
-            "slot"_a, "paths"_a, "gridname"_a, "keepEmpty"_a = true
+            "slot"_a, "paths"_a, "gridname"_a, "keepEmpty"_a = true, "format"_a = GridFormat::Float, "tolerance"_a = 0.f, "residency"_a = Grid::Residency::NanoVDBAndBricks
         ); // PYTHONDEPRECATED
         volume.def("loadGridSequence",
-            [](GridVolume& self, GridVolume::GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty)
-            { return self.loadGridSequence(slot, getActiveAssetResolver().resolvePath(path), gridname, keepEmpty); },
-            "slot"_a, "path"_a, "gridnames"_a, "keepEmpty"_a = true
+            [](GridVolume& self, GridVolume::GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty, GridFormat format, float tolerance, Grid::Residency residency)
+            { return self.loadGridSequence(slot, getActiveAssetResolver().resolvePath(path), gridname, keepEmpty, Grid::StorageDesc{ format, tolerance, residency }); },
+            "slot"_a, "path"_a, "gridnames"_a, "keepEmpty"_a = true, "format"_a = GridFormat::Float, "tolerance"_a = 0.f, "residency"_a = Grid::Residency::NanoVDBAndBricks
         ); // PYTHONDEPRECATED
 
         m.attr("Volume") = m.attr("GridVolume"); // PYTHONDEPRECATED
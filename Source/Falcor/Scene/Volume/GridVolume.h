@@ -113,18 +113,20 @@ namespace Falcor
             \param[in] slot Grid slot.
             \param[in] path File path of the grid. Can also include a full path or relative path from a data directory.
             \param[in] gridname Name of the grid to load.
+            \param[in] storage Storage options for the GPU representation of the grid.
             \return Returns true if grid was loaded successfully.
         */
-        bool loadGrid(GridSlot slot, const std::filesystem::path& path, const std::string& gridname);
+        bool loadGrid(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, const Grid::StorageDesc& storage = {});
 
         /** Create a GridSequence from a list of files.
             \param[in] pDevice GPU device
             \param[in] paths File paths of the grids. Can also include a full path or relative path from a data directory.
             \param[in] gridname Name of the grid to load.
             \param[in] keepEmpty Add empty (nullptr) grids to the sequence if one cannot be loaded from the file.
+            \param[in] storage Storage options for the GPU representation of the grids.
             \return Returns the resulting GridSequence
         */
-        static GridSequence createGridSequence(ref<Device> pDevice, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty = true);
+        static GridSequence createGridSequence(ref<Device> pDevice, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty = true, const Grid::StorageDesc& storage = {});
 
         /** Load a sequence of grids from files to a grid slot.
             Note: This will replace any existing grid sequence for that slot.
@@ -132,9 +134,10 @@ namespace Falcor
             \param[in] paths File paths of the grids. Can also include a full path or relative path from a data directory.
             \param[in] gridname Name of the grid to load.
             \param[in] keepEmpty Add empty (nullptr) grids to the sequence if one cannot be loaded from the file.
+            \param[in] storage Storage options for the GPU representation of the grids.
             \return Returns the length of the loaded sequence.
         */
-        uint32_t loadGridSequence(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty = true);
+        uint32_t loadGridSequence(GridSlot slot, const std::vector<std::filesystem::path>& paths, const std::string& gridname, bool keepEmpty = true, const Grid::StorageDesc& storage = {});
 
         /** Load a sequence of grids from a directory to a grid slot.
             Note: This will replace any existing grid sequence for that slot.
@@ -142,9 +145,10 @@ namespace Falcor
             \param[in] path Directory containing grid files. Can also include a full path or relative path from a data directory.
             \param[in] gridname Name of the grid to load.
             \param[in] keepEmpty Add empty (nullptr) grids to the sequence if one cannot be loaded from the file.
+            \param[in] storage Storage options for the GPU representation of the grids.
             \return Returns the length of the loaded sequence.
         */
-        uint32_t loadGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty = true);
+        uint32_t loadGridSequence(GridSlot slot, const std::filesystem::path& path, const std::string& gridname, bool keepEmpty = true, const Grid::StorageDesc& storage = {});
 
         /** Set the grid sequence for the specified slot.
         */
@@ -0,0 +1,142 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Tracks dirty elements of an array and coalesces them into ranges for uploading.
+ * Used to batch many small updates of a GPU buffer that is mirrored on the CPU into a few large ones.
+ */
+class DirtyRangeTracker
+{
+public:
+    /// Half-open range of elements [begin, end).
+    struct Range
+    {
+        uint32_t begin = 0;
+        uint32_t end = 0;
+
+        uint32_t getCount() const { return end - begin; }
+        bool operator==(const Range& other) const { return begin == other.begin && end == other.end; }
+    };
+
+    /**
+     * Mark a single element as dirty.
+     * @param index Element index.
+     */
+    void markDirty(uint32_t index) { markDirty(index, index + 1); }
+
+    /**
+     * Mark a range of elements as dirty.
+     * @param begin First element.
+     * @param end One past the last element. Empty ranges are ignored.
+     */
+    void markDirty(uint32_t begin, uint32_t end)
+    {
+        if (begin >= end)
+            return;
+
+        // Extend the last range if the new one overlaps or touches it. This keeps the list short for sequential updates.
+        if (!mRanges.empty() && begin <= mRanges.back().end && end >= mRanges.back().begin)
+        {
+            mRanges.back().begin = std::min(mRanges.back().begin, begin);
+            mRanges.back().end = std::max(mRanges.back().end, end);
+            return;
+        }
+
+        mRanges.push_back({begin, end});
+
+        // Compact if the list grows large from scattered updates.
+        if (mRanges.size() >= kCompactThreshold && mRanges.size() >= 2 * mCompactedSize)
+        {
+            mRanges = getRanges();
+            mCompactedSize = mRanges.size();
+        }
+    }
+
+    /// Returns true if any element is dirty.
+    bool isDirty() const { return !mRanges.empty(); }
+
+    /// Clear all dirty elements.
+    void clear()
+    {
+        mRanges.clear();
+        mCompactedSize = 0;
+    }
+
+    /**
+     * Get the dirty elements as sorted, disjoint ranges.
+     * Ranges that are separated by at most 'maxGap' clean elements are merged,
+     * trading redundant uploads of clean elements for fewer uploads.
+     * @param maxGap Maximum number of clean elements between merged ranges.
+     * @return List of ranges.
+     */
+    std::vector<Range> getRanges(uint32_t maxGap = 0) const
+    {
+        std::vector<Range> ranges = mRanges;
+        std::sort(ranges.begin(), ranges.end(), [](const Range& a, const Range& b) { return a.begin < b.begin; });
+
+        std::vector<Range> merged;
+        for (const auto& range : ranges)
+        {
+            if (!merged.empty() && (uint64_t)range.begin <= (uint64_t)merged.back().end + maxGap)
+                merged.back().end = std::max(merged.back().end, range.end);
+            else
+                merged.push_back(range);
+        }
+        return merged;
+    }
+
+    /// Get the range spanning all dirty elements, or an empty range if none are dirty.
+    Range getBounds() const
+    {
+        if (mRanges.empty())
+            return {};
+        Range bounds = mRanges.front();
+        for (const auto& range : mRanges)
+        {
+            bounds.begin = std::min(bounds.begin, range.begin);
+            bounds.end = std::max(bounds.end, range.end);
+        }
+        return bounds;
+    }
+
+private:
+    static constexpr size_t kCompactThreshold = 64;
+
+    std::vector<Range> mRanges;
+    size_t mCompactedSize = 0;
+};
+
+} // namespace Falcor
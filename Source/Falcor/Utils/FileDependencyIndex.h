@@ -0,0 +1,139 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Bidirectional index between files and the objects that depend on them (e.g. programs or assets).
+ * Used together with FileWatcher to find the objects affected by a file change without checking
+ * the modification times of all dependencies.
+ * Paths are used as is, callers are expected to normalize them (see FileWatcher::normalizePath()).
+ * @tparam T Dependent type. Must be hashable and comparable (e.g. a pointer or an ID).
+ */
+template<typename T>
+class FileDependencyIndex
+{
+public:
+    /**
+     * Add a file dependency.
+     * @param dependent Dependent object.
+     * @param path File path.
+     * @return True if the file was not referenced by any dependent before.
+     */
+    bool addDependency(const T& dependent, const std::filesystem::path& path)
+    {
+        std::string key = path.string();
+        auto& dependents = mFileToDependents[key];
+        bool isNewFile = dependents.empty();
+        dependents.insert(dependent);
+        mDependentToFiles[dependent].insert(std::move(key));
+        return isNewFile;
+    }
+
+    /**
+     * Remove a dependent and all its dependencies.
+     * @param dependent Dependent object.
+     * @return Files that are no longer referenced by any dependent.
+     */
+    std::vector<std::filesystem::path> removeDependent(const T& dependent)
+    {
+        std::vector<std::filesystem::path> orphans;
+        auto it = mDependentToFiles.find(dependent);
+        if (it == mDependentToFiles.end())
+            return orphans;
+
+        for (const auto& key : it->second)
+        {
+            auto fileIt = mFileToDependents.find(key);
+            fileIt->second.erase(dependent);
+            if (fileIt->second.empty())
+            {
+                orphans.push_back(key);
+                mFileToDependents.erase(fileIt);
+            }
+        }
+        mDependentToFiles.erase(it);
+        return orphans;
+    }
+
+    /**
+     * Get the dependents of a file.
+     * @param path File path.
+     * @return List of dependents in unspecified order.
+     */
+    std::vector<T> getDependents(const std::filesystem::path& path) const
+    {
+        auto it = mFileToDependents.find(path.string());
+        if (it == mFileToDependents.end())
+            return {};
+        return std::vector<T>(it->second.begin(), it->second.end());
+    }
+
+    /**
+     * Get the files a dependent depends on.
+     * @param dependent Dependent object.
+     * @return List of file paths in unspecified order.
+     */
+    std::vector<std::filesystem::path> getDependencies(const T& dependent) const
+    {
+        auto it = mDependentToFiles.find(dependent);
+        if (it == mDependentToFiles.end())
+            return {};
+        return std::vector<std::filesystem::path>(it->second.begin(), it->second.end());
+    }
+
+    /// Returns true if the dependent has any dependencies.
+    bool hasDependent(const T& dependent) const { return mDependentToFiles.count(dependent) > 0; }
+
+    /// Returns the number of referenced files.
+    size_t getFileCount() const { return mFileToDependents.size(); }
+
+    /// Returns the number of dependents.
+    size_t getDependentCount() const { return mDependentToFiles.size(); }
+
+    /// Remove all dependencies.
+    void clear()
+    {
+        mFileToDependents.clear();
+        mDependentToFiles.clear();
+    }
+
+private:
+    std::unordered_map<std::string, std::unordered_set<T>> mFileToDependents;
+    std::unordered_map<T, std::unordered_set<std::string>> mDependentToFiles;
+};
+
+} // namespace Falcor
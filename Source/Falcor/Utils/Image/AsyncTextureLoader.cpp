@@ -77,6 +77,24 @@ std::future<ref<Texture>> AsyncTextureLoader::loadFromFile(
     return mLoadRequestQueue.back().promise.get_future();
 }
 
+std::future<ImageIO::MipLevels> AsyncTextureLoader::loadMipLevels(
+    fstd::span<const std::filesystem::path> paths,
+    bool generateMipLevels,
+    bool loadAsSrgb,
+    Bitmap::ImportFlags importFlags,
+    ResourceFormat format,
+    uint32_t firstMip,
+    uint32_t mipCount
+)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mMipLoadRequestQueue.push(
+        MipLoadRequest{{paths.begin(), paths.end()}, generateMipLevels, loadAsSrgb, importFlags, format, firstMip, mipCount}
+    );
+    mCondition.notify_one();
+    return mMipLoadRequestQueue.back().promise.get_future();
+}
+
 void AsyncTextureLoader::runWorkers(size_t threadCount)
 {
     // Create a barrier to synchronize worker threads before issuing a global flush.
@@ -107,7 +125,9 @@ void AsyncTextureLoader::runWorker()
     {
         // Wait on condition until more work is ready.
         std::unique_lock<std::mutex> lock(mMutex);
-        mCondition.wait(lock, [&]() { return mTerminate || !mLoadRequestQueue.empty() || mFlushPending; });
+        mCondition.wait(
+            lock, [&]() { return mTerminate || !mLoadRequestQueue.empty() || !mMipLoadRequestQueue.empty() || mFlushPending; }
+        );
 
         // Sync thread if a flush is pending.
         if (mFlushPending)
@@ -119,9 +139,38 @@ void AsyncTextureLoader::runWorker()
         }
 
         // Terminate thread unless there is more work to do.
-        if (mTerminate && mLoadRequestQueue.empty() && !mFlushPending)
+        if (mTerminate && mLoadRequestQueue.empty() && mMipLoadRequestQueue.empty() && !mFlushPending)
             break;
 
+        // Load mip levels into memory. This doesn't upload anything, so it doesn't count towards the flush interval.
+        if (mLoadRequestQueue.empty() && !mMipLoadRequestQueue.empty())
+        {
+            auto request = std::move(mMipLoadRequestQueue.front());
+            mMipLoadRequestQueue.pop();
+
+            lock.unlock();
+
+            try
+            {
+                request.promise.set_value(ImageIO::loadMipLevels(
+                    request.paths,
+                    request.generateMipLevels,
+                    request.loadAsSRGB,
+                    request.importFlags,
+                    request.format,
+                    request.firstMip,
+                    request.mipCount
+                ));
+            }
+            catch (...)
+            {
+                request.promise.set_exception(std::current_exception());
+            }
+
+            mCondition.notify_one();
+            continue;
+        }
+
         // Go back waiting if queue is currently empty.
         if (mLoadRequestQueue.empty())
             continue;
@@ -30,6 +30,7 @@
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
 #include "Core/API/Texture.h"
+#include "Utils/Image/ImageIO.h"
 #include <condition_variable>
 #include <filesystem>
 #include <functional>
@@ -100,6 +101,21 @@ public:
         LoadCallback callback = {}
     );
 
+    /**
+     * Request loading a range of mip levels of a texture into memory.
+     * See ImageIO::loadMipLevels() for a description of the arguments. No GPU resources are created.
+     * @return A future to the loaded levels. The future holds an exception if loading failed.
+     */
+    std::future<ImageIO::MipLevels> loadMipLevels(
+        fstd::span<const std::filesystem::path> paths,
+        bool generateMipLevels,
+        bool loadAsSRGB,
+        Bitmap::ImportFlags importFlags,
+        ResourceFormat format,
+        uint32_t firstMip,
+        uint32_t mipCount
+    );
+
 private:
     void runWorkers(size_t threadCount);
     void runWorker();
@@ -116,6 +132,18 @@ private:
         std::promise<ref<Texture>> promise;
     };
 
+    struct MipLoadRequest
+    {
+        std::vector<std::filesystem::path> paths;
+        bool generateMipLevels;
+        bool loadAsSRGB;
+        Bitmap::ImportFlags importFlags;
+        ResourceFormat format;
+        uint32_t firstMip;
+        uint32_t mipCount;
+        std::promise<ImageIO::MipLevels> promise;
+    };
+
     ref<Device> mpDevice;
 
     std::mutex mMutex;                      ///< Mutex for synchronizing access to shared resources.
@@ -124,7 +152,8 @@ private:
     std::vector<std::thread> mThreads;      ///< Worker threads.
 
     // Internal state. Do not access outside of critical section.
-    std::queue<LoadRequest> mLoadRequestQueue; ///< Texture loading request queue.
+    std::queue<LoadRequest> mLoadRequestQueue;       ///< Texture loading request queue.
+    std::queue<MipLoadRequest> mMipLoadRequestQueue; ///< Mip level loading request queue.
 
     bool mTerminate = false;     ///< Flag to terminate worker threads.
     bool mFlushPending = false;  ///< Flag to indicate a GPU flush is pending.
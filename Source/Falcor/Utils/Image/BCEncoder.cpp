@@ -0,0 +1,495 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BCEncoder.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <execution>
+
+namespace Falcor
+{
+namespace
+{
+/// Block of 4x4 pixels with up to 4 channels.
+template<int N>
+using Block = std::array<std::array<float, N>, 16>;
+
+template<int N>
+using Vec = std::array<float, N>;
+
+template<int N>
+float distance2(const Vec<N>& a, const Vec<N>& b)
+{
+    float d = 0.f;
+    for (int c = 0; c < N; c++)
+        d += (a[c] - b[c]) * (a[c] - b[c]);
+    return d;
+}
+
+/**
+ * Fit a line through the block pixels and return the extreme points of the pixels projected onto it.
+ */
+template<int N>
+void fitEndpoints(const Block<N>& block, Vec<N>& e0, Vec<N>& e1)
+{
+    Vec<N> mean = {};
+    for (const auto& p : block)
+        for (int c = 0; c < N; c++)
+            mean[c] += p[c] / 16.f;
+
+    float covariance[N][N] = {};
+    for (const auto& p : block)
+        for (int i = 0; i < N; i++)
+            for (int j = 0; j < N; j++)
+                covariance[i][j] += (p[i] - mean[i]) * (p[j] - mean[j]);
+
+    // Find the principal axis with power iteration, starting from the diagonal of the bounding box.
+    Vec<N> axis;
+    Vec<N> minValue = block[0], maxValue = block[0];
+    for (const auto& p : block)
+        for (int c = 0; c < N; c++)
+            minValue[c] = std::min(minValue[c], p[c]), maxValue[c] = std::max(maxValue[c], p[c]);
+    for (int c = 0; c < N; c++)
+        axis[c] = maxValue[c] - minValue[c];
+    for (int iteration = 0; iteration < 8; iteration++)
+    {
+        Vec<N> next = {};
+        float length = 0.f;
+        for (int i = 0; i < N; i++)
+        {
+            for (int j = 0; j < N; j++)
+                next[i] += covariance[i][j] * axis[j];
+            length = std::max(length, std::abs(next[i]));
+        }
+        if (length == 0.f)
+            break;
+        for (int i = 0; i < N; i++)
+            axis[i] = next[i] / length;
+    }
+
+    float minT = 0.f, maxT = 0.f;
+    float axisLength2 = 0.f;
+    for (int c = 0; c < N; c++)
+        axisLength2 += axis[c] * axis[c];
+    if (axisLength2 > 0.f)
+    {
+        minT = std::numeric_limits<float>::max();
+        maxT = std::numeric_limits<float>::lowest();
+        for (const auto& p : block)
+        {
+            float t = 0.f;
+            for (int c = 0; c < N; c++)
+                t += (p[c] - mean[c]) * axis[c];
+            t /= axisLength2;
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+    }
+
+    for (int c = 0; c < N; c++)
+    {
+        e0[c] = std::clamp(mean[c] + minT * axis[c], 0.f, 255.f);
+        e1[c] = std::clamp(mean[c] + maxT * axis[c], 0.f, 255.f);
+    }
+}
+
+/**
+ * Refine the endpoints with a least squares fit, given the interpolation weight of each pixel.
+ * @return False if the system is degenerate (all pixels use the same weight).
+ */
+template<int N>
+bool refineEndpoints(const Block<N>& block, const float weights[16], Vec<N>& e0, Vec<N>& e1)
+{
+    float aa = 0.f, ab = 0.f, bb = 0.f;
+    Vec<N> ax = {}, bx = {};
+    for (int i = 0; i < 16; i++)
+    {
+        const float b = weights[i];
+        const float a = 1.f - b;
+        aa += a * a;
+        ab += a * b;
+        bb += b * b;
+        for (int c = 0; c < N; c++)
+        {
+            ax[c] += a * block[i][c];
+            bx[c] += b * block[i][c];
+        }
+    }
+    const float det = aa * bb - ab * ab;
+    if (std::abs(det) < 1e-6f)
+        return false;
+    for (int c = 0; c < N; c++)
+    {
+        e0[c] = std::clamp((bb * ax[c] - ab * bx[c]) / det, 0.f, 255.f);
+        e1[c] = std::clamp((aa * bx[c] - ab * ax[c]) / det, 0.f, 255.f);
+    }
+    return true;
+}
+
+/// Writes a little-endian bitstream into a 16-byte block.
+class BlockWriter
+{
+public:
+    BlockWriter(uint8_t* pDst) : mpDst(pDst) { std::fill_n(pDst, 16, uint8_t(0)); }
+
+    void write(uint32_t value, uint32_t bitCount)
+    {
+        for (uint32_t i = 0; i < bitCount; i++, mBitPos++)
+            mpDst[mBitPos / 8] |= uint8_t(((value >> i) & 1) << (mBitPos % 8));
+    }
+
+private:
+    uint8_t* mpDst;
+    uint32_t mBitPos = 0;
+};
+
+// BC1
+
+uint16_t packColor565(const Vec<3>& color)
+{
+    auto quantize = [](float v, float maxValue) { return (uint32_t)std::lround(v * maxValue / 255.f); };
+    return uint16_t((quantize(color[0], 31.f) << 11) | (quantize(color[1], 63.f) << 5) | quantize(color[2], 31.f));
+}
+
+Vec<3> unpackColor565(uint16_t packed)
+{
+    uint32_t r = (packed >> 11) & 31, g = (packed >> 5) & 63, b = packed & 31;
+    return {float((r << 3) | (r >> 2)), float((g << 2) | (g >> 4)), float((b << 3) | (b >> 2))};
+}
+
+/// Assign the BC1 palette indices for the given endpoints. Returns the total squared error.
+float assignColorIndices(const Block<3>& block, uint16_t c0, uint16_t c1, uint32_t& indices)
+{
+    const Vec<3> e0 = unpackColor565(c0), e1 = unpackColor565(c1);
+    Vec<3> palette[4] = {e0, e1};
+    for (int c = 0; c < 3; c++)
+    {
+        palette[2][c] = (2.f * e0[c] + e1[c]) / 3.f;
+        palette[3][c] = (e0[c] + 2.f * e1[c]) / 3.f;
+    }
+
+    float error = 0.f;
+    indices = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        uint32_t best = 0;
+        float bestError = distance2<3>(block[i], palette[0]);
+        for (uint32_t j = 1; j < 4; j++)
+        {
+            float e = distance2<3>(block[i], palette[j]);
+            if (e < bestError)
+                best = j, bestError = e;
+        }
+        indices |= best << (2 * i);
+        error += bestError;
+    }
+    return error;
+}
+
+void encodeBC1Block(const Block<3>& block, uint8_t* pDst)
+{
+    Vec<3> e0, e1;
+    fitEndpoints<3>(block, e0, e1);
+
+    uint16_t c0 = packColor565(e1), c1 = packColor565(e0);
+    uint32_t indices;
+    float error = assignColorIndices(block, c0, c1, indices);
+
+    // Refine the endpoints using the weights of the assigned palette entries.
+    const float kWeights[4] = {0.f, 1.f, 1.f / 3.f, 2.f / 3.f};
+    for (int iteration = 0; iteration < 2 && c0 != c1; iteration++)
+    {
+        float weights[16];
+        for (int i = 0; i < 16; i++)
+            weights[i] = kWeights[(indices >> (2 * i)) & 3];
+        Vec<3> r0 = unpackColor565(c0), r1 = unpackColor565(c1);
+        if (!refineEndpoints<3>(block, weights, r0, r1))
+            break;
+        uint16_t n0 = packColor565(r0), n1 = packColor565(r1);
+        uint32_t newIndices;
+        float newError = assignColorIndices(block, n0, n1, newIndices);
+        if (newError >= error)
+            break;
+        c0 = n0, c1 = n1, indices = newIndices, error = newError;
+    }
+
+    // Use the four color mode, which requires c0 > c1.
+    if (c0 < c1)
+    {
+        std::swap(c0, c1);
+        indices ^= 0x55555555; // Swaps 0 <-> 1 and 2 <-> 3.
+    }
+    else if (c0 == c1)
+    {
+        indices = 0;
+    }
+
+    pDst[0] = uint8_t(c0), pDst[1] = uint8_t(c0 >> 8);
+    pDst[2] = uint8_t(c1), pDst[3] = uint8_t(c1 >> 8);
+    for (int i = 0; i < 4; i++)
+        pDst[4 + i] = uint8_t(indices >> (8 * i));
+}
+
+// BC4
+
+/// Encode a single channel block with 8 interpolated values.
+void encodeBC4Block(const Block<1>& block, uint8_t* pDst)
+{
+    float minValue = 255.f, maxValue = 0.f;
+    for (const auto& p : block)
+        minValue = std::min(minValue, p[0]), maxValue = std::max(maxValue, p[0]);
+
+    uint32_t e0 = (uint32_t)std::lround(maxValue), e1 = (uint32_t)std::lround(minValue);
+    uint64_t indices = 0;
+    if (e0 > e1)
+    {
+        // Palette entries 0 and 1 are the endpoints, entries 2-7 are interpolated from e0 towards e1.
+        float palette[8] = {float(e0), float(e1)};
+        for (uint32_t i = 1; i < 7; i++)
+            palette[i + 1] = ((7 - i) * e0 + i * e1) / 7.f;
+        for (int i = 0; i < 16; i++)
+        {
+            uint64_t best = 0;
+            float bestError = std::abs(block[i][0] - palette[0]);
+            for (uint32_t j = 1; j < 8; j++)
+            {
+                float e = std::abs(block[i][0] - palette[j]);
+                if (e < bestError)
+                    best = j, bestError = e;
+            }
+            indices |= best << (3 * i);
+        }
+    }
+
+    pDst[0] = uint8_t(e0);
+    pDst[1] = uint8_t(e1);
+    for (int i = 0; i < 6; i++)
+        pDst[2 + i] = uint8_t(indices >> (8 * i));
+}
+
+// BC7
+
+const uint32_t kBC7Weights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+/// Quantize an endpoint to 7 bits per channel plus a shared p-bit, choosing the p-bit with the lowest error.
+void quantizeBC7Endpoint(const Vec<4>& endpoint, uint32_t quantized[4], uint32_t& pBit)
+{
+    float bestError = std::numeric_limits<float>::max();
+    for (uint32_t p = 0; p < 2; p++)
+    {
+        uint32_t q[4];
+        float error = 0.f;
+        for (int c = 0; c < 4; c++)
+        {
+            q[c] = (uint32_t)std::clamp<long>(std::lround((endpoint[c] - p) / 2.f), 0, 127);
+            float d = float((q[c] << 1) | p) - endpoint[c];
+            error += d * d;
+        }
+        if (error < bestError)
+        {
+            bestError = error;
+            pBit = p;
+            std::copy_n(q, 4, quantized);
+        }
+    }
+}
+
+struct BC7Mode6
+{
+    uint32_t endpoints[2][4];
+    uint32_t pBits[2];
+    uint32_t indices[16];
+    float error;
+};
+
+void evaluateBC7Mode6(const Block<4>& block, const Vec<4>& e0, const Vec<4>& e1, BC7Mode6& result)
+{
+    quantizeBC7Endpoint(e0, result.endpoints[0], result.pBits[0]);
+    quantizeBC7Endpoint(e1, result.endpoints[1], result.pBits[1]);
+
+    Vec<4> palette[16];
+    for (int c = 0; c < 4; c++)
+    {
+        const uint32_t a = (result.endpoints[0][c] << 1) | result.pBits[0];
+        const uint32_t b = (result.endpoints[1][c] << 1) | result.pBits[1];
+        for (int j = 0; j < 16; j++)
+            palette[j][c] = float(((64 - kBC7Weights4[j]) * a + kBC7Weights4[j] * b + 32) >> 6);
+    }
+
+    result.error = 0.f;
+    for (int i = 0; i < 16; i++)
+    {
+        uint32_t best = 0;
+        float bestError = distance2<4>(block[i], palette[0]);
+        for (uint32_t j = 1; j < 16; j++)
+        {
+            float e = distance2<4>(block[i], palette[j]);
+            if (e < bestError)
+                best = j, bestError = e;
+        }
+        result.indices[i] = best;
+        result.error += bestError;
+    }
+}
+
+void encodeBC7Block(const Block<4>& block, uint8_t* pDst)
+{
+    Vec<4> e0, e1;
+    fitEndpoints<4>(block, e0, e1);
+
+    BC7Mode6 best;
+    evaluateBC7Mode6(block, e0, e1, best);
+    for (int iteration = 0; iteration < 2 && best.error > 0.f; iteration++)
+    {
+        float weights[16];
+        for (int i = 0; i < 16; i++)
+            weights[i] = kBC7Weights4[best.indices[i]] / 64.f;
+        if (!refineEndpoints<4>(block, weights, e0, e1))
+            break;
+        BC7Mode6 candidate;
+        evaluateBC7Mode6(block, e0, e1, candidate);
+        if (candidate.error >= best.error)
+            break;
+        best = candidate;
+    }
+
+    // The most significant index bit of the first pixel is implicitly zero. Swap the endpoints if needed.
+    if (best.indices[0] & 8)
+    {
+        for (int c = 0; c < 4; c++)
+            std::swap(best.endpoints[0][c], best.endpoints[1][c]);
+        std::swap(best.pBits[0], best.pBits[1]);
+        for (auto& index : best.indices)
+            index = 15 - index;
+    }
+
+    BlockWriter writer(pDst);
+    writer.write(1u << 6, 7); // Mode 6.
+    for (int c = 0; c < 4; c++)
+    {
+        writer.write(best.endpoints[0][c], 7);
+        writer.write(best.endpoints[1][c], 7);
+    }
+    writer.write(best.pBits[0], 1);
+    writer.write(best.pBits[1], 1);
+    writer.write(best.indices[0], 3);
+    for (int i = 1; i < 16; i++)
+        writer.write(best.indices[i], 4);
+}
+
+template<int N>
+Block<N> loadBlock(const uint8_t* pRGBA8, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, uint32_t firstChannel)
+{
+    // Pixels outside the image replicate the last row and column.
+    Block<N> block;
+    for (uint32_t y = 0; y < 4; y++)
+    {
+        const uint32_t py = std::min(blockY * 4 + y, height - 1);
+        for (uint32_t x = 0; x < 4; x++)
+        {
+            const uint32_t px = std::min(blockX * 4 + x, width - 1);
+            const uint8_t* pPixel = pRGBA8 + (size_t(py) * width + px) * 4 + firstChannel;
+            for (int c = 0; c < N; c++)
+                block[y * 4 + x][c] = pPixel[c];
+        }
+    }
+    return block;
+}
+
+} // namespace
+
+bool BCEncoder::isSupported(ResourceFormat format)
+{
+    switch (format)
+    {
+    case ResourceFormat::BC1Unorm:
+    case ResourceFormat::BC1UnormSrgb:
+    case ResourceFormat::BC3Unorm:
+    case ResourceFormat::BC3UnormSrgb:
+    case ResourceFormat::BC4Unorm:
+    case ResourceFormat::BC5Unorm:
+    case ResourceFormat::BC7Unorm:
+    case ResourceFormat::BC7UnormSrgb:
+        return true;
+    default:
+        return false;
+    }
+}
+
+std::vector<uint8_t> BCEncoder::compress(ResourceFormat format, uint32_t width, uint32_t height, const uint8_t* pRGBA8)
+{
+    FALCOR_CHECK(isSupported(format), "BCEncoder doesn't support format '{}'.", to_string(format));
+    FALCOR_CHECK(width > 0 && height > 0, "Invalid image size {}x{}.", width, height);
+
+    const uint32_t blockSize = getFormatBytesPerBlock(format);
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    std::vector<uint8_t> result(size_t(blocksX) * blocksY * blockSize);
+
+    NumericRange<uint32_t> rows(0, blocksY);
+    std::for_each(
+        std::execution::par,
+        rows.begin(),
+        rows.end(),
+        [&](uint32_t blockY)
+        {
+            for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+            {
+                uint8_t* pDst = result.data() + (size_t(blockY) * blocksX + blockX) * blockSize;
+                switch (format)
+                {
+                case ResourceFormat::BC1Unorm:
+                case ResourceFormat::BC1UnormSrgb:
+                    encodeBC1Block(loadBlock<3>(pRGBA8, width, height, blockX, blockY, 0), pDst);
+                    break;
+                case ResourceFormat::BC3Unorm:
+                case ResourceFormat::BC3UnormSrgb:
+                    encodeBC4Block(loadBlock<1>(pRGBA8, width, height, blockX, blockY, 3), pDst);
+                    encodeBC1Block(loadBlock<3>(pRGBA8, width, height, blockX, blockY, 0), pDst + 8);
+                    break;
+                case ResourceFormat::BC4Unorm:
+                    encodeBC4Block(loadBlock<1>(pRGBA8, width, height, blockX, blockY, 0), pDst);
+                    break;
+                case ResourceFormat::BC5Unorm:
+                    encodeBC4Block(loadBlock<1>(pRGBA8, width, height, blockX, blockY, 0), pDst);
+                    encodeBC4Block(loadBlock<1>(pRGBA8, width, height, blockX, blockY, 1), pDst + 8);
+                    break;
+                default:
+                    encodeBC7Block(loadBlock<4>(pRGBA8, width, height, blockX, blockY, 0), pDst);
+                    break;
+                }
+            }
+        }
+    );
+
+    return result;
+}
+
+} // namespace Falcor
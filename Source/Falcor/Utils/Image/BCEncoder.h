@@ -0,0 +1,63 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * CPU encoder for block compressed texture formats.
+ *
+ * Supports BC1, BC3, BC4, BC5 and BC7. Endpoints are fitted along the principal axis of each block and refined
+ * with a least squares fit. BC7 blocks are encoded with mode 6 (single subset, RGBA endpoints, 4-bit indices),
+ * which gives good quality for smooth color and alpha content at a fraction of the cost of a full mode search.
+ * Blocks are encoded in parallel.
+ */
+class FALCOR_API BCEncoder
+{
+public:
+    /**
+     * Check if a format can be produced by the encoder.
+     */
+    static bool isSupported(ResourceFormat format);
+
+    /**
+     * Compress an image.
+     * sRGB formats are encoded like their linear counterparts, i.e. the endpoints are fitted to the stored values.
+     * @param[in] format Destination format. BC4 encodes the red channel, BC5 the red and green channels.
+     * @param[in] width Image width in pixels. Does not need to be a multiple of the block size.
+     * @param[in] height Image height in pixels. Does not need to be a multiple of the block size.
+     * @param[in] pRGBA8 Source pixels with 4 bytes per pixel and tightly packed rows.
+     * @return Compressed blocks in row-major order.
+     */
+    static std::vector<uint8_t> compress(ResourceFormat format, uint32_t width, uint32_t height, const uint8_t* pRGBA8);
+};
+} // namespace Falcor
@@ -0,0 +1,895 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BasisDecoder.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace Falcor
+{
+namespace
+{
+// BasisLZ constants (Basis Universal).
+const size_t kGlobalDataHeaderSize = 20;
+const size_t kImageDescSize = 20;
+const uint32_t kImageFlagPFrame = 0x2;
+
+const uint32_t kMaxHuffmanSymbols = 16384;
+const uint32_t kMaxHuffmanCodeSize = 16;
+const uint32_t kCodeLengthCodeCount = 21;
+const uint8_t kCodeLengthCodeOrder[kCodeLengthCodeCount] = {17, 18, 19, 20, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15, 16};
+
+const uint32_t kEndpointPredRepeatSymbol = 256;
+const uint32_t kEndpointPredRepeatCountBits = 4;
+const uint32_t kEndpointPredMinRepeatCount = 3;
+const uint32_t kSelectorHistoryRunCodeCount = 64;
+const uint32_t kSelectorHistoryRunCountBits = 7;
+const uint32_t kSelectorHistoryMinRunCount = 3;
+
+/// ETC1 intensity modifier tables, indexed by the (linear) selector.
+const int kIntensityTables[8][4] = {
+    {-8, -2, 2, 8},
+    {-17, -5, 5, 17},
+    {-29, -9, 9, 29},
+    {-42, -13, 13, 42},
+    {-60, -18, 18, 60},
+    {-80, -24, 24, 80},
+    {-106, -33, 33, 106},
+    {-183, -47, 47, 183},
+};
+
+uint16_t readU16(const uint8_t* p)
+{
+    uint16_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint32_t readU32(const uint8_t* p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/**
+ * History of recently used selector indices. Used entries move halfway to the front, new entries are added in the
+ * back half of the buffer.
+ */
+class SelectorHistory
+{
+public:
+    SelectorHistory(uint32_t size) : mValues(size, 0), mRover(size / 2) {}
+
+    uint32_t size() const { return (uint32_t)mValues.size(); }
+    uint32_t operator[](uint32_t index) const { return mValues[index]; }
+
+    void add(uint32_t value)
+    {
+        mValues[mRover++] = value;
+        if (mRover == mValues.size())
+            mRover = (uint32_t)mValues.size() / 2;
+    }
+
+    void use(uint32_t index)
+    {
+        if (index > 0)
+            std::swap(mValues[index / 2], mValues[index]);
+    }
+
+private:
+    std::vector<uint32_t> mValues;
+    uint32_t mRover;
+};
+} // namespace
+
+/// Reads a bitstream forward, starting at the least significant bit of the first byte.
+class ETC1SDecoder::BitReader
+{
+public:
+    BitReader(const uint8_t* pData, size_t size) : mpData(pData), mSize(size) {}
+
+    /// Peek at up to 25 bits. Bits past the end of the data read as zero.
+    uint32_t peek(uint32_t count) const
+    {
+        uint32_t value = 0;
+        const size_t byte = mBitPos / 8;
+        for (size_t i = 0; i < 4 && byte + i < mSize; i++)
+            value |= uint32_t(mpData[byte + i]) << (8 * i);
+        return (value >> (mBitPos % 8)) & ((1u << count) - 1);
+    }
+
+    void skip(uint32_t count)
+    {
+        mBitPos += count;
+        if (mBitPos > mSize * 8)
+            FALCOR_THROW("Unexpected end of ETC1S data.");
+    }
+
+    uint32_t read(uint32_t count)
+    {
+        uint32_t value = peek(count);
+        skip(count);
+        return value;
+    }
+
+    /// Read a variable length integer, stored in chunks of the given size that are each followed by a continuation bit.
+    uint32_t readVLC(uint32_t chunkBits)
+    {
+        uint32_t value = 0;
+        for (uint32_t shift = 0; shift < 32; shift += chunkBits)
+        {
+            const uint32_t chunk = read(chunkBits + 1);
+            value |= (chunk & ((1u << chunkBits) - 1)) << shift;
+            if ((chunk >> chunkBits) == 0)
+                return value;
+        }
+        FALCOR_THROW("Invalid variable length integer in ETC1S data.");
+    }
+
+private:
+    const uint8_t* mpData;
+    size_t mSize;
+    size_t mBitPos = 0;
+};
+
+namespace
+{
+uint32_t reverseBits(uint32_t value, uint32_t count)
+{
+    uint32_t result = 0;
+    for (uint32_t i = 0; i < count; i++)
+        result |= ((value >> i) & 1) << (count - 1 - i);
+    return result;
+}
+} // namespace
+
+void ETC1SDecoder::readHuffmanTable(BitReader& reader, HuffmanTable& table)
+{
+    // Build a canonical code from code sizes. Codes are stored with their first bit in the least significant bit.
+    auto build = [](const uint8_t* pCodeSizes, uint32_t symbolCount, HuffmanTable& result)
+    {
+        uint32_t counts[kMaxHuffmanCodeSize + 1] = {};
+        result = {};
+        result.symbolCount = symbolCount;
+        for (uint32_t s = 0; s < symbolCount; s++)
+        {
+            counts[pCodeSizes[s]]++;
+            result.maxBits = std::max<uint32_t>(result.maxBits, pCodeSizes[s]);
+        }
+        if (result.maxBits == 0)
+            return;
+
+        uint32_t nextCode[kMaxHuffmanCodeSize + 1] = {};
+        uint32_t code = 0;
+        for (uint32_t size = 1; size <= kMaxHuffmanCodeSize; size++)
+        {
+            nextCode[size] = code;
+            code = (code + counts[size]) << 1;
+            if (nextCode[size] + counts[size] > (1u << size))
+                FALCOR_THROW("Invalid Huffman code sizes in ETC1S data.");
+        }
+
+        result.entries.assign(size_t(1) << result.maxBits, {});
+        for (uint32_t s = 0; s < symbolCount; s++)
+        {
+            const uint32_t size = pCodeSizes[s];
+            if (size == 0)
+                continue;
+            for (uint32_t i = reverseBits(nextCode[size]++, size); i < result.entries.size(); i += 1u << size)
+                result.entries[i] = {uint16_t(s), uint8_t(size)};
+        }
+    };
+
+    table = {};
+    const uint32_t symbolCount = reader.read(14);
+    if (symbolCount == 0)
+        return;
+    if (symbolCount > kMaxHuffmanSymbols)
+        FALCOR_THROW("Too many Huffman symbols in ETC1S data.");
+
+    // The code sizes are themselves Huffman coded, with run length codes for zeros and repeated sizes.
+    const uint32_t codeLengthCodeCount = reader.read(5);
+    if (codeLengthCodeCount < 1 || codeLengthCodeCount > kCodeLengthCodeCount)
+        FALCOR_THROW("Invalid Huffman table in ETC1S data.");
+    uint8_t codeLengthCodeSizes[kCodeLengthCodeCount] = {};
+    for (uint32_t i = 0; i < codeLengthCodeCount; i++)
+        codeLengthCodeSizes[kCodeLengthCodeOrder[i]] = (uint8_t)reader.read(3);
+    HuffmanTable codeLengthTable;
+    build(codeLengthCodeSizes, kCodeLengthCodeCount, codeLengthTable);
+
+    std::vector<uint8_t> codeSizes(symbolCount, 0);
+    uint32_t count = 0;
+    while (count < symbolCount)
+    {
+        const uint32_t code = decodeSymbol(reader, codeLengthTable);
+        if (code <= kMaxHuffmanCodeSize)
+        {
+            codeSizes[count++] = (uint8_t)code;
+            continue;
+        }
+
+        uint32_t run;
+        uint8_t size = 0;
+        if (code == 17)
+            run = reader.read(3) + 3;
+        else if (code == 18)
+            run = reader.read(7) + 11;
+        else
+        {
+            if (count == 0 || codeSizes[count - 1] == 0)
+                FALCOR_THROW("Invalid Huffman table in ETC1S data.");
+            size = codeSizes[count - 1];
+            run = code == 19 ? reader.read(2) + 3 : reader.read(6) + 7;
+        }
+        if (run > symbolCount - count)
+            FALCOR_THROW("Invalid Huffman table in ETC1S data.");
+        std::fill_n(codeSizes.begin() + count, run, size);
+        count += run;
+    }
+
+    build(codeSizes.data(), symbolCount, table);
+}
+
+uint32_t ETC1SDecoder::decodeSymbol(BitReader& reader, const HuffmanTable& table)
+{
+    if (table.entries.empty())
+        FALCOR_THROW("Missing Huffman table in ETC1S data.");
+    const HuffmanTable::Entry& entry = table.entries[reader.peek(table.maxBits)];
+    if (entry.bitCount == 0)
+        FALCOR_THROW("Invalid Huffman code in ETC1S data.");
+    reader.skip(entry.bitCount);
+    return entry.symbol;
+}
+
+ETC1SDecoder::ETC1SDecoder(const uint8_t* pData, size_t size, uint32_t imageCount)
+{
+    FALCOR_CHECK(size >= kGlobalDataHeaderSize + imageCount * kImageDescSize, "BasisLZ global data is truncated.");
+    const uint32_t endpointCount = readU16(pData);
+    const uint32_t selectorCount = readU16(pData + 2);
+    const uint32_t endpointsByteLength = readU32(pData + 4);
+    const uint32_t selectorsByteLength = readU32(pData + 8);
+    const uint32_t tablesByteLength = readU32(pData + 12);
+    FALCOR_CHECK(endpointCount > 0 && selectorCount > 0, "BasisLZ global data has empty codebooks.");
+
+    mImageDescs.resize(imageCount);
+    const uint8_t* pImageDesc = pData + kGlobalDataHeaderSize;
+    for (auto& desc : mImageDescs)
+    {
+        desc.flags = readU32(pImageDesc);
+        desc.rgbSliceByteOffset = readU32(pImageDesc + 4);
+        desc.rgbSliceByteLength = readU32(pImageDesc + 8);
+        desc.alphaSliceByteOffset = readU32(pImageDesc + 12);
+        desc.alphaSliceByteLength = readU32(pImageDesc + 16);
+        FALCOR_CHECK((desc.flags & kImageFlagPFrame) == 0, "ETC1S video frames are not supported.");
+        pImageDesc += kImageDescSize;
+    }
+
+    const uint8_t* pEndpoints = pImageDesc;
+    const uint8_t* pSelectors = pEndpoints + endpointsByteLength;
+    const uint8_t* pTables = pSelectors + selectorsByteLength;
+    FALCOR_CHECK(
+        uint64_t(endpointsByteLength) + selectorsByteLength + tablesByteLength <= size - (pEndpoints - pData),
+        "BasisLZ global data is truncated."
+    );
+
+    // Endpoint codebook. Colors and intensities are delta coded, the color model is chosen by the previous value.
+    {
+        BitReader reader(pEndpoints, endpointsByteLength);
+        HuffmanTable colorDeltaTables[3];
+        HuffmanTable intensityDeltaTable;
+        for (auto& table : colorDeltaTables)
+            readHuffmanTable(reader, table);
+        readHuffmanTable(reader, intensityDeltaTable);
+        const bool isGrayscale = reader.read(1) != 0;
+
+        mEndpoints.resize(endpointCount);
+        uint32_t prevColor[3] = {16, 16, 16};
+        uint32_t prevIntensity = 0;
+        for (auto& endpoint : mEndpoints)
+        {
+            prevIntensity = (prevIntensity + decodeSymbol(reader, intensityDeltaTable)) & 7;
+            endpoint.intensity = (uint8_t)prevIntensity;
+            for (uint32_t c = 0; c < (isGrayscale ? 1u : 3u); c++)
+            {
+                const HuffmanTable& table = colorDeltaTables[prevColor[c] <= 9 ? 0 : (prevColor[c] <= 21 ? 1 : 2)];
+                prevColor[c] = (prevColor[c] + decodeSymbol(reader, table)) & 31;
+                endpoint.color[c] = (uint8_t)prevColor[c];
+            }
+            if (isGrayscale)
+                endpoint.color[1] = endpoint.color[2] = endpoint.color[0];
+        }
+    }
+
+    // Selector codebook. Each selector is stored as 4 bytes (one per row), either raw or XOR delta coded.
+    {
+        BitReader reader(pSelectors, selectorsByteLength);
+        FALCOR_CHECK(reader.read(1) == 0, "ETC1S files using the global selector codebook are not supported.");
+        FALCOR_CHECK(reader.read(1) == 0, "ETC1S files using the hybrid selector codebook are not supported.");
+        const bool isRaw = reader.read(1) != 0;
+        HuffmanTable deltaTable;
+        if (!isRaw)
+            readHuffmanTable(reader, deltaTable);
+
+        mSelectors.resize(selectorCount);
+        uint8_t prevRows[4] = {};
+        for (uint32_t i = 0; i < selectorCount; i++)
+        {
+            uint32_t selector = 0;
+            for (uint32_t y = 0; y < 4; y++)
+            {
+                const uint32_t row = isRaw || i == 0 ? reader.read(8) : prevRows[y] ^ decodeSymbol(reader, deltaTable);
+                prevRows[y] = uint8_t(row);
+                selector |= uint32_t(prevRows[y]) << (8 * y);
+            }
+            mSelectors[i] = selector;
+        }
+    }
+
+    // Huffman tables used for the slices.
+    {
+        BitReader reader(pTables, tablesByteLength);
+        readHuffmanTable(reader, mEndpointPredTable);
+        readHuffmanTable(reader, mEndpointDeltaTable);
+        readHuffmanTable(reader, mSelectorTable);
+        readHuffmanTable(reader, mSelectorHistoryRunTable);
+        mSelectorHistorySize = reader.read(13);
+        FALCOR_CHECK(mSelectorHistorySize > 0, "Invalid ETC1S selector history size.");
+    }
+}
+
+std::vector<uint8_t> ETC1SDecoder::decodeImage(uint32_t imageIndex, const uint8_t* pLevelData, size_t levelSize, uint32_t width, uint32_t height)
+    const
+{
+    FALCOR_CHECK(imageIndex < mImageDescs.size(), "ETC1S image index {} is out of range.", imageIndex);
+    const ImageDesc& desc = mImageDescs[imageIndex];
+    auto checkSlice = [&](uint32_t offset, uint32_t length)
+    { FALCOR_CHECK(offset <= levelSize && length <= levelSize - offset, "ETC1S slice of image {} is out of bounds.", imageIndex); };
+
+    std::vector<uint8_t> pixels(size_t(width) * height * 4, 0xff);
+    checkSlice(desc.rgbSliceByteOffset, desc.rgbSliceByteLength);
+    decodeSlice(pLevelData + desc.rgbSliceByteOffset, desc.rgbSliceByteLength, width, height, false, pixels.data());
+    if (desc.alphaSliceByteLength > 0)
+    {
+        checkSlice(desc.alphaSliceByteOffset, desc.alphaSliceByteLength);
+        decodeSlice(pLevelData + desc.alphaSliceByteOffset, desc.alphaSliceByteLength, width, height, true, pixels.data());
+    }
+    return pixels;
+}
+
+void ETC1SDecoder::decodeSlice(const uint8_t* pData, size_t size, uint32_t width, uint32_t height, bool isAlpha, uint8_t* pRGBA8) const
+{
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    const uint32_t endpointCount = (uint32_t)mEndpoints.size();
+    const uint32_t selectorCount = (uint32_t)mSelectors.size();
+    const uint32_t selectorRunSymbol = selectorCount + mSelectorHistorySize;
+
+    BitReader reader(pData, size);
+    SelectorHistory selectorHistory(mSelectorHistorySize);
+
+    // Endpoint indices of the previous and current block row, and the prediction bits for odd rows.
+    std::vector<uint32_t> prevRowEndpoints(blocksX, 0);
+    std::vector<uint32_t> rowEndpoints(blocksX, 0);
+    std::vector<uint8_t> oddRowPredBits(blocksX, 0);
+
+    uint32_t predBits = 0;
+    uint32_t prevPredSymbol = 0;
+    uint32_t predRepeatCount = 0;
+    uint32_t prevEndpoint = 0;
+    uint32_t selectorRunCount = 0;
+
+    for (uint32_t by = 0; by < blocksY; by++)
+    {
+        for (uint32_t bx = 0; bx < blocksX; bx++)
+        {
+            // Each endpoint prediction symbol holds the 2-bit predictors of a 2x2 group of blocks.
+            if (bx % 2 == 0)
+            {
+                if (by % 2 == 0)
+                {
+                    if (predRepeatCount > 0)
+                    {
+                        predRepeatCount--;
+                        predBits = prevPredSymbol;
+                    }
+                    else
+                    {
+                        predBits = decodeSymbol(reader, mEndpointPredTable);
+                        if (predBits == kEndpointPredRepeatSymbol)
+                        {
+                            predRepeatCount = reader.readVLC(kEndpointPredRepeatCountBits) + kEndpointPredMinRepeatCount - 1;
+                            predBits = prevPredSymbol;
+                        }
+                        else
+                        {
+                            prevPredSymbol = predBits;
+                        }
+                    }
+                    oddRowPredBits[bx] = uint8_t(predBits >> 4);
+                }
+                else
+                {
+                    predBits = oddRowPredBits[bx];
+                }
+            }
+
+            uint32_t endpoint;
+            const uint32_t pred = predBits & 3;
+            predBits >>= 2;
+            switch (pred)
+            {
+            case 0: // Left
+                FALCOR_CHECK(bx > 0, "Invalid ETC1S endpoint prediction.");
+                endpoint = prevEndpoint;
+                break;
+            case 1: // Upper
+                FALCOR_CHECK(by > 0, "Invalid ETC1S endpoint prediction.");
+                endpoint = prevRowEndpoints[bx];
+                break;
+            case 2: // Upper left
+                FALCOR_CHECK(bx > 0 && by > 0, "Invalid ETC1S endpoint prediction.");
+                endpoint = prevRowEndpoints[bx - 1];
+                break;
+            default: // Delta to the previous endpoint index
+                endpoint = prevEndpoint + decodeSymbol(reader, mEndpointDeltaTable);
+                if (endpoint >= endpointCount)
+                    endpoint -= endpointCount;
+                break;
+            }
+            FALCOR_CHECK(endpoint < endpointCount, "Invalid ETC1S endpoint index.");
+            rowEndpoints[bx] = endpoint;
+            prevEndpoint = endpoint;
+
+            // Selectors are coded directly, as an index into the history buffer, or as a run of the most recent entry.
+            uint32_t symbol;
+            if (selectorRunCount > 0)
+            {
+                selectorRunCount--;
+                symbol = selectorCount;
+            }
+            else
+            {
+                symbol = decodeSymbol(reader, mSelectorTable);
+                if (symbol == selectorRunSymbol)
+                {
+                    const uint32_t runSymbol = decodeSymbol(reader, mSelectorHistoryRunTable);
+                    selectorRunCount = runSymbol == kSelectorHistoryRunCodeCount - 1
+                                           ? reader.readVLC(kSelectorHistoryRunCountBits) + kSelectorHistoryMinRunCount
+                                           : runSymbol + kSelectorHistoryMinRunCount;
+                    FALCOR_CHECK(selectorRunCount <= blocksX * blocksY, "Invalid ETC1S selector run.");
+                    selectorRunCount--;
+                    symbol = selectorCount;
+                }
+            }
+
+            uint32_t selectorIndex;
+            if (symbol >= selectorCount)
+            {
+                const uint32_t historyIndex = symbol - selectorCount;
+                FALCOR_CHECK(historyIndex < selectorHistory.size(), "Invalid ETC1S selector history index.");
+                selectorIndex = selectorHistory[historyIndex];
+                selectorHistory.use(historyIndex);
+            }
+            else
+            {
+                selectorIndex = symbol;
+                selectorHistory.add(selectorIndex);
+            }
+
+            // Decode the block.
+            const Endpoint& e = mEndpoints[endpoint];
+            const uint32_t selector = mSelectors[selectorIndex];
+            uint8_t colors[4][3];
+            for (uint32_t s = 0; s < 4; s++)
+            {
+                for (uint32_t c = 0; c < 3; c++)
+                {
+                    const int base = (e.color[c] << 3) | (e.color[c] >> 2);
+                    colors[s][c] = (uint8_t)std::clamp(base + kIntensityTables[e.intensity][s], 0, 255);
+                }
+            }
+            for (uint32_t y = 0; y < 4 && by * 4 + y < height; y++)
+            {
+                for (uint32_t x = 0; x < 4 && bx * 4 + x < width; x++)
+                {
+                    const uint8_t* color = colors[(selector >> (2 * (y * 4 + x))) & 3];
+                    uint8_t* pPixel = pRGBA8 + (size_t(by * 4 + y) * width + bx * 4 + x) * 4;
+                    if (isAlpha)
+                        pPixel[3] = color[1];
+                    else
+                        std::memcpy(pPixel, color, 3);
+                }
+            }
+        }
+        std::swap(prevRowEndpoints, rowEndpoints);
+    }
+}
+
+namespace
+{
+struct UASTCMode
+{
+    uint8_t code;
+    uint8_t codeBits;
+    uint8_t hintBits; ///< Bits of transcoding hints following the mode code.
+    uint8_t subsetCount;
+    uint8_t planeCount;
+    uint8_t componentCount; ///< 2 (luminance, alpha), 3 (RGB) or 4 (RGBA).
+    uint8_t endpointRange; ///< ASTC endpoint quantization range (0 for 2 levels to 20 for 256 levels).
+    uint8_t weightBits;
+    uint8_t patternBits; ///< Bits of the partition pattern index.
+};
+
+const uint32_t kUASTCSolidMode = 8;
+const uint32_t kUASTCModeCount = 19;
+
+// clang-format off
+const UASTCMode kUASTCModes[kUASTCModeCount] = {
+    {0x01, 4, 15, 1, 1, 3, 19, 4, 0}, // 0: RGB, 192 level endpoints, 4-bit weights
+    {0x35, 6, 15, 1, 1, 3, 20, 2, 0}, // 1: RGB, 256 level endpoints, 2-bit weights
+    {0x1d, 5, 15, 2, 1, 3, 8,  3, 5}, // 2: RGB, 2 subsets
+    {0x03, 5, 15, 3, 1, 3, 7,  2, 4}, // 3: RGB, 3 subsets
+    {0x13, 5, 15, 2, 1, 3, 12, 2, 5}, // 4: RGB, 2 subsets
+    {0x0b, 5, 15, 1, 1, 3, 20, 3, 0}, // 5: RGB
+    {0x1b, 5, 15, 1, 2, 3, 18, 2, 0}, // 6: RGB, dual plane
+    {0x07, 5, 15, 2, 1, 3, 12, 2, 5}, // 7: RGB, 2 subsets with patterns shared with 3-subset BC7 patterns
+    {0x17, 5, 0,  1, 1, 4, 20, 0, 0}, // 8: Solid color
+    {0x0f, 5, 23, 2, 1, 4, 8,  2, 5}, // 9: RGBA, 2 subsets
+    {0x02, 3, 17, 1, 1, 4, 13, 4, 0}, // 10: RGBA
+    {0x00, 2, 17, 1, 2, 4, 13, 2, 0}, // 11: RGBA, dual plane
+    {0x06, 3, 17, 1, 1, 4, 19, 3, 0}, // 12: RGBA
+    {0x1f, 5, 23, 1, 2, 4, 20, 1, 0}, // 13: RGBA, dual plane
+    {0x0d, 5, 23, 1, 1, 4, 20, 2, 0}, // 14: RGBA
+    {0x05, 7, 23, 1, 1, 2, 20, 4, 0}, // 15: Luminance and alpha
+    {0x15, 6, 23, 2, 1, 2, 20, 2, 5}, // 16: Luminance and alpha, 2 subsets
+    {0x25, 6, 23, 1, 2, 2, 20, 2, 0}, // 17: Luminance and alpha, dual plane (alpha in the second plane)
+    {0x09, 4, 15, 1, 1, 3, 11, 5, 0}, // 18: RGB, 32 level endpoints, 5-bit weights
+};
+
+// ASTC partition seeds of the patterns that UASTC shares with BC7.
+const uint16_t kPartitionSeeds2[30] = {
+    28, 20, 16, 29, 91, 9, 107, 72, 149, 204, 50, 114, 496, 17, 78, 39,
+    252, 828, 43, 156, 116, 210, 476, 273, 684, 359, 246, 195, 694, 524,
+};
+const uint16_t kPartitionSeeds3[11] = {260, 74, 32, 156, 183, 15, 745, 0, 335, 902, 254};
+const uint16_t kMode7PartitionSeeds[19] = {36, 48, 61, 137, 161, 183, 226, 281, 302, 307, 479, 495, 593, 594, 605, 799, 812, 988, 993};
+// clang-format on
+
+/// Number of bits, trits and quints of the ASTC quantization ranges.
+struct QuantizationRange
+{
+    uint8_t bits;
+    uint8_t trits;
+    uint8_t quints;
+};
+
+const QuantizationRange kQuantizationRanges[21] = {
+    {1, 0, 0}, {0, 1, 0}, {2, 0, 0}, {0, 0, 1}, {1, 1, 0}, {3, 0, 0}, {1, 0, 1}, {2, 1, 0}, {4, 0, 0}, {2, 0, 1}, {3, 1, 0},
+    {5, 0, 0}, {3, 0, 1}, {4, 1, 0}, {6, 0, 0}, {4, 0, 1}, {5, 1, 0}, {7, 0, 0}, {5, 0, 1}, {6, 1, 0}, {8, 0, 0},
+};
+
+uint32_t readBits(const uint8_t* pBlock, uint32_t& offset, uint32_t count)
+{
+    uint32_t value = 0;
+    for (uint32_t i = 0; i < count; i++, offset++)
+        value |= ((pBlock[offset / 8] >> (offset % 8)) & 1) << i;
+    return value;
+}
+
+/// ASTC partition function for small (less than 31 texels) blocks.
+uint32_t selectPartition(uint32_t seed, uint32_t x, uint32_t y, uint32_t partitionCount)
+{
+    x <<= 1;
+    y <<= 1;
+    seed += (partitionCount - 1) * 1024;
+
+    uint32_t rnum = seed;
+    rnum ^= rnum >> 15;
+    rnum -= rnum << 17;
+    rnum += rnum << 7;
+    rnum += rnum << 4;
+    rnum ^= rnum >> 5;
+    rnum += rnum << 16;
+    rnum ^= rnum >> 7;
+    rnum ^= rnum >> 3;
+    rnum ^= rnum << 6;
+    rnum ^= rnum >> 17;
+
+    uint32_t s[8];
+    for (uint32_t i = 0; i < 8; i++)
+    {
+        s[i] = (rnum >> (4 * i)) & 0xf;
+        s[i] *= s[i];
+    }
+    uint32_t sh1, sh2;
+    if (seed & 1)
+    {
+        sh1 = seed & 2 ? 4 : 5;
+        sh2 = partitionCount == 3 ? 6 : 5;
+    }
+    else
+    {
+        sh1 = partitionCount == 3 ? 6 : 5;
+        sh2 = seed & 2 ? 4 : 5;
+    }
+    for (uint32_t i = 0; i < 8; i++)
+        s[i] >>= i % 2 == 0 ? sh1 : sh2;
+
+    // The z coordinate is zero for 2D blocks, so only the constant terms of the third dimension remain.
+    const uint32_t a = (s[0] * x + s[1] * y + (rnum >> 14)) & 0x3f;
+    const uint32_t b = (s[2] * x + s[3] * y + (rnum >> 10)) & 0x3f;
+    const uint32_t c = partitionCount < 3 ? 0 : (s[4] * x + s[5] * y + (rnum >> 6)) & 0x3f;
+
+    if (a >= b && a >= c)
+        return 0;
+    if (b >= c)
+        return 1;
+    return 2;
+}
+
+struct PartitionPattern
+{
+    uint8_t subsets[16];
+    uint8_t anchors[3]; ///< First texel of each subset. Its weight is stored with one bit less.
+};
+
+template<size_t N>
+std::array<PartitionPattern, N> createPatterns(const uint16_t (&seeds)[N], uint32_t partitionCount)
+{
+    std::array<PartitionPattern, N> patterns;
+    for (size_t i = 0; i < N; i++)
+    {
+        bool found[3] = {};
+        for (uint32_t t = 0; t < 16; t++)
+        {
+            const uint32_t subset = selectPartition(seeds[i], t % 4, t / 4, partitionCount);
+            patterns[i].subsets[t] = (uint8_t)subset;
+            if (!found[subset])
+                patterns[i].anchors[subset] = (uint8_t)t;
+            found[subset] = true;
+        }
+    }
+    return patterns;
+}
+
+/// Expand a value to more bits by repeating its bit pattern.
+uint32_t replicateBits(uint32_t value, uint32_t bits, uint32_t targetBits)
+{
+    uint32_t result = 0;
+    for (int shift = int(targetBits - bits); shift > -int(bits); shift -= int(bits))
+        result |= shift >= 0 ? value << shift : value >> -shift;
+    return result;
+}
+
+/// Unquantize an ASTC color endpoint value to 8 bits.
+uint32_t unquantizeEndpoint(uint32_t range, uint32_t value)
+{
+    const QuantizationRange& q = kQuantizationRanges[range];
+    if (q.trits == 0 && q.quints == 0)
+        return replicateBits(value, q.bits, 8);
+
+    // Trits and quints are unquantized with bit manipulations that scatter the bits over 9 bits.
+    const uint32_t d = value >> q.bits;
+    const uint32_t m = (value & ((1u << q.bits) - 1)) >> 1;
+    const uint32_t a = (value & 1) ? 0x1ff : 0;
+    uint32_t b = 0, c = 0;
+    if (q.trits)
+    {
+        switch (q.bits)
+        {
+        case 1: c = 204; break;
+        case 2: b = (m << 8) | (m << 4) | (m << 2) | (m << 1); c = 93; break;
+        case 3: b = (m << 7) | (m << 2) | m; c = 44; break;
+        case 4: b = (m << 6) | m; c = 22; break;
+        case 5: b = (m << 5) | (m >> 2); c = 11; break;
+        case 6: b = (m << 4) | (m >> 4); c = 5; break;
+        }
+    }
+    else
+    {
+        switch (q.bits)
+        {
+        case 1: c = 113; break;
+        case 2: b = (m << 8) | (m << 3) | (m << 2); c = 54; break;
+        case 3: b = (m << 7) | (m << 1) | (m >> 1); c = 26; break;
+        case 4: b = (m << 6) | (m >> 1); c = 13; break;
+        case 5: b = (m << 5) | (m >> 3); c = 6; break;
+        }
+    }
+    const uint32_t t = (d * c + b) ^ a;
+    return (a & 0x80) | (t >> 2);
+}
+
+/// Unquantize a weight to the range [0, 64].
+uint32_t unquantizeWeight(uint32_t bits, uint32_t value)
+{
+    const uint32_t result = replicateBits(value, bits, 6);
+    return result > 32 ? result + 1 : result;
+}
+} // namespace
+
+void UASTCDecoder::decodeBlock(const uint8_t* pBlock, uint8_t* pRGBA8)
+{
+    static const auto kModeTable = []()
+    {
+        // The mode is Huffman coded in the first 7 bits, with the first bit in the least significant bit.
+        std::array<uint8_t, 128> table;
+        table.fill(0xff);
+        for (uint32_t mode = 0; mode < kUASTCModeCount; mode++)
+            for (uint32_t i = 0; i < 128; i++)
+                if ((i & ((1u << kUASTCModes[mode].codeBits) - 1)) == kUASTCModes[mode].code)
+                    table[i] = (uint8_t)mode;
+        return table;
+    }();
+    static const auto kPatterns2 = createPatterns(kPartitionSeeds2, 2);
+    static const auto kPatterns3 = createPatterns(kPartitionSeeds3, 3);
+    static const auto kMode7Patterns = createPatterns(kMode7PartitionSeeds, 2);
+
+    const uint32_t modeIndex = kModeTable[pBlock[0] & 0x7f];
+    if (modeIndex >= kUASTCModeCount)
+        FALCOR_THROW("Invalid UASTC block mode.");
+    const UASTCMode& mode = kUASTCModes[modeIndex];
+    uint32_t offset = mode.codeBits;
+
+    if (modeIndex == kUASTCSolidMode)
+    {
+        uint8_t color[4];
+        for (uint32_t c = 0; c < 4; c++)
+            color[c] = (uint8_t)readBits(pBlock, offset, 8);
+        for (uint32_t t = 0; t < 16; t++)
+            std::memcpy(pRGBA8 + t * 4, color, 4);
+        return;
+    }
+    offset += mode.hintBits;
+
+    // Component used by the second plane (color component selector).
+    uint32_t ccs = 0;
+    if (mode.planeCount == 2)
+        ccs = mode.componentCount == 2 ? 3 : readBits(pBlock, offset, 2);
+
+    static const PartitionPattern kSingleSubset = {};
+    const PartitionPattern* pPattern = &kSingleSubset;
+    if (mode.subsetCount > 1)
+    {
+        const uint32_t patternIndex = readBits(pBlock, offset, mode.patternBits);
+        const PartitionPattern* pPatterns = modeIndex == 7 ? kMode7Patterns.data() : (mode.subsetCount == 3 ? kPatterns3.data() : kPatterns2.data());
+        const size_t patternCount = modeIndex == 7 ? kMode7Patterns.size() : (mode.subsetCount == 3 ? kPatterns3.size() : kPatterns2.size());
+        if (patternIndex >= patternCount)
+            FALCOR_THROW("Invalid UASTC partition pattern {}.", patternIndex);
+        pPattern = &pPatterns[patternIndex];
+    }
+
+    // Endpoints are integer sequence encoded, with all trit or quint groups stored before the remaining bits.
+    const uint32_t valueCount = mode.subsetCount * mode.componentCount * 2;
+    const QuantizationRange& range = kQuantizationRanges[mode.endpointRange];
+    uint32_t groups[4] = {};
+    const uint32_t groupSize = range.trits ? 5 : 3;
+    if (range.trits || range.quints)
+    {
+        const uint8_t kTritGroupBits[6] = {0, 2, 4, 5, 7, 8};
+        const uint8_t kQuintGroupBits[4] = {0, 3, 5, 7};
+        for (uint32_t i = 0; i * groupSize < valueCount; i++)
+        {
+            const uint32_t count = std::min(groupSize, valueCount - i * groupSize);
+            groups[i] = readBits(pBlock, offset, range.trits ? kTritGroupBits[count] : kQuintGroupBits[count]);
+        }
+    }
+    uint32_t values[18];
+    for (uint32_t i = 0; i < valueCount; i++)
+    {
+        uint32_t value = readBits(pBlock, offset, range.bits);
+        if (range.trits || range.quints)
+        {
+            const uint32_t base = range.trits ? 3 : 5;
+            const uint32_t digit = groups[i / groupSize] % base;
+            groups[i / groupSize] /= base;
+            value |= digit << range.bits;
+        }
+        values[i] = unquantizeEndpoint(mode.endpointRange, value);
+    }
+
+    // Weights are stored in texel order, interleaved for dual plane blocks. Anchor weights have an implied zero MSB.
+    uint32_t weights[32];
+    const uint32_t weightCount = 16 * mode.planeCount;
+    for (uint32_t i = 0; i < weightCount; i++)
+    {
+        const uint32_t texel = i / mode.planeCount;
+        bool isAnchor = false;
+        for (uint32_t s = 0; s < mode.subsetCount; s++)
+            isAnchor |= pPattern->anchors[s] == texel;
+        const uint32_t bitCount = mode.weightBits - (isAnchor ? 1 : 0);
+        weights[i] = unquantizeWeight(mode.weightBits, readBits(pBlock, offset, bitCount));
+    }
+
+    // Decode the endpoint pairs (ASTC color endpoint modes 4, 8 and 12).
+    uint32_t endpoints[3][2][4];
+    for (uint32_t s = 0; s < mode.subsetCount; s++)
+    {
+        const uint32_t* v = values + s * mode.componentCount * 2;
+        auto& e = endpoints[s];
+        if (mode.componentCount == 2)
+        {
+            for (uint32_t i = 0; i < 2; i++)
+                e[i][0] = e[i][1] = e[i][2] = v[i], e[i][3] = v[2 + i];
+            continue;
+        }
+        const uint32_t alpha0 = mode.componentCount == 4 ? v[6] : 255;
+        const uint32_t alpha1 = mode.componentCount == 4 ? v[7] : 255;
+        if (v[1] + v[3] + v[5] >= v[0] + v[2] + v[4])
+        {
+            for (uint32_t i = 0; i < 2; i++)
+                e[i][0] = v[i], e[i][1] = v[2 + i], e[i][2] = v[4 + i];
+            e[0][3] = alpha0, e[1][3] = alpha1;
+        }
+        else
+        {
+            // Blue contraction, with swapped endpoints.
+            for (uint32_t i = 0; i < 2; i++)
+                e[i][0] = (v[1 - i] + v[5 - i]) >> 1, e[i][1] = (v[3 - i] + v[5 - i]) >> 1, e[i][2] = v[5 - i];
+            e[0][3] = alpha1, e[1][3] = alpha0;
+        }
+    }
+
+    for (uint32_t t = 0; t < 16; t++)
+    {
+        const auto& e = endpoints[pPattern->subsets[t]];
+        for (uint32_t c = 0; c < 4; c++)
+        {
+            const uint32_t w = weights[t * mode.planeCount + (mode.planeCount == 2 && c == ccs ? 1 : 0)];
+            const uint32_t c0 = e[0][c] * 257, c1 = e[1][c] * 257;
+            pRGBA8[t * 4 + c] = uint8_t(((c0 * (64 - w) + c1 * w + 32) >> 6) >> 8);
+        }
+    }
+}
+
+std::vector<uint8_t> UASTCDecoder::decode(const uint8_t* pData, size_t size, uint32_t width, uint32_t height)
+{
+    const uint32_t blocksX = (width + 3) / 4;
+    const uint32_t blocksY = (height + 3) / 4;
+    FALCOR_CHECK(size == size_t(blocksX) * blocksY * 16, "UASTC data has size {}, expected {}.", size, size_t(blocksX) * blocksY * 16);
+
+    std::vector<uint8_t> pixels(size_t(width) * height * 4);
+    uint8_t block[16 * 4];
+    for (uint32_t by = 0; by < blocksY; by++)
+    {
+        for (uint32_t bx = 0; bx < blocksX; bx++)
+        {
+            decodeBlock(pData + (size_t(by) * blocksX + bx) * 16, block);
+            for (uint32_t y = 0; y < 4 && by * 4 + y < height; y++)
+            {
+                const uint32_t count = std::min(4u, width - bx * 4);
+                std::memcpy(pixels.data() + (size_t(by * 4 + y) * width + bx * 4) * 4, block + y * 16, count * 4);
+            }
+        }
+    }
+    return pixels;
+}
+
+} // namespace Falcor
@@ -0,0 +1,144 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Decoder for ETC1S images stored with BasisLZ supercompression (Basis Universal).
+ *
+ * The endpoint and selector codebooks and the Huffman tables are shared by all images of a KTX2 file and are read
+ * from the supercompression global data. Images are decoded to RGBA8. Video (P-frame) images are not supported.
+ */
+class FALCOR_API ETC1SDecoder
+{
+public:
+    /// Location of the slices of an image, relative to the start of its mip level data.
+    struct ImageDesc
+    {
+        uint32_t flags = 0;
+        uint32_t rgbSliceByteOffset = 0;
+        uint32_t rgbSliceByteLength = 0;
+        uint32_t alphaSliceByteOffset = 0;
+        uint32_t alphaSliceByteLength = 0;
+    };
+
+    /**
+     * Read the supercompression global data.
+     * Throws a RuntimeError if the data is malformed or uses unsupported features.
+     * @param[in] pData Global data.
+     * @param[in] size Size of the global data in bytes.
+     * @param[in] imageCount Number of images in the file, i.e. the number of image descriptions in the global data.
+     */
+    ETC1SDecoder(const uint8_t* pData, size_t size, uint32_t imageCount);
+
+    uint32_t getImageCount() const { return (uint32_t)mImageDescs.size(); }
+    const ImageDesc& getImageDesc(uint32_t imageIndex) const { return mImageDescs[imageIndex]; }
+
+    /**
+     * Decode an image. The alpha channel is read from the alpha slice, or is opaque if the image has none.
+     * Throws a RuntimeError if the slice data is malformed.
+     * @param[in] imageIndex Image index. Images are ordered by mip level, array layer and face.
+     * @param[in] pLevelData Data of the mip level containing the image.
+     * @param[in] levelSize Size of the mip level data in bytes.
+     * @param[in] width Image width in pixels.
+     * @param[in] height Image height in pixels.
+     * @return Pixels with 4 bytes per pixel and tightly packed rows.
+     */
+    std::vector<uint8_t> decodeImage(uint32_t imageIndex, const uint8_t* pLevelData, size_t levelSize, uint32_t width, uint32_t height) const;
+
+private:
+    /// Canonical Huffman code, decoded with a lookup table indexed by the next (up to 16) bits of the stream.
+    struct HuffmanTable
+    {
+        struct Entry
+        {
+            uint16_t symbol;
+            uint8_t bitCount;
+        };
+
+        uint32_t maxBits = 0;
+        uint32_t symbolCount = 0;
+        std::vector<Entry> entries;
+    };
+
+    struct Endpoint
+    {
+        uint8_t color[3]; ///< 5-bit color.
+        uint8_t intensity; ///< Index of the intensity modifier table.
+    };
+
+    class BitReader;
+    static void readHuffmanTable(BitReader& reader, HuffmanTable& table);
+    static uint32_t decodeSymbol(BitReader& reader, const HuffmanTable& table);
+    void decodeSlice(const uint8_t* pData, size_t size, uint32_t width, uint32_t height, bool isAlpha, uint8_t* pRGBA8) const;
+
+    std::vector<ImageDesc> mImageDescs;
+    std::vector<Endpoint> mEndpoints;
+    std::vector<uint32_t> mSelectors; ///< 2-bit selectors of the 4x4 pixels in row-major order.
+
+    HuffmanTable mEndpointPredTable;
+    HuffmanTable mEndpointDeltaTable;
+    HuffmanTable mSelectorTable;
+    HuffmanTable mSelectorHistoryRunTable;
+    uint32_t mSelectorHistorySize = 0;
+};
+
+/**
+ * Decoder for UASTC blocks (Basis Universal).
+ *
+ * UASTC is a subset of ASTC 4x4 with a simpler bit layout. Blocks are decoded with the ASTC LDR rules to RGBA8.
+ * The transcoding hints stored in the blocks are ignored.
+ */
+class FALCOR_API UASTCDecoder
+{
+public:
+    /**
+     * Decode a single block.
+     * Throws a RuntimeError if the block uses a reserved mode.
+     * @param[in] pBlock 16 bytes of block data.
+     * @param[out] pRGBA8 Pixels of the 4x4 block in row-major order, 4 bytes per pixel.
+     */
+    static void decodeBlock(const uint8_t* pBlock, uint8_t* pRGBA8);
+
+    /**
+     * Decode an image.
+     * Throws a RuntimeError if the data has the wrong size or a block is invalid.
+     * @param[in] pData Blocks in row-major order.
+     * @param[in] size Size of the block data in bytes.
+     * @param[in] width Image width in pixels.
+     * @param[in] height Image height in pixels.
+     * @return Pixels with 4 bytes per pixel and tightly packed rows.
+     */
+    static std::vector<uint8_t> decode(const uint8_t* pData, size_t size, uint32_t width, uint32_t height);
+};
+} // namespace Falcor
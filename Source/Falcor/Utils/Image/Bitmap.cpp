@@ -232,6 +232,103 @@ static FIBITMAP* convertToRGBA16Float(FIBITMAP* pDib)
     }
     return pNew;
 }
+/**
+ * Describes where the RGBA channels of a texel are stored, in units of the channel type.
+ */
+struct ChannelLayout
+{
+    uint32_t texelStride; ///< Number of channels per texel.
+    uint32_t r, g, b, a;  ///< Channel offsets. Alpha is only valid if hasAlpha is set.
+    bool hasAlpha;
+};
+
+/**
+ * Returns the channel layout for formats supported by Bitmap::reduceChannels(), or false if unsupported.
+ */
+static bool getChannelLayout(ResourceFormat format, ChannelLayout& layout)
+{
+    switch (format)
+    {
+    case ResourceFormat::BGRA8Unorm:
+        layout = {4, 2, 1, 0, 3, true};
+        return true;
+    case ResourceFormat::BGRX8Unorm:
+        layout = {4, 2, 1, 0, 3, false};
+        return true;
+    case ResourceFormat::RGBA8Unorm:
+    case ResourceFormat::RGBA16Float:
+    case ResourceFormat::RGBA32Float:
+        layout = {4, 0, 1, 2, 3, true};
+        return true;
+    case ResourceFormat::RGB32Float:
+        layout = {3, 0, 1, 2, 0, false};
+        return true;
+    default:
+        return false;
+    }
+}
+
+/**
+ * Which channel reductions are lossless for an image. Channels are compared bitwise.
+ */
+struct ChannelUsage
+{
+    bool grayscale = true; ///< R, G and B are equal in all texels.
+    bool opaque = true;    ///< Alpha is one in all texels.
+    bool greenZero = true; ///< G is zero in all texels.
+    bool blueZero = true;  ///< B is zero in all texels.
+};
+
+template<typename T>
+static ChannelUsage getChannelUsage(const Bitmap& bitmap, const ChannelLayout& layout, T one)
+{
+    ChannelUsage usage;
+    for (uint32_t y = 0; y < bitmap.getHeight(); y++)
+    {
+        const T* pRow = reinterpret_cast<const T*>(bitmap.getData() + (size_t)y * bitmap.getRowPitch());
+        for (uint32_t x = 0; x < bitmap.getWidth(); x++)
+        {
+            const T* pTexel = pRow + (size_t)x * layout.texelStride;
+            T r = pTexel[layout.r], g = pTexel[layout.g], b = pTexel[layout.b];
+            usage.grayscale = usage.grayscale && r == g && r == b;
+            usage.greenZero = usage.greenZero && g == T(0);
+            usage.blueZero = usage.blueZero && b == T(0);
+            usage.opaque = usage.opaque && (!layout.hasAlpha || pTexel[layout.a] == one);
+        }
+        if (!usage.grayscale && !usage.greenZero && !usage.blueZero && !usage.opaque)
+            break;
+    }
+    return usage;
+}
+
+/**
+ * Copy up to two channels of each texel to a tightly packed destination image.
+ */
+template<typename T>
+static void copyChannels(
+    const Bitmap& src,
+    const ChannelLayout& layout,
+    uint32_t c0,
+    uint32_t c1,
+    uint32_t dstChannelCount,
+    uint8_t* pDst,
+    uint32_t dstRowPitch
+)
+{
+    for (uint32_t y = 0; y < src.getHeight(); y++)
+    {
+        const T* pSrcRow = reinterpret_cast<const T*>(src.getData() + (size_t)y * src.getRowPitch());
+        T* pDstRow = reinterpret_cast<T*>(pDst + (size_t)y * dstRowPitch);
+        for (uint32_t x = 0; x < src.getWidth(); x++)
+        {
+            const T* pTexel = pSrcRow + (size_t)x * layout.texelStride;
+            pDstRow[x * dstChannelCount] = pTexel[c0];
+            if (dstChannelCount == 2)
+                pDstRow[x * dstChannelCount + 1] = pTexel[c1];
+        }
+    }
+}
+
 Bitmap::UniqueConstPtr Bitmap::create(uint32_t width, uint32_t height, ResourceFormat format, const uint8_t* pData)
 {
     return Bitmap::UniqueConstPtr(new Bitmap(width, height, format, pData));
@@ -374,9 +471,83 @@ Bitmap::UniqueConstPtr Bitmap::createFromFile(const std::filesystem::path& path,
         pBmp->getData(), pDib, pBmp->getRowPitch(), bpp, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, isTopDown
     );
     FreeImage_Unload(pDib);
+
+    if (is_set(importFlags, ImportFlags::ReduceChannels))
+    {
+        if (auto pReduced = reduceChannels(*pBmp))
+            pBmp = std::move(pReduced);
+    }
+
     return pBmp;
 }
 
+Bitmap::UniqueConstPtr Bitmap::reduceChannels(const Bitmap& bitmap)
+{
+    ResourceFormat format = bitmap.getFormat();
+
+    // Images that are already stored in a single channel are left as they are, so they keep sampling as (r, 0, 0, 1).
+    ChannelLayout layout;
+    if (!getChannelLayout(format, layout))
+        return nullptr;
+
+    // Pick the reduced formats matching the channel type of the source.
+    uint32_t channelBits = getNumChannelBits(format, 0);
+    ResourceFormat formatR = channelBits == 8 ? ResourceFormat::R8Unorm
+                             : channelBits == 16 ? ResourceFormat::R16Float
+                                                 : ResourceFormat::R32Float;
+    ResourceFormat formatRG = channelBits == 8 ? ResourceFormat::RG8Unorm
+                              : channelBits == 16 ? ResourceFormat::RG16Float
+                                                  : ResourceFormat::RG32Float;
+
+    ChannelUsage usage;
+    if (channelBits == 8)
+        usage = getChannelUsage<uint8_t>(bitmap, layout, 0xff);
+    else if (channelBits == 16)
+        usage = getChannelUsage<uint16_t>(bitmap, layout, 0x3c00); // 1.0 in fp16
+    else
+        usage = getChannelUsage<uint32_t>(bitmap, layout, 0x3f800000); // 1.0 in fp32
+
+    // Choose the smallest lossless representation. Formats without G, B or A channels sample as 0, 0 and 1.
+    ResourceFormat reducedFormat = ResourceFormat::Unknown;
+    ChannelSwizzle swizzle = ChannelSwizzle::Identity;
+    uint32_t c0 = layout.r;
+    uint32_t c1 = layout.g;
+    if (usage.grayscale && usage.opaque)
+    {
+        reducedFormat = formatR;
+        swizzle = ChannelSwizzle::Grayscale;
+    }
+    else if (usage.greenZero && usage.blueZero && usage.opaque)
+    {
+        reducedFormat = formatR;
+    }
+    else if (usage.grayscale)
+    {
+        reducedFormat = formatRG;
+        swizzle = ChannelSwizzle::GrayscaleAlpha;
+        c1 = layout.a;
+    }
+    else if (usage.blueZero && usage.opaque)
+    {
+        reducedFormat = formatRG;
+    }
+    else
+    {
+        return nullptr;
+    }
+
+    auto pReduced = new Bitmap(bitmap.getWidth(), bitmap.getHeight(), reducedFormat);
+    pReduced->mChannelSwizzle = swizzle;
+    uint32_t channelCount = getFormatChannelCount(reducedFormat);
+    if (channelBits == 8)
+        copyChannels<uint8_t>(bitmap, layout, c0, c1, channelCount, pReduced->getData(), pReduced->getRowPitch());
+    else if (channelBits == 16)
+        copyChannels<uint16_t>(bitmap, layout, c0, c1, channelCount, pReduced->getData(), pReduced->getRowPitch());
+    else
+        copyChannels<uint32_t>(bitmap, layout, c0, c1, channelCount, pReduced->getData(), pReduced->getRowPitch());
+    return UniqueConstPtr(pReduced);
+}
+
 Bitmap::Bitmap(uint32_t width, uint32_t height, ResourceFormat format)
     : mWidth(width), mHeight(height), mRowPitch(getFormatRowPitch(format, width)), mFormat(format)
 {
@@ -493,6 +664,7 @@ FileDialogFilterVec Bitmap::getFileDialogFilters(ResourceFormat format)
     if (format == ResourceFormat::Unknown)
     {
         filters.push_back({"hdr", "High Dynamic Range"});
+        filters.push_back({"ktx2", "Khronos Texture"});
     }
     return filters;
 }
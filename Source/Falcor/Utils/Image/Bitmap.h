@@ -54,6 +54,19 @@ public:
     {
         None = 0u,                  ///< Default.
         ConvertToFloat16 = 1u << 0, ///< Convert HDR images to 16-bit float per channel on import.
+        ReduceChannels = 1u << 1,   ///< Store images using one or two channels if that is lossless. See reduceChannels().
+        BlockCompress = 1u << 2,    ///< Transcode uncompressed 8-bit KTX2 images to BC4, BC5 or BC7 on load.
+    };
+
+    /**
+     * Describes how the stored channels of a bitmap map to RGBA when sampled.
+     * Formats without G, B or A channels sample them as 0, 0 and 1.
+     */
+    enum class ChannelSwizzle : uint32_t
+    {
+        Identity = 0,       ///< Channels are used as stored.
+        Grayscale = 1,      ///< R holds grayscale color. Samples as (r, r, r, 1).
+        GrayscaleAlpha = 2, ///< R holds grayscale color and G holds alpha. Samples as (r, r, r, g).
     };
 
     enum class FileFormat
@@ -91,6 +104,17 @@ public:
      */
     static UniqueConstPtr createFromFile(const std::filesystem::path& path, bool isTopDown, ImportFlags importFlags = ImportFlags::None);
 
+    /**
+     * Create a copy of a bitmap stored with the fewest channels that hold its content.
+     * Grayscale RGB is stored in a single channel (plus alpha if not opaque), and RGB(A) images with zero trailing color
+     * channels and opaque alpha drop those channels. The reduction is lossless: sampling the reduced bitmap with its
+     * channel swizzle gives the same values as the original. Only images that are reduced get a channel swizzle.
+     * Supports 8-bit unorm (reduced to R8Unorm/RG8Unorm) and 16/32-bit float formats (reduced to R/RG with the same precision).
+     * @param[in] bitmap Bitmap to reduce.
+     * @return The reduced bitmap, or nullptr if the format is unsupported or no channels can be dropped.
+     */
+    static UniqueConstPtr reduceChannels(const Bitmap& bitmap);
+
     /**
      * Store a memory buffer to a file.
      * @param[in] path Path to write to.
@@ -138,6 +162,9 @@ public:
     /// Get the data size in bytes
     uint32_t getSize() const { return mSize; }
 
+    /// Get how the stored channels map to RGBA
+    ChannelSwizzle getChannelSwizzle() const { return mChannelSwizzle; }
+
     /**
      * Get the file dialog filter vec for images.
      * @param[in] format If set to ResourceFormat::Unknown, will return all the supported image file formats. If set to something else, will
@@ -167,6 +194,7 @@ protected:
     uint32_t mRowPitch = 0; ///< Row pitch in bytes.
     uint32_t mSize = 0;     ///< Total size in bytes.
     ResourceFormat mFormat = ResourceFormat::Unknown;
+    ChannelSwizzle mChannelSwizzle = ChannelSwizzle::Identity;
 };
 
 FALCOR_ENUM_CLASS_OPERATORS(Bitmap::ExportFlags);
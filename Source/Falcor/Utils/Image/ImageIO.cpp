@@ -26,23 +26,34 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "ImageIO.h"
+#include "BCEncoder.h"
+#include "KTX2File.h"
 #include "Core/Error.h"
 #include "Core/API/Device.h"
 #include "Core/API/CopyContext.h"
 #include "Core/API/NativeFormats.h"
 #include "Core/Platform/MemoryMappedFile.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Math/Common.h"
+#include "Utils/Math/Float16.h"
 #include "Utils/Math/ScalarMath.h"
 #include "Utils/Logger.h"
+#include "Utils/Color/ColorHelpers.slang"
 
 #include <dds_header/DDSHeader.h>
 #include <nvtt/nvtt.h>
 
+#include <algorithm>
+#include <array>
+#include <cmath>
 #include <filesystem>
 
 namespace Falcor
 {
 namespace
 {
+static constexpr bool kTopDown = true; // Memory layout when loading from file
+
 struct ImportData
 {
     // Commonly used values converted or casted for cleaner access
@@ -552,6 +563,164 @@ void loadDDS(const std::filesystem::path& path, bool loadAsSrgb, ImportData& dat
     data.imageData.resize(imageSize);
     std::memcpy(data.imageData.data(), reinterpret_cast<const uint8_t*>(file.getData()) + headerSize, imageSize);
 }
+
+/// Get the BC format that 8-bit images of the given format are transcoded to, or Unknown if not transcoded.
+ResourceFormat getBlockCompressedFormat(ResourceFormat format)
+{
+    switch (format)
+    {
+    case ResourceFormat::R8Unorm:
+        return ResourceFormat::BC4Unorm;
+    case ResourceFormat::RG8Unorm:
+        return ResourceFormat::BC5Unorm;
+    case ResourceFormat::RGBA8Unorm:
+    case ResourceFormat::BGRA8Unorm:
+        return ResourceFormat::BC7Unorm;
+    case ResourceFormat::RGBA8UnormSrgb:
+    case ResourceFormat::BGRA8UnormSrgb:
+        return ResourceFormat::BC7UnormSrgb;
+    default:
+        return ResourceFormat::Unknown;
+    }
+}
+
+/// Convert 8-bit texels to RGBA. Missing color channels are set to zero and missing alpha to one.
+std::vector<uint8_t> convertToRGBA8(const uint8_t* pData, size_t texelCount, ResourceFormat format)
+{
+    const uint32_t channelCount = getFormatChannelCount(format);
+    const bool isBGRA = format == ResourceFormat::BGRA8Unorm || format == ResourceFormat::BGRA8UnormSrgb;
+    std::vector<uint8_t> result(texelCount * 4);
+    for (size_t i = 0; i < texelCount; i++)
+    {
+        uint8_t rgba[4] = {0, 0, 0, 0xff};
+        std::copy_n(pData + i * channelCount, channelCount, rgba);
+        if (isBGRA)
+            std::swap(rgba[0], rgba[2]);
+        std::copy_n(rgba, 4, result.data() + i * 4);
+    }
+    return result;
+}
+
+/// Downsample an RGBA8 image with a 2x2 box filter. For sRGB images, the color channels are averaged in linear space.
+std::vector<uint8_t> downsampleRGBA8(const std::vector<uint8_t>& image, uint32_t width, uint32_t height, bool isSrgb)
+{
+    static const auto kSrgbToLinear = []()
+    {
+        std::array<float, 256> table;
+        for (uint32_t i = 0; i < 256; i++)
+            table[i] = sRGBToLinear(i / 255.f);
+        return table;
+    }();
+
+    const uint32_t dstWidth = std::max(width / 2, 1u);
+    const uint32_t dstHeight = std::max(height / 2, 1u);
+    std::vector<uint8_t> result(size_t(dstWidth) * dstHeight * 4);
+    for (uint32_t y = 0; y < dstHeight; y++)
+    {
+        for (uint32_t x = 0; x < dstWidth; x++)
+        {
+            float sum[4] = {};
+            for (uint32_t i = 0; i < 4; i++)
+            {
+                const uint32_t sx = std::min(2 * x + (i & 1), width - 1);
+                const uint32_t sy = std::min(2 * y + (i >> 1), height - 1);
+                const uint8_t* pSrc = image.data() + (size_t(sy) * width + sx) * 4;
+                for (uint32_t c = 0; c < 4; c++)
+                    sum[c] += (isSrgb && c < 3) ? kSrgbToLinear[pSrc[c]] : pSrc[c] / 255.f;
+            }
+            uint8_t* pDst = result.data() + (size_t(y) * dstWidth + x) * 4;
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                float value = sum[c] / 4.f;
+                if (isSrgb && c < 3)
+                    value = linearToSRGB(value);
+                pDst[c] = (uint8_t)std::lround(std::clamp(value, 0.f, 1.f) * 255.f);
+            }
+        }
+    }
+    return result;
+}
+
+/// Get the size in bytes of a 2D image.
+size_t getImageSize(ResourceFormat format, uint32_t width, uint32_t height)
+{
+    return size_t(div_round_up(width, getFormatWidthCompressionRatio(format))) * div_round_up(height, getFormatHeightCompressionRatio(format)) *
+           getFormatBytesPerBlock(format);
+}
+
+/**
+ * Downsample an uncompressed image with a 2x2 box filter, matching the mip generation on the GPU.
+ * Supports 8-bit and 16-bit unorm and 16-bit and 32-bit float formats. For sRGB images, the color channels are averaged in linear space.
+ */
+std::vector<uint8_t> downsampleImage(const std::vector<uint8_t>& image, uint32_t width, uint32_t height, ResourceFormat format)
+{
+    const FormatType type = getFormatType(format);
+    const uint32_t channelCount = getFormatChannelCount(format);
+    const uint32_t channelBits = getNumChannelBits(format, 0);
+    const bool isUnorm = (type == FormatType::Unorm || type == FormatType::UnormSrgb) && (channelBits == 8 || channelBits == 16);
+    const bool isFloat = type == FormatType::Float && (channelBits == 16 || channelBits == 32);
+    FALCOR_CHECK(
+        !isCompressedFormat(format) && (isUnorm || isFloat) && getFormatBytesPerBlock(format) * 8 == channelCount * channelBits,
+        "Can't generate mip levels for format {} on the CPU.",
+        to_string(format)
+    );
+    const bool isSrgb = type == FormatType::UnormSrgb;
+    const uint32_t bytesPerChannel = channelBits / 8;
+
+    auto load = [&](const uint8_t* pSrc, uint32_t c)
+    {
+        float value;
+        if (channelBits == 8)
+            value = pSrc[c] / 255.f;
+        else if (channelBits == 32)
+            std::memcpy(&value, pSrc + c * 4, 4);
+        else
+        {
+            uint16_t bits;
+            std::memcpy(&bits, pSrc + c * 2, 2);
+            value = isFloat ? math::float16ToFloat32(bits) : bits / 65535.f;
+        }
+        return (isSrgb && c < 3) ? sRGBToLinear(value) : value;
+    };
+    auto store = [&](uint8_t* pDst, uint32_t c, float value)
+    {
+        if (isSrgb && c < 3)
+            value = linearToSRGB(value);
+        if (channelBits == 8)
+            pDst[c] = (uint8_t)std::lround(std::clamp(value, 0.f, 1.f) * 255.f);
+        else if (channelBits == 32)
+            std::memcpy(pDst + c * 4, &value, 4);
+        else
+        {
+            uint16_t bits = isFloat ? math::float32ToFloat16(value) : (uint16_t)std::lround(std::clamp(value, 0.f, 1.f) * 65535.f);
+            std::memcpy(pDst + c * 2, &bits, 2);
+        }
+    };
+
+    const uint32_t texelSize = channelCount * bytesPerChannel;
+    const uint32_t dstWidth = std::max(width / 2, 1u);
+    const uint32_t dstHeight = std::max(height / 2, 1u);
+    std::vector<uint8_t> result(size_t(dstWidth) * dstHeight * texelSize);
+    for (uint32_t y = 0; y < dstHeight; y++)
+    {
+        for (uint32_t x = 0; x < dstWidth; x++)
+        {
+            uint8_t* pDst = result.data() + (size_t(y) * dstWidth + x) * texelSize;
+            for (uint32_t c = 0; c < channelCount; c++)
+            {
+                float sum = 0.f;
+                for (uint32_t i = 0; i < 4; i++)
+                {
+                    const uint32_t sx = std::min(2 * x + (i & 1), width - 1);
+                    const uint32_t sy = std::min(2 * y + (i >> 1), height - 1);
+                    sum += load(image.data() + (size_t(sy) * width + sx) * texelSize, c);
+                }
+                store(pDst, c, sum / 4.f);
+            }
+        }
+    }
+    return result;
+}
 } // namespace
 
 Bitmap::UniqueConstPtr ImageIO::loadBitmapFromDDS(const std::filesystem::path& path)
@@ -619,6 +788,268 @@ ref<Texture> ImageIO::loadTextureFromDDS(ref<Device> pDevice, const std::filesys
     return pTex;
 }
 
+ref<Texture> ImageIO::loadTextureFromKTX2(
+    ref<Device> pDevice,
+    const std::filesystem::path& path,
+    bool generateMips,
+    bool loadAsSrgb,
+    ResourceBindFlags bindFlags,
+    Bitmap::ImportFlags importFlags
+)
+{
+    KTX2File ktx = KTX2File::load(path);
+
+    ResourceFormat format = loadAsSrgb ? linearToSrgbFormat(ktx.getFormat()) : ktx.getFormat();
+    const uint32_t width = ktx.getWidth();
+    const uint32_t height = ktx.getHeight();
+    const uint32_t arraySize = ktx.getArraySize();
+    const uint32_t faceCount = ktx.getFaceCount();
+    const uint32_t sliceCount = arraySize * faceCount;
+    uint32_t mipCount = ktx.getMipCount();
+    generateMips = generateMips || ktx.isMipGenerationRequested();
+
+    // Texture init data is ordered by array slice (layer and face), then by mip level.
+    std::vector<uint8_t> initData;
+
+    ResourceFormat compressedFormat = ResourceFormat::Unknown;
+    if (is_set(importFlags, Bitmap::ImportFlags::BlockCompress) && ktx.getDimensions() == 2 && width % 4 == 0 && height % 4 == 0)
+        compressedFormat = getBlockCompressedFormat(format);
+
+    if (compressedFormat != ResourceFormat::Unknown)
+    {
+        // Block compressed textures can't be rendered to, so missing mips are generated on the CPU before compressing.
+        if (generateMips && mipCount == 1)
+            mipCount = bitScanReverse(width | height) + 1;
+
+        for (uint32_t slice = 0; slice < sliceCount; slice++)
+        {
+            std::vector<uint8_t> image;
+            for (uint32_t mip = 0; mip < mipCount; mip++)
+            {
+                const uint32_t mipWidth = std::max(width >> mip, 1u);
+                const uint32_t mipHeight = std::max(height >> mip, 1u);
+                if (mip < ktx.getMipCount())
+                    image = convertToRGBA8(ktx.getImageData(mip, slice / faceCount, slice % faceCount), size_t(mipWidth) * mipHeight, format);
+                else
+                    image = downsampleRGBA8(image, std::max(width >> (mip - 1), 1u), std::max(height >> (mip - 1), 1u), isSrgbFormat(format));
+
+                auto blocks = BCEncoder::compress(compressedFormat, mipWidth, mipHeight, image.data());
+                initData.insert(initData.end(), blocks.begin(), blocks.end());
+            }
+        }
+        format = compressedFormat;
+    }
+    else
+    {
+        // Let the GPU generate missing mips of uncompressed 2D textures from the base level.
+        const bool autoGenerateMips = generateMips && mipCount == 1 && ktx.getDimensions() == 2 && faceCount == 1 && !isCompressedFormat(format);
+
+        for (uint32_t slice = 0; slice < sliceCount; slice++)
+        {
+            for (uint32_t mip = 0; mip < mipCount; mip++)
+            {
+                const uint8_t* pImage = ktx.getImageData(mip, slice / faceCount, slice % faceCount);
+                initData.insert(initData.end(), pImage, pImage + ktx.getImageSize(mip));
+            }
+        }
+        if (autoGenerateMips)
+            mipCount = Texture::kMaxPossible;
+    }
+
+    ref<Texture> pTex;
+    if (ktx.getDimensions() == 1)
+        pTex = pDevice->createTexture1D(width, format, arraySize, mipCount, initData.data(), bindFlags);
+    else if (ktx.getDimensions() == 3)
+        pTex = pDevice->createTexture3D(width, height, ktx.getDepth(), format, mipCount, initData.data(), bindFlags);
+    else if (faceCount == 6)
+        pTex = pDevice->createTextureCube(width, height, format, arraySize, mipCount, initData.data(), bindFlags);
+    else
+        pTex = pDevice->createTexture2D(width, height, format, arraySize, mipCount, initData.data(), bindFlags);
+
+    if (pTex != nullptr)
+    {
+        pTex->setSourcePath(path);
+    }
+
+    return pTex;
+}
+
+ImageIO::MipLevels ImageIO::loadMipLevels(
+    fstd::span<const std::filesystem::path> paths,
+    bool generateMips,
+    bool loadAsSrgb,
+    Bitmap::ImportFlags importFlags,
+    ResourceFormat format,
+    uint32_t firstMip,
+    uint32_t mipCount
+)
+{
+    FALCOR_CHECK(!paths.empty() && mipCount > 0, "No mip levels to load.");
+    const uint32_t endMip = firstMip + mipCount;
+
+    MipLevels levels;
+    levels.mipCount = mipCount;
+    levels.arraySize = 1;
+
+    // Load an image the way Texture loads it. Channels are only reduced if that results in the expected format,
+    // as textures with explicit mip files are only reduced if all levels can be reduced.
+    // Single and two-channel 8-bit formats have no sRGB variant, so sRGB textures are not reduced.
+    auto loadBitmap = [&](const std::filesystem::path& path)
+    {
+        Bitmap::UniqueConstPtr pBitmap = hasExtension(path, "dds")
+                                             ? loadBitmapFromDDS(path)
+                                             : Bitmap::createFromFile(path, kTopDown, importFlags & ~Bitmap::ImportFlags::ReduceChannels);
+        FALCOR_CHECK(pBitmap, "Failed to load image file '{}'.", path);
+
+        ResourceFormat bitmapFormat = loadAsSrgb ? linearToSrgbFormat(pBitmap->getFormat()) : pBitmap->getFormat();
+        if (bitmapFormat != format && is_set(importFlags, Bitmap::ImportFlags::ReduceChannels) && !loadAsSrgb)
+        {
+            if (auto pReduced = Bitmap::reduceChannels(*pBitmap))
+                pBitmap = std::move(pReduced);
+        }
+        return pBitmap;
+    };
+
+    if (paths.size() > 1)
+    {
+        // Each level is stored in its own file. Only the files of the requested levels are loaded.
+        FALCOR_CHECK(endMip <= paths.size(), "Mip levels {}-{} are out of range.", firstMip, endMip - 1);
+        for (uint32_t mip = firstMip; mip < endMip; mip++)
+        {
+            auto pBitmap = loadBitmap(paths[mip]);
+            ResourceFormat bitmapFormat = loadAsSrgb ? linearToSrgbFormat(pBitmap->getFormat()) : pBitmap->getFormat();
+            FALCOR_CHECK(bitmapFormat == format, "Mip level {} in '{}' has format {}, expected {}.", mip, paths[mip], to_string(bitmapFormat), to_string(format));
+            if (mip == firstMip)
+            {
+                levels.format = bitmapFormat;
+                levels.width = pBitmap->getWidth();
+                levels.height = pBitmap->getHeight();
+            }
+            FALCOR_CHECK(
+                pBitmap->getWidth() == std::max(levels.width >> (mip - firstMip), 1u) &&
+                    pBitmap->getHeight() == std::max(levels.height >> (mip - firstMip), 1u),
+                "Mip level {} in '{}' doesn't match the resolution of the other levels.",
+                mip,
+                paths[mip]
+            );
+            levels.data.insert(levels.data.end(), pBitmap->getData(), pBitmap->getData() + pBitmap->getSize());
+        }
+    }
+    else if (hasExtension(paths[0], "dds"))
+    {
+        // DDS files store all levels of each array slice consecutively.
+        ImportData data;
+        loadDDS(paths[0], loadAsSrgb, data);
+        FALCOR_CHECK(data.type == Resource::Type::Texture2D && endMip <= data.mipLevels, "Mip levels {}-{} are out of range.", firstMip, endMip - 1);
+
+        levels.format = data.format;
+        levels.width = std::max(data.width >> firstMip, 1u);
+        levels.height = std::max(data.height >> firstMip, 1u);
+        levels.arraySize = data.arraySize;
+
+        size_t offset = 0;
+        for (uint32_t slice = 0; slice < data.arraySize; slice++)
+        {
+            for (uint32_t mip = 0; mip < data.mipLevels; mip++)
+            {
+                const size_t size = getImageSize(data.format, std::max(data.width >> mip, 1u), std::max(data.height >> mip, 1u));
+                FALCOR_CHECK(offset + size <= data.imageData.size(), "DDS image data is truncated.");
+                if (mip >= firstMip && mip < endMip)
+                    levels.data.insert(levels.data.end(), data.imageData.begin() + offset, data.imageData.begin() + offset + size);
+                offset += size;
+            }
+        }
+    }
+    else if (hasExtension(paths[0], "ktx2"))
+    {
+        // Only decode the requested levels. Generated levels need the base level instead.
+        KTX2File ktx = KTX2File::load(paths[0], firstMip, mipCount);
+        const uint32_t storedMipCount = ktx.getMipCount();
+        if (endMip > storedMipCount)
+        {
+            FALCOR_CHECK(storedMipCount == 1 && (generateMips || ktx.isMipGenerationRequested()), "Mip levels {}-{} are out of range.", firstMip, endMip - 1);
+            if (!ktx.isMipLoaded(0))
+                ktx = KTX2File::load(paths[0], 0, 1);
+        }
+        FALCOR_CHECK(ktx.getDimensions() == 2 && ktx.getFaceCount() == 1, "Only 2D KTX2 textures can be loaded by mip level.");
+
+        ResourceFormat ktxFormat = loadAsSrgb ? linearToSrgbFormat(ktx.getFormat()) : ktx.getFormat();
+        const uint32_t width = ktx.getWidth();
+        const uint32_t height = ktx.getHeight();
+
+        // Mirror the transcoding in loadTextureFromKTX2().
+        ResourceFormat compressedFormat = ResourceFormat::Unknown;
+        if (is_set(importFlags, Bitmap::ImportFlags::BlockCompress) && width % 4 == 0 && height % 4 == 0)
+            compressedFormat = getBlockCompressedFormat(ktxFormat);
+
+        levels.format = compressedFormat != ResourceFormat::Unknown ? compressedFormat : ktxFormat;
+        levels.width = std::max(width >> firstMip, 1u);
+        levels.height = std::max(height >> firstMip, 1u);
+        levels.arraySize = ktx.getArraySize();
+
+        const uint32_t startMip = firstMip < storedMipCount ? firstMip : 0;
+        for (uint32_t slice = 0; slice < ktx.getArraySize(); slice++)
+        {
+            std::vector<uint8_t> image;
+            for (uint32_t mip = startMip; mip < endMip; mip++)
+            {
+                const uint32_t mipWidth = std::max(width >> mip, 1u);
+                const uint32_t mipHeight = std::max(height >> mip, 1u);
+                if (mip < storedMipCount)
+                {
+                    const uint8_t* pImage = ktx.getImageData(mip, slice, 0);
+                    if (compressedFormat != ResourceFormat::Unknown)
+                        image = convertToRGBA8(pImage, size_t(mipWidth) * mipHeight, ktxFormat);
+                    else
+                        image.assign(pImage, pImage + ktx.getImageSize(mip));
+                }
+                else
+                {
+                    const uint32_t prevWidth = std::max(width >> (mip - 1), 1u);
+                    const uint32_t prevHeight = std::max(height >> (mip - 1), 1u);
+                    if (compressedFormat != ResourceFormat::Unknown)
+                        image = downsampleRGBA8(image, prevWidth, prevHeight, isSrgbFormat(ktxFormat));
+                    else
+                        image = downsampleImage(image, prevWidth, prevHeight, ktxFormat);
+                }
+
+                if (mip < firstMip)
+                    continue;
+                if (compressedFormat != ResourceFormat::Unknown)
+                {
+                    auto blocks = BCEncoder::compress(compressedFormat, mipWidth, mipHeight, image.data());
+                    levels.data.insert(levels.data.end(), blocks.begin(), blocks.end());
+                }
+                else
+                {
+                    levels.data.insert(levels.data.end(), image.begin(), image.end());
+                }
+            }
+        }
+    }
+    else
+    {
+        // Image files only store the base level. The other levels are generated from it.
+        FALCOR_CHECK(endMip == 1 || generateMips, "Mip levels {}-{} are out of range.", firstMip, endMip - 1);
+        auto pBitmap = loadBitmap(paths[0]);
+        levels.format = loadAsSrgb ? linearToSrgbFormat(pBitmap->getFormat()) : pBitmap->getFormat();
+        levels.width = std::max(pBitmap->getWidth() >> firstMip, 1u);
+        levels.height = std::max(pBitmap->getHeight() >> firstMip, 1u);
+
+        std::vector<uint8_t> image(pBitmap->getData(), pBitmap->getData() + pBitmap->getSize());
+        for (uint32_t mip = 0; mip < endMip; mip++)
+        {
+            if (mip > 0)
+                image = downsampleImage(image, std::max(pBitmap->getWidth() >> (mip - 1), 1u), std::max(pBitmap->getHeight() >> (mip - 1), 1u), levels.format);
+            if (mip >= firstMip)
+                levels.data.insert(levels.data.end(), image.begin(), image.end());
+        }
+    }
+
+    FALCOR_CHECK(levels.format == format, "Loaded mip levels have format {}, expected {}.", to_string(levels.format), to_string(format));
+    return levels;
+}
+
 void ImageIO::saveToDDS(const std::filesystem::path& path, const Bitmap& bitmap, CompressionMode mode, bool generateMips)
 {
     if (!hasExtension(path, "dds"))
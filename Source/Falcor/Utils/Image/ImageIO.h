@@ -30,6 +30,8 @@
 #include "Core/Macros.h"
 #include "Core/API/Texture.h"
 #include <filesystem>
+#include <vector>
+#include <fstd/span.h>
 
 namespace Falcor
 {
@@ -90,6 +92,67 @@ public:
      */
     static ref<Texture> loadTextureFromDDS(ref<Device> pDevice, const std::filesystem::path& path, bool loadAsSrgb);
 
+    /**
+     * Load a KTX2 file to a Texture.
+     * All array layers, cube faces and mip levels stored in the file are loaded.
+     * Throws an exception if the KTX2 file is malformed or uses an unsupported format.
+     * @param[in] path Path of file to load.
+     * @param[in] generateMips If true and the file only stores the base level, the mip chain is generated.
+     * @param[in] loadAsSrgb If true, convert the image format property to a corresponding sRGB format if available. Image data is not
+     * changed.
+     * @param[in] bindFlags The bind flags for the texture.
+     * @param[in] importFlags If BlockCompress is set, uncompressed 8-bit 2D images with a size that is a multiple of 4 are
+     * transcoded on the CPU (R to BC4, RG to BC5 and RGB(A) to BC7). Missing mips are then generated on the CPU as well.
+     * @return Texture object containing image data if loading was successful. Otherwise, nullptr.
+     */
+    static ref<Texture> loadTextureFromKTX2(
+        ref<Device> pDevice,
+        const std::filesystem::path& path,
+        bool generateMips,
+        bool loadAsSrgb,
+        ResourceBindFlags bindFlags = ResourceBindFlags::ShaderResource,
+        Bitmap::ImportFlags importFlags = Bitmap::ImportFlags::None
+    );
+
+    /**
+     * Mip levels of a 2D texture loaded into memory.
+     */
+    struct MipLevels
+    {
+        ResourceFormat format = ResourceFormat::Unknown;
+        uint32_t width = 0;        ///< Width of the first loaded level.
+        uint32_t height = 0;       ///< Height of the first loaded level.
+        uint32_t arraySize = 0;    ///< Number of array slices.
+        uint32_t mipCount = 0;     ///< Number of loaded levels.
+        std::vector<uint8_t> data; ///< Image data ordered by array slice, then by mip level (the texture init data layout).
+    };
+
+    /**
+     * Load a range of mip levels of a 2D texture into memory.
+     * The levels match the ones created by Texture::createFromFile() (single path) or Texture::createMippedFromFiles()
+     * (one path per level) with the same arguments. Only the files and KTX2 levels needed for the range are read.
+     * Levels that are generated on load are generated on the CPU with a box filter from the base level.
+     * No GPU resources are used, so this can be called from any thread.
+     * Throws an exception if the levels can't be loaded or don't have the expected format.
+     * @param[in] paths Path of the texture file, or the paths of the files of each mip level.
+     * @param[in] generateMips Whether the mip chain is generated on load.
+     * @param[in] loadAsSrgb Whether the texture is loaded with an sRGB format.
+     * @param[in] importFlags Import flags the texture was loaded with.
+     * @param[in] format Expected format of the texture.
+     * @param[in] firstMip First mip level to load.
+     * @param[in] mipCount Number of mip levels to load.
+     * @return The loaded levels.
+     */
+    static MipLevels loadMipLevels(
+        fstd::span<const std::filesystem::path> paths,
+        bool generateMips,
+        bool loadAsSrgb,
+        Bitmap::ImportFlags importFlags,
+        ResourceFormat format,
+        uint32_t firstMip,
+        uint32_t mipCount
+    );
+
     /**
      * Saves a bitmap to a DDS file.
      * Throws an exception if path is invalid or the image cannot be saved.
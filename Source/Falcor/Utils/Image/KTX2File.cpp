@@ -0,0 +1,376 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "KTX2File.h"
+#include "BasisDecoder.h"
+#include "BCEncoder.h"
+#include "ZstdDecoder.h"
+#include "Core/Error.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/NumericRange.h"
+#include "Utils/StringFormatters.h"
+#include <zlib.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <exception>
+#include <execution>
+#include <optional>
+
+namespace Falcor
+{
+namespace
+{
+const uint8_t kIdentifier[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+const size_t kHeaderSize = 80; ///< Identifier, header and index.
+const size_t kLevelIndexEntrySize = 24;
+
+// Data format descriptor values (Khronos Data Format Specification).
+const uint32_t kColorModelETC1S = 163;
+const uint32_t kColorModelUASTC = 166;
+const uint32_t kTransferFunctionSRGB = 2;
+const size_t kBasicDescriptorHeaderSize = 24; ///< Size of the basic descriptor block without the samples.
+const size_t kSampleSize = 16;
+
+struct FormatInfo
+{
+    uint32_t vkFormat;
+    ResourceFormat format;
+    bool isSrgb;
+    bool isRGB8; ///< Three-channel 8-bit format that is expanded to four channels.
+};
+
+// clang-format off
+const FormatInfo kFormats[] = {
+    {9,   ResourceFormat::R8Unorm,        false, false}, // VK_FORMAT_R8_UNORM
+    {10,  ResourceFormat::R8Snorm,        false, false}, // VK_FORMAT_R8_SNORM
+    {16,  ResourceFormat::RG8Unorm,       false, false}, // VK_FORMAT_R8G8_UNORM
+    {17,  ResourceFormat::RG8Snorm,       false, false}, // VK_FORMAT_R8G8_SNORM
+    {23,  ResourceFormat::RGBA8Unorm,     false, true},  // VK_FORMAT_R8G8B8_UNORM
+    {29,  ResourceFormat::RGBA8Unorm,     true,  true},  // VK_FORMAT_R8G8B8_SRGB
+    {30,  ResourceFormat::BGRA8Unorm,     false, true},  // VK_FORMAT_B8G8R8_UNORM
+    {36,  ResourceFormat::BGRA8Unorm,     true,  true},  // VK_FORMAT_B8G8R8_SRGB
+    {37,  ResourceFormat::RGBA8Unorm,     false, false}, // VK_FORMAT_R8G8B8A8_UNORM
+    {38,  ResourceFormat::RGBA8Snorm,     false, false}, // VK_FORMAT_R8G8B8A8_SNORM
+    {43,  ResourceFormat::RGBA8Unorm,     true,  false}, // VK_FORMAT_R8G8B8A8_SRGB
+    {44,  ResourceFormat::BGRA8Unorm,     false, false}, // VK_FORMAT_B8G8R8A8_UNORM
+    {50,  ResourceFormat::BGRA8Unorm,     true,  false}, // VK_FORMAT_B8G8R8A8_SRGB
+    {64,  ResourceFormat::RGB10A2Unorm,   false, false}, // VK_FORMAT_A2B10G10R10_UNORM_PACK32
+    {70,  ResourceFormat::R16Unorm,       false, false}, // VK_FORMAT_R16_UNORM
+    {76,  ResourceFormat::R16Float,       false, false}, // VK_FORMAT_R16_SFLOAT
+    {77,  ResourceFormat::RG16Unorm,      false, false}, // VK_FORMAT_R16G16_UNORM
+    {83,  ResourceFormat::RG16Float,      false, false}, // VK_FORMAT_R16G16_SFLOAT
+    {91,  ResourceFormat::RGBA16Unorm,    false, false}, // VK_FORMAT_R16G16B16A16_UNORM
+    {97,  ResourceFormat::RGBA16Float,    false, false}, // VK_FORMAT_R16G16B16A16_SFLOAT
+    {100, ResourceFormat::R32Float,       false, false}, // VK_FORMAT_R32_SFLOAT
+    {103, ResourceFormat::RG32Float,      false, false}, // VK_FORMAT_R32G32_SFLOAT
+    {106, ResourceFormat::RGB32Float,     false, false}, // VK_FORMAT_R32G32B32_SFLOAT
+    {109, ResourceFormat::RGBA32Float,    false, false}, // VK_FORMAT_R32G32B32A32_SFLOAT
+    {122, ResourceFormat::R11G11B10Float, false, false}, // VK_FORMAT_B10G11R11_UFLOAT_PACK32
+    {123, ResourceFormat::RGB9E5Float,    false, false}, // VK_FORMAT_E5B9G9R9_UFLOAT_PACK32
+    {131, ResourceFormat::BC1Unorm,       false, false}, // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+    {132, ResourceFormat::BC1Unorm,       true,  false}, // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+    {133, ResourceFormat::BC1Unorm,       false, false}, // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+    {134, ResourceFormat::BC1Unorm,       true,  false}, // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+    {135, ResourceFormat::BC2Unorm,       false, false}, // VK_FORMAT_BC2_UNORM_BLOCK
+    {136, ResourceFormat::BC2Unorm,       true,  false}, // VK_FORMAT_BC2_SRGB_BLOCK
+    {137, ResourceFormat::BC3Unorm,       false, false}, // VK_FORMAT_BC3_UNORM_BLOCK
+    {138, ResourceFormat::BC3Unorm,       true,  false}, // VK_FORMAT_BC3_SRGB_BLOCK
+    {139, ResourceFormat::BC4Unorm,       false, false}, // VK_FORMAT_BC4_UNORM_BLOCK
+    {140, ResourceFormat::BC4Snorm,       false, false}, // VK_FORMAT_BC4_SNORM_BLOCK
+    {141, ResourceFormat::BC5Unorm,       false, false}, // VK_FORMAT_BC5_UNORM_BLOCK
+    {142, ResourceFormat::BC5Snorm,       false, false}, // VK_FORMAT_BC5_SNORM_BLOCK
+    {143, ResourceFormat::BC6HU16,        false, false}, // VK_FORMAT_BC6H_UFLOAT_BLOCK
+    {144, ResourceFormat::BC6HS16,        false, false}, // VK_FORMAT_BC6H_SFLOAT_BLOCK
+    {145, ResourceFormat::BC7Unorm,       false, false}, // VK_FORMAT_BC7_UNORM_BLOCK
+    {146, ResourceFormat::BC7Unorm,       true,  false}, // VK_FORMAT_BC7_SRGB_BLOCK
+};
+// clang-format on
+
+uint32_t readU32(const uint8_t* p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+uint64_t readU64(const uint8_t* p)
+{
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+/// Size of an image in bytes, given the number of bytes per texel or block.
+size_t computeImageSize(ResourceFormat format, uint32_t width, uint32_t height, uint32_t depth, uint32_t bytesPerBlock)
+{
+    const uint32_t blockWidth = getFormatWidthCompressionRatio(format);
+    const uint32_t blockHeight = getFormatHeightCompressionRatio(format);
+    return size_t((width + blockWidth - 1) / blockWidth) * ((height + blockHeight - 1) / blockHeight) * depth * bytesPerBlock;
+}
+
+std::vector<uint8_t> inflateLevel(const uint8_t* pData, size_t size, size_t uncompressedSize)
+{
+    std::vector<uint8_t> result(uncompressedSize);
+    uLongf resultSize = (uLongf)uncompressedSize;
+    int ret = uncompress(result.data(), &resultSize, pData, (uLong)size);
+    if (ret != Z_OK || resultSize != uncompressedSize)
+        FALCOR_THROW("Failed to decompress zlib supercompressed level (error: {}).", ret);
+    return result;
+}
+
+/// Decode the images of a Basis Universal level to RGBA8 and re-encode them to a BC format.
+template<typename DecodeImage>
+std::vector<uint8_t> transcodeLevel(ResourceFormat format, uint32_t width, uint32_t height, uint32_t imageCount, DecodeImage decodeImage)
+{
+    std::vector<uint8_t> result;
+    for (uint32_t i = 0; i < imageCount; i++)
+    {
+        auto blocks = BCEncoder::compress(format, width, height, decodeImage(i).data());
+        result.insert(result.end(), blocks.begin(), blocks.end());
+    }
+    return result;
+}
+
+/// Expand tightly packed 3-channel texels to 4 channels with opaque alpha.
+std::vector<uint8_t> expandRGB8(const std::vector<uint8_t>& data)
+{
+    const size_t texelCount = data.size() / 3;
+    std::vector<uint8_t> result(texelCount * 4);
+    for (size_t i = 0; i < texelCount; i++)
+    {
+        result[i * 4 + 0] = data[i * 3 + 0];
+        result[i * 4 + 1] = data[i * 3 + 1];
+        result[i * 4 + 2] = data[i * 3 + 2];
+        result[i * 4 + 3] = 0xff;
+    }
+    return result;
+}
+} // namespace
+
+KTX2File KTX2File::load(const std::filesystem::path& path, uint32_t firstMip, uint32_t mipCount)
+{
+    MemoryMappedFile file(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan);
+    if (!file.isOpen())
+        FALCOR_THROW("Failed to open KTX2 file '{}'.", path);
+    return loadFromMemory(file.getData(), file.getSize(), firstMip, mipCount);
+}
+
+KTX2File KTX2File::loadFromMemory(const void* pData, size_t size, uint32_t firstMip, uint32_t mipCount)
+{
+    const uint8_t* pFile = static_cast<const uint8_t*>(pData);
+    FALCOR_CHECK(size >= kHeaderSize && std::memcmp(pFile, kIdentifier, sizeof(kIdentifier)) == 0, "Not a KTX2 file.");
+
+    const uint32_t vkFormat = readU32(pFile + 12);
+    const uint32_t pixelWidth = readU32(pFile + 20);
+    const uint32_t pixelHeight = readU32(pFile + 24);
+    const uint32_t pixelDepth = readU32(pFile + 28);
+    const uint32_t layerCount = readU32(pFile + 32);
+    const uint32_t faceCount = readU32(pFile + 36);
+    const uint32_t levelCount = readU32(pFile + 40);
+    const uint32_t supercompression = readU32(pFile + 44);
+    const uint32_t dfdOffset = readU32(pFile + 48);
+    const uint32_t dfdLength = readU32(pFile + 52);
+
+    KTX2File ktx;
+    ktx.mWidth = pixelWidth;
+    ktx.mHeight = std::max(pixelHeight, 1u);
+    ktx.mDepth = std::max(pixelDepth, 1u);
+    ktx.mArraySize = std::max(layerCount, 1u);
+    ktx.mFaceCount = faceCount;
+    ktx.mDimensions = pixelDepth > 0 ? 3 : (pixelHeight > 0 ? 2 : 1);
+    ktx.mIsArray = layerCount > 0;
+    ktx.mMipGenerationRequested = levelCount == 0;
+    ktx.mSupercompression = (Supercompression)supercompression;
+
+    FALCOR_CHECK(pixelWidth > 0, "Invalid KTX2 image width.");
+    FALCOR_CHECK(faceCount == 1 || (faceCount == 6 && ktx.mDimensions == 2 && pixelWidth == pixelHeight), "Invalid KTX2 face count {}.", faceCount);
+    FALCOR_CHECK(supercompression <= (uint32_t)Supercompression::Zlib, "Unknown KTX2 supercompression scheme {}.", supercompression);
+
+    // Read the color model, transfer function and sample count from the basic data format descriptor block.
+    uint32_t colorModel = 0;
+    uint32_t transferFunction = 0;
+    uint32_t sampleCount = 0;
+    if (dfdLength >= 4 + 16 && size_t(dfdOffset) + dfdLength <= size)
+    {
+        colorModel = pFile[dfdOffset + 12];
+        transferFunction = pFile[dfdOffset + 14];
+        const uint32_t descriptorBlockSize = pFile[dfdOffset + 10] | (pFile[dfdOffset + 11] << 8);
+        if (descriptorBlockSize >= kBasicDescriptorHeaderSize)
+            sampleCount = uint32_t((descriptorBlockSize - kBasicDescriptorHeaderSize) / kSampleSize);
+    }
+
+    // Basis Universal payloads are transcoded: ETC1S to BC1 (or BC3 if there is an alpha slice), UASTC to BC7.
+    const bool isETC1S = colorModel == kColorModelETC1S;
+    const bool isUASTC = colorModel == kColorModelUASTC;
+    FALCOR_CHECK(
+        isETC1S == (supercompression == (uint32_t)Supercompression::BasisLZ), "KTX2 BasisLZ supercompression requires ETC1S data and vice versa."
+    );
+
+    FormatInfo formatInfo = {};
+    if (isETC1S || isUASTC)
+    {
+        FALCOR_CHECK(vkFormat == 0, "KTX2 Basis Universal data must have an undefined VkFormat.");
+        formatInfo.format = isUASTC ? ResourceFormat::BC7Unorm : (sampleCount > 1 ? ResourceFormat::BC3Unorm : ResourceFormat::BC1Unorm);
+    }
+    else
+    {
+        auto it = std::find_if(std::begin(kFormats), std::end(kFormats), [&](const FormatInfo& info) { return info.vkFormat == vkFormat; });
+        FALCOR_CHECK(it != std::end(kFormats), "Unsupported KTX2 format (VkFormat {}).", vkFormat);
+        formatInfo = *it;
+    }
+    const bool isSrgb = formatInfo.isSrgb || transferFunction == kTransferFunctionSRGB;
+    ktx.mFormat = isSrgb ? linearToSrgbFormat(formatInfo.format) : formatInfo.format;
+    FALCOR_CHECK(!isCompressedFormat(ktx.mFormat) || ktx.mDimensions == 2, "Block compressed KTX2 textures must be 2D.");
+
+    const uint32_t fileMipCount = std::max(levelCount, 1u);
+    const uint32_t maxMipCount = 1 + (uint32_t)std::log2(std::max({ktx.mWidth, ktx.mHeight, ktx.mDepth}));
+    FALCOR_CHECK(fileMipCount <= maxMipCount, "Invalid KTX2 level count {}.", levelCount);
+    FALCOR_CHECK(kHeaderSize + fileMipCount * kLevelIndexEntrySize <= size, "KTX2 level index is truncated.");
+
+    // ETC1S codebooks are stored in the supercompression global data, with a description of each image.
+    const uint32_t imagesPerLevel = ktx.mArraySize * ktx.mFaceCount;
+    std::optional<ETC1SDecoder> etc1sDecoder;
+    if (isETC1S)
+    {
+        const uint64_t sgdOffset = readU64(pFile + 64);
+        const uint64_t sgdLength = readU64(pFile + 72);
+        FALCOR_CHECK(sgdOffset <= size && sgdLength <= size - sgdOffset, "KTX2 supercompression global data is out of bounds.");
+        etc1sDecoder.emplace(pFile + sgdOffset, (size_t)sgdLength, fileMipCount * imagesPerLevel);
+    }
+
+    // Decode the requested levels in parallel.
+    ktx.mLevels.resize(fileMipCount);
+    firstMip = std::min(firstMip, fileMipCount);
+    const uint32_t endMip = fileMipCount - firstMip < mipCount ? fileMipCount : firstMip + mipCount;
+    std::vector<std::exception_ptr> exceptions(fileMipCount);
+    NumericRange<uint32_t> levelRange(firstMip, endMip);
+    std::for_each(
+        std::execution::par,
+        levelRange.begin(),
+        levelRange.end(),
+        [&](uint32_t mip)
+        {
+            try
+            {
+                const uint8_t* pEntry = pFile + kHeaderSize + mip * kLevelIndexEntrySize;
+                const uint64_t byteOffset = readU64(pEntry);
+                const uint64_t byteLength = readU64(pEntry + 8);
+                const uint64_t uncompressedByteLength = readU64(pEntry + 16);
+                FALCOR_CHECK(byteOffset <= size && byteLength <= size - byteOffset, "KTX2 level {} is out of bounds.", mip);
+
+                const uint8_t* pLevel = pFile + byteOffset;
+                const uint32_t width = std::max(ktx.mWidth >> mip, 1u);
+                const uint32_t height = std::max(ktx.mHeight >> mip, 1u);
+                if (etc1sDecoder)
+                {
+                    ktx.mLevels[mip] = transcodeLevel(
+                        ktx.mFormat,
+                        width,
+                        height,
+                        imagesPerLevel,
+                        [&](uint32_t image)
+                        { return etc1sDecoder->decodeImage(mip * imagesPerLevel + image, pLevel, (size_t)byteLength, width, height); }
+                    );
+                    return;
+                }
+
+                const uint32_t sourceBytesPerBlock = formatInfo.isRGB8 ? 3 : getFormatBytesPerBlock(ktx.mFormat);
+                const size_t expectedSize =
+                    computeImageSize(ktx.mFormat, width, height, std::max(ktx.mDepth >> mip, 1u), sourceBytesPerBlock) * imagesPerLevel;
+
+                std::vector<uint8_t> data;
+                switch (ktx.mSupercompression)
+                {
+                case Supercompression::None:
+                    FALCOR_CHECK(byteLength == expectedSize, "KTX2 level {} has size {}, expected {}.", mip, byteLength, expectedSize);
+                    data.assign(pLevel, pLevel + byteLength);
+                    break;
+                case Supercompression::Zstd:
+                    data = ZstdDecoder::decompress(pLevel, (size_t)byteLength, expectedSize);
+                    break;
+                case Supercompression::Zlib:
+                    FALCOR_CHECK(uncompressedByteLength == expectedSize, "KTX2 level {} has size {}, expected {}.", mip, uncompressedByteLength, expectedSize);
+                    data = inflateLevel(pLevel, (size_t)byteLength, expectedSize);
+                    break;
+                default:
+                    FALCOR_UNREACHABLE();
+                }
+                FALCOR_CHECK(data.size() == expectedSize, "KTX2 level {} has size {}, expected {}.", mip, data.size(), expectedSize);
+
+                if (isUASTC)
+                {
+                    // UASTC blocks have the same size as BC7 blocks, so the data size matches the transcoded size.
+                    const size_t imageSize = data.size() / imagesPerLevel;
+                    ktx.mLevels[mip] = transcodeLevel(
+                        ktx.mFormat,
+                        width,
+                        height,
+                        imagesPerLevel,
+                        [&](uint32_t image) { return UASTCDecoder::decode(data.data() + image * imageSize, imageSize, width, height); }
+                    );
+                }
+                else
+                {
+                    ktx.mLevels[mip] = formatInfo.isRGB8 ? expandRGB8(data) : std::move(data);
+                }
+            }
+            catch (...)
+            {
+                exceptions[mip] = std::current_exception();
+            }
+        }
+    );
+    for (const auto& exception : exceptions)
+    {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+
+    return ktx;
+}
+
+size_t KTX2File::getImageSize(uint32_t mipLevel) const
+{
+    FALCOR_CHECK(mipLevel < getMipCount(), "Mip level {} is out of range.", mipLevel);
+    return computeImageSize(
+        mFormat,
+        std::max(mWidth >> mipLevel, 1u),
+        std::max(mHeight >> mipLevel, 1u),
+        std::max(mDepth >> mipLevel, 1u),
+        getFormatBytesPerBlock(mFormat)
+    );
+}
+
+const uint8_t* KTX2File::getImageData(uint32_t mipLevel, uint32_t arrayIndex, uint32_t face) const
+{
+    FALCOR_CHECK(arrayIndex < mArraySize && face < mFaceCount, "Image ({}, {}) is out of range.", arrayIndex, face);
+    FALCOR_CHECK(isMipLoaded(mipLevel), "Mip level {} was not loaded.", mipLevel);
+    return mLevels[mipLevel].data() + (size_t(arrayIndex) * mFaceCount + face) * getImageSize(mipLevel);
+}
+
+} // namespace Falcor
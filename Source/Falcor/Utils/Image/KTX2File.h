@@ -0,0 +1,126 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include <cstdint>
+#include <filesystem>
+#include <limits>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Reader for KTX 2.0 texture files.
+ *
+ * Levels are read and decompressed up front (in parallel). Supported supercompression schemes are BasisLZ, Zstandard
+ * and zlib. Basis Universal payloads are transcoded to BC formats: ETC1S to BC1 (BC3 with an alpha slice) and
+ * UASTC to BC7. Three-channel 8-bit formats have no GPU equivalent and are expanded to four channels with opaque alpha.
+ */
+class FALCOR_API KTX2File
+{
+public:
+    enum class Supercompression : uint32_t
+    {
+        None = 0,
+        BasisLZ = 1,
+        Zstd = 2,
+        Zlib = 3,
+    };
+
+    static constexpr uint32_t kAllMips = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * Load a KTX2 file.
+     * Throws a RuntimeError if the file can't be read, is malformed or uses an unsupported format.
+     * @param[in] path Path of the file.
+     * @param[in] firstMip First mip level to decode.
+     * @param[in] mipCount Number of mip levels to decode. Other levels are skipped.
+     */
+    static KTX2File load(const std::filesystem::path& path, uint32_t firstMip = 0, uint32_t mipCount = kAllMips);
+
+    /**
+     * Load a KTX2 file from memory.
+     * Throws a RuntimeError if the data is malformed or uses an unsupported format.
+     * @param[in] pData File contents.
+     * @param[in] size Size of the file contents in bytes.
+     * @param[in] firstMip First mip level to decode.
+     * @param[in] mipCount Number of mip levels to decode. Other levels are skipped.
+     */
+    static KTX2File loadFromMemory(const void* pData, size_t size, uint32_t firstMip = 0, uint32_t mipCount = kAllMips);
+
+    /// Get the format of the decoded image data. sRGB formats are used if the file specifies the sRGB transfer function.
+    ResourceFormat getFormat() const { return mFormat; }
+
+    uint32_t getWidth() const { return mWidth; }
+    uint32_t getHeight() const { return mHeight; }
+    uint32_t getDepth() const { return mDepth; }
+    uint32_t getArraySize() const { return mArraySize; }
+    uint32_t getFaceCount() const { return mFaceCount; }
+    uint32_t getMipCount() const { return (uint32_t)mLevels.size(); }
+
+    /// True if the data of a mip level was decoded.
+    bool isMipLoaded(uint32_t mipLevel) const { return mipLevel < mLevels.size() && !mLevels[mipLevel].empty(); }
+
+    /// Number of dimensions of the texture (1, 2 or 3).
+    uint32_t getDimensions() const { return mDimensions; }
+
+    /// True if the file is a texture array (array size is not zero in the header).
+    bool isArray() const { return mIsArray; }
+
+    /// True if the file only stores the base level and requests that the mip chain is generated on load.
+    bool isMipGenerationRequested() const { return mMipGenerationRequested; }
+
+    Supercompression getSupercompression() const { return mSupercompression; }
+
+    /**
+     * Get the size of a single image (one array layer and face) of a mip level in bytes, including all depth slices.
+     */
+    size_t getImageSize(uint32_t mipLevel) const;
+
+    /**
+     * Get the decoded data of an image. Rows (or rows of blocks) are tightly packed, followed by the depth slices.
+     */
+    const uint8_t* getImageData(uint32_t mipLevel, uint32_t arrayIndex, uint32_t face) const;
+
+private:
+    KTX2File() = default;
+
+    ResourceFormat mFormat = ResourceFormat::Unknown;
+    uint32_t mWidth = 0;
+    uint32_t mHeight = 0;
+    uint32_t mDepth = 0;
+    uint32_t mArraySize = 0;
+    uint32_t mFaceCount = 0;
+    uint32_t mDimensions = 0;
+    bool mIsArray = false;
+    bool mMipGenerationRequested = false;
+    Supercompression mSupercompression = Supercompression::None;
+    std::vector<std::vector<uint8_t>> mLevels;
+};
+} // namespace Falcor
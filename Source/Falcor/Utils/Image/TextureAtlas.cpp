@@ -0,0 +1,229 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TextureAtlas.h"
+#include "Core/Error.h"
+#include "Utils/Math/Common.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+
+namespace Falcor
+{
+SkylinePacker::SkylinePacker(uint32_t width, uint32_t height) : mWidth(width), mHeight(height)
+{
+    FALCOR_CHECK(width > 0 && height > 0, "Packing area must not be empty.");
+    mSkyline.push_back({0, 0, width});
+}
+
+std::optional<uint2> SkylinePacker::insert(uint2 size)
+{
+    FALCOR_CHECK(size.x > 0 && size.y > 0, "Rectangle must not be empty.");
+    if (size.x > mWidth || size.y > mHeight)
+        return {};
+
+    // Find the lowest position, preferring the leftmost one. Positions start at the left end of a segment.
+    size_t bestIndex = mSkyline.size();
+    uint32_t bestY = std::numeric_limits<uint32_t>::max();
+    for (size_t i = 0; i < mSkyline.size() && mSkyline[i].x + size.x <= mWidth; i++)
+    {
+        uint32_t y = 0;
+        for (size_t j = i; j < mSkyline.size() && mSkyline[j].x < mSkyline[i].x + size.x; j++)
+            y = std::max(y, mSkyline[j].y);
+        if (y + size.y <= mHeight && y < bestY)
+        {
+            bestIndex = i;
+            bestY = y;
+        }
+    }
+    if (bestIndex == mSkyline.size())
+        return {};
+
+    // Replace the covered part of the skyline by the top of the new rectangle.
+    const uint32_t x = mSkyline[bestIndex].x;
+    const uint32_t end = x + size.x;
+    size_t last = bestIndex;
+    while (last < mSkyline.size() && mSkyline[last].x + mSkyline[last].width <= end)
+        last++;
+    if (last < mSkyline.size() && mSkyline[last].x < end)
+    {
+        mSkyline[last].width -= end - mSkyline[last].x;
+        mSkyline[last].x = end;
+    }
+    mSkyline.erase(mSkyline.begin() + bestIndex, mSkyline.begin() + last);
+    mSkyline.insert(mSkyline.begin() + bestIndex, {x, bestY + size.y, size.x});
+
+    // Merge neighboring segments of the same height.
+    size_t count = 1;
+    for (size_t i = 1; i < mSkyline.size(); i++)
+    {
+        if (mSkyline[i].y == mSkyline[count - 1].y)
+            mSkyline[count - 1].width += mSkyline[i].width;
+        else
+            mSkyline[count++] = mSkyline[i];
+    }
+    mSkyline.resize(count);
+
+    mUsedSize = max(mUsedSize, uint2(end, bestY + size.y));
+    mUsedArea += uint64_t(size.x) * size.y;
+    return uint2(x, bestY);
+}
+
+TextureAtlasBuilder::TextureAtlasBuilder(const TextureAtlasSettings& settings) : mSettings(settings)
+{
+    FALCOR_CHECK(settings.mipLevels >= 1 && settings.mipLevels <= 16, "'mipLevels' ({}) must be in the range [1,16].", settings.mipLevels);
+    mPadding = getPadding(settings.mipLevels);
+    FALCOR_CHECK(settings.atlasSize % mPadding == 0, "'atlasSize' ({}) must be a multiple of the padding ({}).", settings.atlasSize, mPadding);
+    FALCOR_CHECK(
+        settings.maxTextureSize > 0 && settings.maxTextureSize + 2 * mPadding <= settings.atlasSize,
+        "'maxTextureSize' ({}) with padding must fit in 'atlasSize' ({}).",
+        settings.maxTextureSize,
+        settings.atlasSize
+    );
+}
+
+bool TextureAtlasBuilder::canPack(ResourceFormat format, uint32_t width, uint32_t height) const
+{
+    return format != ResourceFormat::Unknown && !isCompressedFormat(format) && width > 0 && height > 0 &&
+           width <= mSettings.maxTextureSize && height <= mSettings.maxTextureSize;
+}
+
+uint32_t TextureAtlasBuilder::addTexture(ResourceFormat format, uint32_t width, uint32_t height, std::vector<uint8_t> data)
+{
+    FALCOR_CHECK(canPack(format, width, height), "Texture ({}x{}, {}) can't be packed.", width, height, to_string(format));
+    FALCOR_CHECK(
+        data.size() == size_t(width) * height * getFormatBytesPerBlock(format),
+        "Texture data size ({}) does not match its dimensions ({}x{}).",
+        data.size(),
+        width,
+        height
+    );
+
+    mSources.push_back({format, width, height, std::move(data)});
+    mEntries.push_back({});
+    mEntries.back().size = uint2(width, height);
+    return (uint32_t)mEntries.size() - 1;
+}
+
+void TextureAtlasBuilder::build()
+{
+    mAtlases.clear();
+
+    // Group the textures by format.
+    std::map<ResourceFormat, std::vector<uint32_t>> groups;
+    for (uint32_t i = 0; i < (uint32_t)mSources.size(); i++)
+        groups[mSources[i].format].push_back(i);
+
+    // Cells are packed in units of the padding, which keeps them aligned.
+    const uint32_t atlasUnits = mSettings.atlasSize / mPadding;
+    auto getCellUnits = [&](uint32_t i)
+    { return uint2(div_round_up(mEntries[i].size.x + 2 * mPadding, mPadding), div_round_up(mEntries[i].size.y + 2 * mPadding, mPadding)); };
+
+    for (auto& [format, indices] : groups)
+    {
+        // Placing tall cells first gives a flatter skyline.
+        std::stable_sort(
+            indices.begin(),
+            indices.end(),
+            [&](uint32_t a, uint32_t b)
+            {
+                uint2 ca = getCellUnits(a), cb = getCellUnits(b);
+                return ca.y != cb.y ? ca.y > cb.y : ca.x > cb.x;
+            }
+        );
+
+        const size_t firstAtlas = mAtlases.size();
+        std::vector<SkylinePacker> packers;
+        for (uint32_t i : indices)
+        {
+            uint2 cellUnits = getCellUnits(i);
+            std::optional<uint2> position;
+            size_t page = 0;
+            for (; page < packers.size() && !position; page++)
+                position = packers[page].insert(cellUnits);
+            if (!position)
+            {
+                packers.emplace_back(atlasUnits, atlasUnits);
+                position = packers.back().insert(cellUnits);
+                page = packers.size();
+                FALCOR_ASSERT(position);
+            }
+
+            Entry& entry = mEntries[i];
+            entry.atlasIndex = (uint32_t)(firstAtlas + page - 1);
+            entry.offset = *position * mPadding + mPadding;
+            if (entry.atlasIndex >= mAtlases.size())
+                mAtlases.push_back({format});
+            mAtlases[entry.atlasIndex].entries.push_back(i);
+        }
+
+        for (size_t page = 0; page < packers.size(); page++)
+        {
+            Atlas& atlas = mAtlases[firstAtlas + page];
+            uint2 usedSize = packers[page].getUsedSize() * mPadding;
+            atlas.width = usedSize.x;
+            atlas.height = usedSize.y;
+            atlas.data.resize(size_t(atlas.width) * atlas.height * getFormatBytesPerBlock(format));
+            for (uint32_t i : atlas.entries)
+                writeCell(atlas, mEntries[i], mSources[i]);
+        }
+    }
+}
+
+float4 TextureAtlasBuilder::getUvTransform(uint32_t index) const
+{
+    const Entry& entry = mEntries[index];
+    FALCOR_CHECK(entry.atlasIndex < mAtlases.size(), "Atlases have not been built.");
+    const Atlas& atlas = mAtlases[entry.atlasIndex];
+    float2 atlasSize((float)atlas.width, (float)atlas.height);
+    return float4(float2(entry.size) / atlasSize, float2(entry.offset) / atlasSize);
+}
+
+void TextureAtlasBuilder::writeCell(Atlas& atlas, const Entry& entry, const Source& source) const
+{
+    // Fill the whole cell, including the padding, by repeating the texture.
+    const size_t texelSize = getFormatBytesPerBlock(source.format);
+    const uint2 cellStart = entry.offset - mPadding;
+    const uint2 cellSize = uint2(div_round_up(source.width + 2 * mPadding, mPadding), div_round_up(source.height + 2 * mPadding, mPadding)) * mPadding;
+
+    for (uint32_t y = 0; y < cellSize.y; y++)
+    {
+        // Cells start one padding before the texture, so shift by a multiple of the texture size to keep the modulo positive.
+        uint32_t sy = (y + source.height * mPadding - mPadding) % source.height;
+        for (uint32_t x = 0; x < cellSize.x; x++)
+        {
+            uint32_t sx = (x + source.width * mPadding - mPadding) % source.width;
+            std::memcpy(
+                atlas.data.data() + ((size_t(cellStart.y) + y) * atlas.width + cellStart.x + x) * texelSize,
+                source.data.data() + (size_t(sy) * source.width + sx) * texelSize,
+                texelSize
+            );
+        }
+    }
+}
+} // namespace Falcor
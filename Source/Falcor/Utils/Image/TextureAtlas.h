@@ -0,0 +1,187 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/API/Formats.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <optional>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Settings for packing small textures into atlases.
+ */
+struct TextureAtlasSettings
+{
+    uint32_t maxTextureSize = 64; ///< Max width and height of textures that are packed.
+    uint32_t atlasSize = 2048;    ///< Max width and height of an atlas.
+    uint32_t mipLevels = 4;       ///< Number of mip levels of the atlases. Textures are padded to keep these levels separated.
+};
+
+/**
+ * Skyline rectangle packer.
+ *
+ * Rectangles are placed one at a time at the lowest position along the skyline, i.e., the upper
+ * envelope of the rectangles placed so far, preferring the leftmost position on ties.
+ */
+class FALCOR_API SkylinePacker
+{
+public:
+    /**
+     * Create a packer for an empty area.
+     * @param[in] width Width of the area.
+     * @param[in] height Height of the area.
+     */
+    SkylinePacker(uint32_t width, uint32_t height);
+
+    /**
+     * Place a rectangle.
+     * @param[in] size Size of the rectangle.
+     * @return Position of the rectangle's corner, or an empty optional if it doesn't fit.
+     */
+    std::optional<uint2> insert(uint2 size);
+
+    /**
+     * Get the size of the bounding box of all placed rectangles.
+     */
+    uint2 getUsedSize() const { return mUsedSize; }
+
+    /**
+     * Get the total area of all placed rectangles.
+     */
+    uint64_t getUsedArea() const { return mUsedArea; }
+
+private:
+    struct Segment
+    {
+        uint32_t x;
+        uint32_t y;
+        uint32_t width;
+    };
+
+    uint32_t mWidth;
+    uint32_t mHeight;
+    std::vector<Segment> mSkyline; ///< Skyline segments sorted by x, covering the full width.
+    uint2 mUsedSize{0};
+    uint64_t mUsedArea = 0;
+};
+
+/**
+ * Packs small textures of the same format into shared atlases.
+ *
+ * Each texture is placed in a cell that is aligned to 2^(mipLevels-1) texels, and padded on all sides
+ * by the same amount. Box filtering the atlas then never mixes texels of different cells in the first
+ * mipLevels levels, and every level keeps at least one texel of padding around each texture.
+ * The padding is filled by repeating the texture, so that filtering across its edges matches wrap addressing.
+ *
+ * The builder works on the texel data of mip 0 only. Creating the atlas textures and their mip levels is up to the caller.
+ */
+class FALCOR_API TextureAtlasBuilder
+{
+public:
+    /// Placement of a texture in an atlas.
+    struct Entry
+    {
+        uint32_t atlasIndex = 0; ///< Index of the atlas.
+        uint2 offset{0};         ///< Position of the texture in the atlas, in texels, excluding the padding.
+        uint2 size{0};           ///< Size of the texture in texels.
+    };
+
+    /// Atlas texture data.
+    struct Atlas
+    {
+        ResourceFormat format = ResourceFormat::Unknown;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::vector<uint8_t> data;     ///< Texel data of mip 0, in row-major order without row padding.
+        std::vector<uint32_t> entries; ///< Indices of the textures in this atlas.
+    };
+
+    /**
+     * Create a builder.
+     * @param[in] settings Atlas settings.
+     */
+    TextureAtlasBuilder(const TextureAtlasSettings& settings);
+
+    /**
+     * Get the padding and cell alignment in texels for a given number of mip levels.
+     */
+    static uint32_t getPadding(uint32_t mipLevels) { return 1u << (mipLevels - 1); }
+
+    /**
+     * Check if a texture can be packed. The format must be uncompressed and the texture no larger than the max texture size.
+     */
+    bool canPack(ResourceFormat format, uint32_t width, uint32_t height) const;
+
+    /**
+     * Add a texture.
+     * @param[in] format Texel format.
+     * @param[in] width Width in texels.
+     * @param[in] height Height in texels.
+     * @param[in] data Texel data of mip 0, in row-major order without row padding.
+     * @return Index of the texture.
+     */
+    uint32_t addTexture(ResourceFormat format, uint32_t width, uint32_t height, std::vector<uint8_t> data);
+
+    /**
+     * Pack all added textures. Textures are grouped by format and packed into as few atlases as possible.
+     * Each atlas is shrunk to the area it uses.
+     */
+    void build();
+
+    const std::vector<Atlas>& getAtlases() const { return mAtlases; }
+    const Entry& getEntry(uint32_t index) const { return mEntries[index]; }
+    uint32_t getTextureCount() const { return (uint32_t)mEntries.size(); }
+
+    /**
+     * Get the transform from texture coordinates in [0,1) to atlas texture coordinates.
+     * @param[in] index Index of the texture.
+     * @return Scale (xy) and offset (zw).
+     */
+    float4 getUvTransform(uint32_t index) const;
+
+private:
+    struct Source
+    {
+        ResourceFormat format;
+        uint32_t width;
+        uint32_t height;
+        std::vector<uint8_t> data;
+    };
+
+    void writeCell(Atlas& atlas, const Entry& entry, const Source& source) const;
+
+    TextureAtlasSettings mSettings;
+    uint32_t mPadding;
+    std::vector<Source> mSources;
+    std::vector<Entry> mEntries;
+    std::vector<Atlas> mAtlases;
+};
+} // namespace Falcor
@@ -28,10 +28,14 @@
 #include "TextureManager.h"
 #include "Core/AssetResolver.h"
 #include "Core/API/Device.h"
+#include "Core/API/RenderContext.h"
 #include "Utils/Logger.h"
 #include "Utils/NumericRange.h"
+#include "Utils/Math/Common.h"
 
+#include <chrono>
 #include <execution>
+#include <optional>
 
 // Temporarily disable asynchronous texture loader until Falcor supports parallel GPU work submission.
 // Until then `TextureManager` should only called from the main thread.
@@ -43,11 +47,76 @@ namespace
 {
 const size_t kMaxTextureHandleCount = std::numeric_limits<uint32_t>::max();
 static_assert(TextureManager::CpuTextureHandle::kInvalidID >= kMaxTextureHandleCount);
+
+/**
+ * Compute the residency info for a texture.
+ * Levels of textures in block-compressed formats that are not block aligned can't become the most detailed level,
+ * as the most detailed level of a texture needs to consist of whole blocks.
+ */
+TextureResidencyManager::TextureInfo getResidencyInfo(const Texture& texture)
+{
+    ResourceFormat format = texture.getFormat();
+    uint32_t blockWidth = getFormatWidthCompressionRatio(format);
+    uint32_t blockHeight = getFormatHeightCompressionRatio(format);
+
+    TextureResidencyManager::TextureInfo info;
+    for (uint32_t mip = 0; mip < texture.getMipCount(); ++mip)
+    {
+        uint32_t width = texture.getWidth(mip);
+        uint32_t height = texture.getHeight(mip);
+        uint64_t blockCount = uint64_t(div_round_up(width, blockWidth)) * div_round_up(height, blockHeight);
+        info.mipSizes.push_back(blockCount * getFormatBytesPerBlock(format) * texture.getArraySize());
+        info.allowedMostDetailedMips.push_back(width % blockWidth == 0 && height % blockHeight == 0);
+    }
+    return info;
+}
+
+/// Get the offset in bytes of a mip level in loaded mip data.
+size_t getMipOffset(const ImageIO::MipLevels& levels, uint32_t arraySlice, uint32_t mip)
+{
+    auto getLevelSize = [&](uint32_t level)
+    {
+        uint32_t width = std::max(levels.width >> level, 1u);
+        uint32_t height = std::max(levels.height >> level, 1u);
+        return size_t(div_round_up(width, getFormatWidthCompressionRatio(levels.format))) *
+               div_round_up(height, getFormatHeightCompressionRatio(levels.format)) * getFormatBytesPerBlock(levels.format);
+    };
+
+    size_t sliceSize = 0;
+    size_t offset = 0;
+    for (uint32_t level = 0; level < levels.mipCount; ++level)
+    {
+        sliceSize += getLevelSize(level);
+        if (level < mip)
+            offset += getLevelSize(level);
+    }
+    return arraySlice * sliceSize + offset;
+}
 } // namespace
 
+/**
+ * Allocator forwarding residency changes from the residency manager to the texture manager.
+ */
+class TextureManager::ResidencyAllocator : public TextureResidencyManager::Allocator
+{
+public:
+    ResidencyAllocator(TextureManager& textureManager) : mTextureManager(textureManager) {}
+
+    Result setResidentMips(TextureResidencyManager::TextureID id, uint32_t currentMostDetailedMip, uint32_t mostDetailedMip) override
+    {
+        return mTextureManager.setResidentMips(CpuTextureHandle{id}, currentMostDetailedMip, mostDetailedMip);
+    }
+
+private:
+    TextureManager& mTextureManager;
+};
+
 TextureManager::TextureManager(ref<Device> pDevice, size_t maxTextureCount, size_t threadCount)
     : mpDevice(pDevice), mAsyncTextureLoader(pDevice, threadCount), mMaxTextureCount(std::min(maxTextureCount, kMaxTextureHandleCount))
-{}
+{
+    mpResidencyAllocator = std::make_unique<ResidencyAllocator>(*this);
+    mpResidencyManager = std::make_unique<TextureResidencyManager>(*mpResidencyAllocator);
+}
 
 TextureManager::~TextureManager() {}
 
@@ -62,7 +131,12 @@ TextureManager::CpuTextureHandle TextureManager::addTexture(const ref<Texture>&
     std::lock_guard<std::mutex> lock(mMutex);
     CpuTextureHandle handle;
 
-    if (auto it = mTextureToHandle.find(pTexture.get()); it != mTextureToHandle.end())
+    if (auto it = mTextureToAtlasHandle.find(pTexture.get()); it != mTextureToAtlasHandle.end())
+    {
+        // Texture has been packed into an atlas. Return its atlas handle.
+        handle = it->second;
+    }
+    else if (auto it = mTextureToHandle.find(pTexture.get()); it != mTextureToHandle.end())
     {
         // Texture is already managed. Return its handle.
         handle = it->second;
@@ -306,7 +380,10 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
 
             // Add to texture-to-handle map.
             if (pTexture)
+            {
                 mTextureToHandle[pTexture.get()] = handle;
+                registerResidency(handle, textureKey);
+            }
 
             mLoadRequestsInProgress--;
             mCondition.notify_all();
@@ -342,7 +419,10 @@ TextureManager::CpuTextureHandle TextureManager::loadTexture(
 
         // Add to texture-to-handle map.
         if (pTexture)
+        {
             mTextureToHandle[pTexture.get()] = handle;
+            registerResidency(handle, textureKey);
+        }
 
         mCondition.notify_all();
 #endif
@@ -447,6 +527,8 @@ void TextureManager::endDeferredLoading()
         auto& desc = getDesc(job.handle);
         desc.state = desc.pTexture ? TextureState::Loaded : TextureState::Invalid;
         mTextureToHandle[desc.pTexture.get()] = job.handle;
+        if (desc.pTexture)
+            registerResidency(job.handle, job.key);
     }
 }
 
@@ -465,6 +547,10 @@ void TextureManager::removeTexture(const CpuTextureHandle& handle)
 
 void TextureManager::removeTextureInternal(const CpuTextureHandle& handle)
 {
+    // Atlas entries are kept, as other textures in the same atlas may still be in use.
+    if (handle.isAtlas())
+        return;
+
     if (handle.isUdim())
         removeUdimTexture(handle);
     else
@@ -498,6 +584,11 @@ void TextureManager::removeNonUdimTexture(const CpuTextureHandle& handle)
         mTextureToHandle.erase(desc.pTexture.get());
     }
 
+    // Remove from residency management.
+    mpResidencyManager->removeTexture(handle.getID());
+    mResidencySources.erase(handle.getID());
+    mMipLoads.erase(handle.getID());
+
     // Clear texture desc.
     desc = {};
 
@@ -546,6 +637,12 @@ TextureManager::TextureDesc TextureManager::getTextureDesc(const CpuTextureHandl
 
     std::lock_guard<std::mutex> lock(mMutex);
     FALCOR_CHECK(!handle.isUdim(), "Can't lookup texture desc from handle to UDIM texture. Resolve UDIM first.");
+    if (handle.isAtlas())
+    {
+        // Return the original texture for atlas handles.
+        FALCOR_CHECK(handle.getID() < mAtlasSourceTextures.size(), "Invalid atlas texture handle.");
+        return {TextureState::Loaded, mAtlasSourceTextures[handle.getID()]};
+    }
     FALCOR_CHECK(handle && handle.getID() < mTextureDescs.size(), "Invalid texture handle.");
     return mTextureDescs[handle.getID()];
 }
@@ -578,7 +675,13 @@ std::vector<uint32_t> TextureManager::getUdimIDs(const CpuTextureHandle& handle)
     return udimIDs;
 }
 
-void TextureManager::bindShaderData(const ShaderVar& texturesVar, const size_t descCount, const ShaderVar& udimsVar) const
+size_t TextureManager::bindShaderData(
+    const ShaderVar& texturesVar,
+    const size_t descCount,
+    const ShaderVar& udimsVar,
+    const ShaderVar& atlasesVar,
+    bool incremental
+) const
 {
     std::lock_guard<std::mutex> lock(mMutex);
 
@@ -587,42 +690,175 @@ void TextureManager::bindShaderData(const ShaderVar& texturesVar, const size_t d
         FALCOR_THROW("Descriptor array size ({}) is too small for the required number of textures ({})", descCount, mTextureDescs.size());
     }
 
-    ref<Texture> nullTexture;
-    for (size_t i = 0; i < mTextureDescs.size(); i++)
+    // Write the descriptors. In incremental mode only the ones that differ from the last call are written.
+    // The bound textures are recorded for the whole array, where unused entries are null.
+    if (!incremental || mBoundTextures.size() != descCount)
+    {
+        mBoundTextures.assign(descCount, nullptr);
+        incremental = false;
+    }
+
+    size_t writeCount = 0;
+    for (size_t i = 0; i < descCount; i++)
     {
-        texturesVar[i] = mTextureDescs[i].pTexture;
+        const ref<Texture>& pTexture = i < mTextureDescs.size() ? mTextureDescs[i].pTexture : nullptr;
+        if (incremental && mBoundTextures[i] == pTexture)
+            continue;
+        texturesVar[i] = pTexture;
+        mBoundTextures[i] = pTexture;
+        writeCount++;
     }
-    for (size_t i = mTextureDescs.size(); i < descCount; i++)
+
+    // Atlas entries only change in packTextureAtlases(), which resets the buffer.
+    if (!mAtlasEntries.empty())
     {
-        texturesVar[i] = nullTexture;
+        if (!mpAtlasEntries)
+        {
+            mpAtlasEntries = mpDevice->createStructuredBuffer(
+                sizeof(TextureAtlasEntry),
+                (uint32_t)mAtlasEntries.size(),
+                ResourceBindFlags::ShaderResource,
+                MemoryType::DeviceLocal,
+                mAtlasEntries.data(),
+                false
+            );
+        }
+        atlasesVar = mpAtlasEntries;
     }
 
     if (mUdimIndirection.empty())
     {
         mpUdimIndirection.reset();
-        mUdimIndirectionDirty = false;
-        return;
+        mGpuUdimIndirection.clear();
+        return writeCount;
+    }
+
+    // UDIM tiles can be stored in different reduced formats, so the GPU table packs the channel swizzle of each tile
+    // above its texture ID. Tiles may finish loading after they were added, so the table is rebuilt on every call
+    // and only uploaded if it changed.
+    std::vector<int32_t> udimIndirection = mUdimIndirection;
+    for (int32_t& entry : udimIndirection)
+    {
+        if (entry < 0)
+            continue;
+        const auto& pTexture = mTextureDescs[entry].pTexture;
+        if (pTexture)
+            entry |= (int32_t)pTexture->getChannelSwizzle() << TextureHandle::kTextureIDBits;
     }
 
-    if (!mpUdimIndirection || mUdimIndirection.size() > mpUdimIndirection->getElementCount())
+    if (!mpUdimIndirection || udimIndirection.size() > mpUdimIndirection->getElementCount())
     {
         mpUdimIndirection = mpDevice->createStructuredBuffer(
             sizeof(int32_t),
-            mUdimIndirection.size(),
+            udimIndirection.size(),
             ResourceBindFlags::ShaderResource | ResourceBindFlags::UnorderedAccess,
             MemoryType::DeviceLocal,
-            mUdimIndirection.data(),
+            udimIndirection.data(),
             false
         );
-        mUdimIndirectionDirty = false;
     }
-
-    if (mUdimIndirectionDirty)
+    else if (udimIndirection != mGpuUdimIndirection)
     {
-        mpUdimIndirection->setBlob(mUdimIndirection.data(), 0, mUdimIndirection.size() * sizeof(int32_t));
+        mpUdimIndirection->setBlob(udimIndirection.data(), 0, udimIndirection.size() * sizeof(int32_t));
     }
+    mGpuUdimIndirection = std::move(udimIndirection);
 
     udimsVar = mpUdimIndirection;
+    return writeCount;
+}
+
+size_t TextureManager::packTextureAtlases(const TextureAtlasSettings& settings)
+{
+    waitForAllTexturesLoading();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+
+    // Collect the textures to pack. UDIM tiles are referenced by the indirection table and are left alone.
+    std::set<int32_t> udimTextureIDs(mUdimIndirection.begin(), mUdimIndirection.end());
+    TextureAtlasBuilder builder(settings);
+    std::vector<CpuTextureHandle> handles;
+    for (uint32_t id = 0; id < (uint32_t)mTextureDescs.size(); id++)
+    {
+        const auto& pTexture = mTextureDescs[id].pTexture;
+        if (!pTexture || udimTextureIDs.count((int32_t)id) > 0 || pTexture->getArraySize() != 1)
+            continue;
+        if (!builder.canPack(pTexture->getFormat(), pTexture->getWidth(), pTexture->getHeight()))
+            continue;
+
+        std::vector<uint8_t> data(size_t(pTexture->getWidth()) * pTexture->getHeight() * getFormatBytesPerBlock(pTexture->getFormat()));
+        pTexture->getSubresourceBlob(pTexture->getSubresourceIndex(0, 0), data.data(), data.size());
+        builder.addTexture(pTexture->getFormat(), pTexture->getWidth(), pTexture->getHeight(), std::move(data));
+        handles.push_back(CpuTextureHandle{id});
+    }
+
+    if (handles.size() < 2)
+        return 0;
+
+    builder.build();
+
+    // Remove the packed textures first, so that the atlases reuse their handles.
+    // Ownership is transferred to the atlases below, so that an atlas is removed when all its textures are unused.
+    const uint32_t firstEntry = (uint32_t)mAtlasEntries.size();
+    std::vector<Objects> atlasOwners(builder.getAtlases().size());
+    for (uint32_t i = 0; i < (uint32_t)handles.size(); i++)
+    {
+        const auto& handle = handles[i];
+        CpuTextureHandle atlasHandle{firstEntry + i, false, true};
+        ref<Texture> pTexture = getDesc(handle).pTexture;
+        mAtlasSourceTextures.push_back(pTexture);
+        mTextureToAtlasHandle[pTexture.get()] = atlasHandle;
+
+        if (auto it = mHandleToObjects.find(handle); it != mHandleToObjects.end())
+        {
+            for (const Object* owner : it->second)
+            {
+                atlasOwners[builder.getEntry(i).atlasIndex].insert(owner);
+                mObjectToHandles[owner].erase(handle);
+            }
+        }
+        removeTextureInternal(handle);
+    }
+
+    std::vector<CpuTextureHandle> atlasHandles;
+    for (uint32_t a = 0; a < (uint32_t)builder.getAtlases().size(); a++)
+    {
+        const auto& atlas = builder.getAtlases()[a];
+        ref<Texture> pAtlas = mpDevice->createTexture2D(
+            atlas.width, atlas.height, atlas.format, 1, settings.mipLevels, nullptr, ResourceBindFlags::ShaderResource | ResourceBindFlags::RenderTarget
+        );
+        pAtlas->setSubresourceBlob(pAtlas->getSubresourceIndex(0, 0), atlas.data.data(), atlas.data.size());
+        pAtlas->generateMips(mpDevice->getRenderContext());
+
+        CpuTextureHandle atlasHandle = addDesc({TextureState::Loaded, pAtlas});
+        mTextureToHandle[pAtlas.get()] = atlasHandle;
+        for (const Object* owner : atlasOwners[a])
+            registerOwner(atlasHandle, owner);
+        atlasHandles.push_back(atlasHandle);
+    }
+
+    for (uint32_t i = 0; i < (uint32_t)handles.size(); i++)
+    {
+        const auto& entry = builder.getEntry(i);
+        float4 transform = builder.getUvTransform(i);
+        TextureAtlasEntry atlasEntry = {};
+        atlasEntry.textureID = atlasHandles[entry.atlasIndex].getID();
+        atlasEntry.width = entry.size.x;
+        atlasEntry.height = entry.size.y;
+        atlasEntry.mipLevels = settings.mipLevels;
+        atlasEntry.uvScale = transform.xy();
+        atlasEntry.uvOffset = transform.zw();
+        mAtlasEntries.push_back(atlasEntry);
+    }
+    mpAtlasEntries.reset();
+
+    logInfo("Texture manager: Packed {} textures into {} atlases.", handles.size(), atlasHandles.size());
+    return handles.size();
+}
+
+size_t TextureManager::getAtlasEntryCount() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mAtlasEntries.size();
 }
 
 TextureManager::Stats TextureManager::getStats() const
@@ -645,6 +881,194 @@ TextureManager::Stats TextureManager::getStats() const
     return s;
 }
 
+void TextureManager::setMemoryBudget(uint64_t budgetInBytes)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mpResidencyManager->setBudget(budgetInBytes);
+}
+
+uint64_t TextureManager::getMemoryBudget() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mpResidencyManager->getBudget();
+}
+
+void TextureManager::requestTextureMips(const CpuTextureHandle& handle, uint32_t mostDetailedMip)
+{
+    if (!handle)
+        return;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if (handle.isUdim())
+    {
+        size_t rangeStart = handle.getID();
+        FALCOR_CHECK(rangeStart < mUdimIndirectionSize.size(), "Handle is out of range.");
+        for (size_t i = rangeStart; i < rangeStart + mUdimIndirectionSize[rangeStart]; ++i)
+        {
+            if (mUdimIndirection[i] < 0)
+                continue;
+            uint32_t id = (uint32_t)mUdimIndirection[i];
+            if (mpResidencyManager->hasTexture(id))
+                mpResidencyManager->requestMip(id, mostDetailedMip);
+        }
+    }
+    else if (mpResidencyManager->hasTexture(handle.getID()))
+    {
+        mpResidencyManager->requestMip(handle.getID(), mostDetailedMip);
+    }
+}
+
+bool TextureManager::updateResidency()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mpResidencyManager->update();
+}
+
+TextureResidencyManager::Stats TextureManager::getResidencyStats() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mpResidencyManager->getStats();
+}
+
+void TextureManager::registerResidency(const CpuTextureHandle& handle, const TextureKey& key)
+{
+    // Only textures loaded from file are managed, as trimmed levels are streamed back in by reloading the source files.
+    const auto& pTexture = getDesc(handle).pTexture;
+    FALCOR_ASSERT(pTexture);
+    if (pTexture->getType() != Resource::Type::Texture2D || pTexture->getSampleCount() != 1)
+        return;
+
+    auto info = getResidencyInfo(*pTexture);
+    if (!info.allowedMostDetailedMips[0])
+        return;
+
+    mpResidencyManager->addTexture(handle.getID(), info);
+    mResidencySources.emplace(handle.getID(), key);
+}
+
+TextureResidencyManager::Allocator::Result TextureManager::setResidentMips(
+    const CpuTextureHandle& handle,
+    uint32_t currentMostDetailedMip,
+    uint32_t mostDetailedMip
+)
+{
+    // Called from updateResidency() with the mutex held.
+    using Result = TextureResidencyManager::Allocator::Result;
+    const ref<Texture>& pTexture = getDesc(handle).pTexture;
+    if (!pTexture)
+        return Result::Failed;
+
+    // Trimmed levels are streamed back in by loading only the missing levels from the source files on a worker thread.
+    // The residency stays unchanged until the levels are available.
+    std::optional<ImageIO::MipLevels> levels;
+    uint32_t loadedFirstMip = 0;
+    if (mostDetailedMip < currentMostDetailedMip)
+    {
+        auto sourceIt = mResidencySources.find(handle.getID());
+        if (sourceIt == mResidencySources.end())
+            return Result::Failed;
+
+        // Discard loads that don't cover the requested levels.
+        auto it = mMipLoads.find(handle.getID());
+        if (it != mMipLoads.end() && (mostDetailedMip < it->second.firstMip || currentMostDetailedMip > it->second.endMip))
+        {
+            mMipLoads.erase(it);
+            it = mMipLoads.end();
+        }
+
+        if (it == mMipLoads.end())
+        {
+            const TextureKey& key = sourceIt->second;
+            MipLoad load;
+            load.firstMip = mostDetailedMip;
+            load.endMip = currentMostDetailedMip;
+            load.levels = mAsyncTextureLoader.loadMipLevels(
+                key.fullPaths,
+                key.generateMipLevels,
+                key.loadAsSRGB,
+                key.importFlags,
+                pTexture->getFormat(),
+                mostDetailedMip,
+                currentMostDetailedMip - mostDetailedMip
+            );
+            mMipLoads.emplace(handle.getID(), std::move(load));
+            return Result::Pending;
+        }
+
+        if (it->second.levels.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+            return Result::Pending;
+
+        loadedFirstMip = it->second.firstMip;
+        try
+        {
+            levels = it->second.levels.get();
+        }
+        catch (const std::exception& e)
+        {
+            logWarning("TextureManager: Failed to load mip levels of texture '{}': {}", pTexture->getSourcePath(), e.what());
+        }
+        mMipLoads.erase(it);
+
+        if (!levels || levels->arraySize != pTexture->getArraySize())
+            return Result::Failed;
+    }
+    else
+    {
+        mMipLoads.erase(handle.getID());
+    }
+
+    try
+    {
+        // Create storage for the new resident levels and swap it into the existing texture, so that references to it remain valid.
+        // Levels that stay resident are copied on the GPU, streamed in levels are uploaded from the loaded data.
+        const uint32_t mipCount = currentMostDetailedMip + pTexture->getMipCount() - mostDetailedMip;
+        const uint32_t width = levels ? std::max(levels->width >> (mostDetailedMip - loadedFirstMip), 1u)
+                                      : pTexture->getWidth(mostDetailedMip - currentMostDetailedMip);
+        const uint32_t height = levels ? std::max(levels->height >> (mostDetailedMip - loadedFirstMip), 1u)
+                                       : pTexture->getHeight(mostDetailedMip - currentMostDetailedMip);
+        ref<Texture> pResident =
+            mpDevice->createTexture2D(width, height, pTexture->getFormat(), pTexture->getArraySize(), mipCount, nullptr, pTexture->getBindFlags());
+
+        RenderContext* pRenderContext = mpDevice->getRenderContext();
+        for (uint32_t arraySlice = 0; arraySlice < pTexture->getArraySize(); ++arraySlice)
+        {
+            for (uint32_t mip = 0; mip < mipCount; ++mip)
+            {
+                const uint32_t level = mostDetailedMip + mip;
+                if (level < currentMostDetailedMip)
+                {
+                    pRenderContext->updateSubresourceData(
+                        pResident.get(),
+                        pResident->getSubresourceIndex(arraySlice, mip),
+                        levels->data.data() + getMipOffset(*levels, arraySlice, level - loadedFirstMip)
+                    );
+                }
+                else
+                {
+                    pRenderContext->copySubresource(
+                        pResident.get(),
+                        pResident->getSubresourceIndex(arraySlice, mip),
+                        pTexture.get(),
+                        pTexture->getSubresourceIndex(arraySlice, level - currentMostDetailedMip)
+                    );
+                }
+            }
+        }
+        pTexture->swapStorage(*pResident);
+
+        // Swapping invalidates the views of the texture, so the next incremental bind has to rewrite its descriptor.
+        if (handle.getID() < mBoundTextures.size())
+            mBoundTextures[handle.getID()] = nullptr;
+    }
+    catch (const std::exception& e)
+    {
+        logWarning("TextureManager: Failed to change resident mip levels of texture '{}': {}", pTexture->getSourcePath(), e.what());
+        return Result::Failed;
+    }
+
+    return Result::Success;
+}
+
 TextureManager::CpuTextureHandle TextureManager::addDesc(const TextureDesc& desc)
 {
     CpuTextureHandle handle;
@@ -672,6 +1096,7 @@ TextureManager::CpuTextureHandle TextureManager::addDesc(const TextureDesc& desc
 TextureManager::TextureDesc& TextureManager::getDesc(const CpuTextureHandle& handle)
 {
     FALCOR_CHECK(!handle.isUdim(), "Can't lookup texture desc from handle to UDIM texture. Resolve UDIM first.");
+    FALCOR_CHECK(!handle.isAtlas(), "Can't lookup texture desc from handle to atlas texture.");
     FALCOR_CHECK(handle && handle.getID() < mTextureDescs.size(), "Invalid texture handle.");
     return mTextureDescs[handle.getID()];
 }
@@ -716,8 +1141,6 @@ size_t TextureManager::getUdimRange(size_t requiredSize)
         return rangeStart;
     }
 
-    mUdimIndirectionDirty = true;
-
     // Range is already filled with -1 from the deletion
     const size_t rangeStart = mFreeUdimRanges[foundIndex];
     mFreeUdimRanges[foundIndex] = mFreeUdimRanges.back();
@@ -727,7 +1150,6 @@ size_t TextureManager::getUdimRange(size_t requiredSize)
 
 void TextureManager::freeUdimRange(size_t rangeStart)
 {
-    mUdimIndirectionDirty = true;
     mFreeUdimRanges.push_back(rangeStart);
 }
 
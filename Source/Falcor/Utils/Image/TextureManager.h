@@ -27,6 +27,8 @@
  **************************************************************************/
 #pragma once
 #include "AsyncTextureLoader.h"
+#include "TextureAtlas.h"
+#include "TextureResidencyManager.h"
 #include "Core/Macros.h"
 #include "Core/API/fwd.h"
 #include "Core/API/Resource.h"
@@ -87,7 +89,7 @@ public:
         CpuTextureHandle() = default;
         explicit CpuTextureHandle(uint32_t id) : mID(id) {}
 
-        explicit CpuTextureHandle(uint32_t id, bool isUdim) : mID(id), mIsUdim(isUdim) {}
+        explicit CpuTextureHandle(uint32_t id, bool isUdim, bool isAtlas = false) : mID(id), mIsUdim(isUdim), mIsAtlas(isAtlas) {}
 
         explicit CpuTextureHandle(const TextureHandle& gpuHandle)
         {
@@ -96,6 +98,11 @@ public:
                 mID = gpuHandle.getTextureID();
                 mIsUdim = gpuHandle.getUdimEnabled();
             }
+            else if (gpuHandle.getMode() == TextureHandle::Mode::Atlas)
+            {
+                mID = gpuHandle.getTextureID();
+                mIsAtlas = true;
+            }
         }
 
         bool isValid() const { return mID != kInvalidID; }
@@ -103,9 +110,11 @@ public:
 
         uint32_t getID() const { return mID; }
         bool isUdim() const { return mIsUdim; }
+        /// Returns true if the handle refers to a texture packed into an atlas. The ID is then the index of the atlas entry.
+        bool isAtlas() const { return mIsAtlas; }
 
         bool operator<(const CpuTextureHandle& other) const { return mID < other.mID; }
-        bool operator==(const CpuTextureHandle& other) const { return mID == other.mID && mIsUdim == other.mIsUdim; }
+        bool operator==(const CpuTextureHandle& other) const { return mID == other.mID && mIsUdim == other.mIsUdim && mIsAtlas == other.mIsAtlas; }
 
         TextureHandle toGpuHandle() const
         {
@@ -113,7 +122,7 @@ public:
             if (isValid())
             {
                 gpuHandle.setTextureID(this->getID());
-                gpuHandle.setMode(TextureHandle::Mode::Texture);
+                gpuHandle.setMode(this->isAtlas() ? TextureHandle::Mode::Atlas : TextureHandle::Mode::Texture);
                 gpuHandle.setUdimEnabled(this->isUdim());
             }
             else
@@ -127,6 +136,7 @@ public:
     private:
         uint32_t mID{kInvalidID};
         bool mIsUdim{false};
+        bool mIsAtlas{false};
     };
 
     /// Struct describing a managed texture.
@@ -151,6 +161,7 @@ public:
     /**
      * Add a texture to the manager.
      * If the texture is already managed, its existing handle is returned.
+     * If the texture has been packed into an atlas, a handle to its atlas entry is returned.
      * @param[in] pTexture The texture resource.
      * @return Unique handle to the texture.
      */
@@ -264,6 +275,22 @@ public:
      */
     size_t getUdimIndirectionCount() const { return mUdimIndirection.size(); }
 
+    /**
+     * Pack small textures into shared atlases.
+     * All loaded, uncompressed 2D textures up to the max texture size are packed, except for UDIM tiles.
+     * Their texture descs are replaced by the atlases, and addTexture() returns atlas handles for them from then on,
+     * so materials need to update their texture handles afterwards. Atlased textures are always sampled with
+     * wrap addressing and have at most the atlas mip levels.
+     * @param[in] settings Atlas settings.
+     * @return Number of textures packed.
+     */
+    size_t packTextureAtlases(const TextureAtlasSettings& settings = {});
+
+    /**
+     * Number of atlas entries. This is used to determine whether atlases should be enabled.
+     */
+    size_t getAtlasEntryCount() const;
+
     /**
      * Bind all textures into a shader var.
      * The shader var should refer to a Texture2D descriptor array of fixed size.
@@ -271,14 +298,61 @@ public:
      * This restriction will go away when unbounded descriptor arrays are supported (see #1321).
      * @param[in] var Shader var for descriptor array.
      * @param[in] descCount Size of descriptor array.
+     * @param[in] udimsVar Shader var for the UDIM indirection buffer.
+     * @param[in] atlasesVar Shader var for the atlas entry buffer.
+     * @param[in] incremental If true, only descriptors whose texture or texture storage changed since the last call are written.
+     *            This requires the shader vars to refer to the same parameter block as in the last call.
+     * @return Number of texture descriptors written.
      */
-    void bindShaderData(const ShaderVar& texturesVar, const size_t descCount, const ShaderVar& udimsVar) const;
+    size_t bindShaderData(
+        const ShaderVar& texturesVar,
+        const size_t descCount,
+        const ShaderVar& udimsVar,
+        const ShaderVar& atlasesVar,
+        bool incremental = false
+    ) const;
 
     /**
      * Returns stats for the textures
      */
     Stats getStats() const;
 
+    /**
+     * Set the memory budget for textures loaded from file.
+     * Loaded textures start out fully resident. When the budget is exceeded, updateResidency() trims the least
+     * valuable mip levels (see TextureResidencyManager). Trimmed levels are streamed back in when requested:
+     * only the missing levels are loaded from the source files on a worker thread, and they become resident
+     * on a later call to updateResidency() once loaded. Textures added with addTexture() are not managed.
+     * @param[in] budgetInBytes Memory budget in bytes, or 0 for an unlimited budget.
+     */
+    void setMemoryBudget(uint64_t budgetInBytes);
+
+    /**
+     * Get the memory budget for textures loaded from file (0 means unlimited).
+     */
+    uint64_t getMemoryBudget() const;
+
+    /**
+     * Request mip levels of a texture to be resident.
+     * This marks the texture as used in the current frame. For UDIM textures all tiles are requested.
+     * @param[in] handle Texture handle.
+     * @param[in] mostDetailedMip Most detailed mip level needed.
+     */
+    void requestTextureMips(const CpuTextureHandle& handle, uint32_t mostDetailedMip = 0);
+
+    /**
+     * Apply the residency policy. Should be called once per frame.
+     * Trimmed levels are released immediately. Levels to stream in are loaded in the background and uploaded on a later call.
+     * Textures are changed in place, but their views are recreated, so shader data needs to be rebound if this returns true.
+     * @return True if the resident mip levels of any texture changed.
+     */
+    bool updateResidency();
+
+    /**
+     * Returns residency stats for the textures loaded from file.
+     */
+    TextureResidencyManager::Stats getResidencyStats() const;
+
 private:
     size_t getUdimRange(size_t requiredSize);
     void freeUdimRange(size_t rangeStart);
@@ -339,6 +413,15 @@ private:
         }
     };
 
+    class ResidencyAllocator;
+
+    void registerResidency(const CpuTextureHandle& handle, const TextureKey& key);
+    TextureResidencyManager::Allocator::Result setResidentMips(
+        const CpuTextureHandle& handle,
+        uint32_t currentMostDetailedMip,
+        uint32_t mostDetailedMip
+    );
+
     CpuTextureHandle addDesc(const TextureDesc& desc);
     TextureDesc& getDesc(const CpuTextureHandle& handle);
     void registerOwner(const CpuTextureHandle& handle, const Object* owner);
@@ -360,9 +443,16 @@ private:
     /// Free ranges in the udimIndirection, when a UDIM texture is deleted (contains first position)
     std::vector<size_t> mFreeUdimRanges;
 
-    mutable bool mUdimIndirectionDirty = true;
+    mutable std::vector<int32_t> mGpuUdimIndirection; ///< UDIM indirection table last uploaded to the GPU, with tile swizzles packed above the texture IDs.
     mutable ref<Buffer> mpUdimIndirection;
 
+    mutable std::vector<ref<Texture>> mBoundTextures; ///< Textures written to the descriptor array in the last bindShaderData() call, indexed by handle ID.
+
+    std::vector<TextureAtlasEntry> mAtlasEntries;                 ///< Atlas entries, indexed by atlas handle ID.
+    std::vector<ref<Texture>> mAtlasSourceTextures;               ///< Original texture of each atlas entry. Kept alive so its pointer stays unique.
+    std::map<const Texture*, CpuTextureHandle> mTextureToAtlasHandle; ///< Map from texture ptr to atlas handle.
+    mutable ref<Buffer> mpAtlasEntries;
+
     using Objects = std::set<const Object*>;
     using Handles = std::set<CpuTextureHandle>;
     std::map<CpuTextureHandle, Objects> mHandleToObjects; ///< Map from texture handle to set of objects using the handle.
@@ -374,5 +464,18 @@ private:
     size_t mLoadRequestsInProgress = 0;     ///< Number of load requests currently in progress.
 
     const size_t mMaxTextureCount; ///< Maximum number of textures that can be simultaneously managed.
+
+    std::unique_ptr<ResidencyAllocator> mpResidencyAllocator;      ///< Allocator changing the resident mip levels on the GPU.
+    std::unique_ptr<TextureResidencyManager> mpResidencyManager;  ///< Residency policy for textures loaded from file.
+    std::map<uint32_t, TextureKey> mResidencySources;              ///< Map from handle ID to the key used for reloading trimmed levels.
+
+    /// Mip levels [firstMip, endMip) of a texture being loaded for streaming in.
+    struct MipLoad
+    {
+        uint32_t firstMip = 0;
+        uint32_t endMip = 0;
+        std::future<ImageIO::MipLevels> levels;
+    };
+    std::map<uint32_t, MipLoad> mMipLoads; ///< Map from handle ID to the mip levels being loaded.
 };
 } // namespace Falcor
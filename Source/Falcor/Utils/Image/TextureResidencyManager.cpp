@@ -0,0 +1,308 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "TextureResidencyManager.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <queue>
+#include <tuple>
+
+namespace Falcor
+{
+uint64_t TextureResidencyManager::TextureData::getSize(uint32_t mostDetailedMip) const
+{
+    uint64_t size = 0;
+    for (uint32_t mip = mostDetailedMip; mip < mipSizes.size(); mip++)
+        size += mipSizes[mip];
+    return size;
+}
+
+uint32_t TextureResidencyManager::TextureData::getFinerMip(uint32_t mip) const
+{
+    while (mip-- > 0)
+    {
+        if (allowedMips[mip])
+            return mip;
+    }
+    return kMaxMip;
+}
+
+uint32_t TextureResidencyManager::TextureData::getCoarserMip(uint32_t mip) const
+{
+    while (++mip < allowedMips.size())
+    {
+        if (allowedMips[mip])
+            return mip;
+    }
+    return kMaxMip;
+}
+
+TextureResidencyManager::TextureResidencyManager(Allocator& allocator, uint64_t budgetInBytes)
+    : mAllocator(allocator), mBudget(budgetInBytes)
+{}
+
+void TextureResidencyManager::addTexture(TextureID id, const TextureInfo& info, uint32_t mostDetailedMip)
+{
+    FALCOR_CHECK(!hasTexture(id), "Texture {} is already managed.", id);
+    FALCOR_CHECK(!info.mipSizes.empty(), "Texture {} has no mip levels.", id);
+    FALCOR_CHECK(mostDetailedMip < info.mipSizes.size(), "Resident mip level {} is out of range for texture {}.", mostDetailedMip, id);
+
+    FALCOR_CHECK(
+        info.allowedMostDetailedMips.empty() || info.allowedMostDetailedMips.size() == info.mipSizes.size(),
+        "Allowed mip levels of texture {} don't match its mip count.",
+        id
+    );
+
+    TextureData data;
+    data.mipSizes = info.mipSizes;
+    data.allowedMips.resize(info.mipSizes.size());
+    for (uint32_t mip = 0; mip < data.allowedMips.size(); mip++)
+        data.allowedMips[mip] = mip <= info.maxMostDetailedMip && (info.allowedMostDetailedMips.empty() || info.allowedMostDetailedMips[mip]);
+    FALCOR_CHECK(data.allowedMips[mostDetailedMip], "Resident mip level {} of texture {} is not an allowed most detailed level.", mostDetailedMip, id);
+
+    data.residentMip = mostDetailedMip;
+    data.requestedMip = mostDetailedMip;
+    data.targetMip = mostDetailedMip;
+    data.lastUsedFrame = mFrame;
+    data.requestedThisFrame = true;
+
+    mResidentBytes += data.getSize(mostDetailedMip);
+    mTextures.emplace(id, std::move(data));
+}
+
+void TextureResidencyManager::removeTexture(TextureID id)
+{
+    auto it = mTextures.find(id);
+    if (it == mTextures.end())
+        return;
+
+    mResidentBytes -= it->second.getSize(it->second.residentMip);
+    mTextures.erase(it);
+}
+
+void TextureResidencyManager::requestMip(TextureID id, uint32_t mostDetailedMip)
+{
+    auto& data = getTexture(id);
+    mostDetailedMip = std::min(mostDetailedMip, (uint32_t)data.mipSizes.size() - 1);
+    if (!data.allowedMips[mostDetailedMip])
+    {
+        uint32_t finerMip = data.getFinerMip(mostDetailedMip);
+        mostDetailedMip = finerMip != kMaxMip ? finerMip : data.getCoarserMip(mostDetailedMip);
+    }
+
+    data.requestedMip = data.requestedThisFrame ? std::min(data.requestedMip, mostDetailedMip) : mostDetailedMip;
+    data.requestedThisFrame = true;
+    data.lastUsedFrame = mFrame;
+}
+
+bool TextureResidencyManager::update()
+{
+    uint64_t plannedBytes = mResidentBytes;
+    for (auto& [id, data] : mTextures)
+        data.targetMip = data.residentMip;
+
+    // Enforce the budget. Levels of textures used in this frame are trimmed as a last resort.
+    if (mBudget > 0 && plannedBytes > mBudget)
+        planTrim(plannedBytes - mBudget, true, true, plannedBytes);
+
+    // Stream in requested levels, one level at a time with the smallest pending level first.
+    // This spreads the available memory across all requested textures before any of them gets its most detailed levels.
+    // Levels that can't be the most detailed level are streamed in together with the next more detailed allowed level.
+    {
+        using Entry = std::pair<uint64_t, TextureID>; // Size of next level, texture ID.
+        std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pending;
+        auto addPending = [&](TextureID id, const TextureData& data)
+        {
+            if (data.requestedThisFrame && data.requestedMip < data.targetMip)
+                pending.emplace(data.getSize(data.getFinerMip(data.targetMip)) - data.getSize(data.targetMip), id);
+        };
+        for (const auto& [id, data] : mTextures)
+            addPending(id, data);
+
+        while (!pending.empty())
+        {
+            auto [size, id] = pending.top();
+            pending.pop();
+
+            if (mBudget > 0 && plannedBytes + size > mBudget)
+            {
+                // Only trim levels that are not needed in this frame to make room.
+                if (!planTrim(plannedBytes + size - mBudget, false, false, plannedBytes))
+                    continue;
+            }
+
+            auto& data = getTexture(id);
+            data.targetMip = data.getFinerMip(data.targetMip);
+            plannedBytes += size;
+            addPending(id, data);
+        }
+    }
+
+    // Apply the planned residency. Trims are applied first to release memory before allocating.
+    std::vector<TextureID> trims, streams;
+    for (const auto& [id, data] : mTextures)
+    {
+        if (data.targetMip > data.residentMip)
+            trims.push_back(id);
+        else if (data.targetMip < data.residentMip)
+            streams.push_back(id);
+    }
+    std::sort(trims.begin(), trims.end());
+    std::sort(streams.begin(), streams.end());
+
+    bool changed = false;
+    auto apply = [&](TextureID id)
+    {
+        auto& data = getTexture(id);
+        auto result = mAllocator.setResidentMips(id, data.residentMip, data.targetMip);
+        data.pending = result == Allocator::Result::Pending;
+        if (result != Allocator::Result::Success)
+        {
+            if (result == Allocator::Result::Failed)
+                mFailedRequests++;
+            data.targetMip = data.residentMip;
+            return;
+        }
+
+        if (data.targetMip > data.residentMip)
+            mTrimmedLevels += data.targetMip - data.residentMip;
+        else
+            mStreamedLevels += data.residentMip - data.targetMip;
+
+        mResidentBytes -= data.getSize(data.residentMip);
+        mResidentBytes += data.getSize(data.targetMip);
+        data.residentMip = data.targetMip;
+        changed = true;
+    };
+    for (TextureID id : trims)
+        apply(id);
+    for (TextureID id : streams)
+        apply(id);
+
+    // Advance to the next frame. Loads for textures that are no longer planned to stream in are abandoned.
+    for (auto& [id, data] : mTextures)
+    {
+        if (std::find(streams.begin(), streams.end(), id) == streams.end())
+            data.pending = false;
+        data.requestedThisFrame = false;
+    }
+    mFrame++;
+
+    return changed;
+}
+
+bool TextureResidencyManager::planTrim(uint64_t bytesToFree, bool allowUsed, bool allowPartial, uint64_t& plannedBytes)
+{
+    // Candidates are ordered by (not excess, last used frame, -level size, ID), the top of the queue being the least valuable level.
+    using Key = std::tuple<bool, uint64_t, int64_t, TextureID>;
+    std::priority_queue<Key, std::vector<Key>, std::greater<Key>> candidates;
+
+    // Levels that can't be the most detailed level are trimmed together with the next more detailed allowed level.
+    auto getTrimSize = [](const TextureData& data) { return data.getSize(data.targetMip) - data.getSize(data.getCoarserMip(data.targetMip)); };
+    auto addCandidate = [&](TextureID id, const TextureData& data)
+    {
+        if (data.getCoarserMip(data.targetMip) == kMaxMip)
+            return;
+        bool excess = data.targetMip < data.requestedMip;
+        if (!excess && data.requestedThisFrame && !allowUsed)
+            return;
+        candidates.emplace(!excess, data.lastUsedFrame, -(int64_t)getTrimSize(data), id);
+    };
+
+    for (const auto& [id, data] : mTextures)
+        addCandidate(id, data);
+
+    std::vector<std::pair<TextureID, uint32_t>> trimmed; // Texture ID, previous target level.
+    uint64_t freedBytes = 0;
+    while (freedBytes < bytesToFree && !candidates.empty())
+    {
+        TextureID id = std::get<3>(candidates.top());
+        candidates.pop();
+
+        auto& data = getTexture(id);
+        freedBytes += getTrimSize(data);
+        trimmed.emplace_back(id, data.targetMip);
+        data.targetMip = data.getCoarserMip(data.targetMip);
+
+        addCandidate(id, data);
+    }
+
+    if (freedBytes < bytesToFree && !allowPartial)
+    {
+        for (auto it = trimmed.rbegin(); it != trimmed.rend(); ++it)
+            getTexture(it->first).targetMip = it->second;
+        return false;
+    }
+
+    plannedBytes -= freedBytes;
+    return freedBytes >= bytesToFree;
+}
+
+uint32_t TextureResidencyManager::getResidentMip(TextureID id) const
+{
+    return getTexture(id).residentMip;
+}
+
+uint32_t TextureResidencyManager::getRequestedMip(TextureID id) const
+{
+    return getTexture(id).requestedMip;
+}
+
+TextureResidencyManager::Stats TextureResidencyManager::getStats() const
+{
+    Stats stats;
+    stats.budgetInBytes = mBudget;
+    stats.residentBytes = mResidentBytes;
+    stats.textureCount = (uint32_t)mTextures.size();
+    for (const auto& [id, data] : mTextures)
+    {
+        stats.requestedBytes += data.getSize(data.requestedMip);
+        if (data.residentMip > 0)
+            stats.partiallyResidentCount++;
+        if (data.pending)
+            stats.pendingCount++;
+    }
+    stats.trimmedLevels = mTrimmedLevels;
+    stats.streamedLevels = mStreamedLevels;
+    stats.failedRequests = mFailedRequests;
+    return stats;
+}
+
+TextureResidencyManager::TextureData& TextureResidencyManager::getTexture(TextureID id)
+{
+    auto it = mTextures.find(id);
+    FALCOR_CHECK(it != mTextures.end(), "Texture {} is not managed.", id);
+    return it->second;
+}
+
+const TextureResidencyManager::TextureData& TextureResidencyManager::getTexture(TextureID id) const
+{
+    auto it = mTextures.find(id);
+    FALCOR_CHECK(it != mTextures.end(), "Texture {} is not managed.", id);
+    return it->second;
+}
+} // namespace Falcor
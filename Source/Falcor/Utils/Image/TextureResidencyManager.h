@@ -0,0 +1,214 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Budgeted mip-level residency policy for textures.
+ *
+ * The manager tracks which mip levels of each texture are resident and when each texture was last requested.
+ * Residency is described by the most detailed resident mip level; all coarser levels are always resident.
+ * When the resident memory exceeds the budget, or memory is needed to stream in requested levels,
+ * the least valuable levels are trimmed. Levels are valued by:
+ * - whether they are more detailed than the last requested level (such levels are trimmed first),
+ * - how recently the texture was requested (least recently used first),
+ * - their size (larger levels first).
+ *
+ * Textures can restrict which levels may become the most detailed resident level (e.g. block-compressed textures
+ * need whole blocks); trimming and streaming then step over the other levels.
+ *
+ * The manager does not touch any GPU resources. Changing the residency of a texture is delegated to an
+ * allocator interface, which allows the policy to be tested without a GPU.
+ */
+class FALCOR_API TextureResidencyManager
+{
+public:
+    using TextureID = uint32_t;
+
+    static constexpr uint32_t kMaxMip = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * Interface for changing the resident mip levels of textures.
+     */
+    class Allocator
+    {
+    public:
+        enum class Result
+        {
+            Success, ///< The residency was changed.
+            Pending, ///< The levels to stream in are still being loaded. The residency is unchanged.
+            Failed,  ///< The residency could not be changed and is unchanged.
+        };
+
+        virtual ~Allocator() = default;
+
+        /**
+         * Change the resident mip levels of a texture.
+         * After a successful call, the levels [mostDetailedMip, mipCount) are resident.
+         * Streaming in levels may complete asynchronously. While the levels are being loaded the allocator returns
+         * Pending and the manager repeats the request on later updates for as long as it is still planned.
+         * @param[in] id Texture ID.
+         * @param[in] currentMostDetailedMip Currently most detailed resident mip level.
+         * @param[in] mostDetailedMip New most detailed resident mip level.
+         * @return Result of the change.
+         */
+        virtual Result setResidentMips(TextureID id, uint32_t currentMostDetailedMip, uint32_t mostDetailedMip) = 0;
+    };
+
+    struct TextureInfo
+    {
+        std::vector<uint64_t> mipSizes;   ///< Size in bytes of each mip level, from the most detailed to the coarsest level.
+        uint32_t maxMostDetailedMip = kMaxMip; ///< Coarsest level that can become the most detailed resident level (clamped to the mip count).
+        std::vector<bool> allowedMostDetailedMips; ///< Optional flags for each level whether it can become the most detailed resident level (empty means all levels).
+    };
+
+    struct Stats
+    {
+        uint64_t budgetInBytes = 0;         ///< Memory budget in bytes (0 means unlimited).
+        uint64_t residentBytes = 0;         ///< Memory in bytes used by resident mip levels.
+        uint64_t requestedBytes = 0;        ///< Memory in bytes that would be used if all requested levels were resident.
+        uint32_t textureCount = 0;          ///< Number of managed textures.
+        uint32_t partiallyResidentCount = 0; ///< Number of textures that have their most detailed level trimmed.
+        uint64_t trimmedLevels = 0;         ///< Total number of mip levels trimmed since creation.
+        uint64_t streamedLevels = 0;        ///< Total number of mip levels streamed in since creation.
+        uint64_t failedRequests = 0;        ///< Total number of allocator calls that failed.
+        uint32_t pendingCount = 0;          ///< Number of textures waiting for levels to be loaded.
+    };
+
+    /**
+     * Constructor.
+     * @param[in] allocator Allocator used for changing the residency of textures. Must outlive the manager.
+     * @param[in] budgetInBytes Memory budget in bytes, or 0 for an unlimited budget.
+     */
+    TextureResidencyManager(Allocator& allocator, uint64_t budgetInBytes = 0);
+
+    /**
+     * Set the memory budget. The budget is enforced on the next call to update().
+     * @param[in] budgetInBytes Memory budget in bytes, or 0 for an unlimited budget.
+     */
+    void setBudget(uint64_t budgetInBytes) { mBudget = budgetInBytes; }
+    uint64_t getBudget() const { return mBudget; }
+
+    /**
+     * Add a texture.
+     * Newly added textures count as requested in the current frame at their resident level.
+     * @param[in] id Unique texture ID.
+     * @param[in] info Mip level description.
+     * @param[in] mostDetailedMip Most detailed level that is currently resident. Must be an allowed most detailed level.
+     */
+    void addTexture(TextureID id, const TextureInfo& info, uint32_t mostDetailedMip = 0);
+
+    /**
+     * Remove a texture. Does nothing if the texture is not managed.
+     */
+    void removeTexture(TextureID id);
+
+    bool hasTexture(TextureID id) const { return mTextures.find(id) != mTextures.end(); }
+
+    /**
+     * Request mip levels of a texture to be resident.
+     * Marks the texture as used in the current frame. Multiple requests in the same frame are combined.
+     * If the level can't become the most detailed resident level, the next more detailed allowed level is requested.
+     * @param[in] id Texture ID.
+     * @param[in] mostDetailedMip Most detailed mip level needed.
+     */
+    void requestMip(TextureID id, uint32_t mostDetailedMip = 0);
+
+    /**
+     * Apply the residency policy and advance to the next frame.
+     * Trims levels until the budget is met and streams in requested levels that fit within the budget.
+     * @return True if the residency of any texture changed.
+     */
+    bool update();
+
+    /**
+     * Get the most detailed resident mip level of a texture.
+     */
+    uint32_t getResidentMip(TextureID id) const;
+
+    /**
+     * Get the most detailed mip level requested for a texture.
+     */
+    uint32_t getRequestedMip(TextureID id) const;
+
+    uint64_t getResidentBytes() const { return mResidentBytes; }
+    uint64_t getFrame() const { return mFrame; }
+
+    Stats getStats() const;
+
+private:
+    struct TextureData
+    {
+        std::vector<uint64_t> mipSizes;
+        std::vector<bool> allowedMips; ///< Levels that can become the most detailed resident level.
+        uint32_t residentMip = 0;  ///< Most detailed resident level.
+        uint32_t requestedMip = 0; ///< Most detailed level of the latest request.
+        uint32_t targetMip = 0;    ///< Level planned during update().
+        uint64_t lastUsedFrame = 0;
+        bool requestedThisFrame = false;
+        bool pending = false;      ///< True if the allocator is loading levels for this texture.
+
+        uint64_t getSize(uint32_t mostDetailedMip) const;
+
+        /// Get the next more detailed allowed level, or kMaxMip if there is none.
+        uint32_t getFinerMip(uint32_t mip) const;
+
+        /// Get the next coarser allowed level, or kMaxMip if there is none.
+        uint32_t getCoarserMip(uint32_t mip) const;
+    };
+
+    TextureData& getTexture(TextureID id);
+    const TextureData& getTexture(TextureID id) const;
+
+    /**
+     * Plan trimming levels until at least the given amount of memory is freed.
+     * @param[in] bytesToFree Amount of memory to free.
+     * @param[in] allowUsed If true, levels of textures requested in the current frame are trimmed as a last resort.
+     * @param[in] allowPartial If false, nothing is trimmed unless the full amount can be freed.
+     * @param[in,out] plannedBytes Planned resident memory, updated with the freed memory.
+     * @return True if the full amount was freed.
+     */
+    bool planTrim(uint64_t bytesToFree, bool allowUsed, bool allowPartial, uint64_t& plannedBytes);
+
+    Allocator& mAllocator;
+    uint64_t mBudget = 0;
+    uint64_t mFrame = 0;
+    uint64_t mResidentBytes = 0;
+    std::unordered_map<TextureID, TextureData> mTextures;
+
+    uint64_t mTrimmedLevels = 0;
+    uint64_t mStreamedLevels = 0;
+    uint64_t mFailedRequests = 0;
+};
+} // namespace Falcor
@@ -0,0 +1,835 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ZstdDecoder.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <optional>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kFrameMagic = 0xFD2FB528;
+const uint32_t kSkippableFrameMagic = 0x184D2A50; ///< Skippable frames use magic numbers 0x184D2A50 to 0x184D2A5F.
+const size_t kMaxBlockSize = 128 * 1024;
+
+const uint32_t kMaxLiteralsAccuracyLog = 9;
+const uint32_t kMaxOffsetsAccuracyLog = 8;
+const uint32_t kMaxMatchLengthsAccuracyLog = 9;
+const uint32_t kMaxHuffmanBits = 11;
+
+template<typename... Args>
+[[noreturn]] void corrupted(fmt::format_string<Args...> format, Args&&... args)
+{
+    FALCOR_THROW("Corrupted Zstandard data: {}", fmt::format(format, std::forward<Args>(args)...));
+}
+
+uint32_t highBit(uint32_t value)
+{
+    uint32_t bit = 0;
+    while (value >>= 1)
+        bit++;
+    return bit;
+}
+
+/// Reads little-endian values from a byte range with bounds checking.
+class ByteReader
+{
+public:
+    ByteReader(const uint8_t* pData, size_t size) : mpData(pData), mSize(size) {}
+
+    size_t remaining() const { return mSize - mPos; }
+    const uint8_t* current() const { return mpData + mPos; }
+
+    const uint8_t* take(size_t count)
+    {
+        if (count > remaining())
+            corrupted("Unexpected end of data.");
+        const uint8_t* p = current();
+        mPos += count;
+        return p;
+    }
+
+    uint64_t read(size_t byteCount)
+    {
+        const uint8_t* p = take(byteCount);
+        uint64_t value = 0;
+        for (size_t i = 0; i < byteCount; i++)
+            value |= uint64_t(p[i]) << (8 * i);
+        return value;
+    }
+
+    uint8_t readByte() { return (uint8_t)read(1); }
+
+    size_t getPosition() const { return mPos; }
+
+private:
+    const uint8_t* mpData;
+    size_t mSize;
+    size_t mPos = 0;
+};
+
+/// Reads a bitstream forward, starting at the least significant bit of the first byte. Used for FSE table descriptions.
+class ForwardBitReader
+{
+public:
+    ForwardBitReader(const uint8_t* pData, size_t size) : mpData(pData), mSize(size) {}
+
+    uint32_t peek(uint32_t count) const
+    {
+        FALCOR_ASSERT(count <= 32);
+        uint64_t value = 0;
+        size_t byte = mBitPos / 8;
+        for (size_t i = 0; i < 8 && byte + i < mSize; i++)
+            value |= uint64_t(mpData[byte + i]) << (8 * i);
+        return uint32_t((value >> (mBitPos % 8)) & ((uint64_t(1) << count) - 1));
+    }
+
+    void skip(uint32_t count)
+    {
+        mBitPos += count;
+        if (mBitPos > mSize * 8)
+            corrupted("Unexpected end of table description.");
+    }
+
+    uint32_t read(uint32_t count)
+    {
+        uint32_t value = peek(count);
+        skip(count);
+        return value;
+    }
+
+    size_t getBytesConsumed() const { return (mBitPos + 7) / 8; }
+
+private:
+    const uint8_t* mpData;
+    size_t mSize;
+    size_t mBitPos = 0;
+};
+
+/**
+ * Reads a bitstream backward, starting below the padding marker (the highest set bit of the last byte).
+ * Values read are ordered most significant bit first. Reading past the start yields zeros and sets the overflow state.
+ */
+class BackwardBitReader
+{
+public:
+    BackwardBitReader(const uint8_t* pData, size_t size) : mpData(pData), mSize(size)
+    {
+        if (size == 0 || pData[size - 1] == 0)
+            corrupted("Missing bitstream padding marker.");
+        mBitPos = int64_t(size - 1) * 8 + highBit(pData[size - 1]);
+    }
+
+    uint32_t peek(uint32_t count) const
+    {
+        FALCOR_ASSERT(count <= 32);
+        if (count == 0)
+            return 0;
+        int64_t pos = mBitPos - count;
+        uint64_t mask = (uint64_t(1) << count) - 1;
+        if (pos >= 0)
+            return uint32_t((load(size_t(pos / 8)) >> (pos % 8)) & mask);
+        if (pos + count <= 0)
+            return 0;
+        return uint32_t((load(0) << (-pos)) & mask);
+    }
+
+    void skip(uint32_t count) { mBitPos -= count; }
+
+    uint32_t read(uint32_t count)
+    {
+        uint32_t value = peek(count);
+        skip(count);
+        return value;
+    }
+
+    bool isOverflow() const { return mBitPos < 0; }
+    bool isEmpty() const { return mBitPos == 0; }
+
+private:
+    uint64_t load(size_t byte) const
+    {
+        uint64_t value = 0;
+        size_t count = std::min<size_t>(8, mSize - byte);
+        for (size_t i = 0; i < count; i++)
+            value |= uint64_t(mpData[byte + i]) << (8 * i);
+        return value;
+    }
+
+    const uint8_t* mpData;
+    size_t mSize;
+    int64_t mBitPos; ///< Number of bits not yet read.
+};
+
+/// Finite state entropy decoding table.
+struct FSETable
+{
+    struct Entry
+    {
+        uint8_t symbol;
+        uint8_t bitCount;
+        uint16_t baseline;
+    };
+
+    uint32_t accuracyLog = 0;
+    std::vector<Entry> entries;
+
+    bool isValid() const { return !entries.empty(); }
+
+    /// Build the table from normalized symbol counts. A count of -1 denotes a "less than one" probability.
+    void build(const int16_t* pCounts, uint32_t symbolCount, uint32_t log)
+    {
+        accuracyLog = log;
+        const uint32_t size = 1u << log;
+        entries.assign(size, {});
+
+        // Symbols with "less than one" probability are placed at the end of the table.
+        std::array<uint32_t, 256> next;
+        uint32_t highThreshold = size - 1;
+        for (uint32_t s = 0; s < symbolCount; s++)
+        {
+            if (pCounts[s] == -1)
+            {
+                entries[highThreshold--].symbol = (uint8_t)s;
+                next[s] = 1;
+            }
+            else
+            {
+                next[s] = (uint32_t)pCounts[s];
+            }
+        }
+
+        // Spread the remaining symbols.
+        const uint32_t step = (size >> 1) + (size >> 3) + 3;
+        const uint32_t mask = size - 1;
+        uint32_t position = 0;
+        for (uint32_t s = 0; s < symbolCount; s++)
+        {
+            for (int i = 0; i < pCounts[s]; i++)
+            {
+                entries[position].symbol = (uint8_t)s;
+                do
+                {
+                    position = (position + step) & mask;
+                } while (position > highThreshold);
+            }
+        }
+        if (position != 0)
+            corrupted("Invalid FSE distribution.");
+
+        for (uint32_t i = 0; i < size; i++)
+        {
+            uint32_t state = next[entries[i].symbol]++;
+            entries[i].bitCount = uint8_t(log - highBit(state));
+            entries[i].baseline = uint16_t((state << entries[i].bitCount) - size);
+        }
+    }
+
+    /// Build a table that always decodes the same symbol.
+    void buildRLE(uint8_t symbol)
+    {
+        accuracyLog = 0;
+        entries.assign(1, {symbol, 0, 0});
+    }
+
+    /**
+     * Read a table description.
+     * @return Number of bytes consumed.
+     */
+    size_t read(const uint8_t* pData, size_t size, uint32_t maxSymbol, uint32_t maxAccuracyLog)
+    {
+        ForwardBitReader reader(pData, size);
+        const uint32_t log = reader.read(4) + 5;
+        if (log > maxAccuracyLog)
+            corrupted("FSE accuracy log {} is too large.", log);
+
+        std::array<int16_t, 256> counts = {};
+        int32_t remaining = (1 << log) + 1;
+        uint32_t threshold = 1u << log;
+        uint32_t bitCount = log + 1;
+        uint32_t symbol = 0;
+        bool previousZero = false;
+        while (remaining > 1)
+        {
+            if (previousZero)
+            {
+                // Runs of zero probabilities are encoded with 2-bit repeat flags.
+                uint32_t repeat;
+                do
+                {
+                    repeat = reader.read(2);
+                    symbol += repeat;
+                } while (repeat == 3);
+                if (symbol > maxSymbol)
+                    corrupted("Too many FSE symbols.");
+            }
+            if (symbol > maxSymbol)
+                corrupted("Too many FSE symbols.");
+
+            const uint32_t max = (2 * threshold - 1) - uint32_t(remaining);
+            int32_t count;
+            uint32_t bits = reader.peek(bitCount);
+            if ((bits & (threshold - 1)) < max)
+            {
+                count = int32_t(bits & (threshold - 1));
+                reader.skip(bitCount - 1);
+            }
+            else
+            {
+                count = int32_t(bits & (2 * threshold - 1));
+                if (count >= int32_t(threshold))
+                    count -= int32_t(max);
+                reader.skip(bitCount);
+            }
+            count--;
+
+            remaining -= count < 0 ? -count : count;
+            counts[symbol++] = (int16_t)count;
+            previousZero = count == 0;
+            while (remaining < int32_t(threshold) && threshold > 1)
+            {
+                bitCount--;
+                threshold >>= 1;
+            }
+        }
+        if (remaining != 1)
+            corrupted("Invalid FSE table description.");
+
+        build(counts.data(), symbol, log);
+        return reader.getBytesConsumed();
+    }
+};
+
+struct FSEState
+{
+    const FSETable* pTable = nullptr;
+    uint32_t state = 0;
+
+    void init(BackwardBitReader& reader, const FSETable& table)
+    {
+        pTable = &table;
+        state = reader.read(table.accuracyLog);
+    }
+
+    uint8_t symbol() const { return pTable->entries[state].symbol; }
+
+    void update(BackwardBitReader& reader)
+    {
+        const auto& entry = pTable->entries[state];
+        state = entry.baseline + reader.read(entry.bitCount);
+    }
+};
+
+/// Huffman decoding table for literals.
+struct HuffmanTable
+{
+    struct Entry
+    {
+        uint8_t symbol;
+        uint8_t bitCount;
+    };
+
+    uint32_t maxBits = 0;
+    std::vector<Entry> entries;
+
+    bool isValid() const { return !entries.empty(); }
+
+    /**
+     * Read a Huffman tree description.
+     * @return Number of bytes consumed.
+     */
+    size_t read(const uint8_t* pData, size_t size)
+    {
+        ByteReader bytes(pData, size);
+        const uint32_t header = bytes.readByte();
+        std::array<uint8_t, 256> weights = {};
+        uint32_t weightCount = 0;
+
+        if (header < 128)
+        {
+            // Weights are FSE compressed, with two interleaved states.
+            const uint8_t* pCompressed = bytes.take(header);
+            FSETable table;
+            size_t tableSize = table.read(pCompressed, header, 255, 6);
+            if (tableSize >= header)
+                corrupted("Invalid Huffman weights.");
+            BackwardBitReader reader(pCompressed + tableSize, header - tableSize);
+            FSEState state1, state2;
+            state1.init(reader, table);
+            state2.init(reader, table);
+            while (true)
+            {
+                if (weightCount >= 255)
+                    corrupted("Too many Huffman weights.");
+                weights[weightCount++] = state1.symbol();
+                state1.update(reader);
+                if (reader.isOverflow())
+                {
+                    weights[weightCount++] = state2.symbol();
+                    break;
+                }
+                if (weightCount >= 255)
+                    corrupted("Too many Huffman weights.");
+                weights[weightCount++] = state2.symbol();
+                state2.update(reader);
+                if (reader.isOverflow())
+                {
+                    weights[weightCount++] = state1.symbol();
+                    break;
+                }
+            }
+        }
+        else
+        {
+            // Weights are stored directly, 4 bits each.
+            weightCount = header - 127;
+            const uint8_t* pWeights = bytes.take((weightCount + 1) / 2);
+            for (uint32_t i = 0; i < weightCount; i++)
+                weights[i] = i % 2 == 0 ? pWeights[i / 2] >> 4 : pWeights[i / 2] & 0xf;
+        }
+
+        // The weight of the last symbol is implied, such that the weights sum up to a power of two.
+        uint32_t total = 0;
+        for (uint32_t i = 0; i < weightCount; i++)
+        {
+            if (weights[i] > kMaxHuffmanBits)
+                corrupted("Invalid Huffman weight.");
+            if (weights[i] > 0)
+                total += 1u << (weights[i] - 1);
+        }
+        if (total == 0)
+            corrupted("Invalid Huffman weights.");
+        maxBits = highBit(total) + 1;
+        const uint32_t leftover = (1u << maxBits) - total;
+        if (leftover & (leftover - 1))
+            corrupted("Invalid Huffman weights.");
+        weights[weightCount++] = uint8_t(highBit(leftover) + 1);
+        if (maxBits > kMaxHuffmanBits)
+            corrupted("Huffman codes are too long.");
+
+        // Symbols with the lowest weight (longest codes) come first in the table.
+        entries.assign(size_t(1) << maxBits, {});
+        uint32_t position = 0;
+        for (uint32_t weight = 1; weight <= maxBits; weight++)
+        {
+            for (uint32_t s = 0; s < weightCount; s++)
+            {
+                if (weights[s] != weight)
+                    continue;
+                const uint32_t length = 1u << (weight - 1);
+                std::fill_n(entries.begin() + position, length, Entry{uint8_t(s), uint8_t(maxBits + 1 - weight)});
+                position += length;
+            }
+        }
+
+        return bytes.getPosition();
+    }
+
+    void decodeStream(const uint8_t* pData, size_t size, uint8_t* pDst, size_t count) const
+    {
+        BackwardBitReader reader(pData, size);
+        for (size_t i = 0; i < count; i++)
+        {
+            const Entry& entry = entries[reader.peek(maxBits)];
+            pDst[i] = entry.symbol;
+            reader.skip(entry.bitCount);
+        }
+        if (!reader.isEmpty())
+            corrupted("Huffman stream size mismatch.");
+    }
+};
+
+struct CodeInfo
+{
+    uint32_t baseline;
+    uint8_t bitCount;
+};
+
+// clang-format off
+const int16_t kDefaultLiteralLengthCounts[36] = {
+    4, 3, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 1, 1, 1, 2, 2, 2, 2, 2, 2, 2, 2, 2, 3, 2, 1, 1, 1, 1, 1, -1, -1, -1, -1,
+};
+const int16_t kDefaultMatchLengthCounts[53] = {
+    1, 4, 3, 2, 2, 2, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+    1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1, -1, -1,
+};
+const int16_t kDefaultOffsetCounts[29] = {
+    1, 1, 1, 1, 1, 1, 2, 2, 2, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, -1, -1, -1, -1, -1,
+};
+
+const CodeInfo kLiteralLengthCodes[36] = {
+    {0, 0}, {1, 0}, {2, 0}, {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0}, {8, 0}, {9, 0}, {10, 0}, {11, 0},
+    {12, 0}, {13, 0}, {14, 0}, {15, 0}, {16, 1}, {18, 1}, {20, 1}, {22, 1}, {24, 2}, {28, 2}, {32, 3}, {40, 3},
+    {48, 4}, {64, 6}, {128, 7}, {256, 8}, {512, 9}, {1024, 10}, {2048, 11}, {4096, 12}, {8192, 13}, {16384, 14}, {32768, 15}, {65536, 16},
+};
+const CodeInfo kMatchLengthCodes[53] = {
+    {3, 0}, {4, 0}, {5, 0}, {6, 0}, {7, 0}, {8, 0}, {9, 0}, {10, 0}, {11, 0}, {12, 0}, {13, 0}, {14, 0}, {15, 0}, {16, 0},
+    {17, 0}, {18, 0}, {19, 0}, {20, 0}, {21, 0}, {22, 0}, {23, 0}, {24, 0}, {25, 0}, {26, 0}, {27, 0}, {28, 0}, {29, 0},
+    {30, 0}, {31, 0}, {32, 0}, {33, 0}, {34, 0}, {35, 1}, {37, 1}, {39, 1}, {41, 1}, {43, 2}, {47, 2}, {51, 3}, {59, 3},
+    {67, 4}, {83, 4}, {99, 5}, {131, 7}, {259, 8}, {515, 9}, {1027, 10}, {2051, 11}, {4099, 12}, {8195, 13}, {16387, 14},
+    {32771, 15}, {65539, 16},
+};
+// clang-format on
+
+/// Decoder state that persists across the blocks of a frame.
+class FrameDecoder
+{
+public:
+    FrameDecoder(std::vector<uint8_t>& output) : mOutput(output)
+    {
+        mFrameStart = output.size();
+        mPredefinedLiteralLengths.build(kDefaultLiteralLengthCounts, 36, 6);
+        mPredefinedMatchLengths.build(kDefaultMatchLengthCounts, 53, 6);
+        mPredefinedOffsets.build(kDefaultOffsetCounts, 29, 5);
+    }
+
+    void decodeBlock(const uint8_t* pData, size_t size)
+    {
+        ByteReader reader(pData, size);
+        decodeLiterals(reader);
+        decodeSequences(reader);
+    }
+
+private:
+    void decodeLiterals(ByteReader& reader)
+    {
+        const uint8_t header = reader.readByte();
+        const uint32_t type = header & 3;
+        const uint32_t sizeFormat = (header >> 2) & 3;
+
+        if (type == 0 || type == 1)
+        {
+            // Raw or RLE literals.
+            size_t regeneratedSize;
+            if ((sizeFormat & 1) == 0)
+                regeneratedSize = header >> 3;
+            else if (sizeFormat == 1)
+                regeneratedSize = (header >> 4) + (reader.read(1) << 4);
+            else
+                regeneratedSize = (header >> 4) + (reader.read(2) << 4);
+            if (regeneratedSize > kMaxBlockSize)
+                corrupted("Literals size {} exceeds the block size.", regeneratedSize);
+
+            if (type == 0)
+            {
+                const uint8_t* pLiterals = reader.take(regeneratedSize);
+                mLiterals.assign(pLiterals, pLiterals + regeneratedSize);
+            }
+            else
+            {
+                mLiterals.assign(regeneratedSize, reader.readByte());
+            }
+            return;
+        }
+
+        // Huffman compressed literals, with a new tree (type 2) or the tree of the previous block (type 3).
+        const uint32_t headerSize = sizeFormat < 2 ? 3 : sizeFormat + 2;
+        const uint32_t sizeBits = headerSize * 4 - 2;
+        const uint64_t value = header | (reader.read(headerSize - 1) << 8);
+        const size_t regeneratedSize = size_t((value >> 4) & ((1u << sizeBits) - 1));
+        const size_t compressedSize = size_t(value >> (4 + sizeBits));
+        const uint32_t streamCount = sizeFormat == 0 ? 1 : 4;
+        if (regeneratedSize > kMaxBlockSize)
+            corrupted("Literals size {} exceeds the block size.", regeneratedSize);
+
+        const uint8_t* pCompressed = reader.take(compressedSize);
+        size_t offset = 0;
+        if (type == 2)
+            offset = mHuffman.read(pCompressed, compressedSize);
+        else if (!mHuffman.isValid())
+            corrupted("Missing Huffman table.");
+
+        mLiterals.resize(regeneratedSize);
+        if (streamCount == 1)
+        {
+            mHuffman.decodeStream(pCompressed + offset, compressedSize - offset, mLiterals.data(), regeneratedSize);
+            return;
+        }
+
+        if (compressedSize < offset + 6)
+            corrupted("Missing literals jump table.");
+        ByteReader jumpTable(pCompressed + offset, 6);
+        size_t streamSizes[4];
+        size_t totalSize = 0;
+        for (uint32_t i = 0; i < 3; i++)
+            totalSize += streamSizes[i] = (size_t)jumpTable.read(2);
+        if (offset + 6 + totalSize > compressedSize)
+            corrupted("Invalid literals jump table.");
+        streamSizes[3] = compressedSize - offset - 6 - totalSize;
+
+        const size_t segmentSize = (regeneratedSize + 3) / 4;
+        if (segmentSize * 3 > regeneratedSize)
+            corrupted("Too few literals for four streams.");
+        const uint8_t* pStream = pCompressed + offset + 6;
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            const size_t count = i < 3 ? segmentSize : regeneratedSize - 3 * segmentSize;
+            mHuffman.decodeStream(pStream, streamSizes[i], mLiterals.data() + i * segmentSize, count);
+            pStream += streamSizes[i];
+        }
+    }
+
+    void readTable(ByteReader& reader, uint32_t mode, FSETable& table, const FSETable& predefined, uint32_t maxSymbol, uint32_t maxAccuracyLog)
+    {
+        switch (mode)
+        {
+        case 0:
+            table = predefined;
+            break;
+        case 1:
+        {
+            uint8_t symbol = reader.readByte();
+            if (symbol > maxSymbol)
+                corrupted("Invalid RLE symbol.");
+            table.buildRLE(symbol);
+            break;
+        }
+        case 2:
+            reader.take(table.read(reader.current(), reader.remaining(), maxSymbol, maxAccuracyLog));
+            break;
+        case 3:
+            if (!table.isValid())
+                corrupted("Missing table for repeat mode.");
+            break;
+        }
+    }
+
+    void decodeSequences(ByteReader& reader)
+    {
+        size_t sequenceCount = 0;
+        if (reader.remaining() > 0)
+        {
+            const uint32_t byte0 = reader.readByte();
+            if (byte0 < 128)
+                sequenceCount = byte0;
+            else if (byte0 < 255)
+                sequenceCount = ((byte0 - 128) << 8) + reader.readByte();
+            else
+                sequenceCount = (size_t)reader.read(2) + 0x7f00;
+        }
+
+        if (sequenceCount == 0)
+        {
+            mOutput.insert(mOutput.end(), mLiterals.begin(), mLiterals.end());
+            return;
+        }
+
+        const uint8_t modes = reader.readByte();
+        if (modes & 3)
+            corrupted("Reserved bits set in sequence compression modes.");
+        readTable(reader, modes >> 6, mLiteralLengths, mPredefinedLiteralLengths, 35, kMaxLiteralsAccuracyLog);
+        readTable(reader, (modes >> 4) & 3, mOffsets, mPredefinedOffsets, 31, kMaxOffsetsAccuracyLog);
+        readTable(reader, (modes >> 2) & 3, mMatchLengths, mPredefinedMatchLengths, 52, kMaxMatchLengthsAccuracyLog);
+
+        BackwardBitReader bits(reader.current(), reader.remaining());
+        FSEState literalLengthState, offsetState, matchLengthState;
+        literalLengthState.init(bits, mLiteralLengths);
+        offsetState.init(bits, mOffsets);
+        matchLengthState.init(bits, mMatchLengths);
+
+        size_t literalPos = 0;
+        for (size_t i = 0; i < sequenceCount; i++)
+        {
+            const uint32_t offsetCode = offsetState.symbol();
+            const uint32_t matchLengthCode = matchLengthState.symbol();
+            const uint32_t literalLengthCode = literalLengthState.symbol();
+            if (offsetCode > 31 || matchLengthCode > 52 || literalLengthCode > 35)
+                corrupted("Invalid sequence code.");
+
+            const size_t offsetValue = (size_t(1) << offsetCode) + bits.read(offsetCode);
+            const CodeInfo& matchLengthInfo = kMatchLengthCodes[matchLengthCode];
+            const size_t matchLength = matchLengthInfo.baseline + bits.read(matchLengthInfo.bitCount);
+            const CodeInfo& literalLengthInfo = kLiteralLengthCodes[literalLengthCode];
+            const size_t literalLength = literalLengthInfo.baseline + bits.read(literalLengthInfo.bitCount);
+
+            if (i + 1 < sequenceCount)
+            {
+                literalLengthState.update(bits);
+                matchLengthState.update(bits);
+                offsetState.update(bits);
+            }
+            if (bits.isOverflow())
+                corrupted("Sequence bitstream overflow.");
+
+            const size_t offset = resolveOffset(offsetValue, literalLength);
+
+            if (literalLength > mLiterals.size() - literalPos)
+                corrupted("Sequence literal length exceeds the literals.");
+            mOutput.insert(mOutput.end(), mLiterals.begin() + literalPos, mLiterals.begin() + literalPos + literalLength);
+            literalPos += literalLength;
+
+            if (offset == 0 || offset > mOutput.size() - mFrameStart)
+                corrupted("Match offset {} is out of range.", offset);
+            // Copy byte by byte, as the match may overlap the bytes being written.
+            size_t src = mOutput.size() - offset;
+            mOutput.resize(mOutput.size() + matchLength);
+            uint8_t* pOut = mOutput.data();
+            for (size_t j = 0, dst = mOutput.size() - matchLength; j < matchLength; j++)
+                pOut[dst + j] = pOut[src + j];
+        }
+        if (!bits.isEmpty())
+            corrupted("Sequence bitstream size mismatch.");
+
+        mOutput.insert(mOutput.end(), mLiterals.begin() + literalPos, mLiterals.end());
+    }
+
+    size_t resolveOffset(size_t offsetValue, size_t literalLength)
+    {
+        if (offsetValue > 3)
+        {
+            const size_t offset = offsetValue - 3;
+            mRepeatOffsets[2] = mRepeatOffsets[1];
+            mRepeatOffsets[1] = mRepeatOffsets[0];
+            mRepeatOffsets[0] = offset;
+            return offset;
+        }
+
+        // Repeat offsets. With a zero literal length, the indices are shifted by one.
+        const size_t index = offsetValue - 1 + (literalLength == 0 ? 1 : 0);
+        if (index == 0)
+            return mRepeatOffsets[0];
+
+        const size_t offset = index == 3 ? mRepeatOffsets[0] - 1 : mRepeatOffsets[index];
+        if (index != 1)
+            mRepeatOffsets[2] = mRepeatOffsets[1];
+        mRepeatOffsets[1] = mRepeatOffsets[0];
+        mRepeatOffsets[0] = offset;
+        return offset;
+    }
+
+    std::vector<uint8_t>& mOutput;
+    size_t mFrameStart;
+    std::vector<uint8_t> mLiterals;
+    size_t mRepeatOffsets[3] = {1, 4, 8};
+
+    HuffmanTable mHuffman;
+    FSETable mLiteralLengths;
+    FSETable mOffsets;
+    FSETable mMatchLengths;
+    FSETable mPredefinedLiteralLengths;
+    FSETable mPredefinedOffsets;
+    FSETable mPredefinedMatchLengths;
+};
+
+void decodeFrame(ByteReader& reader, std::vector<uint8_t>& output)
+{
+    const uint8_t descriptor = reader.readByte();
+    const uint32_t contentSizeFlag = descriptor >> 6;
+    const bool singleSegment = (descriptor >> 5) & 1;
+    const bool hasChecksum = (descriptor >> 2) & 1;
+    const uint32_t dictionaryIdFlag = descriptor & 3;
+    if (descriptor & (1 << 3))
+        corrupted("Reserved frame header bit set.");
+
+    if (!singleSegment)
+        reader.readByte(); // Window descriptor. The whole output is kept in memory, so the window size is not needed.
+
+    const uint32_t dictionaryIdSizes[4] = {0, 1, 2, 4};
+    if (dictionaryIdFlag != 0 && reader.read(dictionaryIdSizes[dictionaryIdFlag]) != 0)
+        FALCOR_THROW("Zstandard frames using dictionaries are not supported.");
+
+    const uint32_t contentSizeSizes[4] = {singleSegment ? 1u : 0u, 2, 4, 8};
+    const uint32_t contentSizeSize = contentSizeSizes[contentSizeFlag];
+    std::optional<uint64_t> contentSize;
+    if (contentSizeSize > 0)
+        contentSize = reader.read(contentSizeSize) + (contentSizeSize == 2 ? 256 : 0);
+
+    const size_t frameStart = output.size();
+    if (contentSize && *contentSize < (uint64_t(1) << 32))
+        output.reserve(frameStart + (size_t)*contentSize);
+
+    FrameDecoder decoder(output);
+    bool lastBlock = false;
+    while (!lastBlock)
+    {
+        const uint32_t header = (uint32_t)reader.read(3);
+        lastBlock = header & 1;
+        const uint32_t type = (header >> 1) & 3;
+        const size_t size = header >> 3;
+        if (size > kMaxBlockSize)
+            corrupted("Block size {} is too large.", size);
+
+        switch (type)
+        {
+        case 0: // Raw block.
+        {
+            const uint8_t* pData = reader.take(size);
+            output.insert(output.end(), pData, pData + size);
+            break;
+        }
+        case 1: // RLE block.
+            output.insert(output.end(), size, reader.readByte());
+            break;
+        case 2: // Compressed block.
+            decoder.decodeBlock(reader.take(size), size);
+            break;
+        default:
+            corrupted("Reserved block type.");
+        }
+    }
+
+    if (contentSize && output.size() - frameStart != *contentSize)
+        corrupted("Frame content size mismatch.");
+
+    if (hasChecksum)
+        reader.take(4); // The content checksum (XXH64) is not verified.
+}
+
+} // namespace
+
+std::vector<uint8_t> ZstdDecoder::decompress(const void* pData, size_t size, size_t sizeHint)
+{
+    std::vector<uint8_t> output;
+    output.reserve(sizeHint);
+
+    ByteReader reader(static_cast<const uint8_t*>(pData), size);
+    FALCOR_CHECK(reader.remaining() >= 4, "Zstandard data is too small.");
+    while (reader.remaining() > 0)
+    {
+        const uint32_t magic = (uint32_t)reader.read(4);
+        if (magic == kFrameMagic)
+        {
+            decodeFrame(reader, output);
+        }
+        else if ((magic & 0xfffffff0) == kSkippableFrameMagic)
+        {
+            reader.take((size_t)reader.read(4));
+        }
+        else
+        {
+            FALCOR_THROW("Invalid Zstandard frame magic number {:#010x}.", magic);
+        }
+    }
+
+    return output;
+}
+
+} // namespace Falcor
@@ -0,0 +1,370 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BlueNoiseMask.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <execution>
+#include <fstream>
+#include <limits>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+const char kMagic[4] = {'F', 'B', 'N', 'M'};
+const uint32_t kVersion = 1;
+const std::string kCacheDirectory = "NVIDIA/Falcor/BlueNoiseCache";
+
+const uint32_t kMaxSize = 1024;
+
+struct Header
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t size;
+    uint32_t layerCount;
+    float sigma;
+    float initialDensity;
+    uint32_t seed;
+};
+
+void checkOptions(const BlueNoiseMask::Options& options)
+{
+    FALCOR_CHECK(
+        options.size >= 4 && options.size <= kMaxSize && (options.size & (options.size - 1)) == 0,
+        "Size must be a power of two in [4,{}].",
+        kMaxSize
+    );
+    FALCOR_CHECK(options.layerCount > 0, "Layer count must be larger than zero.");
+    FALCOR_CHECK(options.sigma > 0.f, "Sigma must be larger than zero.");
+    FALCOR_CHECK(options.initialDensity > 0.f && options.initialDensity < 0.5f, "Initial density must be in (0,0.5).");
+}
+
+/**
+ * Binary pattern on a torus with the energy of each pixel, i.e. the sum of the Gaussian filter
+ * centered at each set pixel. The filter is truncated to a window of 4 standard deviations.
+ */
+class VoidAndCluster
+{
+public:
+    VoidAndCluster(uint32_t size, float sigma) : mSize(size), mPattern(size * size, 0), mEnergy(size * size, 0.f)
+    {
+        mRadius = std::min((int32_t)std::ceil(4.f * sigma), (int32_t(size) - 1) / 2);
+        const int32_t width = 2 * mRadius + 1;
+        mKernel.resize(width * width);
+        for (int32_t y = -mRadius; y <= mRadius; ++y)
+            for (int32_t x = -mRadius; x <= mRadius; ++x)
+                mKernel[(y + mRadius) * width + x + mRadius] = std::exp(-float(x * x + y * y) / (2.f * sigma * sigma));
+    }
+
+    uint32_t getPixelCount() const { return mSize * mSize; }
+
+    void set(uint32_t pixel, bool value)
+    {
+        FALCOR_ASSERT(mPattern[pixel] != value);
+        mPattern[pixel] = value;
+
+        const float sign = value ? 1.f : -1.f;
+        const int32_t width = 2 * mRadius + 1;
+        const int32_t px = pixel % mSize;
+        const int32_t py = pixel / mSize;
+        const int32_t mask = mSize - 1;
+        for (int32_t y = -mRadius; y <= mRadius; ++y)
+        {
+            const uint32_t row = ((py + y) & mask) * mSize;
+            for (int32_t x = -mRadius; x <= mRadius; ++x)
+                mEnergy[row + ((px + x) & mask)] += sign * mKernel[(y + mRadius) * width + x + mRadius];
+        }
+    }
+
+    /// Find the set pixel with the highest energy. Ties are resolved to the lowest index.
+    uint32_t findTightestCluster() const
+    {
+        uint32_t best = 0;
+        float bestEnergy = -std::numeric_limits<float>::infinity();
+        for (uint32_t i = 0; i < mEnergy.size(); ++i)
+        {
+            if (mPattern[i] && mEnergy[i] > bestEnergy)
+            {
+                best = i;
+                bestEnergy = mEnergy[i];
+            }
+        }
+        return best;
+    }
+
+    /// Find the unset pixel with the lowest energy. Ties are resolved to the lowest index.
+    uint32_t findLargestVoid() const
+    {
+        uint32_t best = 0;
+        float bestEnergy = std::numeric_limits<float>::infinity();
+        for (uint32_t i = 0; i < mEnergy.size(); ++i)
+        {
+            if (!mPattern[i] && mEnergy[i] < bestEnergy)
+            {
+                best = i;
+                bestEnergy = mEnergy[i];
+            }
+        }
+        return best;
+    }
+
+private:
+    uint32_t mSize;
+    int32_t mRadius;
+    std::vector<float> mKernel;
+    std::vector<uint8_t> mPattern;
+    std::vector<float> mEnergy;
+};
+
+std::vector<uint32_t> generateLayer(const BlueNoiseMask::Options& options, uint32_t layer)
+{
+    VoidAndCluster pattern(options.size, options.sigma);
+    const uint32_t pixelCount = pattern.getPixelCount();
+    const uint32_t initialCount = std::max(1u, uint32_t(pixelCount * options.initialDensity));
+
+    // Initial random pattern. The pixels are drawn with a partial Fisher-Yates shuffle using the raw
+    // generator output, as the standard distributions are implementation defined.
+    std::seed_seq seq{options.seed, layer};
+    std::mt19937 rng(seq);
+    std::vector<uint32_t> pixels(pixelCount);
+    for (uint32_t i = 0; i < pixelCount; ++i)
+        pixels[i] = i;
+    for (uint32_t i = 0; i < initialCount; ++i)
+    {
+        std::swap(pixels[i], pixels[i + rng() % (pixelCount - i)]);
+        pattern.set(pixels[i], true);
+    }
+
+    // Move pixels from the tightest cluster to the largest void until the pattern is stable.
+    for (uint32_t i = 0; i < pixelCount; ++i)
+    {
+        const uint32_t cluster = pattern.findTightestCluster();
+        pattern.set(cluster, false);
+        const uint32_t largestVoid = pattern.findLargestVoid();
+        pattern.set(largestVoid, true);
+        if (largestVoid == cluster)
+            break;
+    }
+
+    std::vector<uint32_t> ranks(pixelCount);
+
+    // Phase 1: Rank the initial pattern by removing the tightest clusters.
+    VoidAndCluster prototype = pattern;
+    for (uint32_t rank = initialCount; rank-- > 0;)
+    {
+        const uint32_t cluster = pattern.findTightestCluster();
+        pattern.set(cluster, false);
+        ranks[cluster] = rank;
+    }
+
+    // Phases 2 and 3: Rank the remaining pixels by filling the largest voids. For an unset pixel, the energy
+    // of the unset pixels is the total filter energy minus the energy of the set pixels, so finding the tightest
+    // cluster of unset pixels in phase 3 is equivalent to finding the largest void.
+    for (uint32_t rank = initialCount; rank < pixelCount; ++rank)
+    {
+        const uint32_t largestVoid = prototype.findLargestVoid();
+        prototype.set(largestVoid, true);
+        ranks[largestVoid] = rank;
+    }
+
+    return ranks;
+}
+} // namespace
+
+BlueNoiseMask::BlueNoiseMask(const Options& options) : mOptions(options)
+{
+    checkOptions(options);
+
+    const size_t pixelCount = size_t(options.size) * options.size;
+    mRanks.resize(pixelCount * options.layerCount);
+
+    NumericRange<uint32_t> layers(0, options.layerCount);
+    std::for_each(
+        std::execution::par,
+        layers.begin(),
+        layers.end(),
+        [&](uint32_t layer)
+        {
+            auto ranks = generateLayer(options, layer);
+            std::copy(ranks.begin(), ranks.end(), mRanks.begin() + layer * pixelCount);
+        }
+    );
+}
+
+BlueNoiseMask BlueNoiseMask::createCached(const Options& options, const std::filesystem::path& cacheDirectory)
+{
+    checkOptions(options);
+
+    auto cachePath = getCachePath(options, cacheDirectory);
+
+    if (auto ranks = readFromFile(cachePath, options))
+    {
+        logInfo("Loaded blue-noise masks from '{}'.", cachePath);
+        return BlueNoiseMask(options, std::move(*ranks));
+    }
+
+    logInfo("Generating {} blue-noise masks of {}x{} pixels.", options.layerCount, options.size, options.size);
+    BlueNoiseMask mask(options);
+    mask.writeToFile(cachePath);
+    return mask;
+}
+
+std::filesystem::path BlueNoiseMask::getDefaultCacheDirectory()
+{
+    return getAppDataDirectory() / kCacheDirectory;
+}
+
+std::filesystem::path BlueNoiseMask::getCachePath(const Options& options, const std::filesystem::path& cacheDirectory)
+{
+    return cacheDirectory / fmt::format(
+                                "BlueNoise_{}x{}x{}_{}_{}_{}.bin",
+                                options.size,
+                                options.size,
+                                options.layerCount,
+                                options.sigma,
+                                options.initialDensity,
+                                options.seed
+                            );
+}
+
+std::vector<uint32_t> BlueNoiseMask::getFixedPointValues() const
+{
+    // The pixel count is a power of two, so the ranks map exactly to the upper bits.
+    uint32_t shift = 32;
+    for (uint32_t pixelCount = mOptions.size * mOptions.size; pixelCount > 1; pixelCount >>= 1)
+        shift--;
+
+    std::vector<uint32_t> values(mRanks.size());
+    for (size_t i = 0; i < mRanks.size(); ++i)
+        values[i] = (mRanks[i] << shift) | (1u << (shift - 1));
+    return values;
+}
+
+std::optional<std::vector<uint32_t>> BlueNoiseMask::readFromFile(const std::filesystem::path& path, const Options& options)
+{
+    std::ifstream fs(path, std::ios_base::binary);
+    if (!fs)
+        return {};
+
+    Header header;
+    fs.read(reinterpret_cast<char*>(&header), sizeof(header));
+    if (!fs || std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion)
+    {
+        logWarning("Ignoring invalid blue-noise cache file '{}'.", path);
+        return {};
+    }
+
+    Options fileOptions;
+    fileOptions.size = header.size;
+    fileOptions.layerCount = header.layerCount;
+    fileOptions.sigma = header.sigma;
+    fileOptions.initialDensity = header.initialDensity;
+    fileOptions.seed = header.seed;
+    if (!(fileOptions == options))
+    {
+        logWarning("Ignoring blue-noise cache file '{}' generated with different options.", path);
+        return {};
+    }
+
+    // Read the ranks and validate that each layer is a permutation.
+    const size_t pixelCount = size_t(options.size) * options.size;
+    std::vector<uint32_t> ranks(pixelCount * options.layerCount);
+    fs.read(reinterpret_cast<char*>(ranks.data()), ranks.size() * sizeof(uint32_t));
+    if (!fs)
+    {
+        logWarning("Ignoring truncated blue-noise cache file '{}'.", path);
+        return {};
+    }
+
+    std::vector<uint8_t> used(pixelCount);
+    for (uint32_t layer = 0; layer < options.layerCount; ++layer)
+    {
+        std::fill(used.begin(), used.end(), 0);
+        for (size_t i = 0; i < pixelCount; ++i)
+        {
+            uint32_t rank = ranks[layer * pixelCount + i];
+            if (rank >= pixelCount || used[rank])
+            {
+                logWarning("Ignoring corrupt blue-noise cache file '{}'.", path);
+                return {};
+            }
+            used[rank] = 1;
+        }
+    }
+
+    return ranks;
+}
+
+void BlueNoiseMask::writeToFile(const std::filesystem::path& path) const
+{
+    logInfo("Writing blue-noise masks to '{}'.", path);
+
+    // The cache is written to a temporary file that is moved in place when complete,
+    // so that other processes never read a partially written file.
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    auto tempPath = path;
+    tempPath += ".tmp";
+
+    {
+        std::ofstream fs(tempPath, std::ios_base::binary);
+        if (fs)
+        {
+            Header header;
+            std::memcpy(header.magic, kMagic, sizeof(kMagic));
+            header.version = kVersion;
+            header.size = mOptions.size;
+            header.layerCount = mOptions.layerCount;
+            header.sigma = mOptions.sigma;
+            header.initialDensity = mOptions.initialDensity;
+            header.seed = mOptions.seed;
+            fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            fs.write(reinterpret_cast<const char*>(mRanks.data()), mRanks.size() * sizeof(uint32_t));
+        }
+        if (!fs)
+        {
+            logWarning("Failed to write blue-noise cache file '{}'.", tempPath);
+            return;
+        }
+    }
+
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec)
+    {
+        logWarning("Failed to write blue-noise cache file '{}': {}", path, ec.message());
+        std::filesystem::remove(tempPath, ec);
+    }
+}
+} // namespace Falcor
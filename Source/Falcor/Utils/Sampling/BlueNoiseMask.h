@@ -0,0 +1,116 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Blue-noise dither masks generated with the void-and-cluster method.
+ *
+ * See Ulichney, "The void-and-cluster method for dither array generation", 1993.
+ * Each layer is an independent tileable mask, storing a rank in [0, size^2) per pixel.
+ * The layers are generated in parallel. As generating large masks is slow, they can be
+ * loaded from and stored to an on-disk cache keyed by the generation options.
+ */
+class FALCOR_API BlueNoiseMask
+{
+public:
+    struct Options
+    {
+        uint32_t size = 128;           ///< Width and height of the masks in pixels. Must be a power of two.
+        uint32_t layerCount = 4;       ///< Number of independent masks.
+        float sigma = 1.5f;            ///< Standard deviation of the Gaussian energy filter in pixels.
+        float initialDensity = 0.1f;   ///< Fraction of pixels in the initial binary pattern.
+        uint32_t seed = 1;             ///< Seed for the initial binary pattern.
+
+        // Note: Empty constructor needed for clang due to the use of the nested struct constructor in the parent constructor.
+        Options() {}
+
+        bool operator==(const Options& other) const
+        {
+            return size == other.size && layerCount == other.layerCount && sigma == other.sigma && initialDensity == other.initialDensity &&
+                   seed == other.seed;
+        }
+    };
+
+    /**
+     * Generate the masks.
+     * @param[in] options Options.
+     */
+    explicit BlueNoiseMask(const Options& options = Options());
+
+    /**
+     * Load the masks from the cache, or generate them and store them in the cache if not available.
+     * @param[in] options Options.
+     * @param[in] cacheDirectory Cache directory.
+     * @return The masks.
+     */
+    static BlueNoiseMask createCached(const Options& options, const std::filesystem::path& cacheDirectory = getDefaultCacheDirectory());
+
+    /**
+     * Get the default cache directory, located in the application data directory.
+     */
+    static std::filesystem::path getDefaultCacheDirectory();
+
+    /**
+     * Get the path of the cache file for a set of options.
+     */
+    static std::filesystem::path getCachePath(const Options& options, const std::filesystem::path& cacheDirectory);
+
+    const Options& getOptions() const { return mOptions; }
+    uint32_t getSize() const { return mOptions.size; }
+    uint32_t getLayerCount() const { return mOptions.layerCount; }
+
+    /**
+     * Get the ranks of all layers, stored as layerCount masks of size x size pixels in scanline order.
+     */
+    const std::vector<uint32_t>& getRanks() const { return mRanks; }
+
+    uint32_t getRank(uint32_t layer, uint32_t x, uint32_t y) const { return mRanks[(size_t(layer) * mOptions.size + y) * mOptions.size + x]; }
+
+    /**
+     * Get the mask values in 32-bit fixed point, i.e. (rank + 0.5) / size^2 * 2^32.
+     * Adding a value to a 32-bit sample modulo 2^32 is a toroidal shift of the sample.
+     */
+    std::vector<uint32_t> getFixedPointValues() const;
+
+private:
+    BlueNoiseMask(const Options& options, std::vector<uint32_t> ranks) : mOptions(options), mRanks(std::move(ranks)) {}
+
+    static std::optional<std::vector<uint32_t>> readFromFile(const std::filesystem::path& path, const Options& options);
+    void writeToFile(const std::filesystem::path& path) const;
+
+    Options mOptions;
+    std::vector<uint32_t> mRanks;
+};
+} // namespace Falcor
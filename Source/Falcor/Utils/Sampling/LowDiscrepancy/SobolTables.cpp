@@ -0,0 +1,287 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SobolTables.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <execution>
+#include <limits>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+/// Carry-less multiplication of two polynomials over GF(2) modulo a polynomial of the given degree.
+uint64_t mulMod(uint64_t a, uint64_t b, uint64_t polynomial, uint32_t degree)
+{
+    uint64_t result = 0;
+    while (b)
+    {
+        if (b & 1)
+            result ^= a;
+        b >>= 1;
+        a <<= 1;
+        if (a & (1ull << degree))
+            a ^= polynomial;
+    }
+    return result;
+}
+
+/// Compute x^e modulo a polynomial over GF(2).
+uint64_t powXMod(uint64_t e, uint64_t polynomial, uint32_t degree)
+{
+    uint64_t result = 1;
+    uint64_t base = degree == 1 ? (2 ^ polynomial) : 2; // x mod p.
+    while (e)
+    {
+        if (e & 1)
+            result = mulMod(result, base, polynomial, degree);
+        base = mulMod(base, base, polynomial, degree);
+        e >>= 1;
+    }
+    return result;
+}
+
+std::vector<uint64_t> primeFactors(uint64_t n)
+{
+    std::vector<uint64_t> factors;
+    for (uint64_t p = 2; p * p <= n; p++)
+    {
+        if (n % p == 0)
+        {
+            factors.push_back(p);
+            while (n % p == 0)
+                n /= p;
+        }
+    }
+    if (n > 1)
+        factors.push_back(n);
+    return factors;
+}
+
+/// Compute the rank of a set of rows over GF(2).
+uint32_t computeRank(const uint32_t* pRows, uint32_t rowCount)
+{
+    // Each basis row has a distinct pivot (its lowest set bit), which is cleared in all later basis rows.
+    // Reducing a row against the basis rows in order therefore never sets an earlier pivot again.
+    uint32_t basis[32];
+    uint32_t pivots[32];
+    uint32_t rank = 0;
+    for (uint32_t i = 0; i < rowCount; i++)
+    {
+        uint32_t row = pRows[i];
+        for (uint32_t j = 0; j < rank; j++)
+        {
+            if (row & pivots[j])
+                row ^= basis[j];
+        }
+        if (row)
+        {
+            basis[rank] = row;
+            pivots[rank] = row & (~row + 1);
+            rank++;
+        }
+    }
+    return rank;
+}
+
+/// Transpose the direction numbers into rows of the generator matrix. Bit k of row i is digit i of direction number k.
+void computeRows(const uint32_t* pDirections, uint32_t log2SampleCount, uint32_t* pRows)
+{
+    for (uint32_t i = 0; i < log2SampleCount; i++)
+    {
+        uint32_t row = 0;
+        for (uint32_t k = 0; k < log2SampleCount; k++)
+            row |= ((pDirections[k] >> (31 - i)) & 1) << k;
+        pRows[i] = row;
+    }
+}
+
+/// Compute the t-value of a two-dimensional projection from the rows of the generator matrices.
+uint32_t computeTValueFromRows(const uint32_t* pRows0, const uint32_t* pRows1, uint32_t m)
+{
+    // The points form a (t,m,2)-net if every elementary interval of volume 2^(t-m) contains 2^t points.
+    // This holds if the first q0 rows of C0 and the first q1 rows of C1 are linearly independent for all q0 + q1 = m - t.
+    const uint32_t columnMask = m < 32 ? (1u << m) - 1 : ~0u;
+    uint32_t rows[64];
+    for (uint32_t t = 0; t < m; t++)
+    {
+        const uint32_t n = m - t;
+        bool isNet = true;
+        for (uint32_t q0 = 0; q0 <= n && isNet; q0++)
+        {
+            for (uint32_t i = 0; i < q0; i++)
+                rows[i] = pRows0[i] & columnMask;
+            for (uint32_t i = 0; i < n - q0; i++)
+                rows[q0 + i] = pRows1[i] & columnMask;
+            isNet = computeRank(rows, n) == n;
+        }
+        if (isNet)
+            return t;
+    }
+    return m;
+}
+
+void computeDirectionNumbers(uint32_t degree, uint32_t coefficients, const uint32_t* pInitial, uint32_t* pDirections)
+{
+    for (uint32_t k = 0; k < degree && k < SobolTables::kBitCount; k++)
+        pDirections[k] = pInitial[k] << (31 - k);
+    for (uint32_t k = degree; k < SobolTables::kBitCount; k++)
+    {
+        uint32_t v = pDirections[k - degree] ^ (pDirections[k - degree] >> degree);
+        for (uint32_t j = 1; j < degree; j++)
+        {
+            if ((coefficients >> (degree - 1 - j)) & 1)
+                v ^= pDirections[k - j];
+        }
+        pDirections[k] = v;
+    }
+}
+} // namespace
+
+SobolTables::SobolTables(const Options& options)
+{
+    FALCOR_CHECK(options.dimensionCount > 0 && options.dimensionCount <= kMaxDimensionCount, "Dimension count must be in [1,{}].", kMaxDimensionCount);
+    FALCOR_CHECK(options.candidateCount > 0, "Candidate count must be larger than zero.");
+    FALCOR_CHECK(options.optimizationLog2SampleCount <= kBitCount, "Optimization sample count must be at most 2^{}.", kBitCount);
+
+    mDimensionCount = options.dimensionCount;
+    mDirectionNumbers.resize(size_t(mDimensionCount) * kBitCount);
+    mDegrees.resize(mDimensionCount);
+    mCoefficients.resize(mDimensionCount);
+
+    // Find the primitive polynomials in order of increasing degree.
+    std::vector<std::pair<uint32_t, uint32_t>> polynomials; // (degree, polynomial)
+    for (uint32_t degree = 1; polynomials.size() + 1 < mDimensionCount; degree++)
+    {
+        FALCOR_ASSERT(degree < 32);
+        for (uint32_t p = (1u << degree) | 1u; p < (2u << degree) && polynomials.size() + 1 < mDimensionCount; p += 2)
+        {
+            if (isPrimitivePolynomial(p, degree))
+                polynomials.emplace_back(degree, p);
+        }
+    }
+
+    // The first dimension is the van der Corput sequence.
+    for (uint32_t k = 0; k < kBitCount; k++)
+        mDirectionNumbers[k] = 1u << (31 - k);
+
+    const uint32_t log2SampleCount = options.optimizationLog2SampleCount;
+    std::vector<uint32_t> rows(size_t(mDimensionCount) * kBitCount);
+    computeRows(mDirectionNumbers.data(), log2SampleCount, rows.data());
+
+    std::vector<uint32_t> candidates(size_t(options.candidateCount) * kBitCount);
+    std::vector<uint64_t> scores(options.candidateCount);
+
+    for (uint32_t d = 1; d < mDimensionCount; d++)
+    {
+        const uint32_t degree = polynomials[d - 1].first;
+        const uint32_t coefficients = (polynomials[d - 1].second >> 1) & ((1u << (degree - 1)) - 1);
+        mDegrees[d] = degree;
+        mCoefficients[d] = coefficients;
+
+        // Generate and score the candidates in parallel.
+        // The initial direction numbers m_k are odd and less than 2^k. The first candidate uses m_k = 1.
+        const uint32_t firstDimension = d > options.optimizationWindow ? d - options.optimizationWindow : 0;
+        NumericRange<uint32_t> candidateRange(0, options.candidateCount);
+        std::for_each(
+            std::execution::par,
+            candidateRange.begin(),
+            candidateRange.end(),
+            [&](uint32_t c)
+            {
+                std::seed_seq seq{options.seed, d, c};
+                std::mt19937 rng(seq);
+                uint32_t initial[32];
+                for (uint32_t k = 0; k < degree && k < kBitCount; k++)
+                    initial[k] = c == 0 ? 1u : ((rng() & ((1u << k) - 1)) << 1) | 1u;
+
+                uint32_t* pDirections = candidates.data() + size_t(c) * kBitCount;
+                computeDirectionNumbers(degree, coefficients, initial, pDirections);
+
+                uint32_t candidateRows[32];
+                computeRows(pDirections, log2SampleCount, candidateRows);
+                uint64_t score = 0;
+                for (uint32_t j = firstDimension; j < d; j++)
+                {
+                    for (uint32_t m = 1; m <= log2SampleCount; m++)
+                        score += computeTValueFromRows(rows.data() + size_t(j) * kBitCount, candidateRows, m);
+                }
+                scores[c] = score;
+            }
+        );
+
+        // Pick the candidate with the lowest score. Ties are resolved by the candidate index to make the result deterministic.
+        const uint32_t best = (uint32_t)std::distance(scores.begin(), std::min_element(scores.begin(), scores.end()));
+        std::copy_n(candidates.data() + size_t(best) * kBitCount, kBitCount, mDirectionNumbers.data() + size_t(d) * kBitCount);
+        computeRows(mDirectionNumbers.data() + size_t(d) * kBitCount, log2SampleCount, rows.data() + size_t(d) * kBitCount);
+    }
+}
+
+uint32_t SobolTables::sample(uint32_t index, uint32_t dimension) const
+{
+    FALCOR_ASSERT(dimension < mDimensionCount);
+    const uint32_t* pDirections = mDirectionNumbers.data() + size_t(dimension) * kBitCount;
+    uint32_t result = 0;
+    for (uint32_t k = 0; index; k++, index >>= 1)
+    {
+        if (index & 1)
+            result ^= pDirections[k];
+    }
+    return result;
+}
+
+uint32_t SobolTables::computeTValue(const uint32_t* pDirections0, const uint32_t* pDirections1, uint32_t log2SampleCount)
+{
+    FALCOR_CHECK(log2SampleCount <= kBitCount, "Sample count must be at most 2^{}.", kBitCount);
+    uint32_t rows0[32];
+    uint32_t rows1[32];
+    computeRows(pDirections0, log2SampleCount, rows0);
+    computeRows(pDirections1, log2SampleCount, rows1);
+    return computeTValueFromRows(rows0, rows1, log2SampleCount);
+}
+
+bool SobolTables::isPrimitivePolynomial(uint32_t polynomial, uint32_t degree)
+{
+    FALCOR_CHECK(degree > 0 && degree < 32, "Degree must be in [1,31].");
+    if ((polynomial >> degree) != 1 || (polynomial & 1) == 0)
+        return false;
+
+    // The polynomial is primitive if the multiplicative order of x modulo the polynomial is 2^degree - 1.
+    const uint64_t order = (1ull << degree) - 1;
+    if (powXMod(order, polynomial, degree) != 1)
+        return false;
+    for (uint64_t factor : primeFactors(order))
+    {
+        if (powXMod(order / factor, polynomial, degree) == 1)
+            return false;
+    }
+    return true;
+}
+} // namespace Falcor
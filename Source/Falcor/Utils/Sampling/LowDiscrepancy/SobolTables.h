@@ -0,0 +1,119 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Direction numbers for the Sobol sequence.
+ *
+ * The direction numbers are generated on the CPU rather than loaded from a table.
+ * The first dimension is the van der Corput sequence and the second dimension uses
+ * the polynomial x+1. The remaining dimensions use the primitive polynomials over GF(2)
+ * in order of increasing degree, found by testing the order of x modulo each polynomial.
+ *
+ * The initial direction numbers m_1..m_s of each dimension are chosen from a set of
+ * pseudorandom candidates, minimizing the t-values of the two-dimensional projections
+ * onto all previous dimensions, similar in spirit to the search by Joe and Kuo, 2008.
+ * Candidates are evaluated in parallel. The result only depends on the options.
+ */
+class FALCOR_API SobolTables
+{
+public:
+    static constexpr uint32_t kBitCount = 32; ///< Number of direction numbers per dimension.
+    static constexpr uint32_t kMaxDimensionCount = 1024;
+
+    struct Options
+    {
+        uint32_t dimensionCount = 64;  ///< Number of dimensions.
+        uint32_t candidateCount = 64;  ///< Number of candidate initial direction numbers to evaluate per dimension.
+        uint32_t optimizationLog2SampleCount = 10; ///< Two-dimensional projections are optimized for the first 2^1..2^N samples.
+        uint32_t optimizationWindow = 64;          ///< Number of previous dimensions to optimize the two-dimensional projections against.
+        uint32_t seed = 1;             ///< Seed for generating the candidates.
+
+        // Note: Empty constructor needed for clang due to the use of the nested struct constructor in the parent constructor.
+        Options() {}
+    };
+
+    /**
+     * Generate the direction numbers.
+     * @param[in] options Options.
+     */
+    explicit SobolTables(const Options& options = Options());
+
+    uint32_t getDimensionCount() const { return mDimensionCount; }
+
+    /**
+     * Get the direction numbers, stored as kBitCount values per dimension.
+     * Direction number k of a dimension is the column for bit k of the sample index, with the first digit in the most significant bit.
+     */
+    const std::vector<uint32_t>& getDirectionNumbers() const { return mDirectionNumbers; }
+
+    /**
+     * Get the degree and coefficients of the primitive polynomial of a dimension.
+     * The coefficients are encoded as in Joe and Kuo's tables, i.e. the s-1 inner coefficients with the highest degree in the most significant bit.
+     * The first dimension has degree 0.
+     */
+    uint32_t getDegree(uint32_t dimension) const { return mDegrees[dimension]; }
+    uint32_t getCoefficients(uint32_t dimension) const { return mCoefficients[dimension]; }
+
+    /**
+     * Evaluate a sample of the (unscrambled) Sobol sequence.
+     * @param[in] index Sample index.
+     * @param[in] dimension Dimension.
+     * @return Sample value in fixed point, i.e. the value is x * 2^-32.
+     */
+    uint32_t sample(uint32_t index, uint32_t dimension) const;
+
+    /**
+     * Compute the t-value of the two-dimensional projection of the first 2^log2SampleCount points.
+     * The points form a (t,m,2)-net in base 2 with m = log2SampleCount.
+     * @param[in] pDirections0 Direction numbers of the first dimension.
+     * @param[in] pDirections1 Direction numbers of the second dimension.
+     * @param[in] log2SampleCount Log2 of the sample count, at most kBitCount.
+     * @return The t-value.
+     */
+    static uint32_t computeTValue(const uint32_t* pDirections0, const uint32_t* pDirections1, uint32_t log2SampleCount);
+
+    /**
+     * Test if a polynomial over GF(2) is primitive.
+     * @param[in] polynomial Polynomial, with the coefficient for x^i in bit i.
+     * @param[in] degree Degree of the polynomial, at most 31.
+     */
+    static bool isPrimitivePolynomial(uint32_t polynomial, uint32_t degree);
+
+private:
+    uint32_t mDimensionCount = 0;
+    std::vector<uint32_t> mDirectionNumbers;
+    std::vector<uint32_t> mDegrees;
+    std::vector<uint32_t> mCoefficients;
+};
+} // namespace Falcor
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "SampleGenerator.h"
+#include "SobolSampleGenerator.h"
 
 namespace Falcor
 {
@@ -74,6 +75,16 @@ void SampleGenerator::registerAll()
         "Uniform (128-bit)",
         [](ref<Device> pDevice) { return ref<SampleGenerator>(new SampleGenerator(pDevice, SAMPLE_GENERATOR_UNIFORM)); }
     );
+    registerType(
+        SAMPLE_GENERATOR_SOBOL,
+        "Sobol (scrambled)",
+        [](ref<Device> pDevice) { return ref<SampleGenerator>(new SobolSampleGenerator(pDevice, SAMPLE_GENERATOR_SOBOL)); }
+    );
+    registerType(
+        SAMPLE_GENERATOR_SOBOL_BLUE_NOISE,
+        "Sobol (blue noise)",
+        [](ref<Device> pDevice) { return ref<SampleGenerator>(new SobolSampleGenerator(pDevice, SAMPLE_GENERATOR_SOBOL_BLUE_NOISE)); }
+    );
 }
 
 // Automatically register basic sampler types.
@@ -0,0 +1,161 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SobolSampleGenerator.h"
+#include "LowDiscrepancy/OwenScrambling.slang"
+#include "Core/API/Device.h"
+#include "Utils/Logger.h"
+#include "Utils/Timing/CpuTimer.h"
+
+namespace Falcor
+{
+namespace
+{
+/// Blue-noise mask values in 32-bit fixed point, as uploaded to the GPU.
+const std::vector<uint32_t>& getBlueNoiseValues()
+{
+    static const std::vector<uint32_t> values = SobolSampleGenerator::getBlueNoiseMask().getFixedPointValues();
+    return values;
+}
+} // namespace
+
+SobolSampleGenerator::SobolSampleGenerator(ref<Device> pDevice, uint32_t type, const Options& options)
+    : SampleGenerator(pDevice, type), mOptions(options)
+{
+    FALCOR_CHECK(type == SAMPLE_GENERATOR_SOBOL || type == SAMPLE_GENERATOR_SOBOL_BLUE_NOISE, "Invalid Sobol sample generator type.");
+    mUseBlueNoise = type == SAMPLE_GENERATOR_SOBOL_BLUE_NOISE;
+
+    const auto& directionNumbers = getSobolTables().getDirectionNumbers();
+    mpDirectionNumbers = mpDevice->createStructuredBuffer(
+        sizeof(uint32_t), (uint32_t)directionNumbers.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, directionNumbers.data(), false
+    );
+    mpDirectionNumbers->setName("SobolSampleGenerator::mpDirectionNumbers");
+
+    if (mUseBlueNoise)
+    {
+        const auto& values = getBlueNoiseValues();
+        mpBlueNoise = mpDevice->createStructuredBuffer(
+            sizeof(uint32_t), (uint32_t)values.size(), ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, values.data(), false
+        );
+        mpBlueNoise->setName("SobolSampleGenerator::mpBlueNoise");
+    }
+}
+
+void SobolSampleGenerator::bindShaderData(const ShaderVar& var) const
+{
+    // The parameter block only exists if the program uses the sample generator.
+    ShaderVar data = var.findMember("gSobolSampleGenerator");
+    if (!data.isValid())
+        return;
+
+    data["directionNumbers"] = mpDirectionNumbers;
+    data["dimensionCount"] = getSobolTables().getDimensionCount();
+    data["scrambling"] = (uint32_t)mOptions.scrambling;
+    if (mUseBlueNoise)
+    {
+        const auto& mask = getBlueNoiseMask();
+        data["blueNoise"] = mpBlueNoise;
+        data["blueNoiseSize"] = mask.getSize();
+        data["blueNoiseLayerCount"] = mask.getLayerCount();
+    }
+}
+
+void SobolSampleGenerator::renderUI(Gui::Widgets& widget)
+{
+    if (widget.dropdown("Scrambling", mOptions.scrambling))
+        mOptionsChanged = true;
+    widget.tooltip(
+        "RandomDigit: XOR each dimension with a random value.\n"
+        "Owen: Nested uniform scrambling, which decorrelates the dimensions while preserving the stratification."
+    );
+}
+
+bool SobolSampleGenerator::beginFrame(RenderContext* pRenderContext, const uint2& frameDim)
+{
+    bool changed = mOptionsChanged;
+    mOptionsChanged = false;
+    return changed;
+}
+
+void SobolSampleGenerator::setOptions(const Options& options)
+{
+    mOptions = options;
+    mOptionsChanged = true;
+}
+
+uint32_t SobolSampleGenerator::generateSample(uint2 pixel, uint32_t sampleNumber, uint32_t dimension) const
+{
+    const auto& tables = getSobolTables();
+    const uint32_t packedPixel = (pixel.x & 0xffff) | (pixel.y << 16);
+
+    const uint32_t wrap = dimension / tables.getDimensionCount();
+    const uint32_t tableDimension = dimension % tables.getDimensionCount();
+
+    const uint32_t seed = scrambleHashCombine(mUseBlueNoise ? 0 : scrambleHash(packedPixel), wrap);
+    const uint32_t index = nestedUniformScramble(sampleNumber, seed);
+    uint32_t x = tables.sample(index, tableDimension);
+
+    const uint32_t dimensionSeed = scrambleHashCombine(seed, tableDimension);
+    if (mOptions.scrambling == SobolScrambling::Owen)
+        x = nestedUniformScramble(x, dimensionSeed);
+    else
+        x ^= scrambleHash(dimensionSeed);
+
+    if (mUseBlueNoise)
+    {
+        const auto& mask = getBlueNoiseMask();
+        const uint32_t size = mask.getSize();
+        const uint32_t offset = scrambleHash(dimension);
+        const uint32_t px = (pixel.x + offset) & (size - 1);
+        const uint32_t py = (pixel.y + (offset >> 16)) & (size - 1);
+        const uint32_t layer = dimension % mask.getLayerCount();
+        x += getBlueNoiseValues()[(layer * size + py) * size + px];
+    }
+
+    return x;
+}
+
+const SobolTables& SobolSampleGenerator::getSobolTables()
+{
+    static const SobolTables tables = []()
+    {
+        CpuTimer timer;
+        timer.update();
+        SobolTables result;
+        timer.update();
+        logInfo("Generated Sobol direction numbers for {} dimensions in {:.2f} s.", result.getDimensionCount(), timer.delta());
+        return result;
+    }();
+    return tables;
+}
+
+const BlueNoiseMask& SobolSampleGenerator::getBlueNoiseMask()
+{
+    static const BlueNoiseMask mask = BlueNoiseMask::createCached(BlueNoiseMask::Options());
+    return mask;
+}
+} // namespace Falcor
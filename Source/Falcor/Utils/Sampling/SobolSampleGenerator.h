@@ -0,0 +1,98 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SampleGenerator.h"
+#include "SobolSampleGeneratorTypes.slang"
+#include "BlueNoiseMask.h"
+#include "LowDiscrepancy/SobolTables.h"
+#include "Core/API/Buffer.h"
+
+namespace Falcor
+{
+/**
+ * Sample generator based on the Sobol sequence.
+ *
+ * Supports the types SAMPLE_GENERATOR_SOBOL, with per-pixel scrambled sequences, and
+ * SAMPLE_GENERATOR_SOBOL_BLUE_NOISE, which shares one sequence between all pixels and rotates
+ * it per pixel by blue-noise masks. The direction numbers and blue-noise masks are generated
+ * on the CPU once per process and uploaded to the GPU. The blue-noise masks are cached on disk.
+ */
+class FALCOR_API SobolSampleGenerator : public SampleGenerator
+{
+public:
+    struct Options
+    {
+        SobolScrambling scrambling = SobolScrambling::Owen;
+
+        // Note: Empty constructor needed for clang due to the use of the nested struct constructor in the parent constructor.
+        Options() {}
+    };
+
+    /**
+     * Constructor.
+     * @param[in] pDevice GPU device.
+     * @param[in] type The type of sample generator, SAMPLE_GENERATOR_SOBOL or SAMPLE_GENERATOR_SOBOL_BLUE_NOISE.
+     * @param[in] options Options.
+     */
+    SobolSampleGenerator(ref<Device> pDevice, uint32_t type, const Options& options = Options());
+
+    void bindShaderData(const ShaderVar& var) const override;
+    void renderUI(Gui::Widgets& widget) override;
+    bool beginFrame(RenderContext* pRenderContext, const uint2& frameDim) override;
+
+    const Options& getOptions() const { return mOptions; }
+    void setOptions(const Options& options);
+
+    /**
+     * Generate a sample on the CPU. This matches the sample returned by the GPU sample generator.
+     * @param[in] pixel Pixel id.
+     * @param[in] sampleNumber Sample number.
+     * @param[in] dimension Sample dimension, i.e. the number of previous calls to next() on the GPU.
+     * @return Sample value in 32-bit fixed point.
+     */
+    uint32_t generateSample(uint2 pixel, uint32_t sampleNumber, uint32_t dimension) const;
+
+    /**
+     * Get the Sobol direction number tables used by all Sobol sample generators.
+     */
+    static const SobolTables& getSobolTables();
+
+    /**
+     * Get the blue-noise masks used by all blue-noise Sobol sample generators.
+     */
+    static const BlueNoiseMask& getBlueNoiseMask();
+
+private:
+    Options mOptions;
+    bool mUseBlueNoise;
+    bool mOptionsChanged = false;
+
+    ref<Buffer> mpDirectionNumbers;
+    ref<Buffer> mpBlueNoise;
+};
+} // namespace Falcor
@@ -210,6 +210,13 @@ void PreviewSurfaceConverter::cacheMaterial(const StandardMaterialSpec& spec, re
     mSpecCacheUpdated.notify_all();
 }
 
+void PreviewSurfaceConverter::clearCache()
+{
+    std::unique_lock lock(mCacheMutex);
+    mPrimMaterialCache.clear();
+    mSpecMaterialCache.clear();
+}
+
 bool getFloat2Value(const UsdShadeInput& input, float2& val)
 {
     SdfValueTypeName typeName(input.GetTypeName());
@@ -517,7 +524,8 @@ StandardMaterialSpec::ConvertedInput PreviewSurfaceConverter::convertColor(
     return ret;
 }
 
-PreviewSurfaceConverter::PreviewSurfaceConverter(ref<Device> pDevice) : mpDevice(pDevice)
+PreviewSurfaceConverter::PreviewSurfaceConverter(ref<Device> pDevice, bool shareIdenticalMaterials)
+    : mpDevice(pDevice), mShareIdenticalMaterials(shareIdenticalMaterials)
 {
     mpSpecTransPass = ComputePass::create(mpDevice, kSpecTransShaderFile, kSpecTransShaderEntry);
 
@@ -964,7 +972,8 @@ ref<Material> PreviewSurfaceConverter::convert(const UsdShadeMaterial& material,
     StandardMaterialSpec spec = createSpec(materialName, shader);
 
     // Does there already exist a material matching this spec? If so, return it.
-    pMaterial = getCachedMaterial(spec);
+    if (mShareIdenticalMaterials)
+        pMaterial = getCachedMaterial(spec);
     if (pMaterial)
     {
         // There is an entry for this material in the by-spec cache. Ensure that there is also an entry in the by-prim
@@ -1103,7 +1112,8 @@ ref<Material> PreviewSurfaceConverter::convert(const UsdShadeMaterial& material,
 
     // Cache the result of the conversion, both by shader node and by spec.
     cacheMaterial(shader, pMaterial);
-    cacheMaterial(spec, pMaterial);
+    if (mShareIdenticalMaterials)
+        cacheMaterial(spec, pMaterial);
 
     return pMaterial;
 }
@@ -56,8 +56,9 @@ class PreviewSurfaceConverter
 public:
     /**
      * Create a new converter, compiling required compute shaders
+     * \param shareIdenticalMaterials If true, materials with identical parameters are converted to a single Falcor material.
      */
-    PreviewSurfaceConverter(ref<Device> pDevice);
+    PreviewSurfaceConverter(ref<Device> pDevice, bool shareIdenticalMaterials = true);
 
     /**
      * Create a Falcor material from a USD material containing a UsdPreviewSurface shader.
@@ -67,6 +68,12 @@ public:
      */
     ref<Material> convert(const pxr::UsdShadeMaterial& material, const std::string& primName, RenderContext* pRenderContext);
 
+    /**
+     * Clear the material caches, so that subsequent conversions pick up changes to the USD materials.
+     * Must not be called while conversions are in progress.
+     */
+    void clearCache();
+
 private:
     StandardMaterialSpec createSpec(const std::string& name, const UsdShadeShader& shader) const;
     ref<Texture> loadTexture(const StandardMaterialSpec::ConvertedInput& ci);
@@ -112,6 +119,7 @@ private:
     void cacheMaterial(const StandardMaterialSpec& spec, ref<StandardMaterial> pMaterial);
 
     ref<Device> mpDevice;
+    bool mShareIdenticalMaterials; ///< Convert materials with identical parameters to a single Falcor material.
 
     ref<ComputePass> mpSpecTransPass; ///< Pass to convert opacity to transparency
     ref<ComputePass> mpPackAlphaPass; ///< Pass to convert separate RGB and A to RGBA
@@ -0,0 +1,321 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "USDSceneUpdater.h"
+#include "Core/API/Device.h"
+#include "Utils/Logger.h"
+
+BEGIN_DISABLE_USD_WARNINGS
+#include <pxr/usd/ar/resolver.h>
+#include <pxr/usd/ar/resolverContextBinder.h>
+#include <pxr/usd/usd/primRange.h>
+#include <pxr/usd/usdGeom/xformable.h>
+#include <pxr/usd/usdLux/boundableLightBase.h>
+#include <pxr/usd/usdLux/nonboundableLightBase.h>
+#include <pxr/usd/usdShade/material.h>
+END_DISABLE_USD_WARNINGS
+
+#include <set>
+
+namespace Falcor
+{
+namespace
+{
+using PropertyKind = SceneChangeMapper::PropertyKind;
+using ObjectType = SceneChangeMapper::ObjectType;
+
+// Effect of changes to USD properties. Properties not listed are material or light parameters.
+const std::pair<const char*, PropertyKind> kPropertyKinds[] = {
+    // Transforms.
+    {"xformOp:*", PropertyKind::Transform},
+    {"xformOpOrder", PropertyKind::Transform},
+    // Geometry.
+    {"points", PropertyKind::Topology},
+    {"normals", PropertyKind::Topology},
+    {"faceVertexCounts", PropertyKind::Topology},
+    {"faceVertexIndices", PropertyKind::Topology},
+    {"holeIndices", PropertyKind::Topology},
+    {"subdivisionScheme", PropertyKind::Topology},
+    {"interpolateBoundary", PropertyKind::Topology},
+    {"faceVaryingLinearInterpolation", PropertyKind::Topology},
+    {"orientation", PropertyKind::Topology},
+    {"curveVertexCounts", PropertyKind::Topology},
+    {"widths", PropertyKind::Topology},
+    {"basis", PropertyKind::Topology},
+    {"type", PropertyKind::Topology},
+    {"wrap", PropertyKind::Topology},
+    {"primvars:*", PropertyKind::Topology},
+    {"skel:*", PropertyKind::Topology},
+    {"extent", PropertyKind::Ignore},
+    // Scene structure.
+    {"visibility", PropertyKind::Topology},
+    {"purpose", PropertyKind::Topology},
+    {"material:binding*", PropertyKind::Topology},
+    // Light shapes and environment maps, which are baked into light transforms and textures.
+    {"width", PropertyKind::Topology},
+    {"height", PropertyKind::Topology},
+    {"radius", PropertyKind::Topology},
+    {"angle", PropertyKind::Topology},
+    {"inputs:width", PropertyKind::Topology},
+    {"inputs:height", PropertyKind::Topology},
+    {"inputs:radius", PropertyKind::Topology},
+    {"inputs:angle", PropertyKind::Topology},
+    {"texture:*", PropertyKind::Topology},
+    {"inputs:texture:*", PropertyKind::Topology},
+    // Light shaping (spot cone and softness, focus, IES profiles) has no counterpart in the imported lights.
+    {"shaping:*", PropertyKind::Topology},
+    {"inputs:shaping:*", PropertyKind::Topology},
+    // Metadata.
+    {"documentation", PropertyKind::Ignore},
+    {"kind", PropertyKind::Ignore},
+    {"comment", PropertyKind::Ignore},
+};
+
+bool isSourcePath(const std::string& name)
+{
+    return !name.empty() && name[0] == '/';
+}
+
+bool isLight(const UsdPrim& prim)
+{
+    return prim.IsA<UsdLuxBoundableLightBase>() || prim.IsA<UsdLuxNonboundableLightBase>();
+}
+} // namespace
+
+USDSceneUpdater::USDSceneUpdater(UsdStageRefPtr pStage, ref<Scene> pScene) : mpStage(pStage), mpScene(pScene)
+{
+    FALCOR_CHECK(mpStage, "'pStage' is missing");
+    FALCOR_CHECK(mpScene != nullptr, "'pScene' is missing");
+    FALCOR_CHECK(mpScene->preservesSourceObjects(), "Scene must be built with SceneBuilder::Flags::PreserveSourceObjects to be updated in place.");
+
+    for (const auto& [pattern, kind] : kPropertyKinds)
+        mMapper.setPropertyKind(pattern, kind);
+    registerSceneObjects();
+
+    mNoticeKey = TfNotice::Register(TfCreateWeakPtr(this), &USDSceneUpdater::onObjectsChanged, UsdStageWeakPtr(mpStage));
+}
+
+USDSceneUpdater::~USDSceneUpdater()
+{
+    TfNotice::Revoke(mNoticeKey);
+}
+
+std::unique_ptr<USDSceneUpdater> USDSceneUpdater::open(const std::filesystem::path& path, ref<Scene> pScene)
+{
+    // Resolve asset paths the same way as the importer.
+    auto resolverContext = ArGetResolver().CreateDefaultContextForAsset(path.string());
+    ArResolverContextBinder binder(resolverContext);
+
+    UsdStageRefPtr pStage = UsdStage::Open(path.string());
+    if (!pStage)
+        FALCOR_THROW("Failed to open USD stage '{}'.", path);
+    return std::make_unique<USDSceneUpdater>(pStage, pScene);
+}
+
+void USDSceneUpdater::reload()
+{
+    mpStage->Reload();
+}
+
+bool USDSceneUpdater::hasPendingChanges() const
+{
+    std::lock_guard lock(mMutex);
+    return !mPendingChanges.empty();
+}
+
+void USDSceneUpdater::registerSceneObjects()
+{
+    // Nodes, materials and meshes are named after the prims they were imported from.
+    for (uint32_t nodeID = 0; nodeID < mpScene->getNodeCount(); ++nodeID)
+    {
+        const auto& name = mpScene->getNode(nodeID).name;
+        if (isSourcePath(name))
+            mMapper.registerObject(name, ObjectType::Node, nodeID);
+    }
+
+    for (uint32_t materialID = 0; materialID < mpScene->getMaterialCount(); ++materialID)
+    {
+        const auto& name = mpScene->getMaterial(MaterialID{materialID})->getName();
+        if (isSourcePath(name))
+            mMapper.registerObject(name, ObjectType::Material, materialID);
+    }
+
+    for (uint32_t meshID = 0; meshID < mpScene->getMeshCount(); ++meshID)
+    {
+        std::string name = mpScene->getMeshName(meshID);
+        if (isSourcePath(name))
+            mMapper.registerObject(name, ObjectType::Mesh, meshID);
+    }
+
+    // Lights are attached to a child of the node of their prim.
+    std::set<std::string> lightPaths;
+    for (uint32_t lightID = 0; lightID < mpScene->getLightCount(); ++lightID)
+    {
+        NodeID nodeID = mpScene->getLight(lightID)->getNodeID();
+        if (nodeID == NodeID::Invalid())
+            continue;
+        NodeID parentID = mpScene->getNode(nodeID.get()).parent;
+        if (parentID == NodeID::Invalid())
+            continue;
+        const auto& path = mpScene->getNode(parentID.get()).name;
+        if (isSourcePath(path))
+        {
+            mMapper.registerObject(path, ObjectType::Light, lightID);
+            lightPaths.insert(path);
+        }
+    }
+
+    // Remaining lights were imported as emissive meshes or environment maps, which are only updated by a rebuild.
+    for (const UsdPrim& prim : mpStage->Traverse())
+    {
+        if (isLight(prim) && lightPaths.count(prim.GetPath().GetString()) == 0)
+            mMapper.registerObject(prim.GetPath().GetString(), ObjectType::Other, 0);
+    }
+
+    logDebug("USDSceneUpdater: Registered {} scene objects.", mMapper.getObjectCount());
+}
+
+void USDSceneUpdater::onObjectsChanged(const UsdNotice::ObjectsChanged& notice, const UsdStageWeakPtr& sender)
+{
+    std::lock_guard lock(mMutex);
+
+    auto addChange = [this, &notice](const SdfPath& path, bool resync)
+    {
+        if (path.IsPropertyPath())
+        {
+            mPendingChanges.push_back({path.GetPrimPath().GetString(), {path.GetName()}, false});
+        }
+        else if (resync)
+        {
+            mPendingChanges.push_back({path.GetString(), {}, true});
+        }
+        else
+        {
+            // Metadata of the prim itself changed.
+            SceneChangeMapper::Change change{path.GetString(), {}, false};
+            for (const TfToken& field : notice.GetChangedFields(path))
+                change.properties.push_back(field.GetString());
+            mPendingChanges.push_back(std::move(change));
+        }
+    };
+
+    for (const SdfPath& path : notice.GetResyncedPaths())
+        addChange(path, true);
+    for (const SdfPath& path : notice.GetChangedInfoOnlyPaths())
+        addChange(path, false);
+}
+
+bool USDSceneUpdater::apply()
+{
+    std::vector<SceneChangeMapper::Change> changes;
+    {
+        std::lock_guard lock(mMutex);
+        changes.swap(mPendingChanges);
+    }
+    if (changes.empty())
+        return true;
+
+    auto result = mMapper.map(changes);
+    if (result.rebuild)
+    {
+        logInfo("USDSceneUpdater: Scene needs to be rebuilt. {}.", result.rebuildReason);
+        return false;
+    }
+
+    // Materials are converted again from the current stage contents.
+    if (mpPreviewSurfaceConverter)
+        mpPreviewSurfaceConverter->clearCache();
+
+    // Prepare all updates before changing anything, so that the scene is left untouched if any of them fails.
+    std::vector<std::function<void()>> applyFuncs;
+    applyFuncs.reserve(result.updates.size());
+    for (const auto& update : result.updates)
+    {
+        auto applyFunc = prepareUpdate(update);
+        if (!applyFunc)
+        {
+            logInfo("USDSceneUpdater: Scene needs to be rebuilt. Can't update '{}' in place.", update.path);
+            return false;
+        }
+        applyFuncs.push_back(std::move(applyFunc));
+    }
+
+    for (const auto& applyFunc : applyFuncs)
+        applyFunc();
+
+    logDebug("USDSceneUpdater: Applied {} updates from {} changes.", result.updates.size(), changes.size());
+    return true;
+}
+
+std::function<void()> USDSceneUpdater::prepareUpdate(const SceneChangeMapper::Update& update)
+{
+    UsdPrim prim = mpStage->GetPrimAtPath(SdfPath(update.path));
+    if (!prim)
+        return {};
+
+    switch (update.type)
+    {
+    case ObjectType::Node:
+    {
+        // Time-varying transforms were imported as animations.
+        UsdGeomXformable xformable(prim);
+        if (!xformable || xformable.TransformMightBeTimeVarying())
+            return {};
+        float4x4 transform;
+        getLocalTransform(xformable, transform);
+        return [this, id = update.id, transform]() { mpScene->updateNodeTransform(id, transform); };
+    }
+    case ObjectType::Material:
+    {
+        UsdShadeMaterial material(prim);
+        if (!material)
+            return {};
+        if (!mpPreviewSurfaceConverter)
+            mpPreviewSurfaceConverter = std::make_unique<PreviewSurfaceConverter>(mpScene->getDevice(), false);
+
+        ref<Material> pMaterial = mpPreviewSurfaceConverter->convert(material, update.path, mpScene->getDevice()->getRenderContext());
+        const auto& pPrevMaterial = mpScene->getMaterial(MaterialID{update.id});
+        if (!pMaterial || pMaterial->getType() != pPrevMaterial->getType())
+            return {};
+        return [this, id = update.id, pMaterial]() { mpScene->getMaterialSystem().replaceMaterial(MaterialID{id}, pMaterial); };
+    }
+    case ObjectType::Light:
+    {
+        float3 intensity;
+        if (prim.IsA<UsdLuxBoundableLightBase>())
+            intensity = getLightIntensity(UsdLuxBoundableLightBase(prim), prim);
+        else if (prim.IsA<UsdLuxNonboundableLightBase>())
+            intensity = getLightIntensity(UsdLuxNonboundableLightBase(prim), prim);
+        else
+            return {};
+        return [this, id = update.id, intensity]() { mpScene->getLight(id)->setIntensity(intensity); };
+    }
+    default:
+        return {};
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,124 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "USDHelpers.h"
+#include "USDUtils.h"
+#include "PreviewSurfaceConverter/PreviewSurfaceConverter.h"
+#include "Core/Object.h"
+#include "Scene/Scene.h"
+#include "Scene/SceneChangeMapper.h"
+
+BEGIN_DISABLE_USD_WARNINGS
+#include <pxr/base/tf/notice.h>
+#include <pxr/base/tf/weakBase.h>
+#include <pxr/usd/usd/notice.h>
+#include <pxr/usd/usd/stage.h>
+END_DISABLE_USD_WARNINGS
+
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Falcor
+{
+
+/**
+ * Applies edits of a USD stage to a scene imported from it, without rebuilding the scene.
+ *
+ * The updater listens to UsdNotice::ObjectsChanged on the stage and collects the changed prims and properties.
+ * apply() maps them to the scene nodes, materials and lights that were imported from them (see SceneChangeMapper)
+ * and updates those in place. Changes to topology or to the prim hierarchy are reported instead, so that the caller
+ * can rebuild the scene. Either all collected changes are applied or none of them. The scene must have been imported
+ * from the same stage contents with SceneBuilder::Flags::PreserveSourceObjects set.
+ */
+class USDSceneUpdater : public TfWeakBase
+{
+public:
+    /**
+     * Create an updater and start listening to changes of the stage.
+     * \param pStage Stage the scene was imported from.
+     * \param pScene Scene to update.
+     */
+    USDSceneUpdater(UsdStageRefPtr pStage, ref<Scene> pScene);
+    ~USDSceneUpdater();
+
+    /**
+     * Open the stage a scene was imported from and create an updater for it.
+     * Throws an exception if the stage can't be opened.
+     * \param path Path of the USD file the scene was imported from.
+     * \param pScene Scene to update.
+     */
+    static std::unique_ptr<USDSceneUpdater> open(const std::filesystem::path& path, ref<Scene> pScene);
+
+    USDSceneUpdater(const USDSceneUpdater&) = delete;
+    USDSceneUpdater& operator=(const USDSceneUpdater&) = delete;
+
+    /**
+     * Reload the layers of the stage that changed on disk. The resulting changes are collected like any other edit.
+     */
+    void reload();
+
+    /**
+     * Apply the changes collected since the last call to the scene.
+     * Must be called from the thread that updates the scene, before Scene::update().
+     * \return False if the scene needs to be rebuilt to reflect the changes.
+     */
+    bool apply();
+
+    /**
+     * Check if there are changes that haven't been applied yet.
+     */
+    bool hasPendingChanges() const;
+
+    /**
+     * Get the mapping from prims to scene objects.
+     */
+    const SceneChangeMapper& getMapper() const { return mMapper; }
+
+private:
+    void onObjectsChanged(const UsdNotice::ObjectsChanged& notice, const UsdStageWeakPtr& sender);
+    void registerSceneObjects();
+    /**
+     * Prepare an in-place update of a scene object from the current state of its prim.
+     * Nothing in the scene is changed until the returned function is called.
+     * \return Function applying the update, or an empty function if the object can't be updated in place.
+     */
+    std::function<void()> prepareUpdate(const SceneChangeMapper::Update& update);
+
+    UsdStageRefPtr mpStage;
+    ref<Scene> mpScene;
+    SceneChangeMapper mMapper;
+    std::unique_ptr<PreviewSurfaceConverter> mpPreviewSurfaceConverter; ///< Converter for changed materials, created on first use.
+    TfNotice::Key mNoticeKey;
+
+    mutable std::mutex mMutex;                                  ///< Mutex protecting the pending changes, as notices may be sent from any thread.
+    std::vector<SceneChangeMapper::Change> mPendingChanges;     ///< Changes collected since the last call to apply().
+};
+} // namespace Falcor
@@ -45,8 +45,10 @@ BEGIN_DISABLE_USD_WARNINGS
 #include <pxr/usd/usdGeom/imageable.h>
 #include <pxr/usd/usdGeom/mesh.h>
 #include <pxr/usd/usdGeom/primvarsAPI.h>
+#include <pxr/usd/usdLux/blackbody.h>
 END_DISABLE_USD_WARNINGS
 
+#include <cmath>
 #include <string>
 #include <functional>
 
@@ -155,6 +157,22 @@ inline T getAuthoredAttribute(const UsdAttribute& mainAttrib, const UsdAttribute
     return val;
 }
 
+// Helper function to compute the Falcor intensity of a UsdLux light from its intensity, exposure and color attributes.
+template<typename UsdLuxLightType>
+inline float3 getLightIntensity(const UsdLuxLightType& light, const UsdPrim& prim)
+{
+    float exposure = getAuthoredAttribute(light.GetExposureAttr(), prim.GetAttribute(TfToken("exposure")), 0.f);
+    float intens = getAuthoredAttribute(light.GetIntensityAttr(), prim.GetAttribute(TfToken("intensity")), 1.f);
+    GfVec3f blackbodyRGB(1.f, 1.f, 1.f);
+    if (getAuthoredAttribute(light.GetEnableColorTemperatureAttr(), prim.GetAttribute(TfToken("enableColorTemperature")), false))
+    {
+        float temperature = getAuthoredAttribute(light.GetColorTemperatureAttr(), prim.GetAttribute(TfToken("colorTemperature")), 6500.f);
+        blackbodyRGB = UsdLuxBlackbodyTemperatureAsRgb(temperature);
+    }
+    GfVec3f color = getAuthoredAttribute(light.GetColorAttr(), prim.GetAttribute(TfToken("color")), GfVec3f(1.f, 1.f, 1.f));
+    return std::exp2(exposure) * intens * toFalcor(blackbodyRGB) * toFalcor(color);
+}
+
 template<class T>
 inline T getAttribute(const UsdPrim& prim, const std::string& attribName, const T& def)
 {
@@ -128,6 +128,8 @@ namespace
     const std::string kLightBVHOptions = "lightBVHOptions";
     const std::string kUseRTXDI = "useRTXDI";
     const std::string kRTXDIOptions = "RTXDIOptions";
+    const std::string kUseAnalyticLightBVH = "useAnalyticLightBVH";
+    const std::string kAnalyticLightBVHOptions = "analyticLightBVHOptions";
 
     const std::string kUseAlphaTest = "useAlphaTest";
     const std::string kAdjustShadingNormals = "adjustShadingNormals";
@@ -203,6 +205,8 @@ void PathTracer::setProperties(const Properties& props)
         lightBVHSampler->setOptions(mLightBVHOptions);
     if (mpRTXDI)
         mpRTXDI->setOptions(mRTXDIOptions);
+    if (mpAnalyticLightSampler)
+        mpAnalyticLightSampler->setOptions(mAnalyticLightBVHOptions);
     mRecompile = true;
     mOptionsChanged = true;
 }
@@ -231,6 +235,8 @@ void PathTracer::parseProperties(const Properties& props)
         else if (key == kLightBVHOptions) mLightBVHOptions = value;
         else if (key == kUseRTXDI) mStaticParams.useRTXDI = value;
         else if (key == kRTXDIOptions) mRTXDIOptions = value;
+        else if (key == kUseAnalyticLightBVH) mStaticParams.useAnalyticLightBVH = value;
+        else if (key == kAnalyticLightBVHOptions) mAnalyticLightBVHOptions = value;
 
         // Material parameters
         else if (key == kUseAlphaTest) mStaticParams.useAlphaTest = value;
@@ -333,6 +339,10 @@ Properties PathTracer::getProperties() const
     {
         mLightBVHOptions = lightBVHSampler->getOptions();
     }
+    if (mpAnalyticLightSampler)
+    {
+        mAnalyticLightBVHOptions = mpAnalyticLightSampler->getOptions();
+    }
 
     Properties props;
 
@@ -356,6 +366,8 @@ Properties PathTracer::getProperties() const
     if (mStaticParams.emissiveSampler == EmissiveLightSamplerType::LightBVH) props[kLightBVHOptions] = mLightBVHOptions;
     props[kUseRTXDI] = mStaticParams.useRTXDI;
     props[kRTXDIOptions] = mRTXDIOptions;
+    props[kUseAnalyticLightBVH] = mStaticParams.useAnalyticLightBVH;
+    if (mStaticParams.useAnalyticLightBVH) props[kAnalyticLightBVHOptions] = mAnalyticLightBVHOptions;
 
     // Material parameters
     props[kUseAlphaTest] = mStaticParams.useAlphaTest;
@@ -537,6 +549,7 @@ bool PathTracer::renderRenderingUI(Gui::Widgets& widget)
         mpSampleGenerator = SampleGenerator::create(mpDevice, mStaticParams.sampleGenerator);
         dirty = true;
     }
+    mpSampleGenerator->renderUI(widget);
 
     dirty |= widget.checkbox("BSDF importance sampling", mStaticParams.useBSDFSampling);
     widget.tooltip("BSDF importance sampling should normally be enabled.\n\n"
@@ -581,6 +594,24 @@ bool PathTracer::renderRenderingUI(Gui::Widgets& widget)
                 }
             }
         }
+
+        if (mpScene && mpScene->useAnalyticLights())
+        {
+            if (auto group = widget.group("Analytic light sampler"))
+            {
+                if (widget.checkbox("Use light BVH", mStaticParams.useAnalyticLightBVH))
+                {
+                    resetLighting();
+                    dirty = true;
+                }
+                widget.tooltip("Select analytic lights based on their estimated contribution using a light BVH.\nOtherwise the lights are selected uniformly.", true);
+
+                if (mpAnalyticLightSampler)
+                {
+                    if (mpAnalyticLightSampler->renderUI(group)) mOptionsChanged = true;
+                }
+            }
+        }
     }
 
     if (auto group = widget.group("RTXDI"))
@@ -921,7 +952,13 @@ void PathTracer::resetLighting()
         mLightBVHOptions = lightBVHSampler->getOptions();
     }
 
+    if (mpAnalyticLightSampler)
+    {
+        mAnalyticLightBVHOptions = mpAnalyticLightSampler->getOptions();
+    }
+
     mpEmissiveSampler = nullptr;
+    mpAnalyticLightSampler = nullptr;
     mpEnvMapSampler = nullptr;
     mRecompile = true;
 }
@@ -1035,6 +1072,32 @@ bool PathTracer::prepareLighting(RenderContext* pRenderContext)
         if (mpTracePass && mpTracePass->pProgram->addDefines(defines)) mRecompile = true;
     }
 
+    if (mpScene->useAnalyticLights() && mStaticParams.useAnalyticLightBVH)
+    {
+        if (!mpAnalyticLightSampler)
+        {
+            mpAnalyticLightSampler = std::make_unique<AnalyticLightBVHSampler>(mpScene, mAnalyticLightBVHOptions);
+            lightingChanged = true;
+            mRecompile = true;
+        }
+    }
+    else
+    {
+        if (mpAnalyticLightSampler)
+        {
+            // Retain the options for the analytic light sampler.
+            mAnalyticLightBVHOptions = mpAnalyticLightSampler->getOptions();
+            mpAnalyticLightSampler = nullptr;
+            lightingChanged = true;
+            mRecompile = true;
+        }
+    }
+
+    if (mpAnalyticLightSampler)
+    {
+        lightingChanged |= mpAnalyticLightSampler->update(pRenderContext);
+    }
+
     return lightingChanged;
 }
 
@@ -1118,6 +1181,11 @@ void PathTracer::bindShaderData(const ShaderVar& var, const RenderData& renderDa
         // TODO: Do we have to bind this every frame?
         mpEmissiveSampler->bindShaderData(var["emissiveSampler"]);
     }
+
+    if (useLightSampling && mpAnalyticLightSampler)
+    {
+        mpAnalyticLightSampler->bindShaderData(var["analyticLightSampler"]);
+    }
 }
 
 bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& renderData)
@@ -1174,6 +1242,13 @@ bool PathTracer::beginFrame(RenderContext* pRenderContext, const RenderData& ren
     prepareRTXDI(pRenderContext);
     if (mpRTXDI) mpRTXDI->beginFrame(pRenderContext, mParams.frameDim);
 
+    // Rebind the sample generator if its settings have changed.
+    if (mpSampleGenerator->beginFrame(pRenderContext, mParams.frameDim))
+    {
+        mVarsChanged = true;
+        mOptionsChanged = true;
+    }
+
     // Update refresh flag if changes that affect the output have occured.
     auto& dict = renderData.getDictionary();
     if (mOptionsChanged || lightingChanged)
@@ -1424,6 +1499,7 @@ DefineList PathTracer::StaticParams::getDefines(const PathTracer& owner) const
     if (scene) defines.add(scene->getSceneDefines());
     defines.add("USE_ENV_LIGHT", scene && scene->useEnvLight() ? "1" : "0");
     defines.add("USE_ANALYTIC_LIGHTS", scene && scene->useAnalyticLights() ? "1" : "0");
+    defines.add("USE_ANALYTIC_LIGHT_BVH", owner.mpAnalyticLightSampler ? "1" : "0");
     defines.add("USE_EMISSIVE_LIGHTS", scene && scene->useEmissiveLights() ? "1" : "0");
     defines.add("USE_CURVES", scene && (scene->hasGeometryType(Scene::GeometryType::Curve)) ? "1" : "0");
     defines.add("USE_SDF_GRIDS", scene && scene->hasGeometryType(Scene::GeometryType::SDFGrid) ? "1" : "0");
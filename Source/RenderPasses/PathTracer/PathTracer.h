@@ -31,6 +31,7 @@
 #include "RenderGraph/RenderPassHelpers.h"
 #include "Utils/Debug/PixelDebug.h"
 #include "Utils/Sampling/SampleGenerator.h"
+#include "Rendering/Lights/AnalyticLightBVHSampler.h"
 #include "Rendering/Lights/LightBVHSampler.h"
 #include "Rendering/Lights/EmissivePowerSampler.h"
 #include "Rendering/Lights/EnvMapSampler.h"
@@ -124,6 +125,7 @@ private:
         float       misPowerExponent = 2.f;                     ///< MIS exponent for the power heuristic. This is only used when 'PowerExp' is chosen.
         EmissiveLightSamplerType emissiveSampler = EmissiveLightSamplerType::LightBVH;  ///< Emissive light sampler to use for NEE.
         bool        useRTXDI = false;                           ///< Use RTXDI for direct illumination.
+        bool        useAnalyticLightBVH = true;                 ///< Use a light BVH to select analytic lights for NEE, otherwise select them uniformly.
 
         // Material parameters
         bool        useAlphaTest = true;                        ///< Use alpha testing on non-opaque triangles.
@@ -149,6 +151,7 @@ private:
     PathTracerParams                mParams;                    ///< Runtime path tracer parameters.
     StaticParams                    mStaticParams;              ///< Static parameters. These are set as compile-time constants in the shaders.
     mutable LightBVHSampler::Options mLightBVHOptions;          ///< Current options for the light BVH sampler.
+    mutable AnalyticLightBVHSampler::Options mAnalyticLightBVHOptions; ///< Current options for the analytic light BVH sampler.
     RTXDI::Options                  mRTXDIOptions;              ///< Current options for the RTXDI sampler.
 
     bool                            mEnabled = true;            ///< Switch to enable/disable the path tracer. When disabled the pass outputs are cleared.
@@ -162,6 +165,7 @@ private:
     ref<SampleGenerator>            mpSampleGenerator;          ///< GPU pseudo-random sample generator.
     std::unique_ptr<EnvMapSampler>  mpEnvMapSampler;            ///< Environment map sampler or nullptr if not used.
     std::unique_ptr<EmissiveLightSampler> mpEmissiveSampler;    ///< Emissive light sampler or nullptr if not used.
+    std::unique_ptr<AnalyticLightBVHSampler> mpAnalyticLightSampler; ///< Analytic light sampler or nullptr if not used.
     std::unique_ptr<RTXDI>          mpRTXDI;                    ///< RTXDI sampler for direct illumination or nullptr if not used.
     std::unique_ptr<PixelStats>     mpPixelStats;               ///< Utility class for collecting pixel stats.
     std::unique_ptr<PixelDebug>     mpPixelDebug;               ///< Utility class for pixel debugging (print in shaders).
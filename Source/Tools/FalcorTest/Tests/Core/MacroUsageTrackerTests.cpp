@@ -0,0 +1,124 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "Core/Program/MacroUsageTracker.h"
+
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+void writeFile(const std::filesystem::path& path, const std::string& content)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+} // namespace
+
+CPU_TEST(MacroUsageTracker_Scan)
+{
+    const std::string source = R"(
+#include "Utils/Math/MathConstants.slangh"
+#if defined(USE_FOO) && BAR_COUNT > 2
+static const uint kValue = VALUE_MACRO;
+#endif
+// COMMENTED_OUT in a line comment
+/* BLOCK_COMMENT
+   spanning lines */
+float f = 1.5e3f + 0x1Fu; // HEX
+static const char* str = "STRING_LITERAL \" STILL_STRING";
+int c = '\'';
+#ifdef AFTER_LITERALS
+)";
+
+    MacroUsageTracker::IdentifierSet identifiers;
+    MacroUsageTracker::scanIdentifiers(source, identifiers);
+
+    for (const char* name : {"include", "USE_FOO", "BAR_COUNT", "kValue", "VALUE_MACRO", "f", "str", "AFTER_LITERALS"})
+        EXPECT_EQ(identifiers.count(name), 1) << name;
+    for (const char* name : {"Utils", "COMMENTED_OUT", "BLOCK_COMMENT", "spanning", "e3f", "x1Fu", "HEX", "STRING_LITERAL", "STILL_STRING"})
+        EXPECT_EQ(identifiers.count(name), 0) << name;
+
+    EXPECT_TRUE(MacroUsageTracker::isAnyMacroUsed(source, {"UNUSED", "USE_FOO"}));
+    EXPECT_FALSE(MacroUsageTracker::isAnyMacroUsed(source, {"UNUSED", "USE"}));
+    EXPECT_FALSE(MacroUsageTracker::isAnyMacroUsed(source, {}));
+}
+
+CPU_TEST(MacroUsageTracker_ChangedMacros)
+{
+    DefineList before = {{"A", "1"}, {"B", "0"}, {"ALIAS_A", "A"}, {"C", ""}};
+
+    EXPECT(MacroUsageTracker::getChangedMacros(before, before).empty());
+
+    // Adding a define with the same value does not change anything.
+    DefineList after = before;
+    after.add("B", "0");
+    EXPECT(MacroUsageTracker::getChangedMacros(before, after).empty());
+
+    after = before;
+    after.add("B", "1");
+    EXPECT(MacroUsageTracker::getChangedMacros(before, after) == std::set<std::string>({"B"}));
+
+    after = before;
+    after.add("D", "1");
+    after.remove("C");
+    EXPECT(MacroUsageTracker::getChangedMacros(before, after) == std::set<std::string>({"C", "D"}));
+
+    // Defines referencing a changed define are changed as well.
+    after = before;
+    after.add("A", "2");
+    EXPECT(MacroUsageTracker::getChangedMacros(before, after) == std::set<std::string>({"A", "ALIAS_A"}));
+
+    after.add("ALIAS_ALIAS", "ALIAS_A + 1");
+    EXPECT(MacroUsageTracker::getChangedMacros(before, after) == std::set<std::string>({"A", "ALIAS_A", "ALIAS_ALIAS"}));
+}
+
+CPU_TEST(MacroUsageTracker_Files)
+{
+    const std::filesystem::path path = getTempFilePath();
+    writeFile(path, "#if USE_FOO\n#endif\n");
+
+    MacroUsageTracker tracker;
+    EXPECT_TRUE(tracker.isAnyMacroUsedInFile(path, {"USE_FOO"}));
+    EXPECT_FALSE(tracker.isAnyMacroUsedInFile(path, {"USE_BAR"}));
+    EXPECT_EQ(tracker.getCachedFileCount(), 1);
+
+    // Modified files are rescanned.
+    writeFile(path, "#if USE_BAR\n#endif\n");
+    std::filesystem::last_write_time(path, std::filesystem::last_write_time(path) + std::chrono::seconds(1));
+    EXPECT_TRUE(tracker.isAnyMacroUsedInFile(path, {"USE_BAR"}));
+    EXPECT_FALSE(tracker.isAnyMacroUsedInFile(path, {"USE_FOO"}));
+    EXPECT_EQ(tracker.getCachedFileCount(), 1);
+
+    // Missing files are conservatively assumed to use all macros.
+    std::filesystem::remove(path);
+    EXPECT_TRUE(tracker.isAnyMacroUsedInFile(path, {"USE_FOO"}));
+}
+} // namespace Falcor
@@ -0,0 +1,246 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/State/StateObjectCache.h"
+#include "Core/API/GraphicsStateObject.h"
+#include <atomic>
+#include <future>
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+struct SyntheticDesc
+{
+    uint32_t programId = 0;
+    uint32_t fboId = 0;
+
+    bool operator==(const SyntheticDesc& other) const { return programId == other.programId && fboId == other.fboId; }
+};
+
+struct SyntheticDescHash
+{
+    size_t operator()(const SyntheticDesc& desc) const { return std::hash<uint64_t>()((uint64_t(desc.programId) << 32) | desc.fboId); }
+};
+
+/// Synthetic state object recording which desc it was created from.
+struct SyntheticStateObject
+{
+    SyntheticDesc desc;
+};
+
+using SyntheticCache = StateObjectCache<SyntheticDesc, std::shared_ptr<SyntheticStateObject>, SyntheticDescHash>;
+
+SyntheticCache::CreateFunc countingCreateFunc(std::atomic<uint32_t>& createCount)
+{
+    return [&createCount](const SyntheticDesc& desc)
+    {
+        createCount++;
+        return std::make_shared<SyntheticStateObject>(SyntheticStateObject{desc});
+    };
+}
+
+std::shared_ptr<SyntheticStateObject> failingCreateFunc(const SyntheticDesc&)
+{
+    throw std::runtime_error("Unexpected state object creation");
+}
+} // namespace
+
+CPU_TEST(StateObjectCache_GetOrCreate)
+{
+    SyntheticCache cache;
+    std::atomic<uint32_t> createCount{0};
+    auto createFunc = countingCreateFunc(createCount);
+
+    EXPECT(cache.find(SyntheticDesc{1, 1}) == nullptr);
+
+    // Each combination is created once and returned from the index afterwards.
+    for (uint32_t pass = 0; pass < 3; pass++)
+    {
+        for (uint32_t program = 0; program < 8; program++)
+        {
+            for (uint32_t fbo = 0; fbo < 4; fbo++)
+            {
+                SyntheticDesc desc{program, fbo};
+                auto pObject = cache.getOrCreate(desc, createFunc);
+                ASSERT(pObject != nullptr);
+                EXPECT(pObject->desc == desc);
+                EXPECT(cache.find(desc) == pObject);
+            }
+        }
+    }
+
+    EXPECT_EQ(createCount.load(), 32u);
+    EXPECT_EQ(cache.size(), 32u);
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.misses, 32u);
+    EXPECT_EQ(stats.hits, 3u * 32u + 64u);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0u);
+    EXPECT(cache.find(SyntheticDesc{1, 1}) == nullptr);
+}
+
+CPU_TEST(StateObjectCache_Prewarm)
+{
+    SyntheticCache cache(4);
+    std::atomic<uint32_t> createCount{0};
+    auto createFunc = countingCreateFunc(createCount);
+
+    for (uint32_t program = 0; program < 16; program++)
+        EXPECT(cache.prewarm(SyntheticDesc{program, 0}, createFunc));
+
+    // Enqueuing a known combination again is a no-op.
+    EXPECT(!cache.prewarm(SyntheticDesc{3, 0}, createFunc));
+
+    cache.waitForPrewarming();
+    EXPECT_EQ(cache.getPendingCount(), 0u);
+    EXPECT_EQ(createCount.load(), 16u);
+
+    // Prewarmed state objects are found without creating them on the calling thread.
+    for (uint32_t program = 0; program < 16; program++)
+    {
+        SyntheticDesc desc{program, 0};
+        auto pObject = cache.getOrCreate(desc, failingCreateFunc);
+        ASSERT(pObject != nullptr);
+        EXPECT(pObject->desc == desc);
+    }
+
+    auto stats = cache.getStats();
+    EXPECT_EQ(stats.prewarmed, 16u);
+    EXPECT_EQ(stats.misses, 0u);
+    EXPECT_EQ(stats.hits, 16u);
+    EXPECT(!cache.prewarm(SyntheticDesc{3, 0}, createFunc));
+}
+
+CPU_TEST(StateObjectCache_WaitForPending)
+{
+    SyntheticCache cache;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    std::atomic<uint32_t> createCount{0};
+
+    const SyntheticDesc desc{7, 3};
+    cache.prewarm(
+        desc,
+        [&](const SyntheticDesc& d)
+        {
+            released.wait();
+            createCount++;
+            return std::make_shared<SyntheticStateObject>(SyntheticStateObject{d});
+        }
+    );
+    EXPECT(cache.contains(desc));
+
+    // A lookup of a pending desc waits for the worker instead of creating a duplicate.
+    std::shared_ptr<SyntheticStateObject> pObject;
+    std::thread lookup([&]() { pObject = cache.getOrCreate(desc, failingCreateFunc); });
+    release.set_value();
+    lookup.join();
+
+    ASSERT(pObject != nullptr);
+    EXPECT(pObject->desc == desc);
+    EXPECT_EQ(createCount.load(), 1u);
+    EXPECT(cache.find(desc) == pObject);
+}
+
+CPU_TEST(StateObjectCache_FailedPrewarm)
+{
+    SyntheticCache cache;
+    const SyntheticDesc desc{1, 2};
+
+    EXPECT(cache.prewarm(desc, failingCreateFunc));
+    cache.waitForPrewarming();
+
+    // Failed creations are not cached, the object is created on the calling thread instead.
+    EXPECT(!cache.contains(desc));
+    EXPECT_EQ(cache.getStats().failedPrewarms, 1u);
+
+    std::atomic<uint32_t> createCount{0};
+    auto pObject = cache.getOrCreate(desc, countingCreateFunc(createCount));
+    ASSERT(pObject != nullptr);
+    EXPECT_EQ(createCount.load(), 1u);
+
+    // Errors on the calling thread are passed on to the caller.
+    const SyntheticDesc otherDesc{2, 2};
+    EXPECT_THROW(cache.getOrCreate(otherDesc, failingCreateFunc));
+    EXPECT(!cache.contains(otherDesc));
+}
+
+CPU_TEST(StateObjectCache_GraphicsStateObjectDesc)
+{
+    // Synthetic graphics state object descs built without a device.
+    std::vector<ref<BlendState>> blendStates = {BlendState::create(BlendState::Desc()), BlendState::create(BlendState::Desc())};
+    std::vector<ResourceFormat> formats = {ResourceFormat::RGBA8Unorm, ResourceFormat::RGBA16Float, ResourceFormat::RG32Float};
+
+    std::vector<GraphicsStateObjectDesc> descs;
+    for (const auto& pBlendState : blendStates)
+    {
+        for (auto format : formats)
+        {
+            for (uint32_t sampleCount : {1u, 4u})
+            {
+                for (auto primitiveType : {GraphicsStateObjectDesc::PrimitiveType::Triangle, GraphicsStateObjectDesc::PrimitiveType::Line})
+                {
+                    GraphicsStateObjectDesc desc;
+                    desc.fboDesc.setColorTarget(0, format).setDepthStencilTarget(ResourceFormat::D32Float).setSampleCount(sampleCount);
+                    desc.pBlendState = pBlendState;
+                    desc.primitiveType = primitiveType;
+                    descs.push_back(desc);
+                }
+            }
+        }
+    }
+
+    // Equal descs hash equal and distinct descs are well distributed.
+    GraphicsStateObjectDesc::Hash hash;
+    std::set<size_t> hashes;
+    for (const auto& desc : descs)
+    {
+        GraphicsStateObjectDesc copy = desc;
+        EXPECT_EQ(hash(desc), hash(copy));
+        hashes.insert(hash(desc));
+    }
+    EXPECT_EQ(hashes.size(), descs.size());
+
+    // Look up through the cache with a synthetic state object type.
+    StateObjectCache<GraphicsStateObjectDesc, std::shared_ptr<size_t>, GraphicsStateObjectDesc::Hash> cache;
+    for (size_t i = 0; i < descs.size(); i++)
+        cache.getOrCreate(descs[i], [i](const GraphicsStateObjectDesc&) { return std::make_shared<size_t>(i); });
+    for (size_t i = 0; i < descs.size(); i++)
+    {
+        auto pIndex = cache.find(descs[i]);
+        ASSERT(pIndex != nullptr);
+        EXPECT_EQ(*pIndex, i);
+    }
+}
+} // namespace Falcor
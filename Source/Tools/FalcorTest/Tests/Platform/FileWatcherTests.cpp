@@ -0,0 +1,167 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Core/Platform/OS.h"
+#include "Core/Platform/FileWatcher.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+const std::chrono::milliseconds kTimeout(2000);
+
+struct TempDirectory
+{
+    std::filesystem::path path;
+
+    TempDirectory() : path(getTempFilePath()) { std::filesystem::create_directories(path); }
+    ~TempDirectory() { std::filesystem::remove_all(path); }
+};
+
+void writeFile(const std::filesystem::path& path, const std::string& content)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+bool contains(const std::vector<std::filesystem::path>& paths, const std::filesystem::path& path)
+{
+    return std::find(paths.begin(), paths.end(), FileWatcher::normalizePath(path)) != paths.end();
+}
+} // namespace
+
+CPU_TEST(FileWatcher_Write)
+{
+    if (!FileWatcher::isSupported())
+        return;
+
+    TempDirectory dir;
+    const auto a = dir.path / "a.slang";
+    const auto b = dir.path / "b.slang";
+    writeFile(a, "a");
+    writeFile(b, "b");
+
+    FileWatcher watcher;
+    EXPECT_TRUE(watcher.addFile(a));
+    EXPECT_TRUE(watcher.addFile(b));
+    EXPECT_TRUE(watcher.isWatching(a));
+    EXPECT_EQ(watcher.getWatchedFileCount(), 2);
+    EXPECT_FALSE(watcher.waitForChanges(std::chrono::milliseconds(50)));
+
+    writeFile(a, "a2");
+    ASSERT_TRUE(watcher.waitForChanges(kTimeout));
+    auto changed = watcher.takeChangedFiles();
+    EXPECT_EQ(changed.size(), 1);
+    EXPECT_TRUE(contains(changed, a));
+    EXPECT_TRUE(watcher.takeChangedFiles().empty());
+
+    // Files that are not watched are not reported.
+    writeFile(dir.path / "c.slang", "c");
+    writeFile(b, "b2");
+    ASSERT_TRUE(watcher.waitForChanges(kTimeout));
+    changed = watcher.takeChangedFiles();
+    EXPECT_EQ(changed.size(), 1);
+    EXPECT_TRUE(contains(changed, b));
+
+    // Removed files are no longer reported.
+    watcher.removeFile(b);
+    EXPECT_FALSE(watcher.isWatching(b));
+    writeFile(b, "b3");
+    writeFile(a, "a3");
+    ASSERT_TRUE(watcher.waitForChanges(kTimeout));
+    changed = watcher.takeChangedFiles();
+    EXPECT_FALSE(contains(changed, b));
+    EXPECT_TRUE(contains(changed, a));
+}
+
+CPU_TEST(FileWatcher_Replace)
+{
+    if (!FileWatcher::isSupported())
+        return;
+
+    TempDirectory dir;
+    const auto a = dir.path / "a.slang";
+    writeFile(a, "a");
+
+    FileWatcher watcher;
+    EXPECT_TRUE(watcher.addFile(dir.path / "." / "a.slang"));
+    EXPECT_TRUE(watcher.isWatching(a));
+
+    // Editors often save by writing a temporary file and renaming it.
+    const auto tmp = dir.path / "a.slang.tmp";
+    writeFile(tmp, "a2");
+    std::filesystem::rename(tmp, a);
+    ASSERT_TRUE(watcher.waitForChanges(kTimeout));
+    EXPECT_TRUE(contains(watcher.takeChangedFiles(), a));
+
+    // The watch survives the replacement.
+    writeFile(a, "a3");
+    ASSERT_TRUE(watcher.waitForChanges(kTimeout));
+    EXPECT_TRUE(contains(watcher.takeChangedFiles(), a));
+
+    std::filesystem::remove(a);
+    ASSERT_TRUE(watcher.waitForChanges(kTimeout));
+    EXPECT_TRUE(contains(watcher.takeChangedFiles(), a));
+}
+
+CPU_TEST(FileWatcher_Callback)
+{
+    if (!FileWatcher::isSupported())
+        return;
+
+    TempDirectory dir;
+    const auto a = dir.path / "a.txt";
+    writeFile(a, "a");
+
+    std::atomic<uint32_t> callCount{0};
+    FileWatcher watcher;
+    EXPECT_TRUE(watcher.addFile(a, [&](const std::filesystem::path& path) { callCount += path == FileWatcher::normalizePath(a) ? 1 : 100; }));
+
+    writeFile(a, "a2");
+    ASSERT_TRUE(watcher.waitForChanges(kTimeout));
+    for (uint32_t i = 0; i < 100 && callCount == 0; i++)
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    EXPECT_EQ(callCount.load(), 1);
+}
+
+CPU_TEST(FileWatcher_MissingDirectory)
+{
+    if (!FileWatcher::isSupported())
+        return;
+
+    FileWatcher watcher;
+    EXPECT_FALSE(watcher.addFile(getTempFilePath() / "missing" / "a.slang"));
+    EXPECT_EQ(watcher.getWatchedFileCount(), 0);
+}
+} // namespace Falcor
@@ -0,0 +1,367 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "RenderGraph/RenderGraphScheduler.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+using Scheduler = RenderGraphScheduler;
+using Queue = Scheduler::Queue;
+using State = Resource::State;
+
+Scheduler::PassDesc pass(const std::string& name, Queue queue, float cost)
+{
+    return {name, {queue, cost}};
+}
+
+Scheduler::EdgeDesc edge(
+    uint32_t src,
+    uint32_t dst,
+    const std::string& resource = "",
+    State srcState = State::Common,
+    State dstState = State::Common
+)
+{
+    return {src, dst, resource, srcState, dstState};
+}
+
+/// Returns true if pass 'after' is guaranteed to execute after pass 'before' has finished, considering queue order and waits.
+bool isOrdered(const Scheduler::Schedule& schedule, uint32_t before, uint32_t after)
+{
+    // Propagate fence knowledge through the schedule (in submission order) as vector clocks.
+    std::vector<std::array<uint64_t, Scheduler::kQueueCount>> clocks(schedule.passes.size());
+    std::array<std::array<uint64_t, Scheduler::kQueueCount>, Scheduler::kQueueCount> queueClock = {};
+    for (size_t i = 0; i < schedule.passes.size(); i++)
+    {
+        const auto& p = schedule.passes[i];
+        auto& clock = queueClock[(uint32_t)p.queue];
+        for (uint32_t w : p.waits)
+        {
+            const auto& sync = schedule.syncPoints[w];
+            const auto& signal = schedule.getPass(sync.signalPass);
+            if (!signal.signal || signal.fenceValue != sync.fenceValue)
+                return false;
+            const auto& signalClock = clocks[schedule.passToScheduled[sync.signalPass]];
+            for (uint32_t q = 0; q < Scheduler::kQueueCount; q++)
+                clock[q] = std::max(clock[q], signalClock[q]);
+        }
+        // Passes earlier on the same queue are only known to be finished once the next pass starts.
+        clocks[i] = clock;
+        clock[(uint32_t)p.queue] = p.fenceValue;
+        clocks[i][(uint32_t)p.queue] = p.fenceValue;
+    }
+
+    const auto& b = schedule.getPass(before);
+    const auto& a = schedule.getPass(after);
+    if (b.queue == a.queue)
+        return b.fenceValue < a.fenceValue;
+    // The clock of 'after' excluding its own queue position reflects the waits issued before it.
+    return clocks[schedule.passToScheduled[after]][(uint32_t)b.queue] >= b.fenceValue;
+}
+
+void validateSchedule(
+    CPUUnitTestContext& ctx,
+    const std::vector<Scheduler::PassDesc>& passes,
+    const std::vector<Scheduler::EdgeDesc>& edges,
+    const Scheduler::Schedule& schedule
+)
+{
+    ASSERT_EQ(schedule.passes.size(), passes.size());
+
+    for (uint32_t i = 0; i < passes.size(); i++)
+    {
+        const auto& p = schedule.getPass(i);
+        EXPECT_EQ(p.pass, i);
+        EXPECT(Scheduler::canRunOn(passes[i].hints.queue, p.queue));
+        EXPECT_GE(p.finish - p.start, passes[i].hints.cost - 1e-5f);
+    }
+
+    for (const auto& e : edges)
+    {
+        // Submission order is topological and every dependency is synchronized.
+        EXPECT_LT(schedule.passToScheduled[e.srcPass], schedule.passToScheduled[e.dstPass]);
+        EXPECT(isOrdered(schedule, e.srcPass, e.dstPass)) << passes[e.srcPass].name << " -> " << passes[e.dstPass].name;
+        EXPECT_LE(schedule.getPass(e.srcPass).finish, schedule.getPass(e.dstPass).start + 1e-5f);
+    }
+
+    // Every wait references an earlier pass on another queue.
+    for (const auto& sync : schedule.syncPoints)
+    {
+        EXPECT(sync.signalQueue != sync.waitQueue);
+        EXPECT_LT(schedule.passToScheduled[sync.signalPass], schedule.passToScheduled[sync.waitPass]);
+    }
+
+    EXPECT_GE(schedule.makespan, schedule.criticalPath - 1e-5f);
+}
+} // namespace
+
+CPU_TEST(RenderGraphScheduler_Chain)
+{
+    std::vector<Scheduler::PassDesc> passes = {
+        pass("GBuffer", Queue::Graphics, 2.f),
+        pass("Lighting", Queue::Graphics, 3.f),
+        pass("ToneMap", Queue::Graphics, 1.f),
+    };
+    std::vector<Scheduler::EdgeDesc> edges = {
+        edge(0, 1, "GBuffer.normals", State::RenderTarget, State::ShaderResource),
+        edge(1, 2, "Lighting.color", State::UnorderedAccess, State::ShaderResource),
+    };
+
+    auto schedule = Scheduler::plan(passes, edges);
+    validateSchedule(ctx, passes, edges, schedule);
+
+    EXPECT_EQ(schedule.queues[(uint32_t)Queue::Graphics].size(), 3);
+    EXPECT(schedule.syncPoints.empty());
+    EXPECT_EQ(schedule.criticalPath, 6.f);
+    EXPECT_EQ(schedule.makespan, 6.f);
+
+    // Transitions are issued right before the consumer.
+    const auto& lighting = schedule.getPass(1);
+    ASSERT_EQ(lighting.preTransitions.size(), 1);
+    EXPECT_EQ(lighting.preTransitions[0].resource, "GBuffer.normals");
+    EXPECT(lighting.preTransitions[0].before == State::RenderTarget);
+    EXPECT(lighting.preTransitions[0].after == State::ShaderResource);
+    EXPECT(schedule.getPass(0).postTransitions.empty());
+}
+
+CPU_TEST(RenderGraphScheduler_AsyncCompute)
+{
+    // Shadow and denoiser branches are independent until they are composited.
+    std::vector<Scheduler::PassDesc> passes = {
+        pass("GBuffer", Queue::Graphics, 2.f),
+        pass("Shadows", Queue::Graphics, 4.f),
+        pass("Denoiser", Queue::Compute, 3.f),
+        pass("Composite", Queue::Graphics, 1.f),
+    };
+    std::vector<Scheduler::EdgeDesc> edges = {
+        edge(0, 1, "GBuffer.depth", State::DepthStencil, State::ShaderResource),
+        edge(0, 2, "GBuffer.normals", State::RenderTarget, State::ShaderResource),
+        edge(1, 3, "Shadows.mask", State::RenderTarget, State::ShaderResource),
+        edge(2, 3, "Denoiser.color", State::UnorderedAccess, State::ShaderResource),
+    };
+
+    auto schedule = Scheduler::plan(passes, edges);
+    validateSchedule(ctx, passes, edges, schedule);
+
+    EXPECT(schedule.getPass(2).queue == Queue::Compute);
+    EXPECT_EQ(schedule.criticalPath, 7.f);
+    EXPECT_EQ(schedule.makespan, 7.f);
+
+    // The denoiser waits for the G-buffer and the composite waits for the denoiser.
+    ASSERT_EQ(schedule.syncPoints.size(), 2);
+    EXPECT(schedule.getPass(0).signal);
+    EXPECT(schedule.getPass(2).signal);
+    EXPECT_EQ(schedule.getPass(2).waits.size(), 1);
+    EXPECT_EQ(schedule.getPass(3).waits.size(), 1);
+
+    // Resources shared across queues are transitioned on the producing queue if it supports the target state.
+    const auto& gbuffer = schedule.getPass(0);
+    bool normalsTransitioned = false;
+    for (const auto& t : gbuffer.postTransitions)
+        normalsTransitioned |= t.resource == "GBuffer.normals" && t.after == State::ShaderResource;
+    EXPECT(normalsTransitioned);
+    const auto& denoiser = schedule.getPass(2);
+    ASSERT_EQ(denoiser.postTransitions.size(), 1);
+    EXPECT_EQ(denoiser.postTransitions[0].resource, "Denoiser.color");
+
+    // Without the compute queue everything is serialized on the graphics queue.
+    Scheduler::Options options;
+    options.enabledQueues[(uint32_t)Queue::Compute] = false;
+    auto serial = Scheduler::plan(passes, edges, options);
+    validateSchedule(ctx, passes, edges, serial);
+    EXPECT_EQ(serial.queues[(uint32_t)Queue::Graphics].size(), 4);
+    EXPECT(serial.syncPoints.empty());
+    EXPECT_EQ(serial.makespan, 10.f);
+}
+
+CPU_TEST(RenderGraphScheduler_SyncCost)
+{
+    // A short compute pass between two graphics passes isn't worth moving when synchronization is expensive.
+    std::vector<Scheduler::PassDesc> passes = {
+        pass("A", Queue::Graphics, 1.f),
+        pass("B", Queue::Compute, 1.f),
+        pass("C", Queue::Graphics, 1.f),
+    };
+    std::vector<Scheduler::EdgeDesc> edges = {edge(0, 1), edge(1, 2)};
+
+    Scheduler::Options options;
+    options.syncCost = 0.5f;
+    auto schedule = Scheduler::plan(passes, edges, options);
+    validateSchedule(ctx, passes, edges, schedule);
+    EXPECT(schedule.getPass(1).queue == Queue::Graphics);
+    EXPECT(schedule.syncPoints.empty());
+    EXPECT_EQ(schedule.makespan, 3.f);
+}
+
+CPU_TEST(RenderGraphScheduler_RedundantWaits)
+{
+    std::vector<Scheduler::PassDesc> passes = {
+        pass("Upload", Queue::Copy, 1.f),
+        pass("Simulate", Queue::Compute, 5.f),
+        pass("Draw0", Queue::Graphics, 2.f),
+        pass("Draw1", Queue::Graphics, 2.f),
+        pass("Long", Queue::Graphics, 4.f),
+    };
+    std::vector<Scheduler::EdgeDesc> edges = {
+        edge(0, 1, "Upload.data", State::CopyDest, State::UnorderedAccess),
+        edge(1, 2, "Simulate.particles", State::UnorderedAccess, State::ShaderResource),
+        edge(1, 3, "Simulate.particles", State::UnorderedAccess, State::ShaderResource),
+        edge(0, 3, "Upload.lut", State::CopyDest, State::CopySource),
+        edge(2, 3),
+    };
+
+    auto schedule = Scheduler::plan(passes, edges);
+    validateSchedule(ctx, passes, edges, schedule);
+
+    EXPECT(schedule.getPass(0).queue == Queue::Copy);
+    EXPECT(schedule.getPass(1).queue == Queue::Compute);
+
+    // Draw1 is ordered after Draw0, which already waited for the compute queue, which in turn waited for the copy queue.
+    EXPECT_EQ(schedule.getPass(2).waits.size(), 1);
+    EXPECT_EQ(schedule.getPass(3).waits.size(), 0);
+
+    // The particles are transitioned once on the compute queue for both draws.
+    EXPECT(schedule.getPass(2).preTransitions.empty());
+    EXPECT(schedule.getPass(3).preTransitions.empty());
+    ASSERT_EQ(schedule.getPass(1).postTransitions.size(), 1);
+    EXPECT_EQ(schedule.getPass(1).postTransitions[0].resource, "Simulate.particles");
+
+    // The copy queue can't transition to unordered access, so the compute queue does it before the simulation.
+    const auto& simulate = schedule.getPass(1);
+    ASSERT_EQ(simulate.preTransitions.size(), 1);
+    EXPECT(simulate.preTransitions[0].before == State::CopyDest);
+    EXPECT(simulate.preTransitions[0].after == State::UnorderedAccess);
+}
+
+CPU_TEST(RenderGraphScheduler_MixedStates)
+{
+    // A resource read in different states by passes that could otherwise run on the compute queue.
+    std::vector<Scheduler::PassDesc> passes = {
+        pass("Producer", Queue::Compute, 1.f),
+        pass("Reader", Queue::Compute, 1.f),
+        pass("Writer", Queue::Compute, 1.f),
+    };
+    std::vector<Scheduler::EdgeDesc> edges = {
+        edge(0, 1, "Producer.buffer", State::UnorderedAccess, State::ShaderResource),
+        edge(0, 2, "Producer.buffer", State::UnorderedAccess, State::UnorderedAccess),
+        edge(1, 2),
+    };
+
+    auto schedule = Scheduler::plan(passes, edges);
+    validateSchedule(ctx, passes, edges, schedule);
+
+    EXPECT(schedule.getPass(1).queue == Queue::Graphics);
+    EXPECT(schedule.getPass(2).queue == Queue::Graphics);
+
+    // The consumers transition the resource in execution order.
+    ASSERT_EQ(schedule.getPass(1).preTransitions.size(), 1);
+    EXPECT(schedule.getPass(1).preTransitions[0].before == State::UnorderedAccess);
+    EXPECT(schedule.getPass(1).preTransitions[0].after == State::ShaderResource);
+    ASSERT_EQ(schedule.getPass(2).preTransitions.size(), 1);
+    EXPECT(schedule.getPass(2).preTransitions[0].before == State::ShaderResource);
+    EXPECT(schedule.getPass(2).preTransitions[0].after == State::UnorderedAccess);
+}
+
+CPU_TEST(RenderGraphScheduler_SharedConsumerTransition)
+{
+    // A copy produces a texture that is sampled on both the graphics and compute queues.
+    // The copy queue can't transition to a shader resource, so the first consumer does it and the other waits for it.
+    std::vector<Scheduler::PassDesc> passes = {
+        pass("Copy", Queue::Copy, 1.f),
+        pass("Raster", Queue::Graphics, 2.f),
+        pass("Blur", Queue::Compute, 2.f),
+    };
+    std::vector<Scheduler::EdgeDesc> edges = {
+        edge(0, 1, "Copy.tex", State::CopyDest, State::ShaderResource),
+        edge(0, 2, "Copy.tex", State::CopyDest, State::ShaderResource),
+    };
+
+    auto schedule = Scheduler::plan(passes, edges);
+    validateSchedule(ctx, passes, edges, schedule);
+
+    uint32_t owner = schedule.passToScheduled[1] < schedule.passToScheduled[2] ? 1 : 2;
+    uint32_t other = owner == 1 ? 2 : 1;
+    EXPECT_EQ(schedule.getPass(owner).preTransitions.size(), 1);
+    EXPECT(schedule.getPass(other).preTransitions.empty());
+    if (schedule.getPass(owner).queue != schedule.getPass(other).queue)
+        EXPECT(isOrdered(schedule, owner, other));
+}
+
+CPU_TEST(RenderGraphScheduler_Cycle)
+{
+    std::vector<Scheduler::PassDesc> passes = {pass("A", Queue::Graphics, 1.f), pass("B", Queue::Graphics, 1.f)};
+    std::vector<Scheduler::EdgeDesc> cycle = {edge(0, 1), edge(1, 0)};
+    EXPECT_THROW(Scheduler::plan(passes, cycle));
+    std::vector<Scheduler::EdgeDesc> invalid = {edge(0, 2)};
+    EXPECT_THROW(Scheduler::plan(passes, invalid));
+}
+
+CPU_TEST(RenderGraphScheduler_Random)
+{
+    std::mt19937 rng(1234);
+    const Queue kQueues[] = {Queue::Graphics, Queue::Compute, Queue::Copy};
+    const State kStates[] = {State::ShaderResource, State::UnorderedAccess, State::RenderTarget, State::CopySource, State::CopyDest};
+
+    for (uint32_t iter = 0; iter < 50; iter++)
+    {
+        const uint32_t passCount = 2 + rng() % 30;
+        std::vector<Scheduler::PassDesc> passes;
+        for (uint32_t i = 0; i < passCount; i++)
+            passes.push_back(pass("Pass" + std::to_string(i), kQueues[rng() % 3], float(rng() % 8)));
+
+        // Edges only go from lower to higher indices, which guarantees an acyclic graph.
+        std::vector<Scheduler::EdgeDesc> edges;
+        for (uint32_t dst = 1; dst < passCount; dst++)
+        {
+            uint32_t inputCount = rng() % 4;
+            for (uint32_t i = 0; i < inputCount; i++)
+            {
+                uint32_t src = rng() % dst;
+                if (rng() % 4 == 0)
+                    edges.push_back(edge(src, dst));
+                else
+                    edges.push_back(edge(src, dst, passes[src].name + ".out", kStates[src % 5], kStates[rng() % 5]));
+            }
+        }
+
+        Scheduler::Options options;
+        options.syncCost = float(rng() % 2);
+        auto schedule = Scheduler::plan(passes, edges, options);
+        validateSchedule(ctx, passes, edges, schedule);
+
+        // The schedule never exceeds the serial execution time (plus synchronization overhead).
+        float serial = 0.f;
+        for (const auto& p : passes)
+            serial += p.hints.cost + options.syncCost;
+        EXPECT_LE(schedule.makespan, serial + 1e-5f);
+    }
+}
+} // namespace Falcor
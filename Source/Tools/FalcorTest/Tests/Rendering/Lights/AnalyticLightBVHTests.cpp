@@ -0,0 +1,420 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Lights/AnalyticLightBVH.h"
+#include "Rendering/Lights/LightBVHCostModel.h"
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+LightData createPointLight(float3 posW, float3 intensity)
+{
+    LightData light;
+    light.type = (uint32_t)LightType::Point;
+    light.posW = posW;
+    light.dirW = float3(0.f, 0.f, -1.f);
+    light.intensity = intensity;
+    return light;
+}
+
+LightData createSpotLight(float3 posW, float3 dirW, float openingAngle, float3 intensity)
+{
+    LightData light = createPointLight(posW, intensity);
+    light.dirW = normalize(dirW);
+    light.openingAngle = openingAngle;
+    light.cosOpeningAngle = std::cos(openingAngle);
+    return light;
+}
+
+LightData createAreaLight(LightType type, float4x4 transform, float surfaceArea, float3 intensity)
+{
+    LightData light;
+    light.type = (uint32_t)type;
+    light.intensity = intensity;
+    light.transMat = transform;
+    light.transMatIT = inverse(transpose(transform));
+    light.surfaceArea = surfaceArea;
+    return light;
+}
+
+LightData createDirectionalLight(float3 dirW, float3 intensity)
+{
+    LightData light;
+    light.type = (uint32_t)LightType::Directional;
+    light.dirW = normalize(dirW);
+    light.intensity = intensity;
+    return light;
+}
+
+/** Creates a mix of point, spot, area and directional lights.
+*/
+std::vector<LightData> createLights(uint32_t count, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    auto u = [&]() { return std::uniform_real_distribution<float>()(rng); };
+    auto randomPos = [&]() { return float3(u(), u(), u()) * 100.f - 50.f; };
+    auto randomDir = [&]() { return normalize(float3(u(), u(), u()) * 2.f - 1.f + float3(0.f, 0.f, 1e-3f)); };
+    auto randomIntensity = [&]() { return float3(u(), u(), u()) * 10.f + 0.1f; };
+
+    std::vector<LightData> lights;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        switch (i % 6)
+        {
+        case 0:
+            lights.push_back(createPointLight(randomPos(), randomIntensity()));
+            break;
+        case 1:
+        case 2:
+            lights.push_back(createSpotLight(randomPos(), randomDir(), 0.1f + u() * 1.5f, randomIntensity()));
+            break;
+        case 3:
+        {
+            float3 scale = float3(0.1f + u(), 0.1f + u(), 1.f);
+            float4x4 transform = mul(math::matrixFromTranslation(randomPos()), mul(math::matrixFromRotation(u() * 6.f, randomDir()), math::matrixFromScaling(scale)));
+            lights.push_back(createAreaLight(LightType::Rect, transform, 4.f * scale.x * scale.y, randomIntensity()));
+            break;
+        }
+        case 4:
+        {
+            float r = 0.1f + u();
+            float4x4 transform = mul(math::matrixFromTranslation(randomPos()), mul(math::matrixFromRotation(u() * 6.f, randomDir()), math::matrixFromScaling(float3(r, r, 1.f))));
+            lights.push_back(createAreaLight(LightType::Disc, transform, float(M_PI) * r * r, randomIntensity()));
+            break;
+        }
+        case 5:
+        {
+            float r = 0.1f + u();
+            float4x4 transform = mul(math::matrixFromTranslation(randomPos()), math::matrixFromScaling(float3(r)));
+            lights.push_back(createAreaLight(LightType::Sphere, transform, 4.f * float(M_PI) * r * r, randomIntensity()));
+            break;
+        }
+        }
+    }
+    return lights;
+}
+
+bool isInfiniteLight(const LightData& light)
+{
+    return light.type == (uint32_t)LightType::Directional || light.type == (uint32_t)LightType::Distant;
+}
+
+/** Returns true if the bounding box of the outer node contains the inner node, up to rounding of the origin and extent.
+*/
+bool contains(const AnalyticLightBVHNode& outer, const AnalyticLightBVHNode& inner)
+{
+    const float3 eps = (abs(outer.origin) + outer.extent) * 1e-6f;
+    return all(outer.origin - outer.extent - eps <= inner.origin - inner.extent) && all(outer.origin + outer.extent + eps >= inner.origin + inner.extent);
+}
+
+/** Returns the angle between two cones' axes plus the spread angle of the inner cone, i.e. the spread angle needed to contain it.
+*/
+float requiredConeAngle(const float3& outerDir, const float3& innerDir, float innerCosTheta)
+{
+    return std::acos(std::clamp(dot(outerDir, innerDir), -1.f, 1.f)) + std::acos(innerCosTheta);
+}
+
+/** Verifies the BVH structure and node bounds. Returns the number of leaves below the node.
+*/
+uint32_t verifySubtree(CPUUnitTestContext& ctx, const AnalyticLightBVH& bvh, const std::vector<LightData>& lights, uint32_t nodeIndex, uint32_t depth, uint64_t bitmask, std::vector<uint32_t>& leafCount)
+{
+    const auto& nodes = bvh.getNodes();
+    const AnalyticLightBVHNode& node = nodes[nodeIndex];
+    EXPECT_LE(depth, AnalyticLightBVH::kMaxDepth);
+
+    if (node.isLeaf())
+    {
+        uint32_t lightIndex = node.getLightIndex();
+        EXPECT_LT(lightIndex, lights.size());
+        leafCount[lightIndex]++;
+        EXPECT_EQ(bvh.getLightBitmask(lightIndex), bitmask);
+
+        AnalyticLightBVH::LightBounds lightBounds;
+        EXPECT(AnalyticLightBVH::computeLightBounds(lights[lightIndex], lightBounds));
+        EXPECT_EQ(node.intensity, lightBounds.intensity);
+        EXPECT_EQ(node.cosThetaO, lightBounds.cosThetaO);
+        EXPECT_EQ(node.cosThetaE, lightBounds.cosThetaE);
+        return 1;
+    }
+
+    uint32_t leftIndex = nodeIndex + 1;
+    uint32_t rightIndex = node.getRightChildIndex();
+    EXPECT_GT(rightIndex, leftIndex);
+    EXPECT_LT(rightIndex, nodes.size());
+
+    for (uint32_t childIndex : {leftIndex, rightIndex})
+    {
+        const AnalyticLightBVHNode& child = nodes[childIndex];
+        EXPECT(contains(node, child)) << "node " << nodeIndex << " child " << childIndex;
+        EXPECT_LE(node.cosThetaE, child.cosThetaE);
+        if (node.cosThetaO != kInvalidCosConeAngle)
+        {
+            EXPECT_NE(child.cosThetaO, kInvalidCosConeAngle);
+            EXPECT_LE(requiredConeAngle(node.coneDirection, child.coneDirection, child.cosThetaO), std::acos(node.cosThetaO) + 1e-4f);
+        }
+    }
+    float childIntensity = nodes[leftIndex].intensity + nodes[rightIndex].intensity;
+    EXPECT_LE(std::abs(node.intensity - childIntensity), 1e-6f * childIntensity);
+
+    uint32_t count = verifySubtree(ctx, bvh, lights, leftIndex, depth + 1, bitmask, leafCount);
+    EXPECT_EQ(rightIndex, leftIndex + 2 * count - 1);
+    count += verifySubtree(ctx, bvh, lights, rightIndex, depth + 1, bitmask | (1ull << depth), leafCount);
+    return count;
+}
+
+void verifyBVH(CPUUnitTestContext& ctx, const AnalyticLightBVH& bvh, const std::vector<LightData>& lights)
+{
+    uint32_t localLightCount = 0;
+    for (const auto& light : lights)
+    {
+        if (!isInfiniteLight(light)) localLightCount++;
+    }
+
+    EXPECT_EQ(bvh.getLightCount(), lights.size());
+    EXPECT_EQ(bvh.getLocalLightCount(), localLightCount);
+    EXPECT_EQ(bvh.getInfiniteLightCount(), lights.size() - localLightCount);
+    for (uint32_t lightIndex : bvh.getInfiniteLightIndices())
+    {
+        EXPECT(isInfiniteLight(lights[lightIndex]));
+        EXPECT_EQ(bvh.getLightBitmask(lightIndex), std::numeric_limits<uint64_t>::max());
+    }
+
+    if (localLightCount == 0)
+    {
+        EXPECT(bvh.getNodes().empty());
+        return;
+    }
+
+    EXPECT_EQ(bvh.getNodes().size(), 2 * localLightCount - 1);
+    std::vector<uint32_t> leafCount(lights.size(), 0);
+    EXPECT_EQ(verifySubtree(ctx, bvh, lights, 0, 0, 0, leafCount), localLightCount);
+    for (uint32_t i = 0; i < lights.size(); i++)
+    {
+        EXPECT_EQ(leafCount[i], isInfiniteLight(lights[i]) ? 0 : 1) << "light " << i;
+    }
+}
+
+/** Returns true if a point or spot light illuminates a shading point.
+*/
+bool isIlluminatedByPointLight(const LightData& light, const float3& posW, const float3& normalW, bool upperHemisphere)
+{
+    float3 dir = normalize(light.posW - posW);
+    if (upperHemisphere && dot(normalW, dir) <= 0.f) return false;
+    return -dot(dir, light.dirW) >= light.cosOpeningAngle;
+}
+
+/** Verifies that the selection probabilities are consistent with the sampling function.
+*/
+void verifyPdfs(CPUUnitTestContext& ctx, const AnalyticLightBVH& bvh, const std::vector<LightData>& lights, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    auto u = [&]() { return std::uniform_real_distribution<float>()(rng); };
+
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        float3 posW = float3(u(), u(), u()) * 120.f - 60.f;
+        float3 normalW = normalize(float3(u(), u(), u()) * 2.f - 1.f + float3(1e-3f, 0.f, 0.f));
+        bool upperHemisphere = (i % 2) == 0;
+
+        // The selection probabilities sum to at most one. Traversal stops at nodes where the importance of both children
+        // is zero, as none of their lights can illuminate the shading point. The missing probability is that of failing to sample.
+        std::vector<double> pdfs(lights.size());
+        double pdfSum = 0.0;
+        for (uint32_t lightIndex = 0; lightIndex < lights.size(); lightIndex++)
+        {
+            pdfs[lightIndex] = bvh.evalLightSelectionPdf(posW, normalW, upperHemisphere, lightIndex);
+            EXPECT_GE(pdfs[lightIndex], 0.0);
+            pdfSum += pdfs[lightIndex];
+
+            // Lights that illuminate the shading point must have a non-zero probability.
+            if (lights[lightIndex].type == (uint32_t)LightType::Point && isIlluminatedByPointLight(lights[lightIndex], posW, normalW, upperHemisphere))
+            {
+                EXPECT_GT(pdfs[lightIndex], 0.0) << "light " << lightIndex;
+            }
+        }
+        EXPECT_LE(pdfSum, 1.0 + 1e-4);
+
+        // Sample the lights with stratified random numbers. The returned pdfs should match the evaluated pdfs,
+        // and the relative sample frequencies should match the pdfs.
+        const uint32_t sampleCount = 100000;
+        std::vector<uint32_t> histogram(lights.size(), 0);
+        uint32_t validCount = 0;
+        for (uint32_t s = 0; s < sampleCount; s++)
+        {
+            uint32_t lightIndex;
+            float pdf;
+            if (!bvh.sampleLight(posW, normalW, upperHemisphere, (s + 0.5f) / sampleCount, lightIndex, pdf)) continue;
+            ASSERT_LT(lightIndex, lights.size());
+            EXPECT_LE(std::abs(pdf - pdfs[lightIndex]), 1e-5 * pdfs[lightIndex]) << "light " << lightIndex;
+            histogram[lightIndex]++;
+            validCount++;
+        }
+        EXPECT_LE(std::abs((double)validCount / sampleCount - pdfSum), 2.0 / sampleCount + 1e-3);
+        for (uint32_t lightIndex = 0; lightIndex < lights.size(); lightIndex++)
+        {
+            double frequency = (double)histogram[lightIndex] / sampleCount;
+            EXPECT_LE(std::abs(frequency - pdfs[lightIndex]), 2.0 / sampleCount + 1e-3 * pdfs[lightIndex]) << "light " << lightIndex;
+        }
+    }
+}
+} // namespace
+
+CPU_TEST(LightBVHCostModel)
+{
+    // Flat diffuse emitters range from pi (single direction) to 4pi (whole sphere).
+    EXPECT_LE(std::abs(LightBVHCostModel::computeOrientationCost(0.f) - float(M_PI)), 1e-5f);
+    EXPECT_LE(std::abs(LightBVHCostModel::computeOrientationCost(float(M_PI)) - 4.f * float(M_PI)), 1e-5f);
+    // A narrow spot light is cheaper than a flat emitter.
+    EXPECT_LT(LightBVHCostModel::computeOrientationCost(0.f, 0.2f), LightBVHCostModel::computeOrientationCost(0.f));
+
+    float3 a = float3(1.f, 0.f, 0.f);
+    float3 b = float3(0.f, 1.f, 0.f);
+    float cosTheta = LightBVHCostModel::computeCosConeAngle(a, 1.f, b, 1.f);
+    EXPECT_LE(std::abs(cosTheta), 1e-6f);
+    EXPECT_EQ(LightBVHCostModel::computeCosConeAngle(a, 1.f, -a, 1.f), kInvalidCosConeAngle);
+    EXPECT_EQ(LightBVHCostModel::computeCosConeAngle(a, kInvalidCosConeAngle, b, 1.f), kInvalidCosConeAngle);
+
+    float3 dir = LightBVHCostModel::coneUnionAverageAxis(a, std::cos(0.1f), b, std::cos(0.2f), cosTheta);
+    EXPECT_LE(length(dir - normalize(a + b)), 1e-6f);
+    EXPECT_LE(requiredConeAngle(dir, a, std::cos(0.1f)), std::acos(cosTheta) + 1e-5f);
+    EXPECT_LE(requiredConeAngle(dir, b, std::cos(0.2f)), std::acos(cosTheta) + 1e-5f);
+    LightBVHCostModel::coneUnionAverageAxis(a, std::cos(2.f), -a, std::cos(2.f), cosTheta);
+    EXPECT_EQ(cosTheta, kInvalidCosConeAngle);
+}
+
+CPU_TEST(AnalyticLightBVH_Build)
+{
+    std::vector<LightData> lights = createLights(600, 1);
+    lights.push_back(createDirectionalLight(float3(0.f, -1.f, 0.f), float3(1.f)));
+    lights.push_back(createDirectionalLight(float3(1.f, -1.f, 0.f), float3(2.f)));
+
+    AnalyticLightBVH bvh;
+    bvh.build(lights, {});
+    verifyBVH(ctx, bvh, lights);
+
+    AnalyticLightBVH::Options options;
+    options.splitAlongLargest = true;
+    options.useLightingCones = false;
+    bvh.build(lights, options);
+    verifyBVH(ctx, bvh, lights);
+
+    // Only infinite lights.
+    std::vector<LightData> directionalLights = {createDirectionalLight(float3(0.f, -1.f, 0.f), float3(1.f))};
+    bvh.build(directionalLights, {});
+    verifyBVH(ctx, bvh, directionalLights);
+
+    bvh.build({}, {});
+    EXPECT_EQ(bvh.getLightCount(), 0);
+    uint32_t lightIndex;
+    float pdf;
+    EXPECT_FALSE(bvh.sampleLight(float3(0.f), float3(0.f, 1.f, 0.f), true, 0.5f, lightIndex, pdf));
+}
+
+CPU_TEST(AnalyticLightBVH_Depth)
+{
+    // Lights at the same position can't be split spatially and should end up in a balanced tree.
+    std::vector<LightData> lights;
+    for (uint32_t i = 0; i < 1000; i++) lights.push_back(createPointLight(float3(1.f, 2.f, 3.f), float3(1.f)));
+    AnalyticLightBVH bvh;
+    bvh.build(lights, {});
+    verifyBVH(ctx, bvh, lights);
+    EXPECT_EQ(bvh.getMaxDepth(), 10);
+
+    // Exponentially spaced lights make the SAOH split off a single light at a time.
+    // The depth should still be limited to what can be represented by the bit masks.
+    lights.clear();
+    for (uint32_t i = 0; i < 200; i++) lights.push_back(createPointLight(float3(std::pow(1.2f, (float)i), 0.f, 0.f), float3(1.f)));
+    bvh.build(lights, {});
+    verifyBVH(ctx, bvh, lights);
+    EXPECT_LE(bvh.getMaxDepth(), AnalyticLightBVH::kMaxDepth);
+    verifyPdfs(ctx, bvh, lights, 2);
+}
+
+CPU_TEST(AnalyticLightBVH_Sampling)
+{
+    std::vector<LightData> lights = createLights(300, 3);
+    lights.push_back(createDirectionalLight(float3(0.f, -1.f, 0.f), float3(1.f)));
+
+    AnalyticLightBVH bvh;
+    bvh.build(lights, {});
+    verifyPdfs(ctx, bvh, lights, 4);
+
+    // A spot light pointing away from the shading point can't be selected.
+    std::vector<LightData> spotLights = {
+        createSpotLight(float3(0.f, 10.f, 0.f), float3(0.f, -1.f, 0.f), 0.3f, float3(1.f)),
+        createSpotLight(float3(0.f, 10.f, 0.f), float3(0.f, 1.f, 0.f), 0.3f, float3(1.f)),
+    };
+    bvh.build(spotLights, {});
+    EXPECT_EQ(bvh.evalLightSelectionPdf(float3(0.f), float3(0.f, 1.f, 0.f), true, 0), 1.f);
+    EXPECT_EQ(bvh.evalLightSelectionPdf(float3(0.f), float3(0.f, 1.f, 0.f), true, 1), 0.f);
+
+    // Lights below the shading point are only selected when the lower hemisphere is considered.
+    std::vector<LightData> pointLights = {
+        createPointLight(float3(0.f, 10.f, 0.f), float3(1.f)),
+        createPointLight(float3(0.f, -10.f, 0.f), float3(1.f)),
+    };
+    bvh.build(pointLights, {});
+    EXPECT_EQ(bvh.evalLightSelectionPdf(float3(0.f), float3(0.f, 1.f, 0.f), true, 1), 0.f);
+    EXPECT_EQ(bvh.evalLightSelectionPdf(float3(0.f), float3(0.f, 1.f, 0.f), false, 1), 0.5f);
+}
+
+CPU_TEST(AnalyticLightBVH_Refit)
+{
+    std::vector<LightData> lights = createLights(300, 5);
+    lights.push_back(createDirectionalLight(float3(0.f, -1.f, 0.f), float3(1.f)));
+
+    AnalyticLightBVH bvh;
+    bvh.build(lights, {});
+    const auto nodes = bvh.getNodes();
+
+    // Move, rotate and scale the lights.
+    const float4x4 transform = mul(math::matrixFromTranslation(float3(5.f, -3.f, 2.f)), math::matrixFromRotation(0.5f, normalize(float3(1.f, 2.f, 3.f))));
+    for (auto& light : lights)
+    {
+        light.posW = transformPoint(transform, light.posW);
+        light.dirW = normalize(transformVector(transform, light.dirW));
+        light.intensity *= 2.f;
+        light.transMat = mul(transform, light.transMat);
+        light.transMatIT = inverse(transpose(light.transMat));
+    }
+
+    bvh.refit(lights);
+    verifyBVH(ctx, bvh, lights);
+    verifyPdfs(ctx, bvh, lights, 6);
+
+    // The hierarchy is kept.
+    ASSERT_EQ(bvh.getNodes().size(), nodes.size());
+    for (size_t i = 0; i < nodes.size(); i++) EXPECT_EQ(bvh.getNodes()[i].childOrLightIndex, nodes[i].childOrLightIndex);
+
+    // Changing the set of lights requires a rebuild.
+    lights.pop_back();
+    EXPECT_THROW(bvh.refit(lights));
+}
+} // namespace Falcor
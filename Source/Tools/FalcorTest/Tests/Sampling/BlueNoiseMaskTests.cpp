@@ -0,0 +1,209 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Sampling/BlueNoiseMask.h"
+#include "Core/Platform/OS.h"
+#include <cmath>
+#include <fstream>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+struct TempDirectory
+{
+    std::filesystem::path path;
+
+    TempDirectory() : path(getTempFilePath()) { std::filesystem::create_directories(path); }
+    ~TempDirectory() { std::filesystem::remove_all(path); }
+};
+
+BlueNoiseMask::Options getTestOptions()
+{
+    BlueNoiseMask::Options options;
+    options.size = 32;
+    options.layerCount = 2;
+    return options;
+}
+
+/**
+ * Compute the average power of the low frequencies of an image, relative to the average power of all frequencies.
+ * This is about one for white noise and close to zero for blue noise.
+ */
+double computeRelativeLowFrequencyPower(const std::vector<double>& image, int32_t size, int32_t maxFrequency)
+{
+    double mean = 0.0;
+    for (double v : image)
+        mean += v;
+    mean /= image.size();
+
+    double lowPower = 0.0;
+    double totalPower = 0.0;
+    uint32_t lowCount = 0;
+    uint32_t totalCount = 0;
+    for (int32_t ky = -size / 2; ky < size / 2; ++ky)
+    {
+        for (int32_t kx = -size / 2; kx < size / 2; ++kx)
+        {
+            if (kx == 0 && ky == 0)
+                continue;
+
+            double re = 0.0;
+            double im = 0.0;
+            for (int32_t y = 0; y < size; ++y)
+            {
+                for (int32_t x = 0; x < size; ++x)
+                {
+                    double phase = -2.0 * M_PI * (kx * x + ky * y) / size;
+                    re += (image[y * size + x] - mean) * std::cos(phase);
+                    im += (image[y * size + x] - mean) * std::sin(phase);
+                }
+            }
+
+            double power = re * re + im * im;
+            totalPower += power;
+            totalCount++;
+            if (kx * kx + ky * ky <= maxFrequency * maxFrequency)
+            {
+                lowPower += power;
+                lowCount++;
+            }
+        }
+    }
+    return (lowPower / lowCount) / (totalPower / totalCount);
+}
+} // namespace
+
+CPU_TEST(BlueNoiseMask_Permutation)
+{
+    BlueNoiseMask mask(getTestOptions());
+    const uint32_t pixelCount = mask.getSize() * mask.getSize();
+    ASSERT_EQ(mask.getRanks().size(), pixelCount * mask.getLayerCount());
+
+    // Each rank appears exactly once in each layer.
+    for (uint32_t layer = 0; layer < mask.getLayerCount(); ++layer)
+    {
+        std::vector<uint32_t> count(pixelCount);
+        for (uint32_t y = 0; y < mask.getSize(); ++y)
+        {
+            for (uint32_t x = 0; x < mask.getSize(); ++x)
+            {
+                uint32_t rank = mask.getRank(layer, x, y);
+                ASSERT_LT(rank, pixelCount);
+                count[rank]++;
+            }
+        }
+        for (uint32_t rank = 0; rank < pixelCount; ++rank)
+            EXPECT_EQ(count[rank], 1) << "layer = " << layer << " rank = " << rank;
+    }
+
+    // The fixed point values are the centers of the strata.
+    auto values = mask.getFixedPointValues();
+    for (size_t i = 0; i < values.size(); ++i)
+        EXPECT_EQ(values[i], uint32_t((mask.getRanks()[i] + 0.5) / pixelCount * 0x1p32));
+}
+
+CPU_TEST(BlueNoiseMask_Determinism)
+{
+    BlueNoiseMask mask0(getTestOptions());
+    BlueNoiseMask mask1(getTestOptions());
+    EXPECT(mask0.getRanks() == mask1.getRanks());
+
+    // Layers are independent.
+    const size_t pixelCount = mask0.getSize() * mask0.getSize();
+    EXPECT(!std::equal(mask0.getRanks().begin(), mask0.getRanks().begin() + pixelCount, mask0.getRanks().begin() + pixelCount));
+}
+
+CPU_TEST(BlueNoiseMask_Spectrum)
+{
+    BlueNoiseMask mask(getTestOptions());
+    const uint32_t size = mask.getSize();
+    const uint32_t pixelCount = size * size;
+
+    std::mt19937 rng(1);
+    std::vector<double> white(pixelCount);
+    for (auto& v : white)
+        v = rng() % pixelCount;
+    EXPECT_GT(computeRelativeLowFrequencyPower(white, size, size / 8), 0.5);
+
+    for (uint32_t layer = 0; layer < mask.getLayerCount(); ++layer)
+    {
+        std::vector<double> ranks(mask.getRanks().begin() + layer * pixelCount, mask.getRanks().begin() + (layer + 1) * pixelCount);
+        EXPECT_LT(computeRelativeLowFrequencyPower(ranks, size, size / 8), 0.01) << "layer = " << layer;
+
+        // Thresholded masks are blue-noise dither patterns.
+        for (double density : {0.1, 0.25, 0.5})
+        {
+            std::vector<double> pattern(pixelCount);
+            for (uint32_t i = 0; i < pixelCount; ++i)
+                pattern[i] = ranks[i] < density * pixelCount ? 1.0 : 0.0;
+            EXPECT_LT(computeRelativeLowFrequencyPower(pattern, size, size / 8), 0.1) << "layer = " << layer << " density = " << density;
+        }
+    }
+}
+
+CPU_TEST(BlueNoiseMask_Cache)
+{
+    TempDirectory dir;
+    auto options = getTestOptions();
+    auto cachePath = BlueNoiseMask::getCachePath(options, dir.path);
+
+    // The first call generates the masks and writes the cache.
+    BlueNoiseMask reference(options);
+    auto mask = BlueNoiseMask::createCached(options, dir.path);
+    EXPECT(mask.getRanks() == reference.getRanks());
+    ASSERT(std::filesystem::exists(cachePath));
+    const auto fileSize = std::filesystem::file_size(cachePath);
+
+    // The second call reads the cache.
+    mask = BlueNoiseMask::createCached(options, dir.path);
+    EXPECT(mask.getRanks() == reference.getRanks());
+
+    // Different options use a different cache file.
+    auto otherOptions = options;
+    otherOptions.seed = 2;
+    EXPECT(BlueNoiseMask::getCachePath(otherOptions, dir.path) != cachePath);
+
+    // A corrupt cache is regenerated.
+    {
+        std::fstream fs(cachePath, std::ios_base::binary | std::ios_base::in | std::ios_base::out);
+        fs.seekp(fileSize - sizeof(uint32_t));
+        uint32_t rank = 0xffffffff;
+        fs.write(reinterpret_cast<const char*>(&rank), sizeof(rank));
+    }
+    mask = BlueNoiseMask::createCached(options, dir.path);
+    EXPECT(mask.getRanks() == reference.getRanks());
+
+    // A truncated cache is regenerated.
+    std::filesystem::resize_file(cachePath, fileSize / 2);
+    mask = BlueNoiseMask::createCached(options, dir.path);
+    EXPECT(mask.getRanks() == reference.getRanks());
+    EXPECT_EQ(std::filesystem::file_size(cachePath), fileSize);
+}
+} // namespace Falcor
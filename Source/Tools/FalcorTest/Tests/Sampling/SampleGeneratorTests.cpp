@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Sampling/SampleGenerator.h"
+#include "Utils/Sampling/SobolSampleGenerator.h"
 
 /** GPU tests for the SampleGenerator utility class.
  */
@@ -70,7 +71,14 @@ double correlation(const float* elems, const size_t numElems, const size_t strid
     return r_xy;
 }
 
-void testSampleGenerator(GPUUnitTestContext& ctx, uint32_t type, const double meanError, const double corrThreshold, bool testInstances)
+void testSampleGenerator(
+    GPUUnitTestContext& ctx,
+    uint32_t type,
+    const double meanError,
+    const double corrThreshold,
+    bool testPixels,
+    bool testInstances
+)
 {
     // Create sample generator.
     ref<SampleGenerator> pSampleGenerator = SampleGenerator::create(ctx.getDevice(), type);
@@ -122,16 +130,19 @@ void testSampleGenerator(GPUUnitTestContext& ctx, uint32_t type, const double me
         EXPECT_LE(corr(i), corrThreshold) << "i = " << i;
     }
 
-    // Test nearby pixels.
-    const size_t xStride = kDimensions;
-    const size_t yStride = kDispatchDim.x * kDimensions;
-    for (size_t y = 0; y < 4; y++)
+    // Test nearby pixels, if they are expected to be uncorrelated.
+    if (testPixels)
     {
-        for (size_t x = 0; x < 4; x++)
+        const size_t xStride = kDimensions;
+        const size_t yStride = kDispatchDim.x * kDimensions;
+        for (size_t y = 0; y < 4; y++)
         {
-            if (x == 0 && y == 0)
-                continue;
-            EXPECT_LE(corr(x * xStride + y * yStride), corrThreshold) << "x = " << x << " y = " << y;
+            for (size_t x = 0; x < 4; x++)
+            {
+                if (x == 0 && y == 0)
+                    continue;
+                EXPECT_LE(corr(x * xStride + y * yStride), corrThreshold) << "x = " << x << " y = " << y;
+            }
         }
     }
 
@@ -145,6 +156,43 @@ void testSampleGenerator(GPUUnitTestContext& ctx, uint32_t type, const double me
         }
     }
 }
+
+void testSobolSampleGenerator(GPUUnitTestContext& ctx, uint32_t type, SobolScrambling scrambling)
+{
+    SobolSampleGenerator::Options options;
+    options.scrambling = scrambling;
+    ref<SobolSampleGenerator> pSampleGenerator = make_ref<SobolSampleGenerator>(ctx.getDevice(), type, options);
+
+    ctx.createProgram(kShaderFile, "testNext", pSampleGenerator->getDefines(), SlangCompilerFlags::None, ShaderModel::SM6_2);
+    pSampleGenerator->bindShaderData(ctx.vars().getRootVar());
+
+    // Use more dimensions than in the tables to test the wrap around.
+    const uint3 dispatchDim = {32, 32, 4};
+    const uint32_t dimensions = SobolSampleGenerator::getSobolTables().getDimensionCount() + 8;
+    const size_t numSamples = dispatchDim.x * dispatchDim.y * dispatchDim.z * dimensions;
+    ctx.allocateStructuredBuffer("resultNext", uint32_t(numSamples));
+    ctx["CB"]["gDispatchDim"] = dispatchDim;
+    ctx["CB"]["gDimensions"] = dimensions;
+    ctx.runProgram(dispatchDim);
+
+    // Compare with the CPU implementation.
+    std::vector<uint32_t> result = ctx.readBuffer<uint32_t>("resultNext");
+    size_t i = 0;
+    for (uint32_t z = 0; z < dispatchDim.z; z++)
+    {
+        for (uint32_t y = 0; y < dispatchDim.y; y++)
+        {
+            for (uint32_t x = 0; x < dispatchDim.x; x++)
+            {
+                for (uint32_t d = 0; d < dimensions; d++, i++)
+                {
+                    EXPECT_EQ(result[i], pSampleGenerator->generateSample(uint2(x, y), z, d))
+                        << "x = " << x << " y = " << y << " z = " << z << " d = " << d;
+                }
+            }
+        }
+    }
+}
 } // namespace
 
 /** Tests for the different types of sample generators.
@@ -155,12 +203,32 @@ void testSampleGenerator(GPUUnitTestContext& ctx, uint32_t type, const double me
 
 GPU_TEST(SampleGenerator_TinyUniform)
 {
-    testSampleGenerator(ctx, SAMPLE_GENERATOR_TINY_UNIFORM, 0.01, 0.0025, true);
+    testSampleGenerator(ctx, SAMPLE_GENERATOR_TINY_UNIFORM, 0.01, 0.0025, true, true);
 }
 
 GPU_TEST(SampleGenerator_Uniform)
 {
-    testSampleGenerator(ctx, SAMPLE_GENERATOR_UNIFORM, 0.01, 0.002, true);
+    testSampleGenerator(ctx, SAMPLE_GENERATOR_UNIFORM, 0.01, 0.002, true, true);
+}
+
+// The samples of a pixel are stratified and thus correlated between instances.
+// With blue noise, nearby pixels are anti-correlated by design.
+GPU_TEST(SampleGenerator_Sobol)
+{
+    testSampleGenerator(ctx, SAMPLE_GENERATOR_SOBOL, 0.001, 0.004, true, false);
+}
+
+GPU_TEST(SampleGenerator_SobolBlueNoise)
+{
+    testSampleGenerator(ctx, SAMPLE_GENERATOR_SOBOL_BLUE_NOISE, 0.001, 0.004, false, false);
+}
+
+GPU_TEST(SampleGenerator_SobolMatchesCPU)
+{
+    testSobolSampleGenerator(ctx, SAMPLE_GENERATOR_SOBOL, SobolScrambling::Owen);
+    testSobolSampleGenerator(ctx, SAMPLE_GENERATOR_SOBOL, SobolScrambling::RandomDigit);
+    testSobolSampleGenerator(ctx, SAMPLE_GENERATOR_SOBOL_BLUE_NOISE, SobolScrambling::Owen);
+    testSobolSampleGenerator(ctx, SAMPLE_GENERATOR_SOBOL_BLUE_NOISE, SobolScrambling::RandomDigit);
 }
 
 } // namespace Falcor
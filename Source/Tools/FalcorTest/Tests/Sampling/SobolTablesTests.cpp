@@ -0,0 +1,246 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Sampling/LowDiscrepancy/SobolTables.h"
+#include "Utils/Sampling/LowDiscrepancy/OwenScrambling.slang"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+namespace
+{
+SobolTables::Options getTestOptions()
+{
+    SobolTables::Options options;
+    options.dimensionCount = 32;
+    options.candidateCount = 16;
+    return options;
+}
+
+double toFloat(uint32_t x)
+{
+    return x * 0x1p-32;
+}
+
+/**
+ * Compute the squared L2-star discrepancy of a point set with Warnock's formula.
+ * @param[in] points Points stored as dimensionCount values each.
+ */
+double computeL2StarDiscrepancy2(const std::vector<double>& points, uint32_t dimensionCount)
+{
+    const size_t n = points.size() / dimensionCount;
+    double sum1 = 0.0;
+    double sum2 = 0.0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const double* p = &points[i * dimensionCount];
+        double prod = 1.0;
+        for (uint32_t k = 0; k < dimensionCount; ++k)
+            prod *= 1.0 - p[k] * p[k];
+        sum1 += prod;
+
+        for (size_t j = 0; j < n; ++j)
+        {
+            const double* q = &points[j * dimensionCount];
+            prod = 1.0;
+            for (uint32_t k = 0; k < dimensionCount; ++k)
+                prod *= 1.0 - std::max(p[k], q[k]);
+            sum2 += prod;
+        }
+    }
+    return std::pow(3.0, -double(dimensionCount)) - std::pow(2.0, 1.0 - dimensionCount) / n * sum1 + sum2 / (double(n) * n);
+}
+
+/// Check that the first 2^m values fall into distinct intervals of size 2^-m.
+bool isStratified(const std::vector<uint32_t>& values, uint32_t log2SampleCount)
+{
+    std::vector<bool> used(1u << log2SampleCount);
+    for (uint32_t i = 0; i < (1u << log2SampleCount); ++i)
+    {
+        uint32_t stratum = log2SampleCount == 0 ? 0 : values[i] >> (32 - log2SampleCount);
+        if (used[stratum])
+            return false;
+        used[stratum] = true;
+    }
+    return true;
+}
+} // namespace
+
+CPU_TEST(SobolTables_PrimitivePolynomials)
+{
+    EXPECT(SobolTables::isPrimitivePolynomial(0b11, 1));
+    EXPECT(SobolTables::isPrimitivePolynomial(0b111, 2));
+    EXPECT(SobolTables::isPrimitivePolynomial(0b10011, 4));
+    EXPECT(!SobolTables::isPrimitivePolynomial(0b101, 2));   // (x+1)^2
+    EXPECT(!SobolTables::isPrimitivePolynomial(0b11111, 4)); // Irreducible, but x has order 5.
+
+    // The number of primitive polynomials of degree s is phi(2^s - 1) / s.
+    const uint32_t kExpectedCounts[] = {1, 1, 2, 2, 6, 6, 18, 16, 48, 60, 176, 144};
+    for (uint32_t degree = 1; degree <= 12; ++degree)
+    {
+        uint32_t count = 0;
+        for (uint32_t p = 1u << degree; p < (2u << degree); ++p)
+        {
+            if (SobolTables::isPrimitivePolynomial(p, degree))
+                count++;
+        }
+        EXPECT_EQ(count, kExpectedCounts[degree - 1]) << "degree = " << degree;
+    }
+}
+
+CPU_TEST(SobolTables_Determinism)
+{
+    SobolTables tables0(getTestOptions());
+    SobolTables tables1(getTestOptions());
+    EXPECT(tables0.getDirectionNumbers() == tables1.getDirectionNumbers());
+
+    auto options = getTestOptions();
+    options.seed = 2;
+    SobolTables tables2(options);
+    EXPECT(tables0.getDirectionNumbers() != tables2.getDirectionNumbers());
+}
+
+CPU_TEST(SobolTables_Polynomials)
+{
+    SobolTables tables(getTestOptions());
+    ASSERT_EQ(tables.getDimensionCount(), 32);
+
+    // The polynomials match the ones used by Joe and Kuo.
+    const uint32_t kExpectedDegrees[] = {0, 1, 2, 3, 3, 4, 4, 5, 5, 5, 5, 5, 5};
+    const uint32_t kExpectedCoefficients[] = {0, 0, 1, 1, 2, 1, 4, 2, 4, 7, 11, 13, 14};
+    for (uint32_t d = 0; d < 13; ++d)
+    {
+        EXPECT_EQ(tables.getDegree(d), kExpectedDegrees[d]) << "d = " << d;
+        EXPECT_EQ(tables.getCoefficients(d), kExpectedCoefficients[d]) << "d = " << d;
+    }
+
+    // The first dimension is the van der Corput sequence.
+    for (uint32_t i = 0; i < 1024; ++i)
+        EXPECT_EQ(tables.sample(i, 0), reverseBits32(i)) << "i = " << i;
+}
+
+CPU_TEST(SobolTables_Stratification)
+{
+    SobolTables tables(getTestOptions());
+    const uint32_t kLog2SampleCount = 12;
+    const uint32_t kSampleCount = 1u << kLog2SampleCount;
+
+    for (uint32_t d = 0; d < tables.getDimensionCount(); ++d)
+    {
+        const uint32_t seed = scrambleHash(d);
+        std::vector<uint32_t> sobol(kSampleCount);
+        std::vector<uint32_t> randomDigit(kSampleCount);
+        std::vector<uint32_t> owen(kSampleCount);
+        std::vector<uint32_t> shuffled(kSampleCount);
+        for (uint32_t i = 0; i < kSampleCount; ++i)
+        {
+            sobol[i] = tables.sample(i, d);
+            randomDigit[i] = sobol[i] ^ seed;
+            owen[i] = nestedUniformScramble(sobol[i], seed);
+            shuffled[i] = nestedUniformScramble(tables.sample(nestedUniformScramble(i, ~seed), d), seed);
+        }
+
+        // Every prefix of 2^m samples is stratified in each dimension.
+        for (uint32_t m = 0; m <= kLog2SampleCount; ++m)
+        {
+            EXPECT(isStratified(sobol, m)) << "d = " << d << " m = " << m;
+            EXPECT(isStratified(randomDigit, m)) << "d = " << d << " m = " << m;
+            EXPECT(isStratified(owen, m)) << "d = " << d << " m = " << m;
+            EXPECT(isStratified(shuffled, m)) << "d = " << d << " m = " << m;
+        }
+    }
+}
+
+CPU_TEST(SobolTables_TValues)
+{
+    SobolTables tables(getTestOptions());
+    const auto& directions = tables.getDirectionNumbers();
+
+    // The first two dimensions form a (0,2)-sequence.
+    for (uint32_t m = 0; m <= 16; ++m)
+        EXPECT_EQ(SobolTables::computeTValue(&directions[0], &directions[SobolTables::kBitCount], m), 0) << "m = " << m;
+
+    // The optimized direction numbers have better two-dimensional projections than unoptimized ones.
+    auto options = getTestOptions();
+    options.candidateCount = 1;
+    SobolTables unoptimized(options);
+
+    auto sumTValues = [](const SobolTables& t)
+    {
+        const auto& v = t.getDirectionNumbers();
+        uint32_t sum = 0;
+        for (uint32_t d0 = 0; d0 < t.getDimensionCount(); ++d0)
+            for (uint32_t d1 = d0 + 1; d1 < t.getDimensionCount(); ++d1)
+                sum += SobolTables::computeTValue(&v[d0 * SobolTables::kBitCount], &v[d1 * SobolTables::kBitCount], 10);
+        return sum;
+    };
+    EXPECT_LT(sumTValues(tables), sumTValues(unoptimized));
+}
+
+CPU_TEST(SobolTables_Discrepancy)
+{
+    SobolTables tables(getTestOptions());
+    const uint32_t kSampleCount = 256;
+    const uint32_t kDimensionCount = 4;
+
+    // Expected squared L2-star discrepancy of uniform random points.
+    const double randomDiscrepancy = (std::pow(2.0, -double(kDimensionCount)) - std::pow(3.0, -double(kDimensionCount))) / kSampleCount;
+
+    // Compare the discrepancy of 4D projections of the sequence with random points.
+    // Individual projections can be poor as the direction numbers are only optimized for 2D projections.
+    double sumSobol = 0.0;
+    double sumOwen = 0.0;
+    uint32_t projectionCount = 0;
+    for (uint32_t firstDimension = 0; firstDimension + kDimensionCount <= tables.getDimensionCount(); firstDimension += kDimensionCount)
+    {
+        std::vector<double> sobol(kSampleCount * kDimensionCount);
+        std::vector<double> owen(kSampleCount * kDimensionCount);
+        for (uint32_t i = 0; i < kSampleCount; ++i)
+        {
+            for (uint32_t k = 0; k < kDimensionCount; ++k)
+            {
+                uint32_t x = tables.sample(i, firstDimension + k);
+                sobol[i * kDimensionCount + k] = toFloat(x);
+                owen[i * kDimensionCount + k] = toFloat(nestedUniformScramble(x, scrambleHash(firstDimension + k)));
+            }
+        }
+
+        double discrepancySobol = computeL2StarDiscrepancy2(sobol, kDimensionCount) / randomDiscrepancy;
+        double discrepancyOwen = computeL2StarDiscrepancy2(owen, kDimensionCount) / randomDiscrepancy;
+        EXPECT_LT(discrepancySobol, 1.0) << "firstDimension = " << firstDimension;
+        EXPECT_LT(discrepancyOwen, 1.0) << "firstDimension = " << firstDimension;
+        sumSobol += discrepancySobol;
+        sumOwen += discrepancyOwen;
+        projectionCount++;
+    }
+
+    EXPECT_LT(sumSobol / projectionCount, 0.35);
+    EXPECT_LT(sumOwen / projectionCount, 0.35);
+}
+} // namespace Falcor
@@ -0,0 +1,304 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/CpuRayQuery.h"
+
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Builds scene data with a 16-bit indexed, a 32-bit indexed and a non-indexed mesh of random triangles,
+/// instanced through a small scene graph with nested transforms.
+Scene::SceneData createTestSceneData(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    auto randomPoint = [&]() { return float3(u(rng), u(rng), u(rng)) * 2.f - 1.f; };
+
+    Scene::SceneData sceneData;
+
+    const uint32_t kTriangleCounts[] = {200, 500, 50};
+    for (uint32_t meshID = 0; meshID < 3; meshID++)
+    {
+        const uint32_t triangleCount = kTriangleCounts[meshID];
+        const uint32_t vertexCount = triangleCount * 3;
+
+        MeshDesc meshDesc = {};
+        meshDesc.vbOffset = (uint32_t)sceneData.meshStaticData.size();
+        meshDesc.ibOffset = (uint32_t)sceneData.meshIndexData.size();
+        meshDesc.vertexCount = vertexCount;
+
+        // Small triangles scattered in the unit cube.
+        for (uint32_t i = 0; i < triangleCount; i++)
+        {
+            float3 center = randomPoint();
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                PackedStaticVertexData vertex = {};
+                vertex.position = center + randomPoint() * 0.2f;
+                sceneData.meshStaticData.push_back(vertex);
+            }
+        }
+
+        // Reference the vertices in reverse order to exercise the index buffer.
+        std::vector<uint32_t> indices(vertexCount);
+        for (uint32_t i = 0; i < vertexCount; i++) indices[i] = vertexCount - 1 - i;
+
+        if (meshID == 0)
+        {
+            meshDesc.indexCount = vertexCount;
+            meshDesc.flags |= (uint32_t)MeshFlags::Use16BitIndices;
+            std::vector<uint32_t> packed((vertexCount + 1) / 2);
+            uint16_t* pPacked = reinterpret_cast<uint16_t*>(packed.data());
+            for (uint32_t i = 0; i < vertexCount; i++) pPacked[i] = (uint16_t)indices[i];
+            sceneData.meshIndexData.insert(sceneData.meshIndexData.end(), packed.begin(), packed.end());
+        }
+        else if (meshID == 1)
+        {
+            meshDesc.indexCount = vertexCount;
+            sceneData.meshIndexData.insert(sceneData.meshIndexData.end(), indices.begin(), indices.end());
+        }
+        sceneData.meshDesc.push_back(meshDesc);
+    }
+
+    // Scene graph: root with a scaling transform and rotated/translated children.
+    sceneData.sceneGraph.push_back(Scene::Node("root", NodeID::Invalid(), math::matrixFromScaling(float3(2.f)), float4x4::identity(), float4x4::identity()));
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        float4x4 transform = mul(math::matrixFromTranslation(float3(i * 1.5f - 2.f, 0.f, 0.f)), math::matrixFromRotationY(0.3f * i));
+        sceneData.sceneGraph.push_back(Scene::Node("child", NodeID(0), transform, float4x4::identity(), float4x4::identity()));
+    }
+
+    // Instances. Mesh 1 is instanced twice.
+    const uint32_t kInstances[][2] = { {0, 1}, {1, 2}, {1, 3}, {2, 4}, {0, 0} };
+    for (const auto& instance : kInstances)
+    {
+        GeometryInstanceData instanceData(GeometryType::TriangleMesh);
+        instanceData.geometryID = instance[0];
+        instanceData.globalMatrixID = instance[1];
+        sceneData.meshInstanceData.push_back(instanceData);
+    }
+
+    return sceneData;
+}
+
+/// Reference triangle intersection used for brute force tracing.
+bool intersectTriangle(const Ray& ray, const float3& p0, const float3& p1, const float3& p2, float& t, float2& barycentrics)
+{
+    const float3 e1 = p1 - p0;
+    const float3 e2 = p2 - p0;
+    const float3 s1 = cross(ray.dir, e2);
+    const float det = dot(s1, e1);
+    if (det == 0.f) return false;
+    const float3 d = ray.origin - p0;
+    const float b1 = dot(d, s1) / det;
+    const float3 s2 = cross(d, e1);
+    const float b2 = dot(ray.dir, s2) / det;
+    t = dot(e2, s2) / det;
+    barycentrics = float2(b1, b2);
+    return b1 >= 0.f && b2 >= 0.f && b1 + b2 <= 1.f && t >= ray.tMin && t < ray.tMax;
+}
+
+/// Brute force closest hit over all instances and triangles.
+CpuRayQuery::TriangleHit traceReference(const Scene::SceneData& sceneData, const Ray& ray)
+{
+    std::vector<float4x4> globalMatrices;
+    for (const auto& node : sceneData.sceneGraph)
+    {
+        float4x4 m = node.transform;
+        if (node.parent != NodeID::Invalid()) m = mul(globalMatrices[node.parent.get()], m);
+        globalMatrices.push_back(m);
+    }
+
+    CpuRayQuery::TriangleHit hit;
+    Ray objectRay = ray;
+    for (uint32_t instanceID = 0; instanceID < sceneData.meshInstanceData.size(); instanceID++)
+    {
+        const auto& instance = sceneData.meshInstanceData[instanceID];
+        const MeshDesc& meshDesc = sceneData.meshDesc[instance.geometryID];
+        const float4x4 worldToObject = inverse(globalMatrices[instance.globalMatrixID]);
+        objectRay.origin = transformPoint(worldToObject, ray.origin);
+        objectRay.dir = transformVector(worldToObject, ray.dir);
+
+        for (uint32_t triangleIndex = 0; triangleIndex < meshDesc.getTriangleCount(); triangleIndex++)
+        {
+            uint32_t indices[3];
+            for (uint32_t j = 0; j < 3; j++)
+            {
+                uint32_t i = triangleIndex * 3 + j;
+                if (!meshDesc.useVertexIndices()) indices[j] = i;
+                else if (meshDesc.use16BitIndices()) indices[j] = reinterpret_cast<const uint16_t*>(sceneData.meshIndexData.data() + meshDesc.ibOffset)[i];
+                else indices[j] = sceneData.meshIndexData[meshDesc.ibOffset + i];
+            }
+            const auto* pVertices = sceneData.meshStaticData.data() + meshDesc.vbOffset;
+
+            float t;
+            float2 barycentrics;
+            if (intersectTriangle(objectRay, pVertices[indices[0]].position, pVertices[indices[1]].position, pVertices[indices[2]].position, t, barycentrics))
+            {
+                objectRay.tMax = t;
+                hit.instanceID = instanceID;
+                hit.primitiveIndex = triangleIndex;
+                hit.barycentrics = barycentrics;
+                hit.t = t;
+            }
+        }
+    }
+    return hit;
+}
+
+std::vector<Ray> createRays(std::mt19937& rng, uint32_t count)
+{
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    std::vector<Ray> rays(count);
+    for (auto& ray : rays)
+    {
+        // Rays from a sphere around the scene towards random points inside it.
+        float3 target = float3(u(rng) * 8.f - 4.f, u(rng) * 4.f - 2.f, u(rng) * 4.f - 2.f);
+        float3 origin = normalize(float3(u(rng), u(rng), u(rng)) * 2.f - 1.f) * 10.f;
+        ray = Ray(origin, normalize(target - origin));
+    }
+    return rays;
+}
+} // namespace
+
+CPU_TEST(CpuRayQuery_ClosestHit)
+{
+    std::mt19937 rng(1);
+    Scene::SceneData sceneData = createTestSceneData(rng);
+    auto pRayQuery = CpuRayQuery::create(sceneData);
+
+    const auto& stats = pRayQuery->getStats();
+    EXPECT_EQ(stats.meshCount, 3u);
+    EXPECT_EQ(stats.instanceCount, 5u);
+    EXPECT_EQ(stats.triangleCount, 750u);
+
+    std::vector<Ray> rays = createRays(rng, 2000);
+    std::vector<CpuRayQuery::TriangleHit> hits;
+    pRayQuery->traceClosestHit(rays, hits);
+    ASSERT_EQ(hits.size(), rays.size());
+
+    uint32_t hitCount = 0;
+    for (size_t i = 0; i < rays.size(); i++)
+    {
+        CpuRayQuery::TriangleHit ref = traceReference(sceneData, rays[i]);
+        const CpuRayQuery::TriangleHit& hit = hits[i];
+        EXPECT_EQ(hit.isValid(), ref.isValid()) << "i = " << i;
+        if (!hit.isValid() || !ref.isValid()) continue;
+        hitCount++;
+
+        EXPECT_EQ(hit.instanceID, ref.instanceID) << "i = " << i;
+        EXPECT_EQ(hit.primitiveIndex, ref.primitiveIndex) << "i = " << i;
+        EXPECT_LE(std::abs(hit.t - ref.t), 1e-4f * ref.t) << "i = " << i;
+        EXPECT_LE(std::abs(hit.barycentrics.x - ref.barycentrics.x), 1e-4f) << "i = " << i;
+        EXPECT_LE(std::abs(hit.barycentrics.y - ref.barycentrics.y), 1e-4f) << "i = " << i;
+
+        // The single ray query should agree with the batch query.
+        CpuRayQuery::TriangleHit singleHit;
+        EXPECT(pRayQuery->traceClosestHit(rays[i], singleHit));
+        EXPECT_EQ(singleHit.instanceID, hit.instanceID);
+        EXPECT_EQ(singleHit.primitiveIndex, hit.primitiveIndex);
+        EXPECT_EQ(singleHit.t, hit.t);
+    }
+
+    // Make sure the test is meaningful.
+    EXPECT_GE(hitCount, 100u);
+    EXPECT_LT(hitCount, (uint32_t)rays.size());
+}
+
+CPU_TEST(CpuRayQuery_AnyHit)
+{
+    std::mt19937 rng(2);
+    Scene::SceneData sceneData = createTestSceneData(rng);
+    auto pRayQuery = CpuRayQuery::create(sceneData);
+
+    std::vector<Ray> rays = createRays(rng, 2000);
+
+    // Shorten half of the rays so that some of them end before reaching the geometry.
+    for (size_t i = 0; i < rays.size(); i += 2) rays[i].tMax = 9.f;
+
+    std::vector<uint8_t> hits;
+    pRayQuery->traceAnyHit(rays, hits);
+    ASSERT_EQ(hits.size(), rays.size());
+
+    for (size_t i = 0; i < rays.size(); i++)
+    {
+        bool refHit = traceReference(sceneData, rays[i]).isValid();
+        EXPECT_EQ(hits[i] != 0, refHit) << "i = " << i;
+        EXPECT_EQ(pRayQuery->traceAnyHit(rays[i]), refHit) << "i = " << i;
+    }
+}
+
+CPU_TEST(CpuRayQuery_RayInterval)
+{
+    // Single quad made of two triangles in the z = 0 plane.
+    Scene::SceneData sceneData;
+    const float3 kPositions[] = { {-1.f, -1.f, 0.f}, {1.f, -1.f, 0.f}, {1.f, 1.f, 0.f}, {-1.f, 1.f, 0.f} };
+    for (const float3& p : kPositions)
+    {
+        PackedStaticVertexData vertex = {};
+        vertex.position = p;
+        sceneData.meshStaticData.push_back(vertex);
+    }
+    sceneData.meshIndexData = { 0, 1, 2, 0, 2, 3 };
+    MeshDesc meshDesc = {};
+    meshDesc.vertexCount = 4;
+    meshDesc.indexCount = 6;
+    sceneData.meshDesc.push_back(meshDesc);
+    sceneData.sceneGraph.push_back(Scene::Node("root", NodeID::Invalid(), math::matrixFromTranslation(float3(0.f, 0.f, 5.f)), float4x4::identity(), float4x4::identity()));
+    GeometryInstanceData instanceData(GeometryType::TriangleMesh);
+    instanceData.geometryID = 0;
+    instanceData.globalMatrixID = 0;
+    sceneData.meshInstanceData.push_back(instanceData);
+
+    auto pRayQuery = CpuRayQuery::create(sceneData);
+    EXPECT(pRayQuery->getBounds() == AABB(float3(-1.f, -1.f, 5.f), float3(1.f, 1.f, 5.f)));
+
+    CpuRayQuery::TriangleHit hit;
+    EXPECT(pRayQuery->traceClosestHit(Ray(float3(0.5f, -0.5f, 0.f), float3(0.f, 0.f, 1.f)), hit));
+    EXPECT_EQ(hit.instanceID, 0u);
+    EXPECT_EQ(hit.primitiveIndex, 0u);
+    EXPECT_LE(std::abs(hit.t - 5.f), 1e-5f);
+    EXPECT_LE(std::abs(hit.barycentrics.x - 0.5f), 1e-5f);
+    EXPECT_LE(std::abs(hit.barycentrics.y - 0.25f), 1e-5f);
+
+    EXPECT(pRayQuery->traceClosestHit(Ray(float3(-0.5f, 0.5f, 0.f), float3(0.f, 0.f, 2.f)), hit));
+    EXPECT_EQ(hit.primitiveIndex, 1u);
+    EXPECT_LE(std::abs(hit.t - 2.5f), 1e-5f);
+
+    // Misses due to the ray interval and direction.
+    EXPECT_FALSE(pRayQuery->traceAnyHit(Ray(float3(0.f), float3(0.f, 0.f, 1.f), 0.f, 4.f)));
+    EXPECT_FALSE(pRayQuery->traceAnyHit(Ray(float3(0.f), float3(0.f, 0.f, 1.f), 6.f)));
+    EXPECT_FALSE(pRayQuery->traceAnyHit(Ray(float3(0.f), float3(0.f, 0.f, -1.f))));
+    EXPECT_FALSE(pRayQuery->traceClosestHit(Ray(float3(2.f, 0.f, 0.f), float3(0.f, 0.f, 1.f)), hit));
+    EXPECT_FALSE(hit.isValid());
+    EXPECT(pRayQuery->traceAnyHit(Ray(float3(0.f), float3(0.f, 0.f, 1.f))));
+}
+} // namespace Falcor
@@ -0,0 +1,267 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Curves/CurveSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+struct TestStrands
+{
+    std::vector<uint32_t> vertexCounts;
+    std::vector<float3> points;
+    std::vector<float> widths;
+    std::vector<float2> UVs;
+
+    uint32_t getStrandCount() const { return (uint32_t)vertexCounts.size(); }
+};
+
+/// Helical strands rooted on a regular grid in the xz-plane.
+TestStrands createGroom(uint32_t gridSize, uint32_t pointsPerStrand, float noise)
+{
+    TestStrands strands;
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> u(-noise, noise);
+    for (uint32_t z = 0; z < gridSize; z++)
+    {
+        for (uint32_t x = 0; x < gridSize; x++)
+        {
+            strands.vertexCounts.push_back(pointsPerStrand);
+            for (uint32_t i = 0; i < pointsPerStrand; i++)
+            {
+                float t = (float)i / (pointsPerStrand - 1);
+                float3 root = float3((float)x, 0.f, (float)z);
+                float3 p = root + float3(0.2f * std::cos(6.f * t), 4.f * t, 0.2f * std::sin(6.f * t));
+                strands.points.push_back(p + float3(u(rng), u(rng), u(rng)));
+                strands.widths.push_back(0.05f * (1.f - 0.5f * t));
+                strands.UVs.push_back(float2((float)x / gridSize, t));
+            }
+        }
+    }
+    return strands;
+}
+
+float distanceToSegment(const float3& p, float r, const float3& a, float ra, const float3& b, float rb)
+{
+    float3 d = b - a;
+    float dd = dot(d, d);
+    float t = dd > 0.f ? std::clamp(dot(p - a, d) / dd, 0.f, 1.f) : 0.f;
+    return length(p - (a + t * d)) + std::abs(r - (ra + t * (rb - ra)));
+}
+
+CurveSimplifier::Result simplify(const TestStrands& strands, const CurveSimplificationSettings& settings)
+{
+    return CurveSimplifier::simplify(
+        strands.getStrandCount(), strands.vertexCounts.data(), strands.points.data(), strands.widths.data(), strands.UVs.data(), settings
+    );
+}
+} // namespace
+
+CPU_TEST(CurveSimplifier_Disabled)
+{
+    TestStrands strands = createGroom(4, 16, 0.f);
+    CurveSimplifier::Result result = simplify(strands, CurveSimplificationSettings{});
+
+    ASSERT_EQ(result.vertexCountsPerStrand.size(), strands.vertexCounts.size());
+    ASSERT_EQ(result.controlPoints.size(), strands.points.size());
+    for (size_t i = 0; i < strands.points.size(); i++)
+    {
+        EXPECT(all(result.controlPoints[i] == strands.points[i]));
+        EXPECT_EQ(result.widths[i], strands.widths[i]);
+        EXPECT(all(result.UVs[i] == strands.UVs[i]));
+    }
+}
+
+CPU_TEST(CurveSimplifier_ControlPoints)
+{
+    const float maxError = 0.02f;
+    TestStrands strands = createGroom(8, 64, 0.002f);
+
+    CurveSimplificationSettings settings;
+    settings.maxError = maxError;
+    CurveSimplifier::Result result = simplify(strands, settings);
+
+    ASSERT_EQ(result.vertexCountsPerStrand.size(), strands.vertexCounts.size());
+    EXPECT_LT(result.controlPoints.size(), strands.points.size() / 2);
+    ASSERT_EQ(result.UVs.size(), result.controlPoints.size());
+
+    // Every original control point must be within the tolerance of the simplified strand.
+    uint32_t src = 0, dst = 0;
+    for (uint32_t s = 0; s < strands.getStrandCount(); s++)
+    {
+        uint32_t count = result.vertexCountsPerStrand[s];
+        ASSERT_GE(count, 2u);
+        EXPECT(all(result.controlPoints[dst] == strands.points[src]));
+        EXPECT(all(result.controlPoints[dst + count - 1] == strands.points[src + strands.vertexCounts[s] - 1]));
+
+        for (uint32_t i = 0; i < strands.vertexCounts[s]; i++)
+        {
+            const float3& p = strands.points[src + i];
+            float minDistance = std::numeric_limits<float>::max();
+            for (uint32_t j = 0; j + 1 < count; j++)
+            {
+                const uint32_t a = dst + j, b = dst + j + 1;
+                float d = distanceToSegment(
+                    p, 0.5f * strands.widths[src + i], result.controlPoints[a], 0.5f * result.widths[a], result.controlPoints[b],
+                    0.5f * result.widths[b]
+                );
+                minDistance = std::min(minDistance, d);
+            }
+            EXPECT_LE(minDistance, maxError * 1.0001f) << "strand " << s << ", point " << i;
+        }
+
+        src += strands.vertexCounts[s];
+        dst += count;
+    }
+    EXPECT_EQ(dst, result.controlPoints.size());
+}
+
+CPU_TEST(CurveSimplifier_MinVertices)
+{
+    TestStrands strands;
+    for (uint32_t i = 0; i < 32; i++)
+    {
+        strands.points.push_back(float3(0.f, (float)i, 0.f));
+        strands.widths.push_back(0.1f);
+    }
+    strands.vertexCounts = { 32, 3 };
+    strands.points.insert(strands.points.end(), { float3(0.f), float3(1.f, 0.f, 0.f), float3(2.f, 0.f, 0.f) });
+    strands.widths.insert(strands.widths.end(), { 0.1f, 0.1f, 0.1f });
+
+    CurveSimplificationSettings settings;
+    settings.maxError = 0.01f;
+    settings.minVerticesPerStrand = 4;
+    CurveSimplifier::Result result = CurveSimplifier::simplify(2, strands.vertexCounts.data(), strands.points.data(), strands.widths.data(), nullptr, settings);
+
+    ASSERT_EQ(result.vertexCountsPerStrand.size(), 2);
+    EXPECT_EQ(result.vertexCountsPerStrand[0], 4u);
+    EXPECT_EQ(result.vertexCountsPerStrand[1], 3u);
+    EXPECT_EQ(result.UVs.size(), 0);
+}
+
+CPU_TEST(CurveSimplifier_Strands)
+{
+    const uint32_t gridSize = 64;
+    TestStrands strands = createGroom(gridSize, 8, 0.f);
+
+    CurveSimplificationSettings settings;
+    settings.strandFraction = 0.25f;
+    settings.widthCompensation = 0.5f;
+    CurveSimplifier::Result result = simplify(strands, settings);
+
+    ASSERT_EQ(result.vertexCountsPerStrand.size(), gridSize * gridSize / 4);
+    ASSERT_EQ(result.controlPoints.size(), result.vertexCountsPerStrand.size() * 8);
+
+    // Widths are scaled by sqrt(4) and the kept strands are distributed uniformly over the grid.
+    std::vector<uint32_t> blockCounts(16, 0);
+    for (size_t s = 0; s < result.vertexCountsPerStrand.size(); s++)
+    {
+        const float3& root = result.controlPoints[s * 8];
+        uint32_t x = (uint32_t)std::lround(root.x), z = (uint32_t)std::lround(root.z);
+        uint32_t source = (z * gridSize + x) * 8;
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            EXPECT(all(result.controlPoints[s * 8 + i] == strands.points[source + i]));
+            EXPECT(std::abs(result.widths[s * 8 + i] - 2.f * strands.widths[source + i]) < 1e-6f);
+            EXPECT(all(result.UVs[s * 8 + i] == strands.UVs[source + i]));
+        }
+        blockCounts[(z / 16) * 4 + x / 16]++;
+    }
+    for (uint32_t count : blockCounts)
+    {
+        EXPECT_GE(count, 56u);
+        EXPECT_LE(count, 72u);
+    }
+}
+
+CPU_TEST(CurveSimplifier_Keyframes)
+{
+    TestStrands strands = createGroom(16, 32, 0.002f);
+
+    CurveSimplificationSettings settings;
+    settings.maxError = 0.02f;
+    settings.strandFraction = 0.5f;
+    CurveSimplifier::Selection selection = CurveSimplifier::select(
+        strands.getStrandCount(), strands.vertexCounts.data(), strands.points.data(), strands.widths.data(), settings
+    );
+
+    // Selecting and applying on the same strands matches simplify().
+    CurveSimplifier::Result reference = simplify(strands, settings);
+    CurveSimplifier::Result result = CurveSimplifier::apply(
+        selection, (uint32_t)strands.points.size(), strands.points.data(), strands.widths.data(), strands.UVs.data()
+    );
+    ASSERT_EQ(result.controlPoints.size(), reference.controlPoints.size());
+    EXPECT(std::equal(
+        result.vertexCountsPerStrand.begin(), result.vertexCountsPerStrand.end(), reference.vertexCountsPerStrand.begin(),
+        reference.vertexCountsPerStrand.end()
+    ));
+    for (size_t i = 0; i < result.controlPoints.size(); i++)
+        EXPECT(all(result.controlPoints[i] == reference.controlPoints[i]));
+
+    // A deformed keyframe keeps the same strands and control points as the keyframe the selection was made from.
+    TestStrands keyframe = strands;
+    for (size_t i = 0; i < keyframe.points.size(); i++)
+        keyframe.points[i] += float3(0.5f * keyframe.points[i].y * keyframe.points[i].y, 0.f, 0.f);
+    CurveSimplifier::Result animated = CurveSimplifier::apply(
+        selection, (uint32_t)keyframe.points.size(), keyframe.points.data(), keyframe.widths.data(), keyframe.UVs.data()
+    );
+    ASSERT_EQ(animated.controlPoints.size(), selection.vertexIndices.size());
+    EXPECT(std::equal(
+        animated.vertexCountsPerStrand.begin(), animated.vertexCountsPerStrand.end(), selection.vertexCountsPerStrand.begin(),
+        selection.vertexCountsPerStrand.end()
+    ));
+    for (size_t i = 0; i < animated.controlPoints.size(); i++)
+    {
+        uint32_t src = selection.vertexIndices[i];
+        EXPECT(all(animated.controlPoints[i] == keyframe.points[src]));
+        EXPECT_EQ(animated.widths[i], keyframe.widths[src] * selection.widthScale);
+        EXPECT(all(animated.UVs[i] == keyframe.UVs[src]));
+    }
+
+    // Keyframes with a different topology are rejected.
+    EXPECT_THROW(CurveSimplifier::apply(selection, 7, keyframe.points.data(), keyframe.widths.data(), nullptr));
+}
+
+CPU_TEST(CurveSimplifier_SelectStrands)
+{
+    std::vector<float3> roots(10, float3(1.f));
+    EXPECT_EQ(CurveSimplifier::selectStrands(10, roots.data(), 1.f).size(), 10);
+    EXPECT_EQ(CurveSimplifier::selectStrands(10, roots.data(), 0.01f).size(), 1);
+
+    std::vector<uint32_t> kept = CurveSimplifier::selectStrands(10, roots.data(), 0.5f);
+    ASSERT_EQ(kept.size(), 5);
+    EXPECT(std::is_sorted(kept.begin(), kept.end()));
+    EXPECT(std::adjacent_find(kept.begin(), kept.end()) == kept.end());
+}
+} // namespace Falcor
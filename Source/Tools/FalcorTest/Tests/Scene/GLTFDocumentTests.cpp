@@ -0,0 +1,301 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/GLTFDocument.h"
+#include "Scene/ImporterError.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/StringUtils.h"
+
+#include <fmt/format.h>
+#include <cstring>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const std::filesystem::path kPath = "test.gltf";
+
+/// Binary buffer contents built from typed values.
+struct BinaryBuffer
+{
+    std::vector<uint8_t> data;
+
+    template<typename T>
+    size_t append(std::initializer_list<T> values)
+    {
+        size_t offset = data.size();
+        for (T value : values)
+        {
+            data.resize(data.size() + sizeof(T));
+            std::memcpy(data.data() + data.size() - sizeof(T), &value, sizeof(T));
+        }
+        return offset;
+    }
+
+    void align(size_t alignment) { data.resize((data.size() + alignment - 1) / alignment * alignment); }
+};
+
+std::string createDataURI(const std::vector<uint8_t>& data)
+{
+    return "data:application/octet-stream;base64," + encodeBase64(data);
+}
+
+/// Create a GLB file with the given JSON and BIN chunks.
+std::vector<uint8_t> createGlb(std::string json, std::vector<uint8_t> bin, uint32_t version = 2)
+{
+    json.resize((json.size() + 3) & ~size_t(3), ' ');
+    bin.resize((bin.size() + 3) & ~size_t(3), 0);
+
+    BinaryBuffer glb;
+    glb.append<uint32_t>({0x46546C67, version, uint32_t(12 + 8 + json.size() + (bin.empty() ? 0 : 8 + bin.size()))});
+    glb.append<uint32_t>({uint32_t(json.size()), 0x4E4F534A});
+    glb.data.insert(glb.data.end(), json.begin(), json.end());
+    if (!bin.empty())
+    {
+        glb.append<uint32_t>({uint32_t(bin.size()), 0x004E4942});
+        glb.data.insert(glb.data.end(), bin.begin(), bin.end());
+    }
+    return glb.data;
+}
+
+std::unique_ptr<gltf::Document> load(const std::string& json)
+{
+    return gltf::Document::loadFromMemory(json.data(), json.size(), kPath);
+}
+
+std::vector<float> readFloats(const gltf::Document& document, uint32_t index, uint32_t componentCount)
+{
+    std::vector<float> values(document.getAccessor(index).count * componentCount);
+    document.readFloats(index, componentCount, values.data());
+    return values;
+}
+
+std::vector<uint32_t> readUints(const gltf::Document& document, uint32_t index)
+{
+    const gltf::Accessor& accessor = document.getAccessor(index);
+    std::vector<uint32_t> values(accessor.count * accessor.componentCount);
+    document.readUints(index, values.data());
+    return values;
+}
+} // namespace
+
+CPU_TEST(GLTFDocument_GlbChunks)
+{
+    BinaryBuffer bin;
+    bin.append<float>({0.f, 0.f, 0.f, 1.f, 0.f, 0.f, 0.f, 1.f, 0.f});
+    bin.append<uint32_t>({0, 1, 2});
+
+    const std::string json = R"({
+        "asset": {"version": "2.0"},
+        "buffers": [{"byteLength": 48}],
+        "bufferViews": [{"buffer": 0, "byteLength": 36}, {"buffer": 0, "byteOffset": 36, "byteLength": 12}],
+        "accessors": [
+            {"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3"},
+            {"bufferView": 1, "componentType": 5125, "count": 3, "type": "SCALAR"}
+        ]
+    })";
+
+    // Tightly packed data is referenced in place in the BIN chunk.
+    std::vector<uint8_t> glb = createGlb(json, bin.data);
+    auto pDocument = gltf::Document::loadFromMemory(glb.data(), glb.size(), "test.glb");
+    ASSERT_EQ(pDocument->getAccessorCount(), 2);
+    const float3* pPositions = pDocument->getTightData<float3>(0, gltf::ComponentType::Float, 3);
+    ASSERT(pPositions != nullptr);
+    EXPECT(reinterpret_cast<const uint8_t*>(pPositions) >= glb.data() && reinterpret_cast<const uint8_t*>(pPositions) < glb.data() + glb.size());
+    EXPECT(all(pPositions[1] == float3(1.f, 0.f, 0.f)));
+    EXPECT(readUints(*pDocument, 1) == std::vector<uint32_t>({0, 1, 2}));
+
+    // The tight data must match the requested layout.
+    EXPECT(pDocument->getTightData<float2>(0, gltf::ComponentType::Float, 2) == nullptr);
+    EXPECT(pDocument->getTightData<uint32_t>(0, gltf::ComponentType::UnsignedInt, 1) == nullptr);
+
+    // Malformed files.
+    std::vector<uint8_t> shortBin(bin.data.begin(), bin.data.begin() + 40);
+    std::vector<uint8_t> invalid = createGlb(json, shortBin);
+    EXPECT_THROW_AS(gltf::Document::loadFromMemory(invalid.data(), invalid.size(), "test.glb"), ImporterError);
+    invalid = createGlb(json, bin.data, 1);
+    EXPECT_THROW_AS(gltf::Document::loadFromMemory(invalid.data(), invalid.size(), "test.glb"), ImporterError);
+    invalid = createGlb(json, bin.data);
+    invalid[12 + 4] = 'X'; // Corrupt the JSON chunk type.
+    EXPECT_THROW_AS(gltf::Document::loadFromMemory(invalid.data(), invalid.size(), "test.glb"), ImporterError);
+    invalid = createGlb(json, bin.data);
+    invalid.resize(invalid.size() - 8); // Truncate the BIN chunk.
+    EXPECT_THROW_AS(gltf::Document::loadFromMemory(invalid.data(), invalid.size(), "test.glb"), ImporterError);
+}
+
+CPU_TEST(GLTFDocument_DataUri)
+{
+    BinaryBuffer bin;
+    bin.append<uint16_t>({0, 1, 2, 2, 3, 0});
+
+    const std::string json = fmt::format(R"({{
+        "asset": {{"version": "2.0"}},
+        "buffers": [{{"byteLength": 12, "uri": "{}"}}],
+        "bufferViews": [{{"buffer": 0, "byteLength": 12}}],
+        "accessors": [{{"bufferView": 0, "componentType": 5123, "count": 6, "type": "SCALAR"}}]
+    }})", createDataURI(bin.data));
+
+    auto pDocument = load(json);
+    EXPECT(pDocument->getTightData<uint32_t>(0, gltf::ComponentType::UnsignedInt, 1) == nullptr);
+    EXPECT(readUints(*pDocument, 0) == std::vector<uint32_t>({0, 1, 2, 2, 3, 0}));
+    auto [pData, size] = pDocument->getBufferViewData(0);
+    ASSERT_EQ(size, 12);
+    EXPECT(std::memcmp(pData, bin.data.data(), size) == 0);
+
+    // Data URIs must be base64 encoded and hold the whole buffer.
+    EXPECT_THROW_AS(load(R"({"asset": {"version": "2.0"}, "buffers": [{"byteLength": 4, "uri": "data:text/plain,abcd"}]})"), ImporterError);
+    EXPECT_THROW_AS(load(fmt::format(R"({{"asset": {{"version": "2.0"}}, "buffers": [{{"byteLength": 16, "uri": "{}"}}]}})", createDataURI(bin.data))), ImporterError);
+}
+
+CPU_TEST(GLTFDocument_StridedNormalizedAccessors)
+{
+    // Interleaved vertices: float3 position, normalized ubyte4 color, normalized short2 texCrd and padding (20 bytes).
+    BinaryBuffer bin;
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        bin.append<float>({float(i), 2.f * i, 3.f * i});
+        bin.append<uint8_t>({255, 0, uint8_t(51 * i), 255});
+        bin.append<int16_t>({32767, int16_t(i == 2 ? -32768 : 0)});
+    }
+    // Normalized bytes, tightly packed.
+    size_t byteOffset = bin.append<int8_t>({127, -127, -128, 0});
+
+    const std::string json = fmt::format(R"({{
+        "asset": {{"version": "2.0"}},
+        "buffers": [{{"byteLength": {0}, "uri": "{1}"}}],
+        "bufferViews": [{{"buffer": 0, "byteLength": 60, "byteStride": 20}}, {{"buffer": 0, "byteOffset": {2}, "byteLength": 4}}],
+        "accessors": [
+            {{"bufferView": 0, "componentType": 5126, "count": 3, "type": "VEC3"}},
+            {{"bufferView": 0, "byteOffset": 12, "componentType": 5121, "normalized": true, "count": 3, "type": "VEC4"}},
+            {{"bufferView": 0, "byteOffset": 16, "componentType": 5122, "normalized": true, "count": 3, "type": "VEC2"}},
+            {{"bufferView": 1, "componentType": 5120, "normalized": true, "count": 4, "type": "SCALAR"}}
+        ]
+    }})", bin.data.size(), createDataURI(bin.data), byteOffset);
+
+    auto pDocument = load(json);
+
+    // Strided data can't be used in place.
+    EXPECT(pDocument->getTightData<float3>(0, gltf::ComponentType::Float, 3) == nullptr);
+    gltf::AccessorView view = pDocument->getAccessorView(0);
+    EXPECT_EQ(view.stride, 20);
+    EXPECT_EQ(view.count, 3);
+
+    EXPECT(readFloats(*pDocument, 0, 3) == std::vector<float>({0.f, 0.f, 0.f, 1.f, 2.f, 3.f, 2.f, 4.f, 6.f}));
+    EXPECT(readFloats(*pDocument, 1, 4) == std::vector<float>({1.f, 0.f, 0.f, 1.f, 1.f, 0.f, 0.2f, 1.f, 1.f, 0.f, 0.4f, 1.f}));
+    EXPECT(readFloats(*pDocument, 2, 2) == std::vector<float>({1.f, 0.f, 1.f, 0.f, 1.f, -1.f}));
+    EXPECT(readFloats(*pDocument, 3, 1) == std::vector<float>({1.f, -1.f, -1.f, 0.f}));
+
+    // Missing components are zero, extra components are dropped.
+    EXPECT(readFloats(*pDocument, 0, 4) == std::vector<float>({0.f, 0.f, 0.f, 0.f, 1.f, 2.f, 3.f, 0.f, 2.f, 4.f, 6.f, 0.f}));
+    EXPECT(readFloats(*pDocument, 0, 1) == std::vector<float>({0.f, 1.f, 2.f}));
+
+    // Accessors must fit into their buffer view, including the stride.
+    const std::string outOfRange = fmt::format(R"({{
+        "asset": {{"version": "2.0"}},
+        "buffers": [{{"byteLength": {0}, "uri": "{1}"}}],
+        "bufferViews": [{{"buffer": 0, "byteLength": 60, "byteStride": 20}}],
+        "accessors": [{{"bufferView": 0, "byteOffset": 12, "componentType": 5126, "count": 3, "type": "VEC3"}}]
+    }})", bin.data.size(), createDataURI(bin.data));
+    EXPECT_THROW_AS(load(outOfRange), ImporterError);
+}
+
+CPU_TEST(GLTFDocument_SparseAccessors)
+{
+    BinaryBuffer bin;
+    size_t denseOffset = bin.append<float>({1.f, 2.f, 3.f, 4.f});
+    size_t indicesOffset = bin.append<uint8_t>({3, 1});
+    bin.align(4);
+    size_t valuesOffset = bin.append<float>({40.f, 20.f});
+    size_t badIndicesOffset = bin.append<uint8_t>({4});
+    bin.align(4);
+
+    const std::string json = fmt::format(R"({{
+        "asset": {{"version": "2.0"}},
+        "buffers": [{{"byteLength": {0}, "uri": "{1}"}}],
+        "bufferViews": [
+            {{"buffer": 0, "byteOffset": {2}, "byteLength": 16}},
+            {{"buffer": 0, "byteOffset": {3}, "byteLength": 2}},
+            {{"buffer": 0, "byteOffset": {4}, "byteLength": 8}},
+            {{"buffer": 0, "byteOffset": {5}, "byteLength": 1}}
+        ],
+        "accessors": [
+            {{"bufferView": 0, "componentType": 5126, "count": 4, "type": "SCALAR",
+              "sparse": {{"count": 2, "indices": {{"bufferView": 1, "componentType": 5121}}, "values": {{"bufferView": 2}}}}}},
+            {{"componentType": 5126, "count": 4, "type": "SCALAR",
+              "sparse": {{"count": 2, "indices": {{"bufferView": 1, "componentType": 5121}}, "values": {{"bufferView": 2}}}}}},
+            {{"componentType": 5126, "count": 4, "type": "SCALAR",
+              "sparse": {{"count": 1, "indices": {{"bufferView": 3, "componentType": 5121}}, "values": {{"bufferView": 2}}}}}}
+        ]
+    }})", bin.data.size(), createDataURI(bin.data), denseOffset, indicesOffset, valuesOffset, badIndicesOffset);
+
+    auto pDocument = load(json);
+
+    // Sparse values replace dense values, or zeros without a buffer view.
+    EXPECT(pDocument->getTightData<float>(0, gltf::ComponentType::Float, 1) == nullptr);
+    EXPECT(readFloats(*pDocument, 0, 1) == std::vector<float>({1.f, 20.f, 3.f, 40.f}));
+    EXPECT(pDocument->getAccessorView(1).pData == nullptr);
+    EXPECT(readFloats(*pDocument, 1, 1) == std::vector<float>({0.f, 20.f, 0.f, 40.f}));
+
+    // Sparse indices are checked when reading.
+    std::vector<float> values(4);
+    EXPECT_THROW_AS(pDocument->readFloats(2, 1, values.data()), ImporterError);
+
+    // Sparse indices must be integers.
+    const std::string floatIndices = fmt::format(R"({{
+        "asset": {{"version": "2.0"}},
+        "buffers": [{{"byteLength": {0}, "uri": "{1}"}}],
+        "bufferViews": [{{"buffer": 0, "byteOffset": {2}, "byteLength": 8}}],
+        "accessors": [{{"componentType": 5126, "count": 4, "type": "SCALAR",
+            "sparse": {{"count": 2, "indices": {{"bufferView": 0, "componentType": 5126}}, "values": {{"bufferView": 0}}}}}}]
+    }})", bin.data.size(), createDataURI(bin.data), valuesOffset);
+    EXPECT_THROW_AS(load(floatIndices), ImporterError);
+}
+
+CPU_TEST(GLTFDocument_Triangulate)
+{
+    const std::vector<uint32_t> indices = {0, 1, 2, 3, 4};
+    std::vector<uint32_t> triangles;
+
+    // Every other strip triangle is flipped to keep the winding of the first one.
+    gltf::triangulate(gltf::PrimitiveMode::TriangleStrip, indices.data(), 5, triangles);
+    EXPECT(triangles == std::vector<uint32_t>({0, 1, 2, 1, 3, 2, 2, 3, 4}));
+
+    // Fans keep the first vertex as the last vertex of every triangle.
+    gltf::triangulate(gltf::PrimitiveMode::TriangleFan, indices.data(), 5, triangles);
+    EXPECT(triangles == std::vector<uint32_t>({1, 2, 0, 2, 3, 0, 3, 4, 0}));
+
+    // Degenerate input yields no triangles.
+    gltf::triangulate(gltf::PrimitiveMode::TriangleStrip, indices.data(), 2, triangles);
+    EXPECT(triangles.empty());
+
+    EXPECT_THROW(gltf::triangulate(gltf::PrimitiveMode::Triangles, indices.data(), 3, triangles));
+}
+} // namespace Falcor
@@ -0,0 +1,103 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/GeometrySpillFile.h"
+
+#include <filesystem>
+#include <numeric>
+#include <vector>
+
+namespace Falcor
+{
+CPU_TEST(GeometrySpillFile_RoundTrip)
+{
+    std::filesystem::path path;
+    {
+        GeometrySpillFile file;
+        path = file.getPath();
+        EXPECT(std::filesystem::exists(path));
+
+        std::vector<uint32_t> a(1000);
+        std::iota(a.begin(), a.end(), 0u);
+        std::vector<float> b = {1.f, 2.f, 3.f};
+
+        auto rangeA = file.write(a);
+        auto rangeB = file.write(b);
+        auto rangeEmpty = file.write(std::vector<float>());
+        EXPECT_EQ(rangeA.offset, 0);
+        EXPECT_EQ(rangeA.size, a.size() * sizeof(uint32_t));
+        EXPECT_EQ(rangeB.offset, rangeA.size);
+        EXPECT_EQ(rangeEmpty.size, 0);
+        EXPECT_EQ(file.getSize(), rangeA.size + rangeB.size);
+
+        // Read back in reverse order and interleaved with writes.
+        std::vector<float> readB;
+        file.read(rangeB, readB);
+        EXPECT(readB == b);
+
+        std::vector<uint32_t> c(10, 7u);
+        auto rangeC = file.write(c);
+
+        std::vector<uint32_t> readA;
+        file.read(rangeA, readA);
+        EXPECT(readA == a);
+
+        std::vector<uint32_t> readC;
+        file.read(rangeC, readC);
+        EXPECT(readC == c);
+
+        // Read a part of a block.
+        uint32_t part[4];
+        file.read({rangeA.offset + 100 * sizeof(uint32_t), sizeof(part)}, part);
+        EXPECT_EQ(part[0], 100u);
+        EXPECT_EQ(part[3], 103u);
+
+        std::vector<float> readEmpty;
+        file.read(rangeEmpty, readEmpty);
+        EXPECT(readEmpty.empty());
+
+        EXPECT_EQ(file.getReadBytes(), rangeB.size + rangeA.size + rangeC.size + sizeof(part));
+    }
+
+    // The file is removed on destruction.
+    EXPECT(!std::filesystem::exists(path));
+}
+
+CPU_TEST(GeometrySpillFile_Directory)
+{
+    auto directory = std::filesystem::temp_directory_path();
+    GeometrySpillFile file(directory);
+    EXPECT(file.getPath().parent_path() == directory);
+
+    std::vector<uint64_t> data = {1, 2, 3};
+    auto range = file.write(data);
+    std::vector<uint64_t> readData;
+    file.read(range, readData);
+    EXPECT(readData == data);
+}
+} // namespace Falcor
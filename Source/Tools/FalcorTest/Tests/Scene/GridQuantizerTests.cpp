@@ -0,0 +1,131 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Volume/GridQuantizer.h"
+
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable : 4146 4244 4267 4275 4996 4456)
+#endif
+// See Grid.cpp for why this is needed.
+#define result_of invoke_result
+#include <nanovdb/util/Primitives.h>
+#undef result_of
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+
+namespace Falcor
+{
+namespace
+{
+nanovdb::GridHandle<nanovdb::HostBuffer> createTestGrid()
+{
+    // Fog volume sphere with values in [0, 1] and a smooth falloff over 4 voxels.
+    return nanovdb::createFogVolumeSphere<float>(20.f, nanovdb::Vec3f(0.f), 1.f, 4.f);
+}
+} // namespace
+
+CPU_TEST(GridQuantizer_FixedWidth)
+{
+    auto handle = createTestGrid();
+    const nanovdb::FloatGrid* pGrid = handle.grid<float>();
+    ASSERT(pGrid != nullptr);
+
+    for (GridFormat format : {GridFormat::Fp4, GridFormat::Fp8, GridFormat::Fp16})
+    {
+        auto result = GridQuantizer::quantize(*pGrid, format);
+        EXPECT_EQ(result.format, format);
+        EXPECT_EQ(GridQuantizer::getFormat(result.handle), format);
+        EXPECT_EQ(result.error.voxelCount, pGrid->activeVoxelCount());
+        EXPECT_LT(result.handle.size(), handle.size());
+
+        // Values are quantized relative to the per-leaf range, which is bounded by the grid's range.
+        const float quantum = result.error.valueRange / float((1u << GridQuantizer::getBitsPerVoxel(format)) - 1);
+        EXPECT_GT(result.error.valueRange, 0.f);
+        EXPECT_LE(result.error.maxAbsError, quantum) << fmt::format("format = {}", format);
+        EXPECT_LE(result.error.rmsError, result.error.maxAbsError);
+
+        // Re-measuring the returned grid must give the same result.
+        auto error = GridQuantizer::computeError(*pGrid, result.handle);
+        EXPECT_EQ(error.maxAbsError, result.error.maxAbsError);
+        EXPECT_EQ(error.voxelCount, result.error.voxelCount);
+    }
+}
+
+CPU_TEST(GridQuantizer_Widening)
+{
+    auto handle = createTestGrid();
+    const nanovdb::FloatGrid* pGrid = handle.grid<float>();
+    ASSERT(pGrid != nullptr);
+
+    // Fp4 cannot satisfy a tolerance below half of its quantization step, the conversion must pick a wider format.
+    const float tolerance = 1e-3f;
+    auto result = GridQuantizer::quantize(*pGrid, GridFormat::Fp4, tolerance);
+    EXPECT_NE(result.format, GridFormat::Fp4);
+    EXPECT_EQ(GridQuantizer::getFormat(result.handle), result.format);
+    EXPECT_LE(result.error.maxAbsError, tolerance);
+
+    // A zero tolerance disables widening.
+    auto unbounded = GridQuantizer::quantize(*pGrid, GridFormat::Fp4, 0.f);
+    EXPECT_EQ(unbounded.format, GridFormat::Fp4);
+    EXPECT_GT(unbounded.error.maxAbsError, tolerance);
+}
+
+CPU_TEST(GridQuantizer_FpN)
+{
+    auto handle = createTestGrid();
+    const nanovdb::FloatGrid* pGrid = handle.grid<float>();
+    ASSERT(pGrid != nullptr);
+
+    for (float tolerance : {1e-2f, 1e-3f, 1e-4f})
+    {
+        auto result = GridQuantizer::quantize(*pGrid, GridFormat::FpN, tolerance);
+        EXPECT_EQ(result.format, GridFormat::FpN);
+        EXPECT_EQ(GridQuantizer::getFormat(result.handle), GridFormat::FpN);
+        EXPECT_LE(result.error.maxAbsError, tolerance) << fmt::format("tolerance = {}", tolerance);
+    }
+
+    // Looser tolerances must not produce larger grids.
+    auto coarse = GridQuantizer::quantize(*pGrid, GridFormat::FpN, 1e-2f);
+    auto fine = GridQuantizer::quantize(*pGrid, GridFormat::FpN, 1e-4f);
+    EXPECT_LE(coarse.handle.size(), fine.handle.size());
+}
+
+CPU_TEST(GridQuantizer_Float)
+{
+    auto handle = createTestGrid();
+    const nanovdb::FloatGrid* pGrid = handle.grid<float>();
+    ASSERT(pGrid != nullptr);
+
+    auto result = GridQuantizer::quantize(*pGrid, GridFormat::Float);
+    EXPECT_EQ(result.format, GridFormat::Float);
+    EXPECT_EQ(result.error.maxAbsError, 0.f);
+    EXPECT_EQ(result.error.voxelCount, pGrid->activeVoxelCount());
+}
+} // namespace Falcor
@@ -0,0 +1,313 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Material/OpacityMicromapBaker.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <set>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+using Baker = OpacityMicromapBaker;
+
+struct TestMesh
+{
+    std::vector<float2> texCrds;
+    std::vector<uint32_t> indices;
+};
+
+void addTriangle(TestMesh& mesh, float2 uv0, float2 uv1, float2 uv2)
+{
+    uint32_t base = (uint32_t)mesh.texCrds.size();
+    mesh.texCrds.insert(mesh.texCrds.end(), { uv0, uv1, uv2 });
+    mesh.indices.insert(mesh.indices.end(), { base, base + 1, base + 2 });
+}
+
+Baker::AlphaMap createAlphaMap(uint32_t width, uint32_t height, uint8_t (*func)(uint32_t x, uint32_t y))
+{
+    std::vector<uint8_t> alpha(size_t(width) * height);
+    for (uint32_t y = 0; y < height; y++)
+        for (uint32_t x = 0; x < width; x++)
+            alpha[size_t(y) * width + x] = func(x, y);
+    return Baker::AlphaMap(width, height, std::move(alpha));
+}
+
+/// Bilinear alpha lookup with wrap or clamp addressing.
+float sampleAlpha(const Baker::AlphaMap& alphaMap, float2 uv, bool clampAddressing)
+{
+    const int width = (int)alphaMap.getWidth(), height = (int)alphaMap.getHeight();
+    auto texel = [&](int x, int y)
+    {
+        if (clampAddressing)
+        {
+            x = std::clamp(x, 0, width - 1);
+            y = std::clamp(y, 0, height - 1);
+        }
+        else
+        {
+            x = ((x % width) + width) % width;
+            y = ((y % height) + height) % height;
+        }
+        return alphaMap.getAlpha(x, y) / 255.f;
+    };
+
+    float2 p = uv * float2((float)width, (float)height) - 0.5f;
+    int x = (int)std::floor(p.x), y = (int)std::floor(p.y);
+    float fx = p.x - x, fy = p.y - y;
+    float a0 = texel(x, y) * (1.f - fx) + texel(x + 1, y) * fx;
+    float a1 = texel(x, y + 1) * (1.f - fx) + texel(x + 1, y + 1) * fx;
+    return a0 * (1.f - fy) + a1 * fy;
+}
+
+/// Checks that the known states agree with bilinear alpha tests at random points in each triangle.
+void validateConservative(CPUUnitTestContext& ctx, const Baker::AlphaMap& alphaMap, const TestMesh& mesh, const Baker::Result& result, const OpacityMicromapSettings& settings)
+{
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+    const uint32_t triangleCount = (uint32_t)mesh.indices.size() / 3;
+    uint32_t errorCount = 0;
+
+    for (uint32_t t = 0; t < triangleCount; t++)
+    {
+        int32_t index = result.indices[t];
+        uint32_t level = index >= 0 ? result.micromaps[index].subdivisionLevel : 0;
+
+        for (uint32_t s = 0; s < 256; s++)
+        {
+            float2 b(dist(rng), dist(rng));
+            if (b.x + b.y > 1.f) b = float2(1.f) - b;
+            float2 uv = mesh.texCrds[mesh.indices[3 * t]] * (1.f - b.x - b.y) + mesh.texCrds[mesh.indices[3 * t + 1]] * b.x + mesh.texCrds[mesh.indices[3 * t + 2]] * b.y;
+
+            OpacityState state = result.getState(t, Baker::getMicroTriangleIndex(b, level));
+            bool opaque = sampleAlpha(alphaMap, uv, settings.addressingMode == TextureAddressingMode::Clamp) >= settings.alphaThreshold;
+            if (state == OpacityState::Opaque && !opaque) errorCount++;
+            if (state == OpacityState::Transparent && opaque) errorCount++;
+        }
+    }
+    EXPECT_EQ(errorCount, 0u);
+}
+}
+
+CPU_TEST(OpacityMicromapBaker_BirdCurve)
+{
+    for (uint32_t level = 0; level <= 6; level++)
+    {
+        const uint32_t n = 1u << level;
+
+        // Collect the vertices of each micro-triangle by index.
+        std::vector<std::array<uint3, 3>> vertices(size_t(n) * n);
+        std::vector<bool> isSet(vertices.size(), false);
+        auto add = [&](uint32_t u, uint32_t v, uint32_t w, std::array<uint3, 3> tri)
+        {
+            uint32_t index = Baker::getMicroTriangleIndex(u, v, w, level);
+            ASSERT_LT(index, n * n);
+            EXPECT(!isSet[index]);
+            isSet[index] = true;
+            vertices[index] = tri;
+
+            // The micro-triangle containing the centroid must have the same index.
+            float2 centroid = float2((float)(tri[0].x + tri[1].x + tri[2].x), (float)(tri[0].y + tri[1].y + tri[2].y)) / (3.f * n);
+            EXPECT_EQ(Baker::getMicroTriangleIndex(centroid, level), index);
+        };
+        for (uint32_t u = 0; u < n; u++)
+        {
+            for (uint32_t v = 0; u + v < n; v++)
+            {
+                uint32_t w = n - 1 - u - v;
+                add(u, v, w, { uint3(u + 1, v, w), uint3(u, v + 1, w), uint3(u, v, w + 1) });
+                if (w > 0) add(u, v, w - 1, { uint3(u + 1, v + 1, w - 1), uint3(u + 1, v, w), uint3(u, v + 1, w) });
+            }
+        }
+        EXPECT(std::all_of(isSet.begin(), isSet.end(), [](bool b) { return b; }));
+
+        // The bird curve is continuous, so consecutive micro-triangles share at least one vertex.
+        for (uint32_t i = 1; i < n * n; i++)
+        {
+            uint32_t shared = 0;
+            for (const auto& a : vertices[i - 1])
+                for (const auto& b : vertices[i])
+                    if (all(a == b)) shared++;
+            EXPECT_GE(shared, 1u);
+        }
+    }
+}
+
+CPU_TEST(OpacityMicromapBaker_Uniform)
+{
+    TestMesh mesh;
+    addTriangle(mesh, float2(0.1f, 0.1f), float2(0.9f, 0.1f), float2(0.5f, 0.9f));
+    addTriangle(mesh, float2(-2.f, 0.f), float2(3.f, 0.f), float2(0.f, 5.f));
+
+    Baker baker;
+    auto opaque = createAlphaMap(32, 32, [](uint32_t, uint32_t) -> uint8_t { return 200; });
+    auto pOpaque = baker.bake(opaque, mesh.texCrds, mesh.indices);
+    auto transparent = createAlphaMap(32, 32, [](uint32_t, uint32_t) -> uint8_t { return 20; });
+    auto pTransparent = baker.bake(transparent, mesh.texCrds, mesh.indices);
+
+    for (uint32_t t = 0; t < 2; t++)
+    {
+        EXPECT_EQ(pOpaque->indices[t], Baker::kFullyOpaque);
+        EXPECT(pOpaque->triangleOpacity[t] == TriangleOpacity::Opaque);
+        EXPECT(pOpaque->getState(t, 0) == OpacityState::Opaque);
+        EXPECT_EQ(pTransparent->indices[t], Baker::kFullyTransparent);
+        EXPECT(pTransparent->triangleOpacity[t] == TriangleOpacity::Transparent);
+    }
+    EXPECT(pOpaque->micromaps.empty() && pOpaque->data.empty());
+    EXPECT(pTransparent->micromaps.empty() && pTransparent->data.empty());
+    EXPECT_EQ(pOpaque->unknownMicroTriangleCount, 0ull);
+}
+
+CPU_TEST(OpacityMicromapBaker_Edge)
+{
+    // Opaque left half. The boundary is at u = 0.5.
+    auto alphaMap = createAlphaMap(64, 64, [](uint32_t x, uint32_t) -> uint8_t { return x < 32 ? 255 : 0; });
+
+    // Many identical triangles straddling the boundary, and a quad covering the whole texture.
+    TestMesh mesh;
+    for (uint32_t i = 0; i < 100; i++) addTriangle(mesh, float2(0.25f, 0.25f), float2(0.75f, 0.25f), float2(0.25f, 0.75f));
+    addTriangle(mesh, float2(0.f, 0.f), float2(1.f, 0.f), float2(0.f, 1.f));
+    addTriangle(mesh, float2(1.f, 0.f), float2(1.f, 1.f), float2(0.f, 1.f));
+
+    OpacityMicromapSettings settings;
+    settings.maxSubdivisionLevel = 5;
+    settings.texelsPerMicroTriangle = 0.f;
+    Baker baker(settings);
+    auto pResult = baker.bake(alphaMap, mesh.texCrds, mesh.indices);
+
+    // The identical triangles share one micromap.
+    EXPECT_EQ(pResult->micromaps.size(), 3u);
+    for (uint32_t t = 1; t < 100; t++) EXPECT_EQ(pResult->indices[t], pResult->indices[0]);
+    for (uint32_t t = 0; t < 102; t++) EXPECT(pResult->triangleOpacity[t] == TriangleOpacity::Unknown);
+    EXPECT_EQ(pResult->data.size(), 3u * 256u);
+
+    // Only micro-triangles near the boundary and at the wrapped texture border are unknown.
+    EXPECT_EQ(pResult->microTriangleCount, 102ull * 1024ull);
+    EXPECT_LT(pResult->unknownMicroTriangleCount, pResult->microTriangleCount / 8);
+
+    validateConservative(ctx, alphaMap, mesh, *pResult, settings);
+}
+
+CPU_TEST(OpacityMicromapBaker_Random)
+{
+    std::mt19937 rng(1);
+    std::uniform_real_distribution<float> dist(-1.5f, 2.5f);
+    std::uniform_real_distribution<float> offset(-0.2f, 0.2f);
+
+    // Diagonal bands of opaque blocks.
+    auto alphaMap = createAlphaMap(64, 64, [](uint32_t x, uint32_t y) -> uint8_t { return (x / 16 + y / 16) % 3 == 0 ? 255 : 0; });
+
+    TestMesh mesh;
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        float2 uv0(dist(rng), dist(rng));
+        addTriangle(mesh, uv0, uv0 + float2(offset(rng), offset(rng)), uv0 + float2(offset(rng), offset(rng)));
+    }
+
+    for (auto addressingMode : { TextureAddressingMode::Wrap, TextureAddressingMode::Clamp })
+    {
+        OpacityMicromapSettings settings;
+        settings.alphaThreshold = 0.3f;
+        settings.addressingMode = addressingMode;
+        Baker baker(settings);
+        auto pResult = baker.bake(alphaMap, mesh.texCrds, mesh.indices);
+
+        for (const auto& micromap : pResult->micromaps) EXPECT_LE(micromap.subdivisionLevel, settings.maxSubdivisionLevel);
+        EXPECT_LT(pResult->unknownMicroTriangleCount, pResult->microTriangleCount / 2);
+        validateConservative(ctx, alphaMap, mesh, *pResult, settings);
+    }
+}
+
+CPU_TEST(OpacityMicromapBaker_SubdivisionLevel)
+{
+    auto alphaMap = createAlphaMap(256, 256, [](uint32_t x, uint32_t y) -> uint8_t { return (x ^ y) & 1 ? 255 : 0; });
+
+    TestMesh mesh;
+    addTriangle(mesh, float2(0.f, 0.f), float2(1.f, 0.f), float2(0.f, 1.f));
+    addTriangle(mesh, float2(0.f, 0.f), float2(0.05f, 0.f), float2(0.f, 0.05f));
+
+    OpacityMicromapSettings settings;
+    settings.maxSubdivisionLevel = 12;
+    settings.texelsPerMicroTriangle = 4.f;
+    Baker baker(settings);
+    auto pResult = baker.bake(alphaMap, mesh.texCrds, mesh.indices);
+
+    // 32768 texels need level 7 to get to 2 texels per micro-triangle, and 82 texels need level 3.
+    // The checkerboard makes every micro-triangle unknown.
+    EXPECT_EQ(pResult->microTriangleCount, (1ull << 14) + (1ull << 6));
+    EXPECT_EQ(pResult->unknownMicroTriangleCount, pResult->microTriangleCount);
+    EXPECT(pResult->triangleOpacity[0] == TriangleOpacity::Unknown);
+}
+
+CPU_TEST(OpacityMicromapBaker_Cache)
+{
+    TestMesh mesh;
+    addTriangle(mesh, float2(0.f, 0.f), float2(1.f, 0.f), float2(0.f, 1.f));
+    auto alphaMapA = createAlphaMap(16, 16, [](uint32_t x, uint32_t) -> uint8_t { return x < 8 ? 255 : 0; });
+    auto alphaMapB = createAlphaMap(16, 16, [](uint32_t, uint32_t y) -> uint8_t { return y < 8 ? 255 : 0; });
+
+    Baker baker;
+    auto pA = baker.bake(alphaMapA, mesh.texCrds, mesh.indices);
+    EXPECT_EQ(baker.bake(alphaMapA, mesh.texCrds, mesh.indices).get(), pA.get());
+    EXPECT_EQ(baker.getCacheSize(), 1u);
+
+    auto pB = baker.bake(alphaMapB, mesh.texCrds, mesh.indices);
+    EXPECT_NE(pB.get(), pA.get());
+    EXPECT_EQ(baker.getCacheSize(), 2u);
+
+    mesh.texCrds[1] = float2(0.5f, 0.f);
+    baker.bake(alphaMapA, mesh.texCrds, mesh.indices);
+    EXPECT_EQ(baker.getCacheSize(), 3u);
+
+    baker.clearCache();
+    EXPECT_EQ(baker.getCacheSize(), 0u);
+}
+
+CPU_TEST(OpacityMicromapBaker_Invalid)
+{
+    TestMesh mesh;
+    addTriangle(mesh, float2(0.f), float2(1.f, 0.f), float2(0.f, 1.f));
+    auto alphaMap = createAlphaMap(4, 4, [](uint32_t, uint32_t) -> uint8_t { return 0; });
+    Baker baker;
+
+    std::vector<uint32_t> badCount = { 0, 1 };
+    EXPECT_THROW(baker.bake(alphaMap, mesh.texCrds, badCount));
+    std::vector<uint32_t> badIndex = { 0, 1, 3 };
+    EXPECT_THROW(baker.bake(alphaMap, mesh.texCrds, badIndex));
+    std::vector<uint8_t> badAlpha(10);
+    EXPECT_THROW(Baker::AlphaMap(4, 4, badAlpha));
+    OpacityMicromapSettings badSettings;
+    badSettings.maxSubdivisionLevel = 13;
+    EXPECT_THROW(Baker baker2(badSettings));
+}
+}
@@ -0,0 +1,276 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/MeshLOD.h"
+#include "Scene/MeshSimplifier.h"
+
+#include <cmath>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+struct TestMesh
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+};
+
+/// Grid in the xy-plane over [0,1]^2 with heights given by a function.
+/// If seam is true, the vertices in the center column are duplicated, as for a texture coordinate seam.
+template<typename F>
+TestMesh createGrid(uint32_t size, F height, bool seam)
+{
+    TestMesh mesh;
+    const uint32_t mid = size / 2;
+    std::vector<uint32_t> left((size + 1) * (size + 1)), right((size + 1) * (size + 1));
+    for (uint32_t y = 0; y <= size; y++)
+    {
+        for (uint32_t x = 0; x <= size; x++)
+        {
+            const float u = (float)x / size, v = (float)y / size;
+            const uint32_t i = y * (size + 1) + x;
+            left[i] = right[i] = (uint32_t)mesh.positions.size();
+            mesh.positions.push_back(float3(u, v, height(u, v)));
+            if (seam && x == mid)
+            {
+                right[i] = (uint32_t)mesh.positions.size();
+                mesh.positions.push_back(mesh.positions.back());
+            }
+        }
+    }
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            const auto& m = x < mid ? left : right;
+            const uint32_t i00 = m[y * (size + 1) + x], i10 = m[y * (size + 1) + x + 1];
+            const uint32_t i01 = m[(y + 1) * (size + 1) + x], i11 = m[(y + 1) * (size + 1) + x + 1];
+            mesh.indices.insert(mesh.indices.end(), { i00, i10, i11, i00, i11, i01 });
+        }
+    }
+    return mesh;
+}
+
+/// Closed UV sphere with the poles and the longitude seam welded.
+TestMesh createSphere(uint32_t rings, uint32_t segments)
+{
+    TestMesh mesh;
+    mesh.positions.push_back(float3(0.f, 1.f, 0.f));
+    for (uint32_t r = 1; r < rings; r++)
+    {
+        const float theta = (float)M_PI * r / rings;
+        for (uint32_t s = 0; s < segments; s++)
+        {
+            const float phi = 2.f * (float)M_PI * s / segments;
+            mesh.positions.push_back(float3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)));
+        }
+    }
+    mesh.positions.push_back(float3(0.f, -1.f, 0.f));
+    const uint32_t bottom = (uint32_t)mesh.positions.size() - 1;
+    auto ring = [&](uint32_t r, uint32_t s) { return 1 + (r - 1) * segments + s % segments; };
+    for (uint32_t s = 0; s < segments; s++)
+    {
+        mesh.indices.insert(mesh.indices.end(), { 0, ring(1, s + 1), ring(1, s) });
+        mesh.indices.insert(mesh.indices.end(), { bottom, ring(rings - 1, s), ring(rings - 1, s + 1) });
+        for (uint32_t r = 1; r + 1 < rings; r++)
+        {
+            mesh.indices.insert(mesh.indices.end(), { ring(r, s), ring(r, s + 1), ring(r + 1, s + 1) });
+            mesh.indices.insert(mesh.indices.end(), { ring(r, s), ring(r + 1, s + 1), ring(r + 1, s) });
+        }
+    }
+    return mesh;
+}
+
+float3 triangleNormal(const TestMesh& mesh, const std::vector<uint32_t>& indices, size_t t)
+{
+    const float3 p0 = mesh.positions[indices[3 * t]];
+    return cross(mesh.positions[indices[3 * t + 1]] - p0, mesh.positions[indices[3 * t + 2]] - p0);
+}
+
+float projectedArea(const TestMesh& mesh, const std::vector<uint32_t>& indices)
+{
+    float area = 0.f;
+    for (size_t t = 0; t < indices.size() / 3; t++) area += 0.5f * triangleNormal(mesh, indices, t).z;
+    return area;
+}
+} // namespace
+
+CPU_TEST(MeshSimplifier_FlatGrid)
+{
+    TestMesh mesh = createGrid(32, [](float, float) { return 0.f; }, false);
+    MeshSimplifier simplifier(mesh.positions, mesh.indices);
+    EXPECT_EQ(simplifier.getTriangleCount(), 2048u);
+
+    // A flat grid with straight borders simplifies without error.
+    uint32_t count = simplifier.simplify(64);
+    EXPECT_LE(count, 64u);
+    EXPECT_LE(simplifier.getError(), 1e-5f);
+
+    // The covered area is unchanged and no triangles are flipped.
+    std::vector<uint32_t> indices = simplifier.getIndices();
+    EXPECT_EQ(indices.size(), 3 * (size_t)count);
+    EXPECT(std::abs(projectedArea(mesh, indices) - 1.f) < 1e-4f);
+    for (size_t t = 0; t < indices.size() / 3; t++) EXPECT_GT(triangleNormal(mesh, indices, t).z, 0.f);
+}
+
+CPU_TEST(MeshSimplifier_Seam)
+{
+    const uint32_t size = 32;
+    TestMesh mesh = createGrid(size, [](float u, float v) { return 0.05f * std::sin(6.f * u) * std::cos(5.f * v); }, true);
+    MeshSimplifier simplifier(mesh.positions, mesh.indices);
+    simplifier.simplify(128);
+    EXPECT_LE(simplifier.getTriangleCount(), 256u);
+
+    // Triangles may only reference vertices on their side of the seam, and seam vertices must stay on the seam.
+    // Left side vertices are the ones created first in each grid row.
+    std::vector<int> side(mesh.positions.size(), 0);
+    for (uint32_t i = 0; i < (uint32_t)mesh.positions.size(); i++)
+    {
+        const float x = mesh.positions[i].x;
+        side[i] = x < 0.5f ? -1 : x > 0.5f ? 1 : (i > 0 && mesh.positions[i - 1].x == 0.5f) ? 1 : -1;
+    }
+    std::vector<uint32_t> indices = simplifier.getIndices();
+    for (size_t t = 0; t < indices.size() / 3; t++)
+    {
+        const int s0 = side[indices[3 * t]], s1 = side[indices[3 * t + 1]], s2 = side[indices[3 * t + 2]];
+        EXPECT(s0 == s1 && s1 == s2);
+        const float cx = (mesh.positions[indices[3 * t]].x + mesh.positions[indices[3 * t + 1]].x + mesh.positions[indices[3 * t + 2]].x) / 3.f;
+        EXPECT(s0 < 0 ? cx < 0.5f : cx > 0.5f);
+    }
+
+    // The seam must not open up and the borders must not move.
+    EXPECT(std::abs(projectedArea(mesh, indices) - 1.f) < 1e-4f);
+}
+
+CPU_TEST(MeshSimplifier_ClosedMesh)
+{
+    TestMesh mesh = createSphere(32, 64);
+    MeshSimplifier simplifier(mesh.positions, mesh.indices);
+    const uint32_t count = simplifier.simplify(200);
+    EXPECT_LE(count, 200u);
+
+    // The result must be a closed two-manifold of genus zero.
+    std::vector<uint32_t> indices = simplifier.getIndices();
+    std::set<std::pair<uint32_t, uint32_t>> edges;
+    std::set<uint32_t> vertices;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        for (size_t k = 0; k < 3; k++)
+        {
+            EXPECT(edges.insert({ indices[i + k], indices[i + (k + 1) % 3] }).second);
+            vertices.insert(indices[i + k]);
+        }
+    }
+    for (const auto& [a, b] : edges) EXPECT(edges.count({ b, a }) == 1);
+    EXPECT_EQ((int)vertices.size() - (int)edges.size() / 2 + (int)count, 2);
+
+    // All triangles face outwards.
+    for (size_t t = 0; t < indices.size() / 3; t++)
+    {
+        const float3 c = mesh.positions[indices[3 * t]] + mesh.positions[indices[3 * t + 1]] + mesh.positions[indices[3 * t + 2]];
+        EXPECT_GT(dot(triangleNormal(mesh, indices, t), c), 0.f);
+    }
+    EXPECT_GT(simplifier.getError(), 0.f);
+    EXPECT_LT(simplifier.getError(), 0.1f);
+}
+
+CPU_TEST(MeshSimplifier_ErrorBound)
+{
+    TestMesh mesh = createGrid(64, [](float u, float v) { return 0.1f * std::sin(12.f * u) * std::sin(9.f * v); }, false);
+    MeshSimplifier simplifier(mesh.positions, mesh.indices);
+
+    // The error bound stops simplification before the target is reached.
+    const float maxError = 1e-3f;
+    const uint32_t count = simplifier.simplify(2, maxError);
+    EXPECT_GT(count, 2u);
+    EXPECT_LE(simplifier.getError(), maxError);
+
+    // Simplification continues when the bound is relaxed.
+    const uint32_t count2 = simplifier.simplify(2, 1e-2f);
+    EXPECT_LT(count2, count);
+    EXPECT_LE(simplifier.getError(), 1e-2f);
+}
+
+CPU_TEST(MeshLOD_Chain)
+{
+    TestMesh mesh = createSphere(48, 96);
+    MeshLODSettings settings;
+    settings.maxLevelCount = 5;
+    settings.maxRelativeError = 0.05f;
+    MeshLODChain chain = generateMeshLODChain(mesh.positions, mesh.indices, settings);
+
+    ASSERT_EQ(chain.levels.size(), 5u);
+    ASSERT_EQ(chain.indices.size(), 5u);
+    EXPECT_EQ(chain.levels[0].triangleCount, (uint32_t)mesh.indices.size() / 3);
+    EXPECT_EQ(chain.levels[0].error, 0.f);
+    for (size_t i = 1; i < chain.levels.size(); i++)
+    {
+        EXPECT_EQ(chain.indices[i].size(), 3 * (size_t)chain.levels[i].triangleCount);
+        EXPECT_LE(chain.levels[i].triangleCount, chain.levels[i - 1].triangleCount / 2);
+        EXPECT_GE(chain.levels[i].error, chain.levels[i - 1].error);
+        EXPECT_LE(chain.levels[i].error, settings.maxRelativeError * 2.f * std::sqrt(3.f));
+    }
+
+    // Small meshes are not simplified.
+    settings.minTriangleCount = (uint32_t)mesh.indices.size() / 3;
+    EXPECT_EQ(generateMeshLODChain(mesh.positions, mesh.indices, settings).levels.size(), 1u);
+}
+
+CPU_TEST(MeshLOD_Selection)
+{
+    // 90 degree field of view with 1000 pixels gives 500 pixels per unit at unit distance.
+    MeshLODSelector selector((float)M_PI / 2.f, 1000, 1.f);
+    EXPECT(std::abs(selector.getProjectedError(0.01f, 10.f) - 0.5f) < 1e-5f);
+    EXPECT_EQ(selector.getProjectedError(0.f, 0.f), 0.f);
+
+    const std::vector<MeshLODLevel> levels = { { 1000, 0.f }, { 500, 0.001f }, { 250, 0.01f }, { 125, 0.1f } };
+    EXPECT_EQ(selector.selectLevel(levels, 0.f, 1.f), 0u);
+    EXPECT_EQ(selector.selectLevel(levels, 0.1f, 1.f), 0u);
+    EXPECT_EQ(selector.selectLevel(levels, 1.f, 1.f), 1u);
+    EXPECT_EQ(selector.selectLevel(levels, 10.f, 1.f), 2u);
+    EXPECT_EQ(selector.selectLevel(levels, 100.f, 1.f), 3u);
+    EXPECT_EQ(selector.selectLevel(levels, 10.f, 10.f), 1u);
+
+    AABB bounds(float3(-1.f), float3(1.f));
+    EXPECT_EQ(MeshLODSelector::getDistance(bounds, float3(0.5f)), 0.f);
+    EXPECT(std::abs(MeshLODSelector::getDistance(bounds, float3(4.f, 5.f, 0.f)) - 5.f) < 1e-5f);
+}
+
+CPU_TEST(MeshSimplifier_InvalidInput)
+{
+    std::vector<float3> positions = { float3(0.f), float3(1.f, 0.f, 0.f), float3(0.f, 1.f, 0.f) };
+    std::vector<uint32_t> indices = { 0, 1 };
+    EXPECT_THROW(MeshSimplifier simplifier(positions, indices));
+    indices = { 0, 1, 3 };
+    EXPECT_THROW(MeshSimplifier simplifier(positions, indices));
+}
+} // namespace Falcor
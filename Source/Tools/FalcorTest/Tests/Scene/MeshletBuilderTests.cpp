@@ -0,0 +1,227 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/MeshletBuilder.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+struct TestMesh
+{
+    std::vector<float3> positions;
+    std::vector<uint32_t> indices;
+};
+
+/// Closed UV sphere with counter-clockwise front faces when seen from the outside.
+TestMesh createSphere(uint32_t rings, uint32_t segments)
+{
+    TestMesh mesh;
+    for (uint32_t r = 0; r <= rings; r++)
+    {
+        const float theta = (float)M_PI * r / rings;
+        for (uint32_t s = 0; s < segments; s++)
+        {
+            const float phi = 2.f * (float)M_PI * s / segments;
+            mesh.positions.push_back(float3(std::sin(theta) * std::cos(phi), std::cos(theta), -std::sin(theta) * std::sin(phi)));
+        }
+    }
+    auto vertex = [&](uint32_t r, uint32_t s) { return r * segments + s % segments; };
+    for (uint32_t r = 0; r < rings; r++)
+    {
+        for (uint32_t s = 0; s < segments; s++)
+        {
+            if (r > 0) mesh.indices.insert(mesh.indices.end(), { vertex(r, s), vertex(r + 1, s), vertex(r, s + 1) });
+            if (r + 1 < rings) mesh.indices.insert(mesh.indices.end(), { vertex(r, s + 1), vertex(r + 1, s), vertex(r + 1, s + 1) });
+        }
+    }
+    return mesh;
+}
+
+/// Flat grid in the xy-plane with the triangles in random order.
+TestMesh createShuffledGrid(uint32_t size, std::mt19937& rng)
+{
+    TestMesh mesh;
+    for (uint32_t y = 0; y <= size; y++)
+        for (uint32_t x = 0; x <= size; x++)
+            mesh.positions.push_back(float3((float)x, (float)y, 0.f));
+
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            const uint32_t i = y * (size + 1) + x;
+            triangles.push_back({ i, i + 1, i + size + 2 });
+            triangles.push_back({ i, i + size + 2, i + size + 1 });
+        }
+    }
+    std::shuffle(triangles.begin(), triangles.end(), rng);
+    for (const auto& t : triangles) mesh.indices.insert(mesh.indices.end(), t.begin(), t.end());
+    return mesh;
+}
+
+/// Check that the meshlets cover every triangle exactly once, respect the limits and bound their vertices.
+void validateMeshlets(CPUUnitTestContext& ctx, const TestMesh& mesh, const MeshletBuilder::Result& result, uint32_t maxVertexCount, uint32_t maxTriangleCount)
+{
+    std::vector<std::array<uint32_t, 3>> expected, actual;
+    for (size_t i = 0; i < mesh.indices.size(); i += 3) expected.push_back({ mesh.indices[i], mesh.indices[i + 1], mesh.indices[i + 2] });
+
+    for (const auto& meshlet : result.meshlets)
+    {
+        EXPECT_GE(meshlet.vertexCount, 3u);
+        EXPECT_LE(meshlet.vertexCount, maxVertexCount);
+        EXPECT_GE(meshlet.triangleCount, 1u);
+        EXPECT_LE(meshlet.triangleCount, maxTriangleCount);
+        ASSERT_LE((size_t)meshlet.vertexOffset + meshlet.vertexCount, result.vertices.size());
+        ASSERT_LE((size_t)meshlet.triangleOffset + meshlet.triangleCount, result.triangles.size());
+
+        for (uint32_t i = 0; i < meshlet.vertexCount; i++)
+        {
+            const float3 d = mesh.positions[result.vertices[meshlet.vertexOffset + i]] - meshlet.center;
+            EXPECT_LE(length(d), meshlet.radius * (1.f + 1e-5f) + 1e-6f);
+        }
+        for (uint32_t i = 0; i < meshlet.triangleCount; i++)
+        {
+            const uint3 t = MeshletBuilder::unpackTriangle(result.triangles[meshlet.triangleOffset + i]);
+            ASSERT(t.x < meshlet.vertexCount && t.y < meshlet.vertexCount && t.z < meshlet.vertexCount);
+            const uint32_t* v = &result.vertices[meshlet.vertexOffset];
+            actual.push_back({ v[t.x], v[t.y], v[t.z] });
+        }
+    }
+
+    std::sort(expected.begin(), expected.end());
+    std::sort(actual.begin(), actual.end());
+    EXPECT(expected == actual);
+}
+} // namespace
+
+CPU_TEST(MeshletBuilder_Sphere)
+{
+    TestMesh mesh = createSphere(64, 128);
+    MeshletBuilder::Result result = MeshletBuilder::build(mesh.positions, mesh.indices);
+    validateMeshlets(ctx, mesh, result, MeshletBuilder::kMaxVertexCount, MeshletBuilder::kMaxTriangleCount);
+
+    // Meshlets on a smooth surface should be nearly full and share most of their vertices.
+    const size_t triangleCount = mesh.indices.size() / 3;
+    EXPECT_LE(result.meshlets.size(), triangleCount / 80);
+    EXPECT_LE(result.vertices.size(), triangleCount * 3 / 4);
+}
+
+CPU_TEST(MeshletBuilder_Locality)
+{
+    // Seeding in spatial order gives compact meshlets even if the triangle order is random.
+    std::mt19937 rng(42);
+    TestMesh mesh = createShuffledGrid(100, rng);
+    MeshletBuilder::Result result = MeshletBuilder::build(mesh.positions, mesh.indices);
+    validateMeshlets(ctx, mesh, result, MeshletBuilder::kMaxVertexCount, MeshletBuilder::kMaxTriangleCount);
+
+    const size_t triangleCount = mesh.indices.size() / 3;
+    EXPECT_LE(result.vertices.size(), triangleCount * 3 / 4);
+    float averageRadius = 0.f;
+    for (const auto& meshlet : result.meshlets) averageRadius += meshlet.radius;
+    averageRadius /= (float)result.meshlets.size();
+    EXPECT_LT(averageRadius, 8.f);
+}
+
+CPU_TEST(MeshletBuilder_Limits)
+{
+    TestMesh mesh = createSphere(16, 32);
+    for (auto [maxVertexCount, maxTriangleCount] : { std::pair<uint32_t, uint32_t>{ 3, 1 }, { 16, 64 }, { 256, 16 }, { 256, 512 } })
+    {
+        MeshletBuilder::Result result = MeshletBuilder::build(mesh.positions, mesh.indices, maxVertexCount, maxTriangleCount);
+        validateMeshlets(ctx, mesh, result, maxVertexCount, maxTriangleCount);
+    }
+}
+
+CPU_TEST(MeshletBuilder_NormalCone)
+{
+    // Any meshlet the normal cone test culls must only have backfacing triangles.
+    // Test both a sphere and an inverted sphere, where the cone apex has to be moved back behind the surface.
+    for (bool inverted : { false, true })
+    {
+        TestMesh mesh = createSphere(32, 64);
+        if (inverted)
+        {
+            for (size_t i = 0; i < mesh.indices.size(); i += 3) std::swap(mesh.indices[i + 1], mesh.indices[i + 2]);
+        }
+        MeshletBuilder::Result result = MeshletBuilder::build(mesh.positions, mesh.indices);
+
+        std::mt19937 rng(1);
+        std::uniform_real_distribution<float> u(-1.f, 1.f);
+        size_t culledCount = 0;
+        for (uint32_t i = 0; i < 64; i++)
+        {
+            const float3 viewPos = normalize(float3(u(rng), u(rng), u(rng))) * (1.01f + 4.f * (i / 64.f) * (i / 64.f));
+            for (const auto& meshlet : result.meshlets)
+            {
+                if (!meshlet.isBackfacing(viewPos)) continue;
+                culledCount++;
+                for (uint32_t j = 0; j < meshlet.triangleCount; j++)
+                {
+                    const uint3 t = MeshletBuilder::unpackTriangle(result.triangles[meshlet.triangleOffset + j]);
+                    const uint32_t* v = &result.vertices[meshlet.vertexOffset];
+                    const float3 p0 = mesh.positions[v[t.x]];
+                    const float3 n = cross(mesh.positions[v[t.y]] - p0, mesh.positions[v[t.z]] - p0);
+                    EXPECT_GE(dot(p0 - viewPos, n), -1e-6f);
+                }
+            }
+        }
+
+        // Roughly half of the sphere faces away from the viewer. The cones of the inverted sphere are more conservative.
+        EXPECT_GT(culledCount, inverted ? 0 : 64 * result.meshlets.size() / 4);
+    }
+}
+
+CPU_TEST(MeshletBuilder_EmptyAndInvalid)
+{
+    std::vector<float3> positions = { float3(0.f), float3(1.f, 0.f, 0.f), float3(0.f, 1.f, 0.f) };
+    std::vector<uint32_t> indices;
+    EXPECT(MeshletBuilder::build(positions, indices).meshlets.empty());
+
+    indices = { 0, 1 };
+    EXPECT_THROW(MeshletBuilder::build(positions, indices));
+    indices = { 0, 1, 3 };
+    EXPECT_THROW(MeshletBuilder::build(positions, indices));
+    indices = { 0, 1, 2 };
+    EXPECT_THROW(MeshletBuilder::build(positions, indices, 2, 1));
+    EXPECT_THROW(MeshletBuilder::build(positions, indices, 3, 0));
+
+    // A single triangle facing +z is culled from below but not from above.
+    MeshletBuilder::Result result = MeshletBuilder::build(positions, indices);
+    ASSERT_EQ(result.meshlets.size(), 1u);
+    EXPECT(result.meshlets[0].isBackfacing(float3(0.2f, 0.2f, -1.f)));
+    EXPECT(!result.meshlets[0].isBackfacing(float3(0.2f, 0.2f, 1.f)));
+}
+} // namespace Falcor
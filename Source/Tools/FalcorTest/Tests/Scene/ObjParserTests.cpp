@@ -0,0 +1,278 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/ObjParser.h"
+#include "Scene/ImporterError.h"
+
+#include <fmt/format.h>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const std::filesystem::path kPath = "test.obj";
+
+/// Unit cube with one quad per side, per-face normals and texture coordinates.
+const char kCube[] = R"(# Cube
+mtllib cube.mtl
+o Cube
+v 0 0 0
+v 1 0 0
+v 1 1 0
+v 0 1 0
+v 0 0 1
+v 1 0 1
+v 1 1 1
+v 0 1 1
+vt 0 0
+vt 1 0
+vt 1 1
+vt 0 1
+vn 0 0 -1
+vn 0 0 1
+vn -1 0 0
+vn 1 0 0
+vn 0 -1 0
+vn 0 1 0
+usemtl Red
+s off
+f 1/1/1 4/4/1 3/3/1 2/2/1
+f 5/1/2 6/2/2 7/3/2 8/4/2
+f 1/1/3 5/2/3 8/3/3 4/4/3
+f 2/1/4 3/2/4 7/3/4 6/4/4
+f 1/1/5 2/2/5 6/3/5 5/4/5
+f 4/1/6 8/2/6 7/3/6 3/4/6
+)";
+
+ObjParser::Result parse(const std::string& text, size_t chunkSize = ObjParser::kDefaultChunkSize)
+{
+    return ObjParser::parse(text.data(), text.size(), kPath, chunkSize);
+}
+
+/// Large OBJ file with several groups and materials, relative and absolute indices and mixed attributes.
+std::string createGridObj(uint32_t size)
+{
+    std::string text;
+    for (uint32_t y = 0; y <= size; y++)
+        for (uint32_t x = 0; x <= size; x++)
+            text += fmt::format("v {} {} {}\nvt {} {}\n", x, y, (x * y) % 7, float(x) / size, float(y) / size);
+    text += "vn 0 0 1\n";
+
+    const uint32_t vertexCount = (size + 1) * (size + 1);
+    auto vertex = [&](uint32_t x, uint32_t y) { return y * (size + 1) + x + 1; };
+    for (uint32_t y = 0; y < size; y++)
+    {
+        text += fmt::format("g row{}\nusemtl mat{}\n", y % 3, y % 2);
+        for (uint32_t x = 0; x < size; x++)
+        {
+            uint32_t a = vertex(x, y), b = vertex(x + 1, y), c = vertex(x + 1, y + 1), d = vertex(x, y + 1);
+            if (x % 2 == 0)
+                text += fmt::format("f {0}/{0}/1 {1}/{1}/1 {2}/{2}/1 {3}/{3}/1\n", a, b, c, d);
+            else // Same vertices with relative indices.
+                text += fmt::format("f -{0}/{1}/-1 {2}/-{3}/1 {4}/{4}/-1\n", vertexCount + 1 - a, a, b, vertexCount + 1 - b, c);
+        }
+    }
+    return text;
+}
+}
+
+CPU_TEST(ObjParser_Cube)
+{
+    auto result = parse(kCube);
+    ASSERT_EQ(result.meshes.size(), 1);
+    ASSERT_EQ(result.materialLibraries.size(), 1);
+    EXPECT_EQ(result.materialLibraries[0], "cube.mtl");
+
+    const auto& mesh = result.meshes[0];
+    EXPECT_EQ(mesh.name, "Cube");
+    EXPECT_EQ(mesh.material, "Red");
+    // Each corner of a quad is a unique vertex, as normals differ between faces.
+    EXPECT_EQ(mesh.positions.size(), 24);
+    EXPECT_EQ(mesh.normals.size(), 24);
+    EXPECT_EQ(mesh.texCrds.size(), 24);
+    ASSERT_EQ(mesh.indices.size(), 36);
+
+    // The first quad is split into (1, 4, 3) and (1, 3, 2).
+    const float3 expected[6] = {{0, 0, 0}, {0, 1, 0}, {1, 1, 0}, {0, 0, 0}, {1, 1, 0}, {1, 0, 0}};
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        EXPECT(all(mesh.positions[mesh.indices[i]] == expected[i])) << "corner " << i;
+        EXPECT(all(mesh.normals[mesh.indices[i]] == float3(0, 0, -1))) << "corner " << i;
+    }
+    // Texture coordinates are flipped vertically.
+    EXPECT(all(mesh.texCrds[mesh.indices[0]] == float2(0, 1)));
+    EXPECT(all(mesh.texCrds[mesh.indices[2]] == float2(1, 0)));
+    EXPECT_EQ(mesh.indices[0], mesh.indices[3]);
+    EXPECT_EQ(mesh.indices[2], mesh.indices[4]);
+}
+
+CPU_TEST(ObjParser_Chunks)
+{
+    // Parsing in small chunks must give the same result as parsing the whole file at once.
+    std::string text = createGridObj(40);
+    auto reference = parse(text, text.size());
+    ASSERT_EQ(reference.meshes.size(), 6);
+
+    for (size_t chunkSize : {1, 7, 100, 4096})
+    {
+        auto result = parse(text, chunkSize);
+        ASSERT_EQ(result.meshes.size(), reference.meshes.size());
+        for (size_t i = 0; i < result.meshes.size(); i++)
+        {
+            const auto& mesh = result.meshes[i];
+            const auto& ref = reference.meshes[i];
+            EXPECT_EQ(mesh.name, ref.name);
+            EXPECT_EQ(mesh.material, ref.material);
+            EXPECT(mesh.indices == ref.indices) << "chunk size " << chunkSize << ", mesh " << i;
+            ASSERT_EQ(mesh.positions.size(), ref.positions.size());
+            ASSERT_EQ(mesh.texCrds.size(), ref.texCrds.size());
+            for (size_t j = 0; j < mesh.positions.size(); j++)
+            {
+                EXPECT(all(mesh.positions[j] == ref.positions[j]));
+                EXPECT(all(mesh.texCrds[j] == ref.texCrds[j]));
+            }
+        }
+    }
+
+    // Shared vertices are welded. Vertices on the boundary between two rows belong to meshes of both rows.
+    size_t vertexCount = 0;
+    size_t triangleCount = 0;
+    for (const auto& mesh : reference.meshes)
+    {
+        vertexCount += mesh.positions.size();
+        triangleCount += mesh.indices.size() / 3;
+        EXPECT_EQ(mesh.normals.size(), mesh.positions.size());
+    }
+    EXPECT_EQ(triangleCount, 40 * 20 * 3);
+    EXPECT_EQ(vertexCount, 40 * 41 * 2);
+}
+
+CPU_TEST(ObjParser_GroupsAndAttributes)
+{
+    const char text[] = R"(
+v 0 0 0
+v 1 0 0
+v 0 1 0
+vn 0 0 1
+f 1//1 2//1 3//1
+g A
+usemtl M
+f 1 2 3
+g B
+f 1 2 3
+g A
+f -3 -2 -1
+usemtl
+f 3 2 1
+)";
+    auto result = parse(text);
+    ASSERT_EQ(result.meshes.size(), 4);
+    EXPECT_EQ(result.meshes[0].name, "default");
+    EXPECT_EQ(result.meshes[0].material, "");
+    EXPECT_EQ(result.meshes[0].normals.size(), 3);
+    EXPECT_EQ(result.meshes[1].name, "A");
+    EXPECT_EQ(result.meshes[1].material, "M");
+    EXPECT_EQ(result.meshes[1].indices.size(), 6);
+    EXPECT_EQ(result.meshes[1].positions.size(), 3);
+    EXPECT(result.meshes[1].normals.empty());
+    EXPECT(result.meshes[1].texCrds.empty());
+    EXPECT_EQ(result.meshes[2].name, "B");
+    EXPECT_EQ(result.meshes[2].material, "M");
+    EXPECT_EQ(result.meshes[3].name, "A");
+    EXPECT_EQ(result.meshes[3].material, "");
+
+    // Attributes missing on some faces are dropped for the whole mesh.
+    auto mixed = parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nvn 0 0 1\nf 1//1 2//1 3//1\nf 1 3 2\n");
+    ASSERT_EQ(mixed.meshes.size(), 1);
+    EXPECT(mixed.meshes[0].normals.empty());
+    EXPECT_EQ(mixed.meshes[0].positions.size(), 3);
+}
+
+CPU_TEST(ObjParser_Errors)
+{
+    EXPECT_THROW_AS(parse("v 0 0 0\nv 1 0 0\nf 1 2 3\n"), ImporterError);
+    EXPECT_THROW_AS(parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 -4\n"), ImporterError);
+    EXPECT_THROW_AS(parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2 0\n"), ImporterError);
+    EXPECT_THROW_AS(parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1 2\n"), ImporterError);
+    EXPECT_THROW_AS(parse("v 0 0 zero\n"), ImporterError);
+    EXPECT_THROW_AS(parse("v 0 0 0\nv 1 0 0\nv 0 1 0\nf 1/1 2/1 3/1\n"), ImporterError);
+
+    try
+    {
+        parse("v 0 0 0\n\nv 1 0 0\nv 0 1 0\nf 1 2 4\n", 8);
+        EXPECT(false);
+    }
+    catch (const ImporterError& e)
+    {
+        EXPECT(std::string(e.what()).find("Line 5") != std::string::npos) << e.what();
+    }
+}
+
+CPU_TEST(ObjParser_Materials)
+{
+    const char text[] = R"(# Materials
+newmtl Red
+Kd 1 0 0
+Ks 0.5
+Ns 100
+Ni 1.45
+d 0.5
+map_Kd -s 2 2 -bm 1 textures/red diffuse.png
+map_Bump -bm 0.5 normal.png
+
+newmtl Glow
+Ke 1 2 3
+Tr 0.25
+map_Ke glow.png
+)";
+    auto materials = ObjParser::parseMaterials(text, "test.mtl");
+    ASSERT_EQ(materials.size(), 2);
+
+    const auto& red = materials[0];
+    EXPECT_EQ(red.name, "Red");
+    EXPECT(all(red.diffuse == float3(1, 0, 0)));
+    EXPECT(all(red.specular == float3(0.5f)));
+    EXPECT_EQ(red.shininess, 100.f);
+    EXPECT_EQ(red.ior, 1.45f);
+    EXPECT_EQ(red.opacity, 0.5f);
+    EXPECT_EQ(red.diffuseMap, "textures/red diffuse.png");
+    EXPECT_EQ(red.normalMap, "normal.png");
+    EXPECT(red.emissiveMap.empty());
+
+    const auto& glow = materials[1];
+    EXPECT_EQ(glow.name, "Glow");
+    EXPECT(all(glow.diffuse == float3(0.6f)));
+    EXPECT(all(glow.emissive == float3(1, 2, 3)));
+    EXPECT_EQ(glow.opacity, 0.75f);
+    EXPECT_EQ(glow.emissiveMap, "glow.png");
+
+    EXPECT_THROW_AS(ObjParser::parseMaterials("newmtl A\nKd red\n", "test.mtl"), ImporterError);
+}
+} // namespace Falcor
@@ -0,0 +1,287 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SDFs/SDFPrimitiveStore.h"
+#include "Scene/SDFs/SDFPrimitiveEvaluator.h"
+#include "Scene/SDFs/SparseBrickSet/SDFSBS.h"
+
+#include <algorithm>
+
+#include <cmath>
+#include <random>
+#include <tuple>
+
+namespace Falcor
+{
+namespace
+{
+SDF3DPrimitive makePrimitive(
+    SDF3DShapeType shapeType,
+    float3 shapeData,
+    SDFOperationType operationType,
+    float3 translation,
+    float3 scale = float3(1.f),
+    float angle = 0.f
+)
+{
+    float c = std::cos(angle);
+    float s = std::sin(angle);
+    float3x3 rotation({c, -s, 0.f, s, c, 0.f, 0.f, 0.f, 1.f});
+    float3x3 scaling({scale.x, 0.f, 0.f, 0.f, scale.y, 0.f, 0.f, 0.f, scale.z});
+
+    SDF3DPrimitive primitive = {};
+    primitive.shapeType = shapeType;
+    primitive.shapeData = shapeData;
+    primitive.operationType = operationType;
+    primitive.translation = translation;
+    primitive.invRotationScale = inverse(mul(rotation, scaling));
+    return primitive;
+}
+
+SDF3DPrimitive makeSphere(float3 center, float radius, SDFOperationType operationType = SDFOperationType::Union)
+{
+    return makePrimitive(SDF3DShapeType::Sphere, float3(radius, 0.f, 0.f), operationType, center);
+}
+
+SDF3DPrimitive makeRandomPrimitive(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    auto shapeType = SDF3DShapeType(rng() % uint32_t(SDF3DShapeType::Count));
+    float3 shapeData;
+    switch (shapeType)
+    {
+    case SDF3DShapeType::Cone:
+        shapeData = float3(0.2f + u(rng), 0.05f + 0.1f * u(rng), 0.f);
+        break;
+    default:
+        shapeData = float3(0.02f + 0.08f * u(rng), 0.02f + 0.08f * u(rng), 0.02f + 0.08f * u(rng));
+        break;
+    }
+
+    // Mostly local operations, with an occasional intersection.
+    const SDFOperationType kOperations[] = {
+        SDFOperationType::Union,
+        SDFOperationType::SmoothUnion,
+        SDFOperationType::Subtraction,
+        SDFOperationType::SmoothSubtraction,
+    };
+    SDFOperationType operationType = u(rng) < 0.05f ? SDFOperationType::SmoothIntersection : kOperations[rng() % 4];
+
+    float3 translation = float3(u(rng), u(rng), u(rng)) - 0.5f;
+    float3 scale = float3(0.5f + u(rng), 0.5f + u(rng), 0.5f + u(rng));
+    SDF3DPrimitive primitive = makePrimitive(shapeType, shapeData, operationType, translation, scale, 6.f * u(rng));
+    primitive.shapeBlobbing = (shapeType == SDF3DShapeType::Torus || shapeType == SDF3DShapeType::Capsule) ? 0.02f + 0.02f * u(rng) : 0.01f * u(rng);
+    primitive.operationSmoothing = 0.01f + 0.04f * u(rng);
+    return primitive;
+}
+
+std::vector<AABB> getSortedBrickAABBs(const SDFSBS& sbs)
+{
+    // Brick IDs depend on the order of the subdivision, so compare the bricks by position.
+    std::vector<AABB> aabbs = sbs.getAABBBuffer()->getElements<AABB>(0, sbs.getAABBCount());
+    std::sort(
+        aabbs.begin(),
+        aabbs.end(),
+        [](const AABB& a, const AABB& b)
+        { return std::tie(a.minPoint.x, a.minPoint.y, a.minPoint.z) < std::tie(b.minPoint.x, b.minPoint.y, b.minPoint.z); }
+    );
+    return aabbs;
+}
+} // namespace
+
+CPU_TEST(SDFPrimitiveStore_AddRemoveUpdate)
+{
+    SDFPrimitiveStore store;
+    std::vector<SDF3DPrimitive> primitives;
+    for (uint32_t i = 0; i < 8; i++)
+        primitives.push_back(makeSphere(float3(0.f), 0.01f * (i + 1)));
+
+    EXPECT_EQ(store.add(primitives), 0);
+    EXPECT_EQ(store.add({makeSphere(float3(0.f), 0.5f)}), 8);
+    EXPECT_EQ(store.getCount(), 9);
+    EXPECT(store.getDirtyRanges().getRanges() == std::vector<DirtyRangeTracker::Range>({{0, 9}}));
+    store.clearDirtyRanges();
+
+    // Batched removal preserves the order of the remaining primitives and their IDs.
+    // Unknown IDs and primitives before the first removable index are skipped.
+    EXPECT_EQ(store.remove({6, 2, 3, 42, 0}, 1), 3);
+    EXPECT_EQ(store.getCount(), 6);
+    const uint32_t kRemainingIDs[] = {0, 1, 4, 5, 7, 8};
+    for (uint32_t index = 0; index < 6; index++)
+    {
+        uint32_t id = kRemainingIDs[index];
+        EXPECT_EQ(store.getID(index), id);
+        EXPECT_EQ(store.getIndex(id), index);
+        EXPECT_EQ(store.getPrimitives()[index].shapeData.x, id < 8 ? 0.01f * (id + 1) : 0.5f);
+    }
+    EXPECT_EQ(store.getIndex(2), SDFPrimitiveStore::kInvalidIndex);
+    EXPECT(store.getDirtyRanges().getRanges() == std::vector<DirtyRangeTracker::Range>({{2, 6}}));
+    store.clearDirtyRanges();
+
+    // Updates only touch the updated elements.
+    EXPECT_EQ(store.update({{7, makeSphere(float3(0.1f), 0.2f)}, {3, makeSphere(float3(0.f), 0.1f)}}), 1);
+    EXPECT_EQ(store.get(7).shapeData.x, 0.2f);
+    EXPECT(store.getDirtyRanges().getRanges() == std::vector<DirtyRangeTracker::Range>({{4, 5}}));
+
+    // New primitives get new IDs after removals.
+    EXPECT_EQ(store.add({makeSphere(float3(0.f), 0.3f)}), 9);
+    EXPECT_EQ(store.getIndex(9), 6);
+
+    store.clear();
+    EXPECT(store.isEmpty());
+    EXPECT_EQ(store.add({makeSphere(float3(0.f), 0.3f)}), 0);
+}
+
+CPU_TEST(SDFPrimitiveStore_ChunkIndex)
+{
+    const uint32_t kGridWidth = 32;
+    const float kNarrowBand = 1.f / kGridWidth;
+
+    SDFPrimitiveStore store;
+    store.enableChunkIndex(kGridWidth, 4, kNarrowBand);
+    EXPECT_EQ(store.getChunksPerAxis(), 9);
+    store.clearDirtyChunks();
+
+    // A small sphere in a corner only touches the chunks around it.
+    uint32_t id = store.add({makeSphere(float3(-0.45f), 0.02f)});
+    auto dirtyChunks = store.getDirtyChunks();
+    EXPECT(!dirtyChunks.empty());
+    EXPECT_LE(dirtyChunks.size(), 8);
+    EXPECT_EQ(dirtyChunks[0], 0);
+
+    std::vector<uint32_t> indices;
+    store.getChunkPrimitiveIndices(0, indices);
+    EXPECT(indices == std::vector<uint32_t>({0}));
+    store.getChunkPrimitiveIndices(9 * 9 * 9 - 1, indices);
+    EXPECT(indices.empty());
+
+    // Moving it marks both the old and new chunks.
+    store.clearDirtyChunks();
+    store.update({{id, makeSphere(float3(0.45f), 0.02f)}});
+    dirtyChunks = store.getDirtyChunks();
+    EXPECT_EQ(dirtyChunks.front(), 0);
+    EXPECT_EQ(dirtyChunks.back(), 9 * 9 * 9 - 1);
+    store.getChunkPrimitiveIndices(0, indices);
+    EXPECT(indices.empty());
+
+    // Intersections affect all chunks and are listed in evaluation order.
+    store.clearDirtyChunks();
+    store.add({makeSphere(float3(0.f), 0.4f, SDFOperationType::Intersection)});
+    EXPECT_EQ(store.getDirtyChunks().size(), 9 * 9 * 9);
+    store.add({makeSphere(float3(0.45f), 0.01f)});
+    store.getChunkPrimitiveIndices(9 * 9 * 9 - 1, indices);
+    EXPECT(indices == std::vector<uint32_t>({0, 1, 2}));
+    store.getChunkPrimitiveIndices(0, indices);
+    EXPECT(indices == std::vector<uint32_t>({1}));
+}
+
+CPU_TEST(SDFPrimitiveStore_LocalizedEvaluation)
+{
+    // Re-evaluating only the dirty chunks after each edit must match evaluating all primitives everywhere.
+    const uint32_t kGridWidth = 24;
+    const float kNarrowBand = 0.5f * std::sqrt(3.f) / kGridWidth * 3.f;
+
+    std::mt19937 rng(1234);
+    SDFPrimitiveStore store;
+    std::vector<SDF3DPrimitive> initial;
+    for (uint32_t i = 0; i < 40; i++)
+        initial.push_back(makeRandomPrimitive(rng));
+    store.add(initial);
+    store.enableChunkIndex(kGridWidth, 4, kNarrowBand);
+
+    std::vector<float> values;
+    SDFPrimitiveEvaluator::evaluateDirtyChunks(store, values);
+    store.clearDirtyChunks();
+    EXPECT(values == SDFPrimitiveEvaluator::evaluateGrid(store, kGridWidth, kNarrowBand));
+
+    const uint32_t chunkCount = store.getChunksPerAxis() * store.getChunksPerAxis() * store.getChunksPerAxis();
+    uint32_t evaluatedChunks = 0;
+
+    for (uint32_t step = 0; step < 30; step++)
+    {
+        uint32_t action = rng() % 3;
+        if (action == 0 || store.getCount() < 4)
+        {
+            store.add({makeRandomPrimitive(rng)});
+        }
+        else if (action == 1)
+        {
+            store.remove({store.getID(rng() % store.getCount()), store.getID(rng() % store.getCount())});
+        }
+        else
+        {
+            store.update({{store.getID(rng() % store.getCount()), makeRandomPrimitive(rng)}});
+        }
+
+        evaluatedChunks += SDFPrimitiveEvaluator::evaluateDirtyChunks(store, values);
+        store.clearDirtyChunks();
+
+        auto reference = SDFPrimitiveEvaluator::evaluateGrid(store, kGridWidth, kNarrowBand);
+        ASSERT_EQ(values.size(), reference.size());
+        size_t mismatches = 0;
+        for (size_t i = 0; i < values.size(); i++)
+            mismatches += values[i] != reference[i];
+        EXPECT_EQ(mismatches, 0) << "step " << step;
+    }
+
+    // Edits should touch a fraction of the grid on average.
+    EXPECT_LT(evaluatedChunks, 30 * chunkCount / 2);
+}
+
+GPU_TEST(SDFSBS_ReuseBricks)
+{
+    // Updating an SBS in place only rebuilds the bricks around the edits, which must yield the bricks of a fresh build.
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = pDevice->getRenderContext();
+    const uint32_t kGridWidth = 64;
+
+    std::mt19937 rng(4321);
+    std::vector<SDF3DPrimitive> primitives;
+    for (uint32_t i = 0; i < 20; i++)
+        primitives.push_back(makeRandomPrimitive(rng));
+
+    ref<SDFSBS> pSBS = SDFSBS::create(pDevice);
+    uint32_t baseID = pSBS->setPrimitives(primitives, kGridWidth);
+    pSBS->createResources(pRenderContext);
+
+    for (uint32_t step = 0; step < 4; step++)
+    {
+        uint32_t index = rng() % primitives.size();
+        primitives[index] = makeSphere(float3(0.3f * step - 0.4f), 0.05f);
+        pSBS->updatePrimitives({{baseID + index, primitives[index]}});
+        pSBS->update(pRenderContext);
+
+        ref<SDFSBS> pReference = SDFSBS::create(pDevice);
+        pReference->setPrimitives(primitives, kGridWidth);
+        pReference->createResources(pRenderContext);
+
+        EXPECT_EQ(pSBS->getAABBCount(), pReference->getAABBCount()) << "step " << step;
+        EXPECT(getSortedBrickAABBs(*pSBS) == getSortedBrickAABBs(*pReference)) << "step " << step;
+    }
+}
+} // namespace Falcor
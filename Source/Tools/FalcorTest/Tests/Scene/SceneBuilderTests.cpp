@@ -0,0 +1,240 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+
+namespace Falcor
+{
+namespace
+{
+using Mesh = SceneBuilder::Mesh;
+using OwnedMesh = SceneBuilder::OwnedMesh;
+
+template<typename T>
+fast_vector<T> makeArray(std::initializer_list<T> values)
+{
+    fast_vector<T> data;
+    data.assign(values.begin(), values.end());
+    return data;
+}
+
+OwnedMesh createOwnedTriangle()
+{
+    OwnedMesh mesh;
+    mesh.name = "triangle";
+    mesh.topology = Vao::Topology::TriangleList;
+    mesh.setIndices(makeArray<uint32_t>({0, 1, 2}));
+    mesh.setPositions(makeArray<float3>({float3(0.f), float3(1.f, 0.f, 0.f), float3(0.f, 1.f, 0.f)}));
+    mesh.setNormals(makeArray<float3>({float3(0.f, 0.f, 1.f)}), Mesh::AttributeFrequency::Constant);
+    mesh.setTexCrds(makeArray<float2>({float2(0.f), float2(1.f, 0.f), float2(0.f, 1.f)}));
+    return mesh;
+}
+} // namespace
+
+CPU_TEST(SceneBuilder_OwnedMeshAdopt)
+{
+    fast_vector<uint32_t> indices = makeArray<uint32_t>({0, 1, 2, 2, 1, 3});
+    fast_vector<float3> positions = makeArray<float3>({float3(0.f), float3(1.f, 0.f, 0.f), float3(0.f, 1.f, 0.f), float3(1.f, 1.f, 0.f)});
+    fast_vector<float2> texCrds = makeArray<float2>({float2(0.f), float2(1.f, 0.f), float2(0.f, 1.f), float2(1.f)});
+    const uint32_t* pIndices = indices.data();
+    const float3* pPositions = positions.data();
+    const float2* pTexCrds = texCrds.data();
+
+    // The set functions take over the arrays without copying and set up the views and counts.
+    OwnedMesh mesh;
+    mesh.setIndices(std::move(indices));
+    mesh.setPositions(std::move(positions));
+    mesh.setTexCrds(std::move(texCrds), Mesh::AttributeFrequency::Vertex);
+    EXPECT(mesh.pIndices == pIndices);
+    EXPECT(mesh.positions.pData == pPositions);
+    EXPECT(mesh.texCrds.pData == pTexCrds);
+    EXPECT(mesh.positions.frequency == Mesh::AttributeFrequency::Vertex);
+    EXPECT_EQ(mesh.indexCount, 6);
+    EXPECT_EQ(mesh.faceCount, 2);
+    EXPECT_EQ(mesh.vertexCount, 4);
+    EXPECT(mesh.normals.pData == nullptr);
+    EXPECT_EQ(mesh.getByteSize(), 6 * sizeof(uint32_t) + 4 * sizeof(float3) + 4 * sizeof(float2));
+
+    // Moving the mesh keeps the storage, so the views stay valid.
+    OwnedMesh moved = std::move(mesh);
+    EXPECT(moved.pIndices == pIndices && moved.indexData.data() == pIndices);
+    EXPECT(moved.positions.pData == pPositions && moved.positionData.data() == pPositions);
+    EXPECT(moved.texCrds.pData == pTexCrds && moved.texCrdData.data() == pTexCrds);
+    EXPECT(all(moved.getPosition(1, 2) == float3(1.f, 1.f, 0.f)));
+    EXPECT(all(moved.getTexCrd(1, 0) == float2(0.f, 1.f)));
+
+    // Releasing frees the arrays and clears the views, but leaves the counts.
+    moved.release();
+    EXPECT(moved.pIndices == nullptr);
+    EXPECT(moved.positions.pData == nullptr);
+    EXPECT(moved.texCrds.pData == nullptr);
+    EXPECT(moved.indexData.empty() && moved.positionData.empty() && moved.texCrdData.empty());
+    EXPECT_EQ(moved.getByteSize(), 0);
+    EXPECT_EQ(moved.indexCount, 6);
+    EXPECT_EQ(moved.vertexCount, 4);
+}
+
+CPU_TEST(SceneBuilder_OwnedMeshBones)
+{
+    OwnedMesh mesh;
+    mesh.setBones(makeArray<uint4>({uint4(1, 2, 0, 0)}), makeArray<float4>({float4(0.5f, 0.5f, 0.f, 0.f)}), Mesh::AttributeFrequency::Constant);
+    EXPECT(mesh.hasBones());
+    EXPECT(all(mesh.get(mesh.boneIDs, 0) == uint4(1, 2, 0, 0)));
+    EXPECT_EQ(mesh.getByteSize(), sizeof(uint4) + sizeof(float4));
+
+    // Bone IDs and weights must match.
+    EXPECT_THROW(mesh.setBones(makeArray<uint4>({uint4(0)}), fast_vector<float4>()));
+}
+
+CPU_TEST(SceneBuilder_MeshAttributeStride)
+{
+    // Interleaved vertices are referenced directly through the attribute stride.
+    std::vector<TriangleMesh::Vertex> vertices = {
+        {float3(0.f, 1.f, 2.f), float3(0.f, 0.f, 1.f), float2(0.25f, 0.5f)},
+        {float3(3.f, 4.f, 5.f), float3(0.f, 1.f, 0.f), float2(0.75f, 1.f)},
+        {float3(6.f, 7.f, 8.f), float3(1.f, 0.f, 0.f), float2(0.f, 0.125f)},
+    };
+    std::vector<uint32_t> indices = {2, 1, 0};
+    const uint32_t stride = sizeof(TriangleMesh::Vertex);
+
+    Mesh mesh;
+    mesh.faceCount = 1;
+    mesh.vertexCount = 3;
+    mesh.indexCount = 3;
+    mesh.pIndices = indices.data();
+    mesh.positions = {&vertices[0].position, Mesh::AttributeFrequency::Vertex, stride};
+    mesh.normals = {&vertices[0].normal, Mesh::AttributeFrequency::Vertex, stride};
+    mesh.texCrds = {&vertices[0].texCoord, Mesh::AttributeFrequency::Vertex, stride};
+
+    for (uint32_t vert = 0; vert < 3; vert++)
+    {
+        const TriangleMesh::Vertex& v = vertices[indices[vert]];
+        Mesh::Vertex result = mesh.getVertex(0, vert);
+        EXPECT(all(result.position == v.position));
+        EXPECT(all(result.normal == v.normal));
+        EXPECT(all(result.texCrd == v.texCoord));
+    }
+}
+
+GPU_TEST(SceneBuilder_ImportStats)
+{
+    // The builder needs a device for its material system, so this can't run as a CPU test.
+    SceneBuilder builder(ctx.getDevice(), Settings(), SceneBuilder::Flags::None);
+    ref<Material> pMaterial = StandardMaterial::create(ctx.getDevice(), "testMaterial");
+
+    // Borrowed data counts as input but is not adopted.
+    OwnedMesh borrowedSource = createOwnedTriangle();
+    borrowedSource.pMaterial = pMaterial;
+    const size_t borrowedBytes = borrowedSource.getByteSize();
+    builder.processMesh(static_cast<const Mesh&>(borrowedSource));
+
+    SceneBuilder::ImportStats stats = builder.getImportStats();
+    EXPECT_EQ(stats.meshCount, 1);
+    EXPECT_EQ(stats.adoptedMeshCount, 0);
+    EXPECT_EQ(stats.inputMeshBytes, borrowedBytes);
+    EXPECT_EQ(stats.adoptedMeshBytes, 0);
+    EXPECT(borrowedSource.pIndices != nullptr);
+
+    // Owned data is adopted and freed by the builder.
+    OwnedMesh owned = createOwnedTriangle();
+    owned.pMaterial = pMaterial;
+    const size_t ownedBytes = owned.getByteSize();
+    SceneBuilder::ProcessedMesh processed = builder.processMesh(std::move(owned));
+    EXPECT_EQ(processed.indexCount, 3);
+    EXPECT_EQ(processed.staticData.size(), 3);
+
+    stats = builder.getImportStats();
+    EXPECT_EQ(stats.meshCount, 2);
+    EXPECT_EQ(stats.adoptedMeshCount, 1);
+    EXPECT_EQ(stats.inputMeshBytes, borrowedBytes + ownedBytes);
+    EXPECT_EQ(stats.adoptedMeshBytes, ownedBytes);
+
+    // Triangle meshes are referenced in place, so they are input but not adopted.
+    ref<TriangleMesh> pQuad = TriangleMesh::createQuad();
+    builder.addTriangleMesh(pQuad, pMaterial);
+    const size_t quadBytes = pQuad->getIndices().size() * sizeof(uint32_t) + pQuad->getVertices().size() * (2 * sizeof(float3) + sizeof(float2));
+
+    stats = builder.getImportStats();
+    EXPECT_EQ(stats.meshCount, 3);
+    EXPECT_EQ(stats.adoptedMeshCount, 1);
+    EXPECT_EQ(stats.inputMeshBytes, borrowedBytes + ownedBytes + quadBytes);
+    EXPECT_EQ(stats.adoptedMeshBytes, ownedBytes);
+    EXPECT_GT(stats.processedMeshBytes, 0);
+}
+
+GPU_TEST(SceneBuilder_OutOfCoreUpload)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ref<Material> pMaterial = StandardMaterial::create(pDevice, "testMaterial");
+    std::vector<ref<TriangleMesh>> meshes = {TriangleMesh::createCube(), TriangleMesh::createSphere(0.5f, 64, 32), TriangleMesh::createQuad(float2(4.f))};
+
+    auto buildScene = [&](SceneBuilder::Flags flags, const Settings& settings)
+    {
+        SceneBuilder builder(pDevice, settings, flags);
+        for (size_t i = 0; i < meshes.size(); i++)
+        {
+            MeshID meshID = builder.addTriangleMesh(meshes[i], pMaterial);
+            NodeID nodeID = builder.addNode(SceneBuilder::Node{"node" + std::to_string(i), float4x4::identity(), float4x4::identity()});
+            builder.addMeshInstance(nodeID, meshID);
+        }
+        return builder.getScene();
+    };
+
+    // Spill all meshes so they are read back from disk while uploading.
+    Settings outOfCoreSettings;
+    outOfCoreSettings.addOptions(nlohmann::json{{"OutOfCore", {{"hostMemoryBudgetMB", 0}, {"uploadChunkSizeMB", 1}}}});
+
+    ref<Scene> pReference = buildScene(SceneBuilder::Flags::None, Settings());
+    ref<Scene> pScene = buildScene(SceneBuilder::Flags::OutOfCoreGeometry, outOfCoreSettings);
+
+    // The uploaded buffers must match the ones created from the host arrays.
+    auto compareBuffers = [&](const ref<Buffer>& pExpected, const ref<Buffer>& pActual)
+    {
+        ASSERT(pExpected && pActual);
+        ASSERT_EQ(pExpected->getSize(), pActual->getSize());
+        std::vector<uint8_t> expected = pExpected->getElements<uint8_t>();
+        std::vector<uint8_t> actual = pActual->getElements<uint8_t>();
+        EXPECT(expected == actual);
+    };
+    compareBuffers(pReference->getMeshVao()->getIndexBuffer(), pScene->getMeshVao()->getIndexBuffer());
+    compareBuffers(pReference->getMeshVao()->getVertexBuffer(0), pScene->getMeshVao()->getVertexBuffer(0));
+
+    ASSERT_EQ(pReference->getMeshCount(), pScene->getMeshCount());
+    for (uint32_t i = 0; i < pScene->getMeshCount(); i++)
+    {
+        std::vector<Rectangle> expected = pReference->getGeometryUVTiles(GlobalGeometryID{i});
+        std::vector<Rectangle> actual = pScene->getGeometryUVTiles(GlobalGeometryID{i});
+        ASSERT_EQ(expected.size(), actual.size());
+        for (size_t j = 0; j < expected.size(); j++)
+        {
+            EXPECT(all(expected[j].minPoint == actual[j].minPoint) && all(expected[j].maxPoint == actual[j].maxPoint));
+        }
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,251 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/SceneCache.h"
+#include "Scene/Material/StandardMaterial.h"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <utility>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+// Mirrors the package format described in docs/usage/scene-formats.md.
+const size_t kPackageHeaderSize = 16;
+const size_t kChunkHeaderSize = 16;
+const uint16_t kChunkRequired = 0x2;
+
+constexpr uint32_t makeTag(const char (&str)[5])
+{
+    return uint32_t(uint8_t(str[0])) | (uint32_t(uint8_t(str[1])) << 8) | (uint32_t(uint8_t(str[2])) << 16) | (uint32_t(uint8_t(str[3])) << 24);
+}
+
+template<typename T>
+T readValue(const std::vector<uint8_t>& data, size_t offset)
+{
+    T value;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return value;
+}
+
+template<typename T>
+void writeValue(std::vector<uint8_t>& data, size_t offset, T value)
+{
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+/// Returns the offset of the chunk header with the given tag.
+size_t findChunk(const std::vector<uint8_t>& data, uint32_t tag)
+{
+    size_t offset = kPackageHeaderSize;
+    while (offset + kChunkHeaderSize <= data.size())
+    {
+        if (readValue<uint32_t>(data, offset) == tag)
+            return offset;
+        offset += kChunkHeaderSize + readValue<uint64_t>(data, offset + 8);
+    }
+    FALCOR_THROW("Chunk not found.");
+}
+
+/// Returns the offset of the field hash of the given struct in the (uncompressed) LAYT chunk.
+size_t findLayoutHash(const std::vector<uint8_t>& data, const std::string& name)
+{
+    size_t offset = findChunk(data, makeTag("LAYT")) + kChunkHeaderSize;
+    uint32_t count = readValue<uint32_t>(data, offset);
+    offset += sizeof(uint32_t);
+    uint32_t index = count;
+    for (uint32_t i = 0; i < count; i++)
+    {
+        uint64_t len = readValue<uint64_t>(data, offset);
+        if (std::string(reinterpret_cast<const char*>(data.data() + offset + sizeof(uint64_t)), len) == name)
+            index = i;
+        offset += sizeof(uint64_t) + len + sizeof(uint32_t);
+    }
+    FALCOR_CHECK(index < count, "Struct not found.");
+    // Each appended entry stores a uint32_t layout version followed by the uint64_t field hash.
+    return offset + index * (sizeof(uint32_t) + sizeof(uint64_t)) + sizeof(uint32_t);
+}
+
+/// Inserts a chunk with an empty payload in front of the END chunk.
+std::vector<uint8_t> insertChunk(const std::vector<uint8_t>& data, uint32_t tag, uint16_t flags)
+{
+    std::vector<uint8_t> chunk(kChunkHeaderSize, 0);
+    writeValue(chunk, 0, tag);
+    writeValue<uint16_t>(chunk, 4, 1);
+    writeValue(chunk, 6, flags);
+    writeValue<uint64_t>(chunk, 8, 0);
+
+    std::vector<uint8_t> result = data;
+    size_t endOffset = findChunk(data, makeTag("END "));
+    result.insert(result.begin() + endOffset, chunk.begin(), chunk.end());
+    return result;
+}
+
+std::vector<uint8_t> readFile(const std::filesystem::path& path)
+{
+    std::ifstream fs(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(fs), std::istreambuf_iterator<char>());
+}
+
+void writeFile(const std::filesystem::path& path, const std::vector<uint8_t>& data)
+{
+    std::ofstream fs(path, std::ios::binary | std::ios::trunc);
+    fs.write(reinterpret_cast<const char*>(data.data()), data.size());
+}
+
+ref<Scene> buildScene(ref<Device> pDevice, const std::filesystem::path& exportPath = {})
+{
+    SceneBuilder builder(pDevice, Settings(), SceneBuilder::Flags::None);
+    ref<Material> pMaterial = StandardMaterial::create(pDevice, "testMaterial");
+    MeshID meshID = builder.addTriangleMesh(TriangleMesh::createCube(), pMaterial);
+    NodeID nodeID = builder.addNode(SceneBuilder::Node{"cube", float4x4::identity(), float4x4::identity()});
+    builder.addMeshInstance(nodeID, meshID);
+    if (!exportPath.empty())
+    {
+        builder.exportPackage(exportPath);
+        return nullptr;
+    }
+    return builder.getScene();
+}
+
+/// Exports the test scene and returns the package contents.
+std::vector<uint8_t> exportTestPackage(ref<Device> pDevice, const std::filesystem::path& path)
+{
+    buildScene(pDevice, path);
+    return readFile(path);
+}
+} // namespace
+
+GPU_TEST(SceneCache_PackageRoundTrip)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    auto path = std::filesystem::temp_directory_path() / "SceneCache_PackageRoundTrip.fscene";
+    buildScene(pDevice, path);
+
+    ref<Scene> pReference = buildScene(pDevice);
+    ref<Scene> pScene = Scene::create(pDevice, SceneCache::readPackage(pDevice, path));
+    std::filesystem::remove(path);
+
+    ASSERT_EQ(pReference->getMeshCount(), pScene->getMeshCount());
+    ASSERT_EQ(pReference->getGeometryInstanceCount(), pScene->getGeometryInstanceCount());
+    auto compareBuffers = [&](const ref<Buffer>& pExpected, const ref<Buffer>& pActual)
+    {
+        ASSERT(pExpected && pActual);
+        ASSERT_EQ(pExpected->getSize(), pActual->getSize());
+        EXPECT(pExpected->getElements<uint8_t>() == pActual->getElements<uint8_t>());
+    };
+    compareBuffers(pReference->getMeshVao()->getIndexBuffer(), pScene->getMeshVao()->getIndexBuffer());
+    compareBuffers(pReference->getMeshVao()->getVertexBuffer(0), pScene->getMeshVao()->getVertexBuffer(0));
+}
+
+GPU_TEST(SceneCache_PackageTruncated)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    auto path = std::filesystem::temp_directory_path() / "SceneCache_PackageTruncated.fscene";
+    std::vector<uint8_t> data = exportTestPackage(pDevice, path);
+    ASSERT_GT(data.size(), kPackageHeaderSize + kChunkHeaderSize);
+
+    // Cut the file inside the package header, a chunk header, a payload and the END chunk.
+    const size_t meshOffset = findChunk(data, makeTag("MESH"));
+    for (size_t size : {size_t(0), size_t(8), kPackageHeaderSize + 4, meshOffset + 8, meshOffset + kChunkHeaderSize + 1, data.size() - 1})
+    {
+        writeFile(path, std::vector<uint8_t>(data.begin(), data.begin() + size));
+        EXPECT_THROW(SceneCache::readPackage(pDevice, path));
+    }
+    std::filesystem::remove(path);
+}
+
+GPU_TEST(SceneCache_PackageUnknownChunks)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    auto path = std::filesystem::temp_directory_path() / "SceneCache_PackageUnknownChunks.fscene";
+    std::vector<uint8_t> data = exportTestPackage(pDevice, path);
+
+    // Unknown optional chunks are skipped.
+    writeFile(path, insertChunk(data, makeTag("XTRA"), 0));
+    Scene::SceneData sceneData = SceneCache::readPackage(pDevice, path);
+    EXPECT_EQ(sceneData.meshDesc.size(), 1);
+
+    // Unknown required chunks are rejected.
+    writeFile(path, insertChunk(data, makeTag("XTRA"), kChunkRequired));
+    EXPECT_THROW(SceneCache::readPackage(pDevice, path));
+    std::filesystem::remove(path);
+}
+
+GPU_TEST(SceneCache_PackageVersionMismatch)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    auto path = std::filesystem::temp_directory_path() / "SceneCache_PackageVersionMismatch.fscene";
+    std::vector<uint8_t> data = exportTestPackage(pDevice, path);
+
+    // A struct whose field layout differs from this build is rejected even if its size matches.
+    {
+        std::vector<uint8_t> patched = data;
+        size_t offset = findLayoutHash(patched, "MeshDesc");
+        writeValue(patched, offset, readValue<uint64_t>(patched, offset) ^ 1);
+        writeFile(path, patched);
+        EXPECT_THROW(SceneCache::readPackage(pDevice, path));
+    }
+
+    // So is a struct with a different layout version.
+    {
+        std::vector<uint8_t> patched = data;
+        size_t offset = findLayoutHash(patched, "PackedStaticVertexData") - sizeof(uint32_t);
+        writeValue(patched, offset, readValue<uint32_t>(patched, offset) + 1);
+        writeFile(path, patched);
+        EXPECT_THROW(SceneCache::readPackage(pDevice, path));
+    }
+
+    // Sections older than the reader supports are rejected.
+    const std::pair<uint32_t, uint16_t> kOldVersions[] = {{makeTag("LAYT"), 1}, {makeTag("MESH"), 0}};
+    for (const auto& [tag, version] : kOldVersions)
+    {
+        std::vector<uint8_t> patched = data;
+        writeValue(patched, findChunk(patched, tag) + 4, version);
+        writeFile(path, patched);
+        EXPECT_THROW(SceneCache::readPackage(pDevice, path));
+    }
+
+    // Newer sections only append data and are accepted.
+    {
+        std::vector<uint8_t> patched = data;
+        size_t offset = findChunk(patched, makeTag("SETT"));
+        writeValue<uint16_t>(patched, offset + 4, readValue<uint16_t>(patched, offset + 4) + 1);
+        writeFile(path, patched);
+        Scene::SceneData sceneData = SceneCache::readPackage(pDevice, path);
+        EXPECT_EQ(sceneData.meshDesc.size(), 1);
+    }
+    std::filesystem::remove(path);
+}
+} // namespace Falcor
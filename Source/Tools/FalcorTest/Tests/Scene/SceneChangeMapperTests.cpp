@@ -0,0 +1,165 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneChangeMapper.h"
+
+namespace Falcor
+{
+namespace
+{
+using ObjectType = SceneChangeMapper::ObjectType;
+using PropertyKind = SceneChangeMapper::PropertyKind;
+
+// Mapper for a small stage:
+// /World (node 0)
+//   /World/Mesh (node 1, mesh 0)
+//   /World/Light (node 2, light 0)
+// /Looks/Red (material 0)
+//   /Looks/Red/Shader
+SceneChangeMapper createMapper()
+{
+    SceneChangeMapper mapper;
+    mapper.setPropertyKind("xformOp:*", PropertyKind::Transform);
+    mapper.setPropertyKind("xformOpOrder", PropertyKind::Transform);
+    mapper.setPropertyKind("points", PropertyKind::Topology);
+    mapper.setPropertyKind("primvars:*", PropertyKind::Topology);
+    mapper.setPropertyKind("primvars:displayColor", PropertyKind::Ignore);
+    mapper.setPropertyKind("documentation", PropertyKind::Ignore);
+
+    mapper.registerObject("/World", ObjectType::Node, 0);
+    mapper.registerObject("/World/Mesh", ObjectType::Node, 1);
+    mapper.registerObject("/World/Mesh", ObjectType::Mesh, 0);
+    mapper.registerObject("/World/Light", ObjectType::Node, 2);
+    mapper.registerObject("/World/Light", ObjectType::Light, 0);
+    mapper.registerObject("/Looks/Red", ObjectType::Material, 0);
+    return mapper;
+}
+} // namespace
+
+CPU_TEST(SceneChangeMapper_PropertyKinds)
+{
+    SceneChangeMapper mapper = createMapper();
+    EXPECT_EQ(mapper.getObjectCount(), 6);
+
+    EXPECT(mapper.getPropertyKind("xformOp:translate") == PropertyKind::Transform);
+    EXPECT(mapper.getPropertyKind("xformOpOrder") == PropertyKind::Transform);
+    EXPECT(mapper.getPropertyKind("points") == PropertyKind::Topology);
+    EXPECT(mapper.getPropertyKind("primvars:st") == PropertyKind::Topology);
+    EXPECT(mapper.getPropertyKind("primvars:displayColor") == PropertyKind::Ignore);
+    EXPECT(mapper.getPropertyKind("inputs:intensity") == PropertyKind::Parameter);
+    EXPECT(mapper.getPropertyKind("pointsExtra") == PropertyKind::Parameter);
+
+    // Longer prefixes take precedence.
+    mapper.setPropertyKind("primvars:skel:*", PropertyKind::Ignore);
+    EXPECT(mapper.getPropertyKind("primvars:skel:jointIndices") == PropertyKind::Ignore);
+    EXPECT(mapper.getPropertyKind("primvars:normals") == PropertyKind::Topology);
+}
+
+CPU_TEST(SceneChangeMapper_InPlaceUpdates)
+{
+    SceneChangeMapper mapper = createMapper();
+
+    auto result = mapper.map({
+        {"/World/Mesh", {"xformOp:translate", "xformOp:rotateXYZ"}},
+        {"/World/Light", {"inputs:intensity", "xformOp:translate"}},
+        {"/Looks/Red/Shader", {"inputs:diffuseColor"}},
+        {"/Looks/Red", {"inputs:roughness"}},
+        {"/World/Mesh", {"primvars:displayColor", "documentation"}},
+    });
+    EXPECT(!result.rebuild);
+    ASSERT_EQ(result.updates.size(), 4);
+    EXPECT(result.updates[0] == SceneChangeMapper::Update({ObjectType::Node, 1, "/World/Mesh"}));
+    EXPECT(result.updates[1] == SceneChangeMapper::Update({ObjectType::Light, 0, "/World/Light"}));
+    EXPECT(result.updates[2] == SceneChangeMapper::Update({ObjectType::Node, 2, "/World/Light"}));
+    EXPECT(result.updates[3] == SceneChangeMapper::Update({ObjectType::Material, 0, "/Looks/Red"}));
+
+    // Reconnecting shader inputs restructures the material but doesn't require a rebuild.
+    result = mapper.map({{"/Looks/Red/Texture", {}, true}});
+    EXPECT(!result.rebuild);
+    ASSERT_EQ(result.updates.size(), 1);
+    EXPECT(result.updates[0] == SceneChangeMapper::Update({ObjectType::Material, 0, "/Looks/Red"}));
+
+    // Changes unrelated to registered objects are ignored.
+    result = mapper.map({{"/Cameras/Main", {"xformOp:translate", "focalLength"}}, {"/Other", {"points"}}});
+    EXPECT(!result.rebuild);
+    EXPECT(result.updates.empty());
+
+    // Parameter changes on plain nodes are ignored.
+    result = mapper.map({{"/World", {"kind"}}});
+    EXPECT(!result.rebuild);
+    EXPECT(result.updates.empty());
+}
+
+CPU_TEST(SceneChangeMapper_Rebuild)
+{
+    SceneChangeMapper mapper = createMapper();
+
+    // Topology changes.
+    auto result = mapper.map({{"/World/Mesh", {"xformOp:translate"}}, {"/World/Mesh", {"points"}}});
+    EXPECT(result.rebuild);
+    EXPECT(result.updates.empty());
+    EXPECT(!result.rebuildReason.empty());
+
+    // Parameters of meshes, e.g. material bindings.
+    result = mapper.map({{"/World/Mesh", {"material:binding"}}});
+    EXPECT(result.rebuild);
+
+    // Objects imported in a form that can't be updated in place, e.g. lights converted to emissive meshes.
+    mapper.registerObject("/World/DiskLight", ObjectType::Other, 0);
+    result = mapper.map({{"/World/DiskLight", {"inputs:intensity"}}});
+    EXPECT(result.rebuild);
+
+    // Added or removed prims.
+    result = mapper.map({{"/World/NewMesh", {}, true}});
+    EXPECT(result.rebuild);
+
+    // Transform of a prim whose node was removed, e.g. by scene graph optimization.
+    mapper.clearObjects();
+    EXPECT_EQ(mapper.getObjectCount(), 0);
+    mapper.registerObject("/World/Group/Mesh", ObjectType::Mesh, 0);
+    result = mapper.map({{"/World/Group", {"xformOp:translate"}}});
+    EXPECT(result.rebuild);
+    result = mapper.map({{"/World/Other", {"xformOp:translate"}}});
+    EXPECT(!result.rebuild);
+}
+
+CPU_TEST(SceneChangeMapper_SharedPath)
+{
+    // Instanced prims may map to several scene objects of the same type.
+    SceneChangeMapper mapper;
+    mapper.setPropertyKind("xformOp:*", PropertyKind::Transform);
+    mapper.registerObject("/Instance", ObjectType::Node, 3);
+    mapper.registerObject("/Instance", ObjectType::Node, 7);
+
+    auto result = mapper.map({{"/Instance", {"xformOp:scale"}}, {"/Instance", {"xformOp:translate"}}});
+    EXPECT(!result.rebuild);
+    ASSERT_EQ(result.updates.size(), 2);
+    EXPECT_EQ(result.updates[0].id, 3);
+    EXPECT_EQ(result.updates[1].id, 7);
+}
+} // namespace Falcor
@@ -0,0 +1,254 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/TangentSpaceGenerator.h"
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+struct TestMesh
+{
+    std::vector<float3> positions;
+    std::vector<float3> normals;
+    std::vector<float2> texCrds;
+
+    void addVertex(const float3& position, const float3& normal, const float2& texCrd)
+    {
+        positions.push_back(position);
+        normals.push_back(normal);
+        texCrds.push_back(texCrd);
+    }
+};
+
+/// Builds a face-varying mesh from indexed vertices.
+TestMesh createIndexedMesh(
+    const std::vector<float3>& positions,
+    const std::vector<float3>& normals,
+    const std::vector<float2>& texCrds,
+    const std::vector<uint32_t>& indices
+)
+{
+    TestMesh mesh;
+    for (uint32_t i : indices)
+        mesh.addVertex(positions[i], normals[i], texCrds[i]);
+    return mesh;
+}
+
+/// Heightfield grid with smooth normals. The texture coordinates are mirrored on half of the grid,
+/// which creates a seam with flipped tangent space orientation.
+TestMesh createGrid(uint32_t size, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    std::vector<float3> positions;
+    std::vector<float3> normals;
+    std::vector<float2> texCrds;
+    for (uint32_t y = 0; y <= size; y++)
+    {
+        for (uint32_t x = 0; x <= size; x++)
+        {
+            positions.push_back(float3(float(x), 0.5f * u(rng), float(y)));
+            normals.push_back(normalize(float3(u(rng) - 0.5f, 4.f, u(rng) - 0.5f)));
+            const float s = x < size / 2 ? float(x) : float(size - x);
+            texCrds.push_back(float2(s, float(y) + 0.1f * u(rng)) / float(size));
+        }
+    }
+
+    std::vector<uint32_t> indices;
+    for (uint32_t y = 0; y < size; y++)
+    {
+        for (uint32_t x = 0; x < size; x++)
+        {
+            const uint32_t i = y * (size + 1) + x;
+            indices.insert(indices.end(), {i, i + size + 1, i + 1, i + 1, i + size + 1, i + size + 2});
+        }
+    }
+    return createIndexedMesh(positions, normals, texCrds, indices);
+}
+
+/// UV sphere. The pole vertices are duplicated per segment, which creates degenerate triangles at the poles.
+TestMesh createSphere(uint32_t rings, uint32_t segments)
+{
+    std::vector<float3> positions;
+    std::vector<float3> normals;
+    std::vector<float2> texCrds;
+    for (uint32_t r = 0; r <= rings; r++)
+    {
+        for (uint32_t s = 0; s <= segments; s++)
+        {
+            const float theta = float(M_PI) * float(r) / float(rings);
+            const float phi = 2.f * float(M_PI) * float(s) / float(segments);
+            const float3 p = float3(std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi));
+            positions.push_back(r == 0 || r == rings ? float3(0.f, p.y, 0.f) : p);
+            normals.push_back(normalize(positions.back()));
+            texCrds.push_back(float2(float(s) / float(segments), float(r) / float(rings)));
+        }
+    }
+
+    std::vector<uint32_t> indices;
+    for (uint32_t r = 0; r < rings; r++)
+    {
+        for (uint32_t s = 0; s < segments; s++)
+        {
+            const uint32_t i = r * (segments + 1) + s;
+            indices.insert(indices.end(), {i, i + 1, i + segments + 1, i + 1, i + segments + 2, i + segments + 1});
+        }
+    }
+    return createIndexedMesh(positions, normals, texCrds, indices);
+}
+
+/// Random triangles over a small vertex pool. This creates non-manifold edges, mixed orientations,
+/// degenerate triangles and vertices with equal positions but different normals or texture coordinates.
+TestMesh createSoup(uint32_t triangleCount, uint32_t vertexCount, std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> u(0.f, 1.f);
+    std::uniform_int_distribution<uint32_t> index(0, vertexCount - 1);
+    std::vector<float3> positions;
+    std::vector<float3> normals;
+    std::vector<float2> texCrds;
+    for (uint32_t i = 0; i < vertexCount; i++)
+    {
+        // Quantized positions and texture coordinates make exact duplicates and degenerate mappings likely.
+        positions.push_back(float3(std::floor(u(rng) * 4.f), std::floor(u(rng) * 4.f), std::floor(u(rng) * 2.f)));
+        normals.push_back(i % 5 == 0 ? float3(0.f, 0.f, 1.f) : normalize(float3(u(rng), u(rng), u(rng)) * 2.f - 1.f));
+        texCrds.push_back(float2(std::floor(u(rng) * 3.f), std::floor(u(rng) * 3.f)) / 3.f);
+    }
+
+    std::vector<uint32_t> indices;
+    for (uint32_t i = 0; i < triangleCount * 3; i++)
+        indices.push_back(index(rng));
+    return createIndexedMesh(positions, normals, texCrds, indices);
+}
+
+/// Returns the number of tangents that differ from the reference implementation.
+size_t countMismatches(const TestMesh& mesh)
+{
+    auto reference = TangentSpaceGenerator::generateReference(mesh.positions, mesh.normals, mesh.texCrds);
+    auto tangents = TangentSpaceGenerator::generate(mesh.positions, mesh.normals, mesh.texCrds);
+    if (tangents.size() != reference.size())
+        return std::max(tangents.size(), reference.size());
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < tangents.size(); i++)
+    {
+        if (std::memcmp(&tangents[i], &reference[i], sizeof(float4)) != 0)
+            mismatches++;
+    }
+    return mismatches;
+}
+} // namespace
+
+CPU_TEST(TangentSpaceGenerator_Grid)
+{
+    std::mt19937 rng(1);
+    EXPECT_EQ(countMismatches(createGrid(1, rng)), 0u);
+    EXPECT_EQ(countMismatches(createGrid(16, rng)), 0u);
+    EXPECT_EQ(countMismatches(createGrid(100, rng)), 0u);
+}
+
+CPU_TEST(TangentSpaceGenerator_Sphere)
+{
+    EXPECT_EQ(countMismatches(createSphere(4, 3)), 0u);
+    EXPECT_EQ(countMismatches(createSphere(32, 64)), 0u);
+}
+
+CPU_TEST(TangentSpaceGenerator_Soup)
+{
+    std::mt19937 rng(2);
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        EXPECT_EQ(countMismatches(createSoup(1 + i * 50, 4 + i * 10, rng)), 0u) << "mesh " << i;
+    }
+}
+
+CPU_TEST(TangentSpaceGenerator_Degenerate)
+{
+    std::mt19937 rng(3);
+
+    // Soup with a single triangle that is not degenerate.
+    TestMesh mesh = createSoup(200, 3, rng);
+    mesh.addVertex(float3(0.f), float3(0.f, 0.f, 1.f), float2(0.f));
+    mesh.addVertex(float3(1.f, 0.f, 0.f), float3(0.f, 0.f, 1.f), float2(1.f, 0.f));
+    mesh.addVertex(float3(0.f, 1.f, 0.f), float3(0.f, 0.f, 1.f), float2(0.f, 1.f));
+    EXPECT_EQ(countMismatches(mesh), 0u);
+
+    // All triangles degenerate.
+    mesh = TestMesh();
+    for (uint32_t i = 0; i < 4; i++)
+        mesh.addVertex(float3(float(i / 3)), float3(0.f, 1.f, 0.f), float2(float(i)));
+    for (uint32_t i = 0; i < 2; i++)
+        mesh.addVertex(float3(float(i)), float3(0.f, 1.f, 0.f), float2(0.f));
+    EXPECT_EQ(countMismatches(mesh), 0u);
+
+    // Degenerate texture mapping and non-finite normals.
+    mesh = createGrid(8, rng);
+    for (size_t i = 0; i < mesh.texCrds.size(); i += 7)
+        mesh.texCrds[i] = float2(0.5f);
+    mesh.normals[10] = float3(std::numeric_limits<float>::quiet_NaN());
+    mesh.normals[20] = float3(0.f);
+    EXPECT_EQ(countMismatches(mesh), 0u);
+}
+
+CPU_TEST(TangentSpaceGenerator_Fallback)
+{
+    std::mt19937 rng(4);
+
+    // Vertices that are only equal because of signed zeros.
+    TestMesh mesh = createGrid(4, rng);
+    for (size_t i = 0; i < mesh.normals.size(); i++)
+        mesh.normals[i] = float3(0.f, 1.f, 0.f);
+    mesh.normals[5] = float3(-0.f, 1.f, 0.f);
+    EXPECT_EQ(countMismatches(mesh), 0u);
+
+    // Non-finite positions.
+    mesh = createGrid(4, rng);
+    mesh.positions[3] = float3(std::numeric_limits<float>::infinity(), 0.f, 0.f);
+    mesh.positions[4] = float3(std::numeric_limits<float>::quiet_NaN());
+    EXPECT_EQ(countMismatches(mesh), 0u);
+}
+
+CPU_TEST(TangentSpaceGenerator_InvalidInput)
+{
+    TestMesh mesh;
+    EXPECT_THROW(TangentSpaceGenerator::generate(mesh.positions, mesh.normals, mesh.texCrds));
+
+    mesh.addVertex(float3(0.f), float3(0.f, 0.f, 1.f), float2(0.f));
+    mesh.addVertex(float3(1.f, 0.f, 0.f), float3(0.f, 0.f, 1.f), float2(1.f, 0.f));
+    EXPECT_THROW(TangentSpaceGenerator::generate(mesh.positions, mesh.normals, mesh.texCrds));
+
+    mesh.addVertex(float3(0.f, 1.f, 0.f), float3(0.f, 0.f, 1.f), float2(0.f, 1.f));
+    mesh.normals.pop_back();
+    EXPECT_THROW(TangentSpaceGenerator::generate(mesh.positions, mesh.normals, mesh.texCrds));
+}
+} // namespace Falcor
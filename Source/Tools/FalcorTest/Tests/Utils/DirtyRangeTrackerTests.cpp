@@ -0,0 +1,146 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/DirtyRangeTracker.h"
+
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+using Range = DirtyRangeTracker::Range;
+
+/// Expand ranges to a per-element dirty mask.
+std::vector<bool> toMask(const std::vector<Range>& ranges, uint32_t size)
+{
+    std::vector<bool> mask(size, false);
+    for (const auto& r : ranges)
+        for (uint32_t i = r.begin; i < r.end; i++)
+            mask[i] = true;
+    return mask;
+}
+} // namespace
+
+CPU_TEST(DirtyRangeTracker_Empty)
+{
+    DirtyRangeTracker tracker;
+    EXPECT(!tracker.isDirty());
+    EXPECT(tracker.getRanges().empty());
+    EXPECT_EQ(tracker.getBounds().getCount(), 0);
+
+    tracker.markDirty(5, 5);
+    EXPECT(!tracker.isDirty());
+}
+
+CPU_TEST(DirtyRangeTracker_Coalesce)
+{
+    DirtyRangeTracker tracker;
+    tracker.markDirty(10);
+    tracker.markDirty(3);
+    tracker.markDirty(11);
+    tracker.markDirty(4, 6);
+    tracker.markDirty(20, 25);
+    tracker.markDirty(22, 30);
+    tracker.markDirty(6);
+    EXPECT(tracker.isDirty());
+
+    // Adjacent and overlapping ranges are merged, disjoint ones are kept separate.
+    auto ranges = tracker.getRanges();
+    ASSERT_EQ(ranges.size(), 3);
+    EXPECT(ranges[0] == (Range{3, 7}));
+    EXPECT(ranges[1] == (Range{10, 12}));
+    EXPECT(ranges[2] == (Range{20, 30}));
+
+    // Ranges separated by at most 'maxGap' clean elements are merged.
+    ranges = tracker.getRanges(3);
+    ASSERT_EQ(ranges.size(), 2);
+    EXPECT(ranges[0] == (Range{3, 12}));
+    EXPECT(ranges[1] == (Range{20, 30}));
+
+    ranges = tracker.getRanges(8);
+    ASSERT_EQ(ranges.size(), 1);
+    EXPECT(ranges[0] == (Range{3, 30}));
+
+    EXPECT(tracker.getBounds() == (Range{3, 30}));
+
+    tracker.clear();
+    EXPECT(!tracker.isDirty());
+    EXPECT(tracker.getRanges().empty());
+}
+
+CPU_TEST(DirtyRangeTracker_Sequential)
+{
+    // A full update marks every element in order and results in a single range.
+    DirtyRangeTracker tracker;
+    for (uint32_t i = 0; i < 1000; i++)
+        tracker.markDirty(i);
+    auto ranges = tracker.getRanges();
+    ASSERT_EQ(ranges.size(), 1);
+    EXPECT(ranges[0] == (Range{0, 1000}));
+}
+
+CPU_TEST(DirtyRangeTracker_Random)
+{
+    // Compare against a reference mask for scattered updates, including repeated ones that trigger compaction.
+    const uint32_t size = 500;
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<uint32_t> indexDist(0, size - 1);
+    std::uniform_int_distribution<uint32_t> lengthDist(1, 4);
+
+    DirtyRangeTracker tracker;
+    std::vector<bool> reference(size, false);
+    for (uint32_t i = 0; i < 2000; i++)
+    {
+        uint32_t begin = indexDist(rng);
+        uint32_t end = std::min(size, begin + lengthDist(rng));
+        tracker.markDirty(begin, end);
+        for (uint32_t j = begin; j < end; j++)
+            reference[j] = true;
+        if (i == 1000)
+        {
+            // Partial check midway.
+            EXPECT(toMask(tracker.getRanges(), size) == reference);
+        }
+    }
+
+    auto ranges = tracker.getRanges();
+    EXPECT(toMask(ranges, size) == reference);
+    for (size_t i = 1; i < ranges.size(); i++)
+        EXPECT_GT(ranges[i].begin, ranges[i - 1].end);
+
+    // Merging with a gap covers all dirty elements with no more ranges.
+    auto merged = tracker.getRanges(16);
+    EXPECT_LE(merged.size(), ranges.size());
+    auto mergedMask = toMask(merged, size);
+    for (uint32_t i = 0; i < size; i++)
+        if (reference[i])
+            EXPECT(mergedMask[i]);
+}
+} // namespace Falcor
@@ -0,0 +1,68 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/FileDependencyIndex.h"
+
+#include <algorithm>
+
+namespace Falcor
+{
+CPU_TEST(FileDependencyIndex_AddRemove)
+{
+    FileDependencyIndex<uint32_t> index;
+
+    EXPECT_TRUE(index.addDependency(1, "/a.slang"));
+    EXPECT_TRUE(index.addDependency(1, "/common.slang"));
+    EXPECT_TRUE(index.addDependency(2, "/b.slang"));
+    EXPECT_FALSE(index.addDependency(2, "/common.slang"));
+    EXPECT_FALSE(index.addDependency(2, "/common.slang"));
+
+    EXPECT_EQ(index.getFileCount(), 3);
+    EXPECT_EQ(index.getDependentCount(), 2);
+    EXPECT_EQ(index.getDependencies(1).size(), 2);
+
+    auto dependents = index.getDependents("/common.slang");
+    std::sort(dependents.begin(), dependents.end());
+    EXPECT(dependents == std::vector<uint32_t>({1, 2}));
+    EXPECT(index.getDependents("/a.slang") == std::vector<uint32_t>({1}));
+    EXPECT(index.getDependents("/missing.slang").empty());
+
+    // Removing a dependent returns the files no longer referenced.
+    auto orphans = index.removeDependent(1);
+    EXPECT(orphans == std::vector<std::filesystem::path>({"/a.slang"}));
+    EXPECT_FALSE(index.hasDependent(1));
+    EXPECT(index.getDependents("/common.slang") == std::vector<uint32_t>({2}));
+    EXPECT(index.removeDependent(1).empty());
+
+    orphans = index.removeDependent(2);
+    std::sort(orphans.begin(), orphans.end());
+    EXPECT(orphans == std::vector<std::filesystem::path>({"/b.slang", "/common.slang"}));
+    EXPECT_EQ(index.getFileCount(), 0);
+    EXPECT_EQ(index.getDependentCount(), 0);
+}
+} // namespace Falcor
@@ -0,0 +1,287 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/BCEncoder.h"
+#include <cmath>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Reference decoders, written directly from the format specifications.
+
+void decodeBC1Block(const uint8_t* pBlock, uint8_t* pRGBA /* 16 pixels */)
+{
+    uint32_t c[2] = {uint32_t(pBlock[0] | (pBlock[1] << 8)), uint32_t(pBlock[2] | (pBlock[3] << 8))};
+    int palette[4][3];
+    for (int i = 0; i < 2; i++)
+    {
+        uint32_t r = (c[i] >> 11) & 31, g = (c[i] >> 5) & 63, b = c[i] & 31;
+        palette[i][0] = (r << 3) | (r >> 2);
+        palette[i][1] = (g << 2) | (g >> 4);
+        palette[i][2] = (b << 3) | (b >> 2);
+    }
+    for (int ch = 0; ch < 3; ch++)
+    {
+        if (c[0] > c[1])
+        {
+            palette[2][ch] = (2 * palette[0][ch] + palette[1][ch]) / 3;
+            palette[3][ch] = (palette[0][ch] + 2 * palette[1][ch]) / 3;
+        }
+        else
+        {
+            palette[2][ch] = (palette[0][ch] + palette[1][ch]) / 2;
+            palette[3][ch] = 0;
+        }
+    }
+    uint32_t indices = pBlock[4] | (pBlock[5] << 8) | (pBlock[6] << 16) | (uint32_t(pBlock[7]) << 24);
+    for (int i = 0; i < 16; i++)
+    {
+        uint32_t index = (indices >> (2 * i)) & 3;
+        for (int ch = 0; ch < 3; ch++)
+            pRGBA[i * 4 + ch] = uint8_t(palette[index][ch]);
+        pRGBA[i * 4 + 3] = (c[0] <= c[1] && index == 3) ? 0 : 255;
+    }
+}
+
+void decodeBC4Block(const uint8_t* pBlock, uint8_t* pRGBA, int channel)
+{
+    int e0 = pBlock[0], e1 = pBlock[1];
+    int palette[8] = {e0, e1};
+    if (e0 > e1)
+    {
+        for (int i = 1; i < 7; i++)
+            palette[i + 1] = ((7 - i) * e0 + i * e1) / 7;
+    }
+    else
+    {
+        for (int i = 1; i < 5; i++)
+            palette[i + 1] = ((5 - i) * e0 + i * e1) / 5;
+        palette[6] = 0;
+        palette[7] = 255;
+    }
+    uint64_t indices = 0;
+    for (int i = 0; i < 6; i++)
+        indices |= uint64_t(pBlock[2 + i]) << (8 * i);
+    for (int i = 0; i < 16; i++)
+        pRGBA[i * 4 + channel] = uint8_t(palette[(indices >> (3 * i)) & 7]);
+}
+
+/// Decodes BC7 mode 6 blocks only, which is all the encoder produces.
+bool decodeBC7Block(const uint8_t* pBlock, uint8_t* pRGBA)
+{
+    uint32_t bitPos = 0;
+    auto read = [&](uint32_t count)
+    {
+        uint32_t value = 0;
+        for (uint32_t i = 0; i < count; i++, bitPos++)
+            value |= ((pBlock[bitPos / 8] >> (bitPos % 8)) & 1) << i;
+        return value;
+    };
+    if (read(7) != (1u << 6))
+        return false;
+    uint32_t endpoints[2][4];
+    for (int c = 0; c < 4; c++)
+    {
+        endpoints[0][c] = read(7);
+        endpoints[1][c] = read(7);
+    }
+    uint32_t p0 = read(1), p1 = read(1);
+    const uint32_t weights[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+    for (int i = 0; i < 16; i++)
+    {
+        uint32_t index = read(i == 0 ? 3 : 4);
+        for (int c = 0; c < 4; c++)
+        {
+            uint32_t a = (endpoints[0][c] << 1) | p0, b = (endpoints[1][c] << 1) | p1;
+            pRGBA[i * 4 + c] = uint8_t(((64 - weights[index]) * a + weights[index] * b + 32) >> 6);
+        }
+    }
+    return true;
+}
+
+std::vector<uint8_t> decode(ResourceFormat format, uint32_t width, uint32_t height, const std::vector<uint8_t>& blocks)
+{
+    const uint32_t blocksX = (width + 3) / 4, blocksY = (height + 3) / 4;
+    const size_t blockSize = blocks.size() / (blocksX * blocksY);
+    std::vector<uint8_t> image(size_t(width) * height * 4);
+    for (uint32_t by = 0; by < blocksY; by++)
+    {
+        for (uint32_t bx = 0; bx < blocksX; bx++)
+        {
+            const uint8_t* pBlock = blocks.data() + (by * blocksX + bx) * blockSize;
+            uint8_t pixels[64] = {};
+            switch (format)
+            {
+            case ResourceFormat::BC1Unorm:
+                decodeBC1Block(pBlock, pixels);
+                break;
+            case ResourceFormat::BC3Unorm:
+                decodeBC1Block(pBlock + 8, pixels);
+                decodeBC4Block(pBlock, pixels, 3);
+                break;
+            case ResourceFormat::BC4Unorm:
+                decodeBC4Block(pBlock, pixels, 0);
+                break;
+            case ResourceFormat::BC5Unorm:
+                decodeBC4Block(pBlock, pixels, 0);
+                decodeBC4Block(pBlock + 8, pixels, 1);
+                break;
+            default:
+                if (!decodeBC7Block(pBlock, pixels))
+                    return {};
+                break;
+            }
+            for (uint32_t i = 0; i < 16; i++)
+            {
+                uint32_t x = bx * 4 + i % 4, y = by * 4 + i / 4;
+                if (x < width && y < height)
+                    std::copy_n(pixels + i * 4, 4, image.data() + (size_t(y) * width + x) * 4);
+            }
+        }
+    }
+    return image;
+}
+
+/// Compute the root mean square error over the given channels.
+float computeRMSE(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, uint32_t channelCount)
+{
+    double sum = 0.0;
+    size_t count = 0;
+    for (size_t i = 0; i < a.size(); i += 4)
+    {
+        for (uint32_t c = 0; c < channelCount; c++, count++)
+            sum += (double(a[i + c]) - double(b[i + c])) * (double(a[i + c]) - double(b[i + c]));
+    }
+    return (float)std::sqrt(sum / count);
+}
+
+/// Create a smooth test image with some noise. The channels vary independently, so the blocks can't be represented exactly.
+std::vector<uint8_t> createTestImage(uint32_t width, uint32_t height)
+{
+    std::vector<uint8_t> image(size_t(width) * height * 4);
+    for (uint32_t y = 0; y < height; y++)
+    {
+        for (uint32_t x = 0; x < width; x++)
+        {
+            uint8_t* p = image.data() + (size_t(y) * width + x) * 4;
+            uint32_t noise = (x * 7919 + y * 104729) % 5;
+            p[0] = uint8_t(x * 255 / (width - 1));
+            p[1] = uint8_t(y * 255 / (height - 1));
+            p[2] = uint8_t(128 + 100 * std::sin(0.1f * x + 0.07f * y) + noise);
+            p[3] = uint8_t(255 - (x + y) * 255 / (width + height - 2));
+        }
+    }
+    return image;
+}
+} // namespace
+
+CPU_TEST(BCEncoder_BlockCount)
+{
+    std::vector<uint8_t> image(13 * 6 * 4, 0x80);
+    EXPECT_EQ(BCEncoder::compress(ResourceFormat::BC1Unorm, 13, 6, image.data()).size(), 4u * 2 * 8);
+    EXPECT_EQ(BCEncoder::compress(ResourceFormat::BC3Unorm, 13, 6, image.data()).size(), 4u * 2 * 16);
+    EXPECT_EQ(BCEncoder::compress(ResourceFormat::BC4Unorm, 13, 6, image.data()).size(), 4u * 2 * 8);
+    EXPECT_EQ(BCEncoder::compress(ResourceFormat::BC5Unorm, 13, 6, image.data()).size(), 4u * 2 * 16);
+    EXPECT_EQ(BCEncoder::compress(ResourceFormat::BC7UnormSrgb, 13, 6, image.data()).size(), 4u * 2 * 16);
+
+    EXPECT(!BCEncoder::isSupported(ResourceFormat::BC6HU16));
+    EXPECT_THROW(BCEncoder::compress(ResourceFormat::RGBA8Unorm, 13, 6, image.data()));
+}
+
+CPU_TEST(BCEncoder_SolidColor)
+{
+    // Solid colors are reproduced exactly by BC4 and BC5, within the shared p-bit precision by BC7
+    // and within the 5:6:5 quantization by BC1.
+    const uint8_t colors[][4] = {{0, 0, 0, 0}, {255, 255, 255, 255}, {17, 130, 201, 77}, {254, 1, 128, 3}};
+    for (const auto& color : colors)
+    {
+        std::vector<uint8_t> image;
+        for (int i = 0; i < 16; i++)
+            image.insert(image.end(), color, color + 4);
+
+        auto bc7 = decode(ResourceFormat::BC7Unorm, 4, 4, BCEncoder::compress(ResourceFormat::BC7Unorm, 4, 4, image.data()));
+        ASSERT_EQ(bc7.size(), image.size());
+
+        auto bc5 = decode(ResourceFormat::BC5Unorm, 4, 4, BCEncoder::compress(ResourceFormat::BC5Unorm, 4, 4, image.data()));
+        auto bc3 = decode(ResourceFormat::BC3Unorm, 4, 4, BCEncoder::compress(ResourceFormat::BC3Unorm, 4, 4, image.data()));
+        for (size_t i = 0; i < 64; i += 4)
+        {
+            for (size_t c = 0; c < 4; c++)
+                EXPECT_LE(std::abs(bc7[i + c] - color[c]), 1);
+            EXPECT_EQ(bc5[i + 0], color[0]);
+            EXPECT_EQ(bc5[i + 1], color[1]);
+            EXPECT_EQ(bc3[i + 3], color[3]);
+            EXPECT_LE(std::abs(bc3[i + 0] - color[0]), 4);
+            EXPECT_LE(std::abs(bc3[i + 1] - color[1]), 2);
+            EXPECT_LE(std::abs(bc3[i + 2] - color[2]), 4);
+        }
+    }
+}
+
+CPU_TEST(BCEncoder_Quality)
+{
+    const uint32_t width = 37, height = 22;
+    auto image = createTestImage(width, height);
+
+    auto roundtrip = [&](ResourceFormat format) { return decode(format, width, height, BCEncoder::compress(format, width, height, image.data())); };
+
+    auto bc1 = roundtrip(ResourceFormat::BC1Unorm);
+    EXPECT_LE(computeRMSE(bc1, image, 3), 7.f);
+
+    auto bc3 = roundtrip(ResourceFormat::BC3Unorm);
+    EXPECT_LE(computeRMSE(bc3, image, 4), 6.f);
+
+    auto bc4 = roundtrip(ResourceFormat::BC4Unorm);
+    EXPECT_LE(computeRMSE(bc4, image, 1), 1.f);
+
+    auto bc5 = roundtrip(ResourceFormat::BC5Unorm);
+    EXPECT_LE(computeRMSE(bc5, image, 2), 1.5f);
+
+    auto bc7 = roundtrip(ResourceFormat::BC7Unorm);
+    ASSERT(!bc7.empty());
+    EXPECT_LE(computeRMSE(bc7, image, 4), 5.5f);
+}
+
+CPU_TEST(BCEncoder_BC7Anchor)
+{
+    // A block that goes from bright to dark requires swapping endpoints to keep the anchor index bit zero.
+    std::vector<uint8_t> image;
+    for (int i = 0; i < 16; i++)
+    {
+        uint8_t v = uint8_t(255 - i * 17);
+        image.insert(image.end(), {v, v, v, uint8_t(i * 17)});
+    }
+    auto blocks = BCEncoder::compress(ResourceFormat::BC7Unorm, 4, 4, image.data());
+    auto decoded = decode(ResourceFormat::BC7Unorm, 4, 4, blocks);
+    ASSERT_EQ(decoded.size(), image.size());
+    for (size_t i = 0; i < image.size(); i++)
+        EXPECT_LE(std::abs(decoded[i] - image[i]), 3);
+}
+} // namespace Falcor
@@ -0,0 +1,480 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/BasisDecoder.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+/// Writes a bitstream starting at the least significant bit of the first byte.
+class BitWriter
+{
+public:
+    void write(uint32_t value, uint32_t count)
+    {
+        for (uint32_t i = 0; i < count; i++, mBitCount++)
+        {
+            if (mBitCount % 8 == 0)
+                mData.push_back(0);
+            mData.back() |= ((value >> i) & 1) << (mBitCount % 8);
+        }
+    }
+
+    /// Write a variable length integer in chunks with continuation bits.
+    void writeVLC(uint32_t value, uint32_t chunkBits)
+    {
+        do
+        {
+            const uint32_t chunk = value & ((1u << chunkBits) - 1);
+            value >>= chunkBits;
+            write(chunk | (value ? 1u << chunkBits : 0), chunkBits + 1);
+        } while (value);
+    }
+
+    const std::vector<uint8_t>& getData() const { return mData; }
+
+private:
+    std::vector<uint8_t> mData;
+    uint32_t mBitCount = 0;
+};
+
+/// Canonical Huffman code. Codes are written first bit first, i.e. bit reversed in the stream.
+class HuffmanCode
+{
+public:
+    explicit HuffmanCode(std::vector<uint32_t> sizes) : mSizes(std::move(sizes)), mCodes(mSizes.size())
+    {
+        uint32_t code = 0;
+        for (uint32_t size = 1; size <= 16; size++)
+        {
+            for (size_t s = 0; s < mSizes.size(); s++)
+                if (mSizes[s] == size)
+                    mCodes[s] = code++;
+            code <<= 1;
+        }
+    }
+
+    /// Complete code with code sizes that differ by at most one.
+    static HuffmanCode uniform(uint32_t symbolCount)
+    {
+        uint32_t bits = 1;
+        while ((1u << bits) < symbolCount)
+            bits++;
+        const uint32_t shortCount = (1u << bits) - std::max(symbolCount, 2u);
+        std::vector<uint32_t> sizes(symbolCount, bits);
+        std::fill_n(sizes.begin(), shortCount, bits - 1);
+        return HuffmanCode(sizes);
+    }
+
+    void writeSymbol(BitWriter& writer, uint32_t symbol) const
+    {
+        for (uint32_t i = mSizes[symbol]; i-- > 0;)
+            writer.write((mCodes[symbol] >> i) & 1, 1);
+    }
+
+    /// Write the table description. Runs of zero and repeated code sizes use the run length codes.
+    void writeTable(BitWriter& writer) const
+    {
+        const uint8_t kOrder[21] = {17, 18, 19, 20, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15, 16};
+        std::vector<uint32_t> codeLengthSizes(21);
+        for (uint32_t i = 0; i < 21; i++)
+            codeLengthSizes[kOrder[i]] = i < 11 ? 4 : 5;
+        HuffmanCode codeLengthCode(codeLengthSizes);
+
+        writer.write((uint32_t)mSizes.size(), 14);
+        writer.write(21, 5);
+        for (uint32_t i = 0; i < 21; i++)
+            writer.write(codeLengthSizes[kOrder[i]], 3);
+
+        const uint32_t count = (uint32_t)mSizes.size();
+        for (uint32_t i = 0; i < count;)
+        {
+            uint32_t run = 1;
+            while (i + run < count && mSizes[i + run] == mSizes[i])
+                run++;
+            const bool isRepeat = i > 0 && mSizes[i] != 0 && mSizes[i - 1] == mSizes[i];
+            if (mSizes[i] == 0 && run >= 11)
+            {
+                run = std::min(run, 138u);
+                codeLengthCode.writeSymbol(writer, 18);
+                writer.write(run - 11, 7);
+            }
+            else if (mSizes[i] == 0 && run >= 3)
+            {
+                run = std::min(run, 10u);
+                codeLengthCode.writeSymbol(writer, 17);
+                writer.write(run - 3, 3);
+            }
+            else if (isRepeat && run >= 7)
+            {
+                run = std::min(run, 70u);
+                codeLengthCode.writeSymbol(writer, 20);
+                writer.write(run - 7, 6);
+            }
+            else if (isRepeat && run >= 3)
+            {
+                run = std::min(run, 6u);
+                codeLengthCode.writeSymbol(writer, 19);
+                writer.write(run - 3, 2);
+            }
+            else
+            {
+                run = 1;
+                codeLengthCode.writeSymbol(writer, mSizes[i]);
+            }
+            i += run;
+        }
+    }
+
+private:
+    std::vector<uint32_t> mSizes;
+    std::vector<uint32_t> mCodes;
+};
+
+template<typename T>
+void append(std::vector<uint8_t>& data, T value)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+    data.insert(data.end(), p, p + sizeof(T));
+}
+
+/// Create BasisLZ global data for a single image with an RGB slice at offset zero.
+std::vector<uint8_t> createGlobalData(
+    uint16_t endpointCount,
+    uint16_t selectorCount,
+    const std::vector<uint8_t>& endpoints,
+    const std::vector<uint8_t>& selectors,
+    const std::vector<uint8_t>& tables,
+    uint32_t sliceSize,
+    uint32_t imageFlags = 0
+)
+{
+    std::vector<uint8_t> data;
+    append<uint16_t>(data, endpointCount);
+    append<uint16_t>(data, selectorCount);
+    append<uint32_t>(data, (uint32_t)endpoints.size());
+    append<uint32_t>(data, (uint32_t)selectors.size());
+    append<uint32_t>(data, (uint32_t)tables.size());
+    append<uint32_t>(data, 0); // extendedByteLength
+    for (uint32_t value : {imageFlags, 0u, sliceSize, 0u, 0u})
+        append<uint32_t>(data, value);
+    data.insert(data.end(), endpoints.begin(), endpoints.end());
+    data.insert(data.end(), selectors.begin(), selectors.end());
+    data.insert(data.end(), tables.begin(), tables.end());
+    return data;
+}
+
+void expectPixel(CPUUnitTestContext& ctx, const uint8_t* pPixel, std::array<uint8_t, 4> expected, uint32_t x, uint32_t y)
+{
+    for (uint32_t c = 0; c < 4; c++)
+        EXPECT_EQ(pPixel[c], expected[c]) << "x = " << x << ", y = " << y << ", c = " << c;
+}
+
+/// Create a UASTC block. The mode code is followed by zero transcoding hints, then the remaining fields.
+std::vector<uint8_t> createUASTCBlock(uint32_t code, uint32_t codeBits, uint32_t hintBits, const std::vector<std::pair<uint32_t, uint32_t>>& fields)
+{
+    BitWriter writer;
+    writer.write(code, codeBits);
+    writer.write(0, hintBits);
+    for (auto [value, bits] : fields)
+        writer.write(value, bits);
+    std::vector<uint8_t> block = writer.getData();
+    block.resize(16, 0);
+    return block;
+}
+} // namespace
+
+CPU_TEST(ETC1SDecoder_Decode)
+{
+    // Endpoint codebook: endpoint 0 is black with intensity table 0, endpoint 1 is color5 (31, 16, 8) with table 3.
+    // The color deltas use different codes per model (chosen by the previous value), to check the model selection.
+    BitWriter endpoints;
+    const HuffmanCode colorModel0 = HuffmanCode::uniform(32);
+    std::vector<uint32_t> skewedSizes(32, 6);
+    std::fill_n(skewedSizes.begin(), 8, 4);
+    std::fill_n(skewedSizes.begin() + 8, 8, 5);
+    const HuffmanCode colorModel1(skewedSizes);
+    const HuffmanCode colorModel2 = HuffmanCode::uniform(32);
+    const HuffmanCode intensityModel = HuffmanCode::uniform(8);
+    colorModel0.writeTable(endpoints);
+    colorModel1.writeTable(endpoints);
+    colorModel2.writeTable(endpoints);
+    intensityModel.writeTable(endpoints);
+    endpoints.write(0, 1); // Not grayscale
+    intensityModel.writeSymbol(endpoints, 0);
+    for (int c = 0; c < 3; c++)
+        colorModel1.writeSymbol(endpoints, 16); // 16 -> 0
+    intensityModel.writeSymbol(endpoints, 3);
+    for (uint32_t delta : {31, 16, 8})
+        colorModel0.writeSymbol(endpoints, delta); // 0 -> delta
+
+    // Selector codebook with delta coded rows: selector 0 is all zero, selector 1 has a different value per row.
+    const uint8_t kSelectorRows[4] = {0xe4, 0x1b, 0xff, 0x00};
+    BitWriter selectors;
+    selectors.write(0, 3); // No global or hybrid codebook, not raw
+    const HuffmanCode selectorDeltaCode = HuffmanCode::uniform(256);
+    selectorDeltaCode.writeTable(selectors);
+    selectors.write(0, 32);
+    for (uint8_t row : kSelectorRows)
+        selectorDeltaCode.writeSymbol(selectors, row);
+
+    // Tables. Endpoint prediction symbol 0x93 selects delta and left predictors on even rows, upper and upper left
+    // predictors on odd rows. Selector symbols 0-1 are codebook indices, 2-5 history indices and 6 starts a run.
+    std::vector<uint32_t> predSizes(257, 0);
+    predSizes[0x93] = 1;
+    predSizes[256] = 1;
+    const HuffmanCode predCode(predSizes);
+    const HuffmanCode deltaCode = HuffmanCode::uniform(2);
+    const HuffmanCode selectorCode = HuffmanCode::uniform(7);
+    std::vector<uint32_t> runSizes(64, 0);
+    runSizes[0] = 1;
+    runSizes[63] = 1;
+    const HuffmanCode runCode(runSizes);
+    BitWriter tables;
+    predCode.writeTable(tables);
+    deltaCode.writeTable(tables);
+    selectorCode.writeTable(tables);
+    runCode.writeTable(tables);
+    tables.write(4, 13); // History size
+
+    // Slice of 8x2 blocks. Endpoints are 1, 1, 0, 0, 1, 1, 0, 0 in both rows.
+    BitWriter slice;
+    predCode.writeSymbol(slice, 0x93); // x = 0: delta
+    deltaCode.writeSymbol(slice, 1);
+    selectorCode.writeSymbol(slice, 1); // Selector 1, history [0, 0, 1, 0]
+    selectorCode.writeSymbol(slice, 0); // x = 1: left, selector 0, history [0, 0, 1, 0]
+    predCode.writeSymbol(slice, 256); // x = 2: repeat the prediction symbol for this and the next two pairs
+    slice.writeVLC(0, 4);
+    deltaCode.writeSymbol(slice, 1);
+    selectorCode.writeSymbol(slice, 4); // History index 2 (selector 1), history [0, 1, 0, 0]
+    selectorCode.writeSymbol(slice, 6); // x = 3: run of three history index 0 (selector 0)
+    runCode.writeSymbol(slice, 0);
+    deltaCode.writeSymbol(slice, 1); // x = 4
+    deltaCode.writeSymbol(slice, 1); // x = 6
+    selectorCode.writeSymbol(slice, 1); // Selector 1, history [0, 1, 1, 0]
+    selectorCode.writeSymbol(slice, 3); // x = 7: history index 1 (selector 1), history [1, 0, 1, 0]
+    selectorCode.writeSymbol(slice, 6); // Second row: run of 8 history index 0 (selector 1)
+    runCode.writeSymbol(slice, 63);
+    slice.writeVLC(5, 7);
+
+    const auto& sliceData = slice.getData();
+    auto globalData = createGlobalData(2, 2, endpoints.getData(), selectors.getData(), tables.getData(), (uint32_t)sliceData.size());
+    ETC1SDecoder decoder(globalData.data(), globalData.size(), 1);
+    EXPECT_EQ(decoder.getImageCount(), 1u);
+    auto pixels = decoder.decodeImage(0, sliceData.data(), sliceData.size(), 32, 8);
+    ASSERT_EQ(pixels.size(), 32u * 8 * 4);
+
+    // Colors of the endpoints for each selector value, and selector values of the selectors.
+    const uint8_t kColors[2][4][3] = {
+        {{0, 0, 0}, {0, 0, 0}, {2, 2, 2}, {8, 8, 8}},
+        {{213, 90, 24}, {242, 119, 53}, {255, 145, 79}, {255, 174, 108}},
+    };
+    const uint32_t kEndpoints[8] = {1, 1, 0, 0, 1, 1, 0, 0};
+    const uint32_t kSelectors[2][8] = {{1, 0, 1, 0, 0, 0, 1, 1}, {1, 1, 1, 1, 1, 1, 1, 1}};
+    for (uint32_t y = 0; y < 8; y++)
+    {
+        for (uint32_t x = 0; x < 32; x++)
+        {
+            const uint32_t selector = kSelectors[y / 4][x / 4];
+            const uint32_t value = selector == 0 ? 0 : (kSelectorRows[y % 4] >> (2 * (x % 4))) & 3;
+            const uint8_t* color = kColors[kEndpoints[x / 4]][value];
+            expectPixel(ctx, pixels.data() + (y * 32 + x) * 4, {color[0], color[1], color[2], 255}, x, y);
+        }
+    }
+
+    // Truncated slice.
+    EXPECT_THROW(decoder.decodeImage(0, sliceData.data(), sliceData.size() - 1, 32, 8));
+    // Slice out of bounds of the level data.
+    EXPECT_THROW(decoder.decodeImage(0, sliceData.data(), 1, 32, 8));
+}
+
+CPU_TEST(ETC1SDecoder_RawSelectorsAndAlpha)
+{
+    // Grayscale endpoint with color5 31 and intensity table 0, and a raw selector with values 0 to 3 in the first row.
+    BitWriter endpoints;
+    const HuffmanCode code32 = HuffmanCode::uniform(32);
+    const HuffmanCode code8 = HuffmanCode::uniform(8);
+    for (int i = 0; i < 3; i++)
+        code32.writeTable(endpoints);
+    code8.writeTable(endpoints);
+    endpoints.write(1, 1); // Grayscale
+    code8.writeSymbol(endpoints, 0);
+    code32.writeSymbol(endpoints, 15); // 16 -> 31
+
+    BitWriter selectors;
+    selectors.write(0b100, 3); // Raw
+    selectors.write(0x000000e4, 32);
+
+    // Single symbol codes take one bit each.
+    BitWriter tables;
+    for (const HuffmanCode& code : {HuffmanCode({0, 0, 0, 1}), HuffmanCode({1}), HuffmanCode({1, 0}), HuffmanCode({1})})
+        code.writeTable(tables);
+    tables.write(1, 13);
+
+    // 4x4 image with a single block. Both slices use endpoint 0 and selector 0.
+    BitWriter slice;
+    slice.write(0, 3);
+    std::vector<uint8_t> level = slice.getData();
+    level.push_back(slice.getData()[0]);
+
+    auto globalData = createGlobalData(1, 1, endpoints.getData(), selectors.getData(), tables.getData(), 1);
+    // Add the alpha slice to the image description.
+    const uint32_t alphaSlice[2] = {1, 1};
+    std::memcpy(globalData.data() + 20 + 12, alphaSlice, sizeof(alphaSlice));
+    ETC1SDecoder decoder(globalData.data(), globalData.size(), 1);
+    EXPECT_EQ(decoder.getImageDesc(0).alphaSliceByteLength, 1u);
+    auto pixels = decoder.decodeImage(0, level.data(), level.size(), 3, 2);
+    ASSERT_EQ(pixels.size(), 3u * 2 * 4);
+    const uint8_t kValues[4] = {247, 253, 255, 255};
+    for (uint32_t i = 0; i < 6; i++)
+    {
+        const uint8_t v = i < 3 ? kValues[i] : 247;
+        expectPixel(ctx, pixels.data() + i * 4, {v, v, v, v}, i % 3, i / 3);
+    }
+
+    // Video frames are not supported.
+    auto pFrame = createGlobalData(1, 1, endpoints.getData(), selectors.getData(), tables.getData(), 1, 2);
+    EXPECT_THROW(ETC1SDecoder(pFrame.data(), pFrame.size(), 1));
+    // Truncated global data.
+    EXPECT_THROW(ETC1SDecoder(globalData.data(), globalData.size() - 1, 1));
+}
+
+CPU_TEST(UASTCDecoder_SolidAndSingleSubset)
+{
+    uint8_t pixels[16 * 4];
+
+    // Mode 8: solid color.
+    auto solid = createUASTCBlock(0x17, 5, 0, {{10, 8}, {20, 8}, {30, 8}, {40, 8}});
+    UASTCDecoder::decodeBlock(solid.data(), pixels);
+    for (uint32_t t = 0; t < 16; t++)
+        expectPixel(ctx, pixels + t * 4, {10, 20, 30, 40}, t % 4, t / 4);
+
+    // Mode 18: RGB with 5-bit endpoints (green to red) and 5-bit weights. The weight of texel 0 has 4 bits.
+    std::vector<std::pair<uint32_t, uint32_t>> fields = {{0, 5}, {31, 5}, {31, 5}, {0, 5}, {0, 5}, {0, 5}, {0, 4}, {31, 5}, {16, 5}};
+    for (uint32_t t = 3; t < 16; t++)
+        fields.push_back({0, 5});
+    auto block = createUASTCBlock(0x09, 4, 15, fields);
+    UASTCDecoder::decodeBlock(block.data(), pixels);
+    expectPixel(ctx, pixels + 0, {0, 255, 0, 255}, 0, 0);
+    expectPixel(ctx, pixels + 4, {255, 0, 0, 255}, 1, 0);
+    expectPixel(ctx, pixels + 8, {135, 120, 0, 255}, 2, 0); // Weight 34 of 64
+    expectPixel(ctx, pixels + 60, {0, 255, 0, 255}, 3, 3);
+
+    // Mode 17: luminance and alpha with alpha in the second plane. Weights are interleaved, both weights of texel 0
+    // are anchors.
+    fields = {{0, 8}, {255, 8}, {255, 8}, {0, 8}};
+    const uint32_t kAlphaWeights[4] = {0, 2, 1, 0};
+    for (uint32_t t = 0; t < 16; t++)
+    {
+        fields.push_back({t % 4, t == 0 ? 1 : 2});
+        fields.push_back({kAlphaWeights[t % 4], t == 0 ? 1 : 2});
+    }
+    block = createUASTCBlock(0x25, 6, 23, fields);
+    UASTCDecoder::decodeBlock(block.data(), pixels);
+    const std::array<uint8_t, 4> kExpected[4] = {{0, 0, 0, 255}, {84, 84, 84, 84}, {171, 171, 171, 171}, {255, 255, 255, 255}};
+    for (uint32_t t = 0; t < 16; t++)
+        expectPixel(ctx, pixels + t * 4, kExpected[t % 4], t % 4, t / 4);
+
+    // Reserved mode.
+    auto reserved = createUASTCBlock(0x45, 7, 0, {});
+    EXPECT_THROW(UASTCDecoder::decodeBlock(reserved.data(), pixels));
+}
+
+CPU_TEST(UASTCDecoder_Subsets)
+{
+    uint8_t pixels[16 * 4];
+
+    // Mode 2: two subsets with pattern 0 (columns 0-1 and 2-3). Subset 0 is black, subset 1 goes from black to white.
+    // The anchor texels 0 and 2 have 2-bit weights.
+    std::vector<std::pair<uint32_t, uint32_t>> fields = {{0, 5}};
+    for (uint32_t i = 0; i < 12; i++)
+        fields.push_back({i >= 6 && i % 2 == 1 ? 15u : 0u, 4});
+    for (uint32_t t = 0; t < 16; t++)
+        fields.push_back({t == 2 ? 3u : (t == 3 ? 7u : (t % 4 >= 2 ? 4u : 5u)), t == 0 || t == 2 ? 2u : 3u});
+    auto block = createUASTCBlock(0x1d, 5, 15, fields);
+    UASTCDecoder::decodeBlock(block.data(), pixels);
+    for (uint32_t t = 0; t < 16; t++)
+    {
+        const uint8_t v = t % 4 < 2 ? 0 : (t == 2 ? 108 : (t == 3 ? 255 : 147));
+        expectPixel(ctx, pixels + t * 4, {v, v, v, 255}, t % 4, t / 4);
+    }
+
+    // Mode 3: three subsets with pattern 0 (top half, bottom left and bottom right) and trit encoded endpoints.
+    // The trits of all 18 endpoint values are zero, the integer sequence value 1 unquantizes to 255.
+    fields = {{0, 4}, {0, 8}, {0, 8}, {0, 8}, {0, 5}};
+    for (uint32_t i = 0; i < 18; i++)
+        fields.push_back({i / 2 % 3 == i / 6 ? 1u : 0u, 2});
+    for (uint32_t t = 0; t < 16; t++)
+        fields.push_back({0, t == 0 || t == 8 || t == 10 ? 1u : 2u});
+    block = createUASTCBlock(0x03, 5, 15, fields);
+    UASTCDecoder::decodeBlock(block.data(), pixels);
+    for (uint32_t t = 0; t < 16; t++)
+    {
+        const uint32_t subset = t < 8 ? 0 : (t % 4 < 2 ? 1 : 2);
+        const std::array<uint8_t, 4> expected = {
+            uint8_t(subset == 0 ? 255 : 0),
+            uint8_t(subset == 1 ? 255 : 0),
+            uint8_t(subset == 2 ? 255 : 0),
+            255,
+        };
+        expectPixel(ctx, pixels + t * 4, expected, t % 4, t / 4);
+    }
+
+    // Invalid pattern index.
+    block = createUASTCBlock(0x03, 5, 15, {{11, 4}});
+    EXPECT_THROW(UASTCDecoder::decodeBlock(block.data(), pixels));
+}
+
+CPU_TEST(UASTCDecoder_Image)
+{
+    // 6x5 image with 2x2 solid color blocks. Pixels outside of the image are dropped.
+    std::vector<uint8_t> data;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        auto block = createUASTCBlock(0x17, 5, 0, {{i, 8}, {uint32_t(10 * i), 8}, {0, 8}, {255, 8}});
+        data.insert(data.end(), block.begin(), block.end());
+    }
+    auto pixels = UASTCDecoder::decode(data.data(), data.size(), 6, 5);
+    ASSERT_EQ(pixels.size(), 6u * 5 * 4);
+    for (uint8_t y = 0; y < 5; y++)
+    {
+        for (uint8_t x = 0; x < 6; x++)
+        {
+            const uint8_t i = (y / 4) * 2 + x / 4;
+            expectPixel(ctx, pixels.data() + (y * 6 + x) * 4, {i, uint8_t(10 * i), 0, 255}, x, y);
+        }
+    }
+
+    EXPECT_THROW(UASTCDecoder::decode(data.data(), data.size() - 16, 6, 5));
+}
+} // namespace Falcor
@@ -27,9 +27,227 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Image/Bitmap.h"
+#include <cstring>
+#include <vector>
 
 namespace Falcor
 {
+namespace
+{
+const uint32_t kWidth = 7;
+const uint32_t kHeight = 3;
+
+template<typename T>
+Bitmap::UniqueConstPtr createBitmap(ResourceFormat format, const std::vector<T>& data)
+{
+    return Bitmap::create(kWidth, kHeight, format, reinterpret_cast<const uint8_t*>(data.data()));
+}
+
+template<typename T>
+std::vector<T> getData(const Bitmap& bitmap)
+{
+    std::vector<T> data(bitmap.getSize() / sizeof(T));
+    std::memcpy(data.data(), bitmap.getData(), bitmap.getSize());
+    return data;
+}
+
+/// Create BGRA8 texels from a function returning RGBA for each texel index.
+template<typename F>
+std::vector<uint8_t> createBGRA8(F func)
+{
+    std::vector<uint8_t> data;
+    for (uint32_t i = 0; i < kWidth * kHeight; i++)
+    {
+        uint8_t rgba[4];
+        func(i, rgba);
+        data.insert(data.end(), {rgba[2], rgba[1], rgba[0], rgba[3]});
+    }
+    return data;
+}
+} // namespace
+
+CPU_TEST(Bitmap_ReduceChannels_Grayscale)
+{
+    // Grayscale with opaque alpha is stored in a single channel.
+    auto data = createBGRA8(
+        [](uint32_t i, uint8_t* rgba)
+        {
+            rgba[0] = rgba[1] = rgba[2] = uint8_t(i * 11);
+            rgba[3] = 0xff;
+        }
+    );
+    auto pReduced = Bitmap::reduceChannels(*createBitmap(ResourceFormat::BGRA8Unorm, data));
+    ASSERT(pReduced != nullptr);
+    EXPECT(pReduced->getFormat() == ResourceFormat::R8Unorm);
+    EXPECT(pReduced->getChannelSwizzle() == Bitmap::ChannelSwizzle::Grayscale);
+    EXPECT_EQ(pReduced->getWidth(), kWidth);
+    EXPECT_EQ(pReduced->getHeight(), kHeight);
+
+    auto reduced = getData<uint8_t>(*pReduced);
+    ASSERT_EQ(reduced.size(), kWidth * kHeight);
+    for (uint32_t i = 0; i < kWidth * kHeight; i++)
+        EXPECT_EQ(reduced[i], uint8_t(i * 11)) << "i = " << i;
+
+    // The same applies to images without alpha.
+    pReduced = Bitmap::reduceChannels(*createBitmap(ResourceFormat::BGRX8Unorm, data));
+    ASSERT(pReduced != nullptr);
+    EXPECT(pReduced->getFormat() == ResourceFormat::R8Unorm);
+    EXPECT(pReduced->getChannelSwizzle() == Bitmap::ChannelSwizzle::Grayscale);
+}
+
+CPU_TEST(Bitmap_ReduceChannels_GrayscaleAlpha)
+{
+    // Grayscale with varying alpha is stored in two channels.
+    auto data = createBGRA8(
+        [](uint32_t i, uint8_t* rgba)
+        {
+            rgba[0] = rgba[1] = rgba[2] = uint8_t(i);
+            rgba[3] = uint8_t(255 - i);
+        }
+    );
+    auto pReduced = Bitmap::reduceChannels(*createBitmap(ResourceFormat::BGRA8Unorm, data));
+    ASSERT(pReduced != nullptr);
+    EXPECT(pReduced->getFormat() == ResourceFormat::RG8Unorm);
+    EXPECT(pReduced->getChannelSwizzle() == Bitmap::ChannelSwizzle::GrayscaleAlpha);
+
+    auto reduced = getData<uint8_t>(*pReduced);
+    ASSERT_EQ(reduced.size(), 2 * kWidth * kHeight);
+    for (uint32_t i = 0; i < kWidth * kHeight; i++)
+    {
+        EXPECT_EQ(reduced[2 * i + 0], uint8_t(i)) << "i = " << i;
+        EXPECT_EQ(reduced[2 * i + 1], uint8_t(255 - i)) << "i = " << i;
+    }
+}
+
+CPU_TEST(Bitmap_ReduceChannels_DropChannels)
+{
+    // Only R used: stored as R8 without swizzle, as G and B sample as zero.
+    auto dataR = createBGRA8(
+        [](uint32_t i, uint8_t* rgba)
+        {
+            rgba[0] = uint8_t(i + 1);
+            rgba[1] = rgba[2] = 0;
+            rgba[3] = 0xff;
+        }
+    );
+    auto pReduced = Bitmap::reduceChannels(*createBitmap(ResourceFormat::BGRA8Unorm, dataR));
+    ASSERT(pReduced != nullptr);
+    EXPECT(pReduced->getFormat() == ResourceFormat::R8Unorm);
+    EXPECT(pReduced->getChannelSwizzle() == Bitmap::ChannelSwizzle::Identity);
+    EXPECT_EQ(getData<uint8_t>(*pReduced)[4], uint8_t(5));
+
+    // R and G used (e.g. two-channel normal maps): stored as RG8.
+    std::vector<uint8_t> dataRG;
+    for (uint32_t i = 0; i < kWidth * kHeight; i++)
+        dataRG.insert(dataRG.end(), {uint8_t(i), uint8_t(2 * i), 0, 0xff});
+    pReduced = Bitmap::reduceChannels(*createBitmap(ResourceFormat::RGBA8Unorm, dataRG));
+    ASSERT(pReduced != nullptr);
+    EXPECT(pReduced->getFormat() == ResourceFormat::RG8Unorm);
+    EXPECT(pReduced->getChannelSwizzle() == Bitmap::ChannelSwizzle::Identity);
+
+    auto reduced = getData<uint8_t>(*pReduced);
+    ASSERT_EQ(reduced.size(), 2 * kWidth * kHeight);
+    for (uint32_t i = 0; i < kWidth * kHeight; i++)
+    {
+        EXPECT_EQ(reduced[2 * i + 0], uint8_t(i)) << "i = " << i;
+        EXPECT_EQ(reduced[2 * i + 1], uint8_t(2 * i)) << "i = " << i;
+    }
+}
+
+CPU_TEST(Bitmap_ReduceChannels_NotReducible)
+{
+    // Color images can't be reduced.
+    auto dataColor = createBGRA8(
+        [](uint32_t i, uint8_t* rgba)
+        {
+            rgba[0] = uint8_t(i);
+            rgba[1] = 3;
+            rgba[2] = 7;
+            rgba[3] = 0xff;
+        }
+    );
+    EXPECT(Bitmap::reduceChannels(*createBitmap(ResourceFormat::BGRA8Unorm, dataColor)) == nullptr);
+
+    // Neither can images with two color channels and alpha.
+    auto dataAlpha = createBGRA8(
+        [](uint32_t i, uint8_t* rgba)
+        {
+            rgba[0] = uint8_t(i);
+            rgba[1] = 3;
+            rgba[2] = 0;
+            rgba[3] = uint8_t(i);
+        }
+    );
+    EXPECT(Bitmap::reduceChannels(*createBitmap(ResourceFormat::BGRA8Unorm, dataAlpha)) == nullptr);
+
+    // A single texel breaking the pattern prevents the reduction.
+    auto dataAlmostGray = createBGRA8(
+        [](uint32_t i, uint8_t* rgba)
+        {
+            rgba[0] = rgba[1] = rgba[2] = uint8_t(i);
+            rgba[3] = 0xff;
+            if (i == kWidth * kHeight - 1)
+                rgba[1]++;
+        }
+    );
+    auto pReduced = Bitmap::reduceChannels(*createBitmap(ResourceFormat::BGRA8Unorm, dataAlmostGray));
+    EXPECT(pReduced == nullptr);
+
+    // Unsupported formats are left alone.
+    std::vector<uint32_t> dataUint(kWidth * kHeight, 0);
+    EXPECT(Bitmap::reduceChannels(*createBitmap(ResourceFormat::R32Uint, dataUint)) == nullptr);
+}
+
+CPU_TEST(Bitmap_ReduceChannels_Float)
+{
+    // Grayscale half-float images are stored as R16Float.
+    const uint16_t kOneHalf = 0x3c00;
+    std::vector<uint16_t> dataHalf;
+    for (uint32_t i = 0; i < kWidth * kHeight; i++)
+        dataHalf.insert(dataHalf.end(), {uint16_t(i), uint16_t(i), uint16_t(i), kOneHalf});
+    auto pReduced = Bitmap::reduceChannels(*createBitmap(ResourceFormat::RGBA16Float, dataHalf));
+    ASSERT(pReduced != nullptr);
+    EXPECT(pReduced->getFormat() == ResourceFormat::R16Float);
+    EXPECT(pReduced->getChannelSwizzle() == Bitmap::ChannelSwizzle::Grayscale);
+    auto reducedHalf = getData<uint16_t>(*pReduced);
+    ASSERT_EQ(reducedHalf.size(), kWidth * kHeight);
+    for (uint32_t i = 0; i < kWidth * kHeight; i++)
+        EXPECT_EQ(reducedHalf[i], uint16_t(i)) << "i = " << i;
+
+    // Two-channel float images keep full precision.
+    std::vector<float> dataFloat;
+    for (uint32_t i = 0; i < kWidth * kHeight; i++)
+        dataFloat.insert(dataFloat.end(), {float(i) * 0.5f, -float(i), 0.f, 1.f});
+    pReduced = Bitmap::reduceChannels(*createBitmap(ResourceFormat::RGBA32Float, dataFloat));
+    ASSERT(pReduced != nullptr);
+    EXPECT(pReduced->getFormat() == ResourceFormat::RG32Float);
+    EXPECT(pReduced->getChannelSwizzle() == Bitmap::ChannelSwizzle::Identity);
+    auto reducedFloat = getData<float>(*pReduced);
+    ASSERT_EQ(reducedFloat.size(), 2 * kWidth * kHeight);
+    for (uint32_t i = 0; i < kWidth * kHeight; i++)
+    {
+        EXPECT_EQ(reducedFloat[2 * i + 0], float(i) * 0.5f) << "i = " << i;
+        EXPECT_EQ(reducedFloat[2 * i + 1], -float(i)) << "i = " << i;
+    }
+
+    // Negative zero is not zero bitwise, so the channel is kept.
+    dataFloat[2] = -0.f;
+    pReduced = Bitmap::reduceChannels(*createBitmap(ResourceFormat::RGBA32Float, dataFloat));
+    EXPECT(pReduced == nullptr);
+}
+
+CPU_TEST(Bitmap_ReduceChannels_SingleChannel)
+{
+    // Images already stored in a single channel are not reduced and keep sampling as they did before.
+    std::vector<uint8_t> data(kWidth * kHeight);
+    for (uint32_t i = 0; i < data.size(); i++)
+        data[i] = uint8_t(i * 3);
+    EXPECT(Bitmap::reduceChannels(*createBitmap(ResourceFormat::R8Unorm, data)) == nullptr);
+
+    std::vector<uint16_t> data16(kWidth * kHeight, 0x1234);
+    EXPECT(Bitmap::reduceChannels(*createBitmap(ResourceFormat::R16Unorm, data16)) == nullptr);
+}
+
 GPU_TEST(Bitmap_LinearRamp_PNG)
 {
     const auto path = getRuntimeDirectory() / "test_linear_ramp.png";
@@ -0,0 +1,430 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/BCEncoder.h"
+#include "Utils/Image/KTX2File.h"
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+const uint32_t kVkFormatR8G8B8Unorm = 23;
+const uint32_t kVkFormatR8G8B8A8Unorm = 37;
+const uint32_t kVkFormatBC7Unorm = 145;
+
+struct KTX2Desc
+{
+    uint32_t vkFormat = kVkFormatR8G8B8A8Unorm;
+    uint32_t width = 1;
+    uint32_t height = 1;
+    uint32_t layerCount = 0;
+    uint32_t faceCount = 1;
+    uint32_t supercompression = 0;
+    uint8_t colorModel = 1; // RGBSDA
+    uint8_t transferFunction = 1; // Linear
+    uint32_t sampleCount = 1;
+};
+
+template<typename T>
+void append(std::vector<uint8_t>& data, T value)
+{
+    const uint8_t* p = reinterpret_cast<const uint8_t*>(&value);
+    data.insert(data.end(), p, p + sizeof(T));
+}
+
+/// Create a KTX2 file. Each level is given as (stored data, uncompressed size).
+std::vector<uint8_t> createKTX2(
+    const KTX2Desc& desc,
+    const std::vector<std::pair<std::vector<uint8_t>, size_t>>& levels,
+    const std::vector<uint8_t>& globalData = {}
+)
+{
+    const uint32_t dfdSize = 28 + 16 * desc.sampleCount;
+    const uint32_t dfdOffset = 80 + 24 * (uint32_t)levels.size();
+    const uint64_t sgdOffset = globalData.empty() ? 0 : (dfdOffset + dfdSize + 7) & ~7u;
+
+    std::vector<uint8_t> data = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+    append<uint32_t>(data, desc.vkFormat);
+    append<uint32_t>(data, 1); // typeSize
+    append<uint32_t>(data, desc.width);
+    append<uint32_t>(data, desc.height);
+    append<uint32_t>(data, 0); // pixelDepth
+    append<uint32_t>(data, desc.layerCount);
+    append<uint32_t>(data, desc.faceCount);
+    append<uint32_t>(data, (uint32_t)levels.size());
+    append<uint32_t>(data, desc.supercompression);
+    append<uint32_t>(data, dfdOffset);
+    append<uint32_t>(data, dfdSize);
+    append<uint32_t>(data, 0); // kvdByteOffset
+    append<uint32_t>(data, 0); // kvdByteLength
+    append<uint64_t>(data, sgdOffset);
+    append<uint64_t>(data, globalData.size());
+
+    uint64_t offset = globalData.empty() ? dfdOffset + dfdSize : sgdOffset + globalData.size();
+    for (const auto& [level, uncompressedSize] : levels)
+    {
+        append<uint64_t>(data, offset);
+        append<uint64_t>(data, level.size());
+        append<uint64_t>(data, uncompressedSize);
+        offset += level.size();
+    }
+
+    // Data format descriptor with a basic descriptor block.
+    append<uint32_t>(data, dfdSize);
+    append<uint32_t>(data, 0);
+    append<uint32_t>(data, (dfdSize - 4) << 16 | 2);
+    data.insert(data.end(), {desc.colorModel, 1, desc.transferFunction, 0});
+    data.resize(dfdOffset + dfdSize);
+
+    if (!globalData.empty())
+    {
+        data.resize(sgdOffset);
+        data.insert(data.end(), globalData.begin(), globalData.end());
+    }
+
+    for (const auto& level : levels)
+        data.insert(data.end(), level.first.begin(), level.first.end());
+    return data;
+}
+
+std::vector<uint8_t> createSequence(size_t size, uint8_t first)
+{
+    std::vector<uint8_t> data(size);
+    std::iota(data.begin(), data.end(), first);
+    return data;
+}
+
+/// Wrap data in a zlib stream with a single stored (uncompressed) deflate block.
+std::vector<uint8_t> createZlibStream(const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> stream = {0x78, 0x01, 0x01};
+    append<uint16_t>(stream, (uint16_t)data.size());
+    append<uint16_t>(stream, (uint16_t)~data.size());
+    stream.insert(stream.end(), data.begin(), data.end());
+    uint32_t a = 1, b = 0;
+    for (uint8_t value : data)
+    {
+        a = (a + value) % 65521;
+        b = (b + a) % 65521;
+    }
+    uint32_t adler = (b << 16) | a;
+    stream.insert(stream.end(), {uint8_t(adler >> 24), uint8_t(adler >> 16), uint8_t(adler >> 8), uint8_t(adler)});
+    return stream;
+}
+
+/// Wrap data in a Zstandard frame with a single raw block.
+std::vector<uint8_t> createZstdFrame(const std::vector<uint8_t>& data)
+{
+    std::vector<uint8_t> frame = {0x28, 0xb5, 0x2f, 0xfd, 0x20, (uint8_t)data.size()};
+    uint32_t blockHeader = uint32_t(data.size() << 3) | 1;
+    frame.insert(frame.end(), {uint8_t(blockHeader), uint8_t(blockHeader >> 8), uint8_t(blockHeader >> 16)});
+    frame.insert(frame.end(), data.begin(), data.end());
+    return frame;
+}
+
+/**
+ * BasisLZ endpoint codebook (50 bytes), selector codebook (5 bytes) and Huffman tables (47 bytes).
+ * There is a single grayscale endpoint with color5 31 and intensity table 0, and a single raw selector with values
+ * 0 to 3 in the first row and 0 elsewhere. A slice byte of zero decodes a block with endpoint 0 and selector 0.
+ */
+const uint8_t kETC1SCodebooks[] = {
+    0x20, 0x40, 0x25, 0x49, 0x92, 0x24, 0xd9, 0xb6, 0x6d, 0xdb, 0x62, 0x61, 0x20, 0x40, 0x25, 0x49, 0x92, 0x24, 0xd9,
+    0xb6, 0x6d, 0xdb, 0x62, 0x61, 0x20, 0x40, 0x25, 0x49, 0x92, 0x24, 0xd9, 0xb6, 0x6d, 0xdb, 0x62, 0x61, 0x08, 0x40,
+    0x25, 0x49, 0x92, 0x24, 0xd9, 0xb6, 0x6d, 0xdb, 0x8e, 0x02, 0xc2, 0x03, 0x24, 0x07, 0x00, 0x00, 0x00, 0x04, 0x40,
+    0x25, 0x49, 0x92, 0x24, 0xd9, 0xb6, 0x6d, 0xdb, 0x3a, 0x5a, 0x00, 0x50, 0x49, 0x92, 0x24, 0x49, 0xb6, 0x6d, 0xdb,
+    0xb6, 0x4d, 0x00, 0xa8, 0x24, 0x49, 0x92, 0x24, 0xdb, 0xb6, 0x6d, 0xdb, 0x06, 0x01, 0x40, 0x25, 0x49, 0x92, 0x24,
+    0xd9, 0xb6, 0x6d, 0xdb, 0xb6, 0x00, 0x00,
+};
+
+/// Create BasisLZ global data for a single image using kETC1SCodebooks, with one-byte RGB and alpha slices.
+std::vector<uint8_t> createETC1SGlobalData(bool hasAlpha)
+{
+    std::vector<uint8_t> data;
+    append<uint16_t>(data, 1); // endpointCount
+    append<uint16_t>(data, 1); // selectorCount
+    append<uint32_t>(data, 50); // endpointsByteLength
+    append<uint32_t>(data, 5); // selectorsByteLength
+    append<uint32_t>(data, 47); // tablesByteLength
+    append<uint32_t>(data, 0); // extendedByteLength
+    // Image description: flags, RGB slice offset and length, alpha slice offset and length.
+    for (uint32_t value : {0u, 0u, 1u, hasAlpha ? 1u : 0u, hasAlpha ? 1u : 0u})
+        append<uint32_t>(data, value);
+    data.insert(data.end(), std::begin(kETC1SCodebooks), std::end(kETC1SCodebooks));
+    return data;
+}
+
+/// Create a UASTC solid color block (mode 8).
+std::vector<uint8_t> createUASTCSolidBlock(uint8_t r, uint8_t g, uint8_t b, uint8_t a)
+{
+    const uint64_t bits = 0x17 | uint64_t(r) << 5 | uint64_t(g) << 13 | uint64_t(b) << 21 | uint64_t(a) << 29;
+    std::vector<uint8_t> block(16, 0);
+    std::memcpy(block.data(), &bits, sizeof(bits));
+    return block;
+}
+} // namespace
+
+CPU_TEST(KTX2File_ArrayWithMips)
+{
+    // 4x2 RGBA8 texture array with two layers and two mip levels.
+    KTX2Desc desc;
+    desc.width = 4;
+    desc.height = 2;
+    desc.layerCount = 2;
+    auto level0 = createSequence(4 * 2 * 4 * 2, 0);
+    auto level1 = createSequence(2 * 1 * 4 * 2, 100);
+    auto file = createKTX2(desc, {{level0, level0.size()}, {level1, level1.size()}});
+
+    KTX2File ktx = KTX2File::loadFromMemory(file.data(), file.size());
+    EXPECT_EQ(ktx.getFormat(), ResourceFormat::RGBA8Unorm);
+    EXPECT_EQ(ktx.getWidth(), 4u);
+    EXPECT_EQ(ktx.getHeight(), 2u);
+    EXPECT_EQ(ktx.getDepth(), 1u);
+    EXPECT_EQ(ktx.getArraySize(), 2u);
+    EXPECT_EQ(ktx.getFaceCount(), 1u);
+    EXPECT_EQ(ktx.getMipCount(), 2u);
+    EXPECT_EQ(ktx.getDimensions(), 2u);
+    EXPECT(ktx.isArray());
+    EXPECT(!ktx.isMipGenerationRequested());
+
+    EXPECT_EQ(ktx.getImageSize(0), 32u);
+    EXPECT_EQ(ktx.getImageSize(1), 8u);
+    EXPECT(std::memcmp(ktx.getImageData(0, 1, 0), level0.data() + 32, 32) == 0);
+    EXPECT(std::memcmp(ktx.getImageData(1, 0, 0), level1.data(), 8) == 0);
+    EXPECT(std::memcmp(ktx.getImageData(1, 1, 0), level1.data() + 8, 8) == 0);
+}
+
+CPU_TEST(KTX2File_MipRange)
+{
+    // 4x4 RGBA8 texture with three mip levels. The first level is corrupt and is only an error if it is decoded.
+    KTX2Desc desc;
+    desc.width = 4;
+    desc.height = 4;
+    desc.supercompression = 3; // Zlib
+    auto level1 = createSequence(2 * 2 * 4, 10);
+    auto level2 = createSequence(1 * 1 * 4, 50);
+    auto file = createKTX2(
+        desc,
+        {{std::vector<uint8_t>(8, 0xff), 64}, {createZlibStream(level1), level1.size()}, {createZlibStream(level2), level2.size()}}
+    );
+
+    EXPECT_THROW(KTX2File::loadFromMemory(file.data(), file.size()));
+
+    KTX2File ktx = KTX2File::loadFromMemory(file.data(), file.size(), 1, 1);
+    EXPECT_EQ(ktx.getMipCount(), 3u);
+    EXPECT(!ktx.isMipLoaded(0));
+    EXPECT(ktx.isMipLoaded(1));
+    EXPECT(!ktx.isMipLoaded(2));
+    EXPECT(std::memcmp(ktx.getImageData(1, 0, 0), level1.data(), level1.size()) == 0);
+    EXPECT_THROW(ktx.getImageData(2, 0, 0));
+
+    // Ranges extending past the last level are clamped.
+    ktx = KTX2File::loadFromMemory(file.data(), file.size(), 2);
+    EXPECT(!ktx.isMipLoaded(1));
+    EXPECT(std::memcmp(ktx.getImageData(2, 0, 0), level2.data(), level2.size()) == 0);
+}
+
+CPU_TEST(KTX2File_RGB8Srgb)
+{
+    // Three-channel data is expanded to RGBA, and the sRGB transfer function selects an sRGB format.
+    KTX2Desc desc;
+    desc.vkFormat = kVkFormatR8G8B8Unorm;
+    desc.width = 2;
+    desc.height = 1;
+    desc.transferFunction = 2;
+    std::vector<uint8_t> level = {1, 2, 3, 4, 5, 6};
+    auto file = createKTX2(desc, {{level, level.size()}});
+
+    KTX2File ktx = KTX2File::loadFromMemory(file.data(), file.size());
+    EXPECT_EQ(ktx.getFormat(), ResourceFormat::RGBA8UnormSrgb);
+    EXPECT_EQ(ktx.getDimensions(), 2u);
+    EXPECT(!ktx.isArray());
+    ASSERT_EQ(ktx.getImageSize(0), 8u);
+    const std::vector<uint8_t> expected = {1, 2, 3, 255, 4, 5, 6, 255};
+    EXPECT(std::memcmp(ktx.getImageData(0, 0, 0), expected.data(), expected.size()) == 0);
+}
+
+CPU_TEST(KTX2File_Supercompression)
+{
+    KTX2Desc desc;
+    desc.width = 4;
+    desc.height = 4;
+    auto level0 = createSequence(4 * 4 * 4, 3);
+    auto level1 = createSequence(2 * 2 * 4, 200);
+
+    for (uint32_t scheme : {2u, 3u})
+    {
+        desc.supercompression = scheme;
+        auto compress = scheme == 2 ? createZstdFrame : createZlibStream;
+        auto file = createKTX2(desc, {{compress(level0), level0.size()}, {compress(level1), level1.size()}});
+
+        KTX2File ktx = KTX2File::loadFromMemory(file.data(), file.size());
+        EXPECT_EQ((uint32_t)ktx.getSupercompression(), scheme);
+        ASSERT_EQ(ktx.getMipCount(), 2u);
+        EXPECT(std::memcmp(ktx.getImageData(0, 0, 0), level0.data(), level0.size()) == 0);
+        EXPECT(std::memcmp(ktx.getImageData(1, 0, 0), level1.data(), level1.size()) == 0);
+    }
+}
+
+CPU_TEST(KTX2File_BlockCompressedCube)
+{
+    // 8x8 BC7 cube map has 2x2 blocks of 16 bytes per face.
+    KTX2Desc desc;
+    desc.vkFormat = kVkFormatBC7Unorm;
+    desc.width = 8;
+    desc.height = 8;
+    desc.faceCount = 6;
+    auto level = createSequence(6 * 64, 0);
+    auto file = createKTX2(desc, {{level, level.size()}});
+
+    KTX2File ktx = KTX2File::loadFromMemory(file.data(), file.size());
+    EXPECT_EQ(ktx.getFormat(), ResourceFormat::BC7Unorm);
+    EXPECT_EQ(ktx.getFaceCount(), 6u);
+    EXPECT_EQ(ktx.getImageSize(0), 64u);
+    EXPECT(std::memcmp(ktx.getImageData(0, 0, 5), level.data() + 5 * 64, 64) == 0);
+}
+
+CPU_TEST(KTX2File_ETC1S)
+{
+    // 4x4 ETC1S texture with a single block. Selector values 0 to 3 in the first row give 247, 253, 255 and 255.
+    std::vector<uint8_t> pixels(4 * 4 * 4);
+    const uint8_t kValues[4] = {247, 253, 255, 255};
+    for (uint32_t i = 0; i < 16; i++)
+        std::fill_n(pixels.begin() + i * 4, 3, i < 4 ? kValues[i] : 247);
+
+    KTX2Desc desc;
+    desc.vkFormat = 0;
+    desc.width = 4;
+    desc.height = 4;
+    desc.supercompression = 1; // BasisLZ
+    desc.colorModel = 163; // ETC1S
+
+    // Without an alpha slice the data is transcoded to BC1.
+    for (uint32_t i = 0; i < 16; i++)
+        pixels[i * 4 + 3] = 255;
+    auto file = createKTX2(desc, {{{0}, 0}}, createETC1SGlobalData(false));
+    KTX2File ktx = KTX2File::loadFromMemory(file.data(), file.size());
+    EXPECT_EQ(ktx.getFormat(), ResourceFormat::BC1Unorm);
+    auto expected = BCEncoder::compress(ResourceFormat::BC1Unorm, 4, 4, pixels.data());
+    ASSERT_EQ(ktx.getImageSize(0), expected.size());
+    EXPECT(std::memcmp(ktx.getImageData(0, 0, 0), expected.data(), expected.size()) == 0);
+
+    // With an alpha slice (second sample in the data format descriptor) the data is transcoded to BC3. Alpha is taken
+    // from the green channel of the alpha slice.
+    for (uint32_t i = 0; i < 16; i++)
+        pixels[i * 4 + 3] = pixels[i * 4 + 1];
+    desc.sampleCount = 2;
+    desc.transferFunction = 2;
+    file = createKTX2(desc, {{{0, 0}, 0}}, createETC1SGlobalData(true));
+    ktx = KTX2File::loadFromMemory(file.data(), file.size());
+    EXPECT_EQ(ktx.getFormat(), ResourceFormat::BC3UnormSrgb);
+    expected = BCEncoder::compress(ResourceFormat::BC3Unorm, 4, 4, pixels.data());
+    ASSERT_EQ(ktx.getImageSize(0), expected.size());
+    EXPECT(std::memcmp(ktx.getImageData(0, 0, 0), expected.data(), expected.size()) == 0);
+}
+
+CPU_TEST(KTX2File_UASTC)
+{
+    // 8x4 UASTC texture with two solid color blocks and Zstandard supercompression is transcoded to BC7.
+    KTX2Desc desc;
+    desc.vkFormat = 0;
+    desc.width = 8;
+    desc.height = 4;
+    desc.supercompression = 2; // Zstd
+    desc.colorModel = 166; // UASTC
+    auto level = createUASTCSolidBlock(10, 20, 30, 40);
+    auto block = createUASTCSolidBlock(200, 150, 100, 255);
+    level.insert(level.end(), block.begin(), block.end());
+    auto file = createKTX2(desc, {{createZstdFrame(level), level.size()}});
+
+    std::vector<uint8_t> pixels(8 * 4 * 4);
+    for (uint32_t i = 0; i < 32; i++)
+    {
+        const bool isLeft = i % 8 < 4;
+        const uint8_t color[4] = {uint8_t(isLeft ? 10 : 200), uint8_t(isLeft ? 20 : 150), uint8_t(isLeft ? 30 : 100), uint8_t(isLeft ? 40 : 255)};
+        std::memcpy(pixels.data() + i * 4, color, 4);
+    }
+
+    KTX2File ktx = KTX2File::loadFromMemory(file.data(), file.size());
+    EXPECT_EQ(ktx.getFormat(), ResourceFormat::BC7Unorm);
+    auto expected = BCEncoder::compress(ResourceFormat::BC7Unorm, 8, 4, pixels.data());
+    ASSERT_EQ(ktx.getImageSize(0), expected.size());
+    EXPECT(std::memcmp(ktx.getImageData(0, 0, 0), expected.data(), expected.size()) == 0);
+}
+
+CPU_TEST(KTX2File_Errors)
+{
+    KTX2Desc desc;
+    desc.width = 2;
+    desc.height = 2;
+    auto level = createSequence(16, 0);
+
+    auto file = createKTX2(desc, {{level, level.size()}});
+    KTX2File::loadFromMemory(file.data(), file.size());
+
+    // Invalid identifier.
+    auto invalid = file;
+    invalid[1] = 'X';
+    EXPECT_THROW(KTX2File::loadFromMemory(invalid.data(), invalid.size()));
+
+    // Truncated level data.
+    EXPECT_THROW(KTX2File::loadFromMemory(file.data(), file.size() - 1));
+
+    // Level size doesn't match the image size.
+    auto shortLevel = createKTX2(desc, {{createSequence(12, 0), 12}});
+    EXPECT_THROW(KTX2File::loadFromMemory(shortLevel.data(), shortLevel.size()));
+
+    // Unsupported format.
+    KTX2Desc unsupported = desc;
+    unsupported.vkFormat = 1000;
+    auto unsupportedFile = createKTX2(unsupported, {{level, level.size()}});
+    EXPECT_THROW(KTX2File::loadFromMemory(unsupportedFile.data(), unsupportedFile.size()));
+
+    // BasisLZ supercompression without global data.
+    KTX2Desc basisLZ = desc;
+    basisLZ.vkFormat = 0;
+    basisLZ.supercompression = 1;
+    basisLZ.colorModel = 163;
+    auto basisLZFile = createKTX2(basisLZ, {{level, 0}});
+    EXPECT_THROW(KTX2File::loadFromMemory(basisLZFile.data(), basisLZFile.size()));
+
+    // BasisLZ supercompression of UASTC data.
+    basisLZ.colorModel = 166;
+    basisLZFile = createKTX2(basisLZ, {{level, 0}}, createETC1SGlobalData(false));
+    EXPECT_THROW(KTX2File::loadFromMemory(basisLZFile.data(), basisLZFile.size()));
+
+    // UASTC data with a size that doesn't match the block count.
+    KTX2Desc uastc = desc;
+    uastc.vkFormat = 0;
+    uastc.colorModel = 166;
+    auto uastcFile = createKTX2(uastc, {{createSequence(32, 0), 32}});
+    EXPECT_THROW(KTX2File::loadFromMemory(uastcFile.data(), uastcFile.size()));
+}
+} // namespace Falcor
@@ -0,0 +1,300 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/TextureAtlas.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+struct Rect
+{
+    uint2 pos;
+    uint2 size;
+};
+
+bool overlaps(const Rect& a, const Rect& b)
+{
+    return a.pos.x < b.pos.x + b.size.x && b.pos.x < a.pos.x + a.size.x && a.pos.y < b.pos.y + b.size.y && b.pos.y < a.pos.y + a.size.y;
+}
+
+/// Single-channel 8-bit texture with unique texel values.
+std::vector<uint8_t> createTexture(uint32_t width, uint32_t height, uint32_t seed)
+{
+    std::vector<uint8_t> data(size_t(width) * height);
+    for (size_t i = 0; i < data.size(); i++)
+        data[i] = (uint8_t)(seed * 31 + i * 7);
+    return data;
+}
+
+/// 2x2 box filter of a single-channel image with even dimensions.
+std::vector<float> downsample(const std::vector<float>& image, uint32_t width, uint32_t height)
+{
+    std::vector<float> result(size_t(width / 2) * (height / 2));
+    for (uint32_t y = 0; y < height / 2; y++)
+        for (uint32_t x = 0; x < width / 2; x++)
+            result[y * (width / 2) + x] = 0.25f * (image[(2 * y) * width + 2 * x] + image[(2 * y) * width + 2 * x + 1] +
+                                                   image[(2 * y + 1) * width + 2 * x] + image[(2 * y + 1) * width + 2 * x + 1]);
+    return result;
+}
+} // namespace
+
+CPU_TEST(SkylinePacker_NoOverlap)
+{
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<uint32_t> dist(1, 40);
+
+    SkylinePacker packer(256, 256);
+    std::vector<Rect> rects;
+    uint64_t area = 0;
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        uint2 size(dist(rng), dist(rng));
+        auto pos = packer.insert(size);
+        if (!pos)
+            continue;
+        Rect rect{*pos, size};
+        EXPECT_LE(rect.pos.x + size.x, 256u);
+        EXPECT_LE(rect.pos.y + size.y, 256u);
+        for (const auto& other : rects)
+            EXPECT(!overlaps(rect, other));
+        rects.push_back(rect);
+        area += uint64_t(size.x) * size.y;
+    }
+
+    EXPECT_EQ(packer.getUsedArea(), area);
+    EXPECT_GT(area, 256ull * 256ull * 3 / 4);
+    EXPECT_LE(packer.getUsedSize().x, 256u);
+    EXPECT_LE(packer.getUsedSize().y, 256u);
+}
+
+CPU_TEST(SkylinePacker_Full)
+{
+    // Equal squares tile the area exactly.
+    SkylinePacker packer(64, 64);
+    for (uint32_t i = 0; i < 16; i++)
+        EXPECT(packer.insert(uint2(16)).has_value());
+    EXPECT(!packer.insert(uint2(1)).has_value());
+    EXPECT_EQ(packer.getUsedArea(), 64ull * 64ull);
+
+    SkylinePacker small(8, 8);
+    EXPECT(!small.insert(uint2(9, 1)).has_value());
+    EXPECT(!small.insert(uint2(1, 9)).has_value());
+    EXPECT(small.insert(uint2(8, 8)).has_value());
+}
+
+CPU_TEST(TextureAtlasBuilder_Layout)
+{
+    TextureAtlasSettings settings;
+    settings.maxTextureSize = 64;
+    settings.atlasSize = 256;
+    settings.mipLevels = 4;
+    const uint32_t padding = TextureAtlasBuilder::getPadding(settings.mipLevels);
+    EXPECT_EQ(padding, 8u);
+
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<uint32_t> dist(1, 64);
+
+    TextureAtlasBuilder builder(settings);
+    std::vector<std::vector<uint8_t>> textures;
+    for (uint32_t i = 0; i < 100; i++)
+    {
+        uint32_t width = dist(rng), height = dist(rng);
+        textures.push_back(createTexture(width, height, i));
+        EXPECT_EQ(builder.addTexture(ResourceFormat::R8Unorm, width, height, textures.back()), i);
+    }
+    builder.build();
+
+    const auto& atlases = builder.getAtlases();
+    EXPECT_GT(atlases.size(), 1u);
+
+    size_t entryCount = 0;
+    for (uint32_t a = 0; a < atlases.size(); a++)
+    {
+        const auto& atlas = atlases[a];
+        EXPECT(atlas.format == ResourceFormat::R8Unorm);
+        EXPECT_LE(atlas.width, settings.atlasSize);
+        EXPECT_LE(atlas.height, settings.atlasSize);
+        EXPECT_EQ(atlas.width % padding, 0u);
+        EXPECT_EQ(atlas.height % padding, 0u);
+        EXPECT_EQ(atlas.data.size(), size_t(atlas.width) * atlas.height);
+        entryCount += atlas.entries.size();
+
+        for (uint32_t i : atlas.entries)
+        {
+            const auto& entry = builder.getEntry(i);
+            EXPECT_EQ(entry.atlasIndex, a);
+            EXPECT_EQ(entry.offset.x % padding, 0u);
+            EXPECT_EQ(entry.offset.y % padding, 0u);
+            EXPECT_GE(entry.offset.x, padding);
+            EXPECT_GE(entry.offset.y, padding);
+            EXPECT_LE(entry.offset.x + entry.size.x + padding, atlas.width);
+            EXPECT_LE(entry.offset.y + entry.size.y + padding, atlas.height);
+
+            // Padded cells don't overlap.
+            Rect cell{entry.offset - padding, entry.size + 2 * padding};
+            for (uint32_t j : atlas.entries)
+            {
+                if (j == i)
+                    continue;
+                const auto& other = builder.getEntry(j);
+                EXPECT(!overlaps(cell, Rect{other.offset, other.size}));
+            }
+
+            // The texture and its padding repeat the texture.
+            const auto& texture = textures[i];
+            uint32_t errors = 0;
+            for (int y = -(int)padding; y < (int)(entry.size.y + padding); y++)
+            {
+                for (int x = -(int)padding; x < (int)(entry.size.x + padding); x++)
+                {
+                    uint32_t sx = (x + entry.size.x * padding) % entry.size.x;
+                    uint32_t sy = (y + entry.size.y * padding) % entry.size.y;
+                    uint8_t value = atlas.data[(entry.offset.y + y) * atlas.width + entry.offset.x + x];
+                    if (value != texture[sy * entry.size.x + sx])
+                        errors++;
+                }
+            }
+            EXPECT_EQ(errors, 0u);
+
+            // The UV transform maps [0,1] onto the texture.
+            float4 transform = builder.getUvTransform(i);
+            EXPECT_LT(std::abs(transform.z * atlas.width - entry.offset.x), 1e-3f);
+            EXPECT_LT(std::abs(transform.w * atlas.height - entry.offset.y), 1e-3f);
+            EXPECT_LT(std::abs((transform.x + transform.z) * atlas.width - (entry.offset.x + entry.size.x)), 1e-3f);
+            EXPECT_LT(std::abs((transform.y + transform.w) * atlas.height - (entry.offset.y + entry.size.y)), 1e-3f);
+        }
+    }
+    EXPECT_EQ(entryCount, 100u);
+}
+
+CPU_TEST(TextureAtlasBuilder_MipPadding)
+{
+    // With cells aligned to 2^(mipLevels-1) texels, each box-filtered mip of the atlas equals the
+    // box-filtered mip of the texture repeated, within the texture and at least one texel around it.
+    TextureAtlasSettings settings;
+    settings.maxTextureSize = 16;
+    settings.atlasSize = 128;
+    settings.mipLevels = 3;
+    const uint32_t padding = TextureAtlasBuilder::getPadding(settings.mipLevels);
+
+    TextureAtlasBuilder builder(settings);
+    const uint32_t sizes[][2] = {{16, 16}, {8, 4}, {4, 16}, {12, 8}, {16, 8}};
+    std::vector<std::vector<uint8_t>> textures;
+    for (uint32_t i = 0; i < 5; i++)
+    {
+        textures.push_back(createTexture(sizes[i][0], sizes[i][1], i));
+        builder.addTexture(ResourceFormat::R8Unorm, sizes[i][0], sizes[i][1], textures.back());
+    }
+    builder.build();
+    ASSERT_EQ(builder.getAtlases().size(), 1u);
+    const auto& atlas = builder.getAtlases()[0];
+
+    std::vector<float> mip(atlas.data.begin(), atlas.data.end());
+    uint32_t width = atlas.width, height = atlas.height;
+    for (uint32_t level = 1; level < settings.mipLevels; level++)
+    {
+        mip = downsample(mip, width, height);
+        width /= 2;
+        height /= 2;
+        const uint32_t scale = 1u << level;
+
+        for (uint32_t i = 0; i < 5; i++)
+        {
+            const auto& entry = builder.getEntry(i);
+            if (entry.size.x % scale != 0 || entry.size.y % scale != 0)
+                continue;
+
+            // Reference: box filter of the texture repeated over the texture and the padding.
+            const uint2 refSize = (entry.size + 2 * padding) / scale;
+            uint32_t errors = 0;
+            for (uint32_t y = 0; y < refSize.y; y++)
+            {
+                for (uint32_t x = 0; x < refSize.x; x++)
+                {
+                    float sum = 0.f;
+                    for (uint32_t dy = 0; dy < scale; dy++)
+                    {
+                        for (uint32_t dx = 0; dx < scale; dx++)
+                        {
+                            uint32_t sx = (x * scale + dx + entry.size.x * padding - padding) % entry.size.x;
+                            uint32_t sy = (y * scale + dy + entry.size.y * padding - padding) % entry.size.y;
+                            sum += textures[i][sy * entry.size.x + sx];
+                        }
+                    }
+                    uint2 p = (entry.offset - padding) / scale + uint2(x, y);
+                    if (std::abs(mip[p.y * width + p.x] - sum / (scale * scale)) > 1e-3f)
+                        errors++;
+                }
+            }
+            EXPECT_EQ(errors, 0u);
+        }
+    }
+}
+
+CPU_TEST(TextureAtlasBuilder_Formats)
+{
+    TextureAtlasSettings settings;
+    settings.atlasSize = 512;
+    TextureAtlasBuilder builder(settings);
+
+    EXPECT(builder.canPack(ResourceFormat::RGBA8Unorm, 64, 64));
+    EXPECT(!builder.canPack(ResourceFormat::RGBA8Unorm, 65, 64));
+    EXPECT(!builder.canPack(ResourceFormat::BC1Unorm, 64, 64));
+    EXPECT(!builder.canPack(ResourceFormat::RGBA8Unorm, 0, 64));
+
+    uint32_t a = builder.addTexture(ResourceFormat::RGBA8Unorm, 4, 4, std::vector<uint8_t>(64, 1));
+    uint32_t b = builder.addTexture(ResourceFormat::RG8Unorm, 4, 4, std::vector<uint8_t>(32, 2));
+    uint32_t c = builder.addTexture(ResourceFormat::RGBA8Unorm, 8, 2, std::vector<uint8_t>(64, 3));
+    builder.build();
+
+    // Textures of different formats go into different atlases, which are shrunk to their used area.
+    const auto& atlases = builder.getAtlases();
+    ASSERT_EQ(atlases.size(), 2u);
+    EXPECT_EQ(builder.getEntry(a).atlasIndex, builder.getEntry(c).atlasIndex);
+    EXPECT_NE(builder.getEntry(a).atlasIndex, builder.getEntry(b).atlasIndex);
+    const auto& rgAtlas = atlases[builder.getEntry(b).atlasIndex];
+    EXPECT(rgAtlas.format == ResourceFormat::RG8Unorm);
+    EXPECT_EQ(rgAtlas.width, 24u);
+    EXPECT_EQ(rgAtlas.height, 24u);
+    EXPECT_EQ(rgAtlas.data.size(), 24u * 24u * 2u);
+    EXPECT(std::all_of(rgAtlas.data.begin(), rgAtlas.data.end(), [](uint8_t v) { return v == 2; }));
+
+    std::vector<uint8_t> wrongSize(10);
+    EXPECT_THROW(builder.addTexture(ResourceFormat::RGBA8Unorm, 4, 4, wrongSize));
+    EXPECT_THROW(builder.addTexture(ResourceFormat::BC1Unorm, 4, 4, wrongSize));
+
+    TextureAtlasSettings badSettings;
+    badSettings.maxTextureSize = 2048;
+    EXPECT_THROW(TextureAtlasBuilder badBuilder(badSettings));
+}
+} // namespace Falcor
@@ -27,6 +27,8 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Image/TextureManager.h"
+#include <chrono>
+#include <thread>
 
 namespace Falcor
 {
@@ -51,4 +53,81 @@ GPU_TEST(TextureManager_LoadMips)
     EXPECT_EQ(tex->getMipCount(), 3);
     EXPECT_EQ(tex->getArraySize(), 1);
 }
+
+GPU_TEST(TextureManager_StreamMips)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    RenderContext* pRenderContext = pDevice->getRenderContext();
+
+    TextureManager textureManager(pDevice, 10);
+
+    std::filesystem::path path = getRuntimeDirectory() / "data/tests/tiny_<MIP>.png";
+    auto handle = textureManager.loadTexture(path, false, false, ResourceBindFlags::ShaderResource, false);
+    auto tex = textureManager.getTexture(handle);
+    ASSERT(tex != nullptr);
+    ASSERT_EQ(tex->getMipCount(), 3);
+    auto mip0 = pRenderContext->readTextureSubresource(tex.get(), 0);
+    auto mip1 = pRenderContext->readTextureSubresource(tex.get(), 1);
+
+    // Trimming is applied immediately. The texture object stays the same.
+    textureManager.setMemoryBudget(4);
+    EXPECT(textureManager.updateResidency());
+    EXPECT_EQ(textureManager.getTexture(handle), tex);
+    EXPECT_EQ(tex->getWidth(), 1);
+    EXPECT_EQ(tex->getMipCount(), 1);
+
+    // Streaming in loads the missing levels in the background. The residency changes once they are loaded.
+    textureManager.setMemoryBudget(0);
+    bool changed = false;
+    for (uint32_t i = 0; i < 1000 && !changed; i++)
+    {
+        textureManager.requestTextureMips(handle, 0);
+        changed = textureManager.updateResidency();
+        if (!changed)
+        {
+            EXPECT_EQ(textureManager.getResidencyStats().pendingCount, 1);
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    EXPECT(changed);
+    EXPECT_EQ(textureManager.getResidencyStats().pendingCount, 0);
+    EXPECT_EQ(tex->getWidth(), 4);
+    EXPECT_EQ(tex->getMipCount(), 3);
+    EXPECT(pRenderContext->readTextureSubresource(tex.get(), 0) == mip0);
+    EXPECT(pRenderContext->readTextureSubresource(tex.get(), 1) == mip1);
+}
+
+GPU_TEST(TextureManager_RebindAfterResidencyChange)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    TextureManager textureManager(pDevice, 10);
+
+    std::filesystem::path path = getRuntimeDirectory() / "data/tests/tiny_<MIP>.png";
+    auto handle = textureManager.loadTexture(path, false, false, ResourceBindFlags::ShaderResource, false);
+    ASSERT(handle.isValid());
+
+    ctx.createProgram("Tests/Utils/Image/TextureManagerTests.cs.slang", "main");
+    ctx.allocateStructuredBuffer("result", 2);
+    ShaderVar var = ctx.vars().getRootVar();
+    auto bind = [&](bool incremental)
+    { return textureManager.bindShaderData(var["textures"], 2, var["udimIndirection"], var["atlasEntries"], incremental); };
+
+    EXPECT_EQ(bind(false), 2u);
+    EXPECT_EQ(bind(true), 0u);
+    ctx.runProgram(1, 1, 1);
+    std::vector<uint32_t> result = ctx.readBuffer<uint32_t>("result");
+    EXPECT_EQ(result[0], 4u);
+    EXPECT_EQ(result[1], 3u);
+
+    // Trimming swaps the storage of the same texture object. Its descriptor still has to be rewritten.
+    textureManager.setMemoryBudget(4);
+    EXPECT(textureManager.updateResidency());
+    EXPECT_EQ(bind(true), 1u);
+    EXPECT_EQ(bind(true), 0u);
+    ctx.runProgram(1, 1, 1);
+    result = ctx.readBuffer<uint32_t>("result");
+    EXPECT_EQ(result[0], 1u);
+    EXPECT_EQ(result[1], 1u);
+}
 } // namespace Falcor
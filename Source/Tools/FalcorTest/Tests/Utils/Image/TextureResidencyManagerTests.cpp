@@ -0,0 +1,428 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/TextureResidencyManager.h"
+#include <map>
+#include <random>
+#include <set>
+
+namespace Falcor
+{
+namespace
+{
+using TextureID = TextureResidencyManager::TextureID;
+
+/// Mock allocator tracking residency and memory like a GPU allocator would.
+class MockAllocator : public TextureResidencyManager::Allocator
+{
+public:
+    struct Call
+    {
+        TextureID id;
+        uint32_t from;
+        uint32_t to;
+    };
+
+    void addTexture(TextureID id, const std::vector<uint64_t>& mipSizes, uint32_t mip = 0)
+    {
+        mMipSizes[id] = mipSizes;
+        mResident[id] = mip;
+    }
+
+    Result setResidentMips(TextureID id, uint32_t currentMostDetailedMip, uint32_t mostDetailedMip) override
+    {
+        calls.push_back({id, currentMostDetailedMip, mostDetailedMip});
+        if (mResident.at(id) != currentMostDetailedMip)
+            mismatch = true;
+        if (failing.count(id))
+            return Result::Failed;
+        if (loading.count(id) && mostDetailedMip < currentMostDetailedMip)
+            return Result::Pending;
+        mResident[id] = mostDetailedMip;
+
+        uint64_t bytes = getBytes();
+        peakBytes = std::max(peakBytes, bytes);
+        return Result::Success;
+    }
+
+    uint32_t getMip(TextureID id) const { return mResident.at(id); }
+
+    uint64_t getBytes() const
+    {
+        uint64_t bytes = 0;
+        for (const auto& [id, mip] : mResident)
+        {
+            const auto& sizes = mMipSizes.at(id);
+            for (size_t i = mip; i < sizes.size(); i++)
+                bytes += sizes[i];
+        }
+        return bytes;
+    }
+
+    std::vector<Call> calls;
+    std::set<TextureID> failing;
+    std::set<TextureID> loading; ///< Textures whose levels to stream in are still being loaded.
+    bool mismatch = false;
+    uint64_t peakBytes = 0;
+
+private:
+    std::map<TextureID, std::vector<uint64_t>> mMipSizes;
+    std::map<TextureID, uint32_t> mResident;
+};
+
+const std::vector<uint64_t> kMipSizes = {64, 16, 4, 1}; // 85 bytes in total.
+
+void addTexture(
+    TextureResidencyManager& manager,
+    MockAllocator& allocator,
+    TextureID id,
+    const std::vector<uint64_t>& mipSizes = kMipSizes,
+    uint32_t mip = 0
+)
+{
+    allocator.addTexture(id, mipSizes, mip);
+    manager.addTexture(id, {mipSizes}, mip);
+}
+} // namespace
+
+CPU_TEST(TextureResidency_Unlimited)
+{
+    MockAllocator allocator;
+    TextureResidencyManager manager(allocator);
+
+    addTexture(manager, allocator, 0);
+    addTexture(manager, allocator, 1);
+    EXPECT_EQ(manager.getResidentBytes(), 170);
+
+    // Nothing is trimmed without a budget, even if textures are never used.
+    for (uint32_t i = 0; i < 10; i++)
+        EXPECT(!manager.update());
+    EXPECT(allocator.calls.empty());
+    EXPECT_EQ(manager.getResidentMip(0), 0);
+    EXPECT_EQ(manager.getResidentMip(1), 0);
+}
+
+CPU_TEST(TextureResidency_BudgetEviction)
+{
+    MockAllocator allocator;
+    TextureResidencyManager manager(allocator);
+
+    for (TextureID id = 0; id < 3; id++)
+        addTexture(manager, allocator, id);
+    manager.update();
+
+    // Textures 0 and 1 are used, texture 2 is not.
+    manager.requestMip(0, 0);
+    manager.requestMip(1, 0);
+    manager.setBudget(150);
+    EXPECT(manager.update());
+
+    // The unused texture is trimmed down to its coarsest level first, then the used texture with the lowest ID.
+    EXPECT_EQ(manager.getResidentMip(2), 3);
+    EXPECT_EQ(manager.getResidentMip(0), 1);
+    EXPECT_EQ(manager.getResidentMip(1), 0);
+    EXPECT_EQ(manager.getResidentBytes(), 107);
+    EXPECT_EQ(allocator.getBytes(), manager.getResidentBytes());
+    EXPECT_LE(manager.getResidentBytes(), manager.getBudget());
+    EXPECT(!allocator.mismatch);
+
+    // Requesting texture 0 again evicts the now least recently used texture 1 to make room.
+    // Trims are applied before stream-ins, so the budget is never exceeded during the update.
+    allocator.peakBytes = 0;
+    manager.requestMip(0, 0);
+    EXPECT(manager.update());
+    EXPECT_EQ(manager.getResidentMip(0), 0);
+    EXPECT_EQ(manager.getResidentMip(1), 1);
+    EXPECT_EQ(manager.getResidentMip(2), 3);
+    EXPECT_EQ(allocator.getBytes(), manager.getResidentBytes());
+    EXPECT_LE(allocator.peakBytes, manager.getBudget());
+
+    auto stats = manager.getStats();
+    EXPECT_EQ(stats.textureCount, 3);
+    EXPECT_EQ(stats.partiallyResidentCount, 2);
+    EXPECT_EQ(stats.trimmedLevels, 5);
+    EXPECT_EQ(stats.streamedLevels, 1);
+}
+
+CPU_TEST(TextureResidency_PartialStreaming)
+{
+    MockAllocator allocator;
+    TextureResidencyManager manager(allocator, 100);
+
+    addTexture(manager, allocator, 0, kMipSizes, 3);
+    addTexture(manager, allocator, 1, kMipSizes, 3);
+    EXPECT_EQ(manager.getResidentBytes(), 2);
+
+    // Requesting the full chain of both textures only streams in what fits. Levels are streamed smallest first,
+    // so both textures get levels 2 and 1 before the budget runs out for their most detailed levels.
+    // Textures used in the current frame are not trimmed to make room for others.
+    manager.requestMip(0, 0);
+    manager.requestMip(1, 0);
+    EXPECT(manager.update());
+    EXPECT_EQ(manager.getResidentMip(0), 1);
+    EXPECT_EQ(manager.getResidentMip(1), 1);
+    EXPECT_EQ(manager.getResidentBytes(), 42);
+
+    // Once texture 1 is no longer used, its levels are trimmed to make room for texture 0.
+    manager.requestMip(0, 0);
+    EXPECT(manager.update());
+    EXPECT_EQ(manager.getResidentMip(0), 0);
+    EXPECT_EQ(manager.getResidentMip(1), 2);
+    EXPECT_EQ(manager.getResidentBytes(), 90);
+    EXPECT_EQ(allocator.getBytes(), manager.getResidentBytes());
+    EXPECT_EQ(manager.getRequestedMip(1), 0);
+}
+
+CPU_TEST(TextureResidency_ExcessLevelsFirst)
+{
+    MockAllocator allocator;
+    TextureResidencyManager manager(allocator);
+
+    addTexture(manager, allocator, 0);
+    addTexture(manager, allocator, 1);
+    manager.update();
+
+    // Texture 0 was used a long time ago, texture 1 is used but only needs level 2.
+    manager.requestMip(0, 0);
+    manager.update();
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        manager.requestMip(1, 2);
+        manager.update();
+    }
+
+    manager.requestMip(1, 2);
+    manager.setBudget(100);
+    manager.update();
+
+    // Levels that are more detailed than requested are trimmed before least recently used levels.
+    EXPECT_EQ(manager.getResidentMip(1), 2);
+    EXPECT_EQ(manager.getResidentMip(0), 0);
+    EXPECT_EQ(manager.getResidentBytes(), 90);
+
+    // Without excess levels left, the least recently used texture is trimmed.
+    manager.requestMip(1, 2);
+    manager.setBudget(30);
+    manager.update();
+    EXPECT_EQ(manager.getResidentMip(1), 2);
+    EXPECT_EQ(manager.getResidentMip(0), 1);
+    EXPECT_EQ(manager.getResidentBytes(), 26);
+}
+
+CPU_TEST(TextureResidency_MaxMostDetailedMip)
+{
+    MockAllocator allocator;
+    TextureResidencyManager manager(allocator, 1);
+
+    // Block compressed textures can only be trimmed to levels that are a multiple of the block size.
+    allocator.addTexture(0, kMipSizes);
+    TextureResidencyManager::TextureInfo info;
+    info.mipSizes = kMipSizes;
+    info.maxMostDetailedMip = 1;
+    manager.addTexture(0, info);
+
+    manager.update();
+    EXPECT_EQ(manager.getResidentMip(0), 1);
+    EXPECT_EQ(manager.getResidentBytes(), 21);
+}
+
+CPU_TEST(TextureResidency_AllowedMips)
+{
+    MockAllocator allocator;
+    TextureResidencyManager manager(allocator);
+
+    // Levels 1 and 2 can't be the most detailed level, e.g. because they are not block aligned.
+    const std::vector<uint64_t> mipSizes = {256, 64, 16, 4, 1};
+    allocator.addTexture(0, mipSizes);
+    TextureResidencyManager::TextureInfo info;
+    info.mipSizes = mipSizes;
+    info.allowedMostDetailedMips = {true, false, false, true, true};
+    manager.addTexture(0, info);
+    addTexture(manager, allocator, 1);
+    manager.update();
+
+    // Trimming skips the levels that are not allowed.
+    manager.requestMip(1, 0);
+    manager.setBudget(100);
+    EXPECT(manager.update());
+    EXPECT_EQ(manager.getResidentMip(0), 3);
+    EXPECT_EQ(manager.getResidentBytes(), 90);
+    EXPECT_EQ(allocator.calls.size(), 1);
+    EXPECT_EQ(allocator.calls[0].to, 3);
+
+    // Requests for levels that are not allowed are rounded to the next more detailed allowed level.
+    manager.requestMip(0, 2);
+    EXPECT_EQ(manager.getRequestedMip(0), 0);
+
+    // Streaming in only happens once all skipped levels fit into the budget.
+    manager.requestMip(0, 2);
+    manager.setBudget(300);
+    EXPECT(!manager.update());
+    EXPECT_EQ(manager.getResidentMip(0), 3);
+
+    manager.requestMip(0, 2);
+    manager.setBudget(500);
+    EXPECT(manager.update());
+    EXPECT_EQ(manager.getResidentMip(0), 0);
+    EXPECT_EQ(manager.getResidentMip(1), 0);
+    EXPECT_EQ(allocator.getBytes(), manager.getResidentBytes());
+
+    // Adding a texture with a resident level that is not allowed is an error.
+    EXPECT_THROW(manager.addTexture(2, info, 1));
+}
+
+CPU_TEST(TextureResidency_PendingLoads)
+{
+    MockAllocator allocator;
+    TextureResidencyManager manager(allocator);
+
+    addTexture(manager, allocator, 0, kMipSizes, 3);
+    allocator.loading.insert(0);
+
+    // While the levels are loading the residency is unchanged and the request is repeated on every update.
+    for (uint32_t i = 0; i < 3; i++)
+    {
+        manager.requestMip(0, 0);
+        EXPECT(!manager.update());
+        EXPECT_EQ(manager.getResidentMip(0), 3);
+        EXPECT_EQ(manager.getStats().pendingCount, 1);
+    }
+    EXPECT_EQ(allocator.calls.size(), 3);
+    EXPECT_EQ(manager.getStats().failedRequests, 0);
+
+    // Once loaded, the levels are made resident.
+    allocator.loading.clear();
+    manager.requestMip(0, 0);
+    EXPECT(manager.update());
+    EXPECT_EQ(manager.getResidentMip(0), 0);
+    EXPECT_EQ(manager.getStats().pendingCount, 0);
+    EXPECT_EQ(allocator.getBytes(), manager.getResidentBytes());
+
+    // A load is abandoned when the texture is no longer requested.
+    manager.setBudget(10);
+    manager.update();
+    allocator.loading.insert(0);
+    manager.setBudget(0);
+    manager.requestMip(0, 0);
+    manager.update();
+    EXPECT_EQ(manager.getStats().pendingCount, 1);
+    manager.update();
+    EXPECT_EQ(manager.getStats().pendingCount, 0);
+}
+
+CPU_TEST(TextureResidency_AllocatorFailure)
+{
+    MockAllocator allocator;
+    TextureResidencyManager manager(allocator);
+
+    addTexture(manager, allocator, 0);
+    addTexture(manager, allocator, 1);
+    manager.update();
+
+    allocator.failing.insert(0);
+    manager.requestMip(1, 0);
+    manager.setBudget(100);
+    manager.update();
+
+    // Trimming texture 0 failed, its residency is unchanged.
+    EXPECT_EQ(manager.getResidentMip(0), 0);
+    EXPECT_EQ(manager.getStats().failedRequests, 1);
+    EXPECT_EQ(allocator.getBytes(), manager.getResidentBytes());
+
+    // The next update retries and succeeds once the allocator recovers.
+    allocator.failing.clear();
+    manager.requestMip(1, 0);
+    manager.update();
+    EXPECT_EQ(manager.getResidentMip(0), 2);
+    EXPECT_EQ(manager.getResidentBytes(), 90);
+    EXPECT_EQ(allocator.getBytes(), manager.getResidentBytes());
+
+    manager.removeTexture(1);
+    EXPECT_EQ(manager.getResidentBytes(), 5);
+    EXPECT(!manager.hasTexture(1));
+    EXPECT_THROW(manager.requestMip(1, 0));
+}
+
+CPU_TEST(TextureResidency_Random)
+{
+    std::mt19937 rng(42);
+    MockAllocator allocator;
+    TextureResidencyManager manager(allocator, 4096);
+
+    const uint32_t textureCount = 64;
+    uint64_t minBytes = 0;
+    std::vector<std::vector<bool>> allowedMips;
+    for (TextureID id = 0; id < textureCount; id++)
+    {
+        uint32_t mipCount = 1 + rng() % 8;
+        std::vector<uint64_t> sizes(mipCount);
+        for (uint32_t mip = 0; mip < mipCount; mip++)
+            sizes[mip] = 1ull << (2 * (mipCount - 1 - mip));
+        TextureResidencyManager::TextureInfo info;
+        info.mipSizes = sizes;
+        info.allowedMostDetailedMips.resize(mipCount);
+        for (uint32_t mip = 0; mip < mipCount; mip++)
+            info.allowedMostDetailedMips[mip] = mip == 0 || rng() % 4 != 0;
+        uint32_t coarsestMip = mipCount - 1;
+        while (!info.allowedMostDetailedMips[coarsestMip])
+            coarsestMip--;
+        for (uint32_t mip = coarsestMip; mip < mipCount; mip++)
+            minBytes += sizes[mip];
+        allocator.addTexture(id, sizes);
+        manager.addTexture(id, info);
+        allowedMips.push_back(info.allowedMostDetailedMips);
+    }
+
+    for (uint32_t frame = 0; frame < 200; frame++)
+    {
+        allocator.loading.clear();
+        for (TextureID id = 0; id < textureCount; id++)
+        {
+            if (rng() % 4 == 0)
+                allocator.loading.insert(id);
+        }
+
+        uint32_t requestCount = rng() % 16;
+        for (uint32_t i = 0; i < requestCount; i++)
+            manager.requestMip(rng() % textureCount, rng() % 8);
+        if (frame % 50 == 49)
+            manager.setBudget(1024 + rng() % 4096);
+
+        manager.update();
+
+        EXPECT(!allocator.mismatch);
+        EXPECT_EQ(allocator.getBytes(), manager.getResidentBytes());
+        EXPECT_LE(manager.getResidentBytes(), std::max(manager.getBudget(), minBytes));
+        for (TextureID id = 0; id < textureCount; id++)
+        {
+            EXPECT_EQ(allocator.getMip(id), manager.getResidentMip(id));
+            EXPECT(allowedMips[id][manager.getResidentMip(id)]);
+        }
+    }
+}
+} // namespace Falcor
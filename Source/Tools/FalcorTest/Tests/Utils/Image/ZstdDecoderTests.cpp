@@ -0,0 +1,181 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/ZstdDecoder.h"
+#include <fmt/format.h>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+namespace
+{
+std::string createText(int lineCount = 300)
+{
+    std::string text;
+    for (int i = 0; i < lineCount; i++)
+        text += fmt::format("line {}: value {}\n", i, (i * 7) % 100);
+    return text;
+}
+
+// createText() compressed with the zstd command line tool (zstd -3 --no-check).
+// The frame has a single compressed block with four Huffman coded literal streams and FSE coded sequences.
+const uint8_t kCompressedText[] = {
+    0x28, 0xb5, 0x2f, 0xfd, 0x60, 0xb8, 0x14, 0xa5, 0x12, 0x00, 0xd6, 0x1b, 0x33, 0x14, 0xa0, 0x27,
+    0xc5, 0x62, 0xe6, 0x5f, 0x42, 0x06, 0x00, 0xbf, 0x97, 0xdd, 0xdd, 0xbd, 0x13, 0x85, 0x2b, 0x9e,
+    0x8a, 0x01, 0x37, 0x00, 0x37, 0x00, 0x26, 0x00, 0x21, 0xcb, 0xa2, 0x88, 0x9c, 0x98, 0x98, 0x54,
+    0x50, 0x4c, 0x4c, 0x48, 0x44, 0x44, 0x1c, 0x86, 0xf1, 0x6d, 0xdb, 0x35, 0x4d, 0xcf, 0xb2, 0x1c,
+    0xae, 0xaa, 0xe7, 0x69, 0x96, 0x41, 0x47, 0x63, 0x57, 0x0b, 0x4d, 0x8c, 0x89, 0x87, 0x78, 0x09,
+    0x30, 0x10, 0x0a, 0x06, 0x04, 0x02, 0x07, 0x84, 0x80, 0x81, 0x50, 0x28, 0x18, 0x20, 0x08, 0x83,
+    0x83, 0x0c, 0xc6, 0xf0, 0x60, 0x0c, 0x0e, 0xc3, 0x9d, 0x5d, 0x5d, 0x1d, 0xdd, 0xdc, 0x9c, 0x5c,
+    0x5c, 0xdc, 0xa6, 0xd9, 0x99, 0x99, 0x59, 0x19, 0x19, 0xd9, 0x94, 0x54, 0x54, 0xd4, 0x65, 0x59,
+    0x75, 0x75, 0x65, 0x54, 0x44, 0x44, 0x34, 0x24, 0x24, 0x14, 0x34, 0x4d, 0xce, 0xdc, 0xdc, 0x58,
+    0x4d, 0x0d, 0xcd, 0xcc, 0x8c, 0x48, 0x27, 0x17, 0x17, 0xb7, 0x69, 0xaa, 0xaa, 0xaa, 0x6a, 0x48,
+    0x5d, 0x5d, 0xa9, 0xaa, 0xaa, 0x47, 0x73, 0x73, 0x63, 0xa3, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa, 0xaa,
+    0xaa, 0xd3, 0xf4, 0x2c, 0xcb, 0xe1, 0xaa, 0xe7, 0x69, 0x4a, 0x83, 0x13, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff,
+    0xff, 0xff, 0xff, 0xff, 0xff, 0xea, 0xd1, 0xcd, 0x4d, 0x81, 0xb9, 0xa8, 0x51, 0xf0, 0xeb, 0x9f,
+    0x01, 0x01, 0x87, 0x22, 0x01, 0x89, 0x1e, 0x11, 0x24, 0x08, 0x0d, 0x9a, 0x24, 0x92, 0x70, 0xba,
+    0x03, 0x24, 0x40, 0x40, 0x20, 0x8c, 0x13, 0x40, 0x00, 0x08, 0x90, 0xff, 0xfb, 0x7f, 0x7f, 0x4f,
+    0x7f, 0xef, 0xbf, 0xfd, 0xe7, 0xea, 0xff, 0xfd, 0xdf, 0xfe, 0xdc, 0xfe, 0x7b, 0x7f, 0xbf, 0x7d,
+    0xff, 0xef, 0xbf, 0x3d, 0x37, 0xcb, 0xe6, 0xc8, 0xd6, 0x63, 0xeb, 0x2c, 0xb6, 0xe7, 0xb9, 0x1c,
+    0xa7, 0xf1, 0x9c, 0x75, 0xfe, 0xb2, 0x66, 0x2d, 0x87, 0xb5, 0xbc, 0x5a, 0x5b, 0xad, 0xab, 0xd6,
+    0xa8, 0xd6, 0x53, 0x6b, 0xa9, 0x75, 0xd4, 0x1a, 0x6a, 0xfd, 0xb4, 0xe6, 0xb4, 0x6e, 0x5a, 0x33,
+    0xad, 0xef, 0xd2, 0x7a, 0x59, 0xa1, 0x87, 0x25, 0x41, 0x3f, 0x9a, 0x37, 0x5a, 0x15, 0xad, 0x88,
+    0x56, 0x43, 0x0b, 0xa1, 0x45, 0xd0, 0x22, 0xd0, 0xe2, 0x67, 0xe1, 0xb3, 0xb8, 0x3d, 0xc3, 0xdb,
+    0xea, 0x36, 0x9b, 0xc4, 0x41, 0x8b, 0x33, 0x79, 0xb3, 0xb2, 0x59, 0xd4, 0x2c, 0x68, 0x16, 0x33,
+    0x0b, 0x99, 0xc5, 0x98, 0x05, 0xcc, 0xe2, 0x65, 0x11, 0x97, 0x35, 0x5a, 0xd6, 0x59, 0x16, 0x2b,
+    0x2b, 0x95, 0x45, 0xca, 0x02, 0x65, 0x71, 0xb2, 0x68, 0xb2, 0x28, 0x59, 0x90, 0x2c, 0x46, 0x16,
+    0x22, 0x8b, 0x90, 0x05, 0x90, 0x05, 0x3f, 0x96, 0x1e, 0xeb, 0x8e, 0x35, 0xc7, 0x3a, 0x6d, 0xec,
+    0xf1, 0x1c, 0x87, 0xd3, 0x74, 0xce, 0x0a, 0xcc, 0xf2, 0x12, 0x4b, 0x16, 0x71, 0xc3, 0x10, 0x94,
+    0x60, 0xd2, 0x0d, 0x0b, 0x0c, 0xc0, 0x35, 0x0c, 0xaf, 0x48, 0x32, 0x0e, 0xe2, 0x95, 0x23, 0xfd,
+    0xc1, 0x69, 0x38, 0xe6, 0xa5, 0xca, 0xb6, 0x3e, 0xbc, 0xd8, 0xa4, 0xac, 0xe9, 0xbf, 0x69, 0xad,
+    0xf5, 0x42, 0xe9, 0xe4, 0x00, 0xe5, 0xe6, 0x02, 0x94, 0xff, 0xc9, 0x7f, 0xd7, 0xbd, 0x6b, 0xbd,
+    0xd7, 0xde, 0x59, 0xe8, 0x14, 0x60, 0x3a, 0x70, 0x66, 0x56, 0x6f, 0xac, 0x3b, 0xdc, 0x5a, 0xed,
+    0x7d, 0xeb, 0xbd, 0xf6, 0x46, 0x75, 0x67, 0x55, 0xb3, 0xac, 0x4d, 0xeb, 0xaa, 0xb7, 0xbe, 0xc2,
+    0x67, 0x67, 0x3f, 0xf0, 0xad, 0xd5, 0xa4, 0x9b, 0x59, 0x7e, 0x27, 0xdb, 0xec, 0x5a, 0x6b, 0x6b,
+    0xeb, 0xad, 0xaf, 0x45, 0xe3, 0x6f, 0x38, 0xfb, 0xca, 0xae, 0xd6, 0xba, 0xe7, 0xde, 0x6c, 0x55,
+    0xf7, 0xbd, 0xf5, 0x5d, 0xeb, 0xb8, 0x26, 0x73, 0x72, 0xb7, 0x9c, 0x61, 0xce, 0xf0, 0xc2, 0xb6,
+    0xa3, 0x76, 0x07, 0x6d, 0xc7, 0xec, 0x77, 0xcc, 0x76, 0xc8, 0x76, 0xc4, 0xe6, 0x80, 0xc5, 0xfd,
+    0xda, 0x18, 0xb8, 0xa2, 0xad, 0x2d, 0x6b, 0x91, 0x16, 0xdf, 0x1b, 0xef, 0xe3, 0x13, 0xdf, 0x8d,
+    0xcd, 0x7c, 0x9c, 0x6e, 0x88, 0x2f, 0xd9, 0xf1, 0xbc, 0x98, 0x33, 0x40, 0x59, 0x05,
+};
+
+// createText(100) compressed with libzstd (level 19, maximum block size of 1 KB).
+// The frame has two compressed blocks. The second block reuses the Huffman tree of the first block (treeless literals),
+// uses the repeat mode for all three FSE tables and starts with a repeat offset carried over from the first block.
+const uint8_t kCompressedMultiBlockText[] = {
+    0x28, 0xb5, 0x2f, 0xfd, 0x60, 0xf4, 0x05, 0x84, 0x05, 0x00, 0x72, 0xca, 0x18, 0x12, 0xc0, 0xa7,
+    0x03, 0x8e, 0x78, 0x6d, 0xff, 0xfa, 0x44, 0x4a, 0x29, 0x53, 0x92, 0xa9, 0x1f, 0x15, 0xe7, 0x06,
+    0x3d, 0xba, 0xdd, 0xcc, 0x1a, 0x53, 0x8b, 0xe5, 0xe5, 0xe3, 0xa3, 0xb1, 0xab, 0x96, 0xce, 0x9b,
+    0x39, 0xbe, 0x16, 0x8b, 0x15, 0x4f, 0x1d, 0x91, 0x5d, 0xf5, 0x74, 0xdf, 0xcc, 0x19, 0xb7, 0xc5,
+    0xc2, 0x32, 0x73, 0x74, 0x76, 0x55, 0xa3, 0xd7, 0xcd, 0xa4, 0xf1, 0x5b, 0x2c, 0x2e, 0x9d, 0x39,
+    0xaa, 0x5d, 0x95, 0xf4, 0x9b, 0x79, 0x63, 0x6b, 0xb1, 0x38, 0x74, 0x74, 0xbb, 0xaa, 0xe9, 0x73,
+    0x33, 0x3b, 0x66, 0x8b, 0x40, 0x09, 0x08, 0xc4, 0x18, 0x92, 0x40, 0x28, 0x01, 0x71, 0x14, 0x46,
+    0x72, 0xa8, 0x21, 0xa8, 0xbe, 0x7f, 0x06, 0xe0, 0x59, 0xd6, 0x10, 0x12, 0x85, 0xf1, 0x01, 0xb7,
+    0x16, 0x20, 0x25, 0xaa, 0x45, 0xe4, 0x3f, 0x54, 0x26, 0x9a, 0xc6, 0xfa, 0x5f, 0x10, 0xd2, 0x8b,
+    0x55, 0x9a, 0xc7, 0xee, 0x2d, 0x90, 0x00, 0xd5, 0x0f, 0x55, 0x98, 0xcf, 0xee, 0x05, 0x91, 0xbf,
+    0x51, 0xca, 0x40, 0x44, 0x35, 0xf6, 0xe9, 0x96, 0xa4, 0x95, 0xcc, 0xca, 0xde, 0xf8, 0x93, 0x73,
+    0xff, 0x60, 0x99, 0xb4, 0x3f, 0x20, 0xcc, 0x00, 0x59, 0x05, 0x0d, 0x03, 0x00, 0x33, 0x87, 0x0d,
+    0xc0, 0xdc, 0x91, 0xd9, 0x55, 0x8b, 0x4e, 0x37, 0xf3, 0x63, 0xb7, 0x58, 0xa6, 0xdc, 0xf4, 0x88,
+    0x76, 0x55, 0xfa, 0xdd, 0x4c, 0x1b, 0x57, 0x8b, 0x85, 0x8a, 0xcd, 0x8f, 0x6c, 0x57, 0x1d, 0x7a,
+    0x6f, 0x26, 0xc7, 0x75, 0x75, 0x65, 0x47, 0x65, 0x57, 0x25, 0xfa, 0x6f, 0xa6, 0xc7, 0xd3, 0x62,
+    0x69, 0xa1, 0xe1, 0xd1, 0x2f, 0x08, 0x54, 0xfc, 0x2f, 0xd6, 0x64, 0x1e, 0xbb, 0x17, 0x44, 0x9e,
+    0xfb, 0x31, 0xb4, 0x9a, 0xcf, 0xfa, 0x05, 0x91, 0xfd, 0x51, 0x45, 0xb9, 0xdc, 0xc0, 0x5e, 0x54,
+    0x5c, 0x1f, 0xe4, 0xb1, 0x7e, 0x01, 0x8b, 0x8a, 0xaa, 0x7d, 0xe0, 0xa8, 0x30, 0x9e,
+};
+const size_t kMultiBlockSecondBlockOffset = 186;
+
+std::string toString(const std::vector<uint8_t>& data)
+{
+    return std::string(data.begin(), data.end());
+}
+} // namespace
+
+CPU_TEST(ZstdDecoder_Compressed)
+{
+    auto result = ZstdDecoder::decompress(kCompressedText, sizeof(kCompressedText));
+    EXPECT(toString(result) == createText());
+
+    // The decoder must not read past the end of the data.
+    EXPECT_THROW(ZstdDecoder::decompress(kCompressedText, sizeof(kCompressedText) - 1));
+}
+
+CPU_TEST(ZstdDecoder_MultiBlock)
+{
+    auto result = ZstdDecoder::decompress(kCompressedMultiBlockText, sizeof(kCompressedMultiBlockText));
+    EXPECT(toString(result) == createText(100));
+
+    // The second block alone can't be decoded, as it depends on the tables of the first block.
+    std::vector<uint8_t> secondBlock = {0x28, 0xb5, 0x2f, 0xfd, 0x00, 0x00};
+    secondBlock.insert(
+        secondBlock.end(),
+        kCompressedMultiBlockText + kMultiBlockSecondBlockOffset,
+        kCompressedMultiBlockText + sizeof(kCompressedMultiBlockText)
+    );
+    EXPECT_THROW(ZstdDecoder::decompress(secondBlock.data(), secondBlock.size()));
+}
+
+CPU_TEST(ZstdDecoder_RawAndRLEBlocks)
+{
+    // clang-format off
+    const std::vector<uint8_t> data = {
+        // Skippable frame with 3 bytes of user data.
+        0x50, 0x2a, 0x4d, 0x18, 0x03, 0x00, 0x00, 0x00, 0x01, 0x02, 0x03,
+        // Frame with single segment and 1 byte content size, followed by a raw block and a final RLE block.
+        0x28, 0xb5, 0x2f, 0xfd, 0x20, 10,
+        (4 << 3), 0x00, 0x00, 'a', 'b', 'c', 'd',
+        (6 << 3) | (1 << 1) | 1, 0x00, 0x00, 'x',
+        // Frame without content size, with a checksum and a final raw block.
+        0x28, 0xb5, 0x2f, 0xfd, 0x04, 0x00,
+        (2 << 3) | 1, 0x00, 0x00, 'y', 'z',
+        0x00, 0x00, 0x00, 0x00,
+    };
+    // clang-format on
+
+    EXPECT_EQ(toString(ZstdDecoder::decompress(data.data(), data.size())), "abcdxxxxxxyz");
+}
+
+CPU_TEST(ZstdDecoder_Errors)
+{
+    const uint8_t invalidMagic[] = {0x28, 0xb5, 0x2f, 0xfe, 0x20, 0x00, 0x01, 0x00, 0x00};
+    EXPECT_THROW(ZstdDecoder::decompress(invalidMagic, sizeof(invalidMagic)));
+
+    // Frames using a dictionary are not supported.
+    const uint8_t dictionary[] = {0x28, 0xb5, 0x2f, 0xfd, 0x21, 0x07, 0x00, 0x01, 0x00, 0x00};
+    EXPECT_THROW(ZstdDecoder::decompress(dictionary, sizeof(dictionary)));
+
+    // Content size doesn't match the decompressed size.
+    const uint8_t sizeMismatch[] = {0x28, 0xb5, 0x2f, 0xfd, 0x20, 0x05, (2 << 3) | 1, 0x00, 0x00, 'a', 'b'};
+    EXPECT_THROW(ZstdDecoder::decompress(sizeMismatch, sizeof(sizeMismatch)));
+
+    // Reserved block type.
+    const uint8_t reservedBlock[] = {0x28, 0xb5, 0x2f, 0xfd, 0x20, 0x00, (3 << 1) | 1, 0x00, 0x00};
+    EXPECT_THROW(ZstdDecoder::decompress(reservedBlock, sizeof(reservedBlock)));
+}
+} // namespace Falcor
@@ -658,10 +658,11 @@ void createMeshes(ImporterData& data)
     // Add meshes to the scene.
     // We retain a deterministic order of the meshes in the global scene buffer by adding
     // them sequentially after being processed in parallel.
+    // The processed data is moved into the builder to avoid holding two copies.
     uint32_t i = 0;
-    for (const auto& mesh : processedMeshes)
+    for (auto& mesh : processedMeshes)
     {
-        MeshID meshID = data.builder.addProcessedMesh(mesh);
+        MeshID meshID = data.builder.addProcessedMesh(std::move(mesh));
         data.meshMap[i++] = meshID;
     }
 }
@@ -0,0 +1,837 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "GLTFImporter.h"
+#include "Scene/GLTFDocument.h"
+#include "Core/Error.h"
+#include "Core/API/Device.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/CryptoUtils.h"
+#include "Utils/StringFormatters.h"
+#include "Utils/StringUtils.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Timing/TimeReport.h"
+#include "Utils/Math/FalcorMath.h"
+#include "Scene/Importer.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Camera/Camera.h"
+#include "Scene/Lights/Light.h"
+#include "Scene/Material/StandardMaterial.h"
+
+#include <algorithm>
+#include <exception>
+#include <execution>
+#include <fstream>
+#include <functional>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <thread>
+
+namespace Falcor
+{
+
+namespace
+{
+using json = nlohmann::json;
+
+// Embedded images are extracted to this directory (below the app data directory), named by content hash.
+const char kEmbeddedImageDirectory[] = "GLTFImages";
+
+class ImporterData
+{
+public:
+    ImporterData(const gltf::Document& document, SceneBuilder& sceneBuilder)
+        : document(document), root(document.getJson()), builder(sceneBuilder)
+    {}
+
+    const gltf::Document& document;
+    const json& root;
+    SceneBuilder& builder;
+
+    std::vector<ref<Material>> materials;                 ///< Material for each glTF material.
+    ref<Material> pDefaultMaterial;                       ///< Material for primitives without a material.
+    std::vector<std::optional<std::filesystem::path>> imagePaths; ///< Resolved path for each glTF image, if already resolved.
+    std::vector<std::vector<MeshID>> meshIDs;             ///< Mesh ID for each primitive of each glTF mesh.
+    std::vector<NodeID> nodeIDs;                          ///< Node ID for each glTF node, invalid if not part of the scene.
+    std::vector<uint32_t> sceneNodes;                     ///< glTF nodes of the imported scene, parents before children.
+
+    const std::filesystem::path& path() const { return document.getPath(); }
+
+    const json& get(const char* array, uint32_t index) const
+    {
+        auto it = root.find(array);
+        if (it == root.end() || !it->is_array() || index >= it->size())
+            throw ImporterError(path(), "Invalid reference to {}[{}].", array, index);
+        return (*it)[index];
+    }
+
+    size_t count(const char* array) const
+    {
+        auto it = root.find(array);
+        return it != root.end() && it->is_array() ? it->size() : 0;
+    }
+};
+
+float3 readFloat3(const json& object, const char* key, float3 defaultValue)
+{
+    auto it = object.find(key);
+    if (it == object.end())
+        return defaultValue;
+    auto v = it->get<std::vector<float>>();
+    return v.size() == 3 ? float3(v[0], v[1], v[2]) : defaultValue;
+}
+
+float4 readFloat4(const json& object, const char* key, float4 defaultValue)
+{
+    auto it = object.find(key);
+    if (it == object.end())
+        return defaultValue;
+    auto v = it->get<std::vector<float>>();
+    return v.size() == 4 ? float4(v[0], v[1], v[2], v[3]) : defaultValue;
+}
+
+const json* findExtension(const json& object, const char* name)
+{
+    auto extensions = object.find("extensions");
+    if (extensions == object.end())
+        return nullptr;
+    auto it = extensions->find(name);
+    return it != extensions->end() ? &*it : nullptr;
+}
+
+/**
+ * Write an embedded image to the image cache and return its path.
+ * Images are named by their content hash, so repeated imports reuse the extracted files.
+ */
+std::optional<std::filesystem::path> writeEmbeddedImage(const uint8_t* pData, size_t size, const std::string& mimeType)
+{
+    std::string extension;
+    if (mimeType == "image/png")
+        extension = ".png";
+    else if (mimeType == "image/jpeg")
+        extension = ".jpg";
+    else
+        return std::nullopt;
+
+    auto directory = getAppDataDirectory() / kEmbeddedImageDirectory;
+    auto path = directory / (SHA1::toString(SHA1::compute(pData, size)) + extension);
+    if (std::filesystem::exists(path))
+        return path;
+
+    // Write to a temporary file first, so that concurrent imports never see a partial image.
+    std::filesystem::create_directories(directory);
+    auto tmpPath = path;
+    tmpPath += fmt::format(".{}.tmp", std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream file(tmpPath, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(pData), size);
+        if (!file.good())
+            return std::nullopt;
+    }
+    std::error_code ec;
+    std::filesystem::rename(tmpPath, path, ec);
+    if (ec)
+    {
+        std::filesystem::remove(tmpPath, ec);
+        if (!std::filesystem::exists(path))
+            return std::nullopt;
+    }
+    return path;
+}
+
+std::optional<std::filesystem::path> resolveImage(ImporterData& data, uint32_t imageIndex)
+{
+    if (data.imagePaths[imageIndex])
+        return data.imagePaths[imageIndex];
+
+    const json& image = data.get("images", imageIndex);
+    std::optional<std::filesystem::path> path;
+    if (auto uri = image.find("uri"); uri != image.end())
+    {
+        std::string uriStr = uri->get<std::string>();
+        if (uriStr.rfind("data:", 0) == 0)
+        {
+            auto separator = uriStr.find(";base64,");
+            if (separator != std::string::npos)
+            {
+                auto bytes = decodeBase64(uriStr.substr(separator + 8));
+                path = writeEmbeddedImage(bytes.data(), bytes.size(), uriStr.substr(5, separator - 5));
+            }
+        }
+        else
+        {
+            // Assets may contain windows native paths, replace '\' with '/' to make compatible on Linux.
+            std::string relativePath = decodeURI(uriStr);
+            std::replace(relativePath.begin(), relativePath.end(), '\\', '/');
+            path = data.path().parent_path() / relativePath;
+        }
+    }
+    else if (auto bufferView = image.find("bufferView"); bufferView != image.end())
+    {
+        auto [pData, size] = data.document.getBufferViewData(bufferView->get<uint32_t>());
+        path = writeEmbeddedImage(pData, size, image.value("mimeType", ""));
+    }
+
+    if (!path)
+        logWarning("GLTFImporter: Image {} has an unsupported format, ignoring.", imageIndex);
+    data.imagePaths[imageIndex] = path;
+    return path;
+}
+
+void loadTexture(ImporterData& data, const json& textureInfo, const ref<Material>& pMaterial, Material::TextureSlot slot)
+{
+    const json& texture = data.get("textures", textureInfo.at("index").get<uint32_t>());
+    if (textureInfo.value("texCoord", 0u) != 0)
+        logWarning("GLTFImporter: Material '{}' uses texture coordinate set {}. Only set 0 is supported.", pMaterial->getName(), textureInfo.value("texCoord", 0u));
+
+    auto source = texture.find("source");
+    if (source == texture.end())
+    {
+        logWarning("GLTFImporter: Texture used by material '{}' has no supported image source, ignoring.", pMaterial->getName());
+        return;
+    }
+
+    if (auto path = resolveImage(data, source->get<uint32_t>()))
+        data.builder.loadMaterialTexture(pMaterial, slot, *path);
+}
+
+ref<Material> createMaterial(ImporterData& data, const json& material, const std::string& name)
+{
+    // glTF materials use the metallic-roughness model. The specular texture holds roughness in G and metallic in B, as in Falcor.
+    ref<StandardMaterial> pMaterial = StandardMaterial::create(data.builder.getDevice(), name, ShadingModel::MetalRough);
+
+    const json pbr = material.value("pbrMetallicRoughness", json::object());
+    pMaterial->setBaseColor(readFloat4(pbr, "baseColorFactor", float4(1.f)));
+    float4 specularParams = pMaterial->getSpecularParams();
+    specularParams.g = pbr.value("roughnessFactor", 1.f);
+    specularParams.b = pbr.value("metallicFactor", 1.f);
+    pMaterial->setSpecularParams(specularParams);
+
+    if (pbr.contains("baseColorTexture"))
+        loadTexture(data, pbr["baseColorTexture"], pMaterial, Material::TextureSlot::BaseColor);
+    if (pbr.contains("metallicRoughnessTexture"))
+        loadTexture(data, pbr["metallicRoughnessTexture"], pMaterial, Material::TextureSlot::Specular);
+    if (material.contains("normalTexture"))
+        loadTexture(data, material["normalTexture"], pMaterial, Material::TextureSlot::Normal);
+
+    // Emission is factor * texture in glTF. Falcor scales the emissive texture by a scalar, so a colored factor
+    // is only represented exactly without a texture.
+    float3 emissive = readFloat3(material, "emissiveFactor", float3(0.f));
+    float emissiveStrength = 1.f;
+    if (const json* pExt = findExtension(material, "KHR_materials_emissive_strength"))
+        emissiveStrength = pExt->value("emissiveStrength", 1.f);
+    if (material.contains("emissiveTexture") && any(emissive > float3(0.f)))
+    {
+        loadTexture(data, material["emissiveTexture"], pMaterial, Material::TextureSlot::Emissive);
+        pMaterial->setEmissiveFactor(emissiveStrength * std::max({emissive.x, emissive.y, emissive.z}));
+    }
+    else
+    {
+        pMaterial->setEmissiveColor(emissive);
+        pMaterial->setEmissiveFactor(emissiveStrength);
+    }
+
+    if (const json* pExt = findExtension(material, "KHR_materials_ior"))
+        pMaterial->setIndexOfRefraction(pExt->value("ior", 1.5f));
+    if (const json* pExt = findExtension(material, "KHR_materials_transmission"))
+        pMaterial->setSpecularTransmission(pExt->value("transmissionFactor", 0.f));
+
+    // Falcor materials are alpha tested when alpha is below the threshold. Opaque materials ignore alpha,
+    // which a zero threshold achieves. Blending is not supported and is approximated by the alpha test.
+    std::string alphaMode = material.value("alphaMode", "OPAQUE");
+    if (alphaMode == "OPAQUE")
+        pMaterial->setAlphaThreshold(0.f);
+    else if (alphaMode == "MASK")
+        pMaterial->setAlphaThreshold(material.value("alphaCutoff", 0.5f));
+    else if (alphaMode == "BLEND")
+        logWarning("GLTFImporter: Material '{}' uses alpha blending, which is approximated by alpha testing.", name);
+
+    pMaterial->setDoubleSided(material.value("doubleSided", false));
+
+    return pMaterial;
+}
+
+void createMaterials(ImporterData& data)
+{
+    data.imagePaths.resize(data.count("images"));
+    data.materials.resize(data.count("materials"));
+    for (uint32_t i = 0; i < data.materials.size(); i++)
+    {
+        const json& material = data.root["materials"][i];
+        std::string name = material.value("name", "");
+        if (name.empty())
+            name = fmt::format("material{}", i);
+        data.materials[i] = createMaterial(data, material, name);
+    }
+}
+
+const ref<Material>& getMaterial(ImporterData& data, const json& primitive)
+{
+    auto material = primitive.find("material");
+    if (material != primitive.end())
+    {
+        uint32_t index = material->get<uint32_t>();
+        if (index >= data.materials.size())
+            throw ImporterError(data.path(), "Invalid reference to materials[{}].", index);
+        return data.materials[index];
+    }
+
+    // The glTF default material.
+    if (!data.pDefaultMaterial)
+        data.pDefaultMaterial = createMaterial(data, json::object(), "default");
+    return data.pDefaultMaterial;
+}
+
+float4x4 getNodeTransform(const ImporterData& data, const json& node)
+{
+    if (auto it = node.find("matrix"); it != node.end())
+    {
+        auto m = it->get<std::vector<float>>();
+        if (m.size() != 16)
+            throw ImporterError(data.path(), "Node '{}' has an invalid matrix.", node.value("name", ""));
+        // glTF matrices are stored in column-major order.
+        float4x4 transform;
+        for (int r = 0; r < 4; r++)
+            for (int c = 0; c < 4; c++)
+                transform[r][c] = m[c * 4 + r];
+        return transform;
+    }
+
+    float3 translation = readFloat3(node, "translation", float3(0.f));
+    float4 rotation = readFloat4(node, "rotation", float4(0.f, 0.f, 0.f, 1.f));
+    float3 scaling = readFloat3(node, "scale", float3(1.f));
+    float4x4 T = math::matrixFromTranslation(translation);
+    float4x4 R = math::matrixFromQuat(quatf(rotation.x, rotation.y, rotation.z, rotation.w));
+    float4x4 S = math::matrixFromScaling(scaling);
+    return mul(mul(T, R), S);
+}
+
+void createSceneGraph(ImporterData& data)
+{
+    const size_t nodeCount = data.count("nodes");
+    data.nodeIDs.assign(nodeCount, NodeID::Invalid());
+
+    // Find the root nodes of the default scene. Without scenes, all nodes that aren't children are roots.
+    std::vector<uint32_t> roots;
+    if (data.count("scenes") > 0)
+    {
+        const json& scene = data.get("scenes", data.root.value("scene", 0u));
+        roots = scene.value("nodes", std::vector<uint32_t>());
+    }
+    else
+    {
+        std::vector<bool> isChild(nodeCount, false);
+        for (const json& node : data.root.value("nodes", json::array()))
+            for (uint32_t child : node.value("children", std::vector<uint32_t>()))
+                if (child < nodeCount)
+                    isChild[child] = true;
+        for (uint32_t i = 0; i < nodeCount; i++)
+            if (!isChild[i])
+                roots.push_back(i);
+    }
+
+    // Add nodes depth first, parents before children.
+    std::vector<std::pair<uint32_t, NodeID>> stack;
+    for (auto it = roots.rbegin(); it != roots.rend(); ++it)
+        stack.emplace_back(*it, NodeID::Invalid());
+
+    while (!stack.empty())
+    {
+        auto [index, parentID] = stack.back();
+        stack.pop_back();
+
+        const json& node = data.get("nodes", index);
+        if (data.nodeIDs[index] != NodeID::Invalid())
+            throw ImporterError(data.path(), "Node {} has multiple parents.", index);
+
+        SceneBuilder::Node n;
+        n.name = node.value("name", "");
+        if (n.name.empty())
+            n.name = fmt::format("node{}", index);
+        n.parent = parentID;
+        n.transform = getNodeTransform(data, node);
+        NodeID nodeID = data.builder.addNode(n);
+        data.nodeIDs[index] = nodeID;
+        data.sceneNodes.push_back(index);
+
+        auto children = node.value("children", std::vector<uint32_t>());
+        for (auto it = children.rbegin(); it != children.rend(); ++it)
+            stack.emplace_back(*it, nodeID);
+    }
+}
+
+/**
+ * Get float vertex attribute data for SceneBuilder. Tightly packed float data is used in place, other layouts are
+ * converted into the scratch array.
+ */
+template<typename T>
+const T* getFloatAttribute(const ImporterData& data, uint32_t accessorIndex, uint32_t vertexCount, const char* name, std::vector<T>& scratch)
+{
+    constexpr uint32_t kComponentCount = sizeof(T) / sizeof(float);
+    const gltf::Accessor& accessor = data.document.getAccessor(accessorIndex);
+    if (accessor.count != vertexCount)
+        throw ImporterError(data.path(), "Accessor {} for attribute {} has {} elements, expected {}.", accessorIndex, name, accessor.count, vertexCount);
+
+    if (const T* pData = data.document.getTightData<T>(accessorIndex, gltf::ComponentType::Float, kComponentCount))
+        return pData;
+
+    scratch.resize(vertexCount);
+    data.document.readFloats(accessorIndex, kComponentCount, reinterpret_cast<float*>(scratch.data()));
+    return scratch.data();
+}
+
+std::optional<uint32_t> findAttribute(const json& attributes, const char* name)
+{
+    auto it = attributes.find(name);
+    return it != attributes.end() ? std::optional<uint32_t>(it->get<uint32_t>()) : std::nullopt;
+}
+
+std::optional<SceneBuilder::ProcessedMesh> processPrimitive(ImporterData& data, const json& mesh, const json& primitive, const std::string& name, const ref<Material>& pMaterial)
+{
+    const bool loadTangents = is_set(data.builder.getFlags(), SceneBuilder::Flags::UseOriginalTangentSpace);
+    const gltf::PrimitiveMode mode = gltf::PrimitiveMode(primitive.value("mode", uint32_t(gltf::PrimitiveMode::Triangles)));
+    const json& attributes = primitive.at("attributes");
+
+    auto positionAccessor = findAttribute(attributes, "POSITION");
+    if (!positionAccessor)
+        throw ImporterError(data.path(), "Mesh '{}' has no positions.", name);
+
+    SceneBuilder::Mesh meshDesc;
+    meshDesc.name = name;
+    meshDesc.topology = Vao::Topology::TriangleList;
+    meshDesc.pMaterial = pMaterial;
+    meshDesc.vertexCount = data.document.getAccessor(*positionAccessor).count;
+
+    // Scratch arrays, only used for data that can't be passed in place.
+    std::vector<uint32_t> indexData;
+    std::vector<uint32_t> triangleData;
+    std::vector<float3> positionData;
+    std::vector<float3> normalData;
+    std::vector<float4> tangentData;
+    std::vector<float2> texCrdData;
+
+    // Indices.
+    const uint32_t* pIndices = nullptr;
+    uint32_t indexCount = 0;
+    if (auto indices = primitive.find("indices"); indices != primitive.end())
+    {
+        uint32_t accessorIndex = indices->get<uint32_t>();
+        indexCount = data.document.getAccessor(accessorIndex).count;
+        pIndices = data.document.getTightData<uint32_t>(accessorIndex, gltf::ComponentType::UnsignedInt, 1);
+        if (!pIndices)
+        {
+            indexData.resize(indexCount);
+            data.document.readUints(accessorIndex, indexData.data());
+            pIndices = indexData.data();
+        }
+    }
+    else
+    {
+        indexCount = meshDesc.vertexCount;
+        indexData.resize(indexCount);
+        std::iota(indexData.begin(), indexData.end(), 0u);
+        pIndices = indexData.data();
+    }
+
+    if (mode == gltf::PrimitiveMode::TriangleStrip || mode == gltf::PrimitiveMode::TriangleFan)
+    {
+        gltf::triangulate(mode, pIndices, indexCount, triangleData);
+        pIndices = triangleData.data();
+        indexCount = (uint32_t)triangleData.size();
+    }
+    indexCount -= indexCount % 3;
+
+    if (indexCount == 0 || meshDesc.vertexCount == 0)
+        return std::nullopt;
+
+    for (uint32_t i = 0; i < indexCount; i++)
+    {
+        if (pIndices[i] >= meshDesc.vertexCount)
+            throw ImporterError(data.path(), "Mesh '{}' has an out of range vertex index {}.", name, pIndices[i]);
+    }
+
+    meshDesc.indexCount = indexCount;
+    meshDesc.faceCount = indexCount / 3;
+    meshDesc.pIndices = pIndices;
+
+    // Vertex attributes.
+    meshDesc.positions.pData = getFloatAttribute(data, *positionAccessor, meshDesc.vertexCount, "POSITION", positionData);
+    meshDesc.positions.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+
+    if (auto accessor = findAttribute(attributes, "NORMAL"))
+    {
+        meshDesc.normals.pData = getFloatAttribute(data, *accessor, meshDesc.vertexCount, "NORMAL", normalData);
+        meshDesc.normals.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+    }
+    else
+    {
+        // glTF specifies flat normals for meshes without normals.
+        normalData.resize(indexCount);
+        for (uint32_t face = 0; face < meshDesc.faceCount; face++)
+        {
+            float3 p0 = meshDesc.positions.pData[pIndices[face * 3 + 0]];
+            float3 p1 = meshDesc.positions.pData[pIndices[face * 3 + 1]];
+            float3 p2 = meshDesc.positions.pData[pIndices[face * 3 + 2]];
+            float3 n = cross(p1 - p0, p2 - p0);
+            float len = length(n);
+            n = len > 0.f ? n / len : float3(0.f, 0.f, 1.f);
+            normalData[face * 3 + 0] = normalData[face * 3 + 1] = normalData[face * 3 + 2] = n;
+        }
+        meshDesc.normals.pData = normalData.data();
+        meshDesc.normals.frequency = SceneBuilder::Mesh::AttributeFrequency::FaceVarying;
+    }
+
+    if (auto accessor = findAttribute(attributes, "TEXCOORD_0"))
+    {
+        meshDesc.texCrds.pData = getFloatAttribute(data, *accessor, meshDesc.vertexCount, "TEXCOORD_0", texCrdData);
+        meshDesc.texCrds.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+    }
+
+    if (loadTangents)
+    {
+        if (auto accessor = findAttribute(attributes, "TANGENT"))
+        {
+            meshDesc.tangents.pData = getFloatAttribute(data, *accessor, meshDesc.vertexCount, "TANGENT", tangentData);
+            meshDesc.tangents.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+        }
+    }
+
+    return data.builder.processMesh(meshDesc);
+}
+
+void createMeshes(ImporterData& data)
+{
+    struct PrimitiveTask
+    {
+        uint32_t mesh;
+        const json* pPrimitive;
+        std::string name;
+        ref<Material> pMaterial;
+    };
+
+    // Only meshes referenced by nodes of the imported scene are processed.
+    const size_t meshCount = data.count("meshes");
+    std::vector<bool> isUsed(meshCount, false);
+    for (uint32_t nodeIndex : data.sceneNodes)
+    {
+        const json& node = data.root["nodes"][nodeIndex];
+        if (auto mesh = node.find("mesh"); mesh != node.end())
+        {
+            uint32_t meshIndex = mesh->get<uint32_t>();
+            if (meshIndex >= meshCount)
+                throw ImporterError(data.path(), "Invalid reference to meshes[{}].", meshIndex);
+            isUsed[meshIndex] = true;
+        }
+    }
+
+    std::vector<PrimitiveTask> tasks;
+    for (uint32_t meshIndex = 0; meshIndex < meshCount; meshIndex++)
+    {
+        if (!isUsed[meshIndex])
+            continue;
+
+        const json& mesh = data.root["meshes"][meshIndex];
+        std::string meshName = mesh.value("name", "");
+        if (meshName.empty())
+            meshName = fmt::format("mesh{}", meshIndex);
+        const json& primitives = mesh.at("primitives");
+
+        for (uint32_t primitiveIndex = 0; primitiveIndex < primitives.size(); primitiveIndex++)
+        {
+            const json& primitive = primitives[primitiveIndex];
+            gltf::PrimitiveMode mode = gltf::PrimitiveMode(primitive.value("mode", uint32_t(gltf::PrimitiveMode::Triangles)));
+            if (mode != gltf::PrimitiveMode::Triangles && mode != gltf::PrimitiveMode::TriangleStrip && mode != gltf::PrimitiveMode::TriangleFan)
+            {
+                logWarning("GLTFImporter: Mesh '{}' has a primitive that is not made of triangles, ignoring.", meshName);
+                continue;
+            }
+            if (primitive.contains("targets"))
+                logWarning("GLTFImporter: Mesh '{}' has morph targets, which are not supported. Using the base shape.", meshName);
+
+            std::string name = primitives.size() > 1 ? fmt::format("{}.{}", meshName, primitiveIndex) : meshName;
+            tasks.push_back({meshIndex, &primitive, std::move(name), getMaterial(data, primitive)});
+        }
+    }
+
+    // Pre-process primitives in parallel.
+    // Exceptions can't propagate out of the parallel loop, the first one is rethrown afterwards.
+    std::vector<std::optional<SceneBuilder::ProcessedMesh>> processedMeshes(tasks.size());
+    std::exception_ptr pException;
+    std::mutex exceptionMutex;
+    auto range = NumericRange<size_t>(0, tasks.size());
+    std::for_each(
+        std::execution::par,
+        range.begin(),
+        range.end(),
+        [&](size_t i)
+        {
+            const PrimitiveTask& task = tasks[i];
+            try
+            {
+                processedMeshes[i] = processPrimitive(data, data.root["meshes"][task.mesh], *task.pPrimitive, task.name, task.pMaterial);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!pException)
+                    pException = std::current_exception();
+            }
+        }
+    );
+    if (pException)
+        std::rethrow_exception(pException);
+
+    // Add meshes to the scene sequentially to retain a deterministic order.
+    // Each glTF mesh is added once, all nodes referencing it create instances of the same meshes.
+    data.meshIDs.resize(meshCount);
+    for (size_t i = 0; i < tasks.size(); i++)
+    {
+        if (!processedMeshes[i])
+        {
+            logWarning("GLTFImporter: Mesh '{}' has no triangles, ignoring.", tasks[i].name);
+            continue;
+        }
+        data.meshIDs[tasks[i].mesh].push_back(data.builder.addProcessedMesh(std::move(*processedMeshes[i])));
+    }
+
+    for (uint32_t nodeIndex : data.sceneNodes)
+    {
+        const json& node = data.root["nodes"][nodeIndex];
+        if (auto mesh = node.find("mesh"); mesh != node.end())
+        {
+            for (MeshID meshID : data.meshIDs[mesh->get<uint32_t>()])
+                data.builder.addMeshInstance(data.nodeIDs[nodeIndex], meshID);
+        }
+    }
+}
+
+void createCameras(ImporterData& data)
+{
+    for (uint32_t nodeIndex : data.sceneNodes)
+    {
+        const json& node = data.root["nodes"][nodeIndex];
+        auto cameraRef = node.find("camera");
+        if (cameraRef == node.end())
+            continue;
+
+        const json& camera = data.get("cameras", cameraRef->get<uint32_t>());
+        std::string name = camera.value("name", "");
+        if (name.empty())
+            name = data.builder.getNode(data.nodeIDs[nodeIndex]).name;
+
+        if (camera.value("type", "") != "perspective")
+        {
+            logWarning("GLTFImporter: Camera '{}' is not a perspective camera, ignoring.", name);
+            continue;
+        }
+
+        const json& perspective = camera.at("perspective");
+        ref<Camera> pCamera = Camera::create(name);
+        if (perspective.contains("aspectRatio"))
+            pCamera->setAspectRatio(perspective["aspectRatio"].get<float>());
+        pCamera->setFocalLength(fovYToFocalLength(perspective.at("yfov").get<float>(), pCamera->getFrameHeight()));
+        pCamera->setDepthRange(perspective.at("znear").get<float>(), perspective.value("zfar", pCamera->getFarPlane()));
+
+        // glTF cameras look down -Z in node space. The node transform places the camera when the scene is initialized.
+        pCamera->setPosition(float3(0.f));
+        pCamera->setTarget(float3(0.f, 0.f, -1.f));
+        pCamera->setUpVector(float3(0.f, 1.f, 0.f));
+        pCamera->setNodeID(data.nodeIDs[nodeIndex]);
+        data.builder.addCamera(pCamera);
+    }
+}
+
+void createLights(ImporterData& data)
+{
+    const json* pLightsExt = findExtension(data.root, "KHR_lights_punctual");
+    if (!pLightsExt)
+        return;
+    const json lights = pLightsExt->value("lights", json::array());
+
+    for (uint32_t nodeIndex : data.sceneNodes)
+    {
+        const json& node = data.root["nodes"][nodeIndex];
+        const json* pNodeExt = findExtension(node, "KHR_lights_punctual");
+        if (!pNodeExt)
+            continue;
+
+        uint32_t lightIndex = pNodeExt->at("light").get<uint32_t>();
+        if (lightIndex >= lights.size())
+            throw ImporterError(data.path(), "Invalid reference to KHR_lights_punctual light {}.", lightIndex);
+        const json& light = lights[lightIndex];
+        std::string name = light.value("name", "");
+        if (name.empty())
+            name = data.builder.getNode(data.nodeIDs[nodeIndex]).name;
+
+        // Lights point down -Z in node space, so the node transform is used directly.
+        ref<Light> pLight;
+        std::string type = light.value("type", "");
+        if (type == "directional")
+        {
+            ref<DirectionalLight> pDirLight = DirectionalLight::create(name);
+            pDirLight->setWorldDirection(float3(0.f, 0.f, -1.f));
+            pLight = pDirLight;
+        }
+        else if (type == "point" || type == "spot")
+        {
+            ref<PointLight> pPointLight = PointLight::create(name);
+            pPointLight->setWorldPosition(float3(0.f));
+            pPointLight->setWorldDirection(float3(0.f, 0.f, -1.f));
+            if (type == "spot")
+            {
+                const json spot = light.value("spot", json::object());
+                float outer = spot.value("outerConeAngle", 0.25f * float(M_PI));
+                float inner = spot.value("innerConeAngle", 0.f);
+                pPointLight->setOpeningAngle(outer);
+                pPointLight->setPenumbraAngle(outer - inner);
+            }
+            pLight = pPointLight;
+        }
+        else
+        {
+            logWarning("GLTFImporter: Light '{}' has unsupported type '{}', ignoring.", name, type);
+            continue;
+        }
+
+        pLight->setIntensity(readFloat3(light, "color", float3(1.f)) * light.value("intensity", 1.f));
+        pLight->setHasAnimation(true);
+        pLight->setNodeID(data.nodeIDs[nodeIndex]);
+        data.builder.addLight(pLight);
+    }
+}
+
+bool needsAssimpFallback(const gltf::Document& document)
+{
+    // Skinning and animation are only supported through Assimp.
+    const json& root = document.getJson();
+    auto nonEmpty = [&](const char* key)
+    {
+        auto it = root.find(key);
+        return it != root.end() && it->is_array() && !it->empty();
+    };
+    return nonEmpty("skins") || nonEmpty("animations");
+}
+
+std::unique_ptr<Importer> createAssimpImporter(const std::filesystem::path& path)
+{
+    auto pImporter = PluginManager::instance().createClass<Importer>("AssimpImporter");
+    if (!pImporter)
+        throw ImporterError(path, "Asset has skins or animations, which require the AssimpImporter plugin.");
+    logInfo("GLTFImporter: '{}' has skins or animations, importing with AssimpImporter.", path);
+    return pImporter;
+}
+
+void importInternal(const gltf::Document& document, SceneBuilder& builder, TimeReport& timeReport)
+{
+    ImporterData data(document, builder);
+
+    try
+    {
+        createMaterials(data);
+        timeReport.measure("Creating materials");
+
+        createSceneGraph(data);
+        timeReport.measure("Creating scene graph");
+
+        createMeshes(data);
+        timeReport.measure("Creating meshes");
+
+        createCameras(data);
+        createLights(data);
+        timeReport.measure("Creating cameras and lights");
+    }
+    catch (const json::exception& e)
+    {
+        throw ImporterError(document.getPath(), "Malformed asset: {}", e.what());
+    }
+
+    timeReport.printToLog();
+}
+
+} // namespace
+
+std::unique_ptr<Importer> GLTFImporter::create()
+{
+    return std::make_unique<GLTFImporter>();
+}
+
+void GLTFImporter::importScene(
+    const std::filesystem::path& path,
+    SceneBuilder& builder,
+    const std::map<std::string, std::string>& materialToShortName
+)
+{
+    TimeReport timeReport;
+
+    if (!path.is_absolute())
+        throw ImporterError(path, "Expected absolute path.");
+
+    auto pDocument = gltf::Document::load(path);
+    timeReport.measure("Loading asset file");
+
+    if (needsAssimpFallback(*pDocument))
+    {
+        pDocument.reset();
+        createAssimpImporter(path)->importScene(path, builder, materialToShortName);
+        return;
+    }
+
+    importInternal(*pDocument, builder, timeReport);
+}
+
+void GLTFImporter::importSceneFromMemory(
+    const void* buffer,
+    size_t byteSize,
+    std::string_view extension,
+    SceneBuilder& builder,
+    const std::map<std::string, std::string>& materialToShortName
+)
+{
+    TimeReport timeReport;
+
+    // Relative URIs are resolved against the working directory.
+    auto pDocument = gltf::Document::loadFromMemory(buffer, byteSize, {});
+    timeReport.measure("Loading asset file");
+
+    if (needsAssimpFallback(*pDocument))
+    {
+        pDocument.reset();
+        createAssimpImporter({})->importSceneFromMemory(buffer, byteSize, extension, builder, materialToShortName);
+        return;
+    }
+
+    importInternal(*pDocument, builder, timeReport);
+}
+
+extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
+{
+    registry.registerClass<Importer, GLTFImporter>();
+}
+
+} // namespace Falcor
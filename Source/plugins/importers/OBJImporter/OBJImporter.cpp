@@ -0,0 +1,339 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "OBJImporter.h"
+#include "Core/API/Device.h"
+#include "Core/Platform/MemoryMappedFile.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
+#include "Utils/StringFormatters.h"
+#include "Utils/StringUtils.h"
+#include "Utils/Timing/TimeReport.h"
+#include "Scene/Importer.h"
+#include "Scene/ObjParser.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+
+#include <algorithm>
+#include <cmath>
+#include <exception>
+#include <execution>
+#include <map>
+#include <optional>
+#include <set>
+
+namespace Falcor
+{
+
+namespace
+{
+/**
+ * Converts specular power to roughness. Note there is no "the conversion".
+ * Reference: http://simonstechblog.blogspot.com/2011/12/microfacet-brdf.html
+ * @param specPower specular power of an obsolete Phong BSDF
+ */
+float convertSpecPowerToRoughness(float specPower)
+{
+    return std::clamp(std::sqrt(2.0f / (specPower + 2.0f)), 0.f, 1.f);
+}
+
+class ImporterData
+{
+public:
+    ImporterData(const std::filesystem::path& path, SceneBuilder& sceneBuilder) : path(path), builder(sceneBuilder) {}
+
+    std::filesystem::path path;
+    SceneBuilder& builder;
+    std::map<std::string, ref<Material>> materials; ///< Materials by name.
+    ref<Material> pDefaultMaterial;                 ///< Material for faces without a known material.
+};
+
+void loadTexture(ImporterData& data, const ref<Material>& pMaterial, Material::TextureSlot slot, std::string path)
+{
+    if (path.empty())
+        return;
+    // Assets may contain windows native paths, replace '\' with '/' to make compatible on Linux.
+    std::replace(path.begin(), path.end(), '\\', '/');
+    data.builder.loadMaterialTexture(pMaterial, slot, data.path.parent_path() / path);
+}
+
+ref<Material> createMaterial(ImporterData& data, const ObjParser::Material& desc)
+{
+    std::string name = desc.name;
+    if (name.empty())
+    {
+        logWarning("OBJImporter: Material with no name found -> renaming to 'unnamed'.");
+        name = "unnamed";
+    }
+
+    // Spec-Gloss is the default for OBJ files, unless Metal-Rough is requested.
+    SceneBuilder::Flags builderFlags = data.builder.getFlags();
+    ShadingModel shadingModel = is_set(builderFlags, SceneBuilder::Flags::UseMetalRoughMaterials) ? ShadingModel::MetalRough : ShadingModel::SpecGloss;
+    ref<StandardMaterial> pMaterial = StandardMaterial::create(data.builder.getDevice(), name, shadingModel);
+
+    // Load textures. Note that loading is affected by the current shading model.
+    // OBJ does not offer a normal map, thus we use the bump map instead.
+    loadTexture(data, pMaterial, Material::TextureSlot::BaseColor, desc.diffuseMap);
+    loadTexture(data, pMaterial, Material::TextureSlot::Specular, desc.specularMap);
+    loadTexture(data, pMaterial, Material::TextureSlot::Emissive, desc.emissiveMap);
+    loadTexture(data, pMaterial, Material::TextureSlot::Normal, desc.normalMap);
+
+    pMaterial->setBaseColor(float4(desc.diffuse, desc.opacity));
+
+    // Convert the Phong exponent to glossiness.
+    float glossiness = 1.f - convertSpecPowerToRoughness(desc.shininess);
+    pMaterial->setSpecularParams(float4(desc.specular, glossiness));
+
+    pMaterial->setIndexOfRefraction(desc.ior);
+    pMaterial->setEmissiveColor(desc.emissive);
+
+    // Parse the information contained in the name
+    // Tokens following a '.' are interpreted as special flags
+    auto nameVec = splitString(name, ".");
+    for (size_t i = 1; i < nameVec.size(); i++)
+    {
+        std::string str = nameVec[i];
+        std::transform(str.begin(), str.end(), str.begin(), ::tolower);
+        if (str == "doublesided")
+            pMaterial->setDoubleSided(true);
+        else
+            logWarning("OBJImporter: Material '{}' has an unknown material property: '{}'.", name, nameVec[i]);
+    }
+
+    // Use scalar opacity value for controlling specular transmission
+    // TODO: Remove this workaround when we have a better way to define materials.
+    if (desc.opacity < 1.f)
+        pMaterial->setSpecularTransmission(1.f - desc.opacity);
+
+    return pMaterial;
+}
+
+void createMaterials(ImporterData& data, const std::vector<std::string>& libraries)
+{
+    for (const auto& library : libraries)
+    {
+        auto path = data.path.parent_path() / library;
+        if (!std::filesystem::exists(path))
+        {
+            logWarning("OBJImporter: Material library '{}' not found, ignoring.", path);
+            continue;
+        }
+
+        for (const auto& desc : ObjParser::parseMaterials(readFile(path), path))
+        {
+            if (data.materials.count(desc.name) > 0)
+                logWarning("OBJImporter: Material '{}' is defined more than once, using the first definition.", desc.name);
+            else
+                data.materials[desc.name] = createMaterial(data, desc);
+        }
+    }
+}
+
+const ref<Material>& getMaterial(ImporterData& data, const std::string& name, std::set<std::string>& missing)
+{
+    if (!name.empty())
+    {
+        auto it = data.materials.find(name);
+        if (it != data.materials.end())
+            return it->second;
+        if (missing.insert(name).second)
+            logWarning("OBJImporter: Material '{}' is not defined, using the default material.", name);
+    }
+
+    if (!data.pDefaultMaterial)
+    {
+        ObjParser::Material desc;
+        desc.name = "DefaultMaterial";
+        data.pDefaultMaterial = createMaterial(data, desc);
+    }
+    return data.pDefaultMaterial;
+}
+
+/**
+ * Compute area-weighted smooth vertex normals for meshes without normals.
+ */
+std::vector<float3> computeNormals(const std::vector<float3>& positions, const std::vector<uint32_t>& indices)
+{
+    std::vector<float3> normals(positions.size(), float3(0.f));
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        const float3& p0 = positions[indices[i + 0]];
+        float3 n = cross(positions[indices[i + 1]] - p0, positions[indices[i + 2]] - p0);
+        for (size_t j = 0; j < 3; j++)
+            normals[indices[i + j]] += n;
+    }
+    for (float3& n : normals)
+    {
+        float len = length(n);
+        n = len > 0.f ? n / len : float3(0.f, 0.f, 1.f);
+    }
+    return normals;
+}
+
+SceneBuilder::ProcessedMesh processMesh(ImporterData& data, ObjParser::Mesh& mesh, const ref<Material>& pMaterial)
+{
+    if (mesh.normals.empty())
+        mesh.normals = computeNormals(mesh.positions, mesh.indices);
+
+    SceneBuilder::Mesh meshDesc;
+    meshDesc.name = mesh.name;
+    meshDesc.topology = Vao::Topology::TriangleList;
+    meshDesc.pMaterial = pMaterial;
+    meshDesc.vertexCount = (uint32_t)mesh.positions.size();
+    meshDesc.indexCount = (uint32_t)mesh.indices.size();
+    meshDesc.faceCount = meshDesc.indexCount / 3;
+    meshDesc.pIndices = mesh.indices.data();
+    meshDesc.positions.pData = mesh.positions.data();
+    meshDesc.positions.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+    meshDesc.normals.pData = mesh.normals.data();
+    meshDesc.normals.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+    if (!mesh.texCrds.empty())
+    {
+        meshDesc.texCrds.pData = mesh.texCrds.data();
+        meshDesc.texCrds.frequency = SceneBuilder::Mesh::AttributeFrequency::Vertex;
+    }
+    // Vertices are already welded by the parser.
+    meshDesc.mergeDuplicateVertices = false;
+
+    auto processedMesh = data.builder.processMesh(meshDesc);
+
+    // Release the parsed data early, the processed mesh holds a copy.
+    mesh = ObjParser::Mesh();
+    return processedMesh;
+}
+
+void createMeshes(ImporterData& data, std::vector<ObjParser::Mesh>& meshes)
+{
+    // Materials are created on demand, so they are resolved before the parallel loop.
+    std::set<std::string> missingMaterials;
+    std::vector<ref<Material>> materials;
+    for (const auto& mesh : meshes)
+        materials.push_back(getMaterial(data, mesh.material, missingMaterials));
+
+    // Pre-process meshes in parallel.
+    // Exceptions can't propagate out of the parallel loop, the first one is rethrown afterwards.
+    std::vector<std::optional<SceneBuilder::ProcessedMesh>> processedMeshes(meshes.size());
+    std::vector<std::exception_ptr> exceptions(meshes.size());
+    auto range = NumericRange<size_t>(0, meshes.size());
+    std::for_each(
+        std::execution::par,
+        range.begin(),
+        range.end(),
+        [&](size_t i)
+        {
+            try
+            {
+                processedMeshes[i] = processMesh(data, meshes[i], materials[i]);
+            }
+            catch (...)
+            {
+                exceptions[i] = std::current_exception();
+            }
+        }
+    );
+    for (const auto& pException : exceptions)
+    {
+        if (pException)
+            std::rethrow_exception(pException);
+    }
+
+    // Add meshes to the scene sequentially to retain a deterministic order. OBJ files have no hierarchy,
+    // all meshes are instanced by a single node.
+    SceneBuilder::Node node;
+    node.name = data.path.empty() ? "root" : data.path.filename().string();
+    NodeID nodeID = data.builder.addNode(node);
+    for (auto& processedMesh : processedMeshes)
+        data.builder.addMeshInstance(nodeID, data.builder.addProcessedMesh(std::move(*processedMesh)));
+}
+
+void importInternal(ImporterData& data, const void* pData, size_t byteSize, TimeReport& timeReport)
+{
+    ObjParser::Result result = ObjParser::parse(pData, byteSize, data.path);
+    timeReport.measure("Parsing OBJ file");
+
+    createMaterials(data, result.materialLibraries);
+    timeReport.measure("Creating materials");
+
+    createMeshes(data, result.meshes);
+    timeReport.measure("Creating meshes");
+
+    timeReport.printToLog();
+}
+
+} // namespace
+
+std::unique_ptr<Importer> OBJImporter::create()
+{
+    return std::make_unique<OBJImporter>();
+}
+
+void OBJImporter::importScene(
+    const std::filesystem::path& path,
+    SceneBuilder& builder,
+    const std::map<std::string, std::string>& materialToShortName
+)
+{
+    TimeReport timeReport;
+
+    if (!path.is_absolute())
+        throw ImporterError(path, "Expected absolute path.");
+
+    ImporterData data(path, builder);
+
+    if (std::filesystem::exists(path) && std::filesystem::file_size(path) == 0)
+        throw ImporterError(path, "File is empty.");
+
+    MemoryMappedFile file;
+    if (!file.open(path, MemoryMappedFile::kWholeFile, MemoryMappedFile::AccessHint::SequentialScan))
+        throw ImporterError(path, "Failed to open file.");
+    timeReport.measure("Loading asset file");
+
+    importInternal(data, file.getData(), file.getMappedSize(), timeReport);
+}
+
+void OBJImporter::importSceneFromMemory(
+    const void* buffer,
+    size_t byteSize,
+    std::string_view extension,
+    SceneBuilder& builder,
+    const std::map<std::string, std::string>& materialToShortName
+)
+{
+    TimeReport timeReport;
+
+    // Material libraries are resolved against the working directory.
+    ImporterData data({}, builder);
+    importInternal(data, buffer, byteSize, timeReport);
+}
+
+extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
+{
+    registry.registerClass<Importer, OBJImporter>();
+}
+
+} // namespace Falcor
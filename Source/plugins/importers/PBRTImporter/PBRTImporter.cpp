@@ -82,6 +82,7 @@
 #include "Scene/Material/PBRT/PBRTCoatedConductorMaterial.h"
 #include "Scene/Material/PBRT/PBRTDielectricMaterial.h"
 #include "Scene/Material/PBRT/PBRTDiffuseTransmissionMaterial.h"
+#include "Scene/Curves/CurveSimplifier.h"
 #include "Scene/Curves/CurveTessellation.h"
 
 #include <pybind11/pybind11.h>
@@ -1682,13 +1683,35 @@ std::variant<Falcor::MeshID, Falcor::CurveID> createCurveGeometry(BuilderContext
 
     uint32_t subdivPerSegment = 1u << curveAggregate.splitDepth;
 
+    uint32_t strandCount = (uint32_t)curveAggregate.strands.size();
+    const uint32_t* pStrands = curveAggregate.strands.data();
+    const float3* pPoints = curveAggregate.points.data();
+    const float* pWidths = curveAggregate.widths.data();
+
+    // Simplify the curve strands if requested.
+    const Settings& settings = ctx.builder.getSettings();
+    CurveSimplificationSettings simplification;
+    simplification.maxError = settings.getOption("curves:simplifyMaxError", simplification.maxError);
+    simplification.strandFraction = settings.getOption("curves:simplifyStrandFraction", simplification.strandFraction);
+    simplification.widthCompensation = settings.getOption("curves:simplifyWidthCompensation", simplification.widthCompensation);
+
+    CurveSimplifier::Result simplified;
+    if (simplification.isEnabled())
+    {
+        simplified = CurveSimplifier::simplify(strandCount, pStrands, pPoints, pWidths, nullptr, simplification);
+        strandCount = (uint32_t)simplified.vertexCountsPerStrand.size();
+        pStrands = simplified.vertexCountsPerStrand.data();
+        pPoints = simplified.controlPoints.data();
+        pWidths = simplified.widths.data();
+    }
+
     if (mode == CurveTessellationMode::LinearSweptSphere)
     {
         auto result = CurveTessellation::convertToLinearSweptSphere(
-            curveAggregate.strands.size(),
-            curveAggregate.strands.data(),
-            curveAggregate.points.data(),
-            curveAggregate.widths.data(),
+            strandCount,
+            pStrands,
+            pPoints,
+            pWidths,
             nullptr,
             1,
             subdivPerSegment,
@@ -1715,10 +1738,10 @@ std::variant<Falcor::MeshID, Falcor::CurveID> createCurveGeometry(BuilderContext
         if (mode == CurveTessellationMode::PolyTube)
         {
             result = CurveTessellation::convertToPolytube(
-                curveAggregate.strands.size(),
-                curveAggregate.strands.data(),
-                curveAggregate.points.data(),
-                curveAggregate.widths.data(),
+                strandCount,
+                pStrands,
+                pPoints,
+                pWidths,
                 nullptr,
                 subdivPerSegment,
                 1,
@@ -1732,25 +1755,18 @@ std::variant<Falcor::MeshID, Falcor::CurveID> createCurveGeometry(BuilderContext
             FALCOR_UNREACHABLE();
         }
 
-        Falcor::SceneBuilder::Mesh mesh;
-        mesh.faceCount = result.faceVertexIndices.size() / 3;
-        mesh.vertexCount = result.vertices.size();
-        mesh.indexCount = result.faceVertexIndices.size();
-        mesh.pIndices = result.faceVertexIndices.data();
+        // Hand the tessellated arrays over to the builder, which processes the mesh in place.
+        Falcor::SceneBuilder::OwnedMesh mesh;
         mesh.topology = Vao::Topology::TriangleList;
         mesh.pMaterial = curveAggregate.pMaterial;
-        mesh.positions.pData = result.vertices.data();
-        mesh.positions.frequency = Falcor::SceneBuilder::Mesh::AttributeFrequency::Vertex;
-        mesh.normals.pData = result.normals.data();
-        mesh.normals.frequency = Falcor::SceneBuilder::Mesh::AttributeFrequency::Vertex;
-        mesh.tangents.pData = result.tangents.data();
-        mesh.tangents.frequency = Falcor::SceneBuilder::Mesh::AttributeFrequency::Vertex;
-        mesh.texCrds.pData = result.texCrds.data();
-        mesh.texCrds.frequency = Falcor::SceneBuilder::Mesh::AttributeFrequency::Vertex;
-        mesh.curveRadii.pData = result.radii.data();
-        mesh.curveRadii.frequency = Falcor::SceneBuilder::Mesh::AttributeFrequency::Vertex;
-
-        return ctx.builder.addMesh(mesh);
+        mesh.setIndices(std::move(result.faceVertexIndices));
+        mesh.setPositions(std::move(result.vertices));
+        mesh.setNormals(std::move(result.normals));
+        mesh.setTangents(std::move(result.tangents));
+        mesh.setTexCrds(std::move(result.texCrds));
+        mesh.setCurveRadii(std::move(result.radii));
+
+        return ctx.builder.addMesh(std::move(mesh));
     }
 }
 
@@ -30,6 +30,7 @@
 #include "Utils/NumericRange.h"
 #include "Scene/Importer.h"
 #include "Scene/Curves/CurveConfig.h"
+#include "Scene/Curves/CurveSimplifier.h"
 #include "Scene/Material/HairMaterial.h"
 #include "Scene/Material/StandardMaterial.h"
 #include "Utils/Settings/Settings.h"
@@ -40,6 +41,8 @@
 
 #include <tbb/parallel_for.h>
 
+#include <optional>
+
 BEGIN_DISABLE_USD_WARNINGS
 #include <pxr/usd/usd/primRange.h>
 #include <pxr/usd/usd/stage.h>
@@ -634,8 +637,37 @@ namespace Falcor
             return true;
         }
 
+        // Simplify the curve strands as requested by the 'curves:simplify*' attributes.
+        // The kept control points are selected from the first keyframe passed in and reused for all later keyframes,
+        // so that every keyframe of an animated curve has the same strands and vertices.
+        void simplifyCurveData(const std::string& curveName, ImporterContext& ctx, std::optional<CurveSimplifier::Selection>& selection, VtVec3fArray& usdPoints, VtIntArray& usdCurveVertexCounts, VtFloatArray& usdCurveWidths, VtVec2fArray& usdUVs)
+        {
+            CurveSimplificationSettings settings;
+            settings.maxError           = ctx.builder.getSettings().getAttribute(curveName, "curves:simplifyMaxError", settings.maxError);
+            settings.strandFraction     = ctx.builder.getSettings().getAttribute(curveName, "curves:simplifyStrandFraction", settings.strandFraction);
+            settings.widthCompensation  = ctx.builder.getSettings().getAttribute(curveName, "curves:simplifyWidthCompensation", settings.widthCompensation);
+            if (!settings.isEnabled()) return;
+
+            if (!selection)
+            {
+                selection = CurveSimplifier::select((uint32_t)usdCurveVertexCounts.size(), reinterpret_cast<const uint32_t*>(usdCurveVertexCounts.data()),
+                    (float3*)usdPoints.data(), usdCurveWidths.data(), settings);
+            }
+
+            const float2* pUsdUVs = usdUVs.empty() ? nullptr : (float2*)usdUVs.data();
+            CurveSimplifier::Result result = CurveSimplifier::apply(*selection, (uint32_t)usdPoints.size(), (float3*)usdPoints.data(), usdCurveWidths.data(), pUsdUVs);
+
+            logDebug("Simplified curve '{}' from {} to {} strands and from {} to {} control points.", curveName,
+                usdCurveVertexCounts.size(), result.vertexCountsPerStrand.size(), usdPoints.size(), result.controlPoints.size());
+
+            usdCurveVertexCounts.assign(result.vertexCountsPerStrand.begin(), result.vertexCountsPerStrand.end());
+            usdPoints.assign((const GfVec3f*)result.controlPoints.begin(), (const GfVec3f*)result.controlPoints.end());
+            usdCurveWidths.assign(result.widths.begin(), result.widths.end());
+            usdUVs.assign((const GfVec2f*)result.UVs.begin(), (const GfVec2f*)result.UVs.end());
+        }
+
         // Convert a UsdGeomBasisCurves into a CurveGeomData (curve primitive).
-        bool convertToCurveGeomData(const UsdGeomBasisCurves& usdCurve, const UsdTimeCode& timeCode, ImporterContext& ctx, CurveGeomData& geomOut)
+        bool convertToCurveGeomData(const UsdGeomBasisCurves& usdCurve, const UsdTimeCode& timeCode, ImporterContext& ctx, std::optional<CurveSimplifier::Selection>& simplification, CurveGeomData& geomOut)
         {
             std::string curveName = usdCurve.GetPath().GetString();
 
@@ -647,6 +679,7 @@ namespace Falcor
             {
                 return false;
             }
+            simplifyCurveData(curveName, ctx, simplification, usdPoints, usdCurveVertexCounts, usdCurveWidths, usdUVs);
 
             size_t strandCount = usdCurveVertexCounts.size();
             size_t vertexCount = std::accumulate(usdCurveVertexCounts.begin(), usdCurveVertexCounts.end(), 0);
@@ -690,7 +723,7 @@ namespace Falcor
         }
 
         // Convert a UsdGeomBasisCurves into a MeshGeomData (mesh).
-        bool convertToMeshGeomData(const UsdGeomBasisCurves& usdCurve, const UsdTimeCode& timeCode, ImporterContext& ctx, CurveTessellationMode tessellationMode, MeshGeomData& geomOut)
+        bool convertToMeshGeomData(const UsdGeomBasisCurves& usdCurve, const UsdTimeCode& timeCode, ImporterContext& ctx, CurveTessellationMode tessellationMode, std::optional<CurveSimplifier::Selection>& simplification, MeshGeomData& geomOut)
         {
             std::string curveName = usdCurve.GetPath().GetString();
 
@@ -702,6 +735,7 @@ namespace Falcor
             {
                 return false;
             }
+            simplifyCurveData(curveName, ctx, simplification, usdPoints, usdCurveVertexCounts, usdCurveWidths, usdUVs);
 
             size_t strandCount = usdCurveVertexCounts.size();
             size_t vertexCount = std::accumulate(usdCurveVertexCounts.begin(), usdCurveVertexCounts.end(), 0);
@@ -810,6 +844,20 @@ namespace Falcor
             return true;
         }
 
+        // Move the arrays of the given MeshGeomData into an owned mesh set up by createSceneBuilderMesh(), so the builder can process it in place.
+        // Moving the arrays keeps their storage, so the views into them stay valid.
+        void moveGeomDataToMesh(MeshGeomData& geomData, SceneBuilder::OwnedMesh& sbMesh)
+        {
+            sbMesh.indexData = std::move(geomData.triangulatedIndices);
+            sbMesh.positionData = std::move(geomData.points);
+            sbMesh.normalData = std::move(geomData.normals);
+            sbMesh.tangentData = std::move(geomData.tangents);
+            sbMesh.texCrdData = std::move(geomData.texCrds);
+            sbMesh.curveRadiusData = std::move(geomData.curveRadii);
+            sbMesh.boneIDData = std::move(geomData.jointIndices);
+            sbMesh.boneWeightData = std::move(geomData.jointWeights);
+        }
+
         bool createSceneBuilderCurve(const UsdPrim& curvePrim, const CurveGeomData& curveData, ImporterContext& ctx, SceneBuilder::Curve& sbCurve)
         {
             sbCurve.name = curveData.id;
@@ -883,15 +931,29 @@ namespace Falcor
 
             for (size_t i = 0; i < geomData.geomSubsets.size(); ++i)
             {
-                // Create separate mesh for each GeomSubset
-                SceneBuilder::Mesh sbMesh;
-                if (!createSceneBuilderMesh(mesh.prim, geomData, geomData.geomSubsets[i], ctx, sbMesh))
+                auto pAttributeIndices = mesh.attributeIndices.empty() ? nullptr : &mesh.attributeIndices[i];
+
+                if (geomData.geomSubsets.size() == 1)
                 {
-                    continue;
+                    // A single subset covers the whole mesh, so the mesh can take over the geometry arrays.
+                    SceneBuilder::OwnedMesh sbMesh;
+                    if (!createSceneBuilderMesh(mesh.prim, geomData, geomData.geomSubsets[i], ctx, sbMesh))
+                    {
+                        continue;
+                    }
+                    moveGeomDataToMesh(geomData, sbMesh);
+                    mesh.processedMeshes.push_back(ctx.builder.processMesh(std::move(sbMesh), pAttributeIndices));
+                }
+                else
+                {
+                    // Create separate mesh for each GeomSubset
+                    SceneBuilder::Mesh sbMesh;
+                    if (!createSceneBuilderMesh(mesh.prim, geomData, geomData.geomSubsets[i], ctx, sbMesh))
+                    {
+                        continue;
+                    }
+                    mesh.processedMeshes.push_back(ctx.builder.processMesh(sbMesh, pAttributeIndices));
                 }
-
-                auto pAttributeIndices = mesh.attributeIndices.empty() ? nullptr : &mesh.attributeIndices[i];
-                mesh.processedMeshes.push_back(ctx.builder.processMesh(sbMesh, pAttributeIndices));
             }
 
             return true;
@@ -997,10 +1059,13 @@ namespace Falcor
                 for (uint32_t i = 0; i < timeSampleCount; i++) timeCodes.push_back(UsdTimeCode(curve.timeSamples[i]));
             }
 
+            // Simplification is selected on the first keyframe and shared by all keyframes and the tessellated mesh.
+            std::optional<CurveSimplifier::Selection> simplification;
+
             for (size_t i = 0; i < timeCodes.size(); i++)
             {
                 CurveGeomData curveData;
-                if (!convertToCurveGeomData(geomCurve, timeCodes[i], ctx, curveData))
+                if (!convertToCurveGeomData(geomCurve, timeCodes[i], ctx, simplification, curveData))
                 {
                     return false;
                 }
@@ -1019,7 +1084,7 @@ namespace Falcor
             if (processFirstKeyframeMesh)
             {
                 MeshGeomData geomData;
-                if (!convertToMeshGeomData(geomCurve, UsdTimeCode::EarliestTime(), ctx, curve.tessellationMode, geomData))
+                if (!convertToMeshGeomData(geomCurve, UsdTimeCode::EarliestTime(), ctx, curve.tessellationMode, simplification, geomData))
                 {
                     return false;
                 }
@@ -1027,11 +1092,12 @@ namespace Falcor
                 // Finally, create a SceneBuilder::Mesh for the (single) geomSubset in the MeshGeomData.
                 FALCOR_ASSERT(geomData.geomSubsets.size() == 1);
 
-                SceneBuilder::Mesh sbMesh;
+                SceneBuilder::OwnedMesh sbMesh;
                 if (createSceneBuilderMesh(curve.curvePrim, geomData, geomData.geomSubsets[0], ctx, sbMesh))
                 {
                     sbMesh.mergeDuplicateVertices = false;
-                    curve.processedMesh = ctx.builder.processMesh(sbMesh);
+                    moveGeomDataToMesh(geomData, sbMesh);
+                    curve.processedMesh = ctx.builder.processMesh(std::move(sbMesh));
                 }
             }
 
@@ -1095,12 +1161,13 @@ namespace Falcor
 
             // Add processed meshes to scene builder.
             // This is done sequentially after being processed in parallel to ensure a deterministic ordering.
+            // The processed data is moved into the builder to avoid holding two copies.
             for (auto& mesh : ctx.meshes)
             {
                 FALCOR_ASSERT(mesh.meshIDs.empty());
                 for (auto& m : mesh.processedMeshes)
                 {
-                    mesh.meshIDs.push_back(ctx.builder.addProcessedMesh(m));
+                    mesh.meshIDs.push_back(ctx.builder.addProcessedMesh(std::move(m)));
                 }
             }
 
@@ -1277,7 +1344,7 @@ namespace Falcor
                 }
                 else
                 {
-                    curve.geometryID = CurveOrMeshID{ ctx.builder.addProcessedMesh(curve.processedMesh) };
+                    curve.geometryID = CurveOrMeshID{ ctx.builder.addProcessedMesh(std::move(curve.processedMesh)) };
                 }
             }
 
@@ -1306,21 +1373,6 @@ namespace Falcor
             timeReport.measure("Create curve instances");
         }
 
-        template<typename UsdLuxLightType>
-        float3 getLightIntensity(const UsdLuxLightType& light, const UsdPrim& prim)
-        {
-            float exposure = getAuthoredAttribute(light.GetExposureAttr(), prim.GetAttribute(TfToken("exposure")), 0.f);
-            float intens = getAuthoredAttribute(light.GetIntensityAttr(), prim.GetAttribute(TfToken("intensity")), 1.f);
-            GfVec3f blackbodyRGB(1.f, 1.f, 1.f);
-            if (getAuthoredAttribute(light.GetEnableColorTemperatureAttr(), prim.GetAttribute(TfToken("enableColorTemperature")), false))
-            {
-                float temperature = getAuthoredAttribute(light.GetColorTemperatureAttr(), prim.GetAttribute(TfToken("colorTemperature")), 6500.f);
-                blackbodyRGB = UsdLuxBlackbodyTemperatureAsRgb(temperature);
-            }
-            GfVec3f color = getAuthoredAttribute(light.GetColorAttr(), prim.GetAttribute(TfToken("color")), GfVec3f(1.f, 1.f, 1.f));
-            return std::exp2(exposure) * intens * toFalcor(blackbodyRGB) * toFalcor(color);
-        }
-
         Falcor::Animation::Keyframe createKeyframe(const UsdGeomXformCommonAPI& xformAPI, double timeCode, double timeCodesPerSecond)
         {
             Falcor::Animation::Keyframe keyframe;
@@ -1444,7 +1496,7 @@ namespace Falcor
     {
         NodeID nodeId = builder.addNode(makeNode(lightPrim.GetName(), parentId));
         pLight->setNodeID(nodeId);
-        pLight->setHasAnimation(builder.isNodeAnimated(parentId));
+        pLight->setHasAnimation(builder.isNodeAnimated(parentId) || is_set(builder.getFlags(), SceneBuilder::Flags::PreserveSourceObjects));
         builder.addLight(pLight);
     }
 
@@ -1790,7 +1842,9 @@ namespace Falcor
         , builder(builder)
         , useInstanceProxies(useInstanceProxies)
     {
-        mpPreviewSurfaceConverter = std::make_unique<PreviewSurfaceConverter>(builder.getDevice());
+        // Keep one material per USD material if the scene is to be updated in place.
+        bool shareIdenticalMaterials = !is_set(builder.getFlags(), SceneBuilder::Flags::PreserveSourceObjects);
+        mpPreviewSurfaceConverter = std::make_unique<PreviewSurfaceConverter>(builder.getDevice(), shareIdenticalMaterials);
     }
 
 